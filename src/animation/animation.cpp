@@ -5,6 +5,7 @@
 #include "engine/matrix.h"
 #include "engine/profiler.h"
 #include "engine/quat.h"
+#include "engine/string.h"
 #include "engine/resource_manager.h"
 #include "engine/vec.h"
 #include "renderer/model.h"
@@ -20,6 +21,7 @@ enum class Version
 	FIRST = 0,
 	COMPRESSION = 1,
 	ROOT_MOTION,
+	QUANTIZED,
 
 	LAST
 };
@@ -51,6 +53,58 @@ Animation::Animation(const Path& path, ResourceManagerBase& resource_manager, IA
 }
 
 
+// returns the first key index with a time above frame; hint is the index a
+// cursor reached last update, so monotonically advancing time touches one or
+// two keys, while a backwards jump (loop, seek) binary searches instead
+static int findKey(const u16* times, int count, int frame, int hint)
+{
+	if (count <= 1) return 1;
+	int idx = Math::clamp(hint, 1, count - 1);
+	if (times[idx - 1] > frame)
+	{
+		int lo = 1;
+		int hi = idx - 1;
+		while (lo < hi)
+		{
+			int mid = (lo + hi) >> 1;
+			if (times[mid] > frame)
+			{
+				hi = mid;
+			}
+			else
+			{
+				lo = mid + 1;
+			}
+		}
+		return lo;
+	}
+	while (idx < count - 1 && times[idx] <= frame) ++idx;
+	return idx;
+}
+
+
+Vec3 Animation::getPosKey(const Bone& bone, int idx) const
+{
+	if (bone.pos) return bone.pos[idx];
+
+	const float DIV = 1 / 65535.0f;
+	const u16* q = bone.pos_quantized + idx * 3;
+	return Vec3(bone.pos_min.x + bone.pos_range.x * (q[0] * DIV),
+		bone.pos_min.y + bone.pos_range.y * (q[1] * DIV),
+		bone.pos_min.z + bone.pos_range.z * (q[2] * DIV));
+}
+
+
+Quat Animation::getRotKey(const Bone& bone, int idx) const
+{
+	if (bone.rot) return bone.rot[idx];
+
+	const float DIV = 1 / 32767.0f;
+	const i16* q = bone.rot_quantized + idx * 4;
+	return Quat(q[0] * DIV, q[1] * DIV, q[2] * DIV, q[3] * DIV);
+}
+
+
 void Animation::getRelativePose(float time, Pose& pose, Model& model, float weight) const
 {
 	PROFILE_FUNCTION();
@@ -64,6 +118,21 @@ void Animation::getRelativePose(float time, Pose& pose, Model& model, float weig
 	Vec3* pos = pose.positions;
 	Quat* rot = pose.rotations;
 
+	// the layer is sampled into scratch arrays and folded into the pose in one
+	// four-wide sweep; models with more bones than the scratch fall back to a
+	// scalar blend per bone
+	enum { MAX_BATCHED_BONES = 256 };
+	Vec3 layer_pos[MAX_BATCHED_BONES];
+	Quat layer_rot[MAX_BATCHED_BONES];
+	bool batched = pose.count <= MAX_BATCHED_BONES;
+	if (batched)
+	{
+		copyMemory(layer_pos, pos, sizeof(pos[0]) * pose.count);
+		copyMemory(layer_rot, rot, sizeof(rot[0]) * pose.count);
+	}
+	Vec3* out_pos = batched ? layer_pos : pos;
+	Quat* out_rot = batched ? layer_rot : rot;
+
 	if (frame < m_frame_count)
 	{
 		for (Bone& bone : m_bones)
@@ -71,32 +140,26 @@ void Animation::getRelativePose(float time, Pose& pose, Model& model, float weig
 			Model::BoneMap::iterator iter = model.getBoneIndex(bone.name);
 			if (!iter.isValid()) continue;
 
-			int idx = 1;
-			for (int c = bone.pos_count; idx < c; ++idx)
-			{
-				if (bone.pos_times[idx] > frame) break;
-			}
+			int idx = findKey(bone.pos_times, bone.pos_count, frame, 1);
 
 			float t = float(time - bone.pos_times[idx - 1] * rcp_fps) /
 					  ((bone.pos_times[idx] - bone.pos_times[idx - 1]) * rcp_fps);
 
 			int model_bone_index = iter.value();
 			Vec3 anim_pos;
-			lerp(bone.pos[idx - 1], bone.pos[idx], &anim_pos, t);
-			lerp(pos[model_bone_index], anim_pos, &pos[model_bone_index], weight);
+			lerp(getPosKey(bone, idx - 1), getPosKey(bone, idx), &anim_pos, t);
+			if (batched) out_pos[model_bone_index] = anim_pos;
+			else lerp(pos[model_bone_index], anim_pos, &pos[model_bone_index], weight);
 
-			idx = 1;
-			for (int c = bone.rot_count; idx < c; ++idx)
-			{
-				if (bone.rot_times[idx] > frame) break;
-			}
+			idx = findKey(bone.rot_times, bone.rot_count, frame, 1);
 
 			t = float(time - bone.rot_times[idx - 1] * rcp_fps) /
 				((bone.rot_times[idx] - bone.rot_times[idx - 1]) * rcp_fps);
 
 			Quat anim_rot;
-			nlerp(bone.rot[idx - 1], bone.rot[idx], &anim_rot, t);
-			nlerp(rot[model_bone_index], anim_rot, &rot[model_bone_index], weight);
+			nlerp(getRotKey(bone, idx - 1), getRotKey(bone, idx), &anim_rot, t);
+			if (batched) out_rot[model_bone_index] = anim_rot;
+			else nlerp(rot[model_bone_index], anim_rot, &rot[model_bone_index], weight);
 		}
 	}
 	else
@@ -107,10 +170,24 @@ void Animation::getRelativePose(float time, Pose& pose, Model& model, float weig
 			if (!iter.isValid()) continue;
 
 			int model_bone_index = iter.value();
-			lerp(pos[model_bone_index], bone.pos[bone.pos_count - 1], &pos[model_bone_index], weight);
-			nlerp(rot[model_bone_index], bone.rot[bone.rot_count - 1], &rot[model_bone_index], weight);
+			if (batched)
+			{
+				out_pos[model_bone_index] = getPosKey(bone, bone.pos_count - 1);
+				out_rot[model_bone_index] = getRotKey(bone, bone.rot_count - 1);
+			}
+			else
+			{
+				lerp(pos[model_bone_index], getPosKey(bone, bone.pos_count - 1), &pos[model_bone_index], weight);
+				nlerp(rot[model_bone_index], getRotKey(bone, bone.rot_count - 1), &rot[model_bone_index], weight);
+			}
 		}
 	}
+
+	if (batched)
+	{
+		blendPositions(pos, layer_pos, pose.count, weight);
+		blendRotations(rot, layer_rot, pose.count, weight);
+	}
 }
 
 
@@ -132,7 +209,7 @@ Transform Animation::getBoneTransform(float time, int bone_idx) const
 
 		float t = float(time - bone.pos_times[idx - 1] * rcp_fps) /
 			((bone.pos_times[idx] - bone.pos_times[idx - 1]) * rcp_fps);
-		lerp(bone.pos[idx - 1], bone.pos[idx], &ret.pos, t);
+		lerp(getPosKey(bone, idx - 1), getPosKey(bone, idx), &ret.pos, t);
 
 		idx = 1;
 		for (int c = bone.rot_count; idx < c; ++idx)
@@ -142,12 +219,12 @@ Transform Animation::getBoneTransform(float time, int bone_idx) const
 
 		t = float(time - bone.rot_times[idx - 1] * rcp_fps) /
 			((bone.rot_times[idx] - bone.rot_times[idx - 1]) * rcp_fps);
-		nlerp(bone.rot[idx - 1], bone.rot[idx], &ret.rot, t);
+		nlerp(getRotKey(bone, idx - 1), getRotKey(bone, idx), &ret.rot, t);
 	}
 	else
 	{
-		ret.pos = bone.pos[bone.pos_count - 1];
-		ret.rot = bone.rot[bone.rot_count - 1];
+		ret.pos = getPosKey(bone, bone.pos_count - 1);
+		ret.rot = getRotKey(bone, bone.rot_count - 1);
 	}
 	return ret;
 }
@@ -163,7 +240,7 @@ int Animation::getBoneIndex(u32 name) const
 }
 
 
-void Animation::getRelativePose(float time, Pose& pose, Model& model) const
+void Animation::getRelativePose(float time, Pose& pose, Model& model, KeyCursor* cursor, int max_bone_count) const
 {
 	PROFILE_FUNCTION();
 	ASSERT(!pose.is_absolute);
@@ -176,33 +253,44 @@ void Animation::getRelativePose(float time, Pose& pose, Model& model) const
 	Vec3* pos = pose.positions;
 	Quat* rot = pose.rotations;
 
+	int* cursor_indices = nullptr;
+	if (cursor)
+	{
+		if (cursor->animation != this || cursor->indices.size() != m_bones.size() * 2)
+		{
+			cursor->animation = this;
+			cursor->indices.clear();
+			cursor->indices.resize(m_bones.size() * 2);
+			for (int i = 0, c = cursor->indices.size(); i < c; ++i) cursor->indices[i] = 1;
+		}
+		if (!m_bones.empty()) cursor_indices = &cursor->indices[0];
+	}
+
 	if (frame < m_frame_count)
 	{
-		for (Bone& bone : m_bones)
+		for (int bone_idx = 0, bone_count = m_bones.size(); bone_idx < bone_count; ++bone_idx)
 		{
+			const Bone& bone = m_bones[bone_idx];
 			Model::BoneMap::iterator iter = model.getBoneIndex(bone.name);
 			if (!iter.isValid()) continue;
+			int model_bone_index = iter.value();
+			if (max_bone_count >= 0 && model_bone_index >= max_bone_count) continue;
 
-			int idx = 1;
-			for (int c = bone.pos_count; idx < c; ++idx)
-			{
-				if (bone.pos_times[idx] > frame) break;
-			}
+			int idx = findKey(
+				bone.pos_times, bone.pos_count, frame, cursor_indices ? cursor_indices[bone_idx * 2] : 1);
+			if (cursor_indices) cursor_indices[bone_idx * 2] = idx;
 
 			float t = float(time - bone.pos_times[idx - 1] * rcp_fps) /
 				((bone.pos_times[idx] - bone.pos_times[idx - 1]) * rcp_fps);
-			int model_bone_index = iter.value();
-			lerp(bone.pos[idx - 1], bone.pos[idx], &pos[model_bone_index], t);
+			lerp(getPosKey(bone, idx - 1), getPosKey(bone, idx), &pos[model_bone_index], t);
 
-			idx = 1;
-			for (int c = bone.rot_count; idx < c; ++idx)
-			{
-				if (bone.rot_times[idx] > frame) break;
-			}
+			idx = findKey(
+				bone.rot_times, bone.rot_count, frame, cursor_indices ? cursor_indices[bone_idx * 2 + 1] : 1);
+			if (cursor_indices) cursor_indices[bone_idx * 2 + 1] = idx;
 
 			t = float(time - bone.rot_times[idx - 1] * rcp_fps) /
 				((bone.rot_times[idx] - bone.rot_times[idx - 1]) * rcp_fps);
-			nlerp(bone.rot[idx - 1], bone.rot[idx], &rot[model_bone_index], t);
+			nlerp(getRotKey(bone, idx - 1), getRotKey(bone, idx), &rot[model_bone_index], t);
 		}
 	}
 	else
@@ -213,8 +301,9 @@ void Animation::getRelativePose(float time, Pose& pose, Model& model) const
 			if (!iter.isValid()) continue;
 
 			int model_bone_index = iter.value();
-			pos[model_bone_index] = bone.pos[bone.pos_count - 1];
-			rot[model_bone_index] = bone.rot[bone.rot_count - 1];
+			if (max_bone_count >= 0 && model_bone_index >= max_bone_count) continue;
+			pos[model_bone_index] = getPosKey(bone, bone.pos_count - 1);
+			rot[model_bone_index] = getRotKey(bone, bone.rot_count - 1);
 		}
 	}
 }
@@ -255,6 +344,9 @@ bool Animation::load(FS::IFile& file)
 	int size = int(file.size() - file.pos());
 	m_mem.resize(size);
 	file.read(&m_mem[0], size);
+	// quantized files keep the compact tracks resident and decode per key;
+	// older files still map the raw Vec3/Quat arrays directly
+	bool quantized = header.version > (int)Version::QUANTIZED;
 	InputBlob blob(&m_mem[0], size);
 	for (int i = 0; i < m_bones.size(); ++i)
 	{
@@ -262,11 +354,33 @@ bool Animation::load(FS::IFile& file)
 
 		m_bones[i].pos_count = blob.read<int>();
 		m_bones[i].pos_times = (const u16*)blob.skip(m_bones[i].pos_count * sizeof(u16));
-		m_bones[i].pos = (const Vec3*)blob.skip(m_bones[i].pos_count * sizeof(Vec3));;
-		
+		if (quantized)
+		{
+			m_bones[i].pos = nullptr;
+			m_bones[i].pos_min = blob.read<Vec3>();
+			m_bones[i].pos_range = blob.read<Vec3>();
+			m_bones[i].pos_quantized = (const u16*)blob.skip(m_bones[i].pos_count * 3 * sizeof(u16));
+		}
+		else
+		{
+			m_bones[i].pos = (const Vec3*)blob.skip(m_bones[i].pos_count * sizeof(Vec3));
+			m_bones[i].pos_quantized = nullptr;
+			m_bones[i].pos_min.set(0, 0, 0);
+			m_bones[i].pos_range.set(0, 0, 0);
+		}
+
 		m_bones[i].rot_count = blob.read<int>();
-		m_bones[i].rot_times = (const u16*)blob.skip(m_bones[i].rot_count * sizeof(u16));;
-		m_bones[i].rot = (const Quat*)blob.skip(m_bones[i].rot_count * sizeof(Quat));;
+		m_bones[i].rot_times = (const u16*)blob.skip(m_bones[i].rot_count * sizeof(u16));
+		if (quantized)
+		{
+			m_bones[i].rot = nullptr;
+			m_bones[i].rot_quantized = (const i16*)blob.skip(m_bones[i].rot_count * 4 * sizeof(i16));
+		}
+		else
+		{
+			m_bones[i].rot = (const Quat*)blob.skip(m_bones[i].rot_count * sizeof(Quat));
+			m_bones[i].rot_quantized = nullptr;
+		}
 	}
 
 	m_size = file.size();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "engine/array.h"
 #include "engine/matrix.h"
 #include "engine/resource.h"
 #include "engine/resource_manager_base.h"
@@ -51,12 +52,30 @@ class Animation LUMIX_FINAL : public Resource
 			u32 fps;
 		};
 
+	public:
+		// remembers the key reached for every bone of one playing instance, so
+		// advancing time costs O(1) per bone instead of a scan from the first
+		// key; re-binds itself when pointed at a different animation and falls
+		// back to binary search when time jumps backwards
+		struct KeyCursor
+		{
+			explicit KeyCursor(IAllocator& allocator)
+				: indices(allocator)
+			{}
+
+			Array<int> indices;
+			const Animation* animation = nullptr;
+		};
+
 	public:
 		Animation(const Path& path, ResourceManagerBase& resource_manager, IAllocator& allocator);
 
 		int getRootMotionBoneIdx() const { return m_root_motion_bone_idx; }
 		Transform getBoneTransform(float time, int bone_idx) const;
-		void getRelativePose(float time, Pose& pose, Model& model) const;
+		// bones with model index >= max_bone_count are not sampled and keep the
+		// pose already in `pose`; model bones are sorted parents first, so a
+		// prefix covers the root and major limbs
+		void getRelativePose(float time, Pose& pose, Model& model, KeyCursor* cursor = nullptr, int max_bone_count = -1) const;
 		void getRelativePose(float time, Pose& pose, Model& model, float weight) const;
 		int getFrameCount() const { return m_frame_count; }
 		float getLength() const { return m_frame_count / (float)m_fps; }
@@ -77,11 +96,22 @@ class Animation LUMIX_FINAL : public Resource
 			u32 name;
 			int pos_count;
 			const u16* pos_times;
+			// raw tracks; null when the file stores quantized tracks instead
 			const Vec3* pos;
+			const Quat* rot;
+			// quantized tracks stay resident in this compact form and are
+			// decoded per key in getPosKey/getRotKey; positions are 3xu16
+			// normalized into [pos_min, pos_min + pos_range], rotations are
+			// 4xi16 quaternion components scaled by 32767
+			const u16* pos_quantized;
+			const i16* rot_quantized;
+			Vec3 pos_min;
+			Vec3 pos_range;
 			int rot_count;
 			const u16* rot_times;
-			const Quat* rot;
 		};
+		Vec3 getPosKey(const Bone& bone, int idx) const;
+		Quat getRotKey(const Bone& bone, int idx) const;
 		Array<Bone> m_bones;
 		Array<u8> m_mem;
 		int m_fps;
@@ -3,18 +3,24 @@
 #include "animation/animation.h"
 #include "animation/controller.h"
 #include "animation/events.h"
+#include "animation/ik.h"
 #include "engine/base_proxy_allocator.h"
 #include "engine/blob.h"
+#include "engine/chunked_storage.h"
 #include "engine/crc32.h"
 #include "engine/engine.h"
+#include "engine/hash_map.h"
 #include "engine/json_serializer.h"
 #include "engine/lua_wrapper.h"
+#include "engine/mt/sync.h"
+#include "engine/mtjd/for_each.h"
 #include "engine/profiler.h"
 #include "engine/property_descriptor.h"
 #include "engine/property_register.h"
 #include "engine/resource_manager.h"
 #include "engine/serializer.h"
 #include "engine/universe/universe.h"
+#include "physics/physics_scene.h"
 #include "renderer/model.h"
 #include "renderer/pose.h"
 #include "renderer/render_scene.h"
@@ -28,6 +34,7 @@ namespace Lumix
 enum class AnimationSceneVersion
 {
 	SHARED_CONTROLLER,
+	ROOT_MOTION,
 
 	LATEST
 };
@@ -36,6 +43,7 @@ enum class AnimationSceneVersion
 static const ComponentType ANIMABLE_TYPE = PropertyRegister::getComponentType("animable");
 static const ComponentType CONTROLLER_TYPE = PropertyRegister::getComponentType("anim_controller");
 static const ComponentType SHARED_CONTROLLER_TYPE = PropertyRegister::getComponentType("shared_anim_controller");
+static const ComponentType PHYSICS_CONTROLLER_TYPE = PropertyRegister::getComponentType("physical_controller");
 static const ResourceType ANIMATION_TYPE("animation");
 static const ResourceType CONTROLLER_RESOURCE_TYPE("anim_controller");
 
@@ -141,6 +149,10 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 		Anim::ControllerResource* resource = nullptr;
 		Anim::ComponentInstance* root = nullptr;
 		u32 default_set = 0;
+		// when set, the sampled root motion moves the entity (through the
+		// physics controller if the entity has one) instead of gameplay
+		// polling getControllerRootMotion and transforming it again
+		bool use_root_motion = false;
 		Lumix::Array<u8> input;
 		HashMap<u32, Animation*> animations;
 	};
@@ -153,6 +165,27 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 		float start_time;
 		Animation* animation;
 		Entity entity;
+		// owned by the scene; keeps per-bone key indices so getRelativePose
+		// advances in O(1) per bone instead of rescanning the key lists
+		Animation::KeyCursor* cursor;
+		// time not yet applied because the LOD skipped this instance's update
+		float skipped_time;
+		// gameplay-driven IK, solved on the relative pose after sampling; a
+		// slot with zero weight is unused
+		struct IKSlot
+		{
+			enum Type : u8
+			{
+				TWO_BONE,
+				LOOK_AT
+			};
+
+			u32 bone;
+			Type type;
+			float weight;
+			Vec3 target;
+		};
+		IKSlot ik[4];
 	};
 
 
@@ -164,8 +197,13 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 		, m_controllers(allocator)
 		, m_shared_controllers(allocator)
 		, m_event_stream(allocator)
+		, m_pose_cache(allocator)
+		, m_pose_cache_pool(allocator)
+		, m_pose_cache_mutex(false)
 	{
 		m_is_game_running = false;
+		m_update_counter = 0;
+		m_physics_scene = nullptr;
 		m_render_scene = static_cast<RenderScene*>(universe.getScene(crc32("renderer")));
 		universe.registerComponentType(ANIMABLE_TYPE, this, &AnimationSceneImpl::serializeAnimable, &AnimationSceneImpl::deserializeAnimable);
 		universe.registerComponentType(CONTROLLER_TYPE, this, &AnimationSceneImpl::serializeController, &AnimationSceneImpl::deserializeController);
@@ -203,6 +241,9 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 	{
 		Animable& animable = m_animables.insert(entity);
 		animable.entity = entity;
+		animable.cursor = LUMIX_NEW(m_anim_system.m_allocator, Animation::KeyCursor)(m_anim_system.m_allocator);
+		animable.skipped_time = 0;
+		setMemory(animable.ik, 0, sizeof(animable.ik));
 		serializer.read(&animable.time_scale);
 		serializer.read(&animable.start_time);
 		char tmp[MAX_PATH_LENGTH];
@@ -218,6 +259,7 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 		Controller& controller = m_controllers.get({cmp.index});
 		serializer.write("source", controller.resource ? controller.resource->getPath().c_str() : "");
 		serializer.write("default_set", controller.default_set);
+		serializer.write("use_root_motion", controller.use_root_motion);
 	}
 
 
@@ -234,6 +276,10 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 		{
 			serializer.read(&controller.default_set);
 		}
+		if (scene_version > (int)AnimationSceneVersion::ROOT_MOTION)
+		{
+			serializer.read(&controller.use_root_motion);
+		}
 		auto* res = tmp[0] ? m_engine.getResourceManager().get(CONTROLLER_RESOURCE_TYPE)->load(Path(tmp)) : nullptr;
 		controller.resource = (Anim::ControllerResource*)res;
 		m_universe.addComponent(entity, CONTROLLER_TYPE, this, {entity.index});
@@ -248,9 +294,21 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 
 	void clear() override
 	{
+		for (auto iter = m_pose_cache.begin(), end = m_pose_cache.end(); iter != end; ++iter)
+		{
+			LUMIX_DELETE(m_anim_system.m_allocator, iter.value());
+		}
+		m_pose_cache.clear();
+		for (Pose* pose : m_pose_cache_pool)
+		{
+			LUMIX_DELETE(m_anim_system.m_allocator, pose);
+		}
+		m_pose_cache_pool.clear();
+
 		for (Animable& animable : m_animables)
 		{
 			unloadAnimation(animable.animation);
+			LUMIX_DELETE(m_anim_system.m_allocator, animable.cursor);
 		}
 		m_animables.clear();
 
@@ -364,6 +422,9 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 	
 	void startGame() override 
 	{
+		// the physics plugin is created after this one, so the scene can not be
+		// fetched in the constructor
+		m_physics_scene = static_cast<PhysicsScene*>(m_universe.getScene(crc32("physics")));
 		for (auto& controller : m_controllers)
 		{
 			initControllerRuntime(controller);
@@ -439,6 +500,7 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 			Entity entity = {component.index};
 			auto& animable = m_animables[entity];
 			unloadAnimation(animable.animation);
+			LUMIX_DELETE(m_anim_system.m_allocator, animable.cursor);
 			m_animables.erase(entity);
 			m_universe.destroyComponent(entity, type, this, component);
 		}
@@ -503,6 +565,9 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 			char path[MAX_PATH_LENGTH];
 			serializer.readString(path, sizeof(path));
 			animable.animation = path[0] == '\0' ? nullptr : loadAnimation(Path(path));
+			animable.cursor = LUMIX_NEW(m_anim_system.m_allocator, Animation::KeyCursor)(m_anim_system.m_allocator);
+			animable.skipped_time = 0;
+			setMemory(animable.ik, 0, sizeof(animable.ik));
 			m_animables.insert(animable.entity, animable);
 			ComponentHandle cmp = {animable.entity.index};
 			m_universe.addComponent(animable.entity, ANIMABLE_TYPE, this, cmp);
@@ -586,7 +651,7 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 	}
 
 
-	void updateAnimable(Animable& animable, float time_delta)
+	void updateAnimable(Animable& animable, float time_delta, const Vec3* lod_ref_pos)
 	{
 		if (!animable.animation || !animable.animation->isReady()) return;
 		ComponentHandle model_instance = m_render_scene->getModelInstanceComponent(animable.entity);
@@ -598,11 +663,96 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 		if (!pose) return;
 		if (!model->isReady()) return;
 
+		// distant instances are sampled every 2nd/4th/8th frame with a reduced
+		// bone set; the skipped time is applied in one step on the next sample,
+		// unsampled bones keep their last pose
+		static const float LOD_DISTANCES_SQUARED[] = {30 * 30, 60 * 60, 120 * 120};
+		int lod = 0;
+		if (lod_ref_pos)
+		{
+			float dist_squared = (m_universe.getPosition(animable.entity) - *lod_ref_pos).squaredLength();
+			while (lod < lengthOf(LOD_DISTANCES_SQUARED) && dist_squared > LOD_DISTANCES_SQUARED[lod]) ++lod;
+		}
+		if (lod > 0 && (m_update_counter + animable.entity.index) % (1 << lod) != 0)
+		{
+			animable.skipped_time += time_delta;
+			return;
+		}
+		time_delta += animable.skipped_time;
+		animable.skipped_time = 0;
+		int max_bone_count = lod >= 2 ? Math::maximum(1, model->getBoneCount() >> (lod - 1)) : -1;
+
+		bool has_ik = false;
+		for (const Animable::IKSlot& slot : animable.ik)
+		{
+			if (slot.weight > 0)
+			{
+				has_ik = true;
+				break;
+			}
+		}
+
+		// crowds tend to share animations; instances hitting the same quarter
+		// frame bucket this update reuse the first computed pose instead of
+		// redoing the sampling and bone walk; IK targets are per character, so
+		// solved poses stay out of the cache
+		u32 bucket = u32(animable.time * animable.animation->getFPS() * 4);
+		// instances in the same bucket share one pose, so the sampling happens
+		// at the bucket's time, not at whichever instance fills the cache first
+		float sample_time = bucket / float(animable.animation->getFPS() * 4);
+		// reduced-bone poses must not be served to full-skeleton instances
+		if (max_bone_count >= 0) bucket |= u32(lod) << 28;
+		u64 key = (u64(animable.animation->getPath().getHash() ^ model->getPath().getHash()) << 32) | bucket;
+		if (!has_ik)
+		{
+			MT::SpinLock lock(m_pose_cache_mutex);
+			auto iter = m_pose_cache.find(key);
+			if (iter.isValid())
+			{
+				Pose* cached = iter.value();
+				copyMemory(pose->positions, cached->positions, sizeof(pose->positions[0]) * pose->count);
+				copyMemory(pose->rotations, cached->rotations, sizeof(pose->rotations[0]) * pose->count);
+				pose->is_absolute = true;
+				advanceAnimableTime(animable, time_delta);
+				return;
+			}
+		}
+
 		model->getPose(*pose);
 		pose->computeRelative(*model);
-		animable.animation->getRelativePose(animable.time, *pose, *model);
+		animable.animation->getRelativePose(sample_time, *pose, *model, animable.cursor, max_bone_count);
+		if (has_ik) applyIK(animable, *pose, *model);
 		pose->computeAbsolute(*model);
 
+		if (!has_ik)
+		{
+			MT::SpinLock lock(m_pose_cache_mutex);
+			if (!m_pose_cache.find(key).isValid())
+			{
+				Pose* copy;
+				if (m_pose_cache_pool.empty())
+				{
+					copy = LUMIX_NEW(m_anim_system.m_allocator, Pose)(m_anim_system.m_allocator);
+				}
+				else
+				{
+					copy = m_pose_cache_pool.back();
+					m_pose_cache_pool.pop();
+				}
+				if (copy->count != pose->count) copy->resize(pose->count);
+				copyMemory(copy->positions, pose->positions, sizeof(pose->positions[0]) * pose->count);
+				copyMemory(copy->rotations, pose->rotations, sizeof(pose->rotations[0]) * pose->count);
+				copy->is_absolute = true;
+				m_pose_cache.insert(key, copy);
+			}
+		}
+
+		advanceAnimableTime(animable, time_delta);
+	}
+
+
+	void advanceAnimableTime(Animable& animable, float time_delta)
+	{
 		float t = animable.time + time_delta * animable.time_scale;
 		float l = animable.animation->getLength();
 		while (t > l)
@@ -616,7 +766,58 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 	void updateAnimable(ComponentHandle cmp, float time_delta) override
 	{
 		Animable& animable = m_animables[{cmp.index}];
-		updateAnimable(animable, time_delta);
+		updateAnimable(animable, time_delta, nullptr);
+	}
+
+
+	void setAnimableIKTarget(ComponentHandle cmp, int index, const char* bone_name, const Vec3& target, float weight)
+	{
+		setIKSlot(cmp, index, bone_name, target, weight, Animable::IKSlot::TWO_BONE);
+	}
+
+
+	void setAnimableIKLookAt(ComponentHandle cmp, int index, const char* bone_name, const Vec3& target, float weight)
+	{
+		setIKSlot(cmp, index, bone_name, target, weight, Animable::IKSlot::LOOK_AT);
+	}
+
+
+	void setIKSlot(ComponentHandle cmp,
+		int index,
+		const char* bone_name,
+		const Vec3& target,
+		float weight,
+		Animable::IKSlot::Type type)
+	{
+		Animable& animable = m_animables[{cmp.index}];
+		if (index < 0 || index >= lengthOf(animable.ik)) return;
+		Animable::IKSlot& slot = animable.ik[index];
+		slot.bone = crc32(bone_name);
+		slot.type = type;
+		slot.target = target;
+		slot.weight = Math::clamp(weight, 0.0f, 1.0f);
+	}
+
+
+	void applyIK(Animable& animable, Pose& pose, Model& model)
+	{
+		Transform to_model_space = m_universe.getTransform(animable.entity).inverted();
+		for (const Animable::IKSlot& slot : animable.ik)
+		{
+			if (slot.weight <= 0) continue;
+			auto iter = model.getBoneIndex(slot.bone);
+			if (!iter.isValid()) continue;
+
+			Vec3 target = to_model_space.transform(slot.target);
+			if (slot.type == Animable::IKSlot::LOOK_AT)
+			{
+				solveLookAt(pose, model, iter.value(), target, slot.weight);
+			}
+			else
+			{
+				solveTwoBoneIK(pose, model, iter.value(), target, slot.weight);
+			}
+		}
 	}
 
 
@@ -648,6 +849,18 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 	}
 
 
+	bool getControllerUseRootMotion(ComponentHandle cmp)
+	{
+		return m_controllers.get({cmp.index}).use_root_motion;
+	}
+
+
+	void setControllerUseRootMotion(ComponentHandle cmp, bool value)
+	{
+		m_controllers.get({cmp.index}).use_root_motion = value;
+	}
+
+
 	Transform getControllerRootMotion(ComponentHandle cmp) override
 	{
 		Controller& ctrl = m_controllers.get({cmp.index});
@@ -755,7 +968,13 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 	}
 
 
-	void updateController(Controller& controller, float time_delta)
+	// root motion is not written to the universe here; it is appended to the
+	// out arrays so the caller can flush all controllers in one batched
+	// setTransforms with a single entityTransformed fan-out
+	void updateController(Controller& controller,
+		float time_delta,
+		Array<Entity>& moved_entities,
+		Array<Transform>& moved_transforms)
 	{
 		if (!controller.resource->isReady())
 		{
@@ -776,6 +995,32 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 		rc.controller = {controller.entity.index};
 		controller.root = controller.root->update(rc, true);
 
+		if (controller.use_root_motion)
+		{
+			Transform root_motion = controller.root->getRootMotion();
+			Transform tr = m_universe.getTransform(controller.entity);
+			Vec3 delta_pos = tr.rot.rotate(root_motion.pos);
+			ComponentHandle phy_controller = INVALID_COMPONENT;
+			if (m_physics_scene)
+			{
+				phy_controller = m_physics_scene->getComponent(controller.entity, PHYSICS_CONTROLLER_TYPE);
+			}
+			if (isValid(phy_controller))
+			{
+				// the physics controller owns the position so the motion goes
+				// through its collision response; only the rotation is applied
+				// directly
+				m_physics_scene->moveController(phy_controller, delta_pos);
+				moved_entities.push(controller.entity);
+				moved_transforms.emplace(tr.pos, tr.rot * root_motion.rot);
+			}
+			else
+			{
+				moved_entities.push(controller.entity);
+				moved_transforms.emplace(tr.pos + delta_pos, tr.rot * root_motion.rot);
+			}
+		}
+
 		ComponentHandle model_instance = m_render_scene->getModelInstanceComponent(controller.entity);
 		if (model_instance == INVALID_COMPONENT) return;
 
@@ -801,14 +1046,44 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 
 		m_event_stream.clear();
 
-		for (Animable& animable : m_animables)
+		for (auto iter = m_pose_cache.begin(), end = m_pose_cache.end(); iter != end; ++iter)
+		{
+			m_pose_cache_pool.push(iter.value());
+		}
+		m_pose_cache.clear();
+
+		++m_update_counter;
+		Vec3 lod_ref_pos;
+		const Vec3* lod_ref = nullptr;
+		ComponentHandle camera = m_render_scene->getCameraInSlot("main");
+		if (camera != INVALID_COMPONENT)
 		{
-			AnimationSceneImpl::updateAnimable(animable, time_delta);
+			lod_ref_pos = m_universe.getPosition(m_render_scene->getCameraEntity(camera));
+			lod_ref = &lod_ref_pos;
 		}
 
+		PROFILE_INT("animables", m_animables.size());
+		MTJD::forEach(m_engine.getMTJDManager(),
+			m_anim_system.m_allocator,
+			0,
+			m_animables.size(),
+			0,
+			[this, time_delta, lod_ref](int from, int to) {
+				for (int i = from; i < to; ++i)
+				{
+					AnimationSceneImpl::updateAnimable(m_animables.at(i), time_delta, lod_ref);
+				}
+			});
+
+		Array<Entity> moved_entities(m_anim_system.m_allocator);
+		Array<Transform> moved_transforms(m_anim_system.m_allocator);
 		for (Controller& controller : m_controllers)
 		{
-			AnimationSceneImpl::updateController(controller, time_delta);
+			AnimationSceneImpl::updateController(controller, time_delta, moved_entities, moved_transforms);
+		}
+		if (!moved_entities.empty())
+		{
+			m_universe.setTransforms(&moved_entities[0], &moved_transforms[0], moved_entities.size());
 		}
 
 		for (SharedController& controller : m_shared_controllers)
@@ -880,6 +1155,9 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 		animable.entity = entity;
 		animable.time_scale = 1;
 		animable.start_time = 0;
+		animable.cursor = LUMIX_NEW(m_anim_system.m_allocator, Animation::KeyCursor)(m_anim_system.m_allocator);
+		animable.skipped_time = 0;
+		setMemory(animable.ik, 0, sizeof(animable.ik));
 
 		ComponentHandle cmp = {entity.index};
 		m_universe.addComponent(entity, ANIMABLE_TYPE, this, cmp);
@@ -912,12 +1190,19 @@ struct AnimationSceneImpl LUMIX_FINAL : public AnimationScene
 	Universe& m_universe;
 	AnimationSystemImpl& m_anim_system;
 	Engine& m_engine;
-	AssociativeArray<Entity, Animable> m_animables;
+	ChunkedStorage<Animable> m_animables;
 	AssociativeArray<Entity, Controller> m_controllers;
 	AssociativeArray<Entity, SharedController> m_shared_controllers;
 	RenderScene* m_render_scene;
+	PhysicsScene* m_physics_scene;
 	bool m_is_game_running;
+	u32 m_update_counter;
 	OutputBlob m_event_stream;
+	// poses computed this frame keyed by (animation, model, time bucket);
+	// updateAnimable runs on worker threads, hence the mutex
+	HashMap<u64, Pose*> m_pose_cache;
+	Array<Pose*> m_pose_cache_pool;
+	MT::SpinMutex m_pose_cache_mutex;
 };
 
 
@@ -937,6 +1222,10 @@ AnimationSystemImpl::AnimationSystemImpl(Engine& engine)
 			"Animation controller (*.act)",
 			CONTROLLER_RESOURCE_TYPE));
 	PropertyRegister::add("anim_controller", LUMIX_NEW(m_allocator, AnimSetPropertyDescriptor)("Default set"));
+	PropertyRegister::add("anim_controller",
+		LUMIX_NEW(m_allocator, BoolPropertyDescriptor<AnimationSceneImpl>)("Use root motion",
+			&AnimationSceneImpl::getControllerUseRootMotion,
+			&AnimationSceneImpl::setControllerUseRootMotion));
 
 	PropertyRegister::add("animable",
 		LUMIX_NEW(m_allocator, ResourcePropertyDescriptor<AnimationSceneImpl>)("Animation",
@@ -981,6 +1270,8 @@ void AnimationSystemImpl::registerLuaAPI()
 	REGISTER_FUNCTION(setControllerBoolInput);
 	REGISTER_FUNCTION(setControllerFloatInput);
 	REGISTER_FUNCTION(getControllerInputIndex);
+	REGISTER_FUNCTION(setAnimableIKTarget);
+	REGISTER_FUNCTION(setAnimableIKLookAt);
 
 	#undef REGISTER_FUNCTION
 }
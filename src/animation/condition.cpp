@@ -851,17 +851,55 @@ int ExpressionCompiler::tokenize(const char* src, Token* tokens, int max_size)
 
 Condition::Condition(IAllocator& allocator)
 	: bytecode(allocator)
+	, is_constant(false)
+	, constant_value(false)
 {}
 
 
 bool Condition::operator()(RunningContext& rc)
 {
+	if (is_constant) return constant_value;
 	ExpressionVM vm;
 	auto ret = vm.evaluate(&bytecode[0], rc);
 	return ret.b_value;
 }
 
 
+void Condition::fold()
+{
+	is_constant = false;
+	if (bytecode.empty()) return;
+	const u8* cp = &bytecode[0];
+	for (;;)
+	{
+		u8 type = *cp;
+		++cp;
+		switch (type)
+		{
+			case Instruction::CALL:
+			case Instruction::INPUT_FLOAT:
+			case Instruction::INPUT_INT:
+			case Instruction::INPUT_BOOL:
+				return;
+			case Instruction::RET_FLOAT:
+				return;
+			case Instruction::RET_BOOL:
+			{
+				RunningContext rc = {};
+				ExpressionVM vm;
+				constant_value = vm.evaluate(&bytecode[0], rc).b_value;
+				is_constant = true;
+				return;
+			}
+			case Instruction::PUSH_BOOL: cp += sizeof(bool); break;
+			case Instruction::PUSH_FLOAT: cp += sizeof(float); break;
+			case Instruction::PUSH_INT: cp += sizeof(int); break;
+			default: break;
+		}
+	}
+}
+
+
 bool Condition::compile(const char* expression, InputDecl& decl)
 {
 	ExpressionCompiler compiler;
@@ -879,6 +917,7 @@ bool Condition::compile(const char* expression, InputDecl& decl)
 		return false;
 	}
 	bytecode.resize(size);
+	fold();
 	return true;
 }
 
@@ -123,8 +123,14 @@ struct Condition
 
 	bool operator()(RunningContext& rc);
 	bool compile(const char* expression, InputDecl& decl);
+	// scans the bytecode; an expression referencing no inputs and no functions
+	// is evaluated once here and operator() returns the stored value without
+	// running the interpreter; call after the bytecode changes
+	void fold();
 
 	Array<u8> bytecode;
+	bool is_constant;
+	bool constant_value;
 };
 
 
@@ -179,7 +179,12 @@ void Node::onGUI()
 					ImGui::TreePop();
 					break;
 				}
-				ImGui::InputFloat("Time", &header.time);
+				if (ImGui::InputFloat("Time", &header.time))
+				{
+					engine_node->sortEvents();
+					ImGui::TreePop();
+					break;
+				}
 				int event_offset = header.offset + sizeof(Anim::EventHeader) * engine_node->events_count;
 				m_controller.getEditor().getEventType(header.type).editor.invoke(&events[event_offset], *this);
 				ImGui::TreePop();
@@ -213,6 +218,7 @@ void Node::onGUI()
 			auto& event_type = m_controller.getEditor().getEventTypeByIdx(current);
 			newEvent(event_type.size, event_type.type);
 			++engine_node->events_count;
+			engine_node->sortEvents();
 		}
 	}
 }
@@ -0,0 +1,127 @@
+#include "animation/ik.h"
+#include "engine/math_utils.h"
+#include "engine/matrix.h"
+#include "engine/quat.h"
+#include "engine/vec.h"
+#include "renderer/model.h"
+#include "renderer/pose.h"
+#include <cmath>
+
+
+namespace Lumix
+{
+
+
+static void getAbsoluteTransform(const Pose& pose, Model& model, int bone_idx, Vec3* out_pos, Quat* out_rot)
+{
+	Vec3 pos = pose.positions[bone_idx];
+	Quat rot = pose.rotations[bone_idx];
+	int parent = model.getBone(bone_idx).parent_idx;
+	while (parent >= 0)
+	{
+		pos = pose.rotations[parent].rotate(pos) + pose.positions[parent];
+		rot = pose.rotations[parent] * rot;
+		parent = model.getBone(parent).parent_idx;
+	}
+	*out_pos = pos;
+	*out_rot = rot;
+}
+
+
+static Quat shortestArc(const Vec3& from, const Vec3& to)
+{
+	Vec3 axis = crossProduct(from, to);
+	if (axis.squaredLength() < 1e-9f) return Quat(0, 0, 0, 1);
+	axis.normalize();
+	float angle = acos(Math::clamp(dotProduct(from, to), -1.0f, 1.0f));
+	return Quat(axis, angle);
+}
+
+
+void solveTwoBoneIK(Pose& pose, Model& model, int leaf_bone, const Vec3& target, float weight)
+{
+	ASSERT(!pose.is_absolute);
+	if (weight <= 0) return;
+	if (leaf_bone < 0 || leaf_bone >= pose.count) return;
+	int mid_bone = model.getBone(leaf_bone).parent_idx;
+	if (mid_bone < 0) return;
+	int root_bone = model.getBone(mid_bone).parent_idx;
+	if (root_bone < 0) return;
+
+	Vec3 root_pos;
+	Quat root_rot;
+	getAbsoluteTransform(pose, model, root_bone, &root_pos, &root_rot);
+	Vec3 mid_pos = root_rot.rotate(pose.positions[mid_bone]) + root_pos;
+	Quat mid_rot = root_rot * pose.rotations[mid_bone];
+	Vec3 leaf_pos = mid_rot.rotate(pose.positions[leaf_bone]) + mid_pos;
+
+	float len_upper = (mid_pos - root_pos).length();
+	float len_lower = (leaf_pos - mid_pos).length();
+	if (len_upper < 0.001f || len_lower < 0.001f) return;
+
+	Vec3 to_target = target - root_pos;
+	float target_len = to_target.length();
+	if (target_len < 0.001f) return;
+	float max_reach = (len_upper + len_lower) * 0.999f;
+	if (target_len > max_reach)
+	{
+		to_target *= max_reach / target_len;
+		target_len = max_reach;
+	}
+
+	Vec3 upper_dir = (mid_pos - root_pos) * (1 / len_upper);
+	Vec3 lower_dir = (leaf_pos - mid_pos) * (1 / len_lower);
+	// the chain bends around its current plane; a straight chain bends toward
+	// the target instead
+	Vec3 bend_axis = crossProduct(upper_dir, lower_dir);
+	if (bend_axis.squaredLength() < 1e-6f) bend_axis = crossProduct(upper_dir, to_target);
+	if (bend_axis.squaredLength() < 1e-6f) return;
+	bend_axis.normalize();
+
+	// law of cosines: the angle between the limbs that puts the leaf at
+	// target_len from the root
+	float cos_desired = (target_len * target_len - len_upper * len_upper - len_lower * len_lower) /
+						(2 * len_upper * len_lower);
+	float desired_angle = acos(Math::clamp(cos_desired, -1.0f, 1.0f));
+	float current_angle = acos(Math::clamp(dotProduct(upper_dir, lower_dir), -1.0f, 1.0f));
+
+	Quat mid_delta(bend_axis, desired_angle - current_angle);
+	Quat new_mid_rot = mid_delta * mid_rot;
+	leaf_pos = new_mid_rot.rotate(pose.positions[leaf_bone]) + mid_pos;
+
+	// swing the whole chain so the leaf lands on the target
+	Quat root_delta = shortestArc((leaf_pos - root_pos).normalized(), to_target.normalized());
+	Quat parent_rot = root_rot * pose.rotations[root_bone].conjugated();
+	Quat parent_rot_inv = parent_rot.conjugated();
+
+	Quat new_root_rel = parent_rot_inv * (root_delta * root_rot);
+	// the root delta cancels out in the mid bone's parent-relative rotation
+	Quat new_mid_rel = root_rot.conjugated() * new_mid_rot;
+	nlerp(pose.rotations[root_bone], new_root_rel, &pose.rotations[root_bone], weight);
+	nlerp(pose.rotations[mid_bone], new_mid_rel, &pose.rotations[mid_bone], weight);
+}
+
+
+void solveLookAt(Pose& pose, Model& model, int bone, const Vec3& target, float weight)
+{
+	ASSERT(!pose.is_absolute);
+	if (weight <= 0) return;
+	if (bone < 0 || bone >= pose.count) return;
+
+	Vec3 bone_pos;
+	Quat bone_rot;
+	getAbsoluteTransform(pose, model, bone, &bone_pos, &bone_rot);
+
+	Vec3 to_target = target - bone_pos;
+	if (to_target.squaredLength() < 1e-6f) return;
+	to_target.normalize();
+
+	Quat delta = shortestArc(bone_rot.rotate(Vec3(0, 0, 1)), to_target);
+	int parent = model.getBone(bone).parent_idx;
+	Quat parent_rot = parent >= 0 ? bone_rot * pose.rotations[bone].conjugated() : Quat(0, 0, 0, 1);
+	Quat new_rel = parent_rot.conjugated() * (delta * bone_rot);
+	nlerp(pose.rotations[bone], new_rel, &pose.rotations[bone], weight);
+}
+
+
+} // namespace Lumix
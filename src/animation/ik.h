@@ -0,0 +1,24 @@
+#pragma once
+
+
+#include "engine/lumix.h"
+
+
+namespace Lumix
+{
+
+
+class Model;
+struct Pose;
+struct Vec3;
+
+
+// solvers adjusting a relative pose in place; they run after sampling and
+// before Pose::computeAbsolute, so the corrections propagate to the child
+// bones for free; targets are in model space
+void solveTwoBoneIK(Pose& pose, Model& model, int leaf_bone, const Vec3& target, float weight);
+// rotates the bone so its +Z axis aims at the target
+void solveLookAt(Pose& pose, Model& model, int bone, const Vec3& target, float weight);
+
+
+} // namespace Lumix
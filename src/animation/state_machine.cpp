@@ -144,6 +144,7 @@ void Edge::deserialize(InputBlob& blob, Container* parent, int version)
 	blob.read(size);
 	condition.bytecode.resize(size);
 	if(size > 0) blob.read(&condition.bytecode[0], size);
+	condition.fold();
 	from->out_edges.push(this);
 }
 
@@ -188,6 +189,25 @@ void Node::deserialize(InputBlob& blob, Container* parent, int version)
 		blob.read(size);
 		events.resize(size);
 		blob.read(&events[0], size);
+		sortEvents();
+	}
+}
+
+
+void Node::sortEvents()
+{
+	if (events_count <= 1) return;
+	EventHeader* headers = (EventHeader*)&events[0];
+	for (int i = 1; i < events_count; ++i)
+	{
+		EventHeader tmp = headers[i];
+		int j = i - 1;
+		while (j >= 0 && headers[j].time > tmp.time)
+		{
+			headers[j + 1] = headers[j];
+			--j;
+		}
+		headers[j + 1] = tmp;
 	}
 }
 
@@ -358,42 +378,49 @@ void AnimationNode::deserialize(InputBlob& blob, Container* parent, int version)
 }
 
 
+// first header with time >= `time`; the headers are kept sorted by sortEvents
+static int findFirstEvent(const EventHeader* headers, int count, float time)
+{
+	int lo = 0;
+	int hi = count;
+	while (lo < hi)
+	{
+		int mid = (lo + hi) >> 1;
+		if (headers[mid].time < time) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+
 void NodeInstance::queueEvents(RunningContext& rc, float old_time, float time, float length)
 {
 	Node& node = (Node&)source;
 	if (node.events_count <= 0) return;
 
-	if (time < old_time)
-	{
-		EventHeader* headers = (EventHeader*)&node.events[0];
-		for (int i = 0; i < node.events_count; ++i)
+	EventHeader* headers = (EventHeader*)&node.events[0];
+	auto queue_range = [&rc, &node, headers](float from, float to) {
+		for (int i = findFirstEvent(headers, node.events_count, from);
+			 i < node.events_count && headers[i].time < to;
+			 ++i)
 		{
 			EventHeader& header = headers[i];
-			if ((header.time >= old_time && header.time < length) || header.time < time)
-			{
-				rc.event_stream->write(header.type);
-				rc.event_stream->write(rc.controller);
-				rc.event_stream->write(header.size);
-				rc.event_stream->write(
-					&node.events[0] + header.offset + sizeof(EventHeader) * node.events_count, header.size);
-			}
+			rc.event_stream->write(header.type);
+			rc.event_stream->write(rc.controller);
+			rc.event_stream->write(header.size);
+			rc.event_stream->write(
+				&node.events[0] + header.offset + sizeof(EventHeader) * node.events_count, header.size);
 		}
+	};
+
+	if (time < old_time)
+	{
+		queue_range(old_time, length);
+		queue_range(0, time);
 	}
 	else
 	{
-		EventHeader* headers = (EventHeader*)&node.events[0];
-		for (int i = 0; i < node.events_count; ++i)
-		{
-			EventHeader& header = headers[i];
-			if (header.time >= old_time && header.time < time)
-			{
-				rc.event_stream->write(header.type);
-				rc.event_stream->write(rc.controller);
-				rc.event_stream->write(header.size);
-				rc.event_stream->write(
-					&node.events[0] + header.offset + sizeof(EventHeader) * node.events_count, header.size);
-			}
-		}
+		queue_range(old_time, time);
 	}
 }
 
@@ -627,6 +654,7 @@ void StateMachine::deserialize(InputBlob& blob, Container* parent, int version)
 		{
 			blob.read(&entry.condition.bytecode[0], size);
 		}
+		entry.condition.fold();
 	}
 }
 
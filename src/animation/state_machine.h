@@ -78,6 +78,10 @@ struct Node : public Component
 	void serialize(OutputBlob& blob) override;
 	void deserialize(InputBlob& blob, Container* parent, int version) override;
 
+	// keeps the event headers ordered by time so queueEvents can binary search
+	// the window passed this update instead of scanning the whole track
+	void sortEvents();
+
 	IAllocator& allocator;
 	Array<Edge*> out_edges;
 	Array<u8> events;
@@ -169,6 +169,7 @@ struct App
 		m_engine->getPluginManager().load("audio");
 		m_engine->getPluginManager().load("lua_script");
 		m_engine->getPluginManager().load("physics");
+		m_engine->getPluginManager().initPlugins();
 		m_engine->getInputSystem().enable(true);
 		Lumix::Renderer* renderer = static_cast<Lumix::Renderer*>(m_engine->getPluginManager().getPlugin("renderer"));
 		m_pipeline = Lumix::Pipeline::create(*renderer, Lumix::Path(m_pipeline_path), m_engine->getAllocator());
@@ -262,8 +263,29 @@ struct App
 	}
 
 
+	// requests everything the universe needs in one batch, so resource loads
+	// do not wait on the model-material-texture discovery chain
+	void preloadResources(const char* universe_path)
+	{
+		char manifest_path[Lumix::MAX_PATH_LENGTH];
+		Lumix::copyString(manifest_path, universe_path);
+		char* ext = (char*)Lumix::reverseFind(manifest_path, nullptr, '.');
+		if (!ext) return;
+		Lumix::copyString(ext, Lumix::lengthOf(manifest_path) - int(ext - manifest_path), ".res");
+
+		auto& fs = m_engine->getFileSystem();
+		auto* file = fs.open(fs.getDefaultDevice(), Lumix::Path(manifest_path), Lumix::FS::Mode::OPEN_AND_READ);
+		if (!file) return;
+		Lumix::InputBlob blob(file->getBuffer(), (int)file->size());
+		m_engine->preloadResourceManifest(blob);
+		fs.close(*file);
+	}
+
+
 	void loadUniverse(const char* path)
 	{
+		preloadResources(path);
+
 		auto& fs = m_engine->getFileSystem();
 		Lumix::FS::ReadCallback file_read_cb;
 		file_read_cb.bind<App, &App::universeFileLoaded>(this);
@@ -44,6 +44,17 @@ public:
 	static void destroy(AudioDevice& device);
 
 	virtual BufferHandle createBuffer(const void* data, int size_bytes, int channels, int sample_rate, int flags) = 0;
+	// source is a ring of ring_size_bytes of PCM refilled by the caller; byte i of
+	// the stream lives at ring[i % ring_size_bytes] and the producer must stay
+	// ahead of getStreamedPosition(); total_size_bytes is the virtual stream size
+	virtual BufferHandle createRingBuffer(const void* ring,
+		int ring_size_bytes,
+		int total_size_bytes,
+		int channels,
+		int sample_rate,
+		int flags) = 0;
+	// absolute byte position consumed from a ring buffer's source so far
+	virtual int getStreamedPosition(BufferHandle buffer) = 0;
 	virtual void setEcho(BufferHandle handle,
 		float wet_dry_mix,
 		float feedback,
@@ -53,6 +64,9 @@ public:
 	virtual bool isPlaying(BufferHandle buffer) = 0;
 	virtual bool isEnd(BufferHandle buffer) = 0;
 	virtual void stop(BufferHandle buffer) = 0;
+	// stop() releases the buffer asynchronously; returns true once the device is
+	// done with it and the source memory passed to create* can be freed
+	virtual bool isProcessed(BufferHandle buffer) = 0;
 	virtual void pause(BufferHandle buffer) = 0;
 	virtual void setMasterVolume(float volume) = 0;
 	virtual void setVolume(BufferHandle buffer, float volume) = 0;
@@ -9,12 +9,17 @@
 #include "engine/iallocator.h"
 #include "engine/lua_wrapper.h"
 #include "engine/matrix.h"
+#include "engine/mt/thread.h"
+#include "engine/mtjd/generic_job.h"
+#include "engine/mtjd/group.h"
 #include "engine/property_register.h"
 #include "engine/resource_manager.h"
 #include "engine/resource_manager_base.h"
 #include "engine/serializer.h"
 #include "engine/universe/universe.h"
 #include "lua_script/lua_script_system.h"
+#define STB_VORBIS_HEADER_ONLY
+#include "stb/stb_vorbis.cpp"
 
 
 namespace Lumix
@@ -24,6 +29,7 @@ namespace Lumix
 static const ComponentType LISTENER_TYPE = PropertyRegister::getComponentType("audio_listener");
 static const ComponentType AMBIENT_SOUND_TYPE = PropertyRegister::getComponentType("ambient_sound");
 static const ComponentType ECHO_ZONE_TYPE = PropertyRegister::getComponentType("echo_zone");
+static const ComponentType ANIM_CONTROLLER_TYPE = PropertyRegister::getComponentType("anim_controller");
 static const ResourceType CLIP_RESOURCE_TYPE("clip");
 
 
@@ -50,17 +56,49 @@ struct AmbientSound
 };
 
 
+// decode-ahead state of one playing streamed clip; the refill job owns the
+// ring and the decoder while it is in flight
+struct ClipStream
+{
+	static const int RING_SIZE = 256 * 1024;
+
+	explicit ClipStream(IAllocator& allocator)
+		: ring(allocator)
+	{
+	}
+
+	stb_vorbis* decoder = nullptr;
+	Clip* clip = nullptr;
+	Array<u8> ring;
+	int write_pos = 0;
+	bool looped = false;
+};
+
+
 struct PlayingSound
 {
 	AudioDevice::BufferHandle buffer_id;
 	Entity entity;
 	AudioScene::ClipInfo* clip;
+	ClipStream* stream;
 	bool is_3d;
+	// inaudible sounds give up their device voice and only advance a clock
+	bool is_virtual;
+	float virtual_time;
 };
 
 
 struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 {
+	// cap on simultaneously mixed device voices; the rest are virtualized
+	static const int MAX_REAL_VOICES = 32;
+
+	struct DeadStream
+	{
+		ClipStream* stream;
+		AudioDevice::BufferHandle buffer_id;
+	};
+
 	AudioSceneImpl(AudioSystem& system, Universe& context, IAllocator& allocator)
 		: m_allocator(allocator)
 		, m_universe(context)
@@ -69,12 +107,16 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 		, m_device(system.getDevice())
 		, m_ambient_sounds(allocator)
 		, m_echo_zones(allocator)
+		, m_stream_sync(true, allocator)
+		, m_dead_streams(allocator)
 	{
 		m_listener.entity = INVALID_ENTITY;
 		for (auto& i : m_playing_sounds)
 		{
 			i.entity = INVALID_ENTITY;
 			i.buffer_id = AudioDevice::INVALID_BUFFER_HANDLE;
+			i.stream = nullptr;
+			i.is_virtual = false;
 		}
 		context.registerComponentType(LISTENER_TYPE, this, &AudioSceneImpl::serializeListener, &AudioSceneImpl::deserializeListener);
 		context.registerComponentType(AMBIENT_SOUND_TYPE, this, &AudioSceneImpl::serializeAmbientSound, &AudioSceneImpl::deserializeAmbientSound);
@@ -82,6 +124,27 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 	}
 
 
+	~AudioSceneImpl()
+	{
+		for (auto& sound : m_playing_sounds)
+		{
+			if (sound.buffer_id == AudioDevice::INVALID_BUFFER_HANDLE) continue;
+
+			m_device.stop(sound.buffer_id);
+			destroyStream(sound);
+			sound.buffer_id = AudioDevice::INVALID_BUFFER_HANDLE;
+		}
+		// the queued stops are processed within one device tick; wait them out
+		// instead of leaking the decoders
+		updateDeadStreams();
+		while (!m_dead_streams.empty())
+		{
+			MT::sleep(1);
+			updateDeadStreams();
+		}
+	}
+
+
 	void serialize(ISerializer& serializer)
 	{
 		serializer.write("count", m_clips.size());
@@ -227,8 +290,209 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 		}
 	}
 
+	// decodes PCM into the ring until target; runs on an MTJD worker, which
+	// owns the stream while its job is in flight
+	static void fillClipStream(ClipStream* stream, int target)
+	{
+		int channels = stream->clip->getChannels();
+		int frame_size = channels * sizeof(u16);
+		while (stream->write_pos < target)
+		{
+			int ring_offset = stream->write_pos % ClipStream::RING_SIZE;
+			int size = Math::minimum(target - stream->write_pos, ClipStream::RING_SIZE - ring_offset);
+			auto* out = (short*)&stream->ring[ring_offset];
+			int frames = stb_vorbis_get_samples_short_interleaved(
+				stream->decoder, channels, out, size / (int)sizeof(short));
+			if (frames == 0)
+			{
+				if (stream->looped)
+				{
+					stb_vorbis_seek_start(stream->decoder);
+					continue;
+				}
+				setMemory(out, 0, size);
+				stream->write_pos += size;
+				continue;
+			}
+			stream->write_pos += frames * frame_size;
+		}
+	}
+
+
+	void syncStreamJobs()
+	{
+		if (!m_stream_jobs_in_flight) return;
+
+		m_stream_sync.sync();
+		m_stream_jobs_in_flight = false;
+	}
+
+
+	void updateClipStreams()
+	{
+		MTJD::Manager& manager = m_system.getEngine().getMTJDManager();
+		for (auto& sound : m_playing_sounds)
+		{
+			if (sound.buffer_id == AudioDevice::INVALID_BUFFER_HANDLE || !sound.stream) continue;
+
+			ClipStream* stream = sound.stream;
+			int pos = m_device.getStreamedPosition(sound.buffer_id);
+			if (stream->write_pos - pos >= ClipStream::RING_SIZE / 2) continue;
+
+			int frame_size = stream->clip->getChannels() * sizeof(u16);
+			int target = pos + ClipStream::RING_SIZE;
+			target -= target % frame_size;
+			MTJD::Job* job = MTJD::makeJob(manager,
+				[stream, target]() { fillClipStream(stream, target); },
+				manager.getJobAllocator());
+			job->addDependency(&m_stream_sync);
+			manager.schedule(job);
+			m_stream_jobs_in_flight = true;
+		}
+	}
+
+
+	// priority of a playing sound for voice management; 2d sounds score by
+	// plain volume since they are not attenuated by distance
+	float getAudibility(const PlayingSound& sound) const
+	{
+		float volume = sound.clip->volume;
+		if (!sound.is_3d || m_listener.entity == INVALID_ENTITY) return volume;
+		float dist2 = (m_universe.getPosition(sound.entity) - m_universe.getPosition(m_listener.entity))
+						  .squaredLength();
+		return volume / (1 + dist2);
+	}
+
+
+	void virtualizeVoice(PlayingSound& sound)
+	{
+		sound.virtual_time = m_device.getCurrentTime(sound.buffer_id);
+		m_device.stop(sound.buffer_id);
+		sound.buffer_id = AudioDevice::INVALID_BUFFER_HANDLE;
+		sound.is_virtual = true;
+	}
+
+
+	void devirtualizeVoice(PlayingSound& sound)
+	{
+		if (!startVoice(sound, sound.virtual_time)) return;
+		sound.is_virtual = false;
+	}
+
+
+	void updateVirtualVoices(float time_delta)
+	{
+		for (auto& sound : m_playing_sounds)
+		{
+			if (!sound.is_virtual) continue;
+
+			sound.virtual_time += time_delta;
+			Clip* clip = sound.clip->clip;
+			float length = clip && clip->isReady() ? clip->getLengthSeconds() : 0;
+			if (length <= 0) continue;
+			if (sound.clip->looped)
+			{
+				while (sound.virtual_time >= length) sound.virtual_time -= length;
+			}
+			else if (sound.virtual_time >= length)
+			{
+				// ended while inaudible
+				sound.is_virtual = false;
+			}
+		}
+	}
+
+
+	// caps real device voices; the least audible sounds above the cap are
+	// virtualized, virtual sounds that outscore a real voice get it back.
+	// streamed clips keep their decoder state and always stay real
+	void updateVoices(float time_delta)
+	{
+		updateVirtualVoices(time_delta);
+
+		int active[AudioDevice::MAX_PLAYING_SOUNDS];
+		float scores[AudioDevice::MAX_PLAYING_SOUNDS];
+		int count = 0;
+		for (int i = 0; i < lengthOf(m_playing_sounds); ++i)
+		{
+			auto& sound = m_playing_sounds[i];
+			if (sound.buffer_id == AudioDevice::INVALID_BUFFER_HANDLE && !sound.is_virtual) continue;
+			if (sound.stream) continue;
+
+			float score = getAudibility(sound);
+			int j = count;
+			while (j > 0 && scores[j - 1] < score)
+			{
+				scores[j] = scores[j - 1];
+				active[j] = active[j - 1];
+				--j;
+			}
+			scores[j] = score;
+			active[j] = i;
+			++count;
+		}
+
+		for (int i = 0; i < count; ++i)
+		{
+			auto& sound = m_playing_sounds[active[i]];
+			if (i < MAX_REAL_VOICES)
+			{
+				if (sound.is_virtual) devirtualizeVoice(sound);
+			}
+			else if (!sound.is_virtual)
+			{
+				virtualizeVoice(sound);
+			}
+		}
+	}
+
+
+	// the device releases stopped buffers asynchronously, so the ring and the
+	// decoder must stay alive until it reports the buffer processed
+	void destroyStream(PlayingSound& sound)
+	{
+		if (!sound.stream) return;
+
+		syncStreamJobs();
+		DeadStream& dead = m_dead_streams.emplace();
+		dead.stream = sound.stream;
+		dead.buffer_id = sound.buffer_id;
+		sound.stream = nullptr;
+	}
+
+
+	void updateDeadStreams()
+	{
+		for (int i = m_dead_streams.size() - 1; i >= 0; --i)
+		{
+			if (!m_device.isProcessed(m_dead_streams[i].buffer_id)) continue;
+
+			stb_vorbis_close(m_dead_streams[i].stream->decoder);
+			LUMIX_DELETE(m_allocator, m_dead_streams[i].stream);
+			m_dead_streams.eraseFast(i);
+		}
+	}
+
+
+	// update reads listener and sound entity transforms and the animation
+	// event stream, and writes only audio components, so the engine may run
+	// it concurrently with scenes that do not move entities
+	UpdateAccess getUpdateAccess() const override
+	{
+		UpdateAccess access;
+		access.component_writes = (u64)1 << LISTENER_TYPE.index | (u64)1 << AMBIENT_SOUND_TYPE.index |
+								  (u64)1 << ECHO_ZONE_TYPE.index;
+		access.component_reads = access.component_writes | (u64)1 << ANIM_CONTROLLER_TYPE.index;
+		access.transform_read = true;
+		access.transform_write = false;
+		return access;
+	}
+
+
 	void update(float time_delta, bool paused) override
 	{
+		syncStreamJobs();
+
 		if (m_listener.entity != INVALID_ENTITY)
 		{
 			auto pos = m_universe.getPosition(m_listener.entity);
@@ -254,10 +518,14 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 			if (!clip_info->looped && m_device.isEnd(sound.buffer_id))
 			{
 				m_device.stop(sound.buffer_id);
+				destroyStream(m_playing_sounds[i]);
 				m_playing_sounds[i].buffer_id = AudioDevice::INVALID_BUFFER_HANDLE;
 			}
 		}
+		updateVoices(time_delta);
 		m_device.update(time_delta);
+		updateClipStreams();
+		updateDeadStreams();
 
 		updateAnimationEvents();
 	}
@@ -293,8 +561,10 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 			if (i.buffer_id != AudioDevice::INVALID_BUFFER_HANDLE)
 			{
 				m_device.stop(i.buffer_id);
+				destroyStream(i);
 				i.buffer_id = AudioDevice::INVALID_BUFFER_HANDLE;
 			}
+			i.is_virtual = false;
 		}
 
 		for (AmbientSound& sound : m_ambient_sounds)
@@ -493,10 +763,7 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 			serializer.read(clip->looped);
 			serializer.readString(clip->name, lengthOf(clip->name));
 			clip->name_hash = crc32(clip->name);
-			char path[MAX_PATH_LENGTH];
-			serializer.readString(path, lengthOf(path));
-
-			clip->clip = static_cast<Clip*>(m_system.getClipManager().load(Path(path)));
+			clip->clip = static_cast<Clip*>(m_system.getClipManager().load(Path(serializer.readStringView())));
 		}
 
 		serializer.read(count);
@@ -575,8 +842,10 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 			if (i.clip == info && i.buffer_id != AudioDevice::INVALID_BUFFER_HANDLE)
 			{
 				m_device.stop(i.buffer_id);
+				destroyStream(i);
 				i.buffer_id = AudioDevice::INVALID_BUFFER_HANDLE;
 			}
+			if (i.clip == info) i.is_virtual = false;
 		}
 
 		for (AmbientSound& sound : m_ambient_sounds)
@@ -640,44 +909,110 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 	}
 
 
+	// creates the device voice for an already filled sound slot; start_time
+	// resumes a devirtualized sound where it left off
+	bool startVoice(PlayingSound& sound, float start_time)
+	{
+		ClipInfo* clip_info = sound.clip;
+		auto* clip = clip_info->clip;
+		if (!clip || !clip->isReady()) return false;
+
+		int flags = sound.is_3d ? (int)AudioDevice::BufferFlags::IS3D : 0;
+		AudioDevice::BufferHandle buffer;
+		ClipStream* stream = nullptr;
+		if (clip->isStreamed())
+		{
+			stream = LUMIX_NEW(m_allocator, ClipStream)(m_allocator);
+			int error;
+			stream->decoder =
+				stb_vorbis_open_memory(clip->getCompressedData(), clip->getCompressedSize(), &error, nullptr);
+			if (!stream->decoder)
+			{
+				LUMIX_DELETE(m_allocator, stream);
+				return false;
+			}
+			stream->clip = clip;
+			stream->looped = clip_info->looped;
+			stream->ring.resize(ClipStream::RING_SIZE);
+			fillClipStream(stream, ClipStream::RING_SIZE);
+			// looped streams never end, the decoder just seeks back
+			int virtual_size = clip_info->looped ? 0x7fffFFFF : clip->getSize();
+			buffer = m_device.createRingBuffer(&stream->ring[0],
+				ClipStream::RING_SIZE,
+				virtual_size,
+				clip->getChannels(),
+				clip->getSampleRate(),
+				flags);
+		}
+		else
+		{
+			buffer = m_device.createBuffer(
+				clip->getData(), clip->getSize(), clip->getChannels(), clip->getSampleRate(), flags);
+		}
+		if (buffer == AudioDevice::INVALID_BUFFER_HANDLE)
+		{
+			if (stream)
+			{
+				stb_vorbis_close(stream->decoder);
+				LUMIX_DELETE(m_allocator, stream);
+			}
+			return false;
+		}
+		if (start_time > 0) m_device.setCurrentTime(buffer, start_time);
+		m_device.play(buffer, clip_info->looped);
+		m_device.setVolume(buffer, clip_info->volume);
+
+		Vec3 pos = m_universe.getPosition(sound.entity);
+		m_device.setSourcePosition(buffer, pos.x, pos.y, pos.z);
+
+		sound.buffer_id = buffer;
+		sound.stream = stream;
+
+		for (const EchoZone& zone : m_echo_zones)
+		{
+			float dist2 = (pos - m_universe.getPosition(zone.entity)).squaredLength();
+			float r2 = zone.radius * zone.radius;
+			if (dist2 > r2) continue;
+
+			float w = dist2 / r2;
+			m_device.setEcho(buffer, 1, 1 - w, zone.delay, zone.delay);
+			break;
+		}
+
+		return true;
+	}
+
+
 	SoundHandle play(Entity entity, ClipInfo* clip_info, bool is_3d) override
 	{
+		int real_voices = 0;
+		for (auto& i : m_playing_sounds)
+		{
+			if (i.buffer_id != AudioDevice::INVALID_BUFFER_HANDLE) ++real_voices;
+		}
+
 		for (int i = 0; i < lengthOf(m_playing_sounds); ++i)
 		{
-			if (m_playing_sounds[i].buffer_id == AudioDevice::INVALID_BUFFER_HANDLE)
-			{
-				auto* clip = clip_info->clip;
-				if (!clip->isReady()) return -1;
-
-				int flags = is_3d ? (int)AudioDevice::BufferFlags::IS3D : 0;
-				auto buffer = m_device.createBuffer(
-					clip->getData(), clip->getSize(), clip->getChannels(), clip->getSampleRate(), flags);
-				if (buffer == AudioDevice::INVALID_BUFFER_HANDLE) return -1;
-				m_device.play(buffer, clip_info->looped);
-				m_device.setVolume(buffer, clip_info->volume);
-
-				Vec3 pos = m_universe.getPosition(entity);
-				m_device.setSourcePosition(buffer, pos.x, pos.y, pos.z);
-
-				auto& sound = m_playing_sounds[i];
-				sound.is_3d = is_3d;
-				sound.buffer_id = buffer;
-				sound.entity = entity;
-				sound.clip = clip_info;
-
-				for (const EchoZone& zone : m_echo_zones)
-				{
-					float dist2 = (pos - m_universe.getPosition(zone.entity)).squaredLength();
-					float r2 = zone.radius * zone.radius;
-					if (dist2 > r2) continue;
+			auto& sound = m_playing_sounds[i];
+			if (sound.buffer_id != AudioDevice::INVALID_BUFFER_HANDLE || sound.is_virtual) continue;
 
-					float w = dist2 / r2;
-					m_device.setEcho(buffer, 1, 1 - w, zone.delay, zone.delay);
-					break;
-				}
+			sound.is_3d = is_3d;
+			sound.entity = entity;
+			sound.clip = clip_info;
+			sound.stream = nullptr;
 
+			Clip* clip = clip_info->clip;
+			if (real_voices >= MAX_REAL_VOICES && clip && !clip->isStreamed())
+			{
+				// the mixer is saturated; start virtual, updateVoices promotes
+				// it as soon as it outscores a real voice
+				sound.is_virtual = true;
+				sound.virtual_time = 0;
 				return i;
 			}
+
+			if (!startVoice(sound, 0)) return -1;
+			return i;
 		}
 
 		return INVALID_SOUND_HANDLE;
@@ -687,8 +1022,15 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 	void stop(SoundHandle sound_id) override
 	{
 		ASSERT(sound_id >= 0 && sound_id < lengthOf(m_playing_sounds));
-		m_device.stop(m_playing_sounds[sound_id].buffer_id);
-		m_playing_sounds[sound_id].buffer_id = AudioDevice::INVALID_BUFFER_HANDLE;
+		auto& sound = m_playing_sounds[sound_id];
+		if (sound.is_virtual)
+		{
+			sound.is_virtual = false;
+			return;
+		}
+		m_device.stop(sound.buffer_id);
+		destroyStream(sound);
+		sound.buffer_id = AudioDevice::INVALID_BUFFER_HANDLE;
 	}
 
 
@@ -699,6 +1041,7 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 	{
 		if (sound_id == AudioScene::INVALID_SOUND_HANDLE) return;
 		ASSERT(sound_id >= 0 && sound_id < lengthOf(m_playing_sounds));
+		if (m_playing_sounds[sound_id].is_virtual) return;
 		m_device.setVolume(m_playing_sounds[sound_id].buffer_id, volume);
 	}
 
@@ -706,6 +1049,7 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 	void setEcho(SoundHandle sound_id, float wet_dry_mix, float feedback, float left_delay, float right_delay) override
 	{
 		ASSERT(sound_id >= 0 && sound_id < lengthOf(m_playing_sounds));
+		if (m_playing_sounds[sound_id].is_virtual) return;
 		m_device.setEcho(m_playing_sounds[sound_id].buffer_id, wet_dry_mix, feedback, left_delay, right_delay);
 	}
 
@@ -721,6 +1065,9 @@ struct AudioSceneImpl LUMIX_FINAL : public AudioScene
 	Array<ClipInfo*> m_clips;
 	AudioSystem& m_system;
 	PlayingSound m_playing_sounds[AudioDevice::MAX_PLAYING_SOUNDS];
+	MTJD::Group m_stream_sync;
+	bool m_stream_jobs_in_flight = false;
+	Array<DeadStream> m_dead_streams;
 	AnimationScene* m_animation_scene = nullptr;
 };
 
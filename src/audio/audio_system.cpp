@@ -25,33 +25,27 @@ namespace Lumix
 {
 
 
-static void registerProperties(Lumix::IAllocator& allocator)
+static void registerProperties()
 {
-	PropertyRegister::add("ambient_sound",
-		LUMIX_NEW(allocator, DynamicEnumPropertyDescriptor<AudioScene>)("Sound",
-			&AudioScene::getAmbientSoundClipIndex,
-			&AudioScene::setAmbientSoundClipIndex,
-			&AudioScene::getClipCount,
-			&AudioScene::getClipName));
-
-	PropertyRegister::add("ambient_sound",
-		LUMIX_NEW(allocator, BoolPropertyDescriptor<AudioScene>)(
-			"3D", &AudioScene::isAmbientSound3D, &AudioScene::setAmbientSound3D));
-
-	PropertyRegister::add("echo_zone",
-		LUMIX_NEW(allocator, DecimalPropertyDescriptor<AudioScene>)("Radius",
-			&AudioScene::getEchoZoneRadius,
-			&AudioScene::setEchoZoneRadius,
-			0.01f,
-			FLT_MAX,
-			0.1f));
-	PropertyRegister::add("echo_zone",
-		LUMIX_NEW(allocator, DecimalPropertyDescriptor<AudioScene>)("Delay (ms)",
-			&AudioScene::getEchoZoneDelay,
-			&AudioScene::setEchoZoneDelay,
-			0.01f,
-			FLT_MAX,
-			100.0f));
+	static StaticDynamicEnumPropertyDescriptor<AudioScene,
+		&AudioScene::getAmbientSoundClipIndex,
+		&AudioScene::setAmbientSoundClipIndex,
+		&AudioScene::getClipCount,
+		&AudioScene::getClipName>
+		sound("Sound");
+	PropertyRegister::addStatic("ambient_sound", &sound);
+
+	static StaticBoolPropertyDescriptor<AudioScene, &AudioScene::isAmbientSound3D, &AudioScene::setAmbientSound3D>
+		is_3d("3D");
+	PropertyRegister::addStatic("ambient_sound", &is_3d);
+
+	static StaticDecimalPropertyDescriptor<AudioScene, &AudioScene::getEchoZoneRadius, &AudioScene::setEchoZoneRadius>
+		radius("Radius", 0.01f, FLT_MAX, 0.1f);
+	PropertyRegister::addStatic("echo_zone", &radius);
+
+	static StaticDecimalPropertyDescriptor<AudioScene, &AudioScene::getEchoZoneDelay, &AudioScene::setEchoZoneDelay>
+		delay("Delay (ms)", 0.01f, FLT_MAX, 100.0f);
+	PropertyRegister::addStatic("echo_zone", &delay);
 }
 
 
@@ -62,20 +56,24 @@ struct AudioSystemImpl LUMIX_FINAL : public AudioSystem
 		, m_manager(engine.getAllocator())
 		, m_device(nullptr)
 	{
-		registerProperties(engine.getAllocator());
+		registerProperties();
 		AudioScene::registerLuaAPI(m_engine.getState());
-		m_device = AudioDevice::create(m_engine);
 		m_manager.create(CLIP_TYPE, m_engine.getResourceManager());
 	}
 
 
 	~AudioSystemImpl()
 	{
-		AudioDevice::destroy(*m_device);
+		if (m_device) AudioDevice::destroy(*m_device);
 		m_manager.destroy();
 	}
 
 
+	// device creation only talks to the audio backend, so it can overlap the
+	// init of other plugins; the device is ready before the first scene update
+	void initBackground() override { m_device = AudioDevice::create(m_engine); }
+
+
 	Engine& getEngine() override { return m_engine; }
 	AudioDevice& getDevice() override { return *m_device; }
 	ClipManager& getClipManager() override { return m_manager; }
@@ -16,17 +16,39 @@ namespace Lumix
 void Clip::unload()
 {
 	m_data.clear();
+	m_compressed_data.clear();
+	m_is_streamed = false;
 }
 
 
 bool Clip::load(FS::IFile& file)
 {
 	PROFILE_FUNCTION();
+	int error;
+	stb_vorbis* decoder =
+		stb_vorbis_open_memory((unsigned char*)file.getBuffer(), (int)file.size(), &error, nullptr);
+	if (!decoder) return false;
+
+	stb_vorbis_info info = stb_vorbis_get_info(decoder);
+	m_channels = info.channels;
+	m_sample_rate = info.sample_rate;
+	m_frames = stb_vorbis_stream_length_in_samples(decoder);
+	stb_vorbis_close(decoder);
+
+	m_is_streamed = m_frames * m_channels * (int)sizeof(u16) > STREAMED_SIZE_BYTES;
+	if (m_is_streamed)
+	{
+		m_compressed_data.resize((int)file.size());
+		copyMemory(&m_compressed_data[0], file.getBuffer(), (int)file.size());
+		return true;
+	}
+
 	short* output = nullptr;
 	auto res = stb_vorbis_decode_memory(
 		(unsigned char*)file.getBuffer(), (int)file.size(), &m_channels, &m_sample_rate, &output);
 	if (res <= 0) return false;
 
+	m_frames = res;
 	m_data.resize(res * m_channels);
 	copyMemory(&m_data[0], output, res * m_channels * sizeof(m_data[0]));
 	free(output);
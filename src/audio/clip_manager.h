@@ -16,21 +16,33 @@ public:
 	Clip(const Path& path, ResourceManagerBase& manager, IAllocator& allocator)
 		: Resource(path, manager, allocator)
 		, m_data(allocator)
+		, m_compressed_data(allocator)
 	{
 	}
 
+	// clips longer than this stay compressed and are decoded on the fly
+	// while playing; shorter SFX are decoded fully at load
+	static const int STREAMED_SIZE_BYTES = 2 * 1024 * 1024;
+
 	void unload(void) override;
 	bool load(FS::IFile& file) override;
 	int getChannels() const { return m_channels; }
 	int getSampleRate() const { return m_sample_rate; }
-	int getSize() const { return m_data.size() * sizeof(m_data[0]); }
+	// total decoded PCM size, whether or not the clip is resident
+	int getSize() const { return m_frames * m_channels * sizeof(u16); }
 	u16* getData() { return &m_data[0]; }
-	float getLengthSeconds() const { return m_data.size() / float(m_channels * m_sample_rate); }
+	float getLengthSeconds() const { return m_frames / float(m_sample_rate); }
+	bool isStreamed() const { return m_is_streamed; }
+	const u8* getCompressedData() const { return &m_compressed_data[0]; }
+	int getCompressedSize() const { return m_compressed_data.size(); }
 
 private:
 	int m_channels;
 	int m_sample_rate;
+	int m_frames;
+	bool m_is_streamed = false;
 	Array<u16> m_data;
+	Array<u8> m_compressed_data;
 };
 
 
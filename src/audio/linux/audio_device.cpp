@@ -20,6 +20,16 @@ public:
 	{
 		return INVALID_BUFFER_HANDLE;
 	}
+	BufferHandle createRingBuffer(const void* ring,
+		int ring_size_bytes,
+		int total_size_bytes,
+		int channels,
+		int sample_rate,
+		int flags) override
+	{
+		return INVALID_BUFFER_HANDLE;
+	}
+	int getStreamedPosition(BufferHandle buffer) override { return 0; }
 	void setEcho(BufferHandle handle,
 		float wet_dry_mix,
 		float feedback,
@@ -29,6 +39,7 @@ public:
 	bool isPlaying(BufferHandle buffer) override { return false; }
 	void stop(BufferHandle buffer) override {}
 	bool isEnd(BufferHandle buffer) override { return true; }
+	bool isProcessed(BufferHandle buffer) override { return true; }
 	void pause(BufferHandle buffer) override {}
 	void setMasterVolume(float volume) override {}
 	void setVolume(BufferHandle buffer, float volume) override {}
@@ -3,6 +3,9 @@
 #include "engine/engine.h"
 #include "engine/iplugin.h"
 #include "engine/log.h"
+#include "engine/mt/lock_free_fixed_queue.h"
+#include "engine/mt/task.h"
+#include "engine/mt/thread.h"
 #include <cmath>
 #include <dsound.h>
 
@@ -11,6 +14,10 @@ namespace Lumix
 {
 
 
+// all DirectSound calls are made on a dedicated device thread so a stalled
+// game thread can not starve stream refills; the game thread talks to it
+// through a lock-free command queue and gets released voice slots back
+// through a completion queue
 struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 {
 	struct Buffer
@@ -20,21 +27,118 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 		IDirectSoundBuffer8* handle8;
 		const void* data;
 		DWORD data_size;
+		DWORD ring_size;
 		DWORD written;
 		int sparse_idx;
 		bool looped;
 	};
 
+	struct Command
+	{
+		enum Type : i32
+		{
+			CREATE,
+			PLAY,
+			STOP,
+			PAUSE,
+			SET_VOLUME,
+			SET_FREQUENCY,
+			SET_CURRENT_TIME,
+			SET_ECHO,
+			SET_SOURCE_POSITION,
+			SET_LISTENER_POSITION,
+			SET_LISTENER_ORIENTATION,
+			SET_MASTER_VOLUME
+		};
+
+		Type type;
+		i32 sparse_idx;
+		union
+		{
+			struct
+			{
+				const void* data;
+				i32 data_size;
+				i32 ring_size;
+				i32 channels;
+				i32 sample_rate;
+				i32 flags;
+			} create;
+			struct
+			{
+				bool looped;
+			} play;
+			struct
+			{
+				float value;
+			} set_value;
+			struct
+			{
+				float wet_dry_mix;
+				float feedback;
+				float left_delay;
+				float right_delay;
+			} echo;
+			struct
+			{
+				float x, y, z;
+			} position;
+			struct
+			{
+				float front_x, front_y, front_z;
+				float up_x, up_y, up_z;
+			} orientation;
+		};
+	};
+
+	struct Completion
+	{
+		i32 sparse_idx;
+	};
+
+	// refreshed by the device thread every tick, read lock-free by the game
+	// thread; each field is a single aligned word
+	struct VoiceStatus
+	{
+		volatile i32 is_playing;
+		volatile i32 is_end;
+		volatile i32 written;
+		volatile float time;
+	};
+
+	struct DeviceTask : MT::Task
+	{
+		DeviceTask(AudioDeviceImpl& device, IAllocator& allocator)
+			: MT::Task(allocator)
+			, m_device(device)
+		{
+		}
+
+		int task() override { return m_device.deviceTask(); }
+
+		AudioDeviceImpl& m_device;
+	};
+
 	Engine* m_engine;
 	HMODULE m_library;
 	LPDIRECTSOUND8 m_direct_sound;
 	LPDIRECTSOUNDBUFFER m_primary_buffer;
 	LPDIRECTSOUND3DLISTENER8 m_listener;
+	DeviceTask* m_task;
+	MT::LockFreeFixedQueue<Command, 512> m_commands;
+	MT::LockFreeFixedQueue<Completion, MAX_PLAYING_SOUNDS> m_completions;
+	VoiceStatus m_status[MAX_PLAYING_SOUNDS];
+	// game thread only; a slot stays allocated from create* until the device
+	// thread has released the voice and its completion has been drained
+	bool m_slot_allocated[MAX_PLAYING_SOUNDS];
+	i32 m_generation[MAX_PLAYING_SOUNDS];
+	// device thread only
 	Buffer m_buffers[MAX_PLAYING_SOUNDS];
 	int m_buffer_map[MAX_PLAYING_SOUNDS];
 	int m_buffer_count;
 
 	static const int STREAM_SIZE = 32768;
+	static const int DEVICE_PERIOD_MS = 5;
 
 	AudioDeviceImpl()
 	{
@@ -43,11 +147,57 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 		m_direct_sound = nullptr;
 		m_primary_buffer = nullptr;
 		m_listener = nullptr;
+		m_task = nullptr;
 		m_buffer_count = 0;
 		for (auto& i : m_buffer_map)
 		{
 			i = INVALID_BUFFER_HANDLE;
 		}
+		for (int i = 0; i < MAX_PLAYING_SOUNDS; ++i)
+		{
+			m_slot_allocated[i] = false;
+			m_generation[i] = 0;
+		}
+	}
+
+
+	// the sparse slot index lives in the low bits of a handle, the slot's
+	// generation in the high bits, so a handle goes stale the moment its slot
+	// is recycled
+	static int toSparse(BufferHandle handle) { return handle & (MAX_PLAYING_SOUNDS - 1); }
+
+
+	BufferHandle toHandle(int sparse_idx) const
+	{
+		return m_generation[sparse_idx] * MAX_PLAYING_SOUNDS + sparse_idx;
+	}
+
+
+	bool isHandleValid(BufferHandle handle) const
+	{
+		if (handle == INVALID_BUFFER_HANDLE) return false;
+		int sparse_idx = toSparse(handle);
+		return m_slot_allocated[sparse_idx] && toHandle(sparse_idx) == handle;
+	}
+
+
+	void pushCommand(const Command& command)
+	{
+		Command* slot = m_commands.alloc(true);
+		*slot = command;
+		m_commands.push(slot, true);
+	}
+
+
+	void drainCompletions()
+	{
+		while (Completion* completion = m_completions.pop(false))
+		{
+			int sparse_idx = completion->sparse_idx;
+			m_completions.dealoc(completion);
+			m_slot_allocated[sparse_idx] = false;
+			++m_generation[sparse_idx];
+		}
 	}
 
 
@@ -134,12 +284,35 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 			return false;
 		}
 
+		m_task = LUMIX_NEW(engine.getAllocator(), DeviceTask)(*this, engine.getAllocator());
+		if (!m_task->create("audio_device"))
+		{
+			g_log_error.log("Audio") << "Failed to create the audio device thread.";
+			LUMIX_DELETE(engine.getAllocator(), m_task);
+			m_task = nullptr;
+			m_listener->Release();
+			m_listener = nullptr;
+			m_primary_buffer->Release();
+			m_primary_buffer = nullptr;
+			m_direct_sound->Release();
+			m_direct_sound = nullptr;
+			FreeLibrary(m_library);
+			m_library = nullptr;
+			return false;
+		}
+
 		return true;
 	}
 
 
 	~AudioDeviceImpl()
 	{
+		if (m_task)
+		{
+			m_commands.abort();
+			m_task->destroy();
+			LUMIX_DELETE(m_engine->getAllocator(), m_task);
+		}
 		if (m_listener) m_listener->Release();
 		if (m_primary_buffer) m_primary_buffer->Release();
 		if (m_direct_sound) m_direct_sound->Release();
@@ -153,7 +326,358 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 		int sample_rate,
 		int flags) override
 	{
-		if (m_buffer_count == MAX_PLAYING_SOUNDS) return INVALID_BUFFER_HANDLE;
+		return createBufferInternal(data, data_size, 0, channels, sample_rate, flags);
+	}
+
+
+	BufferHandle createRingBuffer(const void* ring,
+		int ring_size_bytes,
+		int total_size_bytes,
+		int channels,
+		int sample_rate,
+		int flags) override
+	{
+		ASSERT(ring_size_bytes >= 2 * STREAM_SIZE);
+		return createBufferInternal(ring, total_size_bytes, ring_size_bytes, channels, sample_rate, flags);
+	}
+
+
+	BufferHandle createBufferInternal(const void* data,
+		int data_size,
+		int ring_size,
+		int channels,
+		int sample_rate,
+		int flags)
+	{
+		drainCompletions();
+		int sparse_idx = -1;
+		for (int i = 0; i < MAX_PLAYING_SOUNDS; ++i)
+		{
+			if (!m_slot_allocated[i])
+			{
+				sparse_idx = i;
+				break;
+			}
+		}
+		if (sparse_idx < 0) return INVALID_BUFFER_HANDLE;
+
+		m_slot_allocated[sparse_idx] = true;
+		m_status[sparse_idx].is_playing = 0;
+		m_status[sparse_idx].is_end = 0;
+		m_status[sparse_idx].written = data_size > STREAM_SIZE ? STREAM_SIZE : data_size;
+		m_status[sparse_idx].time = 0;
+
+		Command command;
+		command.type = Command::CREATE;
+		command.sparse_idx = sparse_idx;
+		command.create.data = data;
+		command.create.data_size = data_size;
+		command.create.ring_size = ring_size;
+		command.create.channels = channels;
+		command.create.sample_rate = sample_rate;
+		command.create.flags = flags;
+		pushCommand(command);
+
+		return toHandle(sparse_idx);
+	}
+
+
+	void setEcho(BufferHandle handle,
+		float wet_dry_mix,
+		float feedback,
+		float left_delay,
+		float right_delay) override
+	{
+		if (!isHandleValid(handle)) return;
+		Command command;
+		command.type = Command::SET_ECHO;
+		command.sparse_idx = toSparse(handle);
+		command.echo.wet_dry_mix = wet_dry_mix;
+		command.echo.feedback = feedback;
+		command.echo.left_delay = left_delay;
+		command.echo.right_delay = right_delay;
+		pushCommand(command);
+	}
+
+
+	bool isPlaying(BufferHandle handle) override
+	{
+		if (!isHandleValid(handle)) return false;
+		return m_status[toSparse(handle)].is_playing != 0;
+	}
+
+
+	void play(BufferHandle handle, bool looped) override
+	{
+		if (!isHandleValid(handle)) return;
+		// set optimistically so isPlaying does not report false until the
+		// device thread gets around to the command
+		m_status[toSparse(handle)].is_playing = 1;
+		Command command;
+		command.type = Command::PLAY;
+		command.sparse_idx = toSparse(handle);
+		command.play.looped = looped;
+		pushCommand(command);
+	}
+
+
+	bool isEnd(BufferHandle handle) override
+	{
+		if (!isHandleValid(handle)) return true;
+		return m_status[toSparse(handle)].is_end != 0;
+	}
+
+
+	void stop(BufferHandle handle) override
+	{
+		if (!isHandleValid(handle)) return;
+		m_status[toSparse(handle)].is_playing = 0;
+		Command command;
+		command.type = Command::STOP;
+		command.sparse_idx = toSparse(handle);
+		pushCommand(command);
+	}
+
+
+	bool isProcessed(BufferHandle handle) override
+	{
+		drainCompletions();
+		return !isHandleValid(handle);
+	}
+
+
+	void pause(BufferHandle handle) override
+	{
+		if (!isHandleValid(handle)) return;
+		m_status[toSparse(handle)].is_playing = 0;
+		Command command;
+		command.type = Command::PAUSE;
+		command.sparse_idx = toSparse(handle);
+		pushCommand(command);
+	}
+
+
+	int getStreamedPosition(BufferHandle handle) override
+	{
+		if (!isHandleValid(handle)) return 0;
+		return m_status[toSparse(handle)].written;
+	}
+
+
+	void setMasterVolume(float volume) override
+	{
+		Command command;
+		command.type = Command::SET_MASTER_VOLUME;
+		command.sparse_idx = -1;
+		command.set_value.value = volume;
+		pushCommand(command);
+	}
+
+
+	void setVolume(BufferHandle handle, float volume) override
+	{
+		if (!isHandleValid(handle)) return;
+		Command command;
+		command.type = Command::SET_VOLUME;
+		command.sparse_idx = toSparse(handle);
+		command.set_value.value = volume;
+		pushCommand(command);
+	}
+
+
+	void setFrequency(BufferHandle handle, float frequency) override
+	{
+		if (!isHandleValid(handle)) return;
+		Command command;
+		command.type = Command::SET_FREQUENCY;
+		command.sparse_idx = toSparse(handle);
+		command.set_value.value = frequency;
+		pushCommand(command);
+	}
+
+
+	float getCurrentTime(BufferHandle handle) override
+	{
+		if (!isHandleValid(handle)) return 0;
+		return m_status[toSparse(handle)].time;
+	}
+
+
+	void setCurrentTime(BufferHandle handle, float time_seconds) override
+	{
+		if (!isHandleValid(handle)) return;
+		Command command;
+		command.type = Command::SET_CURRENT_TIME;
+		command.sparse_idx = toSparse(handle);
+		command.set_value.value = time_seconds;
+		pushCommand(command);
+	}
+
+
+	void setSourcePosition(BufferHandle handle, float x, float y, float z) override
+	{
+		if (!isHandleValid(handle)) return;
+		Command command;
+		command.type = Command::SET_SOURCE_POSITION;
+		command.sparse_idx = toSparse(handle);
+		command.position.x = x;
+		command.position.y = y;
+		command.position.z = z;
+		pushCommand(command);
+	}
+
+
+	void setListenerOrientation(float front_x,
+		float front_y,
+		float front_z,
+		float up_x,
+		float up_y,
+		float up_z) override
+	{
+		Command command;
+		command.type = Command::SET_LISTENER_ORIENTATION;
+		command.sparse_idx = -1;
+		command.orientation.front_x = front_x;
+		command.orientation.front_y = front_y;
+		command.orientation.front_z = front_z;
+		command.orientation.up_x = up_x;
+		command.orientation.up_y = up_y;
+		command.orientation.up_z = up_z;
+		pushCommand(command);
+	}
+
+
+	void setListenerPosition(float x, float y, float z) override
+	{
+		Command command;
+		command.type = Command::SET_LISTENER_POSITION;
+		command.sparse_idx = -1;
+		command.position.x = x;
+		command.position.y = y;
+		command.position.z = z;
+		pushCommand(command);
+	}
+
+
+	void update(float) override { drainCompletions(); }
+
+
+	// everything below runs on the device thread
+
+
+	int deviceTask()
+	{
+		while (!m_commands.isAborted())
+		{
+			while (Command* command = m_commands.pop(false))
+			{
+				Command copy = *command;
+				m_commands.dealoc(command);
+				executeCommand(copy);
+			}
+			updateVoices();
+			MT::sleep(DEVICE_PERIOD_MS);
+		}
+		while (m_buffer_count > 0)
+		{
+			releaseVoice(0);
+		}
+		return 0;
+	}
+
+
+	void executeCommand(const Command& command)
+	{
+		if (command.type == Command::CREATE)
+		{
+			doCreateBuffer(command);
+			return;
+		}
+		if (command.type == Command::SET_MASTER_VOLUME)
+		{
+			float volume = command.set_value.value;
+			LONG v = volume < 0.0001f ? DSBVOLUME_MIN : LONG(-2000.0f * log10(1.0f / volume));
+			m_primary_buffer->SetVolume(v);
+			return;
+		}
+		if (command.type == Command::SET_LISTENER_POSITION)
+		{
+			m_listener->SetPosition(
+				command.position.x, command.position.y, command.position.z, DS3D_DEFERRED);
+			return;
+		}
+		if (command.type == Command::SET_LISTENER_ORIENTATION)
+		{
+			m_listener->SetOrientation(command.orientation.front_x,
+				command.orientation.front_y,
+				command.orientation.front_z,
+				command.orientation.up_x,
+				command.orientation.up_y,
+				command.orientation.up_z,
+				DS3D_DEFERRED);
+			return;
+		}
+
+		// commands targeting a voice whose create failed are dropped here
+		int dense_idx = m_buffer_map[command.sparse_idx];
+		if (dense_idx == INVALID_BUFFER_HANDLE) return;
+		Buffer& buffer = m_buffers[dense_idx];
+		switch (command.type)
+		{
+			case Command::PLAY:
+				buffer.looped = command.play.looped;
+				buffer.handle->Play(0,
+					0,
+					command.play.looped || buffer.data_size > STREAM_SIZE ? DSBPLAY_LOOPING : 0);
+				break;
+			case Command::STOP:
+				releaseVoice(dense_idx);
+				pushCompletion(command.sparse_idx);
+				break;
+			case Command::PAUSE: buffer.handle->Stop(); break;
+			case Command::SET_VOLUME:
+				buffer.handle->SetVolume(
+					DSBVOLUME_MIN + LONG(command.set_value.value * (DSBVOLUME_MAX - DSBVOLUME_MIN)));
+				break;
+			case Command::SET_FREQUENCY:
+				buffer.handle->SetFrequency(
+					DSBFREQUENCY_MIN +
+					DWORD(command.set_value.value * (DSBFREQUENCY_MAX - DSBFREQUENCY_MIN)));
+				break;
+			case Command::SET_CURRENT_TIME: doSetCurrentTime(buffer, command.set_value.value); break;
+			case Command::SET_ECHO:
+				doSetEcho(buffer,
+					command.echo.wet_dry_mix,
+					command.echo.feedback,
+					command.echo.left_delay,
+					command.echo.right_delay);
+				break;
+			case Command::SET_SOURCE_POSITION:
+				if (buffer.handle_3d)
+				{
+					buffer.handle_3d->SetPosition(
+						command.position.x, command.position.y, command.position.z, DS3D_DEFERRED);
+				}
+				break;
+			default: ASSERT(false); break;
+		}
+	}
+
+
+	void pushCompletion(int sparse_idx)
+	{
+		Completion* completion = m_completions.alloc(true);
+		completion->sparse_idx = sparse_idx;
+		m_completions.push(completion, true);
+	}
+
+
+	void doCreateBuffer(const Command& command)
+	{
+		int sparse_idx = command.sparse_idx;
+		const void* data = command.create.data;
+		int data_size = command.create.data_size;
+		DWORD ring_size = command.create.ring_size;
 
 		int buffer_size = data_size > STREAM_SIZE ? STREAM_SIZE : data_size;
 		DSBUFFERDESC desc = {};
@@ -161,14 +685,14 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 		desc.dwSize = sizeof(desc);
 		desc.dwFlags = DSBCAPS_CTRLVOLUME | DSBCAPS_GETCURRENTPOSITION2 | DSBCAPS_CTRLFREQUENCY |
 					   DSBCAPS_CTRLFX;
-		bool is_3d = (flags & (int)BufferFlags::IS3D) != 0;
+		bool is_3d = (command.create.flags & (int)BufferFlags::IS3D) != 0;
 		if (is_3d) desc.dwFlags |= DSBCAPS_CTRL3D;
 		desc.dwBufferBytes = buffer_size;
 
 		WAVEFORMATEX wave_format = {};
 		wave_format.cbSize = 0;
-		wave_format.nChannels = channels;
-		wave_format.nSamplesPerSec = sample_rate;
+		wave_format.nChannels = command.create.channels;
+		wave_format.nSamplesPerSec = command.create.sample_rate;
 		wave_format.wBitsPerSample = 16;
 		wave_format.nBlockAlign = wave_format.nChannels * wave_format.wBitsPerSample / 8;
 		wave_format.nAvgBytesPerSec = wave_format.nSamplesPerSec * wave_format.nBlockAlign;
@@ -176,7 +700,11 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 
 		desc.lpwfxFormat = &wave_format;
 		auto result = SUCCEEDED(m_direct_sound->CreateSoundBuffer(&desc, &buffer, nullptr));
-		if (!result) return INVALID_BUFFER_HANDLE;
+		if (!result)
+		{
+			failCreateBuffer(sparse_idx);
+			return;
+		}
 
 		void* p1;
 		void* p2;
@@ -185,20 +713,23 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 		if (!result)
 		{
 			buffer->Release();
-			return INVALID_BUFFER_HANDLE;
+			failCreateBuffer(sparse_idx);
+			return;
 		}
 		memcpy(p1, data, s1);
 		result = SUCCEEDED(buffer->Unlock(p1, s1, p2, s2));
 		if (!result)
 		{
 			buffer->Release();
-			return INVALID_BUFFER_HANDLE;
+			failCreateBuffer(sparse_idx);
+			return;
 		}
 		result = SUCCEEDED(buffer->SetCurrentPosition(0));
 		if (!result)
 		{
 			buffer->Release();
-			return INVALID_BUFFER_HANDLE;
+			failCreateBuffer(sparse_idx);
+			return;
 		}
 
 		LPDIRECTSOUND3DBUFFER8 source = nullptr;
@@ -212,46 +743,62 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 			}
 		}
 
-		for (int i = 0; i < lengthOf(m_buffer_map); ++i)
-		{
-			if (m_buffer_map[i] == INVALID_BUFFER_HANDLE)
-			{
-				m_buffer_map[i] = m_buffer_count;
-				m_buffers[m_buffer_count].handle = buffer;
-				m_buffers[m_buffer_count].data = data;
-				m_buffers[m_buffer_count].data_size = data_size;
-				m_buffers[m_buffer_count].written = buffer_size;
-				m_buffers[m_buffer_count].sparse_idx = i;
-				m_buffers[m_buffer_count].handle_3d = source;
-				m_buffers[m_buffer_count].handle8 = nullptr;
-				buffer->QueryInterface(
-					IID_IDirectSoundBuffer8, (void**)&m_buffers[m_buffer_count].handle8);
-				++m_buffer_count;
-				return i;
-			}
-		}
+		m_buffer_map[sparse_idx] = m_buffer_count;
+		m_buffers[m_buffer_count].handle = buffer;
+		m_buffers[m_buffer_count].data = data;
+		m_buffers[m_buffer_count].data_size = data_size;
+		m_buffers[m_buffer_count].ring_size = ring_size;
+		m_buffers[m_buffer_count].written = buffer_size;
+		m_buffers[m_buffer_count].sparse_idx = sparse_idx;
+		m_buffers[m_buffer_count].handle_3d = source;
+		m_buffers[m_buffer_count].handle8 = nullptr;
+		m_buffers[m_buffer_count].looped = false;
+		buffer->QueryInterface(IID_IDirectSoundBuffer8, (void**)&m_buffers[m_buffer_count].handle8);
+		++m_buffer_count;
+	}
 
-		ASSERT(false);
-		buffer->Release();
-		return INVALID_BUFFER_HANDLE;
+
+	// a failed create still owes the game thread a completion, otherwise the
+	// slot would leak; the is_end flag makes the voice look finished so the
+	// scene winds it down through the usual path
+	void failCreateBuffer(int sparse_idx)
+	{
+		m_status[sparse_idx].is_playing = 0;
+		m_status[sparse_idx].is_end = 1;
+		pushCompletion(sparse_idx);
 	}
 
 
-	void setEcho(BufferHandle handle,
+	void releaseVoice(int dense_idx)
+	{
+		--m_buffer_count;
+		Buffer& buffer = m_buffers[dense_idx];
+		buffer.handle->Stop();
+		if (buffer.handle_3d) buffer.handle_3d->Release();
+		if (buffer.handle8) buffer.handle8->Release();
+		buffer.handle->Release();
+
+		m_buffer_map[buffer.sparse_idx] = INVALID_BUFFER_HANDLE;
+		m_buffers[dense_idx] = m_buffers[m_buffer_count];
+		m_buffers[m_buffer_count].handle = nullptr;
+		m_buffer_map[m_buffers[dense_idx].sparse_idx] = dense_idx;
+	}
+
+
+	void doSetEcho(Buffer& buffer,
 		float wet_dry_mix,
 		float feedback,
 		float left_delay,
-		float right_delay) override
+		float right_delay)
 	{
-		auto buffer = m_buffers[m_buffer_map[handle]];
 		DSEFFECTDESC echo_effect = {};
 		echo_effect.dwSize = sizeof(DSEFFECTDESC);
 		echo_effect.guidDSFXClass = GUID_DSFX_STANDARD_ECHO;
 		if (!buffer.handle8) return;
 
 		DWORD buffer_status;
-		if(FAILED(buffer.handle->GetStatus(&buffer_status))) return;
-		
+		if (FAILED(buffer.handle->GetStatus(&buffer_status))) return;
+
 		buffer.handle->Stop();
 		DWORD res = 0;
 
@@ -263,8 +810,7 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 			{
 				if (buffer_status & DSBSTATUS_PLAYING)
 				{
-					buffer.handle->Play(0, 0, buffer_status & DSBSTATUS_LOOPING ? DSBPLAY_LOOPING: 0);
-
+					buffer.handle->Play(0, 0, buffer_status & DSBSTATUS_LOOPING ? DSBPLAY_LOOPING : 0);
 				}
 				return;
 			}
@@ -280,7 +826,7 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 		}
 
 		DSFXEcho echo_params;
-		
+
 		echo_params.fFeedback = DSFXECHO_FEEDBACK_MIN + feedback * DSFXECHO_FEEDBACK_MAX;
 		echo_params.fWetDryMix = DSFXECHO_WETDRYMIX_MIN + wet_dry_mix * DSFXECHO_WETDRYMIX_MAX;
 		echo_params.fRightDelay = right_delay;
@@ -294,109 +840,9 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 		}
 	}
 
-	
-	bool isPlaying(BufferHandle handle) override
-	{
-		auto buffer = m_buffers[m_buffer_map[handle]].handle;
-		DWORD status;
-		if (FAILED(buffer->GetStatus(&status))) return false;
-
-		return status & DSBSTATUS_PLAYING;
-	}
-
-
-	void play(BufferHandle handle, bool looped) override
-	{
-		auto& buffer = m_buffers[m_buffer_map[handle]];
-		buffer.looped = looped;
-		buffer.handle->Play(0, 0, looped || buffer.data_size > STREAM_SIZE ? DSBPLAY_LOOPING : 0);
-	}
-
-
-	bool isEnd(BufferHandle handle) override
-	{
-		int dense_idx = m_buffer_map[handle];
-		Buffer& buffer = m_buffers[dense_idx];
-		DWORD rel_pc, rel_wc;
-		DWORD status;
-		if (buffer.data_size <= STREAM_SIZE)
-		{
-			buffer.handle->GetStatus(&status);
-			if ((status & DSBSTATUS_PLAYING) == 0) return true;
-		}
-		buffer.handle->GetCurrentPosition(&rel_pc, &rel_wc);
-		auto rel_written = DWORD(buffer.written % STREAM_SIZE);
-		DWORD abs_pc = buffer.written - (rel_written - rel_pc);
-		if (rel_pc >= rel_written) abs_pc -= STREAM_SIZE;
-		return abs_pc >= buffer.data_size;
-	}
-
-
-	void stop(BufferHandle handle) override
-	{
-		--m_buffer_count;
-		int dense_idx = m_buffer_map[handle];
-
-		auto& buffer = m_buffers[dense_idx];
-		buffer.handle->Stop();
-		if (buffer.handle_3d) buffer.handle_3d->Release();
-		if (buffer.handle8) buffer.handle8->Release();
-		buffer.handle->Release();
-
-		m_buffers[dense_idx] = m_buffers[m_buffer_count];
-		m_buffers[m_buffer_count].handle = nullptr;
-		
-		m_buffer_map[m_buffers[dense_idx].sparse_idx] = dense_idx;
-		m_buffer_map[handle] = -1;
-	}
-
-
-	void pause(BufferHandle handle) override { m_buffers[m_buffer_map[handle]].handle->Stop(); }
-
-
-	void setMasterVolume(float volume) override
-	{
-		LONG v = volume < 0.0001f ? DSBVOLUME_MIN : LONG(-2000.0f * log10(1.0f / volume));
-		m_primary_buffer->SetVolume(v);
-	}
-
-
-	void setVolume(BufferHandle handle, float volume) override
-	{
-		m_buffers[m_buffer_map[handle]].handle->SetVolume(
-			DSBVOLUME_MIN + LONG(volume * (DSBVOLUME_MAX - DSBVOLUME_MIN)));
-	}
-
-
-	void setFrequency(BufferHandle handle, float frequency) override
-	{
-		m_buffers[m_buffer_map[handle]].handle->SetFrequency(
-			DSBFREQUENCY_MIN + DWORD(frequency * (DSBFREQUENCY_MAX - DSBFREQUENCY_MIN)));
-	}
-
-
-	float getCurrentTime(BufferHandle handle) override
-	{
-		auto& buffer = m_buffers[m_buffer_map[handle]];
-
-		WAVEFORMATEX format;
-		if (SUCCEEDED(buffer.handle->GetFormat(&format, sizeof(format), nullptr)))
-		{
-			if (buffer.data_size <= STREAM_SIZE)
-			{
-				DWORD pc, wc;
-				buffer.handle->GetCurrentPosition(&pc, &wc);
-				return pc / (float)format.nAvgBytesPerSec;
-			}
-			return buffer.written / (float)format.nAvgBytesPerSec;
-		}
-		return 0;
-	}
-	
 
-	void setCurrentTime(BufferHandle handle, float time_seconds) override
+	void doSetCurrentTime(Buffer& buffer, float time_seconds)
 	{
-		auto& buffer = m_buffers[m_buffer_map[handle]];
 		WAVEFORMATEX format;
 		if (SUCCEEDED(buffer.handle->GetFormat(&format, sizeof(format), nullptr)))
 		{
@@ -408,12 +854,37 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 			}
 			else
 			{
+				// refill right away so the stale window before the next
+				// device tick is not audible after a seek
 				buffer.written = pos;
+				buffer.handle->SetCurrentPosition(pos % STREAM_SIZE);
+				updateStreamData(buffer, STREAM_SIZE);
 			}
 		}
 	}
 
 
+	// reads size bytes of the source starting at an absolute stream offset;
+	// resident sources are read directly, ring sources wrap modulo ring_size
+	static void copyFromSource(const Buffer& buffer, void* dest, DWORD offset, DWORD size)
+	{
+		if (buffer.ring_size == 0)
+		{
+			memcpy(dest, (u8*)buffer.data + offset, size);
+			return;
+		}
+		DWORD ring_offset = offset % buffer.ring_size;
+		DWORD tail = buffer.ring_size - ring_offset;
+		if (size <= tail)
+		{
+			memcpy(dest, (u8*)buffer.data + ring_offset, size);
+			return;
+		}
+		memcpy(dest, (u8*)buffer.data + ring_offset, tail);
+		memcpy((u8*)dest + tail, buffer.data, size - tail);
+	}
+
+
 	void updateStreamData(Buffer& buffer, DWORD update_size)
 	{
 		DWORD s1, s2;
@@ -427,12 +898,12 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 			if (!p) return;
 			if (buffer.written + size > buffer.data_size)
 			{
-				memcpy(p, (u8*)buffer.data + buffer.written, buffer.data_size - buffer.written);
+				copyFromSource(buffer, p, buffer.written, buffer.data_size - buffer.written);
 				void* p_2 = (u8*)p + (buffer.data_size - buffer.written);
 				DWORD size_2 = size - (buffer.data_size - buffer.written);
 				if (buffer.looped)
 				{
-					memcpy(p_2, buffer.data, size_2);
+					copyFromSource(buffer, p_2, 0, size_2);
 				}
 				else
 				{
@@ -441,7 +912,7 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 			}
 			else
 			{
-				memcpy(p, (u8*)buffer.data + buffer.written, size);
+				copyFromSource(buffer, p, buffer.written, size);
 			}
 			buffer.written += size;
 			buffer.written = buffer.written % buffer.data_size;
@@ -457,50 +928,62 @@ struct AudioDeviceImpl LUMIX_FINAL : public AudioDevice
 	}
 
 
-	void update(float) override 
+	void refreshStatus(Buffer& buffer)
 	{
-		for (int i = 0; i < m_buffer_count; ++i)
-		{
-			auto& buffer = m_buffers[i];
-			if (buffer.data_size <= STREAM_SIZE) continue;
-
-			DWORD rel_pc, rel_wc;
-			buffer.handle->GetCurrentPosition(&rel_pc, &rel_wc);
+		VoiceStatus& status = m_status[buffer.sparse_idx];
+		DWORD dsound_status = 0;
+		if (FAILED(buffer.handle->GetStatus(&dsound_status))) return;
+		status.is_playing = (dsound_status & DSBSTATUS_PLAYING) != 0 ? 1 : 0;
+		status.written = (i32)buffer.written;
 
+		WAVEFORMATEX format;
+		if (FAILED(buffer.handle->GetFormat(&format, sizeof(format), nullptr))) return;
+		DWORD rel_pc, rel_wc;
+		buffer.handle->GetCurrentPosition(&rel_pc, &rel_wc);
+		if (buffer.data_size <= STREAM_SIZE && (dsound_status & DSBSTATUS_PLAYING) == 0)
+		{
+			status.is_end = 1;
+		}
+		else
+		{
 			auto rel_written = DWORD(buffer.written % STREAM_SIZE);
 			DWORD abs_pc = buffer.written - (rel_written - rel_pc);
 			if (rel_pc >= rel_written) abs_pc -= STREAM_SIZE;
-			if (buffer.written - abs_pc < STREAM_SIZE / 2)
-			{
-				DWORD update_size = abs_pc + STREAM_SIZE - buffer.written;
-				updateStreamData(buffer, update_size);
-			}
+			status.is_end = abs_pc >= buffer.data_size ? 1 : 0;
+		}
+		if (buffer.data_size <= STREAM_SIZE)
+		{
+			status.time = rel_pc / (float)format.nAvgBytesPerSec;
+		}
+		else
+		{
+			status.time = buffer.written / (float)format.nAvgBytesPerSec;
 		}
-		m_listener->CommitDeferredSettings(); 
 	}
 
 
-	void setSourcePosition(BufferHandle handle, float x, float y, float z) override
+	void updateVoices()
 	{
-		auto buffer = m_buffers[m_buffer_map[handle]].handle_3d;
-		if (buffer) buffer->SetPosition(x, y, z, DS3D_DEFERRED);
-	}
-
-
-	void setListenerOrientation(float front_x,
-		float front_y,
-		float front_z,
-		float up_x,
-		float up_y,
-		float up_z) override
-	{
-		m_listener->SetOrientation(front_x, front_y, front_z, up_x, up_y, up_z, DS3D_DEFERRED);
-	}
-
+		for (int i = 0; i < m_buffer_count; ++i)
+		{
+			auto& buffer = m_buffers[i];
+			if (buffer.data_size > STREAM_SIZE)
+			{
+				DWORD rel_pc, rel_wc;
+				buffer.handle->GetCurrentPosition(&rel_pc, &rel_wc);
 
-	void setListenerPosition(float x, float y, float z) override
-	{
-		m_listener->SetPosition(x, y, z, DS3D_DEFERRED);
+				auto rel_written = DWORD(buffer.written % STREAM_SIZE);
+				DWORD abs_pc = buffer.written - (rel_written - rel_pc);
+				if (rel_pc >= rel_written) abs_pc -= STREAM_SIZE;
+				if (buffer.written - abs_pc < STREAM_SIZE / 2)
+				{
+					DWORD update_size = abs_pc + STREAM_SIZE - buffer.written;
+					updateStreamData(buffer, update_size);
+				}
+			}
+			refreshStatus(buffer);
+		}
+		m_listener->CommitDeferredSettings();
 	}
 };
 
@@ -516,6 +999,16 @@ public:
 	{
 		return INVALID_BUFFER_HANDLE;
 	}
+	BufferHandle createRingBuffer(const void* ring,
+		int ring_size_bytes,
+		int total_size_bytes,
+		int channels,
+		int sample_rate,
+		int flags) override
+	{
+		return INVALID_BUFFER_HANDLE;
+	}
+	int getStreamedPosition(BufferHandle buffer) override { return 0; }
 	void setEcho(BufferHandle handle,
 		float wet_dry_mix,
 		float feedback,
@@ -525,6 +1018,7 @@ public:
 	bool isPlaying(BufferHandle buffer) override { return false; }
 	void stop(BufferHandle buffer) override {}
 	bool isEnd(BufferHandle buffer) override { return true; }
+	bool isProcessed(BufferHandle buffer) override { return true; }
 	void pause(BufferHandle buffer) override {}
 	void setMasterVolume(float volume) override {}
 	void setVolume(BufferHandle buffer, float volume) override {}
@@ -566,4 +1060,4 @@ void AudioDevice::destroy(AudioDevice& device)
 }
 
 
-} // namespace Lumix
\ No newline at end of file
+} // namespace Lumix
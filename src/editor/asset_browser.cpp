@@ -10,6 +10,7 @@
 #include "engine/resource_manager.h"
 #include "engine/resource_manager_base.h"
 #include "engine/string.h"
+#include "engine/timer.h"
 #include "engine/engine.h"
 #include "file_system_watcher.h"
 #include "metadata.h"
@@ -59,6 +60,7 @@ AssetBrowser::AssetBrowser(StudioApp& app)
 	auto& allocator = editor.getAllocator();
 	m_filter[0] = '\0';
 	m_resources.emplace(allocator);
+	m_changed_files_timer = Lumix::Timer::create(allocator);
 
 	findResources();
 
@@ -114,6 +116,7 @@ AssetBrowser::~AssetBrowser()
 
 	FileSystemWatcher::destroy(m_watchers[0]);
 	FileSystemWatcher::destroy(m_watchers[1]);
+	Lumix::Timer::destroy(m_changed_files_timer);
 }
 
 
@@ -123,7 +126,11 @@ void AssetBrowser::onFileChanged(const char* path)
 	if (!Lumix::isValid(resource_type)) return;
 
 	Lumix::MT::SpinLock lock(m_changed_files_mutex);
-	m_changed_files.push(Lumix::Path(path));
+	// a checkout or export reports the same file several times in a burst;
+	// coalesce by path so every file is reloaded at most once per batch
+	Lumix::Path lumix_path(path);
+	if (m_changed_files.indexOf(lumix_path) < 0) m_changed_files.push(lumix_path);
+	m_changed_files_timer->tick();
 }
 
 
@@ -163,10 +170,14 @@ void AssetBrowser::update()
 		findResources();
 	}
 	if (!m_is_update_enabled) return;
+	static const float EVENT_SETTLE_TIME = 0.2f;
 	bool is_empty;
 	{
 		Lumix::MT::SpinLock lock(m_changed_files_mutex);
 		is_empty = m_changed_files.empty();
+		// let a burst of watcher events (e.g. a branch switch) settle, then
+		// reload the whole batch in one sweep
+		if (!is_empty && m_changed_files_timer->getTimeSinceTick() < EVENT_SETTLE_TIME) return;
 	}
 
 	while (!is_empty)
@@ -277,11 +288,22 @@ void AssetBrowser::onGUI()
 		ImGui::ListBoxHeader("Resources", size);
 		auto& resources = m_resources[m_current_type + 1];
 
+		static const float THUMBNAIL_SIZE = 50;
 		for (auto& resource : resources)
 		{
 			if (m_filter[0] != '\0' && strstr(resource.c_str(), m_filter) == nullptr) continue;
 
 			bool is_selected = m_selected_resource ? m_selected_resource->getPath() == resource : false;
+			// thumbnails are requested only for rows inside the visible region,
+			// so scrolling a huge folder bakes and loads tiles incrementally
+			void* thumbnail = ImGui::IsRectVisible(ImVec2(THUMBNAIL_SIZE, THUMBNAIL_SIZE))
+								  ? m_plugins[m_current_type]->getThumbnail(resource.c_str())
+								  : nullptr;
+			if (thumbnail)
+			{
+				ImGui::Image(thumbnail, ImVec2(THUMBNAIL_SIZE, THUMBNAIL_SIZE));
+				ImGui::SameLine();
+			}
 			if (ImGui::Selectable(resource.c_str(), is_selected))
 			{
 				selectResource(resource, true);
@@ -12,6 +12,7 @@ namespace Lumix
 	class Material;
 	class Resource;
 	struct ResourceType;
+	class Timer;
 	class WorldEditor;
 }
 
@@ -31,6 +32,9 @@ public:
 		virtual ~IPlugin() {}
 
 		virtual bool onGUI(Lumix::Resource* resource, Lumix::ResourceType type) = 0;
+		// ImGui texture id of a cached thumbnail for the file; plugins bake and
+		// load tiles lazily, so this can return nullptr for a few frames
+		virtual void* getThumbnail(const char* path) { return nullptr; }
 		virtual Lumix::ResourceType getResourceType(const char* ext) = 0;
 		virtual void onResourceUnloaded(Lumix::Resource* resource) = 0;
 		virtual const char* getName() const = 0;
@@ -86,6 +90,7 @@ private:
 	int m_history_index;
 	Lumix::Array<IPlugin*> m_plugins;
 	Lumix::MT::SpinMutex m_changed_files_mutex;
+	Lumix::Timer* m_changed_files_timer;
 	Lumix::Array<Lumix::Array<Lumix::Path> > m_resources;
 	Lumix::Resource* m_selected_resource;
 	Lumix::WorldEditor& m_editor;
@@ -175,6 +175,7 @@ public:
 		, m_instances(editor.getAllocator())
 		, m_resources(editor.getAllocator())
 		, m_prefabs(editor.getAllocator())
+		, m_cached_prefabs(editor.getAllocator())
 	{
 		editor.universeCreated().bind<PrefabSystemImpl, &PrefabSystemImpl::onUniverseCreated>(this);
 		editor.universeDestroyed().bind<PrefabSystemImpl, &PrefabSystemImpl::onUniverseDestroyed>(this);
@@ -191,6 +192,10 @@ public:
 		m_editor.universeDestroyed()
 			.unbind<PrefabSystemImpl, &PrefabSystemImpl::onUniverseDestroyed>(this);
 		setUniverse(nullptr);
+		for (auto iter = m_cached_prefabs.begin(), end = m_cached_prefabs.end(); iter != end; ++iter)
+		{
+			LUMIX_DELETE(m_editor.getAllocator(), iter.value());
+		}
 	}
 
 
@@ -365,6 +370,88 @@ public:
 	};
 
 
+	// forwards reads to the text deserializer and records every value read,
+	// so later instances of the same prefab replay raw values instead of
+	// parsing the text stream again
+	struct RecordingDeserializer LUMIX_FINAL : public IDeserializer
+	{
+		RecordingDeserializer(IDeserializer& inner, OutputBlob& record)
+			: m_inner(inner)
+			, m_record(record)
+		{
+		}
+
+		void read(Entity* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(ComponentHandle* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(Transform* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(Vec4* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(Vec3* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(Quat* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(float* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(bool* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(u64* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(i64* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(u32* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(i32* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(u8* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(i8* v) override { m_inner.read(v); m_record.write(*v); }
+		void read(char* value, int max_size) override
+		{
+			m_inner.read(value, max_size);
+			m_record.writeString(value);
+		}
+		Entity getEntity(EntityGUID guid) override { return m_inner.getEntity(guid); }
+
+		IDeserializer& m_inner;
+		OutputBlob& m_record;
+	};
+
+
+	// replays a recorded prefab; values are raw and in exactly the order the
+	// scenes read them while the first instance was created
+	struct ReplayDeserializer LUMIX_FINAL : public IDeserializer
+	{
+		ReplayDeserializer(InputBlob& blob, IEntityGUIDMap& entity_map)
+			: m_blob(blob)
+			, m_entity_map(entity_map)
+		{
+		}
+
+		void read(Entity* v) override { m_blob.read(*v); }
+		void read(ComponentHandle* v) override { m_blob.read(*v); }
+		void read(Transform* v) override { m_blob.read(*v); }
+		void read(Vec4* v) override { m_blob.read(*v); }
+		void read(Vec3* v) override { m_blob.read(*v); }
+		void read(Quat* v) override { m_blob.read(*v); }
+		void read(float* v) override { m_blob.read(*v); }
+		void read(bool* v) override { m_blob.read(*v); }
+		void read(u64* v) override { m_blob.read(*v); }
+		void read(i64* v) override { m_blob.read(*v); }
+		void read(u32* v) override { m_blob.read(*v); }
+		void read(i32* v) override { m_blob.read(*v); }
+		void read(u8* v) override { m_blob.read(*v); }
+		void read(i8* v) override { m_blob.read(*v); }
+		void read(char* value, int max_size) override { m_blob.readString(value, max_size); }
+		Entity getEntity(EntityGUID guid) override { return m_entity_map.get(guid); }
+
+		InputBlob& m_blob;
+		IEntityGUIDMap& m_entity_map;
+	};
+
+
+	struct CachedPrefab
+	{
+		explicit CachedPrefab(IAllocator& allocator)
+			: program(allocator)
+		{
+		}
+
+		OutputBlob program;
+		int source_size = 0;
+		u32 source_crc = 0;
+	};
+
+
 	void instantiatePrefab(PrefabResource& prefab,
 		const Vec3& pos,
 		const Quat& rot,
@@ -376,29 +463,121 @@ public:
 			m_resources.insert(prefab.getPath().getHash(), &prefab);
 			prefab.getResourceManager().load(prefab);
 		}
+
+		u32 path_hash = prefab.getPath().getHash();
+		int source_size = prefab.blob.getPos();
+		u32 source_crc = crc32(prefab.blob.getData(), source_size);
+		auto cache_iter = m_cached_prefabs.find(path_hash);
+		CachedPrefab* cache = cache_iter.isValid() ? cache_iter.value() : nullptr;
+		if (!cache)
+		{
+			cache = LUMIX_NEW(m_editor.getAllocator(), CachedPrefab)(m_editor.getAllocator());
+			cache->source_size = source_size;
+			cache->source_crc = source_crc;
+			m_cached_prefabs.insert(path_hash, cache);
+		}
+		else if (cache->source_size != source_size || cache->source_crc != source_crc)
+		{
+			// the prefab was edited or reloaded; the program is re-recorded
+			cache->program.clear();
+			cache->source_size = source_size;
+			cache->source_crc = source_crc;
+		}
+
+		if (cache->program.getPos() == 0)
+		{
+			instantiateFromSource(prefab, pos, rot, scale, entities, cache->program);
+		}
+		else
+		{
+			instantiateFromProgram(*cache, pos, rot, scale, entities);
+		}
+	}
+
+
+	void instantiateFromSource(PrefabResource& prefab,
+		const Vec3& pos,
+		const Quat& rot,
+		float scale,
+		Array<Entity>* entities,
+		OutputBlob& program)
+	{
 		InputBlob blob(prefab.blob.getData(), prefab.blob.getPos());
 		EntityGUIDMap entity_map;
 		TextDeserializer deserializer(blob, entity_map);
 		while (blob.getPosition() < blob.getSize())
 		{
-			u64 prefab;
-			deserializer.read(&prefab);
+			u64 prefab_id;
+			deserializer.read(&prefab_id);
+			program.write(prefab_id);
 			Entity entity = m_universe->createEntity(pos, rot);
 			if(entities) entities->push(entity);
 			reserve(entity);
-			m_prefabs[entity.index].prefab = prefab;
-			link(entity, prefab);
+			m_prefabs[entity.index].prefab = prefab_id;
+			link(entity, prefab_id);
 			m_universe->setScale(entity, scale);
 			u32 cmp_type_hash;
 			deserializer.read(&cmp_type_hash);
 			while (cmp_type_hash != 0)
 			{
+				program.write(cmp_type_hash);
 				ComponentType cmp_type = PropertyRegister::getComponentTypeFromHash(cmp_type_hash);
 				int scene_version;
 				deserializer.read(&scene_version);
-				m_universe->deserializeComponent(deserializer, entity, cmp_type, scene_version);
+				program.write(scene_version);
+				RecordingDeserializer recorder(deserializer, program);
+				m_universe->deserializeComponent(recorder, entity, cmp_type, scene_version);
 				deserializer.read(&cmp_type_hash);
 			}
+			program.write((u32)0);
+		}
+	}
+
+
+	void instantiateFromProgram(CachedPrefab& cache,
+		const Vec3& pos,
+		const Quat& rot,
+		float scale,
+		Array<Entity>* entities)
+	{
+		InputBlob blob(cache.program.getData(), cache.program.getPos());
+		EntityGUIDMap entity_map;
+		ReplayDeserializer deserializer(blob, entity_map);
+		while (blob.getPosition() < blob.getSize())
+		{
+			u64 prefab_id;
+			blob.read(prefab_id);
+			Entity entity = m_universe->createEntity(pos, rot);
+			if(entities) entities->push(entity);
+			reserve(entity);
+			m_prefabs[entity.index].prefab = prefab_id;
+			link(entity, prefab_id);
+			m_universe->setScale(entity, scale);
+			u32 cmp_type_hash;
+			blob.read(cmp_type_hash);
+			while (cmp_type_hash != 0)
+			{
+				ComponentType cmp_type = PropertyRegister::getComponentTypeFromHash(cmp_type_hash);
+				int scene_version;
+				blob.read(scene_version);
+				m_universe->deserializeComponent(deserializer, entity, cmp_type, scene_version);
+				blob.read(cmp_type_hash);
+			}
+		}
+	}
+
+
+	void instantiatePrefabs(PrefabResource& prefab,
+		const Vec3* positions,
+		const Quat* rotations,
+		float scale,
+		int count,
+		Array<Entity>* entities) override
+	{
+		// the first call records the creation program, the rest replay it
+		for (int i = 0; i < count; ++i)
+		{
+			instantiatePrefab(prefab, positions[i], rotations[i], scale, entities);
 		}
 	}
 
@@ -587,6 +766,7 @@ private:
 	Array<EntityPrefab> m_prefabs;
 	AssociativeArray<u64, Entity> m_instances;
 	HashMap<u32, PrefabResource*> m_resources;
+	HashMap<u32, CachedPrefab*> m_cached_prefabs;
 	Universe* m_universe;
 	WorldEditor& m_editor;
 }; // class PrefabSystemImpl
@@ -37,6 +37,14 @@ public:
 	virtual void serialize(ISerializer& serializer) = 0;
 	virtual void deserialize(IDeserializer& serializer) = 0;
 	virtual const Array<Entity>* instantiatePrefab(PrefabResource& prefab, const Vec3& pos, const Quat& rot, float scale) = 0;
+	// spawns count instances; the first instantiation of a prefab records a
+	// creation program, the rest replay it without parsing the source again
+	virtual void instantiatePrefabs(PrefabResource& prefab,
+		const Vec3* positions,
+		const Quat* rotations,
+		float scale,
+		int count,
+		Array<Entity>* entities) = 0;
 	virtual u64 getPrefab(Entity entity) = 0;
 	virtual int getMaxEntityIndex() const = 0;
 	virtual void setPrefab(Entity entity, u64 prefab) = 0;
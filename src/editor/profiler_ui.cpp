@@ -19,6 +19,7 @@
 
 
 static const int MAX_FRAMES = 200;
+static const int MAX_TRACE_EVENTS = 256 * 1024;
 
 
 enum Column
@@ -48,7 +49,13 @@ struct ProfilerUIImpl LUMIX_FINAL : public ProfilerUI
 		, m_device(allocator)
 		, m_engine(engine)
 		, m_threads(allocator)
+		, m_trace(allocator)
 	{
+		m_trace_next = 0;
+		m_is_trace_enabled = false;
+		m_autosave_trace = false;
+		m_trace_spike_threshold = 100;
+		m_last_trace_save_time = 0;
 		m_allocation_size_from = 0;
 		m_allocation_size_to = 1024 * 1024;
 		m_current_frame = -1;
@@ -320,7 +327,9 @@ struct ProfilerUIImpl LUMIX_FINAL : public ProfilerUI
 		{
 			onGUICPUProfiler();
 			onGUIMemoryProfiler();
+			onGUIGPUMemory();
 			onGUIResources();
+			onGUILoadTelemetry();
 			onGUIFileSystem();
 		}
 		ImGui::EndDock();
@@ -417,8 +426,12 @@ struct ProfilerUIImpl LUMIX_FINAL : public ProfilerUI
 
 	void onGUICPUProfiler();
 	void onGUIMemoryProfiler();
+	void onGUIGPUMemory();
 	void onGUIResources();
+	void onGUILoadTelemetry();
 	void onFrame();
+	void recordTraceEvents(Lumix::u32 thread_id, Lumix::Profiler::Block* remote_block);
+	void saveTrace();
 	void showProfileBlock(Block* block, int column);
 	void cloneBlock(Block* my_block, Lumix::Profiler::Block* remote_block);
 	void addToTree(Lumix::Debug::Allocator::AllocationInfo* info);
@@ -434,6 +447,14 @@ struct ProfilerUIImpl LUMIX_FINAL : public ProfilerUI
 		bool opened;
 	};
 
+	struct TraceEvent
+	{
+		const char* m_name;
+		Lumix::u32 m_thread_id;
+		Lumix::u64 m_start;
+		Lumix::u64 m_length;
+	};
+
 	Lumix::DefaultAllocator m_allocator;
 	Lumix::Array<Thread> m_threads;
 	Block* m_current_block;
@@ -457,6 +478,14 @@ struct ProfilerUIImpl LUMIX_FINAL : public ProfilerUI
 	volatile int m_bytes_read;
 	float m_next_transfer_rate_time;
 	SortOrder m_sort_order;
+	// rolling history of the last MAX_TRACE_EVENTS blocks; m_trace_next is the
+	// oldest entry once the ring has wrapped
+	Lumix::Array<TraceEvent> m_trace;
+	int m_trace_next;
+	bool m_is_trace_enabled;
+	bool m_autosave_trace;
+	float m_trace_spike_threshold;
+	float m_last_trace_save_time;
 };
 
 
@@ -549,6 +578,74 @@ void ProfilerUIImpl::cloneBlock(Block* my_block, Lumix::Profiler::Block* remote_
 }
 
 
+void ProfilerUIImpl::recordTraceEvents(Lumix::u32 thread_id, Lumix::Profiler::Block* remote_block)
+{
+	while (remote_block)
+	{
+		if (Lumix::Profiler::getBlockType(remote_block) == Lumix::Profiler::BlockType::TIME)
+		{
+			const char* name = Lumix::Profiler::getBlockName(remote_block);
+			for (int i = 0, c = Lumix::Profiler::getBlockHitCount(remote_block); i < c; ++i)
+			{
+				TraceEvent event;
+				event.m_name = name;
+				event.m_thread_id = thread_id;
+				event.m_start = Lumix::Profiler::getBlockHitStart(remote_block, i);
+				event.m_length = Lumix::Profiler::getBlockHitLength(remote_block, i);
+				if (m_trace.size() < MAX_TRACE_EVENTS)
+				{
+					m_trace.push(event);
+				}
+				else
+				{
+					m_trace[m_trace_next] = event;
+					m_trace_next = (m_trace_next + 1) % MAX_TRACE_EVENTS;
+				}
+			}
+		}
+		recordTraceEvents(thread_id, Lumix::Profiler::getBlockFirstChild(remote_block));
+		remote_block = Lumix::Profiler::getBlockNext(remote_block);
+	}
+}
+
+
+void ProfilerUIImpl::saveTrace()
+{
+	Lumix::FS::OsFile file;
+	if (!file.open("profile_trace.json", Lumix::FS::Mode::CREATE_AND_WRITE, m_allocator))
+	{
+		Lumix::g_log_error.log("Editor") << "Failed to save trace to profile_trace.json";
+		return;
+	}
+
+	double to_us = 1000000.0 / (double)Lumix::Profiler::frequency();
+	file.write("[", 1);
+	bool first = true;
+	for (int i = 0, c = Lumix::Profiler::getThreadCount(); i < c; ++i)
+	{
+		Lumix::u32 thread_id = Lumix::Profiler::getThreadID(i);
+		Lumix::StaticString<300> line(first ? "\n" : ",\n",
+			"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":", thread_id,
+			",\"args\":{\"name\":\"", Lumix::Profiler::getThreadName(thread_id), "\"}}");
+		file.write(line, Lumix::stringLength(line));
+		first = false;
+	}
+	for (int i = 0, c = m_trace.size(); i < c; ++i)
+	{
+		const TraceEvent& event = m_trace[(m_trace_next + i) % c];
+		Lumix::StaticString<300> line(first ? "\n" : ",\n",
+			"{\"name\":\"", event.m_name, "\",\"ph\":\"X\",\"pid\":0,\"tid\":", event.m_thread_id,
+			",\"ts\":", (Lumix::u64)(event.m_start * to_us),
+			",\"dur\":", (Lumix::u64)(event.m_length * to_us), "}");
+		file.write(line, Lumix::stringLength(line));
+		first = false;
+	}
+	file.write("\n]", 2);
+	file.close();
+	Lumix::g_log_info.log("Editor") << "Trace saved to profile_trace.json";
+}
+
+
 void ProfilerUIImpl::onFrame()
 {
 	if (!m_is_opened) return;
@@ -593,6 +690,19 @@ void ProfilerUIImpl::onFrame()
 		ASSERT(!root || m_threads[i].root->m_name == Lumix::Profiler::getBlockName(root));
 
 		if (m_threads[i].root) cloneBlock(m_threads[i].root, root);
+		if (m_is_trace_enabled && root) recordTraceEvents(thread_id, root);
+	}
+
+	if (m_is_trace_enabled && m_autosave_trace)
+	{
+		float frame_ms = float((m_frame_end - m_frame_start) * 1000.0 / (double)Lumix::Profiler::frequency());
+		// the save itself causes a hitch, do not let it retrigger immediately
+		if (frame_ms > m_trace_spike_threshold &&
+			m_timer->getTimeSinceStart() - m_last_trace_save_time > 1.0f)
+		{
+			m_last_trace_save_time = m_timer->getTimeSinceStart();
+			saveTrace();
+		}
 	}
 }
 
@@ -869,6 +979,71 @@ void ProfilerUIImpl::onGUIResources()
 }
 
 
+void ProfilerUIImpl::onGUILoadTelemetry()
+{
+	if (!ImGui::CollapsingHeader("Resource loads")) return;
+
+	bool enabled = Lumix::Profiler::isLoadTelemetryEnabled();
+	if (ImGui::Checkbox("Record###record_loads", &enabled))
+	{
+		Lumix::Profiler::enableLoadTelemetry(enabled);
+	}
+
+	int count = Lumix::Profiler::getLoadRecordCount();
+	if (count == 0) return;
+
+	Lumix::u64 session_start = Lumix::Profiler::getLoadRecord(0).queued;
+	Lumix::u64 session_end = session_start;
+	for (int i = 0; i < count; ++i)
+	{
+		const Lumix::Profiler::LoadRecord& record = Lumix::Profiler::getLoadRecord(i);
+		if (record.queued < session_start) session_start = record.queued;
+		if (record.ready > session_end) session_end = record.ready;
+	}
+	double to_ms = 1000.0 / (double)Lumix::Profiler::frequency();
+	ImGui::SameLine();
+	ImGui::Text("%d loads in %.0f ms", count, float((session_end - session_start) * to_ms));
+	ImGui::SameLine();
+	ImGui::TextDisabled("gray queue, blue IO, green parse, red dependency wait");
+
+	if (ImGui::BeginChild("load_waterfall", ImVec2(0, 300)))
+	{
+		ImDrawList* draw_list = ImGui::GetWindowDrawList();
+		float width = ImGui::GetContentRegionAvail().x;
+		double to_x = width / double(session_end > session_start ? session_end - session_start : 1);
+		for (int i = 0; i < count; ++i)
+		{
+			const Lumix::Profiler::LoadRecord& record = Lumix::Profiler::getLoadRecord(i);
+			ImVec2 pos = ImGui::GetCursorScreenPos();
+			auto draw_phase = [&](Lumix::u64 from, Lumix::u64 to, Lumix::u32 color) {
+				if (to <= from) return;
+				draw_list->AddRectFilled(
+					ImVec2(pos.x + float((from - session_start) * to_x), pos.y + 2),
+					ImVec2(pos.x + float((to - session_start) * to_x), pos.y + 14),
+					color);
+			};
+			draw_phase(record.queued, record.issued, 0xff808080);
+			draw_phase(record.issued, record.file_read, 0xffcc5030);
+			draw_phase(record.file_read, record.parsed, 0xff30cc30);
+			draw_phase(record.parsed, record.ready, 0xff3030cc);
+			ImGui::Dummy(ImVec2(width, 14));
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::BeginTooltip();
+				ImGui::Text("%s%s", record.path, record.failed ? " (failed)" : "");
+				ImGui::Text("queue %.2f ms, IO %.2f ms, parse %.2f ms, dependencies %.2f ms",
+					float((record.issued - record.queued) * to_ms),
+					float((record.file_read - record.issued) * to_ms),
+					float((record.parsed - record.file_read) * to_ms),
+					float((record.ready - record.parsed) * to_ms));
+				ImGui::EndTooltip();
+			}
+		}
+	}
+	ImGui::EndChild();
+}
+
+
 ProfilerUIImpl::AllocationStackNode* ProfilerUIImpl::getOrCreate(AllocationStackNode* my_node,
 	Lumix::Debug::StackNode* external_node,
 	size_t size)
@@ -993,6 +1168,14 @@ void ProfilerUIImpl::onGUIMemoryProfiler()
 	}
 	ImGui::Text("Total size: %.3fMB", (m_main_allocator.getTotalSize() / 1024) / 1024.0f);
 
+	for (int i = 0, c = Lumix::Profiler::getMemoryTagCount(); i < c; ++i)
+	{
+		ImGui::Text("%s: %.3fMB (%d allocations)",
+			Lumix::Profiler::getMemoryTagName(i),
+			(Lumix::Profiler::getMemoryTagSize(i) / 1024) / 1024.0f,
+			Lumix::Profiler::getMemoryTagAllocationCount(i));
+	}
+
 	ImGui::Columns(2, "memc");
 	for (auto* child : m_allocation_root->m_children)
 	{
@@ -1007,6 +1190,51 @@ void ProfilerUIImpl::onGUIMemoryProfiler()
 }
 
 
+void ProfilerUIImpl::onGUIGPUMemory()
+{
+	if (!ImGui::CollapsingHeader("GPU memory")) return;
+
+	static const char* category_names[] = { "Textures", "Vertex buffers", "Index buffers", "Framebuffers" };
+	ASSERT(Lumix::lengthOf(category_names) == (int)Lumix::Profiler::GPUCategory::COUNT);
+
+	ImGui::Text("Total: %.1fMB, high water %.1fMB",
+		(Lumix::Profiler::getGPUMemoryTotal() / 1024) / 1024.0f,
+		(Lumix::Profiler::getGPUMemoryHighWater() / 1024) / 1024.0f);
+	for (int i = 0; i < (int)Lumix::Profiler::GPUCategory::COUNT; ++i)
+	{
+		ImGui::Text("%s: %.1fMB",
+			category_names[i],
+			(Lumix::Profiler::getGPUMemorySize((Lumix::Profiler::GPUCategory)i) / 1024) / 1024.0f);
+	}
+
+	static float budget_mb = 0;
+	if (ImGui::DragFloat("Budget (MB)###gpu_budget", &budget_mb, 16, 0, 16 * 1024))
+	{
+		Lumix::Profiler::setGPUMemoryBudget((Lumix::u64)budget_mb * 1024 * 1024);
+	}
+
+	ImGui::Columns(3, "gpumemc");
+	ImGui::Text("Name");
+	ImGui::NextColumn();
+	ImGui::Text("Category");
+	ImGui::NextColumn();
+	ImGui::Text("Size");
+	ImGui::NextColumn();
+	ImGui::Separator();
+	for (int i = 0, c = Lumix::Profiler::getGPUAllocCount(); i < c; ++i)
+	{
+		const Lumix::Profiler::GPUAlloc& alloc = Lumix::Profiler::getGPUAlloc(i);
+		ImGui::Text("%s", alloc.name);
+		ImGui::NextColumn();
+		ImGui::Text("%s", category_names[(int)alloc.category]);
+		ImGui::NextColumn();
+		ImGui::Text("%.3fMB", (alloc.size / 1024) / 1024.0f);
+		ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+}
+
+
 static void showThreadColumn(ProfilerUIImpl& profiler, Column column)
 {
 	for (int i = 0; i < profiler.m_threads.size(); ++i)
@@ -1045,6 +1273,22 @@ void ProfilerUIImpl::onGUICPUProfiler()
 	if (!ImGui::CollapsingHeader("CPU")) return;
 
 	ImGui::Checkbox("Pause", &m_is_paused);
+	ImGui::SameLine();
+	ImGui::Checkbox("Capture trace", &m_is_trace_enabled);
+	if (m_is_trace_enabled)
+	{
+		ImGui::SameLine();
+		if (ImGui::Button("Save trace")) saveTrace();
+		ImGui::SameLine();
+		ImGui::Checkbox("Save on spike", &m_autosave_trace);
+		if (m_autosave_trace)
+		{
+			ImGui::SameLine();
+			ImGui::PushItemWidth(100);
+			ImGui::DragFloat("Threshold (ms)", &m_trace_spike_threshold, 1, 1, 10000);
+			ImGui::PopItemWidth();
+		}
+	}
 
 	auto thread_getter = [](void* data, int index, const char** out) -> bool {
 		auto id = Lumix::Profiler::getThreadID(index);
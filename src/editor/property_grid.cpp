@@ -45,9 +45,28 @@ void PropertyGrid::showProperty(Lumix::IPropertyDescriptor& desc,
 	const Lumix::Array<Lumix::Entity>& entities,
 	Lumix::ComponentType cmp_type)
 {
-	if (desc.getType() == Lumix::IPropertyDescriptor::BLOB) return;
+	switch (desc.getType())
+	{
+	case Lumix::IPropertyDescriptor::BLOB: return;
+	case Lumix::IPropertyDescriptor::ARRAY:
+		showArrayProperty(entities, cmp_type, static_cast<Lumix::IArrayDescriptor&>(desc));
+		return;
+	case Lumix::IPropertyDescriptor::SAMPLED_FUNCTION:
+		showSampledFunctionProperty(entities, cmp_type, static_cast<Lumix::ISampledFunctionDescriptor&>(desc));
+		return;
+	case Lumix::IPropertyDescriptor::ENTITY:
+		showEntityProperty(entities, cmp_type, index, static_cast<Lumix::IEnumPropertyDescriptor&>(desc));
+		return;
+	case Lumix::IPropertyDescriptor::ENUM:
+		showEnumProperty(entities, cmp_type, index, static_cast<Lumix::IEnumPropertyDescriptor&>(desc));
+		return;
+	default: break;
+	}
 
-	Lumix::OutputBlob stream(m_editor.getAllocator());
+	// the remaining types are fixed-size values or short strings; reading them
+	// through a stack buffer avoids a heap allocation per property per frame
+	Lumix::u8 stream_mem[1024];
+	Lumix::OutputBlob stream(stream_mem, sizeof(stream_mem));
 	Lumix::ComponentUID first_entity_cmp;
 	first_entity_cmp.type = cmp_type;
 	first_entity_cmp.scene = m_editor.getUniverse()->getScene(cmp_type);
@@ -211,19 +230,6 @@ void PropertyGrid::showProperty(Lumix::IPropertyDescriptor& desc,
 		}
 		break;
 	}
-	case Lumix::IPropertyDescriptor::ARRAY:
-		showArrayProperty(entities, cmp_type, static_cast<Lumix::IArrayDescriptor&>(desc));
-		break;
-	case Lumix::IPropertyDescriptor::SAMPLED_FUNCTION:
-		showSampledFunctionProperty(entities, cmp_type, static_cast<Lumix::ISampledFunctionDescriptor&>(desc));
-		break;
-	case Lumix::IPropertyDescriptor::ENTITY:
-		showEntityProperty(entities, cmp_type, index, static_cast<Lumix::IEnumPropertyDescriptor&>(desc));
-		break;
-	case Lumix::IPropertyDescriptor::ENUM:
-		showEnumProperty(entities, cmp_type, index, static_cast<Lumix::IEnumPropertyDescriptor&>(desc));
-		break;
-	case Lumix::IPropertyDescriptor::BLOB:
 	default:
 		ASSERT(false);
 		break;
@@ -236,15 +242,15 @@ void PropertyGrid::showEntityProperty(const Lumix::Array<Lumix::Entity>& entitie
 	int index,
 	Lumix::IPropertyDescriptor& desc)
 {
-	Lumix::OutputBlob blob(m_editor.getAllocator());
-	
+	Lumix::Entity entity;
+	Lumix::OutputBlob blob(&entity, sizeof(entity));
+
 	Lumix::ComponentUID cmp;
 	cmp.scene = m_editor.getUniverse()->getScene(cmp_type);
 	cmp.type = cmp_type;
 	cmp.entity = entities[0];
 	cmp.handle = cmp.scene->getComponent(cmp.entity, cmp.type);
 	desc.get(cmp, index, blob);
-	Lumix::Entity entity = *(Lumix::Entity*)blob.getData();
 
 	char buf[128];
 	getEntityListDisplayName(m_editor, buf, Lumix::lengthOf(buf), entity);
@@ -285,9 +291,9 @@ void PropertyGrid::showEnumProperty(const Lumix::Array<Lumix::Entity>& entities,
 	cmp.entity = entities[0];
 	cmp.scene = m_editor.getUniverse()->getScene(cmp_type);
 	cmp.handle = cmp.scene->getComponent(cmp.entity, cmp.type);
-	Lumix::OutputBlob blob(m_editor.getAllocator());
+	int value;
+	Lumix::OutputBlob blob(&value, sizeof(value));
 	desc.get(cmp, index, blob);
-	int value = *(int*)blob.getData();
 	int count = desc.getEnumCount(cmp.scene, cmp.handle);
 
 	struct Data
@@ -329,7 +335,7 @@ void PropertyGrid::showSampledFunctionProperty(const Lumix::Array<Lumix::Entity>
 {
 	static const int MIN_COUNT = 6;
 
-	Lumix::OutputBlob blob(m_editor.getAllocator());
+	Lumix::OutputBlob blob(m_app.getFrameAllocator());
 	Lumix::ComponentUID cmp;
 	cmp.type = cmp_type;
 	cmp.entity = entities[0];
@@ -657,7 +663,7 @@ void PropertyGrid::showCoreProperties(const Lumix::Array<Lumix::Entity>& entitie
 		euler.z = Lumix::Math::degreesToRadians(fmodf(euler.z + 180, 360.0f) - 180);
 		rot.fromEuler(euler);
 		
-		Lumix::Array<Lumix::Quat> rots(m_editor.getAllocator());
+		Lumix::Array<Lumix::Quat> rots(m_app.getFrameAllocator());
 		for (Lumix::Entity entity : entities)
 		{
 			Lumix::Vec3 tmp = universe->getRotation(entity).toEuler();
@@ -13,9 +13,12 @@
 #include "engine/debug/debug.h"
 #include "engine/default_allocator.h"
 #include "engine/engine.h"
+#include "engine/frame_allocator.h"
 #include "engine/fs/disk_file_device.h"
+#include "engine/hash_map.h"
 #include "engine/fs/file_system.h"
 #include "engine/fs/os_file.h"
+#include "engine/fs/pack_file_device.h"
 #include "engine/input_system.h"
 #include "engine/log.h"
 #include "engine/lua_wrapper.h"
@@ -26,6 +29,7 @@
 #include "engine/property_register.h"
 #include "engine/quat.h"
 #include "engine/resource_manager.h"
+#include "engine/sort.h"
 #include "engine/system.h"
 #include "engine/timer.h"
 #include "engine/universe/universe.h"
@@ -141,6 +145,7 @@ public:
 		, m_confirm_exit(false)
 		, m_exit_code(0)
 		, m_allocator(m_main_allocator)
+		, m_frame_allocator(m_allocator, 4 * 1024 * 1024)
 		, m_universes(m_allocator)
 	{
 		m_add_cmp_root.label[0] = '\0';
@@ -521,6 +526,8 @@ public:
 	void update()
 	{
 		PROFILE_FUNCTION();
+		// everything UI code took from the frame allocator last frame dies here
+		m_frame_allocator.reset();
 		guiBeginFrame();
 
 		float time_delta = m_editor->getEngine().getLastTimeDelta();
@@ -768,6 +775,7 @@ public:
 	PropertyGrid* getPropertyGrid() override { return m_property_grid; }
 	Metadata* getMetadata() override { return &m_metadata; }
 	LogUI* getLogUI() override { return m_log_ui; }
+	IAllocator& getFrameAllocator() override { return m_frame_allocator; }
 	void toggleGameMode() { m_editor->toggleGameMode(); }
 	void setTranslateGizmoMode() { m_editor->getGizmo().setTranslateMode(); }
 	void setRotateGizmoMode() { m_editor->getGizmo().setRotateMode(); }
@@ -1780,6 +1788,72 @@ public:
 	}
 
 
+	void packDataAddFile(const char* path, AssociativeArray<u32, PackFileInfo>& infos)
+	{
+		u32 hash = crc32(path);
+		if (infos.find(hash) >= 0) return;
+		auto& out_info = infos.emplace(hash);
+		copyString(out_info.path, MAX_PATH_LENGTH, path);
+		out_info.hash = hash;
+		out_info.size = PlatformInterface::getFileSize(path);
+		out_info.offset = ~0UL;
+	}
+
+
+	// dependency closure of every saved universe: each .unv, its directory and
+	// the resources its .res manifest recorded at save time; no universe has to
+	// be loaded for this
+	void packDataScanUniverseList(AssociativeArray<u32, PackFileInfo>& infos)
+	{
+		auto* iter = PlatformInterface::createFileIterator("universes/", m_allocator);
+		PlatformInterface::FileInfo info;
+		while (PlatformInterface::getNextFile(iter, &info))
+		{
+			if (info.filename[0] == '.') continue;
+			if (startsWith(info.filename, "__")) continue;
+			if (info.is_directory)
+			{
+				StaticString<MAX_PATH_LENGTH> dir("universes/", info.filename, "/");
+				packDataScan(dir, infos);
+				continue;
+			}
+
+			char ext[10];
+			PathUtils::getExtension(ext, lengthOf(ext), info.filename);
+			StaticString<MAX_PATH_LENGTH> path("universes/", info.filename);
+			if (equalStrings(ext, "unv")) packDataAddFile(path, infos);
+			if (!equalStrings(ext, "res")) continue;
+
+			packDataAddFile(path, infos);
+			FS::OsFile file;
+			if (!file.open(path, FS::Mode::OPEN_AND_READ, m_allocator)) continue;
+			Array<u8> data(m_allocator);
+			data.resize((int)file.size());
+			if (!data.empty()) file.read(&data[0], data.size());
+			file.close();
+			InputBlob blob(data.empty() ? nullptr : &data[0], data.size());
+			u32 magic;
+			u32 version;
+			blob.read(magic);
+			if (magic != Engine::RESOURCE_MANIFEST_MAGIC) continue;
+			blob.read(version);
+			if (version != Engine::RESOURCE_MANIFEST_VERSION) continue;
+			i32 count;
+			blob.read(count);
+			for (int i = 0; i < count; ++i)
+			{
+				u32 type;
+				char res_path[MAX_PATH_LENGTH];
+				blob.read(type);
+				blob.readString(res_path, lengthOf(res_path));
+				packDataAddFile(res_path, infos);
+			}
+		}
+		PlatformInterface::destroyFileIterator(iter);
+		packDataScan("pipelines/", infos);
+	}
+
+
 	void showPackDataDialog()
 	{
 		m_is_pack_data_dialog_opened = true;
@@ -1800,7 +1874,7 @@ public:
 				}
 			}
 
-			ImGui::Combo("Mode", (int*)&m_pack.mode, "All files\0Loaded universe\0");
+			ImGui::Combo("Mode", (int*)&m_pack.mode, "All files\0Loaded universe\0All universes\0");
 
 			if (ImGui::Button("Pack")) packData();
 		}
@@ -1824,6 +1898,7 @@ public:
 		{
 			case PackConfig::Mode::ALL_FILES: packDataScan("./", infos); break;
 			case PackConfig::Mode::CURRENT_UNIVERSE: packDataScanResources(infos); break;
+			case PackConfig::Mode::ALL_UNIVERSES: packDataScanUniverseList(infos); break;
 			default: ASSERT(false); break;
 		}
 		
@@ -1833,6 +1908,36 @@ public:
 			return;
 		}
 
+		// files the instrumented session loaded go to the front of the pack in
+		// first-use order, so startup reads one contiguous ascending region;
+		// everything else follows in path order. Play the universe with load
+		// telemetry enabled before packing to record the order
+		HashMap<u32, int> ranks(m_allocator);
+		for (int i = 0, c = Profiler::getLoadRecordCount(); i < c; ++i)
+		{
+			u32 hash = crc32(Profiler::getLoadRecord(i).path);
+			if (ranks.find(hash) == ranks.end()) ranks.insert(hash, ranks.size());
+		}
+		Array<PackFileInfo*> order(m_allocator);
+		Array<PackFileInfo*> order_temp(m_allocator);
+		int ranked_count = 0;
+		for (auto& info : infos)
+		{
+			order.push(&info);
+			order_temp.push(nullptr);
+			if (ranks.find(info.hash) != ranks.end()) ++ranked_count;
+		}
+		mergeSort(&order[0], &order_temp[0], order.size(), [&ranks](PackFileInfo* a, PackFileInfo* b) {
+			auto iter_a = ranks.find(a->hash);
+			auto iter_b = ranks.find(b->hash);
+			int rank_a = iter_a != ranks.end() ? iter_a.value() : INT_MAX;
+			int rank_b = iter_b != ranks.end() ? iter_b.value() : INT_MAX;
+			if (rank_a != rank_b) return rank_a < rank_b;
+			return compareString(a->path, b->path) < 0;
+		});
+		g_log_info.log("Editor") << ranked_count << " of " << infos.size()
+								 << " files ordered by recorded first use";
+
 		FS::OsFile file;
 		if (!file.open(dest, FS::Mode::CREATE_AND_WRITE, m_allocator))
 		{
@@ -1840,24 +1945,43 @@ public:
 			return;
 		}
 
+		u32 magic = FS::PackFileDevice::PACK_MAGIC;
+		u32 version = FS::PackFileDevice::PACK_VERSION;
+		file.write(&magic, sizeof(magic));
+		file.write(&version, sizeof(version));
 		int count = infos.size();
 		file.write(&count, sizeof(count));
-		u64 offset = sizeof(count) + (sizeof(u32) + sizeof(u64) * 2) * count;
-		for (auto& info : infos)
+		u64 alignment = FS::PackFileDevice::PACK_ALIGNMENT;
+		u64 offset = sizeof(magic) + sizeof(version) + sizeof(count) + (sizeof(u32) + sizeof(u64) * 2) * count;
+		for (PackFileInfo* info_ptr : order)
 		{
+			auto& info = *info_ptr;
+			offset = (offset + alignment - 1) & ~(alignment - 1);
 			info.offset = offset;
 			offset += info.size;
 		}
 
-		for (auto& info : infos)
+		for (PackFileInfo* info_ptr : order)
 		{
+			auto& info = *info_ptr;
 			file.write(&info.hash, sizeof(info.hash));
 			file.write(&info.offset, sizeof(info.offset));
 			file.write(&info.size, sizeof(info.size));
 		}
 
-		for (auto& info : infos)
+		u64 write_pos = file.pos();
+		for (PackFileInfo* info_ptr : order)
 		{
+			auto& info = *info_ptr;
+			u8 buf[4096];
+			setMemory(buf, 0, sizeof(buf));
+			while (write_pos < info.offset)
+			{
+				size_t padding = Math::minimum((u64)sizeof(buf), info.offset - write_pos);
+				file.write(buf, padding);
+				write_pos += padding;
+			}
+
 			FS::OsFile src;
 			size_t src_size = PlatformInterface::getFileSize(info.path);
 			if (!src.open(info.path, FS::Mode::OPEN_AND_READ, m_allocator))
@@ -1866,7 +1990,6 @@ public:
 				g_log_error.log("Editor") << "Could not open " << info.path;
 				return;
 			}
-			u8 buf[4096];
 			for (; src_size > 0; src_size -= Math::minimum(sizeof(buf), src_size))
 			{
 				size_t batch_size = Math::minimum(sizeof(buf), src_size);
@@ -1877,6 +2000,7 @@ public:
 					return;
 				}
 				file.write(buf, batch_size);
+				write_pos += batch_size;
 			}
 			src.close();
 		}
@@ -2269,6 +2393,7 @@ public:
 
 	DefaultAllocator m_main_allocator;
 	Debug::Allocator m_allocator;
+	FrameAllocator m_frame_allocator;
 	Engine* m_engine;
 	SDL_Window* m_window;
 
@@ -2300,7 +2425,8 @@ public:
 		enum class Mode : int
 		{
 			ALL_FILES,
-			CURRENT_UNIVERSE
+			CURRENT_UNIVERSE,
+			ALL_UNIVERSES
 		};
 
 		Mode mode;
@@ -22,6 +22,7 @@ struct SDL_Window;
 namespace Lumix
 {
 struct ComponentUID;
+class IAllocator;
 struct ResourceType;
 class WorldEditor;
 }
@@ -93,6 +94,9 @@ public:
 	virtual class LogUI* getLogUI() = 0;
 	virtual class AssetBrowser* getAssetBrowser() = 0;
 	virtual Lumix::WorldEditor* getWorldEditor() = 0;
+	// bump arena rewound at the start of every editor frame; UI code uses it
+	// for frame-temporary buffers instead of the heap
+	virtual Lumix::IAllocator& getFrameAllocator() = 0;
 	virtual void addPlugin(IPlugin& plugin) = 0;
 	virtual void removePlugin(IPlugin& plugin) = 0;
 	virtual const char* getComponentTypeName(Lumix::ComponentType cmp_type) const = 0;
@@ -0,0 +1,356 @@
+#include "undo_blob_store.h"
+#include "editor/platform_interface.h"
+#include "engine/blob.h"
+#include "engine/crc32.h"
+#include "engine/engine.h"
+#include "engine/fs/disk_file_device.h"
+#include "engine/fs/file_system.h"
+#include "engine/iallocator.h"
+#include "engine/log.h"
+#include "engine/math_utils.h"
+#include "engine/path.h"
+#include "engine/sort.h"
+#include "engine/string.h"
+
+
+namespace Lumix
+{
+
+
+static const int CHUNK_SIZE = 4096;
+static const size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+
+UndoBlobStore::UndoBlobStore(Engine& engine, IAllocator& allocator)
+	: m_engine(engine)
+	, m_allocator(allocator)
+	, m_chunks(allocator)
+	, m_free_chunks(allocator)
+	, m_blobs(allocator)
+	, m_free_blobs(allocator)
+	, m_chunk_map(allocator)
+	, m_pending_spill(allocator)
+	, m_resident_size(0)
+	, m_stored_size(0)
+	, m_memory_budget(DEFAULT_MEMORY_BUDGET)
+	, m_lru_counter(0)
+	, m_segment_count(0)
+	, m_is_spill_in_flight(false)
+{
+	StaticString<MAX_PATH_LENGTH> dir(engine.getDiskFileDevice()->getBasePath(), ".undo_cache/");
+	PlatformInterface::makePath(dir);
+}
+
+
+UndoBlobStore::~UndoBlobStore()
+{
+	// pending spills copied their data into the IO queue, nothing to wait for
+	for (Chunk& chunk : m_chunks)
+	{
+		if (chunk.data) m_allocator.deallocate(chunk.data);
+	}
+	for (Blob* blob : m_blobs)
+	{
+		LUMIX_DELETE(m_allocator, blob);
+	}
+	const char* base_path = m_engine.getDiskFileDevice()->getBasePath();
+	for (int i = 0; i < m_segment_count; ++i)
+	{
+		char relative[MAX_PATH_LENGTH];
+		getSegmentPath(i, relative, lengthOf(relative));
+		StaticString<MAX_PATH_LENGTH> path(base_path, relative);
+		PlatformInterface::deleteFile(path);
+	}
+}
+
+
+void UndoBlobStore::getSegmentPath(int segment, char* out, int max_size) const
+{
+	copyString(out, max_size, ".undo_cache/spill_");
+	int len = stringLength(out);
+	toCString(segment, out + len, max_size - len);
+	catString(out, max_size, ".bin");
+}
+
+
+UndoBlobStore::Handle UndoBlobStore::store(const void* data, int size)
+{
+	Blob* blob = LUMIX_NEW(m_allocator, Blob)(m_allocator);
+	blob->size = size;
+	const u8* ptr = (const u8*)data;
+	for (int offset = 0; offset < size; offset += CHUNK_SIZE)
+	{
+		int chunk_size = Math::minimum(CHUNK_SIZE, size - offset);
+		blob->chunks.push(findOrAddChunk(ptr + offset, chunk_size));
+	}
+	m_stored_size += size;
+	if (!m_free_blobs.empty())
+	{
+		Handle handle = m_free_blobs.back();
+		m_free_blobs.pop();
+		m_blobs[handle] = blob;
+		return handle;
+	}
+	m_blobs.push(blob);
+	return m_blobs.size() - 1;
+}
+
+
+UndoBlobStore::Handle UndoBlobStore::store(const OutputBlob& blob)
+{
+	return store(blob.getData(), blob.getPos());
+}
+
+
+void UndoBlobStore::release(Handle handle)
+{
+	if (handle == INVALID_HANDLE) return;
+	Blob* blob = m_blobs[handle];
+	for (int chunk_index : blob->chunks)
+	{
+		releaseChunk(chunk_index);
+	}
+	m_stored_size -= blob->size;
+	LUMIX_DELETE(m_allocator, blob);
+	m_blobs[handle] = nullptr;
+	m_free_blobs.push(handle);
+}
+
+
+void UndoBlobStore::read(Handle handle, OutputBlob& out)
+{
+	ASSERT(handle != INVALID_HANDLE);
+	Blob* blob = m_blobs[handle];
+	out.reserve(out.getPos() + blob->size);
+	for (int chunk_index : blob->chunks)
+	{
+		Chunk& chunk = m_chunks[chunk_index];
+		if (!chunk.data) loadChunk(chunk_index);
+		chunk.last_used = ++m_lru_counter;
+		out.write(chunk.data, chunk.size);
+	}
+}
+
+
+int UndoBlobStore::getSize(Handle handle) const
+{
+	if (handle == INVALID_HANDLE) return 0;
+	return m_blobs[handle]->size;
+}
+
+
+int UndoBlobStore::findOrAddChunk(const u8* data, int size)
+{
+	u32 hash = crc32(data, size);
+	auto iter = m_chunk_map.find(hash);
+	int index = iter.isValid() ? iter.value() : -1;
+	while (index >= 0)
+	{
+		Chunk& chunk = m_chunks[index];
+		// the hash only finds candidates, content decides; a collision just
+		// means two chunks share a chain
+		if (chunk.size == size)
+		{
+			if (!chunk.data) loadChunk(index);
+			if (compareMemory(chunk.data, data, size) == 0)
+			{
+				++chunk.ref_count;
+				chunk.last_used = ++m_lru_counter;
+				return index;
+			}
+		}
+		index = chunk.next_with_same_hash;
+	}
+
+	Chunk chunk;
+	chunk.data = (u8*)m_allocator.allocate(size);
+	copyMemory(chunk.data, data, size);
+	chunk.size = size;
+	chunk.hash = hash;
+	chunk.ref_count = 1;
+	chunk.last_used = ++m_lru_counter;
+	chunk.next_with_same_hash = iter.isValid() ? iter.value() : -1;
+	chunk.spill_segment = -1;
+	chunk.spill_offset = 0;
+	chunk.is_spill_pending = false;
+
+	int new_index;
+	if (!m_free_chunks.empty())
+	{
+		new_index = m_free_chunks.back();
+		m_free_chunks.pop();
+		m_chunks[new_index] = chunk;
+	}
+	else
+	{
+		m_chunks.push(chunk);
+		new_index = m_chunks.size() - 1;
+	}
+	if (iter.isValid()) m_chunk_map.erase(hash);
+	m_chunk_map.insert(hash, new_index);
+	m_resident_size += size;
+	return new_index;
+}
+
+
+void UndoBlobStore::releaseChunk(int chunk_index)
+{
+	Chunk& chunk = m_chunks[chunk_index];
+	--chunk.ref_count;
+	if (chunk.ref_count > 0) return;
+	unlinkChunk(chunk_index);
+	// the async spill still reads the data; recycled when the write finishes
+	if (chunk.is_spill_pending) return;
+	recycleChunk(chunk_index);
+}
+
+
+void UndoBlobStore::unlinkChunk(int chunk_index)
+{
+	Chunk& chunk = m_chunks[chunk_index];
+	auto iter = m_chunk_map.find(chunk.hash);
+	ASSERT(iter.isValid());
+	int index = iter.value();
+	if (index == chunk_index)
+	{
+		m_chunk_map.erase(chunk.hash);
+		if (chunk.next_with_same_hash >= 0)
+		{
+			m_chunk_map.insert(chunk.hash, chunk.next_with_same_hash);
+		}
+		return;
+	}
+	while (m_chunks[index].next_with_same_hash != chunk_index)
+	{
+		index = m_chunks[index].next_with_same_hash;
+	}
+	m_chunks[index].next_with_same_hash = chunk.next_with_same_hash;
+}
+
+
+void UndoBlobStore::recycleChunk(int chunk_index)
+{
+	Chunk& chunk = m_chunks[chunk_index];
+	if (chunk.data)
+	{
+		m_allocator.deallocate(chunk.data);
+		chunk.data = nullptr;
+		m_resident_size -= chunk.size;
+	}
+	m_free_chunks.push(chunk_index);
+}
+
+
+void UndoBlobStore::loadChunk(int chunk_index)
+{
+	Chunk& chunk = m_chunks[chunk_index];
+	ASSERT(!chunk.data && chunk.spill_segment >= 0 && !chunk.is_spill_pending);
+	char path[MAX_PATH_LENGTH];
+	getSegmentPath(chunk.spill_segment, path, lengthOf(path));
+	FS::FileSystem& fs = m_engine.getFileSystem();
+	FS::IFile* file = fs.open(fs.getDiskDevice(), Path(path), FS::Mode::OPEN_AND_READ);
+	chunk.data = (u8*)m_allocator.allocate(chunk.size);
+	if (file)
+	{
+		file->seek(FS::SeekMode::BEGIN, chunk.spill_offset);
+		file->read(chunk.data, chunk.size);
+		fs.close(*file);
+	}
+	else
+	{
+		g_log_error.log("Editor") << "Failed to load spilled undo history from " << path;
+		setMemory(chunk.data, 0, chunk.size);
+	}
+	m_resident_size += chunk.size;
+}
+
+
+void UndoBlobStore::update()
+{
+	if (m_is_spill_in_flight) return;
+	if (m_resident_size <= m_memory_budget) return;
+
+	// oldest first; chunks that already sit in a segment are dropped without IO
+	Array<u32> keys(m_allocator);
+	Array<int> values(m_allocator);
+	for (int i = 0, c = m_chunks.size(); i < c; ++i)
+	{
+		const Chunk& chunk = m_chunks[i];
+		if (!chunk.data || chunk.ref_count <= 0) continue;
+		keys.push(chunk.last_used);
+		values.push(i);
+	}
+	if (keys.empty()) return;
+	Array<u32> temp_keys(m_allocator);
+	Array<int> temp_values(m_allocator);
+	temp_keys.resize(keys.size());
+	temp_values.resize(values.size());
+	radixSort(&keys[0], &values[0], &temp_keys[0], &temp_values[0], keys.size());
+
+	// free a quarter below the budget so one spill lasts a while
+	size_t target = m_memory_budget - m_memory_budget / 4;
+	size_t planned_resident = m_resident_size;
+	OutputBlob segment_data(m_allocator);
+	for (int i = 0; i < values.size() && planned_resident > target; ++i)
+	{
+		Chunk& chunk = m_chunks[values[i]];
+		if (chunk.spill_segment >= 0)
+		{
+			m_allocator.deallocate(chunk.data);
+			chunk.data = nullptr;
+			m_resident_size -= chunk.size;
+			planned_resident -= chunk.size;
+			continue;
+		}
+		chunk.spill_segment = m_segment_count;
+		chunk.spill_offset = segment_data.getPos();
+		chunk.is_spill_pending = true;
+		segment_data.write(chunk.data, chunk.size);
+		m_pending_spill.push(values[i]);
+		planned_resident -= chunk.size;
+	}
+	if (m_pending_spill.empty()) return;
+
+	char path[MAX_PATH_LENGTH];
+	getSegmentPath(m_segment_count, path, lengthOf(path));
+	++m_segment_count;
+	FS::FileSystem& fs = m_engine.getFileSystem();
+	FS::ReadCallback cb;
+	cb.bind<UndoBlobStore, &UndoBlobStore::onSpillWritten>(this);
+	m_is_spill_in_flight = true;
+	fs.writeAsync(fs.getDiskDevice(), Path(path), segment_data.getData(), segment_data.getPos(), cb);
+}
+
+
+void UndoBlobStore::onSpillWritten(FS::IFile&, bool success)
+{
+	for (int chunk_index : m_pending_spill)
+	{
+		Chunk& chunk = m_chunks[chunk_index];
+		chunk.is_spill_pending = false;
+		if (chunk.ref_count <= 0)
+		{
+			// released while the write was in flight
+			recycleChunk(chunk_index);
+			continue;
+		}
+		if (success)
+		{
+			m_allocator.deallocate(chunk.data);
+			chunk.data = nullptr;
+			m_resident_size -= chunk.size;
+		}
+		else
+		{
+			// keep the chunk resident, the segment cannot be trusted
+			chunk.spill_segment = -1;
+			chunk.spill_offset = 0;
+		}
+	}
+	if (!success) g_log_error.log("Editor") << "Failed to spill undo history to disk";
+	m_pending_spill.clear();
+	m_is_spill_in_flight = false;
+}
+
+
+} // namespace Lumix
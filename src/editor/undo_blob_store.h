@@ -0,0 +1,107 @@
+#pragma once
+
+
+#include "engine/lumix.h"
+#include "engine/array.h"
+#include "engine/hash_map.h"
+
+
+namespace Lumix
+{
+
+
+class Engine;
+class OutputBlob;
+
+namespace FS
+{
+class IFile;
+}
+
+
+// content-addressed storage for undo command snapshots; blobs are split into
+// chunks deduplicated by hash, so history entries that serialize the same
+// entities share memory instead of each owning a full copy. Cold chunks are
+// spilled to disk through the async write path when the resident set exceeds
+// the budget and are reloaded transparently on read.
+class LUMIX_EDITOR_API UndoBlobStore
+{
+public:
+	typedef u32 Handle;
+	static const Handle INVALID_HANDLE = 0xffffFFFF;
+
+public:
+	UndoBlobStore(Engine& engine, IAllocator& allocator);
+	~UndoBlobStore();
+
+	// returns a handle owning one reference to the deduplicated content
+	Handle store(const void* data, int size);
+	Handle store(const OutputBlob& blob);
+	void release(Handle handle);
+	// reassembles the blob; spilled chunks are loaded back first
+	void read(Handle handle, OutputBlob& out);
+	int getSize(Handle handle) const;
+
+	void setMemoryBudget(size_t bytes) { m_memory_budget = bytes; }
+	size_t getMemoryBudget() const { return m_memory_budget; }
+	// bytes currently held in memory, after dedup and spilling
+	size_t getResidentSize() const { return m_resident_size; }
+	// bytes the stored blobs would occupy without dedup
+	size_t getStoredSize() const { return m_stored_size; }
+	// spills least recently used chunks when over budget; call once per frame
+	void update();
+
+private:
+	struct Chunk
+	{
+		u8* data;
+		int size;
+		u32 hash;
+		int ref_count;
+		u32 last_used;
+		int next_with_same_hash;
+		int spill_segment;
+		int spill_offset;
+		bool is_spill_pending;
+	};
+
+	struct Blob
+	{
+		explicit Blob(IAllocator& allocator)
+			: chunks(allocator)
+			, size(0)
+		{
+		}
+
+		Array<int> chunks;
+		int size;
+	};
+
+private:
+	int findOrAddChunk(const u8* data, int size);
+	void loadChunk(int chunk_index);
+	void releaseChunk(int chunk_index);
+	void unlinkChunk(int chunk_index);
+	void recycleChunk(int chunk_index);
+	void getSegmentPath(int segment, char* out, int max_size) const;
+	void onSpillWritten(FS::IFile& file, bool success);
+
+private:
+	Engine& m_engine;
+	IAllocator& m_allocator;
+	Array<Chunk> m_chunks;
+	Array<int> m_free_chunks;
+	Array<Blob*> m_blobs;
+	Array<int> m_free_blobs;
+	HashMap<u32, int> m_chunk_map;
+	Array<int> m_pending_spill;
+	size_t m_resident_size;
+	size_t m_stored_size;
+	size_t m_memory_budget;
+	u32 m_lru_counter;
+	int m_segment_count;
+	bool m_is_spill_in_flight;
+};
+
+
+} // namespace Lumix
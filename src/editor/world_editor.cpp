@@ -6,6 +6,7 @@
 #include "editor/measure_tool.h"
 #include "editor/platform_interface.h"
 #include "editor/prefab_system.h"
+#include "editor/undo_blob_store.h"
 #include "engine/array.h"
 #include "engine/associative_array.h"
 #include "engine/blob.h"
@@ -707,8 +708,6 @@ public:
 			u64 prefab = prefab_system.getPrefab(entities[i]);
 			if (prefab == 0)
 			{
-				ComponentUID component = m_editor.getUniverse()->getComponent(entities[i], component_type);
-				m_property_descriptor->get(component, index, m_old_value);
 				m_entities.push(entities[i]);
 			}
 			else
@@ -716,8 +715,6 @@ public:
 				Entity instance = prefab_system.getFirstInstance(prefab);
 				while(isValid(instance))
 				{
-					ComponentUID component = m_editor.getUniverse()->getComponent(instance, component_type);
-					m_property_descriptor->get(component, index, m_old_value);
 					m_entities.push(instance);
 					instance = prefab_system.getNextInstance(instance);
 				}
@@ -780,7 +777,19 @@ public:
 
 	bool execute() override
 	{
+		// the old value is captured lazily on the first execute, so commands
+		// that are merged away during a slider drag never serialize anything
+		if (m_old_value.getPos() == 0)
+		{
+			for (Entity entity : m_entities)
+			{
+				ComponentUID component = m_editor.getUniverse()->getComponent(entity, m_component_type);
+				m_property_descriptor->get(component, m_index, m_old_value);
+			}
+		}
 		InputBlob blob(m_new_value);
+		Array<ComponentUID> components(m_editor.getAllocator());
+		components.reserve(m_entities.size());
 		for (Entity entity : m_entities)
 		{
 			if (m_editor.getEditCamera().entity == entity && m_component_type == CAMERA_TYPE &&
@@ -788,9 +797,11 @@ public:
 			{
 				continue;
 			}
-			ComponentUID component = m_editor.getUniverse()->getComponent(entity, m_component_type);
-			blob.rewind();
-			m_property_descriptor->set(component, m_index, blob);
+			components.push(m_editor.getUniverse()->getComponent(entity, m_component_type));
+		}
+		if (!components.empty())
+		{
+			m_property_descriptor->setBatch(&components[0], components.size(), m_index, blob);
 		}
 		return true;
 	}
@@ -960,7 +971,7 @@ private:
 			: m_editor(static_cast<WorldEditorImpl&>(editor))
 			, m_entities(editor.getAllocator())
 			, m_transformations(editor.getAllocator())
-			, m_old_values(editor.getAllocator())
+			, m_old_values(UndoBlobStore::INVALID_HANDLE)
 			, m_resources(editor.getAllocator())
 		{
 		}
@@ -970,7 +981,7 @@ private:
 			: m_editor(editor)
 			, m_entities(editor.getAllocator())
 			, m_transformations(editor.getAllocator())
-			, m_old_values(editor.getAllocator())
+			, m_old_values(UndoBlobStore::INVALID_HANDLE)
 			, m_resources(editor.getAllocator())
 		{
 			m_entities.reserve(count);
@@ -984,6 +995,7 @@ private:
 
 		~DestroyEntitiesCommand()
 		{
+			m_editor.getUndoBlobStore().release(m_old_values);
 			for (Resource* resource : m_resources)
 			{
 				resource->getResourceManager().unload(*resource);
@@ -1036,7 +1048,9 @@ private:
 		{
 			Universe* universe = m_editor.getUniverse();
 			m_transformations.clear();
-			m_old_values.clear();
+			UndoBlobStore& blob_store = m_editor.getUndoBlobStore();
+			blob_store.release(m_old_values);
+			OutputBlob old_values(m_editor.getAllocator());
 			ResourceManager& resource_manager = m_editor.getEngine().getResourceManager();
 			for (int i = 0; i < m_entities.size(); ++i)
 			{
@@ -1049,17 +1063,17 @@ private:
 					++count;
 				}
 				EntityGUID guid = m_editor.m_entity_map.get(m_entities[i]);
-				m_old_values.write(guid.value);
-				m_old_values.write(count);
+				old_values.write(guid.value);
+				old_values.write(count);
 				for (ComponentUID cmp = universe->getFirstComponent(m_entities[i]);
 					cmp.isValid();
 					cmp = universe->getNextComponent(cmp))
 				{
-					m_old_values.write(cmp.type);
+					old_values.write(cmp.type);
 					Array<IPropertyDescriptor*>& props = PropertyRegister::getDescriptors(cmp.type);
 					for (int k = 0; k < props.size(); ++k)
 					{
-						props[k]->get(cmp, -1, m_old_values);
+						props[k]->get(cmp, -1, old_values);
 						if (props[k]->getType() == IPropertyDescriptor::RESOURCE)
 						{
 							auto* resource_prop = static_cast<IResourcePropertyDescriptor*>(props[k]);
@@ -1073,11 +1087,12 @@ private:
 					}
 				}
 				u64 prefab = m_editor.getPrefabSystem().getPrefab(m_entities[i]);
-				m_old_values.write(prefab);
+				old_values.write(prefab);
 
 				universe->destroyEntity(m_entities[i]);
 				m_editor.m_entity_map.erase(m_entities[i]);
 			}
+			m_old_values = blob_store.store(old_values);
 			return true;
 		}
 
@@ -1088,7 +1103,9 @@ private:
 		void undo() override
 		{
 			Universe* universe = m_editor.getUniverse();
-			InputBlob blob(m_old_values);
+			OutputBlob old_values(m_editor.getAllocator());
+			m_editor.getUndoBlobStore().read(m_old_values, old_values);
+			InputBlob blob(old_values.getData(), old_values.getPos());
 			for (int i = 0; i < m_entities.size(); ++i)
 			{
 				Entity new_entity =
@@ -1131,7 +1148,7 @@ private:
 		WorldEditorImpl& m_editor;
 		Array<Entity> m_entities;
 		Array<Transform> m_transformations;
-		OutputBlob m_old_values;
+		UndoBlobStore::Handle m_old_values;
 		Array<Resource*> m_resources;
 	};
 
@@ -1141,7 +1158,7 @@ private:
 	public:
 		explicit DestroyComponentCommand(WorldEditor& editor)
 			: m_editor(static_cast<WorldEditorImpl&>(editor))
-			, m_old_values(editor.getAllocator())
+			, m_old_values(UndoBlobStore::INVALID_HANDLE)
 			, m_entities(editor.getAllocator())
 			, m_cmp_type(INVALID_COMPONENT_TYPE)
 			, m_resources(editor.getAllocator())
@@ -1152,7 +1169,7 @@ private:
 		DestroyComponentCommand(WorldEditorImpl& editor, const Entity* entities, int count, ComponentType cmp_type)
 			: m_cmp_type(cmp_type)
 			, m_editor(editor)
-			, m_old_values(editor.getAllocator())
+			, m_old_values(UndoBlobStore::INVALID_HANDLE)
 			, m_entities(editor.getAllocator())
 			, m_resources(editor.getAllocator())
 		{
@@ -1180,6 +1197,7 @@ private:
 
 		~DestroyComponentCommand()
 		{
+			m_editor.getUndoBlobStore().release(m_old_values);
 			for (Resource* resource : m_resources)
 			{
 				resource->getResourceManager().unload(*resource);
@@ -1222,7 +1240,9 @@ private:
 			cmp.scene = m_editor.getUniverse()->getScene(m_cmp_type);
 			cmp.type = m_cmp_type;
 			ASSERT(cmp.scene);
-			InputBlob blob(m_old_values);
+			OutputBlob old_values(m_editor.getAllocator());
+			m_editor.getUndoBlobStore().read(m_old_values, old_values);
+			InputBlob blob(old_values.getData(), old_values.getPos());
 			const Array<IPropertyDescriptor*>& props = PropertyRegister::getDescriptors(cmp.type);
 			for (Entity entity : m_entities)
 			{
@@ -1251,6 +1271,9 @@ private:
 			if (m_entities.empty()) return false;
 			if (!cmp.scene) return false;
 			ResourceManager& resource_manager = m_editor.getEngine().getResourceManager();
+			UndoBlobStore& blob_store = m_editor.getUndoBlobStore();
+			blob_store.release(m_old_values);
+			OutputBlob old_values(m_editor.getAllocator());
 
 			for (Entity entity : m_entities)
 			{
@@ -1258,7 +1281,7 @@ private:
 				cmp.handle = cmp.scene->getComponent(entity, m_cmp_type);
 				for (int i = 0; i < props.size(); ++i)
 				{
-					props[i]->get(cmp, -1, m_old_values);
+					props[i]->get(cmp, -1, old_values);
 					if (props[i]->getType() == IPropertyDescriptor::RESOURCE)
 					{
 						auto* res_prop = static_cast<IResourcePropertyDescriptor*>(props[i]);
@@ -1272,6 +1295,7 @@ private:
 				}
 				cmp.scene->destroyComponent(cmp.handle, m_cmp_type);
 			}
+			m_old_values = blob_store.store(old_values);
 			return true;
 		}
 
@@ -1279,7 +1303,7 @@ private:
 		Array<Entity> m_entities;
 		ComponentType m_cmp_type;
 		WorldEditorImpl& m_editor;
-		OutputBlob m_old_values;
+		UndoBlobStore::Handle m_old_values;
 		Array<Resource*> m_resources;
 	};
 
@@ -1370,6 +1394,9 @@ public:
 	Engine& getEngine() override { return *m_engine; }
 
 
+	UndoBlobStore& getUndoBlobStore() override { return *m_undo_blob_store; }
+
+
 	void showGizmos()
 	{
 		if (m_selected_entities.empty()) return;
@@ -1440,6 +1467,7 @@ public:
 	{
 		PROFILE_FUNCTION();
 		updateGoTo();
+		m_undo_blob_store->update();
 
 		if (!m_selected_entities.empty())
 		{
@@ -1474,6 +1502,7 @@ public:
 		PrefabSystem::destroy(m_prefab_system);
 
 		LUMIX_DELETE(m_allocator, m_render_interface);
+		LUMIX_DELETE(m_allocator, m_undo_blob_store);
 	}
 
 
@@ -1671,12 +1700,18 @@ public:
 	{
 		g_log_info.log("Editor") << "Saving universe " << basename << "...";
 		
+		// serialize on the main thread, write on an IO thread; the editor
+		// stays responsive while a big map hits the disk
+		OutputBlob blob(m_allocator);
+		save(blob);
+
 		auto& fs = m_engine->getFileSystem();
 		StaticString<MAX_PATH_LENGTH> path("universes/", basename, ".unv");
-		FS::IFile* file = fs.open(fs.getDefaultDevice(), Path(path), FS::Mode::CREATE_AND_WRITE);
-		save(*file);
-		fs.close(*file);
+		FS::ReadCallback cb;
+		cb.bind<WorldEditorImpl, &WorldEditorImpl::onUniverseSaved>(this);
+		fs.writeAsync(fs.getDefaultDevice(), Path(path), blob.getData(), blob.getPos(), cb);
 
+		saveResourceManifest(basename);
 		serialize(basename);
 		m_is_universe_changed = false;
 
@@ -1684,6 +1719,39 @@ public:
 	}
 
 
+	void onUniverseSaved(FS::IFile& file, bool success)
+	{
+		if (success)
+		{
+			g_log_info.log("editor") << "Universe saved";
+		}
+		else
+		{
+			g_log_error.log("Editor") << "Failed to save universe";
+		}
+	}
+
+
+	// the manifest lists every resource the universe needs, so the runtime can
+	// batch the file requests instead of discovering them load by load
+	void saveResourceManifest(const char* basename)
+	{
+		OutputBlob manifest(m_allocator);
+		m_engine->serializeResourceManifest(manifest);
+
+		auto& fs = m_engine->getFileSystem();
+		StaticString<MAX_PATH_LENGTH> path("universes/", basename, ".res");
+		FS::IFile* file = fs.open(fs.getDefaultDevice(), Path(path), FS::Mode::CREATE_AND_WRITE);
+		if (!file)
+		{
+			g_log_error.log("Editor") << "Could not save resource manifest " << path;
+			return;
+		}
+		file->write(manifest.getData(), manifest.getPos());
+		fs.close(*file);
+	}
+
+
 	struct EntityGUIDMap : public IEntityGUIDMap
 	{
 		EntityGUIDMap(IAllocator& allocator)
@@ -1963,13 +2031,12 @@ public:
 	}
 
 
-	void save(FS::IFile& file)
+	void save(OutputBlob& blob)
 	{
 		while (m_engine->getFileSystem().hasWork()) m_engine->getFileSystem().updateAsyncTransactions();
 
 		ASSERT(m_universe);
 
-		OutputBlob blob(m_allocator);
 		blob.reserve(64 * 1024);
 
 		Header header = {0xffffFFFF, (int)SerializedVersion::LATEST, 0, 0};
@@ -1981,9 +2048,6 @@ public:
 		m_prefab_system->serialize(blob);
 		header.hash = crc32((const u8*)blob.getData() + hashed_offset, blob.getPos() - hashed_offset);
 		*(Header*)blob.getData() = header;
-
-		g_log_info.log("editor") << "Universe saved";
-		file.write(blob.getData(), blob.getPos());
 	}
 
 
@@ -2343,9 +2407,10 @@ public:
 		else
 		{
 			m_selected_entity_on_game_mode = m_selected_entities.empty() ? INVALID_ENTITY : m_selected_entities[0];
-			auto& fs = m_engine->getFileSystem();
-			m_game_mode_file = fs.open(fs.getMemoryDevice(), Path(""), FS::Mode::WRITE);
-			save(*m_game_mode_file);
+			// the blob keeps its capacity across game mode sessions, so after the
+			// first toggle the snapshot is a straight memcpy into warm memory
+			m_game_mode_blob.clear();
+			save(m_game_mode_blob);
 			m_is_game_mode = true;
 			m_engine->startGame(*m_universe);
 		}
@@ -2364,7 +2429,6 @@ public:
 		if (reload)
 		{
 			m_universe_destroyed.invoke();
-			m_game_mode_file->seek(FS::SeekMode::BEGIN, 0);
 			m_entity_groups.setUniverse(nullptr);
 			StaticString<64> name(m_universe->getName());
 			m_engine->destroyUniverse(*m_universe);
@@ -2376,10 +2440,9 @@ public:
 			m_selected_entities.clear();
 			m_entity_groups.setUniverse(m_universe);
 			m_camera = INVALID_ENTITY;
-			load(*m_game_mode_file);
+			InputBlob blob(m_game_mode_blob);
+			load(blob);
 		}
-		m_engine->getFileSystem().close(*m_game_mode_file);
-		m_game_mode_file = nullptr;
 		if(isValid(m_selected_entity_on_game_mode)) selectEntities(&m_selected_entity_on_game_mode, 1);
 		m_engine->getResourceManager().enableUnload(true);
 	}
@@ -2588,10 +2651,17 @@ public:
 
 	void load(FS::IFile& file)
 	{
-		m_is_loading = true;
 		ASSERT(file.getBuffer());
+		InputBlob blob(file.getBuffer(), (int)file.size());
+		load(blob);
+	}
+
+
+	void load(InputBlob& blob)
+	{
+		m_is_loading = true;
 		Header header;
-		if (file.size() < sizeof(header))
+		if (blob.getSize() < (int)sizeof(header))
 		{
 			g_log_error.log("Editor") << "Corrupted file.";
 			newUniverse();
@@ -2601,7 +2671,6 @@ public:
 
 		Timer* timer = Timer::create(m_allocator);
 		g_log_info.log("Editor") << "Parsing universe...";
-		InputBlob blob(file.getBuffer(), (int)file.size());
 		u32 hash = 0;
 		blob.read(hash);
 		header.version = -1;
@@ -2692,6 +2761,7 @@ public:
 		, m_selected_entity_on_game_mode(INVALID_ENTITY)
 		, m_mouse_handling_plugin(nullptr)
 		, m_is_game_mode(false)
+		, m_game_mode_blob(m_allocator)
 		, m_is_snap_mode(false)
 		, m_undo_index(-1)
 		, m_engine(&engine)
@@ -2702,6 +2772,8 @@ public:
 		for (auto& i : m_is_mouse_click) i = false;
 		m_go_to_parameters.m_is_active = false;
 		
+		m_undo_blob_store = LUMIX_NEW(m_allocator, UndoBlobStore)(engine, m_allocator);
+
 		m_measure_tool = LUMIX_NEW(m_allocator, MeasureTool)();
 		addPlugin(*m_measure_tool);
 
@@ -2719,6 +2791,7 @@ public:
 				g_log_info.log("Editor") << plugin_name << " plugin has not been loaded";
 			}
 		}
+		plugin_manager.initPlugins();
 
 		m_prefab_system = PrefabSystem::create(*this);
 
@@ -3393,7 +3466,7 @@ private:
 	bool m_is_orbit;
 	bool m_is_additive_selection;
 	bool m_is_snap_mode;
-	FS::IFile* m_game_mode_file;
+	OutputBlob m_game_mode_blob;
 	Engine* m_engine;
 	Entity m_camera;
 	Entity m_selected_entity_on_game_mode;
@@ -3408,6 +3481,7 @@ private:
 	Plugin* m_mouse_handling_plugin;
 	PrefabSystem* m_prefab_system;
 	Array<IEditorCommand*> m_undo_stack;
+	UndoBlobStore* m_undo_blob_store;
 	AssociativeArray<u32, EditorCommandCreator> m_editor_command_creators;
 	int m_undo_index;
 	OutputBlob m_copy_buffer;
@@ -24,6 +24,7 @@ class Pipeline;
 class RenderInterface;
 struct Quat;
 struct RayCastModelHit;
+class UndoBlobStore;
 class Universe;
 
 struct MouseButton
@@ -80,6 +81,9 @@ public:
 	virtual void endCommandGroup() = 0;
 	virtual IEditorCommand* executeCommand(IEditorCommand* command) = 0;
 	virtual IEditorCommand* createEditorCommand(u32 command_type) = 0;
+	// deduplicated storage for command snapshots; commands keep handles
+	// instead of owned blobs so a deep undo stack stays cheap
+	virtual UndoBlobStore& getUndoBlobStore() = 0;
 	virtual Engine& getEngine() = 0;
 	virtual Universe* getUniverse() = 0;
 	virtual IAllocator& getAllocator() = 0;
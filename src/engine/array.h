@@ -209,6 +209,18 @@ public:
 	}
 
 
+	void insert(int index, T&& value)
+	{
+		if (m_size == m_capacity)
+		{
+			grow();
+		}
+		moveMemory(m_data + index + 1, m_data + index, sizeof(T) * (m_size - index));
+		new (NewPlaceholder(), &m_data[index]) T(static_cast<T&&>(value));
+		++m_size;
+	}
+
+
 	void erase(int index)
 	{
 		if (index >= 0 && index < m_size)
@@ -235,6 +247,19 @@ public:
 	}
 
 
+	void push(T&& value)
+	{
+		int size = m_size;
+		if (size == m_capacity)
+		{
+			grow();
+		}
+		new (NewPlaceholder(), (char*)(m_data + size)) T(static_cast<T&&>(value));
+		++size;
+		m_size = size;
+	}
+
+
 	template <class _Ty> struct remove_reference
 	{ // remove rvalue reference
 		typedef _Ty type;
@@ -371,4 +396,171 @@ private:
 };
 
 
+template <typename T, int N> class InlineArray
+{
+public:
+	explicit InlineArray(IAllocator& allocator)
+		: m_allocator(allocator)
+	{
+		m_data = (T*)m_inline_mem;
+		m_capacity = N;
+		m_size = 0;
+	}
+
+	~InlineArray()
+	{
+		callDestructors(m_data, m_data + m_size);
+		if (!isInline()) m_allocator.deallocate_aligned(m_data);
+	}
+
+	T* begin() const { return m_data; }
+	T* end() const { return m_data + m_size; }
+
+	bool empty() const { return m_size == 0; }
+	int size() const { return m_size; }
+	int capacity() const { return m_capacity; }
+
+	const T& operator[](int index) const
+	{
+		ASSERT(index >= 0 && index < m_size);
+		return m_data[index];
+	}
+
+	T& operator[](int index)
+	{
+		ASSERT(index >= 0 && index < m_size);
+		return m_data[index];
+	}
+
+	const T& back() const { return m_data[m_size - 1]; }
+	T& back() { return m_data[m_size - 1]; }
+
+	int indexOf(const T& item) const
+	{
+		for (int i = 0; i < m_size; ++i)
+		{
+			if (m_data[i] == item)
+			{
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	void push(const T& value)
+	{
+		if (m_size == m_capacity)
+		{
+			grow();
+		}
+		new (NewPlaceholder(), (char*)(m_data + m_size)) T(value);
+		++m_size;
+	}
+
+	template <typename... Params> T& emplace(Params&&... params)
+	{
+		if (m_size == m_capacity)
+		{
+			grow();
+		}
+		new (NewPlaceholder(), (char*)(m_data + m_size)) T(static_cast<Params&&>(params)...);
+		++m_size;
+		return m_data[m_size - 1];
+	}
+
+	void pop()
+	{
+		if (m_size > 0)
+		{
+			m_data[m_size - 1].~T();
+			--m_size;
+		}
+	}
+
+	void eraseFast(int index)
+	{
+		if (index >= 0 && index < m_size)
+		{
+			m_data[index].~T();
+			if (index != m_size - 1)
+			{
+				moveMemory(m_data + index, m_data + m_size - 1, sizeof(T));
+			}
+			--m_size;
+		}
+	}
+
+	void erase(int index)
+	{
+		if (index >= 0 && index < m_size)
+		{
+			m_data[index].~T();
+			if (index < m_size - 1)
+			{
+				moveMemory(m_data + index, m_data + index + 1, sizeof(T) * (m_size - index - 1));
+			}
+			--m_size;
+		}
+	}
+
+	void clear()
+	{
+		callDestructors(m_data, m_data + m_size);
+		m_size = 0;
+	}
+
+	void resize(int size)
+	{
+		if (size > m_capacity)
+		{
+			reserve(size);
+		}
+		for (int i = m_size; i < size; ++i)
+		{
+			new (NewPlaceholder(), (char*)(m_data + i)) T();
+		}
+		callDestructors(m_data + size, m_data + m_size);
+		m_size = size;
+	}
+
+	void reserve(int capacity)
+	{
+		if (capacity > m_capacity)
+		{
+			T* new_data = (T*)m_allocator.allocate_aligned(capacity * sizeof(T), ALIGN_OF(T));
+			copyMemory(new_data, m_data, sizeof(T) * m_size);
+			if (!isInline()) m_allocator.deallocate_aligned(m_data);
+			m_data = new_data;
+			m_capacity = capacity;
+		}
+	}
+
+private:
+	InlineArray(const InlineArray& rhs);
+	void operator=(const InlineArray& rhs);
+
+	bool isInline() const { return m_data == (const T*)m_inline_mem; }
+
+	void grow()
+	{
+		reserve(m_capacity * 2);
+	}
+
+	void callDestructors(T* begin, T* end)
+	{
+		for (; begin < end; ++begin)
+		{
+			begin->~T();
+		}
+	}
+
+private:
+	IAllocator& m_allocator;
+	int m_capacity;
+	int m_size;
+	T* m_data;
+	alignas(T) u8 m_inline_mem[N * sizeof(T)];
+};
+
+
 } // ~namespace Lumix
@@ -20,6 +20,14 @@ namespace Lumix
 		void injectMouseYMove(float value) override {}
 		float getMouseXMove() const override { return 0; }
 		float getMouseYMove() const override { return 0; }
+		int getEventCount() const override { return 0; }
+		const Event& getEvent(int index) const override
+		{
+			ASSERT(false);
+			static Event event;
+			return event;
+		}
+		Vec2 getMousePosAt(float t) const override { return Vec2(0, 0); }
 		void addAction(u32 action, InputType type, int key, int controller_id) override {}
 
 		IAllocator& m_allocator;
@@ -3,6 +3,7 @@
 
 #include "engine/iallocator.h"
 #include "engine/mt/atomic.h"
+#include "engine/profiler.h"
 
 
 namespace Lumix
@@ -12,68 +13,152 @@ namespace Lumix
 class BaseProxyAllocator : public IAllocator
 {
 public:
-	BaseProxyAllocator(IAllocator& source)
+	explicit BaseProxyAllocator(IAllocator& source)
 		: m_source(source)
+		, m_tag(-1)
 	{
 		m_allocation_count = 0;
 	}
 
+	// a named proxy prefixes every allocation with its size and books the
+	// bytes under the tag, so shipped builds can see per-subsystem totals
+	BaseProxyAllocator(const char* name, IAllocator& source)
+		: m_source(source)
+	{
+		m_allocation_count = 0;
+		m_tag = Profiler::registerMemoryTag(name);
+	}
+
 	virtual ~BaseProxyAllocator() { ASSERT(m_allocation_count == 0); }
 
 
 	void* allocate_aligned(size_t size, size_t align) override
 	{
 		MT::atomicIncrement(&m_allocation_count);
-		return m_source.allocate_aligned(size, align);
+		if (m_tag < 0) return m_source.allocate_aligned(size, align);
+
+		size_t padding = getAlignedPadding(align);
+		u8* mem = (u8*)m_source.allocate_aligned(size + padding, align);
+		if (!mem) return nullptr;
+		*(size_t*)(mem + padding - sizeof(size_t)) = size;
+		*(size_t*)(mem + padding - 2 * sizeof(size_t)) = padding;
+		Profiler::trackAlloc(m_tag, size);
+		return mem + padding;
 	}
 
 
 	void deallocate_aligned(void* ptr) override
 	{
-		if(ptr)
+		if (!ptr) return;
+
+		MT::atomicDecrement(&m_allocation_count);
+		if (m_tag < 0)
 		{
-			MT::atomicDecrement(&m_allocation_count);
 			m_source.deallocate_aligned(ptr);
+			return;
 		}
+
+		Profiler::trackFree(m_tag, *((size_t*)ptr - 1));
+		m_source.deallocate_aligned((u8*)ptr - *((size_t*)ptr - 2));
 	}
 
 
 	void* reallocate_aligned(void* ptr, size_t size, size_t align) override
 	{
-		if (!ptr) MT::atomicIncrement(&m_allocation_count);
-		if (size == 0) MT::atomicDecrement(&m_allocation_count);
-		return m_source.reallocate_aligned(ptr, size, align);
+		if (m_tag < 0)
+		{
+			if (!ptr) MT::atomicIncrement(&m_allocation_count);
+			if (size == 0) MT::atomicDecrement(&m_allocation_count);
+			return m_source.reallocate_aligned(ptr, size, align);
+		}
+
+		if (!ptr) return allocate_aligned(size, align);
+		if (size == 0)
+		{
+			deallocate_aligned(ptr);
+			return nullptr;
+		}
+
+		size_t padding = getAlignedPadding(align);
+		size_t old_size = *((size_t*)ptr - 1);
+		u8* mem = (u8*)m_source.reallocate_aligned((u8*)ptr - padding, size + padding, align);
+		if (!mem) return nullptr;
+		*(size_t*)(mem + padding - sizeof(size_t)) = size;
+		*(size_t*)(mem + padding - 2 * sizeof(size_t)) = padding;
+		Profiler::trackFree(m_tag, old_size);
+		Profiler::trackAlloc(m_tag, size);
+		return mem + padding;
 	}
 
 
 	void* allocate(size_t size) override
 	{
 		MT::atomicIncrement(&m_allocation_count);
-		return m_source.allocate(size);
+		if (m_tag < 0) return m_source.allocate(size);
+
+		u8* mem = (u8*)m_source.allocate(size + sizeof(size_t));
+		if (!mem) return nullptr;
+		*(size_t*)mem = size;
+		Profiler::trackAlloc(m_tag, size);
+		return mem + sizeof(size_t);
 	}
 
 	void deallocate(void* ptr) override
 	{
-		if (ptr)
+		if (!ptr) return;
+
+		MT::atomicDecrement(&m_allocation_count);
+		if (m_tag < 0)
 		{
-			MT::atomicDecrement(&m_allocation_count);
 			m_source.deallocate(ptr);
+			return;
 		}
+
+		Profiler::trackFree(m_tag, *((size_t*)ptr - 1));
+		m_source.deallocate((size_t*)ptr - 1);
 	}
 
 	void* reallocate(void* ptr, size_t size) override
 	{
-		if (!ptr) MT::atomicIncrement(&m_allocation_count);
-		if (size == 0) MT::atomicDecrement(&m_allocation_count);
-		return m_source.reallocate(ptr, size);
+		if (m_tag < 0)
+		{
+			if (!ptr) MT::atomicIncrement(&m_allocation_count);
+			if (size == 0) MT::atomicDecrement(&m_allocation_count);
+			return m_source.reallocate(ptr, size);
+		}
+
+		if (!ptr) return allocate(size);
+		if (size == 0)
+		{
+			deallocate(ptr);
+			return nullptr;
+		}
+
+		size_t old_size = *((size_t*)ptr - 1);
+		u8* mem = (u8*)m_source.reallocate((size_t*)ptr - 1, size + sizeof(size_t));
+		if (!mem) return nullptr;
+		*(size_t*)mem = size;
+		Profiler::trackFree(m_tag, old_size);
+		Profiler::trackAlloc(m_tag, size);
+		return mem + sizeof(size_t);
 	}
 
 
 	IAllocator& getSourceAllocator() { return m_source; }
 
+private:
+	// padding is a multiple of align big enough for the size and the offset
+	// back to the system pointer, stored right before the user pointer
+	static size_t getAlignedPadding(size_t align)
+	{
+		size_t padding = 2 * sizeof(size_t);
+		return align > padding ? align : padding;
+	}
+
 private:
 	IAllocator& m_source;
 	volatile i32 m_allocation_count;
+	int m_tag;
 };
 
 
@@ -160,6 +160,68 @@ void BinaryArray::resize(int size)
 }
 
 
+void BinaryArray::fill(bool value)
+{
+	if (m_size == 0) return;
+	setMemory(m_data, value ? 0xff : 0, ((m_size + BITMASK_7BIT) >> 5) * ITEM_SIZE);
+}
+
+
+int BinaryArray::countSet() const
+{
+	if (m_size == 0) return 0;
+	int count = 0;
+	const int last_major = (m_size - 1) >> 5;
+	for (int i = 0; i <= last_major; ++i)
+	{
+		StoreType v = m_data[i];
+		// stale bits can live past the end after pop, mask them off
+		if (i == last_major && (m_size & BITMASK_7BIT) != 0)
+		{
+			v &= BINARY_MASK[(m_size & BITMASK_7BIT) - 1];
+		}
+		v = v - ((v >> 1) & 0x55555555);
+		v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+		count += int((((v + (v >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24);
+	}
+	return count;
+}
+
+
+// bits are stored most significant first, so the lowest array index in a
+// word is its highest set bit
+static int highestBitIndex(BinaryArray::StoreType v)
+{
+	int index = 0;
+	if (v & 0xffff0000) { index += 16; v >>= 16; }
+	if (v & 0xff00) { index += 8; v >>= 8; }
+	if (v & 0xf0) { index += 4; v >>= 4; }
+	if (v & 0xc) { index += 2; v >>= 2; }
+	if (v & 0x2) { index += 1; }
+	return index;
+}
+
+
+int BinaryArray::nextSet(int from) const
+{
+	if (from < 0) from = 0;
+	while (from < m_size)
+	{
+		const int major = from >> 5;
+		const int minor = from & BITMASK_7BIT;
+		StoreType word = m_data[major];
+		if (minor > 0) word &= ~BINARY_MASK[minor - 1];
+		if (word)
+		{
+			int index = (major << 5) + (BITMASK_7BIT - highestBitIndex(word));
+			return index < m_size ? index : -1;
+		}
+		from = (major + 1) << 5;
+	}
+	return -1;
+}
+
+
 BinaryArray::StoreType* BinaryArray::getRaw()
 {
 	return m_data;
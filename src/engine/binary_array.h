@@ -71,6 +71,12 @@ namespace Lumix
 			int size() const;
 			int getRawSize() const;
 			StoreType* getRaw();
+			// word-at-a-time helpers; hot loops use these to skip 32 clear
+			// bits per test instead of touching one flag per element
+			void fill(bool value);
+			int countSet() const;
+			// index of the first set bit at or after from, -1 when none
+			int nextSet(int from) const;
 
 		private:
 			void grow(int capacity);
@@ -0,0 +1,144 @@
+#pragma once
+
+
+#include "engine/array.h"
+
+
+namespace Lumix
+{
+
+
+// Allocator-aware binary min-heap keyed separately from the stored value.
+// decreaseKey finds the value and sifts it up, so schedulers can bump the
+// priority of an already queued item (smaller key == served earlier).
+template <typename Key, typename Value> class BinaryHeap
+{
+public:
+	explicit BinaryHeap(IAllocator& allocator)
+		: m_entries(allocator)
+	{
+	}
+
+
+	bool empty() const { return m_entries.empty(); }
+	int size() const { return m_entries.size(); }
+	void clear() { m_entries.clear(); }
+	void reserve(int capacity) { m_entries.reserve(capacity); }
+
+
+	const Key& topKey() const { return m_entries[0].key; }
+	const Value& top() const { return m_entries[0].value; }
+
+
+	void insert(const Key& key, const Value& value)
+	{
+		Entry& entry = m_entries.emplace();
+		entry.key = key;
+		entry.value = value;
+		siftUp(m_entries.size() - 1);
+	}
+
+
+	void pop()
+	{
+		ASSERT(!m_entries.empty());
+		m_entries[0] = m_entries.back();
+		m_entries.pop();
+		if (!m_entries.empty()) siftDown(0);
+	}
+
+
+	bool decreaseKey(const Value& value, const Key& new_key)
+	{
+		for (int i = 0; i < m_entries.size(); ++i)
+		{
+			if (m_entries[i].value == value)
+			{
+				if (new_key < m_entries[i].key)
+				{
+					m_entries[i].key = new_key;
+					siftUp(i);
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+
+	bool remove(const Value& value)
+	{
+		for (int i = 0; i < m_entries.size(); ++i)
+		{
+			if (m_entries[i].value == value)
+			{
+				m_entries[i] = m_entries.back();
+				m_entries.pop();
+				if (i < m_entries.size())
+				{
+					siftDown(i);
+					siftUp(i);
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+
+	bool contains(const Value& value) const
+	{
+		for (int i = 0; i < m_entries.size(); ++i)
+		{
+			if (m_entries[i].value == value) return true;
+		}
+		return false;
+	}
+
+
+private:
+	struct Entry
+	{
+		Key key;
+		Value value;
+	};
+
+
+	void siftUp(int index)
+	{
+		while (index > 0)
+		{
+			int parent = (index - 1) >> 1;
+			if (!(m_entries[index].key < m_entries[parent].key)) break;
+			Entry tmp = m_entries[index];
+			m_entries[index] = m_entries[parent];
+			m_entries[parent] = tmp;
+			index = parent;
+		}
+	}
+
+
+	void siftDown(int index)
+	{
+		for (;;)
+		{
+			int smallest = index;
+			int left = index * 2 + 1;
+			int right = index * 2 + 2;
+			if (left < m_entries.size() && m_entries[left].key < m_entries[smallest].key) smallest = left;
+			if (right < m_entries.size() && m_entries[right].key < m_entries[smallest].key) smallest = right;
+			if (smallest == index) break;
+			Entry tmp = m_entries[index];
+			m_entries[index] = m_entries[smallest];
+			m_entries[smallest] = tmp;
+			index = smallest;
+		}
+	}
+
+
+private:
+	Array<Entry> m_entries;
+};
+
+
+} // namespace Lumix
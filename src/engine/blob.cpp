@@ -189,6 +189,139 @@ namespace Lumix
 	}
 
 
+	static const int FIRST_CHUNK_SIZE = 32 * 1024;
+
+
+	ChunkedOutputBlob::ChunkedOutputBlob(IAllocator& allocator)
+		: m_allocator(allocator)
+		, m_first(nullptr)
+		, m_current(nullptr)
+		, m_pos(0)
+	{
+	}
+
+
+	ChunkedOutputBlob::~ChunkedOutputBlob()
+	{
+		Chunk* chunk = m_first;
+		while (chunk)
+		{
+			Chunk* next = chunk->next;
+			m_allocator.deallocate(chunk);
+			chunk = next;
+		}
+	}
+
+
+	ChunkedOutputBlob::Chunk* ChunkedOutputBlob::allocateChunk(int size)
+	{
+		Chunk* chunk = (Chunk*)m_allocator.allocate(sizeof(Chunk) + size);
+		chunk->next = nullptr;
+		chunk->size = size;
+		chunk->used = 0;
+		if (m_current)
+		{
+			m_current->next = chunk;
+		}
+		else
+		{
+			m_first = chunk;
+		}
+		m_current = chunk;
+		return chunk;
+	}
+
+
+	void ChunkedOutputBlob::write(const void* data, int size)
+	{
+		if (!size) return;
+
+		const u8* src = (const u8*)data;
+		while (size > 0)
+		{
+			if (!m_current || m_current->used == m_current->size)
+			{
+				if (m_current && m_current->next)
+				{
+					// reuse chunks kept alive across clear()
+					m_current = m_current->next;
+				}
+				else
+				{
+					int chunk_size = m_current ? m_current->size * 2 : FIRST_CHUNK_SIZE;
+					if (chunk_size < size) chunk_size = size;
+					allocateChunk(chunk_size);
+				}
+			}
+			int to_copy = m_current->size - m_current->used;
+			if (to_copy > size) to_copy = size;
+			copyMemory((u8*)(m_current + 1) + m_current->used, src, to_copy);
+			m_current->used += to_copy;
+			m_pos += to_copy;
+			src += to_copy;
+			size -= to_copy;
+		}
+	}
+
+
+	void ChunkedOutputBlob::writeString(const char* string)
+	{
+		if (string)
+		{
+			i32 size = stringLength(string) + 1;
+			write(size);
+			write(string, size);
+		}
+		else
+		{
+			write((i32)0);
+		}
+	}
+
+
+	void ChunkedOutputBlob::reserve(int size)
+	{
+		int available = 0;
+		for (Chunk* chunk = m_first; chunk; chunk = chunk->next)
+		{
+			available += chunk->size;
+		}
+		if (size > available) allocateChunk(size - available);
+	}
+
+
+	void ChunkedOutputBlob::clear()
+	{
+		for (Chunk* chunk = m_first; chunk; chunk = chunk->next)
+		{
+			chunk->used = 0;
+		}
+		m_current = m_first;
+		m_pos = 0;
+	}
+
+
+	void ChunkedOutputBlob::copyTo(void* dest) const
+	{
+		u8* out = (u8*)dest;
+		for (Chunk* chunk = m_first; chunk; chunk = chunk->next)
+		{
+			copyMemory(out, chunk + 1, chunk->used);
+			out += chunk->used;
+		}
+	}
+
+
+	void ChunkedOutputBlob::copyTo(OutputBlob& dest) const
+	{
+		dest.reserve(dest.getPos() + m_pos);
+		for (Chunk* chunk = m_first; chunk; chunk = chunk->next)
+		{
+			dest.write(chunk + 1, chunk->used);
+		}
+	}
+
+
 	void OutputBlob::reserve(int size)
 	{
 		if (size <= m_size) return;
@@ -270,4 +403,16 @@ namespace Lumix
 	}
 
 
+	const char* InputBlob::readStringView()
+	{
+		i32 size;
+		read(size);
+		if (size <= 0) return "";
+		const char* value = (const char*)m_data + m_pos;
+		m_pos += size;
+		ASSERT(m_pos <= m_size && value[size - 1] == '\0');
+		return value;
+	}
+
+
 } // !namespace Lumix
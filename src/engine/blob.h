@@ -57,6 +57,51 @@ namespace Lumix
 		write(&v, sizeof(v));
 	}
 
+	// Rope-style output blob; grows by appending chunks instead of
+	// reallocating one contiguous buffer, so big serializations (universe
+	// saves, undo stack) never memcpy already written data. Use copyTo() or
+	// an InputBlob-free consumer to read it back out.
+	class LUMIX_ENGINE_API ChunkedOutputBlob
+	{
+		public:
+			explicit ChunkedOutputBlob(IAllocator& allocator);
+			~ChunkedOutputBlob();
+
+			void write(const void* data, int size);
+			void writeString(const char* string);
+			template <class T> void write(const T& value) { write(&value, sizeof(T)); }
+			int getPos() const { return m_pos; }
+			void reserve(int size);
+			void clear();
+			void copyTo(void* dest) const;
+			void copyTo(OutputBlob& dest) const;
+
+		private:
+			struct Chunk
+			{
+				Chunk* next;
+				int size;
+				int used;
+			};
+
+			Chunk* allocateChunk(int size);
+
+			ChunkedOutputBlob(const ChunkedOutputBlob&);
+			void operator =(const ChunkedOutputBlob&);
+
+		private:
+			IAllocator& m_allocator;
+			Chunk* m_first;
+			Chunk* m_current;
+			int m_pos;
+	};
+
+	template <> inline void ChunkedOutputBlob::write<bool>(const bool& value)
+	{
+		u8 v = value;
+		write(&v, sizeof(v));
+	}
+
 	class LUMIX_ENGINE_API InputBlob
 	{
 		public:
@@ -65,6 +110,10 @@ namespace Lumix
 
 			bool read(void* data, int size);
 			bool readString(char* data, int max_size);
+			// zero-copy variant; the returned pointer aliases the blob's memory
+			// and is valid for the blob's lifetime. Only for strings written
+			// with writeString, which stores the terminator
+			const char* readStringView();
 			template <class T> void read(T& value) { read(&value, sizeof(T)); }
 			template <class T> inline T read();
 			const void* skip(int size);
@@ -0,0 +1,179 @@
+#pragma once
+
+
+#include "engine/array.h"
+#include "engine/iallocator.h"
+#include "engine/lumix.h"
+
+
+namespace Lumix
+{
+	// contiguous storage for per-entity component data; values live in
+	// fixed-size chunks, so iteration is cache-linear, growth never moves
+	// existing values and lookup is O(1) through a per-entity dense index.
+	// removal swaps the last value into the hole, so iteration order is not
+	// stable across erase
+	template <typename T>
+	class ChunkedStorage
+	{
+		public:
+			enum
+			{
+				CHUNK_BYTES = 16384,
+				CHUNK_SIZE = CHUNK_BYTES / sizeof(T) > 0 ? CHUNK_BYTES / sizeof(T) : 1
+			};
+
+		public:
+			explicit ChunkedStorage(IAllocator& allocator)
+				: m_allocator(allocator)
+				, m_chunks(allocator)
+				, m_entities(allocator)
+				, m_map(allocator)
+				, m_size(0)
+			{}
+
+
+			~ChunkedStorage()
+			{
+				for (int i = 0; i < m_size; ++i) at(i).~T();
+				for (T* chunk : m_chunks) m_allocator.deallocate(chunk);
+			}
+
+
+			T& insert(Entity entity)
+			{
+				T& value = pushValue(entity);
+				new (NewPlaceholder(), &value) T();
+				return value;
+			}
+
+
+			T& insert(Entity entity, const T& rhs)
+			{
+				T& value = pushValue(entity);
+				new (NewPlaceholder(), &value) T(rhs);
+				return value;
+			}
+
+
+			int find(Entity entity) const
+			{
+				if (entity.index < 0 || entity.index >= m_map.size()) return -1;
+				return m_map[entity.index];
+			}
+
+
+			T& get(Entity entity)
+			{
+				int index = find(entity);
+				ASSERT(index >= 0);
+				return at(index);
+			}
+
+
+			T& operator[](Entity entity) { return get(entity); }
+
+
+			const T& operator[](Entity entity) const
+			{
+				int index = find(entity);
+				ASSERT(index >= 0);
+				return at(index);
+			}
+
+
+			void erase(Entity entity)
+			{
+				int index = find(entity);
+				if (index < 0) return;
+
+				T& value = at(index);
+				int last = m_size - 1;
+				if (index != last)
+				{
+					value = static_cast<T&&>(at(last));
+					m_entities[index] = m_entities[last];
+					m_map[m_entities[index].index] = index;
+				}
+				at(last).~T();
+				m_entities.pop();
+				m_map[entity.index] = -1;
+				--m_size;
+			}
+
+
+			T& at(int index) { return m_chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+			const T& at(int index) const { return m_chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+			Entity getEntity(int index) const { return m_entities[index]; }
+			int size() const { return m_size; }
+
+
+			void clear()
+			{
+				for (int i = 0; i < m_size; ++i) at(i).~T();
+				for (Entity entity : m_entities) m_map[entity.index] = -1;
+				m_entities.clear();
+				m_size = 0;
+			}
+
+
+			void reserve(int capacity)
+			{
+				m_entities.reserve(capacity);
+				while (m_chunks.size() * CHUNK_SIZE < capacity) pushChunk();
+			}
+
+
+			struct iterator
+			{
+				ChunkedStorage* storage;
+				int index;
+
+				T& operator*() const { return storage->at(index); }
+				bool operator!=(const iterator& rhs) const { return index != rhs.index; }
+				void operator++() { ++index; }
+			};
+
+			struct const_iterator
+			{
+				const ChunkedStorage* storage;
+				int index;
+
+				const T& operator*() const { return storage->at(index); }
+				bool operator!=(const const_iterator& rhs) const { return index != rhs.index; }
+				void operator++() { ++index; }
+			};
+
+			iterator begin() { return {this, 0}; }
+			iterator end() { return {this, m_size}; }
+			const_iterator begin() const { return {this, 0}; }
+			const_iterator end() const { return {this, m_size}; }
+
+		private:
+			void pushChunk()
+			{
+				m_chunks.push((T*)m_allocator.allocate(CHUNK_SIZE * sizeof(T)));
+			}
+
+
+			T& pushValue(Entity entity)
+			{
+				ASSERT(find(entity) < 0);
+				if (m_size == m_chunks.size() * CHUNK_SIZE) pushChunk();
+				while (m_map.size() <= entity.index) m_map.push(-1);
+				m_map[entity.index] = m_size;
+				m_entities.push(entity);
+				++m_size;
+				return at(m_size - 1);
+			}
+
+		private:
+			IAllocator& m_allocator;
+			Array<T*> m_chunks;
+			Array<Entity> m_entities;
+			Array<int> m_map;
+			int m_size;
+	};
+
+
+} // namespace Lumix
@@ -0,0 +1,173 @@
+#include "engine/compression.h"
+#include "engine/string.h"
+
+
+namespace Lumix
+{
+
+
+namespace Compression
+{
+
+
+static const i32 MIN_MATCH = 4;
+// matches may not start in the last bytes of the input, the tail is always
+// emitted as literals; this keeps the hot copy loops free of end checks
+static const i32 TAIL_LITERALS = 12;
+static const i32 MAX_OFFSET = 0xffff;
+static const i32 HASH_BITS = 13;
+
+
+i32 maxCompressedSize(i32 size)
+{
+	return size + size / 255 + 16;
+}
+
+
+static LUMIX_FORCE_INLINE u32 hash(const u8* p)
+{
+	u32 sequence;
+	copyMemory(&sequence, p, sizeof(sequence));
+	return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+
+static LUMIX_FORCE_INLINE u8* writeLength(u8* dst, i32 length)
+{
+	while (length >= 255)
+	{
+		*dst++ = 255;
+		length -= 255;
+	}
+	*dst++ = (u8)length;
+	return dst;
+}
+
+
+i32 compress(const void* src_mem, i32 src_size, void* dst_mem, i32 dst_capacity)
+{
+	const u8* src = (const u8*)src_mem;
+	u8* dst = (u8*)dst_mem;
+	u8* dst_end = dst + dst_capacity;
+
+	i32 table[1 << HASH_BITS];
+	for (i32& entry : table) entry = -1;
+
+	const u8* ip = src;
+	const u8* anchor = src;
+	const u8* match_limit = src + src_size - TAIL_LITERALS;
+	u8* op = dst;
+
+	if (src_size > TAIL_LITERALS)
+	{
+		while (ip < match_limit)
+		{
+			i32 match_pos = table[hash(ip)];
+			table[hash(ip)] = i32(ip - src);
+
+			bool found = match_pos >= 0 && ip - src - match_pos <= MAX_OFFSET &&
+						 compareMemory(src + match_pos, ip, MIN_MATCH) == 0;
+			if (!found)
+			{
+				++ip;
+				continue;
+			}
+
+			const u8* match = src + match_pos;
+			i32 match_len = MIN_MATCH;
+			while (ip + match_len < match_limit && ip[match_len] == match[match_len]) ++match_len;
+
+			i32 literal_len = i32(ip - anchor);
+			// token + extended lengths + literals + offset, conservatively
+			if (op + literal_len + (literal_len + 255) / 255 + (match_len + 255) / 255 + 4 > dst_end) return 0;
+
+			u8* token = op++;
+			*token = (u8)(literal_len < 15 ? literal_len << 4 : 15 << 4);
+			if (literal_len >= 15) op = writeLength(op, literal_len - 15);
+			copyMemory(op, anchor, literal_len);
+			op += literal_len;
+
+			u16 offset = (u16)(ip - match);
+			copyMemory(op, &offset, sizeof(offset));
+			op += sizeof(offset);
+
+			i32 stored_match = match_len - MIN_MATCH;
+			*token |= (u8)(stored_match < 15 ? stored_match : 15);
+			if (stored_match >= 15) op = writeLength(op, stored_match - 15);
+
+			ip += match_len;
+			anchor = ip;
+		}
+	}
+
+	// trailing literals
+	i32 literal_len = i32(src + src_size - anchor);
+	if (op + literal_len + (literal_len + 255) / 255 + 1 > dst_end) return 0;
+	u8* token = op++;
+	*token = (u8)(literal_len < 15 ? literal_len << 4 : 15 << 4);
+	if (literal_len >= 15) op = writeLength(op, literal_len - 15);
+	copyMemory(op, anchor, literal_len);
+	op += literal_len;
+
+	return i32(op - dst);
+}
+
+
+static LUMIX_FORCE_INLINE const u8* readLength(const u8* src, i32& length)
+{
+	u8 byte;
+	do
+	{
+		byte = *src++;
+		length += byte;
+	} while (byte == 255);
+	return src;
+}
+
+
+bool decompress(const void* src_mem, i32 src_size, void* dst_mem, i32 dst_size)
+{
+	const u8* ip = (const u8*)src_mem;
+	const u8* ip_end = ip + src_size;
+	u8* op = (u8*)dst_mem;
+	u8* op_end = op + dst_size;
+
+	while (ip < ip_end)
+	{
+		u8 token = *ip++;
+
+		i32 literal_len = token >> 4;
+		if (literal_len == 15) ip = readLength(ip, literal_len);
+		if (ip + literal_len > ip_end || op + literal_len > op_end) return false;
+		copyMemory(op, ip, literal_len);
+		ip += literal_len;
+		op += literal_len;
+
+		if (ip >= ip_end) break; // the last sequence has no match
+
+		u16 offset;
+		if (ip + sizeof(offset) > ip_end) return false;
+		copyMemory(&offset, ip, sizeof(offset));
+		ip += sizeof(offset);
+
+		i32 match_len = (token & 15) + MIN_MATCH;
+		if ((token & 15) == 15) ip = readLength(ip, match_len);
+
+		const u8* match = op - offset;
+		if (offset == 0 || match < (const u8*)dst_mem || op + match_len > op_end) return false;
+		// byte-by-byte, the match may overlap its own output
+		while (match_len > 0)
+		{
+			*op++ = *match++;
+			--match_len;
+		}
+	}
+
+	return op == op_end;
+}
+
+
+} // namespace Compression
+
+
+} // namespace Lumix
@@ -0,0 +1,28 @@
+#pragma once
+
+
+#include "engine/lumix.h"
+
+
+namespace Lumix
+{
+
+
+// Byte-oriented LZ77 codec in the LZ4 block layout (token with literal and
+// match length nibbles, 64 KB offset window, greedy hash matcher). Built for
+// speed over ratio: repetitive engine data (meshes, uncompressed textures,
+// text) shrinks well, already compressed data passes through with compress()
+// reporting failure so callers can send it raw.
+namespace Compression
+{
+	// worst case output size for an incompressible input
+	LUMIX_ENGINE_API i32 maxCompressedSize(i32 size);
+	// returns the compressed size, or 0 when the result would not fit in
+	// dst_capacity (incompressible input) and dst contents are undefined
+	LUMIX_ENGINE_API i32 compress(const void* src, i32 src_size, void* dst, i32 dst_capacity);
+	// dst_size must be the exact decompressed size the compressor was fed
+	LUMIX_ENGINE_API bool decompress(const void* src, i32 src_size, void* dst, i32 dst_size);
+} // namespace Compression
+
+
+} // namespace Lumix
@@ -51,44 +51,77 @@ static u32 crc32Table[256] = {
 	0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d};
 
 
-u32 crc32(const void* data, int length)
+// slice-by-8 lookup tables derived from crc32Table; built once at startup.
+// Note that the SSE4.2 crc32 instruction computes CRC-32C (a different
+// polynomial), which would change every stored hash, so it is not used here.
+static u32 crc32Tables[8][256];
+
+static struct InitCrc32Tables
+{
+	InitCrc32Tables()
+	{
+		for (int i = 0; i < 256; ++i)
+		{
+			u32 crc = crc32Table[i];
+			crc32Tables[0][i] = crc;
+			for (int t = 1; t < 8; ++t)
+			{
+				crc = (crc >> 8) ^ crc32Table[crc & 0xFF];
+				crc32Tables[t][i] = crc;
+			}
+		}
+	}
+} s_init_crc32_tables;
+
+
+static u32 computeCrc32(u32 crc, const u8* c, size_t len)
 {
-	const u8* c = static_cast<const u8*>(data);
-	u32 crc = 0xffffFFFF;
-	int len = length;
+	while (len && ((uintptr)c & 7))
+	{
+		crc = (crc >> 8) ^ crc32Table[(crc & 0xFF) ^ *c];
+		--len;
+		++c;
+	}
+	while (len >= 8)
+	{
+		u32 lo = *(const u32*)c ^ crc;
+		u32 hi = *(const u32*)(c + 4);
+		crc = crc32Tables[7][lo & 0xFF] ^ crc32Tables[6][(lo >> 8) & 0xFF] ^
+			  crc32Tables[5][(lo >> 16) & 0xFF] ^ crc32Tables[4][lo >> 24] ^
+			  crc32Tables[3][hi & 0xFF] ^ crc32Tables[2][(hi >> 8) & 0xFF] ^
+			  crc32Tables[1][(hi >> 16) & 0xFF] ^ crc32Tables[0][hi >> 24];
+		c += 8;
+		len -= 8;
+	}
 	while (len)
 	{
-		crc = (crc >> 8) ^ crc32Table[crc & 0xFF ^ *c];
+		crc = (crc >> 8) ^ crc32Table[(crc & 0xFF) ^ *c];
 		--len;
 		++c;
 	}
-	return ~crc;
+	return crc;
+}
+
+
+u32 crc32(const void* data, int length)
+{
+	return ~computeCrc32(0xffffFFFF, static_cast<const u8*>(data), length);
 }
 
 
 u32 crc32(const char* str)
 {
-	const u8* c = reinterpret_cast<const u8*>(str);
-	u32 crc = 0xffffFFFF;
-	while (*c)
-	{
-		crc = (crc >> 8) ^ crc32Table[crc & 0xFF ^ *c];
-		++c;
-	}
-	return ~crc;
+	const char* c = str;
+	while (*c) ++c;
+	return ~computeCrc32(0xffffFFFF, reinterpret_cast<const u8*>(str), c - str);
 }
 
 
 u32 continueCrc32(u32 original_crc, const char* str)
 {
-	const u8* c = reinterpret_cast<const u8*>(str);
-	u32 crc = ~original_crc;
-	while (*c)
-	{
-		crc = (crc >> 8) ^ crc32Table[crc & 0xFF ^ *c];
-		++c;
-	}
-	return ~crc;
+	const char* c = str;
+	while (*c) ++c;
+	return ~computeCrc32(~original_crc, reinterpret_cast<const u8*>(str), c - str);
 }
 
 
@@ -2,18 +2,24 @@
 #include "engine/blob.h"
 #include "engine/crc32.h"
 #include "engine/debug/debug.h"
+#include "engine/fs/cache_file_device.h"
 #include "engine/fs/disk_file_device.h"
+#include "engine/fs/mapped_file_device.h"
 #include "engine/fs/file_system.h"
 #include "engine/fs/memory_file_device.h"
 #include "engine/fs/os_file.h"
 #include "engine/fs/resource_file_device.h"
 #include "engine/input_system.h"
 #include "engine/iplugin.h"
+#include "engine/frame_allocator.h"
 #include "engine/lifo_allocator.h"
 #include "engine/log.h"
 #include "engine/lua_wrapper.h"
 #include "engine/lua_wrapper.h"
 #include "engine/math_utils.h"
+#include "engine/mtjd/for_each.h"
+#include "engine/mtjd/generic_job.h"
+#include "engine/mtjd/group.h"
 #include "engine/mtjd/manager.h"
 #include "engine/path.h"
 #include "engine/plugin_manager.h"
@@ -22,6 +28,7 @@
 #include "engine/property_descriptor.h"
 #include "engine/property_register.h"
 #include "engine/resource_manager.h"
+#include "engine/resource_manager_base.h"
 #include "engine/timer.h"
 #include "engine/universe/hierarchy.h"
 #include "engine/universe/universe.h"
@@ -359,6 +366,7 @@ void registerCFunction(lua_State* L, const char* name, lua_CFunction f)
 }
 
 static const u32 SERIALIZED_ENGINE_MAGIC = 0x5f4c454e; // == '_LEN'
+static const u32 SERIALIZED_ENGINE_VERSION = 1;
 static const ResourceType PREFAB_TYPE("prefab");
 static const ComponentType HIERARCHY_TYPE = PropertyRegister::getComponentType("hierarchy");
 
@@ -372,7 +380,7 @@ class SerializedEngineHeader
 {
 public:
 	u32 m_magic;
-	u32 m_reserved; // for crc
+	u32 m_version; // 0 = legacy stream without scene section sizes
 };
 #pragma pack()
 
@@ -401,20 +409,25 @@ public:
 		: m_allocator(allocator)
 		, m_prefab_resource_manager(m_allocator)
 		, m_resource_manager(m_allocator)
+		, m_preloaded_resources(m_allocator)
 		, m_lua_resources(m_allocator)
 		, m_last_lua_resource_idx(-1)
 		, m_mtjd_manager(nullptr)
 		, m_fps(0)
-		, m_is_game_running(false)
+		, m_game_running_count(0)
 		, m_last_time_delta(0)
 		, m_time(0)
 		, m_path_manager(m_allocator)
 		, m_time_multiplier(1.0f)
+		, m_fixed_timestep(0)
 		, m_paused(false)
 		, m_next_frame(false)
+		, m_last_save_size(0)
 		, m_lifo_allocator(m_allocator, 10 * 1024 * 1024)
+		, m_frame_allocators(m_allocator, 1024 * 1024)
 	{
 		g_log_info.log("Core") << "Creating engine...";
+		startAsyncLogging(m_allocator);
 		Profiler::setThreadName("Main");
 		installUnhandledExceptionHandler();
 
@@ -438,22 +451,26 @@ public:
 			m_mem_file_device = LUMIX_NEW(m_allocator, FS::MemoryFileDevice)(m_allocator);
 			m_resource_file_device = LUMIX_NEW(m_allocator, FS::ResourceFileDevice)(m_allocator);
 			m_disk_file_device = LUMIX_NEW(m_allocator, FS::DiskFileDevice)("disk", base_path0, m_allocator);
+			m_mapped_file_device = LUMIX_NEW(m_allocator, FS::MappedFileDevice)("mapped", base_path0, m_allocator);
+			m_cache_file_device = LUMIX_NEW(m_allocator, FS::CacheFileDevice)(m_allocator);
 
 			m_file_system->mount(m_mem_file_device);
 			m_file_system->mount(m_resource_file_device);
 			m_file_system->mount(m_disk_file_device);
+			m_file_system->mount(m_mapped_file_device);
+			m_file_system->mount(m_cache_file_device);
 			bool is_patching = base_path1[0] != 0 && !equalStrings(base_path0, base_path1);
 			if (is_patching)
 			{
 				m_patch_file_device = LUMIX_NEW(m_allocator, FS::DiskFileDevice)("patch", base_path1, m_allocator);
 				m_file_system->mount(m_patch_file_device);
-				m_file_system->setDefaultDevice("memory:patch:disk:resource");
+				m_file_system->setDefaultDevice("memory:patch:mapped:disk:resource");
 				m_file_system->setSaveGameDevice("memory:disk:resource");
 			}
 			else
 			{
 				m_patch_file_device = nullptr;
-				m_file_system->setDefaultDevice("memory:disk:resource");
+				m_file_system->setDefaultDevice("memory:mapped:disk:resource");
 				m_file_system->setSaveGameDevice("memory:disk:resource");
 			}
 		}
@@ -463,6 +480,8 @@ public:
 			m_mem_file_device = nullptr;
 			m_resource_file_device = nullptr;
 			m_disk_file_device = nullptr;
+			m_mapped_file_device = nullptr;
+			m_cache_file_device = nullptr;
 			m_patch_file_device = nullptr;
 		}
 
@@ -759,6 +778,10 @@ public:
 	static void LUA_pause(Engine* engine, bool pause) { engine->pause(pause); }
 	static void LUA_nextFrame(Engine* engine) { engine->nextFrame(); }
 	static void LUA_setTimeMultiplier(Engine* engine, float multiplier) { engine->setTimeMultiplier(multiplier); }
+	static void LUA_setFixedTimestep(Engine* engine, float dt) { engine->setFixedTimestep(dt); }
+	static void LUA_enableLoadTelemetry(bool enable) { Profiler::enableLoadTelemetry(enable); }
+	static void LUA_enableHitchDetector(bool enable) { Profiler::enableHitchDetector(enable); }
+	static void LUA_setFrameBudget(const char* name, float budget_ms) { Profiler::setBudget(name, budget_ms); }
 	static Entity LUA_getFirstEntity(Universe* universe) { return universe->getFirstEntity(); }
 	static Entity LUA_getNextEntity(Universe* universe, Entity entity) { return universe->getNextEntity(entity); }
 	static Vec4 LUA_multMatrixVec(const Matrix& m, const Vec4& v) { return m * v; }
@@ -812,7 +835,9 @@ public:
 
 	static void LUA_destroyEntity(Universe* universe, Entity entity)
 	{
-		universe->destroyEntity(entity);
+		// scripts run mid-frame; deferring keeps handles other scripts hold
+		// valid until the end-of-frame fence
+		universe->deferDestroyEntity(entity);
 	}
 
 
@@ -861,12 +886,17 @@ public:
 		REGISTER_FUNCTION(setEntityLocalRotation);
 		REGISTER_FUNCTION(setEntityPosition);
 		REGISTER_FUNCTION(setEntityRotation);
+		REGISTER_FUNCTION(setFrameBudget);
 		REGISTER_FUNCTION(setTimeMultiplier);
+		REGISTER_FUNCTION(setFixedTimestep);
+		REGISTER_FUNCTION(enableLoadTelemetry);
+		REGISTER_FUNCTION(enableHitchDetector);
 		REGISTER_FUNCTION(startGame);
 		REGISTER_FUNCTION(unloadResource);
 
 		#undef REGISTER_FUNCTION
 
+		LuaWrapper::createSystemFunction(m_state, "Engine", "getEntitiesWithComponents", &LUA_getEntitiesWithComponents);
 		LuaWrapper::createSystemFunction(m_state, "Engine", "instantiatePrefab", &LUA_instantiatePrefab);
 		LuaWrapper::createSystemFunction(m_state, "Engine", "createEntityEx", &LUA_createEntityEx);
 		LuaWrapper::createSystemFunction(m_state, "Engine", "multVecQuat", &LUA_multVecQuat);
@@ -1039,6 +1069,7 @@ public:
 
 	~EngineImpl()
 	{
+		releasePreloadedResources();
 		for (Resource* res : m_lua_resources)
 		{
 			res->getResourceManager().unload(*res);
@@ -1055,6 +1086,8 @@ public:
 			LUMIX_DELETE(m_allocator, m_mem_file_device);
 			LUMIX_DELETE(m_allocator, m_resource_file_device);
 			LUMIX_DELETE(m_allocator, m_disk_file_device);
+			LUMIX_DELETE(m_allocator, m_mapped_file_device);
+			LUMIX_DELETE(m_allocator, m_cache_file_device);
 			LUMIX_DELETE(m_allocator, m_patch_file_device);
 		}
 
@@ -1063,6 +1096,7 @@ public:
 		MTJD::Manager::destroy(*m_mtjd_manager);
 		lua_close(m_state);
 
+		stopAsyncLogging();
 		g_error_file.close();
 	}
 
@@ -1172,12 +1206,13 @@ public:
 
 	void startGame(Universe& context) override
 	{
-		ASSERT(!m_is_game_running);
-		m_is_game_running = true;
+		++m_game_running_count;
 		for (auto* scene : context.getScenes())
 		{
 			scene->startGame();
 		}
+		// plugins are process-wide, they start with the first universe only
+		if (m_game_running_count != 1) return;
 		for (auto* plugin : m_plugin_manager->getPlugins())
 		{
 			plugin->startGame();
@@ -1187,12 +1222,13 @@ public:
 
 	void stopGame(Universe& context) override
 	{
-		ASSERT(m_is_game_running);
-		m_is_game_running = false;
+		ASSERT(m_game_running_count > 0);
+		--m_game_running_count;
 		for (auto* scene : context.getScenes())
 		{
 			scene->stopGame();
 		}
+		if (m_game_running_count != 0) return;
 		for (auto* plugin : m_plugin_manager->getPlugins())
 		{
 			plugin->stopGame();
@@ -1218,9 +1254,94 @@ public:
 	}
 
 
+	void setFixedTimestep(float dt) override
+	{
+		m_fixed_timestep = dt;
+	}
+
+
+	static bool scenesConflict(const IScene::UpdateAccess& a, const IScene::UpdateAccess& b)
+	{
+		if (a.transform_write && (b.transform_read || b.transform_write)) return true;
+		if (b.transform_write && a.transform_read) return true;
+		if ((a.component_writes & (b.component_reads | b.component_writes)) != 0) return true;
+		if ((b.component_writes & a.component_reads) != 0) return true;
+		return false;
+	}
+
+
+	// greedy list scheduling over the declared access masks: each scene lands
+	// in the first phase after the last scene it conflicts with, so scenes in
+	// one phase touch disjoint state and run concurrently on MTJD workers while
+	// conflicting scenes keep their registration order
+	void updateScenes(Universe& context, float dt)
+	{
+		auto& scenes = context.getScenes();
+		int count = scenes.size();
+		ASSERT(count <= MAX_COMPONENTS_TYPES_COUNT);
+		IScene::UpdateAccess accesses[MAX_COMPONENTS_TYPES_COUNT];
+		int phases[MAX_COMPONENTS_TYPES_COUNT];
+		int phase_count = 0;
+		for (int i = 0; i < count; ++i)
+		{
+			accesses[i] = scenes[i]->getUpdateAccess();
+			int phase = 0;
+			for (int j = 0; j < i; ++j)
+			{
+				if (scenesConflict(accesses[i], accesses[j]))
+				{
+					phase = Math::maximum(phase, phases[j] + 1);
+				}
+			}
+			phases[i] = phase;
+			phase_count = Math::maximum(phase_count, phase + 1);
+		}
+
+		for (int phase = 0; phase < phase_count; ++phase)
+		{
+			int phase_size = 0;
+			int last_idx = -1;
+			for (int i = 0; i < count; ++i)
+			{
+				if (phases[i] != phase) continue;
+				++phase_size;
+				last_idx = i;
+			}
+			if (phase_size == 1)
+			{
+				IScene* scene = scenes[last_idx];
+				u64 start = Profiler::now();
+				scene->update(dt, m_paused);
+				Profiler::addBudgetTime(scene->getPlugin().getName(), Profiler::now() - start);
+				continue;
+			}
+
+			MTJD::Group phase_sync(true, m_allocator);
+			for (int i = 0; i < count; ++i)
+			{
+				if (phases[i] != phase) continue;
+
+				IScene* scene = scenes[i];
+				bool paused = m_paused;
+				MTJD::Job* job = MTJD::makeJob(*m_mtjd_manager,
+					[scene, dt, paused]() {
+						u64 start = Profiler::now();
+						scene->update(dt, paused);
+						Profiler::addBudgetTime(scene->getPlugin().getName(), Profiler::now() - start);
+					},
+					m_mtjd_manager->getJobAllocator());
+				job->addDependency(&phase_sync);
+				m_mtjd_manager->schedule(job);
+			}
+			phase_sync.sync();
+		}
+	}
+
+
 	void update(Universe& context) override
 	{
 		PROFILE_FUNCTION();
+		m_frame_allocators.resetAll();
 		float dt;
 		++m_fps_frame;
 		if (m_fps_timer->getTimeSinceTick() > 0.5f)
@@ -1229,6 +1350,8 @@ public:
 			m_fps_frame = 0;
 		}
 		dt = m_timer->tick() * m_time_multiplier;
+		// the timer is ticked anyway so real time does not pile up in it
+		if (m_fixed_timestep > 0) dt = m_fixed_timestep;
 		if (m_next_frame)
 		{
 			m_paused = false;
@@ -1236,23 +1359,31 @@ public:
 		}
 		m_time += dt;
 		m_last_time_delta = dt;
+		{
+			PROFILE_BLOCK("publish transform snapshot");
+			// frame fence: no job reading the previous snapshot is running here
+			context.publishTransformSnapshot();
+		}
 		{
 			PROFILE_BLOCK("update scenes");
-			for (auto* scene : context.getScenes())
-			{
-				scene->update(dt, m_paused);
-			}
+			updateScenes(context, dt);
 		}
 		{
 			PROFILE_BLOCK("late update scenes");
 			for (auto* scene : context.getScenes())
 			{
+				u64 start = Profiler::now();
 				scene->lateUpdate(dt, m_paused);
+				Profiler::addBudgetTime(scene->getPlugin().getName(), Profiler::now() - start);
 			}
 		}
+		context.processDeferredDestruction();
 		m_plugin_manager->update(dt, m_paused);
 		m_input_system->update(dt);
+		m_resource_manager.updateLoadQueues(64);
 		getFileSystem().updateAsyncTransactions();
+		// sampled here so a hitch dump can say whether IO was backed up
+		Profiler::setIOQueueDepth(getFileSystem().getPendingAsyncCount());
 
 		if (m_next_frame)
 		{
@@ -1262,6 +1393,52 @@ public:
 	}
 
 
+	// headless server mode: steps every universe (game room) by the same dt,
+	// one worker per room; rooms share loaded resources through the resource
+	// managers and must treat them as immutable, scenes only touch their own
+	// universe so rooms do not need the per-scene phase scheduling
+	void updateUniverses(Universe** universes, int count) override
+	{
+		PROFILE_FUNCTION();
+		m_frame_allocators.resetAll();
+		++m_fps_frame;
+		if (m_fps_timer->getTimeSinceTick() > 0.5f)
+		{
+			m_fps = m_fps_frame / m_fps_timer->tick();
+			m_fps_frame = 0;
+		}
+		float dt = m_timer->tick() * m_time_multiplier;
+		if (m_fixed_timestep > 0) dt = m_fixed_timestep;
+		m_time += dt;
+		m_last_time_delta = dt;
+
+		bool paused = m_paused;
+		MTJD::forEach(*m_mtjd_manager, m_allocator, 0, count, 1, [universes, dt, paused](int from, int to) {
+			for (int i = from; i < to; ++i)
+			{
+				Universe* universe = universes[i];
+				universe->publishTransformSnapshot();
+				for (auto* scene : universe->getScenes())
+				{
+					u64 start = Profiler::now();
+					scene->update(dt, paused);
+					Profiler::addBudgetTime(scene->getPlugin().getName(), Profiler::now() - start);
+				}
+				for (auto* scene : universe->getScenes())
+				{
+					scene->lateUpdate(dt, paused);
+				}
+				universe->processDeferredDestruction();
+			}
+		});
+
+		m_plugin_manager->update(dt, m_paused);
+		m_resource_manager.updateLoadQueues(64);
+		getFileSystem().updateAsyncTransactions();
+		Profiler::setIOQueueDepth(getFileSystem().getPendingAsyncCount());
+	}
+
+
 	InputSystem& getInputSystem() override { return *m_input_system; }
 
 
@@ -1336,9 +1513,11 @@ public:
 
 	u32 serialize(Universe& ctx, OutputBlob& serializer) override
 	{
+		// size of the previous save is the best guess for this one
+		serializer.reserve(serializer.getPos() + m_last_save_size);
 		SerializedEngineHeader header;
 		header.m_magic = SERIALIZED_ENGINE_MAGIC; // == '_LEN'
-		header.m_reserved = 0;
+		header.m_version = SERIALIZED_ENGINE_VERSION;
 		serializer.write(header);
 		serializePluginList(serializer);
 		serializerSceneVersions(serializer, ctx);
@@ -1350,13 +1529,88 @@ public:
 		for (auto* scene : ctx.getScenes())
 		{
 			serializer.writeString(scene->getPlugin().getName());
+			// section size is patched afterwards; the loader uses it to slice
+			// each scene's data out of the stream without replaying it
+			int size_pos = serializer.getPos();
+			serializer.write((i32)0);
 			scene->serialize(serializer);
+			i32 section_size = serializer.getPos() - size_pos - (i32)sizeof(i32);
+			copyMemory((u8*)serializer.getMutableData() + size_pos, &section_size, sizeof(section_size));
 		}
 		u32 crc = crc32((const u8*)serializer.getData() + pos, serializer.getPos() - pos);
+		m_last_save_size = serializer.getPos();
 		return crc;
 	}
 
 
+	void serializeResourceManifest(OutputBlob& serializer) override
+	{
+		serializer.write(RESOURCE_MANIFEST_MAGIC);
+		serializer.write(RESOURCE_MANIFEST_VERSION);
+
+		i32 count = 0;
+		for (auto* manager : m_resource_manager.getAll())
+		{
+			count += manager->getResourceTable().size();
+		}
+		serializer.write(count);
+
+		for (auto iter = m_resource_manager.getAll().begin(), end = m_resource_manager.getAll().end();
+			 iter != end;
+			 ++iter)
+		{
+			for (Resource* resource : iter.value()->getResourceTable())
+			{
+				serializer.write(iter.key());
+				serializer.writeString(resource->getPath().c_str());
+			}
+		}
+	}
+
+
+	bool preloadResourceManifest(InputBlob& serializer) override
+	{
+		u32 magic;
+		u32 version;
+		serializer.read(magic);
+		if (magic != RESOURCE_MANIFEST_MAGIC)
+		{
+			g_log_error.log("Core") << "Wrong or corrupted resource manifest";
+			return false;
+		}
+		serializer.read(version);
+		if (version != RESOURCE_MANIFEST_VERSION) return false;
+
+		i32 count;
+		serializer.read(count);
+		for (int i = 0; i < count; ++i)
+		{
+			u32 type;
+			char path[MAX_PATH_LENGTH];
+			serializer.read(type);
+			serializer.readString(path, lengthOf(path));
+
+			ResourceType resource_type;
+			resource_type.type = type;
+			ResourceManagerBase* manager = m_resource_manager.get(resource_type);
+			if (!manager) continue;
+
+			m_preloaded_resources.push(manager->load(Path(path)));
+		}
+		return true;
+	}
+
+
+	void releasePreloadedResources()
+	{
+		for (Resource* resource : m_preloaded_resources)
+		{
+			resource->getResourceManager().unload(*resource);
+		}
+		m_preloaded_resources.clear();
+	}
+
+
 	bool deserialize(Universe& ctx, InputBlob& serializer) override
 	{
 		SerializedEngineHeader header;
@@ -1379,9 +1633,28 @@ public:
 			char tmp[32];
 			serializer.readString(tmp, sizeof(tmp));
 			IScene* scene = ctx.getScene(crc32(tmp));
-			scene->deserialize(serializer);
+			if (header.m_version < 1)
+			{
+				scene->deserialize(serializer);
+				continue;
+			}
+			// each scene reads from its own slice of the stream; a scene whose
+			// plugin is gone is skipped instead of corrupting everything after it
+			i32 section_size;
+			serializer.read(section_size);
+			const u8* section = (const u8*)serializer.skip(section_size);
+			if (!scene)
+			{
+				g_log_warning.log("Core") << "Skipping data of missing scene " << tmp;
+				continue;
+			}
+			InputBlob section_blob(section, section_size);
+			scene->deserialize(section_blob);
 		}
 		m_path_manager.clear();
+		// scenes requested their resources above and hold their own references
+		// now, so the batch-issued preloads are no longer needed
+		releasePreloadedResources();
 		return true;
 	}
 
@@ -1396,6 +1669,30 @@ public:
 	}
 
 
+	static int LUA_getEntitiesWithComponents(lua_State* L)
+	{
+		auto* universe = LuaWrapper::checkArg<Universe*>(L, 1);
+		u64 mask = 0;
+		int arg_count = lua_gettop(L);
+		for (int i = 2; i <= arg_count; ++i)
+		{
+			const char* type_name = LuaWrapper::checkArg<const char*>(L, i);
+			ComponentType type = PropertyRegister::getComponentType(type_name);
+			mask |= (u64)1 << type.index;
+		}
+		Array<Entity> entities(universe->getAllocator());
+		universe->getEntitiesWithComponents(mask, entities);
+
+		lua_createtable(L, entities.size(), 0);
+		for (int i = 0; i < entities.size(); ++i)
+		{
+			LuaWrapper::push(L, entities[i]);
+			lua_rawseti(L, -2, i + 1);
+		}
+		return 1;
+	}
+
+
 	static int LUA_instantiatePrefab(lua_State* L)
 	{
 		auto* engine = LuaWrapper::checkArg<EngineImpl*>(L, 1);
@@ -1460,6 +1757,12 @@ public:
 	}
 
 
+	IAllocator& getFrameAllocator() override
+	{
+		return m_frame_allocators.getThreadLocal();
+	}
+
+
 	void runScript(const char* src, int src_length, const char* path) override
 	{
 		if (luaL_loadbuffer(m_state, src, src_length, path) != LUA_OK)
@@ -1485,11 +1788,14 @@ public:
 private:
 	IAllocator& m_allocator;
 	LIFOAllocator m_lifo_allocator;
+	FrameAllocators m_frame_allocators;
 
 	FS::FileSystem* m_file_system;
 	FS::MemoryFileDevice* m_mem_file_device;
 	FS::ResourceFileDevice* m_resource_file_device;
 	FS::DiskFileDevice* m_disk_file_device;
+	FS::MappedFileDevice* m_mapped_file_device;
+	FS::CacheFileDevice* m_cache_file_device;
 	FS::DiskFileDevice* m_patch_file_device;
 
 	ResourceManager m_resource_manager;
@@ -1503,15 +1809,18 @@ private:
 	Timer* m_fps_timer;
 	int m_fps_frame;
 	float m_time_multiplier;
+	float m_fixed_timestep;
 	float m_fps;
 	float m_last_time_delta;
 	double m_time;
-	bool m_is_game_running;
+	int m_game_running_count;
 	bool m_paused;
 	bool m_next_frame;
+	int m_last_save_size;
 	PlatformData m_platform_data;
 	PathManager m_path_manager;
 	lua_State* m_state;
+	Array<Resource*> m_preloaded_resources;
 	HashMap<int, Resource*> m_lua_resources;
 	int m_last_lua_resource_idx;
 
@@ -44,6 +44,14 @@ public:
 		void* display;
 	};
 
+	// format of the blob written by serializeResourceManifest; public so the
+	// editor's pack step can parse saved manifests without loading the universe
+	enum : u32
+	{
+		RESOURCE_MANIFEST_MAGIC = 0x5f4c524d, // == '_LRM'
+		RESOURCE_MANIFEST_VERSION = 1
+	};
+
 public:
 	virtual ~Engine() {}
 
@@ -73,12 +81,26 @@ public:
 	virtual void stopGame(Universe& context) = 0;
 
 	virtual void update(Universe& context) = 0;
+	// steps every universe by the same dt, one worker thread per universe; made
+	// for headless servers hosting many match instances in one process, where
+	// the resource managers already share loaded data between the universes
+	virtual void updateUniverses(Universe** universes, int count) = 0;
 	virtual u32 serialize(Universe& ctx, OutputBlob& serializer) = 0;
 	virtual bool deserialize(Universe& ctx, InputBlob& serializer) = 0;
+	// writes a manifest of every loaded resource; the editor saves it next to
+	// the universe so a runtime load can request all leaf files in one batch
+	// instead of discovering them through the model-material-texture chain
+	virtual void serializeResourceManifest(OutputBlob& serializer) = 0;
+	// issues a load for every resource in the manifest; the references are
+	// held until the next successful deserialize and then released
+	virtual bool preloadResourceManifest(InputBlob& serializer) = 0;
 	virtual float getFPS() const = 0;
 	virtual double getTime() const = 0;
 	virtual float getLastTimeDelta() const = 0;
 	virtual void setTimeMultiplier(float multiplier) = 0;
+	// forces every update to use a constant dt instead of wall clock time, so
+	// scripted runs are deterministic; 0 restores real time
+	virtual void setFixedTimestep(float dt) = 0;
 	virtual void pause(bool pause) = 0;
 	virtual void nextFrame() = 0;
 	virtual PathManager& getPathManager() = 0;
@@ -86,6 +108,7 @@ public:
 	virtual void runScript(const char* src, int src_length, const char* path) = 0;
 	virtual ComponentUID createComponent(Universe& universe, Entity entity, ComponentType type) = 0;
 	virtual IAllocator& getLIFOAllocator() = 0;
+	virtual IAllocator& getFrameAllocator() = 0;
 	virtual class Resource* getLuaResource(int idx) const = 0;
 	virtual int addLuaResource(const Path& path, struct ResourceType type) = 0;
 	virtual void unloadLuaResource(int resource_idx) = 0;
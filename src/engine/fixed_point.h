@@ -0,0 +1,192 @@
+#pragma once
+
+
+#include "engine/lumix.h"
+
+
+namespace Lumix
+{
+
+
+// 48.16 fixed point scalar for deterministic simulation; every operation is
+// plain integer arithmetic, so results are bit-identical across compilers,
+// platforms and optimization levels, unlike float math where fma contraction
+// and x87 excess precision desync lockstep peers. Gameplay code that has to
+// stay in sync opts into this type, the engine's own math stays float
+struct Fixed
+{
+	enum { FRACTION_BITS = 16 };
+	enum : i64 { ONE_RAW = (i64)1 << FRACTION_BITS };
+
+	Fixed() {}
+	explicit Fixed(int value) : raw((i64)value << FRACTION_BITS) {}
+
+	static Fixed fromRaw(i64 raw)
+	{
+		Fixed f;
+		f.raw = raw;
+		return f;
+	}
+
+	// the float conversions are for i/o at the simulation boundary only;
+	// feeding floats back into deterministic state defeats the purpose
+	static Fixed fromFloat(float value) { return fromRaw((i64)(value * ONE_RAW)); }
+	float toFloat() const { return (float)raw / ONE_RAW; }
+	int toInt() const { return (int)(raw >> FRACTION_BITS); }
+
+	Fixed operator+(Fixed rhs) const { return fromRaw(raw + rhs.raw); }
+	Fixed operator-(Fixed rhs) const { return fromRaw(raw - rhs.raw); }
+	Fixed operator-() const { return fromRaw(-raw); }
+	void operator+=(Fixed rhs) { raw += rhs.raw; }
+	void operator-=(Fixed rhs) { raw -= rhs.raw; }
+
+	Fixed operator*(Fixed rhs) const { return fromRaw(mulShift(raw, rhs.raw)); }
+	void operator*=(Fixed rhs) { raw = mulShift(raw, rhs.raw); }
+
+	Fixed operator/(Fixed rhs) const { return fromRaw(divShift(raw, rhs.raw)); }
+	void operator/=(Fixed rhs) { raw = divShift(raw, rhs.raw); }
+
+	bool operator<(Fixed rhs) const { return raw < rhs.raw; }
+	bool operator<=(Fixed rhs) const { return raw <= rhs.raw; }
+	bool operator>(Fixed rhs) const { return raw > rhs.raw; }
+	bool operator>=(Fixed rhs) const { return raw >= rhs.raw; }
+	bool operator==(Fixed rhs) const { return raw == rhs.raw; }
+	bool operator!=(Fixed rhs) const { return raw != rhs.raw; }
+
+	// (a * b) >> FRACTION_BITS with a full 128 bit intermediate, done in
+	// 32 bit limbs so it compiles the same everywhere
+	static i64 mulShift(i64 a, i64 b)
+	{
+		bool negative = (a < 0) != (b < 0);
+		u64 ua = a < 0 ? (u64)-a : (u64)a;
+		u64 ub = b < 0 ? (u64)-b : (u64)b;
+		u64 a_lo = ua & 0xffffFFFF;
+		u64 a_hi = ua >> 32;
+		u64 b_lo = ub & 0xffffFFFF;
+		u64 b_hi = ub >> 32;
+		u64 lo_lo = a_lo * b_lo;
+		u64 lo_hi = a_lo * b_hi;
+		u64 hi_lo = a_hi * b_lo;
+		u64 hi_hi = a_hi * b_hi;
+		u64 mid = (lo_lo >> 32) + (lo_hi & 0xffffFFFF) + (hi_lo & 0xffffFFFF);
+		u64 result_lo = (lo_lo & 0xffffFFFF) | (mid << 32);
+		u64 result_hi = hi_hi + (lo_hi >> 32) + (hi_lo >> 32) + (mid >> 32);
+		u64 shifted = (result_lo >> FRACTION_BITS) | (result_hi << (64 - FRACTION_BITS));
+		return negative ? -(i64)shifted : (i64)shifted;
+	}
+
+	// (a << FRACTION_BITS) / b, limb version of the same idea
+	static i64 divShift(i64 a, i64 b)
+	{
+		bool negative = (a < 0) != (b < 0);
+		u64 ua = a < 0 ? (u64)-a : (u64)a;
+		u64 ub = b < 0 ? (u64)-b : (u64)b;
+		// long division of the 80 bit value (ua << 16) by ub; the high part
+		// seeds the remainder, then the low 64 bits come in one at a time
+		u64 hi = ua >> (64 - FRACTION_BITS);
+		u64 lo = ua << FRACTION_BITS;
+		u64 remainder = hi;
+		u64 quotient = 0;
+		for (int i = 63; i >= 0; --i)
+		{
+			remainder = (remainder << 1) | ((lo >> i) & 1);
+			quotient <<= 1;
+			if (remainder >= ub)
+			{
+				remainder -= ub;
+				quotient |= 1;
+			}
+		}
+		return negative ? -(i64)quotient : (i64)quotient;
+	}
+
+	i64 raw;
+};
+
+
+inline Fixed fixedAbs(Fixed a)
+{
+	return a.raw < 0 ? Fixed::fromRaw(-a.raw) : a;
+}
+
+
+inline Fixed fixedMin(Fixed a, Fixed b) { return a < b ? a : b; }
+inline Fixed fixedMax(Fixed a, Fixed b) { return a > b ? a : b; }
+
+
+// bit-by-bit integer square root, exact for the representable range
+inline Fixed fixedSqrt(Fixed a)
+{
+	if (a.raw <= 0) return Fixed(0);
+	// sqrt(raw * 2^16) keeps the result in the same 48.16 format
+	u64 value = (u64)a.raw << Fixed::FRACTION_BITS;
+	u64 result = 0;
+	u64 bit = (u64)1 << 62;
+	while (bit > value) bit >>= 2;
+	while (bit)
+	{
+		if (value >= result + bit)
+		{
+			value -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else
+		{
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return Fixed::fromRaw((i64)result);
+}
+
+
+// pi in 48.16
+inline Fixed fixedPi() { return Fixed::fromRaw(205887); }
+
+
+// sine by table with linear interpolation; 256 samples over the quarter
+// wave keep the error under 2e-4 while staying pure integer
+LUMIX_ENGINE_API Fixed fixedSin(Fixed angle);
+LUMIX_ENGINE_API Fixed fixedCos(Fixed angle);
+LUMIX_ENGINE_API Fixed fixedAtan2(Fixed y, Fixed x);
+
+
+// deterministic counterpart of Vec3 for simulation state
+struct FixedVec3
+{
+	FixedVec3() {}
+	FixedVec3(Fixed x, Fixed y, Fixed z) : x(x), y(y), z(z) {}
+
+	FixedVec3 operator+(const FixedVec3& rhs) const { return FixedVec3(x + rhs.x, y + rhs.y, z + rhs.z); }
+	FixedVec3 operator-(const FixedVec3& rhs) const { return FixedVec3(x - rhs.x, y - rhs.y, z - rhs.z); }
+	FixedVec3 operator*(Fixed rhs) const { return FixedVec3(x * rhs, y * rhs, z * rhs); }
+
+	Fixed squaredLength() const { return x * x + y * y + z * z; }
+	Fixed length() const { return fixedSqrt(squaredLength()); }
+
+	void normalize()
+	{
+		Fixed len = length();
+		if (len.raw == 0) return;
+		x /= len;
+		y /= len;
+		z /= len;
+	}
+
+	Fixed x, y, z;
+};
+
+
+inline Fixed dotProduct(const FixedVec3& a, const FixedVec3& b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+
+inline FixedVec3 crossProduct(const FixedVec3& a, const FixedVec3& b)
+{
+	return FixedVec3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+
+} // namespace Lumix
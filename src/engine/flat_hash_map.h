@@ -0,0 +1,302 @@
+#pragma once
+
+
+#include "engine/hash_map.h"
+#include "engine/math_utils.h"
+
+
+namespace Lumix
+{
+
+
+	// Open-addressing, robin-hood hash map with contiguous key/value storage.
+	// Lookups probe a linear run of slots instead of chasing chained nodes, so
+	// hot maps (resource tables, name lookups) stay cache resident.
+	template<class K, class T, class Hasher = HashFunc<K>>
+	class FlatHashMap
+	{
+	public:
+		typedef T value_type;
+		typedef K key_type;
+		typedef Hasher hasher_type;
+		typedef FlatHashMap<key_type, value_type, hasher_type> my_type;
+		typedef u32 size_type;
+
+		static const size_type s_default_ids_count = 8;
+		static const u8 EMPTY_SLOT = 0;
+
+		template <class HM, class KT, class VT>
+		class IteratorBase
+		{
+		public:
+			IteratorBase()
+				: m_map(nullptr)
+				, m_idx(0)
+			{
+			}
+
+			IteratorBase(HM* map, size_type idx)
+				: m_map(map)
+				, m_idx(idx)
+			{
+			}
+
+			bool isValid() const { return m_map && m_idx < m_map->m_capacity; }
+
+			KT& key() const { return m_map->m_keys[m_idx]; }
+			VT& value() const { return m_map->m_values[m_idx]; }
+			VT& operator*() const { return value(); }
+
+			IteratorBase& operator++()
+			{
+				m_idx = m_map->nextOccupied(m_idx + 1);
+				return *this;
+			}
+
+			IteratorBase operator++(int)
+			{
+				IteratorBase tmp = *this;
+				m_idx = m_map->nextOccupied(m_idx + 1);
+				return tmp;
+			}
+
+			bool operator==(const IteratorBase& rhs) const { return rhs.m_idx == m_idx && rhs.m_map == m_map; }
+			bool operator!=(const IteratorBase& rhs) const { return rhs.m_idx != m_idx || rhs.m_map != m_map; }
+
+		private:
+			friend class FlatHashMap;
+
+			HM* m_map;
+			size_type m_idx;
+		};
+
+		typedef IteratorBase<my_type, key_type, value_type> iterator;
+		typedef IteratorBase<const my_type, const key_type, const value_type> constIterator;
+
+		friend class IteratorBase<my_type, key_type, value_type>;
+		friend class IteratorBase<const my_type, const key_type, const value_type>;
+
+		explicit FlatHashMap(IAllocator& allocator)
+			: m_allocator(allocator)
+		{
+			init(s_default_ids_count);
+		}
+
+		FlatHashMap(size_type buckets, IAllocator& allocator)
+			: m_allocator(allocator)
+		{
+			init(Math::nextPow2(buckets));
+		}
+
+		~FlatHashMap()
+		{
+			callDestructors();
+			m_allocator.deallocate(m_keys);
+			m_allocator.deallocate(m_values);
+			m_allocator.deallocate(m_distances);
+		}
+
+		size_type size() const { return m_size; }
+		bool empty() const { return 0 == m_size; }
+
+		float loadFactor() const { return float(m_size) / m_capacity; }
+		float maxLoadFactor() const { return 0.75f; }
+
+		value_type& operator[](const key_type& key) const
+		{
+			size_type idx = findIdx(key);
+			ASSERT(idx < m_capacity);
+			return m_values[idx];
+		}
+
+		value_type& at(const key_type& key)
+		{
+			size_type idx = findIdx(key);
+			ASSERT(idx < m_capacity);
+			return m_values[idx];
+		}
+
+		void insert(const key_type& key, const value_type& val)
+		{
+			if (loadFactor() >= maxLoadFactor()) grow();
+			insertNoGrow(key, val);
+			++m_size;
+		}
+
+		iterator find(const key_type& key) { return iterator(this, findIdx(key)); }
+		constIterator find(const key_type& key) const { return constIterator(this, findIdx(key)); }
+
+		size_type erase(const key_type& key)
+		{
+			size_type idx = findIdx(key);
+			if (idx >= m_capacity) return 0;
+
+			m_keys[idx].~key_type();
+			m_values[idx].~value_type();
+			m_distances[idx] = EMPTY_SLOT;
+
+			// shift the rest of the probe run back one slot
+			size_type prev = idx;
+			size_type i = (idx + 1) & m_mask;
+			while (m_distances[i] > 1)
+			{
+				new (NewPlaceholder(), &m_keys[prev]) key_type(m_keys[i]);
+				new (NewPlaceholder(), &m_values[prev]) value_type(m_values[i]);
+				m_distances[prev] = m_distances[i] - 1;
+				m_keys[i].~key_type();
+				m_values[i].~value_type();
+				m_distances[i] = EMPTY_SLOT;
+				prev = i;
+				i = (i + 1) & m_mask;
+			}
+			--m_size;
+			return 1;
+		}
+
+		iterator erase(iterator it)
+		{
+			ASSERT(it.isValid());
+			key_type key = it.key();
+			size_type idx = it.m_idx;
+			erase(key);
+			if (m_distances[idx] != EMPTY_SLOT) return iterator(this, idx);
+			return iterator(this, nextOccupied(idx));
+		}
+
+		void clear()
+		{
+			callDestructors();
+			m_allocator.deallocate(m_keys);
+			m_allocator.deallocate(m_values);
+			m_allocator.deallocate(m_distances);
+			init(s_default_ids_count);
+		}
+
+		void rehash(size_type ids_count)
+		{
+			if (m_capacity < ids_count) growTo(Math::nextPow2(ids_count));
+		}
+
+		iterator begin() { return iterator(this, nextOccupied(0)); }
+		iterator end() { return iterator(this, m_capacity); }
+
+		constIterator begin() const { return constIterator(this, nextOccupied(0)); }
+		constIterator end() const { return constIterator(this, m_capacity); }
+
+	private:
+		FlatHashMap(const my_type&);
+		void operator=(const my_type&);
+
+		void init(size_type capacity)
+		{
+			ASSERT(Math::isPowOfTwo(capacity));
+			m_keys = (key_type*)m_allocator.allocate(sizeof(key_type) * capacity);
+			m_values = (value_type*)m_allocator.allocate(sizeof(value_type) * capacity);
+			m_distances = (u8*)m_allocator.allocate(capacity);
+			setMemory(m_distances, EMPTY_SLOT, capacity);
+			m_capacity = capacity;
+			m_mask = capacity - 1;
+			m_size = 0;
+		}
+
+		size_type nextOccupied(size_type idx) const
+		{
+			while (idx < m_capacity && m_distances[idx] == EMPTY_SLOT) ++idx;
+			return idx;
+		}
+
+		size_type findIdx(const key_type& key) const
+		{
+			size_type idx = Hasher::get(key) & m_mask;
+			u8 distance = 1;
+			while (m_distances[idx] != EMPTY_SLOT)
+			{
+				if (m_distances[idx] < distance) return m_capacity;
+				if (m_distances[idx] == distance && m_keys[idx] == key) return idx;
+				idx = (idx + 1) & m_mask;
+				++distance;
+			}
+			return m_capacity;
+		}
+
+		void insertNoGrow(key_type key, value_type val)
+		{
+			size_type idx = Hasher::get(key) & m_mask;
+			u8 distance = 1;
+			for (;;)
+			{
+				if (m_distances[idx] == EMPTY_SLOT)
+				{
+					new (NewPlaceholder(), &m_keys[idx]) key_type(key);
+					new (NewPlaceholder(), &m_values[idx]) value_type(val);
+					m_distances[idx] = distance;
+					return;
+				}
+				if (m_distances[idx] < distance)
+				{
+					// rob the rich: swap with the slot that probed less far
+					key_type tmp_key = m_keys[idx];
+					value_type tmp_val = m_values[idx];
+					u8 tmp_distance = m_distances[idx];
+					m_keys[idx].~key_type();
+					m_values[idx].~value_type();
+					new (NewPlaceholder(), &m_keys[idx]) key_type(key);
+					new (NewPlaceholder(), &m_values[idx]) value_type(val);
+					m_distances[idx] = distance;
+					key = tmp_key;
+					val = tmp_val;
+					distance = tmp_distance;
+				}
+				idx = (idx + 1) & m_mask;
+				++distance;
+				ASSERT(distance != 0);
+			}
+		}
+
+		void grow() { growTo(m_capacity * 2); }
+
+		void growTo(size_type new_capacity)
+		{
+			key_type* old_keys = m_keys;
+			value_type* old_values = m_values;
+			u8* old_distances = m_distances;
+			size_type old_capacity = m_capacity;
+			size_type old_size = m_size;
+
+			init(new_capacity);
+			for (size_type i = 0; i < old_capacity; ++i)
+			{
+				if (old_distances[i] == EMPTY_SLOT) continue;
+				insertNoGrow(old_keys[i], old_values[i]);
+				old_keys[i].~key_type();
+				old_values[i].~value_type();
+			}
+			m_size = old_size;
+
+			m_allocator.deallocate(old_keys);
+			m_allocator.deallocate(old_values);
+			m_allocator.deallocate(old_distances);
+		}
+
+		void callDestructors()
+		{
+			for (size_type i = 0; i < m_capacity; ++i)
+			{
+				if (m_distances[i] == EMPTY_SLOT) continue;
+				m_keys[i].~key_type();
+				m_values[i].~value_type();
+			}
+		}
+
+	private:
+		IAllocator& m_allocator;
+		key_type* m_keys;
+		value_type* m_values;
+		u8* m_distances;
+		size_type m_capacity;
+		size_type m_mask;
+		size_type m_size;
+	};
+
+
+} // namespace Lumix
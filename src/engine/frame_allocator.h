@@ -0,0 +1,166 @@
+#pragma once
+
+
+#include "engine/iallocator.h"
+#include "engine/string.h"
+#include "engine/mt/sync.h"
+#include "engine/mt/thread.h"
+
+
+namespace Lumix
+{
+
+
+	// Bump arena for frame-temporary memory. Individual deallocations are
+	// no-ops; the whole arena is rewound once per frame from Engine::update.
+	class FrameAllocator LUMIX_FINAL : public IAllocator
+	{
+		public:
+			FrameAllocator(IAllocator& source, size_t bucket_size)
+				: m_source(source)
+				, m_bucket_size(bucket_size)
+			{
+				m_bucket = (u8*)source.allocate(bucket_size);
+				m_current = m_bucket;
+			}
+
+
+			~FrameAllocator()
+			{
+				m_source.deallocate(m_bucket);
+			}
+
+
+			void reset()
+			{
+				m_current = m_bucket;
+			}
+
+
+			void* allocate(size_t size) override
+			{
+				u8* mem = m_current;
+				ASSERT(mem + size + sizeof(size_t) <= m_bucket + m_bucket_size);
+				*(size_t*)mem = size;
+				m_current = mem + sizeof(size_t) + size;
+				return mem + sizeof(size_t);
+			}
+
+
+			void deallocate(void* ptr) override {}
+
+
+			void* reallocate(void* ptr, size_t size) override
+			{
+				if (!ptr) return allocate(size);
+
+				size_t old_size = *((size_t*)ptr - 1);
+				if (size <= old_size) return ptr;
+
+				void* new_mem = allocate(size);
+				copyMemory(new_mem, ptr, old_size);
+				return new_mem;
+			}
+
+
+			void* allocate_aligned(size_t size, size_t align) override
+			{
+				u8* mem = m_current + sizeof(size_t);
+				size_t padding = (align - ((uintptr)mem % align)) % align;
+				mem += padding;
+				ASSERT(mem + size <= m_bucket + m_bucket_size);
+				*((size_t*)mem - 1) = size;
+				m_current = mem + size;
+				return mem;
+			}
+
+
+			void deallocate_aligned(void* ptr) override {}
+
+
+			void* reallocate_aligned(void* ptr, size_t size, size_t align) override
+			{
+				if (!ptr) return allocate_aligned(size, align);
+
+				size_t old_size = *((size_t*)ptr - 1);
+				if (size <= old_size) return ptr;
+
+				void* new_mem = allocate_aligned(size, align);
+				copyMemory(new_mem, ptr, old_size);
+				return new_mem;
+			}
+
+
+		private:
+			IAllocator& m_source;
+			size_t m_bucket_size;
+			u8* m_bucket;
+			u8* m_current;
+	};
+
+
+	// Hands out one FrameAllocator per thread, keyed by thread id the same way
+	// the profiler tracks its per-thread data. Workers grab their arena through
+	// getThreadLocal() and never touch a lock after the first call.
+	class FrameAllocators
+	{
+		public:
+			enum { MAX_THREADS = 64 };
+
+			FrameAllocators(IAllocator& source, size_t bucket_size)
+				: m_source(source)
+				, m_bucket_size(bucket_size)
+				, m_mutex(false)
+				, m_count(0)
+			{
+			}
+
+
+			~FrameAllocators()
+			{
+				for (int i = 0; i < m_count; ++i)
+				{
+					LUMIX_DELETE(m_source, m_allocators[i]);
+				}
+			}
+
+
+			FrameAllocator& getThreadLocal()
+			{
+				MT::ThreadID thread_id = MT::getCurrentThreadID();
+				for (int i = 0; i < m_count; ++i)
+				{
+					if (m_thread_ids[i] == thread_id) return *m_allocators[i];
+				}
+
+				MT::SpinLock lock(m_mutex);
+				ASSERT(m_count < MAX_THREADS);
+				FrameAllocator* allocator = LUMIX_NEW(m_source, FrameAllocator)(m_source, m_bucket_size);
+				m_allocators[m_count] = allocator;
+				m_thread_ids[m_count] = thread_id;
+				++m_count;
+				return *allocator;
+			}
+
+
+			// must not race with jobs still using the arenas; call between frames
+			void resetAll()
+			{
+				for (int i = 0; i < m_count; ++i)
+				{
+					m_allocators[i]->reset();
+				}
+			}
+
+
+		private:
+			IAllocator& m_source;
+			size_t m_bucket_size;
+			MT::SpinMutex m_mutex;
+			FrameAllocator* m_allocators[MAX_THREADS];
+			MT::ThreadID m_thread_ids[MAX_THREADS];
+			volatile int m_count;
+	};
+
+
+} // namespace Lumix
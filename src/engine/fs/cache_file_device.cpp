@@ -0,0 +1,301 @@
+#include "engine/fs/cache_file_device.h"
+#include "engine/iallocator.h"
+#include "engine/fs/file_system.h"
+#include "engine/path.h"
+#include "engine/string.h"
+
+
+namespace Lumix
+{
+	namespace FS
+	{
+		class CacheFile LUMIX_FINAL : public IFile
+		{
+		public:
+			CacheFile(IFile* file, CacheFileDevice& device, IAllocator& allocator)
+				: m_device(device)
+				, m_allocator(allocator)
+				, m_file(file)
+				, m_data(nullptr)
+				, m_size(0)
+				, m_pos(0)
+				, m_path_hash(0)
+				, m_own_data(false)
+				, m_in_cache(false)
+			{
+			}
+
+
+			~CacheFile()
+			{
+				if (m_file) m_file->release();
+				if (m_own_data) m_allocator.deallocate(m_data);
+			}
+
+
+			IFileDevice& getDevice() override
+			{
+				return m_device;
+			}
+
+
+			bool open(const Path& path, Mode mode) override
+			{
+				ASSERT(!m_data); // reopen is not supported currently
+
+				m_path_hash = path.getHash();
+				if (mode & (Mode::WRITE | Mode::CREATE))
+				{
+					m_device.invalidate(m_path_hash);
+					return m_file && m_file->open(path, mode);
+				}
+
+				size_t size;
+				const u8* cached = m_device.acquire(m_path_hash, size);
+				if (cached)
+				{
+					m_data = (u8*)cached;
+					m_size = size;
+					m_pos = 0;
+					m_in_cache = true;
+					return true;
+				}
+
+				if (!m_file || !m_file->open(path, mode)) return false;
+
+				// a mapped inner file is already served from memory, caching
+				// it would only duplicate the pages
+				if (m_file->getBuffer()) return true;
+
+				m_size = m_file->size();
+				m_data = (u8*)m_allocator.allocate(m_size);
+				if (!m_file->read(m_data, m_size))
+				{
+					m_allocator.deallocate(m_data);
+					m_data = nullptr;
+					m_file->close();
+					return false;
+				}
+				m_pos = 0;
+				// the cache takes ownership of the buffer, the last reader or
+				// the eviction frees it; if it declines the file keeps it
+				m_in_cache = m_device.add(m_path_hash, m_data, m_size);
+				m_own_data = !m_in_cache;
+				return true;
+			}
+
+
+			void close() override
+			{
+				if (m_in_cache)
+				{
+					m_device.release(m_path_hash);
+					m_in_cache = false;
+				}
+				else if (m_own_data)
+				{
+					m_allocator.deallocate(m_data);
+					m_own_data = false;
+				}
+				m_data = nullptr;
+				m_size = m_pos = 0;
+				if (m_file) m_file->close();
+			}
+
+
+			bool read(void* buffer, size_t size) override
+			{
+				if (m_data)
+				{
+					size_t amount = m_pos + size < m_size ? size : m_size - m_pos;
+					if (amount != size) return false;
+					copyMemory(buffer, m_data + m_pos, (int)amount);
+					m_pos += amount;
+					return true;
+				}
+				return m_file && m_file->read(buffer, size);
+			}
+
+
+			bool write(const void* buffer, size_t size) override
+			{
+				ASSERT(!m_data); // cached files are read only
+				return m_file && m_file->write(buffer, size);
+			}
+
+
+			const void* getBuffer() const override
+			{
+				if (m_data) return m_data;
+				return m_file ? m_file->getBuffer() : nullptr;
+			}
+
+
+			size_t size() override
+			{
+				if (m_data) return m_size;
+				return m_file ? m_file->size() : 0;
+			}
+
+
+			bool seek(SeekMode base, size_t pos) override
+			{
+				if (m_data)
+				{
+					switch (base)
+					{
+						case SeekMode::BEGIN: m_pos = pos; break;
+						case SeekMode::END: m_pos = m_size - pos; break;
+						case SeekMode::CURRENT: m_pos += pos; break;
+					}
+					return m_pos <= m_size;
+				}
+				return m_file && m_file->seek(base, pos);
+			}
+
+
+			size_t pos() override
+			{
+				if (m_data) return m_pos;
+				return m_file ? m_file->pos() : 0;
+			}
+
+		private:
+			CacheFileDevice& m_device;
+			IAllocator& m_allocator;
+			IFile* m_file;
+			u8* m_data;
+			size_t m_size;
+			size_t m_pos;
+			u32 m_path_hash;
+			bool m_own_data;
+			bool m_in_cache;
+		};
+
+
+		CacheFileDevice::CacheFileDevice(IAllocator& allocator, size_t budget)
+			: m_allocator(allocator)
+			, m_entries(allocator)
+			, m_mutex(false)
+			, m_budget(budget)
+			, m_total_size(0)
+			, m_lru_counter(0)
+		{
+		}
+
+
+		CacheFileDevice::~CacheFileDevice()
+		{
+			for (auto iter = m_entries.begin(), end = m_entries.end(); iter != end; ++iter)
+			{
+				ASSERT(iter.value().refs == 0);
+				m_allocator.deallocate(iter.value().data);
+			}
+		}
+
+
+		const u8* CacheFileDevice::acquire(u32 path_hash, size_t& size)
+		{
+			MT::SpinLock lock(m_mutex);
+			auto iter = m_entries.find(path_hash);
+			if (!iter.isValid() || iter.value().stale) return nullptr;
+
+			CacheEntry& entry = iter.value();
+			++entry.refs;
+			entry.last_used = ++m_lru_counter;
+			size = entry.size;
+			return entry.data;
+		}
+
+
+		bool CacheFileDevice::add(u32 path_hash, u8* data, size_t size)
+		{
+			MT::SpinLock lock(m_mutex);
+			if (size > m_budget) return false;
+			if (m_entries.find(path_hash).isValid()) return false;
+
+			while (m_total_size + size > m_budget)
+			{
+				if (!evictOne()) return false;
+			}
+
+			CacheEntry entry;
+			entry.data = data;
+			entry.size = size;
+			entry.last_used = ++m_lru_counter;
+			entry.refs = 1;
+			entry.stale = false;
+			m_entries.insert(path_hash, entry);
+			m_total_size += size;
+			return true;
+		}
+
+
+		void CacheFileDevice::release(u32 path_hash)
+		{
+			MT::SpinLock lock(m_mutex);
+			auto iter = m_entries.find(path_hash);
+			ASSERT(iter.isValid());
+			CacheEntry& entry = iter.value();
+			ASSERT(entry.refs > 0);
+			--entry.refs;
+			if (entry.refs == 0 && entry.stale)
+			{
+				m_allocator.deallocate(entry.data);
+				m_total_size -= entry.size;
+				m_entries.erase(path_hash);
+			}
+		}
+
+
+		void CacheFileDevice::invalidate(u32 path_hash)
+		{
+			MT::SpinLock lock(m_mutex);
+			auto iter = m_entries.find(path_hash);
+			if (!iter.isValid()) return;
+
+			CacheEntry& entry = iter.value();
+			if (entry.refs > 0)
+			{
+				// still being read from, the last reader frees it
+				entry.stale = true;
+				return;
+			}
+			m_allocator.deallocate(entry.data);
+			m_total_size -= entry.size;
+			m_entries.erase(path_hash);
+		}
+
+
+		bool CacheFileDevice::evictOne()
+		{
+			auto victim = m_entries.end();
+			for (auto iter = m_entries.begin(), end = m_entries.end(); iter != end; ++iter)
+			{
+				if (iter.value().refs > 0) continue;
+				if (!victim.isValid() || iter.value().last_used < victim.value().last_used)
+				{
+					victim = iter;
+				}
+			}
+			if (!victim.isValid()) return false;
+
+			m_allocator.deallocate(victim.value().data);
+			m_total_size -= victim.value().size;
+			m_entries.erase(victim);
+			return true;
+		}
+
+
+		void CacheFileDevice::destroyFile(IFile* file)
+		{
+			LUMIX_DELETE(m_allocator, file);
+		}
+
+
+		IFile* CacheFileDevice::createFile(IFile* child)
+		{
+			return LUMIX_NEW(m_allocator, CacheFile)(child, *this, m_allocator);
+		}
+	} // namespace FS
+} // namespace Lumix
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "engine/lumix.h"
+#include "engine/fs/ifile_device.h"
+#include "engine/flat_hash_map.h"
+#include "engine/mt/sync.h"
+
+namespace Lumix
+{
+	class IAllocator;
+
+	namespace FS
+	{
+		// Read cache stacked above slower devices ("cache:disk"). Whole files
+		// are kept in RAM keyed by path hash, so hot small files (shader
+		// includes, materials, JSON) are served without touching the device
+		// below on repeated opens. Entries are evicted least recently used
+		// first when the memory budget is exceeded; write opens invalidate
+		// the cached copy.
+		class LUMIX_ENGINE_API CacheFileDevice LUMIX_FINAL : public IFileDevice
+		{
+			friend class CacheFile;
+		public:
+			CacheFileDevice(IAllocator& allocator, size_t budget = 16 * 1024 * 1024);
+			~CacheFileDevice();
+
+			void destroyFile(IFile* file) override;
+			IFile* createFile(IFile* child) override;
+			const char* name() const override { return "cache"; }
+
+			size_t getCachedSize() const { return m_total_size; }
+
+		private:
+			struct CacheEntry
+			{
+				u8* data;
+				size_t size;
+				u32 last_used;
+				i32 refs;
+				bool stale;
+			};
+
+			const u8* acquire(u32 path_hash, size_t& size);
+			bool add(u32 path_hash, u8* data, size_t size);
+			void release(u32 path_hash);
+			void invalidate(u32 path_hash);
+			bool evictOne();
+
+			IAllocator& m_allocator;
+			FlatHashMap<u32, CacheEntry> m_entries;
+			MT::SpinMutex m_mutex;
+			size_t m_budget;
+			size_t m_total_size;
+			u32 m_lru_counter;
+		};
+	} // namespace FS
+} // namespace Lumix
@@ -26,7 +26,8 @@ enum TransFlags
 	E_SUCCESS = 0x1,
 	E_IS_OPEN = E_SUCCESS << 1,
 	E_FAIL = E_IS_OPEN << 1,
-	E_CANCELED = E_FAIL << 1
+	E_CANCELED = E_FAIL << 1,
+	E_IS_WRITE = E_CANCELED << 1
 };
 
 struct AsyncItem
@@ -37,13 +38,19 @@ struct AsyncItem
 	u32 m_id;
 	char m_path[MAX_PATH_LENGTH];
 	u8 m_flags;
+	const u8* m_data;
+	size_t m_data_size;
 };
 
-static const i32 C_MAX_TRANS = 16;
+static const i32 C_MAX_TRANS = 64;
+// IO threads spend their time blocked in the OS, so a few of them keep many
+// reads in flight even on low core counts; completions are picked up in
+// whatever order the disk delivers them
+static const i32 C_TASKS_COUNT = 4;
 
 typedef MT::Transaction<AsyncItem> AsynTrans;
 typedef MT::LockFreeFixedQueue<AsynTrans, C_MAX_TRANS> TransQueue;
-typedef Queue<AsynTrans*, C_MAX_TRANS> InProgressQueue;
+typedef Array<AsynTrans*> InProgressQueue;
 typedef Array<AsyncItem> ItemsTable;
 typedef Array<IFileDevice*> DevicesTable;
 
@@ -98,6 +105,18 @@ public:
 				tr->data.m_flags |=
 					tr->data.m_file->open(Path(tr->data.m_path), tr->data.m_mode) ? E_SUCCESS : E_FAIL;
 			}
+			else if ((tr->data.m_flags & E_IS_WRITE) == E_IS_WRITE)
+			{
+				IFile* file = tr->data.m_file;
+				bool success = file->open(Path(tr->data.m_path), tr->data.m_mode);
+				if (success)
+				{
+					success = file->write(tr->data.m_data, tr->data.m_data_size);
+					// closing here flushes to the OS before the callback fires
+					file->close();
+				}
+				tr->data.m_flags |= success ? E_SUCCESS : E_FAIL;
+			}
 			else if ((tr->data.m_flags & E_CLOSE) == E_CLOSE)
 			{
 				tr->data.m_file->close();
@@ -123,7 +142,7 @@ class FileSystemImpl LUMIX_FINAL : public FileSystem
 {
 public:
 	explicit FileSystemImpl(IAllocator& allocator)
-		: m_allocator(allocator)
+		: m_allocator("file_system", allocator)
 		, m_pending(m_allocator)
 		, m_devices(m_allocator)
 		, m_in_progress(m_allocator)
@@ -134,26 +153,44 @@ public:
 		m_default_device.m_devices[0] = nullptr;
 		m_save_game_device.m_devices[0] = nullptr;
 		#if !LUMIX_SINGLE_THREAD()
-			m_task = LUMIX_NEW(m_allocator, FSTask)(&m_transaction_queue, m_allocator);
-			m_task->create("FSTask");
+			for (i32 i = 0; i < C_TASKS_COUNT; ++i)
+			{
+				m_tasks[i] = LUMIX_NEW(m_allocator, FSTask)(&m_transaction_queue, m_allocator);
+				m_tasks[i]->create(StaticString<16>("FSTask", i));
+			}
 		#endif
 	}
 
 	~FileSystemImpl()
 	{
 		#if !LUMIX_SINGLE_THREAD()
-			m_task->stop();
-			m_task->destroy();
-			LUMIX_DELETE(m_allocator, m_task);
+			// each stop() signals the queue once, so every sleeping task wakes
+			for (FSTask* task : m_tasks) task->stop();
+			for (FSTask* task : m_tasks)
+			{
+				task->destroy();
+				LUMIX_DELETE(m_allocator, task);
+			}
 		#endif
-		while (!m_in_progress.empty())
+		for (AsynTrans* trans : m_in_progress)
 		{
-			auto* trans = m_in_progress.front();
-			m_in_progress.pop();
-			if (trans->data.m_file) close(*trans->data.m_file);
+			if (trans->data.m_data) m_allocator.deallocate((void*)trans->data.m_data);
+			if (!trans->data.m_file) continue;
+
+			if ((trans->data.m_flags & E_IS_WRITE) != 0)
+			{
+				// write transactions close their file on the IO thread
+				trans->data.m_file->release();
+			}
+			else
+			{
+				close(*trans->data.m_file);
+			}
 		}
+		m_in_progress.clear();
 		for (auto& i : m_pending)
 		{
+			if (i.m_data) m_allocator.deallocate((void*)i.m_data);
 			close(*i.m_file);
 		}
 	}
@@ -164,6 +201,9 @@ public:
 	bool hasWork() const override { return !m_in_progress.empty() || !m_pending.empty(); }
 
 
+	int getPendingAsyncCount() const override { return m_in_progress.size() + m_pending.size(); }
+
+
 	bool mount(IFileDevice* device) override
 	{
 		for (int i = 0; i < m_devices.size(); i++)
@@ -255,6 +295,8 @@ public:
 			item.m_mode = mode;
 			copyString(item.m_path, file.c_str());
 			item.m_flags = E_IS_OPEN;
+			item.m_data = nullptr;
+			item.m_data_size = 0;
 			item.m_id = m_last_id;
 			++m_last_id;
 			if (m_last_id == INVALID_ASYNC) m_last_id = 0;
@@ -278,11 +320,11 @@ public:
 			}
 		}
 
-		for (auto iter = m_in_progress.begin(), end = m_in_progress.end(); iter != end; ++iter)
+		for (AsynTrans* trans : m_in_progress)
 		{
-			if (iter.value()->data.m_id == id)
+			if (trans->data.m_id == id)
 			{
-				iter.value()->data.m_flags |= E_CANCELED;
+				trans->data.m_flags |= E_CANCELED;
 				return;
 			}
 		}
@@ -290,6 +332,16 @@ public:
 	}
 
 
+	bool isInProgress(IFile* file) const
+	{
+		for (const AsynTrans* trans : m_in_progress)
+		{
+			if (trans->data.m_file == file) return true;
+		}
+		return false;
+	}
+
+
 	void setDefaultDevice(const char* dev) override { fillDeviceList(dev, m_default_device); }
 
 
@@ -333,6 +385,35 @@ public:
 	}
 
 
+	u32 writeAsync(const DeviceList& device_list,
+		const Path& file,
+		const void* data,
+		size_t size,
+		const ReadCallback& call_back) override
+	{
+		IFile* prev = createFile(device_list);
+		if (!prev) return INVALID_ASYNC;
+
+		// the caller's buffer is copied so it can be reused immediately
+		u8* copy = (u8*)m_allocator.allocate(size);
+		copyMemory(copy, data, (int)size);
+
+		AsyncItem& item = m_pending.emplace();
+
+		item.m_file = prev;
+		item.m_cb = call_back;
+		item.m_mode = Mode::CREATE_AND_WRITE;
+		copyString(item.m_path, file.c_str());
+		item.m_flags = E_IS_WRITE;
+		item.m_data = copy;
+		item.m_data_size = size;
+		item.m_id = m_last_id;
+		++m_last_id;
+		if (m_last_id == INVALID_ASYNC) m_last_id = 0;
+		return item.m_id;
+	}
+
+
 	void closeAsync(IFile& file) override
 	{
 		AsyncItem& item = m_pending.emplace();
@@ -341,51 +422,76 @@ public:
 		item.m_cb.bind<closeAsync>();
 		item.m_mode = 0;
 		item.m_flags = E_CLOSE;
+		item.m_data = nullptr;
+		item.m_data_size = 0;
 	}
 
 
 	void updateAsyncTransactions() override
 	{
 		PROFILE_FUNCTION();
-		while (!m_in_progress.empty())
+		// transactions complete in whatever order the IO threads finish them
+		for (int i = 0; i < m_in_progress.size();)
 		{
-			AsynTrans* tr = m_in_progress.front();
-			if (!tr->isCompleted()) break;
+			AsynTrans* tr = m_in_progress[i];
+			if (!tr->isCompleted())
+			{
+				++i;
+				continue;
+			}
 
 			PROFILE_BLOCK("processAsyncTransaction");
-			m_in_progress.pop();
+			m_in_progress.erase(i);
 
+			if (tr->data.m_data) m_allocator.deallocate((void*)tr->data.m_data);
 			if ((tr->data.m_flags & E_CANCELED) == 0)
 			{
 				tr->data.m_cb.invoke(*tr->data.m_file, !!(tr->data.m_flags & E_SUCCESS));
 			}
 			if ((tr->data.m_flags & (E_SUCCESS | E_FAIL)) != 0)
 			{
-				closeAsync(*tr->data.m_file);
+				if ((tr->data.m_flags & E_IS_WRITE) != 0)
+				{
+					// write transactions close their file on the IO thread
+					tr->data.m_file->release();
+				}
+				else
+				{
+					closeAsync(*tr->data.m_file);
+				}
 			}
 			m_transaction_queue.dealoc(tr);
 		}
 
 		i32 can_add = C_MAX_TRANS - m_in_progress.size();
-		while (can_add && !m_pending.empty())
+		for (int i = 0; can_add > 0 && i < m_pending.size();)
 		{
-			AsynTrans* tr = m_transaction_queue.alloc(false);
-			if (tr)
+			AsyncItem& item = m_pending[i];
+			// operations on one file must not run concurrently; a close racing
+			// its open on another IO thread would use a half-opened file
+			if (isInProgress(item.m_file))
 			{
-				AsyncItem& item = m_pending[0];
-				tr->data.m_file = item.m_file;
-				tr->data.m_cb = item.m_cb;
-				tr->data.m_id = item.m_id;
-				tr->data.m_mode = item.m_mode;
-				copyString(tr->data.m_path, sizeof(tr->data.m_path), item.m_path);
-				tr->data.m_flags = item.m_flags;
-				tr->reset();
-
-				m_transaction_queue.push(tr, true);
-				m_in_progress.push(tr);
-				m_pending.erase(0);
+				++i;
+				continue;
 			}
-			can_add--;
+
+			AsynTrans* tr = m_transaction_queue.alloc(false);
+			if (!tr) break;
+
+			tr->data.m_file = item.m_file;
+			tr->data.m_cb = item.m_cb;
+			tr->data.m_id = item.m_id;
+			tr->data.m_mode = item.m_mode;
+			copyString(tr->data.m_path, sizeof(tr->data.m_path), item.m_path);
+			tr->data.m_flags = item.m_flags;
+			tr->data.m_data = item.m_data;
+			tr->data.m_data_size = item.m_data_size;
+			tr->reset();
+
+			m_transaction_queue.push(tr, true);
+			m_in_progress.push(tr);
+			m_pending.erase(i);
+			--can_add;
 		}
 
 		#if LUMIX_SINGLE_THREAD()
@@ -397,6 +503,17 @@ public:
 					tr->data.m_flags |=
 						tr->data.m_file->open(Path(tr->data.m_path), tr->data.m_mode) ? E_SUCCESS : E_FAIL;
 				}
+				else if ((tr->data.m_flags & E_IS_WRITE) == E_IS_WRITE)
+				{
+					IFile* file = tr->data.m_file;
+					bool success = file->open(Path(tr->data.m_path), tr->data.m_mode);
+					if (success)
+					{
+						success = file->write(tr->data.m_data, tr->data.m_data_size);
+						file->close();
+					}
+					tr->data.m_flags |= success ? E_SUCCESS : E_FAIL;
+				}
 				else if ((tr->data.m_flags & E_CLOSE) == E_CLOSE)
 				{
 					tr->data.m_file->close();
@@ -427,7 +544,7 @@ public:
 private:
 	BaseProxyAllocator m_allocator;
 	#if !LUMIX_SINGLE_THREAD()
-		FSTask* m_task;
+		FSTask* m_tasks[C_TASKS_COUNT];
 	#endif
 	DevicesTable m_devices;
 
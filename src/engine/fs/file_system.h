@@ -111,6 +111,14 @@ public:
 						   const Path& file,
 						   int mode,
 						   const ReadCallback& call_back) = 0;
+	// write-behind: copies the data, opens, writes and closes the file on an
+	// IO thread and invokes the callback from updateAsyncTransactions; by the
+	// time it fires the data has been handed to the OS
+	virtual u32 writeAsync(const DeviceList& device_list,
+						   const Path& file,
+						   const void* data,
+						   size_t size,
+						   const ReadCallback& call_back) = 0;
 	virtual void cancelAsync(u32 id) = 0;
 
 	virtual void close(IFile& file) = 0;
@@ -128,6 +136,8 @@ public:
 	virtual void setDefaultDevice(const char* dev) = 0;
 	virtual void setSaveGameDevice(const char* dev) = 0;
 	virtual bool hasWork() const = 0;
+	// async reads queued or in flight; the profiler samples this every frame
+	virtual int getPendingAsyncCount() const = 0;
 };
 
 
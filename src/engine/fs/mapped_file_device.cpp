@@ -0,0 +1,257 @@
+#include "engine/fs/mapped_file_device.h"
+#include "engine/iallocator.h"
+#include "engine/fs/file_system.h"
+#include "engine/fs/os_file.h"
+#include "engine/path.h"
+#include "engine/path_utils.h"
+#include "engine/string.h"
+
+#ifdef _WIN32
+	#include "engine/win/simple_win.h"
+#elif defined __linux__
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+namespace Lumix
+{
+	namespace FS
+	{
+		struct FileMapping
+		{
+			const u8* data = nullptr;
+			size_t size = 0;
+			#ifdef _WIN32
+				HANDLE file = nullptr;
+				HANDLE mapping = nullptr;
+			#endif
+		};
+
+
+		#ifdef _WIN32
+			static bool mapFile(const char* path, FileMapping& map)
+			{
+				map.file = ::CreateFile(
+					path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (map.file == INVALID_HANDLE_VALUE)
+				{
+					map.file = nullptr;
+					return false;
+				}
+				map.size = ::GetFileSize(map.file, nullptr);
+				map.mapping = ::CreateFileMapping(map.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (!map.mapping)
+				{
+					::CloseHandle(map.file);
+					map.file = nullptr;
+					return false;
+				}
+				map.data = (const u8*)::MapViewOfFile(map.mapping, FILE_MAP_READ, 0, 0, 0);
+				if (!map.data)
+				{
+					::CloseHandle(map.mapping);
+					::CloseHandle(map.file);
+					map.mapping = nullptr;
+					map.file = nullptr;
+					return false;
+				}
+				return true;
+			}
+
+
+			static void unmapFile(FileMapping& map)
+			{
+				if (map.data) ::UnmapViewOfFile(map.data);
+				if (map.mapping) ::CloseHandle(map.mapping);
+				if (map.file) ::CloseHandle(map.file);
+				map = FileMapping();
+			}
+		#elif defined __linux__
+			static bool mapFile(const char* path, FileMapping& map)
+			{
+				int fd = ::open(path, O_RDONLY);
+				if (fd < 0) return false;
+
+				struct stat st;
+				if (::fstat(fd, &st) != 0 || st.st_size == 0)
+				{
+					::close(fd);
+					return false;
+				}
+
+				void* data = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				// the mapping keeps its own reference to the file
+				::close(fd);
+				if (data == MAP_FAILED) return false;
+
+				map.data = (const u8*)data;
+				map.size = (size_t)st.st_size;
+				return true;
+			}
+
+
+			static void unmapFile(FileMapping& map)
+			{
+				if (map.data) ::munmap((void*)map.data, map.size);
+				map = FileMapping();
+			}
+		#else
+			static bool mapFile(const char* path, FileMapping& map) { return false; }
+			static void unmapFile(FileMapping& map) { map = FileMapping(); }
+		#endif
+
+
+		struct MappedFile LUMIX_FINAL : public IFile
+		{
+			MappedFile(IFile* fallthrough, MappedFileDevice& device, IAllocator& allocator)
+				: m_device(device)
+				, m_allocator(allocator)
+				, m_fallthrough(fallthrough)
+				, m_pos(0)
+			{
+				m_use_fallthrough = false;
+				m_use_file = false;
+			}
+
+
+			~MappedFile()
+			{
+				if (m_fallthrough) m_fallthrough->release();
+			}
+
+
+			IFileDevice& getDevice() override
+			{
+				return m_device;
+			}
+
+			bool open(const Path& path, Mode mode) override
+			{
+				char tmp[MAX_PATH_LENGTH];
+				if (path.length() > 1 && path.c_str()[1] == ':')
+				{
+					copyString(tmp, path.c_str());
+				}
+				else
+				{
+					copyString(tmp, m_device.getBasePath());
+					catString(tmp, path.c_str());
+				}
+				bool want_read = (mode & Mode::READ) != 0;
+				if (want_read && !OsFile::fileExists(tmp) && m_fallthrough)
+				{
+					m_use_fallthrough = true;
+					return m_fallthrough->open(path, mode);
+				}
+				bool read_only = want_read && (mode & (Mode::WRITE | Mode::CREATE)) == 0;
+				if (read_only && mapFile(tmp, m_mapping))
+				{
+					m_pos = 0;
+					return true;
+				}
+				// writes and files that cannot be mapped use plain IO
+				m_use_file = true;
+				return m_file.open(tmp, mode, m_allocator);
+			}
+
+			void close() override
+			{
+				if (m_fallthrough) m_fallthrough->close();
+				if (m_use_file) m_file.close();
+				unmapFile(m_mapping);
+				m_pos = 0;
+				m_use_fallthrough = false;
+				m_use_file = false;
+			}
+
+			bool read(void* buffer, size_t size) override
+			{
+				if (m_use_fallthrough) return m_fallthrough->read(buffer, size);
+				if (m_use_file) return m_file.read(buffer, size);
+				if (m_pos + size > m_mapping.size) return false;
+				copyMemory(buffer, m_mapping.data + m_pos, (int)size);
+				m_pos += size;
+				return true;
+			}
+
+			bool write(const void* buffer, size_t size) override
+			{
+				if (m_use_fallthrough) return m_fallthrough->write(buffer, size);
+				if (m_use_file) return m_file.write(buffer, size);
+				ASSERT(false); // mapped files are read-only
+				return false;
+			}
+
+			const void* getBuffer() const override
+			{
+				if (m_use_fallthrough) return m_fallthrough->getBuffer();
+				if (m_use_file) return nullptr;
+				return m_mapping.data;
+			}
+
+			size_t size() override
+			{
+				if (m_use_fallthrough) return m_fallthrough->size();
+				if (m_use_file) return m_file.size();
+				return m_mapping.size;
+			}
+
+			bool seek(SeekMode base, size_t pos) override
+			{
+				if (m_use_fallthrough) return m_fallthrough->seek(base, pos);
+				if (m_use_file) return m_file.seek(base, pos);
+				switch (base)
+				{
+					case SeekMode::BEGIN: m_pos = pos; break;
+					case SeekMode::END: m_pos = m_mapping.size - pos; break;
+					case SeekMode::CURRENT: m_pos += pos; break;
+				}
+				return m_pos <= m_mapping.size;
+			}
+
+			size_t pos() override
+			{
+				if (m_use_fallthrough) return m_fallthrough->pos();
+				if (m_use_file) return m_file.pos();
+				return m_pos;
+			}
+
+			MappedFileDevice& m_device;
+			IAllocator& m_allocator;
+			FileMapping m_mapping;
+			OsFile m_file;
+			size_t m_pos;
+			IFile* m_fallthrough;
+			bool m_use_fallthrough;
+			bool m_use_file;
+		};
+
+
+		MappedFileDevice::MappedFileDevice(const char* name, const char* base_path, IAllocator& allocator)
+			: m_allocator(allocator)
+		{
+			copyString(m_name, name);
+			PathUtils::normalize(base_path, m_base_path, Lumix::lengthOf(m_base_path));
+			if (m_base_path[0] != '\0') catString(m_base_path, "/");
+		}
+
+		void MappedFileDevice::setBasePath(const char* path)
+		{
+			PathUtils::normalize(path, m_base_path, Lumix::lengthOf(m_base_path));
+			if (m_base_path[0] != '\0') catString(m_base_path, "/");
+		}
+
+		void MappedFileDevice::destroyFile(IFile* file)
+		{
+			LUMIX_DELETE(m_allocator, file);
+		}
+
+		IFile* MappedFileDevice::createFile(IFile* fallthrough)
+		{
+			return LUMIX_NEW(m_allocator, MappedFile)(fallthrough, *this, m_allocator);
+		}
+	} // namespace FS
+} // ~namespace Lumix
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "engine/lumix.h"
+#include "engine/fs/ifile_device.h"
+
+namespace Lumix
+{
+	class IAllocator;
+
+	namespace FS
+	{
+		class IFile;
+
+		// Serves read-only files straight from the OS page cache (mmap /
+		// MapViewOfFile), so getBuffer() is a zero-copy pointer into the
+		// mapping and resource loaders skip the intermediate read. Writes
+		// and platforms without mapping fall back to plain file IO.
+		class LUMIX_ENGINE_API MappedFileDevice LUMIX_FINAL : public IFileDevice
+		{
+		public:
+			MappedFileDevice(const char* name, const char* base_path, IAllocator& allocator);
+
+			IFile* createFile(IFile* child) override;
+			void destroyFile(IFile* file) override;
+			const char* getBasePath() const { return m_base_path; }
+			void setBasePath(const char* path);
+			const char* name() const override { return m_name; }
+
+		private:
+			IAllocator& m_allocator;
+			char m_base_path[MAX_PATH_LENGTH];
+			char m_name[20];
+		};
+	} // ~namespace FS
+} // ~namespace Lumix
@@ -18,19 +18,20 @@ namespace Lumix
 				, m_size(0)
 				, m_capacity(0)
 				, m_pos(0)
-				, m_file(file) 
+				, m_file(file)
 				, m_write(false)
+				, m_own_buffer(true)
 				, m_allocator(allocator)
 			{
 			}
 
-			~MemoryFile() 
-			{ 
+			~MemoryFile()
+			{
 				if (m_file)
 				{
 					m_file->release();
 				}
-				m_allocator.deallocate(m_buffer);
+				if (m_own_buffer) m_allocator.deallocate(m_buffer);
 			}
 
 
@@ -51,8 +52,18 @@ namespace Lumix
 						if(mode & Mode::READ)
 						{
 							m_capacity = m_size = m_file->size();
-							m_buffer = (u8*)m_allocator.allocate(sizeof(u8) * m_size);
-							m_file->read(m_buffer, m_size);
+							const void* mapped = (mode & Mode::WRITE) == 0 ? m_file->getBuffer() : nullptr;
+							if(mapped)
+							{
+								// the inner file is memory mapped, no need to copy it
+								m_buffer = (u8*)mapped;
+								m_own_buffer = false;
+							}
+							else
+							{
+								m_buffer = (u8*)m_allocator.allocate(sizeof(u8) * m_size);
+								m_file->read(m_buffer, m_size);
+							}
 							m_pos = 0;
 						}
 
@@ -82,8 +93,9 @@ namespace Lumix
 					m_file->close();
 				}
 
-				m_allocator.deallocate(m_buffer);
+				if (m_own_buffer) m_allocator.deallocate(m_buffer);
 				m_buffer = nullptr;
+				m_own_buffer = true;
 			}
 
 			bool read(void* buffer, size_t size) override
@@ -99,14 +111,15 @@ namespace Lumix
 				size_t pos = m_pos;
 				size_t cap = m_capacity;
 				size_t sz = m_size;
-				if(pos + size > cap)
+				if(pos + size > cap || !m_own_buffer)
 				{
 					size_t new_cap = Math::maximum(cap * 2, pos + size);
 					u8* new_data = (u8*)m_allocator.allocate(sizeof(u8) * new_cap);
 					copyMemory(new_data, m_buffer, (int)sz);
-					m_allocator.deallocate(m_buffer);
+					if (m_own_buffer) m_allocator.deallocate(m_buffer);
 					m_buffer = new_data;
 					m_capacity = new_cap;
+					m_own_buffer = true;
 				}
 
 				copyMemory(m_buffer + pos, buffer, (int)size);
@@ -166,6 +179,7 @@ namespace Lumix
 			size_t m_pos;
 			IFile* m_file;
 			bool m_write;
+			bool m_own_buffer;
 		};
 
 		void MemoryFileDevice::destroyFile(IFile* file)
@@ -1,4 +1,5 @@
 #include "engine/fs/file_system.h"
+#include "engine/fs/os_file.h"
 #include "engine/iallocator.h"
 #include "engine/path.h"
 #include "engine/string.h"
@@ -26,45 +27,47 @@ public:
 	{
 		auto iter = m_device.m_files.find(path.getHash());
 		if (iter == m_device.m_files.end()) return false;
-		m_file = iter.value();
+		m_info = iter.value();
 		m_local_offset = 0;
-		return m_device.m_file.seek(SeekMode::BEGIN, (size_t)m_file.offset);
+		// every handle owns its own OS file, so concurrent async reads from
+		// the pack do not serialize on one shared seek position
+		if (!m_file.open(m_device.m_pack_path, Mode::OPEN_AND_READ, m_allocator)) return false;
+		return m_file.seek(SeekMode::BEGIN, (size_t)m_info.offset);
 	}
 
 
 	bool read(void* buffer, size_t size) override
 	{
-		if (m_device.m_offset != m_file.offset + m_local_offset)
-		{
-			if (!m_device.m_file.seek(FS::SeekMode::BEGIN, size_t(m_file.offset + m_local_offset)))
-			{
-				return false;
-			}
-		}
+		if (m_local_offset + size > m_info.size) return false;
 		m_local_offset += size;
-		return m_device.m_file.read(buffer, size);
+		return m_file.read(buffer, size);
 	}
 
 
 	bool seek(SeekMode base, size_t pos) override
 	{
 		m_local_offset = pos;
-		return m_device.m_file.seek(SeekMode::BEGIN, size_t(m_file.offset + pos));
+		return m_file.seek(SeekMode::BEGIN, size_t(m_info.offset + pos));
 	}
 
 
 	IFileDevice& getDevice() override { return m_device; }
-	void close() override { m_local_offset = 0; }
+	void close() override
+	{
+		m_file.close();
+		m_local_offset = 0;
+	}
 	bool write(const void* buffer, size_t size) override { ASSERT(false); return false; }
 	const void* getBuffer() const override { return nullptr; }
-	size_t size() override { return (size_t)m_file.size; }
+	size_t size() override { return (size_t)m_info.size; }
 	size_t pos() override { return m_local_offset; }
 
 private:
 	virtual ~PackFile() {}
 
-	PackFileDevice::PackFileInfo m_file;
+	PackFileDevice::PackFileInfo m_info;
 	PackFileDevice& m_device;
+	OsFile m_file;
 	size_t m_local_offset;
 	IAllocator& m_allocator;
 }; // class PackFile
@@ -74,31 +77,51 @@ PackFileDevice::PackFileDevice(IAllocator& allocator)
 	: m_allocator(allocator)
 	, m_files(allocator)
 {
+	m_pack_path[0] = '\0';
 }
 
 
 PackFileDevice::~PackFileDevice()
 {
-	m_file.close();
 }
 
 
 bool PackFileDevice::mount(const char* path)
 {
-	m_file.close();
-	if(!m_file.open(path, Mode::OPEN_AND_READ, m_allocator)) return false;
+	OsFile file;
+	if(!file.open(path, Mode::OPEN_AND_READ, m_allocator)) return false;
+	copyString(m_pack_path, path);
+
+	u32 magic;
+	file.read(&magic, sizeof(magic));
 
 	i32 count;
-	m_file.read(&count, sizeof(count));
+	if (magic == PACK_MAGIC)
+	{
+		u32 version;
+		file.read(&version, sizeof(version));
+		if (version != PACK_VERSION)
+		{
+			file.close();
+			return false;
+		}
+		file.read(&count, sizeof(count));
+	}
+	else
+	{
+		// v1 pack, the first dword is the entry count
+		count = (i32)magic;
+	}
+
 	for(int i = 0; i < count; ++i)
 	{
 		u32 hash;
-		m_file.read(&hash, sizeof(hash));
+		file.read(&hash, sizeof(hash));
 		PackFileInfo info;
-		m_file.read(&info, sizeof(info));
+		file.read(&info, sizeof(info));
 		m_files.insert(hash, info);
 	}
-	m_offset = m_file.pos();
+	file.close();
 	return true;
 }
 
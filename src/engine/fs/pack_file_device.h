@@ -1,8 +1,7 @@
 #pragma once
 
 #include "engine/fs/ifile_device.h"
-#include "engine/fs/os_file.h"
-#include "engine/hash_map.h"
+#include "engine/flat_hash_map.h"
 #include "engine/lumix.h"
 
 
@@ -19,6 +18,12 @@ class LUMIX_ENGINE_API PackFileDevice LUMIX_FINAL : public IFileDevice
 {
 	friend class PackFile;
 public:
+	// v2 packs start with this magic; v1 packs start with the entry count
+	static const u32 PACK_MAGIC = 0x4b50584c; // "LXPK"
+	static const u32 PACK_VERSION = 2;
+	// v2 entries are aligned so every read starts on a disk-friendly boundary
+	static const u32 PACK_ALIGNMENT = 4096;
+
 	PackFileDevice(IAllocator& allocator);
 	~PackFileDevice();
 
@@ -34,9 +39,8 @@ private:
 		u64 size;
 	};
 
-	HashMap<u32, PackFileInfo> m_files;
-	size_t m_offset;
-	OsFile m_file;
+	FlatHashMap<u32, PackFileInfo> m_files;
+	char m_pack_path[MAX_PATH_LENGTH];
 	IAllocator& m_allocator;
 };
 
@@ -1,6 +1,7 @@
 #include "engine/fs/tcp_file_device.h"
 #include "engine/iallocator.h"
 #include "engine/blob.h"
+#include "engine/compression.h"
 #include "engine/fs/file_system.h"
 #include "engine/mt/sync.h"
 #include "engine/path.h"
@@ -16,14 +17,23 @@ namespace Lumix
 		class TCPFile LUMIX_FINAL : public IFile
 		{
 		public:
-			TCPFile(Net::TCPStream* stream, TCPFileDevice& device, MT::SpinMutex& spin_mutex) 
+			TCPFile(Net::TCPStream* stream,
+				TCPFileDevice& device,
+				MT::SpinMutex& spin_mutex,
+				IAllocator& allocator,
+				i32 server_version)
 				: m_device(device)
 				, m_stream(stream)
 				, m_spin_mutex(spin_mutex)
+				, m_allocator(allocator)
+				, m_server_version(server_version)
 				, m_file(INVALID_FILE)
+				, m_buffer(nullptr)
+				, m_buffer_size(0)
+				, m_buffer_pos(0)
 			{}
 
-			~TCPFile() {}
+			~TCPFile() { m_allocator.deallocate(m_buffer); }
 
 			IFileDevice& getDevice() override
 			{
@@ -37,6 +47,9 @@ namespace Lumix
 					return false;
 				}
 
+				bool read_only = (mode & Mode::READ) != 0 && (mode & (Mode::WRITE | Mode::CREATE)) == 0;
+				if (read_only && m_server_version >= 2) return openWholeFile(path);
+
 				i32 op = TCPCommand::OpenFile;
 
 				MT::SpinLock lock(m_spin_mutex);
@@ -48,8 +61,53 @@ namespace Lumix
 				return INVALID_FILE != m_file;
 			}
 
+
+			// one round trip fetches the whole file, compressed when that
+			// saves bandwidth; read, seek and size are then served locally
+			bool openWholeFile(const Path& path)
+			{
+				i32 op = TCPCommand::ReadWholeFile;
+
+				MT::SpinLock lock(m_spin_mutex);
+				m_stream->write(op);
+				m_stream->writeString(path.c_str());
+
+				u64 file_size;
+				m_stream->read(file_size);
+				if (file_size == 0xffffFFFFffffFFFFULL) return false;
+
+				u32 compressed_size;
+				m_stream->read(compressed_size);
+
+				m_buffer = (u8*)m_allocator.allocate((size_t)file_size);
+				m_buffer_size = (size_t)file_size;
+				m_buffer_pos = 0;
+				if (compressed_size == 0)
+				{
+					if (m_stream->read(m_buffer, m_buffer_size)) return true;
+				}
+				else
+				{
+					u8* compressed = (u8*)m_allocator.allocate(compressed_size);
+					bool ok = m_stream->read(compressed, compressed_size) &&
+							  Compression::decompress(compressed, compressed_size, m_buffer, (i32)file_size);
+					m_allocator.deallocate(compressed);
+					if (ok) return true;
+				}
+				m_allocator.deallocate(m_buffer);
+				m_buffer = nullptr;
+				return false;
+			}
+
 			void close() override
 			{
+				if (m_buffer)
+				{
+					m_allocator.deallocate(m_buffer);
+					m_buffer = nullptr;
+					m_buffer_size = 0;
+					m_buffer_pos = 0;
+				}
 				if (INVALID_FILE != m_file)
 				{
 					i32 op = TCPCommand::Close;
@@ -62,6 +120,14 @@ namespace Lumix
 
 			bool read(void* buffer, size_t size) override
 			{
+				if (m_buffer)
+				{
+					if (m_buffer_pos + size > m_buffer_size) return false;
+					copyMemory(buffer, m_buffer + m_buffer_pos, (int)size);
+					m_buffer_pos += size;
+					return true;
+				}
+
 				i32 op = TCPCommand::Read;
 
 				MT::SpinLock lock(m_spin_mutex);
@@ -78,6 +144,8 @@ namespace Lumix
 
 			bool write(const void* buffer, size_t size) override
 			{
+				ASSERT(!m_buffer); // whole-file reads are read only
+
 				i32 op = TCPCommand::Write;
 
 				MT::SpinLock lock(m_spin_mutex);
@@ -94,11 +162,13 @@ namespace Lumix
 
 			const void* getBuffer() const override
 			{
-				return nullptr;
+				return m_buffer;
 			}
 
 			size_t size() override
 			{
+				if (m_buffer) return m_buffer_size;
+
 				i32 op = TCPCommand::Size;
 				u32 size = 0;
 
@@ -113,6 +183,17 @@ namespace Lumix
 
 			bool seek(SeekMode base, size_t pos) override
 			{
+				if (m_buffer)
+				{
+					switch (base)
+					{
+						case SeekMode::BEGIN: m_buffer_pos = pos; break;
+						case SeekMode::END: m_buffer_pos = m_buffer_size - pos; break;
+						case SeekMode::CURRENT: m_buffer_pos += pos; break;
+					}
+					return m_buffer_pos <= m_buffer_size;
+				}
+
 				i32 op = TCPCommand::Seek;
 
 				MT::SpinLock lock(m_spin_mutex);
@@ -129,6 +210,8 @@ namespace Lumix
 
 			size_t pos() override
 			{
+				if (m_buffer) return m_buffer_pos;
+
 				i32 op = TCPCommand::Seek;
 				i32 pos = 0;
 
@@ -148,7 +231,12 @@ namespace Lumix
 			TCPFileDevice& m_device;
 			Net::TCPStream* m_stream;
 			MT::SpinMutex& m_spin_mutex;
+			IAllocator& m_allocator;
+			i32 m_server_version;
 			u32 m_file;
+			u8* m_buffer;
+			size_t m_buffer_size;
+			size_t m_buffer_pos;
 		};
 
 		struct TCPImpl
@@ -158,12 +246,14 @@ namespace Lumix
 				, m_allocator(allocator)
 				, m_connector(m_allocator)
 				, m_stream(nullptr)
+				, m_server_version(1)
 			{}
 
 			IAllocator& m_allocator;
 			Net::TCPConnector m_connector;
 			Net::TCPStream* m_stream;
 			MT::SpinMutex m_spin_mutex;
+			i32 m_server_version;
 		};
 
 		TCPFileDevice::TCPFileDevice()
@@ -173,7 +263,8 @@ namespace Lumix
 
 		IFile* TCPFileDevice::createFile(IFile*)
 		{
-			return LUMIX_NEW(m_impl->m_allocator, TCPFile)(m_impl->m_stream, *this, m_impl->m_spin_mutex);
+			return LUMIX_NEW(m_impl->m_allocator, TCPFile)(
+				m_impl->m_stream, *this, m_impl->m_spin_mutex, m_impl->m_allocator, m_impl->m_server_version);
 		}
 
 		void TCPFileDevice::destroyFile(IFile* file)
@@ -185,6 +276,14 @@ namespace Lumix
 		{
 			m_impl = LUMIX_NEW(allocator, TCPImpl)(allocator);
 			m_impl->m_stream = m_impl->m_connector.connect(ip, port);
+			if (m_impl->m_stream)
+			{
+				// agree on the protocol; an older server echoes a lower
+				// version and the client sticks to the version 1 commands
+				m_impl->m_stream->write(TCPCommand::Hello);
+				m_impl->m_stream->write(TCP_PROTOCOL_VERSION);
+				m_impl->m_stream->read(m_impl->m_server_version);
+			}
 		}
 
 		void TCPFileDevice::disconnect()
@@ -18,6 +18,10 @@ namespace Lumix
 		class TCPFileSystemTask;
 		struct TCPImpl;
 
+		// version 2 adds the hello handshake, whole-file reads and compressed
+		// payloads; a version 1 peer never sees the new commands
+		static const i32 TCP_PROTOCOL_VERSION = 2;
+
 		struct TCPCommand
 		{
 			enum Value
@@ -30,6 +34,8 @@ namespace Lumix
 				Seek,
 				Pos,
 				Disconnect,
+				Hello,
+				ReadWholeFile,
 			};
 
 			TCPCommand() : value(0) {}
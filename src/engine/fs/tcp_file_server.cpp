@@ -1,6 +1,7 @@
 #include "engine/fs/tcp_file_server.h"
 
 #include "engine/array.h"
+#include "engine/compression.h"
 #include "engine/free_list.h"
 #include "engine/fs/os_file.h"
 #include "engine/fs/tcp_file_device.h"
@@ -159,6 +160,72 @@ public:
 	}
 
 
+	void hello(Net::TCPStream* stream)
+	{
+		i32 client_version = 1;
+		stream->read(client_version);
+		stream->write(TCP_PROTOCOL_VERSION);
+	}
+
+
+	// serves a whole read-only file in a single reply; the payload is sent
+	// compressed when that makes it smaller, raw (compressed size 0) otherwise
+	void readWholeFile(Net::TCPStream* stream)
+	{
+		stream->readString(m_buffer, lengthOf(m_buffer));
+
+		char path[MAX_PATH_LENGTH];
+		if (compareStringN(m_buffer, m_base_path.c_str(), m_base_path.length()) != 0)
+		{
+			copyString(path, m_base_path.c_str());
+			catString(path, m_buffer);
+		}
+		else
+		{
+			copyString(path, m_buffer);
+		}
+
+		OsFile file;
+		if (!file.open(path, Mode::OPEN_AND_READ, getAllocator()))
+		{
+			u64 fail = 0xffffFFFFffffFFFFULL;
+			stream->write(fail);
+			return;
+		}
+
+		u64 file_size = file.size();
+		u8* data = (u8*)getAllocator().allocate((size_t)file_size);
+		if (!file.read(data, (size_t)file_size))
+		{
+			getAllocator().deallocate(data);
+			file.close();
+			u64 fail = 0xffffFFFFffffFFFFULL;
+			stream->write(fail);
+			return;
+		}
+		file.close();
+
+		i32 max_size = Compression::maxCompressedSize((i32)file_size);
+		u8* compressed = (u8*)getAllocator().allocate(max_size);
+		i32 compressed_size = Compression::compress(data, (i32)file_size, compressed, max_size);
+
+		stream->write(file_size);
+		if (compressed_size > 0 && compressed_size < (i32)file_size)
+		{
+			stream->write((u32)compressed_size);
+			stream->write(compressed, compressed_size);
+		}
+		else
+		{
+			stream->write((u32)0);
+			stream->write(data, (size_t)file_size);
+		}
+
+		getAllocator().deallocate(compressed);
+		getAllocator().deallocate(data);
+	}
+
+
 	void pos(Net::TCPStream* stream)
 	{
 		u32 id = 0xffffFFFF;
@@ -170,18 +237,30 @@ public:
 	}
 
 
+	// one thread serves every connection; the loop blocks in waitForData, not
+	// in accept or a per-client read, so a stalled client cannot starve others
 	int task()
 	{
 		bool quit = false;
 
 		m_acceptor.start("127.0.0.1", 10001);
-		Net::TCPStream* stream = m_acceptor.accept();
+		Array<Net::TCPStream*> streams(getAllocator());
 
 		while (!quit)
 		{
+			int ready = Net::waitForData(streams.empty() ? nullptr : &streams[0], streams.size(), &m_acceptor, 100);
+			if (ready == -2) continue;
+			if (ready == -1)
+			{
+				Net::TCPStream* stream = m_acceptor.acceptPending();
+				if (stream) streams.push(stream);
+				continue;
+			}
+
+			Net::TCPStream* stream = streams[ready];
 			PROFILE_BLOCK("File server operation")
 			i32 op = 0;
-			stream->read(op);
+			if (!stream->read(op)) op = TCPCommand::Disconnect;
 			switch (op)
 			{
 				case TCPCommand::OpenFile:
@@ -205,8 +284,17 @@ public:
 				case TCPCommand::Pos:
 					pos(stream);
 					break;
+				case TCPCommand::Hello:
+					hello(stream);
+					break;
+				case TCPCommand::ReadWholeFile:
+					readWholeFile(stream);
+					break;
 				case TCPCommand::Disconnect:
-					quit = true;
+					m_acceptor.close(stream);
+					streams.eraseItemFast(stream);
+					// keep serving remaining clients; the server quits with its last one
+					quit = streams.empty();
 					break;
 				default:
 					ASSERT(0);
@@ -214,7 +302,7 @@ public:
 			}
 		}
 
-		m_acceptor.close(stream);
+		for (Net::TCPStream* stream : streams) m_acceptor.close(stream);
 		return 0;
 	}
 
@@ -146,4 +146,142 @@ void Frustum::computePerspective(const Vec3& position,
 }
 
 
+void frustumIntersectSpheres(const Frustum& frustum, const Sphere* spheres, u8* results, int count)
+{
+	// a Sphere is exactly four floats, so four of them transpose straight into
+	// SoA; each plane is then one splat against all four spheres
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		float4 xs = f4LoadUnaligned(&spheres[i]);
+		float4 ys = f4LoadUnaligned(&spheres[i + 1]);
+		float4 zs = f4LoadUnaligned(&spheres[i + 2]);
+		float4 rs = f4LoadUnaligned(&spheres[i + 3]);
+		f4Transpose(xs, ys, zs, rs);
+
+		int outside = 0;
+		for (int p = 0; p < (int)Frustum::Planes::COUNT; ++p)
+		{
+			float4 t = f4Mul(xs, f4Splat(frustum.xs[p]));
+			t = f4Add(t, f4Mul(ys, f4Splat(frustum.ys[p])));
+			t = f4Add(t, f4Mul(zs, f4Splat(frustum.zs[p])));
+			t = f4Add(t, f4Splat(frustum.ds[p]));
+			t = f4Add(t, rs);
+			outside |= f4MoveMask(t);
+		}
+		results[i] = (outside & 1) == 0;
+		results[i + 1] = (outside & 2) == 0;
+		results[i + 2] = (outside & 4) == 0;
+		results[i + 3] = (outside & 8) == 0;
+	}
+	for (; i < count; ++i)
+	{
+		results[i] = frustum.isSphereInside(spheres[i].position, spheres[i].radius);
+	}
+}
+
+
+void frustumIntersectAABBs(const Frustum& frustum, const AABB* aabbs, u8* results, int count)
+{
+	// p-vertex test, all eight planes per box; max(n * min, n * max) picks the
+	// vertex furthest along each plane normal without branching
+	const float4 px = f4Load(frustum.xs);
+	const float4 py = f4Load(frustum.ys);
+	const float4 pz = f4Load(frustum.zs);
+	const float4 pd = f4Load(frustum.ds);
+	const float4 px2 = f4Load(&frustum.xs[4]);
+	const float4 py2 = f4Load(&frustum.ys[4]);
+	const float4 pz2 = f4Load(&frustum.zs[4]);
+	const float4 pd2 = f4Load(&frustum.ds[4]);
+
+	for (int i = 0; i < count; ++i)
+	{
+		const AABB& aabb = aabbs[i];
+		float4 minx = f4Splat(aabb.min.x);
+		float4 miny = f4Splat(aabb.min.y);
+		float4 minz = f4Splat(aabb.min.z);
+		float4 maxx = f4Splat(aabb.max.x);
+		float4 maxy = f4Splat(aabb.max.y);
+		float4 maxz = f4Splat(aabb.max.z);
+
+		float4 t = f4Max(f4Mul(px, minx), f4Mul(px, maxx));
+		t = f4Add(t, f4Max(f4Mul(py, miny), f4Mul(py, maxy)));
+		t = f4Add(t, f4Max(f4Mul(pz, minz), f4Mul(pz, maxz)));
+		t = f4Add(t, pd);
+		int outside = f4MoveMask(t);
+
+		t = f4Max(f4Mul(px2, minx), f4Mul(px2, maxx));
+		t = f4Add(t, f4Max(f4Mul(py2, miny), f4Mul(py2, maxy)));
+		t = f4Add(t, f4Max(f4Mul(pz2, minz), f4Mul(pz2, maxz)));
+		t = f4Add(t, pd2);
+		outside |= f4MoveMask(t);
+
+		results[i] = outside == 0;
+	}
+}
+
+
+void sphereIntersectSpheres(const Sphere& sphere, const Sphere* spheres, u8* results, int count)
+{
+	const float4 cx = f4Splat(sphere.position.x);
+	const float4 cy = f4Splat(sphere.position.y);
+	const float4 cz = f4Splat(sphere.position.z);
+	const float4 cr = f4Splat(sphere.radius);
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		float4 xs = f4LoadUnaligned(&spheres[i]);
+		float4 ys = f4LoadUnaligned(&spheres[i + 1]);
+		float4 zs = f4LoadUnaligned(&spheres[i + 2]);
+		float4 rs = f4LoadUnaligned(&spheres[i + 3]);
+		f4Transpose(xs, ys, zs, rs);
+
+		float4 dx = f4Sub(xs, cx);
+		float4 dy = f4Sub(ys, cy);
+		float4 dz = f4Sub(zs, cz);
+		float4 dist2 = f4Add(f4Add(f4Mul(dx, dx), f4Mul(dy, dy)), f4Mul(dz, dz));
+		float4 rsum = f4Add(rs, cr);
+		int overlap = f4MoveMask(f4Sub(dist2, f4Mul(rsum, rsum)));
+		results[i] = (overlap & 1) != 0;
+		results[i + 1] = (overlap & 2) != 0;
+		results[i + 2] = (overlap & 4) != 0;
+		results[i + 3] = (overlap & 8) != 0;
+	}
+	for (; i < count; ++i)
+	{
+		Vec3 diff = spheres[i].position - sphere.position;
+		float rsum = spheres[i].radius + sphere.radius;
+		results[i] = diff.squaredLength() < rsum * rsum;
+	}
+}
+
+
+void rayIntersectAABBs(const Vec3& origin, const Vec3& dir, const AABB* aabbs, u8* results, int count)
+{
+	// slab test with the reciprocal direction hoisted out of the loop; a zero
+	// direction component becomes an infinity and falls out correctly
+	float rx = 1 / dir.x;
+	float ry = 1 / dir.y;
+	float rz = 1 / dir.z;
+	for (int i = 0; i < count; ++i)
+	{
+		const AABB& aabb = aabbs[i];
+		float tx1 = (aabb.min.x - origin.x) * rx;
+		float tx2 = (aabb.max.x - origin.x) * rx;
+		float tmin = Math::minimum(tx1, tx2);
+		float tmax = Math::maximum(tx1, tx2);
+		float ty1 = (aabb.min.y - origin.y) * ry;
+		float ty2 = (aabb.max.y - origin.y) * ry;
+		tmin = Math::maximum(tmin, Math::minimum(ty1, ty2));
+		tmax = Math::minimum(tmax, Math::maximum(ty1, ty2));
+		float tz1 = (aabb.min.z - origin.z) * rz;
+		float tz2 = (aabb.max.z - origin.z) * rz;
+		tmin = Math::maximum(tmin, Math::minimum(tz1, tz2));
+		tmax = Math::minimum(tmax, Math::maximum(tz1, tz2));
+		results[i] = tmax >= tmin && tmax >= 0;
+	}
+}
+
+
 } // namespace Lumix
+
@@ -322,4 +322,27 @@ struct AABB
 };
 
 
+// batch intersection tests shared by everything that culls arrays of
+// primitives; results gets one 0/1 byte per primitive, so callers keep
+// their payloads scattered and only the math is batched
+LUMIX_ENGINE_API void frustumIntersectSpheres(const Frustum& frustum,
+	const Sphere* spheres,
+	u8* results,
+	int count);
+LUMIX_ENGINE_API void frustumIntersectAABBs(const Frustum& frustum,
+	const AABB* aabbs,
+	u8* results,
+	int count);
+// strict overlap, tangent spheres do not count
+LUMIX_ENGINE_API void sphereIntersectSpheres(const Sphere& sphere,
+	const Sphere* spheres,
+	u8* results,
+	int count);
+LUMIX_ENGINE_API void rayIntersectAABBs(const Vec3& origin,
+	const Vec3& dir,
+	const AABB* aabbs,
+	u8* results,
+	int count);
+
+
 } // namespace Lumix
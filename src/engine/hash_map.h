@@ -20,6 +20,12 @@ namespace Lumix
 			, m_next(nullptr)
 		{}
 
+		HashNode(const K& key, V&& value)
+			: m_key(key)
+			, m_value(static_cast<V&&>(value))
+			, m_next(nullptr)
+		{}
+
 		explicit HashNode(const my_node& src)
 			: m_key(src.m_key)
 			, m_value(src.m_value)
@@ -431,6 +437,15 @@ namespace Lumix
 			checkSize();
 		}
 
+		void insert(const key_type& key, value_type&& val)
+		{
+			size_type pos = getPosition(key);
+			node_type* node = getEmptyNode(pos);
+			new (NewPlaceholder(), node) node_type(key, static_cast<value_type&&>(val));
+			m_size++;
+			checkSize();
+		}
+
 		iterator erase(iterator it)
 		{
 			ASSERT(it.isValid());
@@ -35,6 +35,24 @@ namespace Lumix
 				RIGHT
 			};
 
+			struct Event
+			{
+				enum Type : u8
+				{
+					MOUSE_MOVE,
+					MOUSE_BUTTON
+				};
+
+				Type type;
+				MouseButton button;
+				bool is_down;
+				float rel_x;
+				float rel_y;
+				float abs_x;
+				float abs_y;
+				u64 timestamp; // raw timer ticks, see Timer::getFrequency
+			};
+
 		public:
 
 			static InputSystem* create(IAllocator& allocator);
@@ -50,6 +68,13 @@ namespace Lumix
 			virtual float getMouseYMove() const = 0;
 			virtual bool  isMouseDown(MouseButton button) = 0;
 			virtual Vec2 getMousePos() const = 0;
+			// events gathered since the previous update, oldest first; platforms
+			// with a polling thread sample at ~1 kHz, others report one event per frame
+			virtual int getEventCount() const = 0;
+			virtual const Event& getEvent(int index) const = 0;
+			// mouse position at a point inside the last frame; t is 0 at frame
+			// start and 1 at frame end, positions between samples are interpolated
+			virtual Vec2 getMousePosAt(float t) const = 0;
 			virtual void addAction(u32 action, InputType type, int key, int controller_id) = 0;
 	};
 
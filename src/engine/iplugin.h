@@ -18,6 +18,18 @@ namespace Lumix
 
 	class LUMIX_ENGINE_API IScene
 	{
+		public:
+			// what update() touches; the engine updates scenes with no overlap
+			// concurrently and keeps conflicting scenes in registration order.
+			// the defaults claim everything, which keeps a scene fully serial
+			struct UpdateAccess
+			{
+				u64 component_reads = ~(u64)0; // bit index = ComponentType::index
+				u64 component_writes = ~(u64)0;
+				bool transform_read = true;
+				bool transform_write = true;
+			};
+
 		public:
 			virtual ~IScene() {}
 
@@ -30,6 +42,7 @@ namespace Lumix
 			virtual IPlugin& getPlugin() const = 0;
 			virtual void update(float time_delta, bool paused) = 0;
 			virtual void lateUpdate(float time_delta, bool paused) {}
+			virtual UpdateAccess getUpdateAccess() const { return UpdateAccess(); }
 			virtual ComponentHandle getComponent(Entity entity, ComponentType type) = 0;
 			virtual Universe& getUniverse() = 0;
 			virtual void startGame() {}
@@ -50,6 +63,18 @@ namespace Lumix
 			virtual const char* getName() const = 0;
 			virtual void pluginAdded(IPlugin& plugin) {}
 
+			// comma separated names of plugins whose initBackground must finish
+			// before this plugin's runs; empty means it can run with any other
+			virtual const char* getInitDependencies() const { return ""; }
+			// self-contained part of initialization; PluginManager::initPlugins
+			// runs these on worker threads, concurrently for plugins without a
+			// dependency between them, so nothing here may touch shared engine
+			// state such as the property or resource registries
+			virtual void initBackground() {}
+			// non-critical initialization; runs on the main thread after the
+			// first frame so it does not delay the time to first pixel
+			virtual void initLate() {}
+
 			virtual void createScenes(Universe&) {}
 			virtual void destroyScene(IScene*) { ASSERT(false); }
 			virtual void startGame() {}
@@ -2,6 +2,7 @@
 
 
 #include "engine/array.h"
+#include "engine/blob.h"
 #include "engine/universe/universe.h"
 
 
@@ -36,12 +37,23 @@ public:
 public:
 	IPropertyDescriptor()
 		: m_is_in_radians(false)
+		, m_is_owned(true)
 	{
 	}
 	virtual ~IPropertyDescriptor() {}
 
 	virtual void set(ComponentUID cmp, int index, InputBlob& stream) const = 0;
 	virtual void get(ComponentUID cmp, int index, OutputBlob& stream) const = 0;
+	// applies one serialized value to a whole span of components; this fallback
+	// re-parses the blob per component, typed descriptors parse it only once
+	virtual void setBatch(const ComponentUID* cmps, int count, int index, InputBlob& stream) const
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			stream.rewind();
+			set(cmps[i], index, stream);
+		}
+	}
 
 	Type getType() const { return m_type; }
 	u32 getNameHash() const { return m_name_hash; }
@@ -49,9 +61,13 @@ public:
 	void setName(const char* name);
 	IPropertyDescriptor& setIsInRadians(bool is) { m_is_in_radians = is; return *this; }
 	bool isInRadians() const { return m_is_in_radians; }
+	// descriptors in static storage are registered but never deleted by the registry
+	IPropertyDescriptor& setOwned(bool is) { m_is_owned = is; return *this; }
+	bool isOwned() const { return m_is_owned; }
 
 protected:
 	bool m_is_in_radians;
+	bool m_is_owned;
 	u32 m_name_hash;
 	StaticString<32> m_name;
 	Type m_type;
@@ -4,6 +4,7 @@
 #include "engine/log.h"
 #include "engine/math_utils.h"
 #include "engine/path.h"
+#include "engine/simd.h"
 #include <cstdlib>
 
 
@@ -681,6 +682,115 @@ static bool isSingleCharToken(char c)
 }
 
 
+#ifdef LUMIX_SIMD_SSE
+
+static LUMIX_FORCE_INLINE int firstSetBit(u32 mask)
+{
+	#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return (int)index;
+	#else
+		return __builtin_ctz(mask);
+	#endif
+}
+
+
+// the scanners below eat 16 bytes per step; the data buffer is exactly the
+// file size, so the last partial chunk always falls through to the scalar
+// loop instead of reading past the end
+
+static const char* skipDelimiters(const char* p, const char* end)
+{
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i lf = _mm_set1_epi8('\n');
+	while (p + 16 <= end)
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i*)p);
+		__m128i is_delim = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf)));
+		u32 mask = ~(u32)_mm_movemask_epi8(is_delim) & 0xffff;
+		if (mask) return p + firstSetBit(mask);
+		p += 16;
+	}
+	while (p < end && isDelimiter(*p)) ++p;
+	return p;
+}
+
+
+static const char* findStringEnd(const char* p, const char* end)
+{
+	const __m128i quote = _mm_set1_epi8('"');
+	while (p + 16 <= end)
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i*)p);
+		u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote));
+		if (mask) return p + firstSetBit(mask);
+		p += 16;
+	}
+	while (p < end && *p != '"') ++p;
+	return p;
+}
+
+
+static const char* findTokenEnd(const char* p, const char* end)
+{
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i lf = _mm_set1_epi8('\n');
+	const __m128i comma = _mm_set1_epi8(',');
+	const __m128i colon = _mm_set1_epi8(':');
+	const __m128i bracket_open = _mm_set1_epi8('[');
+	const __m128i bracket_close = _mm_set1_epi8(']');
+	const __m128i brace_open = _mm_set1_epi8('{');
+	const __m128i brace_close = _mm_set1_epi8('}');
+	while (p + 16 <= end)
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i*)p);
+		__m128i is_end = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf)));
+		is_end = _mm_or_si128(is_end, _mm_cmpeq_epi8(chunk, comma));
+		is_end = _mm_or_si128(is_end, _mm_cmpeq_epi8(chunk, colon));
+		is_end = _mm_or_si128(is_end, _mm_cmpeq_epi8(chunk, bracket_open));
+		is_end = _mm_or_si128(is_end, _mm_cmpeq_epi8(chunk, bracket_close));
+		is_end = _mm_or_si128(is_end, _mm_cmpeq_epi8(chunk, brace_open));
+		is_end = _mm_or_si128(is_end, _mm_cmpeq_epi8(chunk, brace_close));
+		u32 mask = (u32)_mm_movemask_epi8(is_end);
+		if (mask) return p + firstSetBit(mask);
+		p += 16;
+	}
+	while (p < end && !isDelimiter(*p) && !isSingleCharToken(*p)) ++p;
+	return p;
+}
+
+#else
+
+static const char* skipDelimiters(const char* p, const char* end)
+{
+	while (p < end && isDelimiter(*p)) ++p;
+	return p;
+}
+
+
+static const char* findStringEnd(const char* p, const char* end)
+{
+	while (p < end && *p != '"') ++p;
+	return p;
+}
+
+
+static const char* findTokenEnd(const char* p, const char* end)
+{
+	while (p < end && !isDelimiter(*p) && !isSingleCharToken(*p)) ++p;
+	return p;
+}
+
+#endif
+
+
 void JsonSerializer::deserializeToken()
 {
 	m_token += m_token_size;
@@ -689,25 +799,19 @@ void JsonSerializer::deserializeToken()
 		++m_token;
 	}
 
-	while (m_token < m_data + m_data_size && isDelimiter(*m_token))
+	const char* end = m_data + m_data_size;
+	m_token = skipDelimiters(m_token, end);
+	if (*m_token == '/' && m_token < end - 1 && m_token[1] == '/')
 	{
-		++m_token;
-	}
-	if (*m_token == '/' && m_token < m_data + m_data_size - 1 && m_token[1] == '/')
-	{
-		m_token_size = int((m_data + m_data_size) - m_token);
+		m_token_size = int(end - m_token);
 		m_is_string_token = false;
 	}
 	else if (*m_token == '"')
 	{
 		++m_token;
 		m_is_string_token = true;
-		const char* token_end = m_token;
-		while (token_end < m_data + m_data_size && *token_end != '"')
-		{
-			++token_end;
-		}
-		if (token_end == m_data + m_data_size)
+		const char* token_end = findStringEnd(m_token, end);
+		if (token_end == end)
 		{
 			ErrorProxy(*this).log() << "Unexpected end of file while looking for \".";
 			m_token_size = 0;
@@ -725,12 +829,7 @@ void JsonSerializer::deserializeToken()
 	else
 	{
 		m_is_string_token = false;
-		const char* token_end = m_token;
-		while (token_end < m_data + m_data_size && !isDelimiter(*token_end) &&
-			   !isSingleCharToken(*token_end))
-		{
-			++token_end;
-		}
+		const char* token_end = findTokenEnd(m_token, end);
 		m_token_size = int(token_end - m_token);
 	}
 }
@@ -838,6 +937,44 @@ void JsonSerializer::deserializeLabel(const char* label)
 
 float JsonSerializer::tokenToFloat()
 {
+	// fast path for the plain decimal numbers the serializer itself writes;
+	// exponent notation and other oddities fall back to atof
+	const char* c = m_token;
+	const char* end = m_token + m_token_size;
+	bool negative = false;
+	if (c < end && (*c == '-' || *c == '+'))
+	{
+		negative = *c == '-';
+		++c;
+	}
+	u64 mantissa = 0;
+	int digits = 0;
+	int frac_digits = 0;
+	while (c < end && *c >= '0' && *c <= '9')
+	{
+		mantissa = mantissa * 10 + (*c - '0');
+		++digits;
+		++c;
+	}
+	if (c < end && *c == '.')
+	{
+		++c;
+		while (c < end && *c >= '0' && *c <= '9')
+		{
+			mantissa = mantissa * 10 + (*c - '0');
+			++digits;
+			++frac_digits;
+			++c;
+		}
+	}
+	if (c == end && digits > 0 && digits <= 17)
+	{
+		static const double POW10[] = {1.0, 10.0, 100.0, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+			1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17};
+		double value = (double)mantissa / POW10[frac_digits];
+		return (float)(negative ? -value : value);
+	}
+
 	char tmp[64];
 	int size = Math::minimum((int)sizeof(tmp) - 1, m_token_size);
 	copyMemory(tmp, m_token, size);
@@ -1,4 +1,5 @@
 #include "engine/input_system.h"
+#include "engine/array.h"
 #include "engine/associative_array.h"
 #include "engine/profiler.h"
 #include "engine/string.h"
@@ -12,6 +13,7 @@ namespace Lumix
 		InputSystemImpl(IAllocator& allocator) : m_allocator(allocator)
 			, m_mouse_rel_pos(0, 0)
 			, m_injected_mouse_rel_pos(0, 0)
+			, m_events(allocator)
 		{}
 
 
@@ -27,6 +29,20 @@ namespace Lumix
 
 			m_mouse_rel_pos = m_injected_mouse_rel_pos;
 			m_injected_mouse_rel_pos = { 0, 0 };
+
+			// no polling thread here, report the injected state as one event per frame
+			m_events.clear();
+			if (m_mouse_rel_pos.x != 0 || m_mouse_rel_pos.y != 0)
+			{
+				Event event;
+				event.type = Event::MOUSE_MOVE;
+				event.rel_x = m_mouse_rel_pos.x;
+				event.rel_y = m_mouse_rel_pos.y;
+				event.abs_x = m_mouse_pos.x;
+				event.abs_y = m_mouse_pos.y;
+				event.timestamp = 0;
+				m_events.push(event);
+			}
 		}
 
 
@@ -51,6 +67,9 @@ namespace Lumix
 		float getMouseYMove() const override { return m_mouse_rel_pos.y; }
 		Vec2 getMousePos() const override { return m_mouse_pos; }
 		bool isMouseDown(MouseButton button) override { return false; }
+		int getEventCount() const override { return m_events.size(); }
+		const Event& getEvent(int index) const override { return m_events[index]; }
+		Vec2 getMousePosAt(float t) const override { return m_mouse_pos; }
 
 
 
@@ -60,6 +79,7 @@ namespace Lumix
 		Vec2 m_injected_mouse_rel_pos;
 		Vec2 m_mouse_pos;
 		Vec2 m_mouse_rel_pos;
+		Array<Event> m_events;
 	};
 
 
@@ -63,6 +63,20 @@ TCPStream* TCPAcceptor::accept()
 }
 
 
+TCPStream* TCPAcceptor::acceptPending()
+{
+	ASSERT(false);
+	return nullptr;
+}
+
+
+int waitForData(TCPStream** streams, int count, TCPAcceptor* acceptor, int timeout_ms)
+{
+	ASSERT(false);
+	return -2;
+}
+
+
 TCPConnector::TCPConnector(IAllocator& allocator)
 	: m_allocator(allocator)
 	, m_socket(0)
@@ -179,5 +193,12 @@ bool TCPStream::write(const void* buffer, size_t size)
 }
 
 
+bool TCPStream::hasData() const
+{
+	ASSERT(false);
+	return false;
+}
+
+
 } // namespace Net
 } // namespace Lumix
@@ -1,5 +1,8 @@
 #include "engine/log.h"
 #include "engine/array.h"
+#include "engine/mt/lock_free_fixed_queue.h"
+#include "engine/mt/task.h"
+#include "engine/mt/thread.h"
 #include "engine/path.h"
 #include "engine/string.h"
 
@@ -13,6 +16,96 @@ Log g_log_warning;
 Log g_log_error;
 
 
+struct LogMessage
+{
+	Log* log;
+	char system[64];
+	char message[1024];
+};
+
+
+typedef MT::LockFreeFixedQueue<LogMessage, 512> LogQueue;
+
+
+class LogTask LUMIX_FINAL : public MT::Task
+{
+public:
+	LogTask(LogQueue* queue, IAllocator& allocator)
+		: MT::Task(allocator)
+		, m_queue(queue)
+	{
+	}
+
+
+	int task() override
+	{
+		while (!m_queue->isAborted())
+		{
+			LogMessage* msg = m_queue->pop(true);
+			if (!msg) break;
+
+			msg->log->getCallback().invoke(msg->system, msg->message);
+			m_queue->dealoc(msg);
+		}
+		return 0;
+	}
+
+
+	void stop() { m_queue->abort(); }
+
+private:
+	LogQueue* m_queue;
+};
+
+
+static LogQueue* g_log_queue = nullptr;
+static LogTask* g_log_task = nullptr;
+static IAllocator* g_log_allocator = nullptr;
+
+
+void startAsyncLogging(IAllocator& allocator)
+{
+	if (g_log_task) return;
+
+	g_log_allocator = &allocator;
+	g_log_queue = LUMIX_NEW(allocator, LogQueue);
+	g_log_task = LUMIX_NEW(allocator, LogTask)(g_log_queue, allocator);
+	g_log_task->create("log");
+}
+
+
+void stopAsyncLogging()
+{
+	if (!g_log_task) return;
+
+	LogTask* task = g_log_task;
+	// switch to synchronous delivery before tearing the queue down
+	g_log_task = nullptr;
+	while (!g_log_queue->isEmpty()) MT::sleep(1);
+	task->stop();
+	task->destroy();
+	LUMIX_DELETE(*g_log_allocator, task);
+	LUMIX_DELETE(*g_log_allocator, g_log_queue);
+	g_log_queue = nullptr;
+	g_log_allocator = nullptr;
+}
+
+
+static void sendToSinks(Log& log, const char* system, const char* message)
+{
+	if (g_log_task)
+	{
+		LogMessage* msg = g_log_queue->alloc(true);
+		msg->log = &log;
+		copyString(msg->system, system);
+		copyString(msg->message, message);
+		g_log_queue->push(msg, true);
+		return;
+	}
+	log.getCallback().invoke(system, message);
+}
+
+
 LogProxy Log::log(const char* system)
 {
 	return LogProxy(*this, system, m_allocator);
@@ -34,7 +127,38 @@ LogProxy::LogProxy(Log& log, const char* system, IAllocator& allocator)
 
 LogProxy::~LogProxy()
 {
-	m_log.getCallback().invoke(m_system.c_str(), m_message.c_str());
+	sendToSinks(m_log, m_system.c_str(), m_message.c_str());
+}
+
+
+LogProxy& LogProxy::field(const char* key, const char* value)
+{
+	m_message.cat(" ");
+	m_message.cat(key);
+	m_message.cat("=\"");
+	m_message.cat(value);
+	m_message.cat("\"");
+	return *this;
+}
+
+
+LogProxy& LogProxy::field(const char* key, i32 value)
+{
+	m_message.cat(" ");
+	m_message.cat(key);
+	m_message.cat("=");
+	m_message.cat(value);
+	return *this;
+}
+
+
+LogProxy& LogProxy::field(const char* key, float value)
+{
+	m_message.cat(" ");
+	m_message.cat(key);
+	m_message.cat("=");
+	m_message.cat(value);
+	return *this;
 }
 
 
@@ -26,6 +26,11 @@ namespace Lumix
 			LogProxy& operator <<(const string& path);
 			LogProxy& operator <<(const Path& path);
 			LogProxy& substring(const char* str, int start, int length);
+			// appends a machine-parsable " key=value" pair; keep fields after
+			// the human readable part of the message
+			LogProxy& field(const char* key, const char* value);
+			LogProxy& field(const char* key, i32 value);
+			LogProxy& field(const char* key, float value);
 
 		private:
 			IAllocator& m_allocator;
@@ -61,5 +66,12 @@ namespace Lumix
 	extern Log LUMIX_ENGINE_API g_log_warning;
 	extern Log LUMIX_ENGINE_API g_log_error;
 
+	// routes log output through a background thread; callers only enqueue, so
+	// a burst of warnings from loading threads never waits on the sinks.
+	// messages logged before start or after stop are delivered synchronously
+	// on the calling thread
+	LUMIX_ENGINE_API void startAsyncLogging(IAllocator& allocator);
+	LUMIX_ENGINE_API void stopAsyncLogging();
+
 
 } // ~namespace Lumix
@@ -78,15 +78,15 @@ void Matrix::decompose(Vec3& position, Quat& rotation, float& scale) const
 
 
 
-Matrix Matrix::operator *(const Matrix& rhs) const
+// columns of lhs come in preloaded so the batch kernels can hoist them; every
+// read of rhs happens before out is written, so out may alias rhs
+static LUMIX_FORCE_INLINE void multiplyMatrices(Matrix* out,
+	const float4 a,
+	const float4 b,
+	const float4 c,
+	const float4 d,
+	const Matrix& rhs)
 {
-	Matrix out;
-
-	const float4 a = f4Load(&m11);
-	const float4 b = f4Load(&m21);
-	const float4 c = f4Load(&m31);
-	const float4 d = f4Load(&m41);
-
 	float4 t1, t2;
 
 	t1 = f4Splat(rhs.m11);
@@ -96,9 +96,7 @@ Matrix Matrix::operator *(const Matrix& rhs) const
 	t1 = f4Splat(rhs.m13);
 	t2 = f4Add(f4Mul(c, t1), t2);
 	t1 = f4Splat(rhs.m14);
-	t2 = f4Add(f4Mul(d, t1), t2);
-
-	f4Store(&out.m11, t2);
+	const float4 o1 = f4Add(f4Mul(d, t1), t2);
 
 	t1 = f4Splat(rhs.m21);
 	t2 = f4Mul(a, t1);
@@ -107,9 +105,7 @@ Matrix Matrix::operator *(const Matrix& rhs) const
 	t1 = f4Splat(rhs.m23);
 	t2 = f4Add(f4Mul(c, t1), t2);
 	t1 = f4Splat(rhs.m24);
-	t2 = f4Add(f4Mul(d, t1), t2);
-
-	f4Store(&out.m21, t2);
+	const float4 o2 = f4Add(f4Mul(d, t1), t2);
 
 	t1 = f4Splat(rhs.m31);
 	t2 = f4Mul(a, t1);
@@ -118,9 +114,7 @@ Matrix Matrix::operator *(const Matrix& rhs) const
 	t1 = f4Splat(rhs.m33);
 	t2 = f4Add(f4Mul(c, t1), t2);
 	t1 = f4Splat(rhs.m34);
-	t2 = f4Add(f4Mul(d, t1), t2);
-
-	f4Store(&out.m31, t2);
+	const float4 o3 = f4Add(f4Mul(d, t1), t2);
 
 	t1 = f4Splat(rhs.m41);
 	t2 = f4Mul(a, t1);
@@ -129,14 +123,141 @@ Matrix Matrix::operator *(const Matrix& rhs) const
 	t1 = f4Splat(rhs.m43);
 	t2 = f4Add(f4Mul(c, t1), t2);
 	t1 = f4Splat(rhs.m44);
-	t2 = f4Add(f4Mul(d, t1), t2);
+	const float4 o4 = f4Add(f4Mul(d, t1), t2);
+
+	f4Store(&out->m11, o1);
+	f4Store(&out->m21, o2);
+	f4Store(&out->m31, o3);
+	f4Store(&out->m41, o4);
+}
 
-	f4Store(&out.m41, t2);
 
+Matrix Matrix::operator *(const Matrix& rhs) const
+{
+	Matrix out;
+	multiplyMatrices(&out, f4Load(&m11), f4Load(&m21), f4Load(&m31), f4Load(&m41), rhs);
 	return out;
 }
 
 
+void Matrix::multiplyArrays(const Matrix* a, const Matrix* b, Matrix* out, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		multiplyMatrices(&out[i],
+			f4Load(&a[i].m11),
+			f4Load(&a[i].m21),
+			f4Load(&a[i].m31),
+			f4Load(&a[i].m41),
+			b[i]);
+	}
+}
+
+
+void Matrix::multiplyArrays(const Matrix& a, const Matrix* b, Matrix* out, int count)
+{
+	const float4 c1 = f4Load(&a.m11);
+	const float4 c2 = f4Load(&a.m21);
+	const float4 c3 = f4Load(&a.m31);
+	const float4 c4 = f4Load(&a.m41);
+	for (int i = 0; i < count; ++i)
+	{
+		multiplyMatrices(&out[i], c1, c2, c3, c4, b[i]);
+	}
+}
+
+
+void Matrix::transformPoints(const Matrix& mtx, const Vec3* src, Vec3* dst, int count)
+{
+	// four points per iteration, shuffled to SoA so one splatted matrix element
+	// serves all four; after the transpose back, the fourth lane of each row
+	// carries the next point's untouched x, so in-place use stays correct and
+	// the one-past write of the last row lands on a point the tail rewrites
+	const float4 m11_4 = f4Splat(mtx.m11);
+	const float4 m21_4 = f4Splat(mtx.m21);
+	const float4 m31_4 = f4Splat(mtx.m31);
+	const float4 m41_4 = f4Splat(mtx.m41);
+	const float4 m12_4 = f4Splat(mtx.m12);
+	const float4 m22_4 = f4Splat(mtx.m22);
+	const float4 m32_4 = f4Splat(mtx.m32);
+	const float4 m42_4 = f4Splat(mtx.m42);
+	const float4 m13_4 = f4Splat(mtx.m13);
+	const float4 m23_4 = f4Splat(mtx.m23);
+	const float4 m33_4 = f4Splat(mtx.m33);
+	const float4 m43_4 = f4Splat(mtx.m43);
+	int i = 0;
+	for (; i + 4 < count; i += 4)
+	{
+		float4 r0 = f4LoadUnaligned(&src[i]);
+		float4 r1 = f4LoadUnaligned(&src[i + 1]);
+		float4 r2 = f4LoadUnaligned(&src[i + 2]);
+		float4 r3 = f4LoadUnaligned(&src[i + 3]);
+		f4Transpose(r0, r1, r2, r3);
+
+		float4 ox = f4Add(f4Add(f4Mul(r0, m11_4), f4Mul(r1, m21_4)), f4Add(f4Mul(r2, m31_4), m41_4));
+		float4 oy = f4Add(f4Add(f4Mul(r0, m12_4), f4Mul(r1, m22_4)), f4Add(f4Mul(r2, m32_4), m42_4));
+		float4 oz = f4Add(f4Add(f4Mul(r0, m13_4), f4Mul(r1, m23_4)), f4Add(f4Mul(r2, m33_4), m43_4));
+
+		f4Transpose(ox, oy, oz, r3);
+		f4StoreUnaligned(&dst[i], ox);
+		f4StoreUnaligned(&dst[i + 1], oy);
+		f4StoreUnaligned(&dst[i + 2], oz);
+		f4StoreUnaligned(&dst[i + 3], r3);
+	}
+	for (; i < count; ++i)
+	{
+		dst[i] = mtx.transform(src[i]);
+	}
+}
+
+
+void Matrix::transformPoints(const Matrix& mtx, const Vec3* src, Vec4* dst, int count)
+{
+	const float4 m11_4 = f4Splat(mtx.m11);
+	const float4 m21_4 = f4Splat(mtx.m21);
+	const float4 m31_4 = f4Splat(mtx.m31);
+	const float4 m41_4 = f4Splat(mtx.m41);
+	const float4 m12_4 = f4Splat(mtx.m12);
+	const float4 m22_4 = f4Splat(mtx.m22);
+	const float4 m32_4 = f4Splat(mtx.m32);
+	const float4 m42_4 = f4Splat(mtx.m42);
+	const float4 m13_4 = f4Splat(mtx.m13);
+	const float4 m23_4 = f4Splat(mtx.m23);
+	const float4 m33_4 = f4Splat(mtx.m33);
+	const float4 m43_4 = f4Splat(mtx.m43);
+	const float4 m14_4 = f4Splat(mtx.m14);
+	const float4 m24_4 = f4Splat(mtx.m24);
+	const float4 m34_4 = f4Splat(mtx.m34);
+	const float4 m44_4 = f4Splat(mtx.m44);
+	int i = 0;
+	// i + 4 < count and not <=, the last source load would read one float past
+	// the array
+	for (; i + 4 < count; i += 4)
+	{
+		float4 r0 = f4LoadUnaligned(&src[i]);
+		float4 r1 = f4LoadUnaligned(&src[i + 1]);
+		float4 r2 = f4LoadUnaligned(&src[i + 2]);
+		float4 r3 = f4LoadUnaligned(&src[i + 3]);
+		f4Transpose(r0, r1, r2, r3);
+
+		float4 ox = f4Add(f4Add(f4Mul(r0, m11_4), f4Mul(r1, m21_4)), f4Add(f4Mul(r2, m31_4), m41_4));
+		float4 oy = f4Add(f4Add(f4Mul(r0, m12_4), f4Mul(r1, m22_4)), f4Add(f4Mul(r2, m32_4), m42_4));
+		float4 oz = f4Add(f4Add(f4Mul(r0, m13_4), f4Mul(r1, m23_4)), f4Add(f4Mul(r2, m33_4), m43_4));
+		float4 ow = f4Add(f4Add(f4Mul(r0, m14_4), f4Mul(r1, m24_4)), f4Add(f4Mul(r2, m34_4), m44_4));
+
+		f4Transpose(ox, oy, oz, ow);
+		f4StoreUnaligned(&dst[i], ox);
+		f4StoreUnaligned(&dst[i + 1], oy);
+		f4StoreUnaligned(&dst[i + 2], oz);
+		f4StoreUnaligned(&dst[i + 3], ow);
+	}
+	for (; i < count; ++i)
+	{
+		dst[i] = mtx * Vec4(src[i], 1);
+	}
+}
+
+
 Quat Matrix::getRotation() const
 {
 	Quat rot;
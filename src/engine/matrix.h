@@ -93,6 +93,17 @@ LUMIX_ALIGN_BEGIN(16) struct LUMIX_ENGINE_API Matrix
 
 	Matrix operator *(const Matrix& rhs) const;
 
+	// batch kernels over the SIMD layer; code with whole arrays should use
+	// these instead of looping over operator* or transform()
+	// out[i] = a[i] * b[i]; out may alias a or b
+	static void multiplyArrays(const Matrix* a, const Matrix* b, Matrix* out, int count);
+	// out[i] = a * b[i]; e.g. one view-projection over a batch of world matrices
+	static void multiplyArrays(const Matrix& a, const Matrix* b, Matrix* out, int count);
+	// dst[i] = mtx.transform(src[i]); dst may alias src
+	static void transformPoints(const Matrix& mtx, const Vec3* src, Vec3* dst, int count);
+	// dst[i] = mtx * Vec4(src[i], 1), keeping w for clipping
+	static void transformPoints(const Matrix& mtx, const Vec3* src, Vec4* dst, int count);
+
 	Vec4 operator *(const Vec4& rhs) const
 	{
 		return Vec4(
@@ -0,0 +1,276 @@
+#pragma once
+
+
+#include "engine/array.h"
+#include "engine/hash_map.h"
+#include "engine/lumix.h"
+#include "engine/vec.h"
+#include <cmath>
+
+#ifdef __BMI2__
+	#include <immintrin.h>
+#endif
+
+
+namespace Lumix
+{
+
+
+// 2d/3d morton (z-order) keys; interleaving the coordinate bits keeps
+// spatially close cells numerically close, so anything sorted or bucketed
+// by the key stays cache friendly when walked in spatial order. The pdep
+// path is compile-time only, the baseline build uses the magic-bit version
+
+#ifdef __BMI2__
+
+LUMIX_FORCE_INLINE u32 mortonEncode(u32 x, u32 y)
+{
+	return _pdep_u32(x, 0x55555555) | _pdep_u32(y, 0xaaaaaaaa);
+}
+
+
+LUMIX_FORCE_INLINE void mortonDecode(u32 key, u32& x, u32& y)
+{
+	x = _pext_u32(key, 0x55555555);
+	y = _pext_u32(key, 0xaaaaaaaa);
+}
+
+
+LUMIX_FORCE_INLINE u32 mortonEncode(u32 x, u32 y, u32 z)
+{
+	return _pdep_u32(x, 0x09249249) | _pdep_u32(y, 0x12492492) | _pdep_u32(z, 0x24924924);
+}
+
+
+LUMIX_FORCE_INLINE void mortonDecode(u32 key, u32& x, u32& y, u32& z)
+{
+	x = _pext_u32(key, 0x09249249);
+	y = _pext_u32(key, 0x12492492);
+	z = _pext_u32(key, 0x24924924);
+}
+
+#else
+
+// spreads the low 16 bits of x to the even bit positions
+LUMIX_FORCE_INLINE u32 mortonPart1By1(u32 x)
+{
+	x &= 0x0000ffff;
+	x = (x ^ (x << 8)) & 0x00ff00ff;
+	x = (x ^ (x << 4)) & 0x0f0f0f0f;
+	x = (x ^ (x << 2)) & 0x33333333;
+	x = (x ^ (x << 1)) & 0x55555555;
+	return x;
+}
+
+
+LUMIX_FORCE_INLINE u32 mortonCompact1By1(u32 x)
+{
+	x &= 0x55555555;
+	x = (x ^ (x >> 1)) & 0x33333333;
+	x = (x ^ (x >> 2)) & 0x0f0f0f0f;
+	x = (x ^ (x >> 4)) & 0x00ff00ff;
+	x = (x ^ (x >> 8)) & 0x0000ffff;
+	return x;
+}
+
+
+// spreads the low 10 bits of x to every third bit position
+LUMIX_FORCE_INLINE u32 mortonPart1By2(u32 x)
+{
+	x &= 0x000003ff;
+	x = (x ^ (x << 16)) & 0xff0000ff;
+	x = (x ^ (x << 8)) & 0x0300f00f;
+	x = (x ^ (x << 4)) & 0x030c30c3;
+	x = (x ^ (x << 2)) & 0x09249249;
+	return x;
+}
+
+
+LUMIX_FORCE_INLINE u32 mortonCompact1By2(u32 x)
+{
+	x &= 0x09249249;
+	x = (x ^ (x >> 2)) & 0x030c30c3;
+	x = (x ^ (x >> 4)) & 0x0300f00f;
+	x = (x ^ (x >> 8)) & 0xff0000ff;
+	x = (x ^ (x >> 16)) & 0x000003ff;
+	return x;
+}
+
+
+// x and y are 16 bit cell coordinates
+LUMIX_FORCE_INLINE u32 mortonEncode(u32 x, u32 y)
+{
+	return mortonPart1By1(x) | (mortonPart1By1(y) << 1);
+}
+
+
+LUMIX_FORCE_INLINE void mortonDecode(u32 key, u32& x, u32& y)
+{
+	x = mortonCompact1By1(key);
+	y = mortonCompact1By1(key >> 1);
+}
+
+
+// x, y and z are 10 bit cell coordinates
+LUMIX_FORCE_INLINE u32 mortonEncode(u32 x, u32 y, u32 z)
+{
+	return mortonPart1By2(x) | (mortonPart1By2(y) << 1) | (mortonPart1By2(z) << 2);
+}
+
+
+LUMIX_FORCE_INLINE void mortonDecode(u32 key, u32& x, u32& y, u32& z)
+{
+	x = mortonCompact1By2(key);
+	y = mortonCompact1By2(key >> 1);
+	z = mortonCompact1By2(key >> 2);
+}
+
+#endif
+
+
+// hash grid over morton cell keys; values in one cell are chained through
+// indices into a pooled entry array, so insert and remove do not allocate
+// per element. Coordinates wrap at the 10 bit cell range, which only makes
+// distant cells share a bucket - callers compare positions anyway
+template <typename T>
+class SpatialHashGrid
+{
+public:
+	SpatialHashGrid(float cell_size, IAllocator& allocator)
+		: m_cells(allocator)
+		, m_entries(allocator)
+		, m_first_free(-1)
+		, m_cell_size(cell_size)
+	{
+	}
+
+
+	u32 getKey(const Vec3& pos) const
+	{
+		int x = int(floorf(pos.x / m_cell_size)) + 512;
+		int y = int(floorf(pos.y / m_cell_size)) + 512;
+		int z = int(floorf(pos.z / m_cell_size)) + 512;
+		return mortonEncode(u32(x) & 0x3ff, u32(y) & 0x3ff, u32(z) & 0x3ff);
+	}
+
+
+	void insert(const Vec3& pos, const T& value)
+	{
+		int idx;
+		if (m_first_free >= 0)
+		{
+			idx = m_first_free;
+			m_first_free = m_entries[idx].next;
+			m_entries[idx].value = value;
+		}
+		else
+		{
+			idx = m_entries.size();
+			Entry& entry = m_entries.emplace();
+			entry.value = value;
+		}
+		u32 key = getKey(pos);
+		auto iter = m_cells.find(key);
+		if (iter == m_cells.end())
+		{
+			m_entries[idx].next = -1;
+			m_cells.insert(key, idx);
+		}
+		else
+		{
+			m_entries[idx].next = iter.value();
+			iter.value() = idx;
+		}
+	}
+
+
+	bool remove(const Vec3& pos, const T& value)
+	{
+		u32 key = getKey(pos);
+		auto iter = m_cells.find(key);
+		if (iter == m_cells.end()) return false;
+		int idx = iter.value();
+		int prev = -1;
+		while (idx >= 0)
+		{
+			Entry& entry = m_entries[idx];
+			if (entry.value == value)
+			{
+				if (prev < 0)
+				{
+					if (entry.next < 0) m_cells.erase(iter);
+					else iter.value() = entry.next;
+				}
+				else
+				{
+					m_entries[prev].next = entry.next;
+				}
+				entry.next = m_first_free;
+				m_first_free = idx;
+				return true;
+			}
+			prev = idx;
+			idx = entry.next;
+		}
+		return false;
+	}
+
+
+	// calls f(value) for every value bucketed in the cell containing pos
+	template <typename F> void forEachInCell(const Vec3& pos, const F& f) const
+	{
+		u32 key = getKey(pos);
+		auto iter = m_cells.find(key);
+		if (iter == m_cells.end()) return;
+		int idx = iter.value();
+		while (idx >= 0)
+		{
+			const Entry& entry = m_entries[idx];
+			f(entry.value);
+			idx = entry.next;
+		}
+	}
+
+
+	// calls f(value) for every value bucketed in a cell overlapping the box
+	template <typename F> void forEachInBox(const Vec3& min, const Vec3& max, const F& f) const
+	{
+		float x0 = floorf(min.x / m_cell_size) * m_cell_size;
+		float y0 = floorf(min.y / m_cell_size) * m_cell_size;
+		float z0 = floorf(min.z / m_cell_size) * m_cell_size;
+		for (float z = z0; z <= max.z; z += m_cell_size)
+		{
+			for (float y = y0; y <= max.y; y += m_cell_size)
+			{
+				for (float x = x0; x <= max.x; x += m_cell_size)
+				{
+					forEachInCell(Vec3(x, y, z), f);
+				}
+			}
+		}
+	}
+
+
+	void clear()
+	{
+		m_cells.clear();
+		m_entries.clear();
+		m_first_free = -1;
+	}
+
+
+private:
+	struct Entry
+	{
+		T value;
+		int next;
+	};
+
+	HashMap<u32, int> m_cells;
+	Array<Entry> m_entries;
+	int m_first_free;
+	float m_cell_size;
+};
+
+
+} // namespace Lumix
@@ -1,5 +1,4 @@
 #include "engine/mt/atomic.h"
-#include <SDL_atomic.h>
 
 
 namespace Lumix
@@ -9,54 +8,46 @@ namespace MT
 
 i32 atomicIncrement(i32 volatile* value)
 {
-	ASSERT(false);
-	return *value++;
+	return __sync_fetch_and_add(value, 1) + 1;
 }
 
 i32 atomicDecrement(i32 volatile* value)
 {
-	ASSERT(false);
-	return *value--;
+	return __sync_fetch_and_sub(value, 1) - 1;
 }
 
 i32 atomicAdd(i32 volatile* addend, i32 value)
 {
-	ASSERT(false);
-	int tmp = *addend;
-	*addend += value;
-	return tmp;
+	return __sync_fetch_and_add(addend, value) + value;
 }
 
 i32 atomicSubtract(i32 volatile* addend, i32 value)
 {
-	ASSERT(false);
-	int tmp = *addend;
-	*addend -= value;
-	return tmp;
+	return __sync_fetch_and_sub(addend, value) - value;
 }
 
 bool compareAndExchange(i32 volatile* dest, i32 exchange, i32 comperand)
 {
-	ASSERT(false);
-	if (*dest != comperand) return false;
-	*dest = exchange;
-	return true;
+	return __sync_bool_compare_and_swap(dest, comperand, exchange);
 }
 
 bool compareAndExchange64(i64 volatile* dest, i64 exchange, i64 comperand)
 {
-	ASSERT(false);
-	if (*dest != comperand) return false;
-	*dest = exchange;
-	return true;
+	return __sync_bool_compare_and_swap(dest, comperand, exchange);
 }
 
 
 LUMIX_ENGINE_API void memoryBarrier()
 {
-	SDL_CompilerBarrier();
+	__sync_synchronize();
 }
 
 
-} // ~namespace MT
-} // ~namespace Lumix
+void pause()
+{
+	// wasm has no spin hint; spinners fall through to their yield/sleep path
+}
+
+
+} // namespace MT
+} // namespace Lumix
@@ -0,0 +1,42 @@
+#include "engine/mt/fiber.h"
+#include "engine/iallocator.h"
+
+
+namespace Lumix
+{
+namespace MT
+{
+namespace Fiber
+{
+
+
+// no fibers in emscripten; everything runs on the main thread anyway
+
+
+Handle initFromThread(IAllocator&)
+{
+	return INVALID_FIBER;
+}
+
+
+Handle create(int, FiberProc, void*, IAllocator&)
+{
+	ASSERT(false);
+	return INVALID_FIBER;
+}
+
+
+void destroy(Handle, IAllocator&)
+{
+}
+
+
+void switchTo(Handle, Handle)
+{
+	ASSERT(false);
+}
+
+
+} // namespace Fiber
+} // namespace MT
+} // namespace Lumix
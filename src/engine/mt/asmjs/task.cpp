@@ -3,6 +3,7 @@
 #include "engine/mt/task.h"
 #include "engine/mt/thread.h"
 #include "engine/profiler.h"
+#include <pthread.h>
 
 
 #if !LUMIX_SINGLE_THREAD()
@@ -16,11 +17,40 @@ namespace MT
 struct TaskImpl
 {
 	IAllocator& allocator;
+	bool force_exit;
+	bool exited;
+	bool is_running;
+	pthread_t handle;
+	const char* thread_name;
+	u32 affinity_mask;
+	Task* owner;
 };
 
+static void* threadFunction(void* ptr)
+{
+	struct TaskImpl* impl = reinterpret_cast<TaskImpl*>(ptr);
+	setThreadName(getCurrentThreadID(), impl->thread_name);
+	Profiler::setThreadName(impl->thread_name);
+	u32 ret = 0xffffFFFF;
+	if (!impl->force_exit) ret = impl->owner->task();
+	impl->exited = true;
+	impl->is_running = false;
+
+	return nullptr;
+}
+
 Task::Task(IAllocator& allocator)
 {
-	m_implementation = LUMIX_NEW(allocator, TaskImpl) {allocator};
+	auto impl = LUMIX_NEW(allocator, TaskImpl) {allocator};
+
+	impl->is_running = false;
+	impl->force_exit = false;
+	impl->exited = false;
+	impl->thread_name = "";
+	impl->owner = this;
+	impl->affinity_mask = getThreadAffinityMask();
+
+	m_implementation = impl;
 }
 
 Task::~Task()
@@ -30,40 +60,45 @@ Task::~Task()
 
 bool Task::create(const char* name)
 {
-	ASSERT(false);
-	return false;
+	pthread_attr_t attr;
+	int res = pthread_attr_init(&attr);
+	ASSERT(res == 0);
+	if (res != 0) return false;
+	res = pthread_create(&m_implementation->handle, &attr, threadFunction, m_implementation);
+	ASSERT(res == 0);
+	if (res != 0) return false;
+	return true;
 }
 
 bool Task::destroy()
 {
-	ASSERT(false);
-	return false;
+	return pthread_join(m_implementation->handle, nullptr) == 0;
 }
 
 void Task::setAffinityMask(u32 affinity_mask)
 {
-	ASSERT(false);
+	// web workers cannot be pinned; the mask is kept for symmetry only
+	m_implementation->affinity_mask = affinity_mask;
 }
 
 u32 Task::getAffinityMask() const
 {
-	ASSERT(false);
-	return 0;
+	return m_implementation->affinity_mask;
 }
 
 bool Task::isRunning() const
 {
-	return false;
+	return m_implementation->is_running;
 }
 
 bool Task::isFinished() const
 {
-	return false;
+	return m_implementation->exited;
 }
 
 bool Task::isForceExit() const
 {
-	return false;
+	return m_implementation->force_exit;
 }
 
 IAllocator& Task::getAllocator()
@@ -73,7 +108,12 @@ IAllocator& Task::getAllocator()
 
 void Task::forceExit(bool wait)
 {
-	ASSERT(false);
+	m_implementation->force_exit = true;
+
+	if (wait)
+	{
+		pthread_join(m_implementation->handle, nullptr);
+	}
 }
 
 } // namespace MT
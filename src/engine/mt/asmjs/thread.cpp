@@ -1,7 +1,8 @@
 #include "engine/lumix.h"
 #include "engine/mt/thread.h"
-#include <SDL_cpuinfo.h>
-#include <SDL_timer.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 
 
 namespace Lumix
@@ -12,28 +13,38 @@ namespace MT
 
 void sleep(u32 milliseconds)
 {
-	SDL_Delay(milliseconds);
+	if (milliseconds) usleep(useconds_t(milliseconds * 1000));
 }
 
+
+void yield()
+{
+	sched_yield();
+}
+
+
 u32 getCPUsCount()
 {
-	return 1;
+	// navigator.hardwareConcurrency behind the libc shim
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (u32)count : 1;
 }
 
-u32 getCurrentThreadID()
+ThreadID getCurrentThreadID()
 {
-	return 0;
+	return pthread_self();
 }
 
-u32 getProccessAffinityMask()
+u32 getThreadAffinityMask()
 {
+	// web workers cannot be pinned to cores
 	return 0;
 }
 
 
-void setThreadName(u32 /*thread_id*/, const char* /*thread_name*/)
+void setThreadName(ThreadID thread_id, const char* thread_name)
 {
-	ASSERT(false);
+	// thread names only show up in native debuggers; nothing to do here
 }
 
 
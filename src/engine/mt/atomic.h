@@ -16,6 +16,8 @@ LUMIX_ENGINE_API i32 atomicSubtract(i32 volatile* addend,
 LUMIX_ENGINE_API bool compareAndExchange(i32 volatile* dest, i32 exchange, i32 comperand);
 LUMIX_ENGINE_API bool compareAndExchange64(i64 volatile* dest, i64 exchange, i64 comperand);
 LUMIX_ENGINE_API void memoryBarrier();
+// hints the core we are in a spin-wait loop (x86 PAUSE); cheaper than yield()
+LUMIX_ENGINE_API void pause();
 
 
 } // ~namespace MT
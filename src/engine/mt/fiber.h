@@ -0,0 +1,38 @@
+#pragma once
+
+#include "engine/lumix.h"
+
+
+namespace Lumix
+{
+
+class IAllocator;
+
+namespace MT
+{
+namespace Fiber
+{
+
+
+// Stackful coroutines: a fiber suspends by switching to another fiber and
+// resumes exactly where it left off, so long waits (async file IO, shader
+// compilation) can give the worker thread back instead of blocking it. A
+// thread must convert itself with initFromThread() before it can switch to
+// fibers, and a fiber's proc must switch away before returning - falling off
+// the end of a fiber is undefined.
+
+struct FiberImpl;
+typedef FiberImpl* Handle;
+typedef void (*FiberProc)(void* parameter);
+
+const Handle INVALID_FIBER = nullptr;
+
+LUMIX_ENGINE_API Handle initFromThread(IAllocator& allocator);
+LUMIX_ENGINE_API Handle create(int stack_size, FiberProc proc, void* parameter, IAllocator& allocator);
+LUMIX_ENGINE_API void destroy(Handle fiber, IAllocator& allocator);
+LUMIX_ENGINE_API void switchTo(Handle from, Handle to);
+
+
+} // namespace Fiber
+} // namespace MT
+} // namespace Lumix
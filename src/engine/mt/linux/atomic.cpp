@@ -43,5 +43,11 @@ LUMIX_ENGINE_API void memoryBarrier()
 }
 
 
+void pause()
+{
+	__builtin_ia32_pause();
+}
+
+
 } // ~namespace MT
 } // ~namespace Lumix
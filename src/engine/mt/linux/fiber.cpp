@@ -0,0 +1,77 @@
+#include "engine/mt/fiber.h"
+#include "engine/iallocator.h"
+#include <ucontext.h>
+
+
+namespace Lumix
+{
+namespace MT
+{
+namespace Fiber
+{
+
+
+struct FiberImpl
+{
+	ucontext_t context;
+	void* stack;
+	FiberProc proc;
+	void* parameter;
+};
+
+
+static void trampoline(u32 lo, u32 hi)
+{
+	// makecontext only forwards ints, so the pointer travels as two halves
+	FiberImpl* fiber = (FiberImpl*)(((u64)hi << 32) | lo);
+	fiber->proc(fiber->parameter);
+}
+
+
+Handle initFromThread(IAllocator& allocator)
+{
+	FiberImpl* fiber = LUMIX_NEW(allocator, FiberImpl);
+	fiber->stack = nullptr;
+	fiber->proc = nullptr;
+	fiber->parameter = nullptr;
+	getcontext(&fiber->context);
+	return fiber;
+}
+
+
+Handle create(int stack_size, FiberProc proc, void* parameter, IAllocator& allocator)
+{
+	FiberImpl* fiber = LUMIX_NEW(allocator, FiberImpl);
+	fiber->stack = allocator.allocate(stack_size);
+	fiber->proc = proc;
+	fiber->parameter = parameter;
+	getcontext(&fiber->context);
+	fiber->context.uc_stack.ss_sp = fiber->stack;
+	fiber->context.uc_stack.ss_size = stack_size;
+	fiber->context.uc_link = nullptr;
+	makecontext(&fiber->context,
+		(void (*)())trampoline,
+		2,
+		(u32)(uintptr)fiber,
+		(u32)((uintptr)fiber >> 32));
+	return fiber;
+}
+
+
+void destroy(Handle fiber, IAllocator& allocator)
+{
+	if (!fiber) return;
+	allocator.deallocate(fiber->stack);
+	LUMIX_DELETE(allocator, fiber);
+}
+
+
+void switchTo(Handle from, Handle to)
+{
+	swapcontext(&from->context, &to->context);
+}
+
+
+} // namespace Fiber
+} // namespace MT
+} // namespace Lumix
@@ -118,16 +118,17 @@ namespace Lumix
 
 			T* pop(bool wait)
 			{
-				bool can_read = wait ? m_data_signal.wait(), wait : m_data_signal.poll();
-
-				if (isAborted())
+				for (;;)
 				{
-					return nullptr;
-				}
+					if (isAborted())
+					{
+						return nullptr;
+					}
 
-				while (can_read)
-				{
-					if (m_rd != m_wr)
+					// fast path: data already queued is taken without touching
+					// the semaphore; the count it leaves behind only causes a
+					// spurious wakeup of a later waiting pop
+					while (m_rd != m_wr)
 					{
 						i32 cur_read_idx = m_rd;
 						i32 idx = cur_read_idx & (size - 1);
@@ -145,9 +146,13 @@ namespace Lumix
 							}
 						}
 					}
-				}
 
-				return nullptr;
+					if (!wait)
+					{
+						return nullptr;
+					}
+					m_data_signal.wait();
+				}
 			}
 
 
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "engine/mt/atomic.h"
+
+
+namespace Lumix
+{
+	namespace MT
+	{
+		// Bounded multi-producer multi-consumer queue based on per-cell
+		// sequence numbers (Vyukov). Push and pop are lock-free and never touch
+		// a kernel object; batch variants amortize the per-call overhead when
+		// moving many items at once. size must be a power of two.
+		template <class T, i32 size>
+		class MPMCQueue
+		{
+		public:
+			MPMCQueue()
+				: m_wr(0)
+				, m_rd(0)
+			{
+				static_assert((size & (size - 1)) == 0, "size must be a power of two");
+				for (i32 i = 0; i < size; ++i)
+				{
+					m_cells[i].sequence = i;
+				}
+			}
+
+
+			bool push(const T& item)
+			{
+				Cell* cell;
+				i32 pos = m_wr;
+				for (;;)
+				{
+					cell = &m_cells[pos & (size - 1)];
+					i32 seq = cell->sequence;
+					i32 dif = seq - pos;
+					if (dif == 0)
+					{
+						if (compareAndExchange(&m_wr, pos + 1, pos)) break;
+						pos = m_wr;
+					}
+					else if (dif < 0)
+					{
+						return false;
+					}
+					else
+					{
+						pos = m_wr;
+					}
+				}
+				cell->data = item;
+				memoryBarrier();
+				cell->sequence = pos + 1;
+				return true;
+			}
+
+
+			bool pop(T& item)
+			{
+				Cell* cell;
+				i32 pos = m_rd;
+				for (;;)
+				{
+					cell = &m_cells[pos & (size - 1)];
+					i32 seq = cell->sequence;
+					i32 dif = seq - (pos + 1);
+					if (dif == 0)
+					{
+						if (compareAndExchange(&m_rd, pos + 1, pos)) break;
+						pos = m_rd;
+					}
+					else if (dif < 0)
+					{
+						return false;
+					}
+					else
+					{
+						pos = m_rd;
+					}
+				}
+				item = cell->data;
+				memoryBarrier();
+				cell->sequence = pos + size;
+				return true;
+			}
+
+
+			// pushes up to count items, returns how many fit
+			i32 pushBatch(const T* items, i32 count)
+			{
+				i32 pushed = 0;
+				while (pushed < count && push(items[pushed]))
+				{
+					++pushed;
+				}
+				return pushed;
+			}
+
+
+			// pops up to max_count items, returns how many were available
+			i32 popBatch(T* items, i32 max_count)
+			{
+				i32 popped = 0;
+				while (popped < max_count && pop(items[popped]))
+				{
+					++popped;
+				}
+				return popped;
+			}
+
+
+			bool isEmpty() const { return m_rd == m_wr; }
+
+
+		private:
+			struct Cell
+			{
+				volatile i32 sequence;
+				T data;
+			};
+
+			MPMCQueue(const MPMCQueue&);
+			void operator=(const MPMCQueue&);
+
+		private:
+			Cell m_cells[size];
+			volatile i32 m_wr;
+			volatile i32 m_rd;
+		};
+	} // namespace MT
+} // namespace Lumix
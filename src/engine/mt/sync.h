@@ -1,6 +1,7 @@
 #pragma once
 #include "engine/lumix.h"
-#ifdef __linux__
+#include "engine/mt/atomic.h"
+#if defined __linux__ || defined __EMSCRIPTEN__
 	#include <pthread.h>
 #endif
 
@@ -15,7 +16,7 @@ namespace MT
 	typedef void* MutexHandle;
 	typedef void* EventHandle;
 	typedef volatile i32 SpinMutexHandle;
-#elif defined __linux__
+#elif defined __linux__ || defined __EMSCRIPTEN__
 	struct SemaphoreHandle
 	{
 		pthread_mutex_t mutex;
@@ -83,6 +84,215 @@ private:
 };
 
 
+// many concurrent readers or one writer; the writer flag is checked before
+// and after the reader count goes up, so readers back off while a write is
+// pending and a steady stream of reads cannot starve a publish
+class RWLock
+{
+public:
+	RWLock()
+		: m_readers(0)
+		, m_writer(0)
+	{
+	}
+
+	void lockRead()
+	{
+		for (;;)
+		{
+			while (m_writer)
+			{
+				pause();
+			}
+			atomicIncrement(&m_readers);
+			if (!m_writer) return;
+			atomicDecrement(&m_readers);
+		}
+	}
+
+	void unlockRead() { atomicDecrement(&m_readers); }
+
+	void lockWrite()
+	{
+		while (!compareAndExchange(&m_writer, 1, 0))
+		{
+			pause();
+		}
+		while (m_readers)
+		{
+			pause();
+		}
+		memoryBarrier();
+	}
+
+	void unlockWrite()
+	{
+		memoryBarrier();
+		m_writer = 0;
+	}
+
+private:
+	RWLock(const RWLock&);
+	void operator=(const RWLock&);
+
+	volatile i32 m_readers;
+	volatile i32 m_writer;
+};
+
+
+class ReadLock
+{
+public:
+	ReadLock(RWLock& lock)
+		: m_lock(lock)
+	{
+		lock.lockRead();
+	}
+	~ReadLock() { m_lock.unlockRead(); }
+
+private:
+	ReadLock(const ReadLock&);
+	void operator=(const ReadLock&);
+	RWLock& m_lock;
+};
+
+
+class WriteLock
+{
+public:
+	WriteLock(RWLock& lock)
+		: m_lock(lock)
+	{
+		lock.lockWrite();
+	}
+	~WriteLock() { m_lock.unlockWrite(); }
+
+private:
+	WriteLock(const WriteLock&);
+	void operator=(const WriteLock&);
+	RWLock& m_lock;
+};
+
+
+// spins briefly with PAUSE, then parks on a semaphore. Unlike SpinMutex this
+// never burns a core while the lock is held for more than a few instructions,
+// so prefer it for anything that can be contended across many threads
+class AdaptiveMutex
+{
+public:
+	explicit AdaptiveMutex(bool locked)
+		: m_state(0)
+		, m_park_signal(0, 0x7fffFFFF)
+	{
+		if (locked)
+		{
+			lock();
+		}
+	}
+
+	void lock()
+	{
+		if (compareAndExchange(&m_state, LOCKED, UNLOCKED))
+		{
+			memoryBarrier();
+			return;
+		}
+
+		for (int i = 0; i < SPIN_COUNT; ++i)
+		{
+			if (m_state == UNLOCKED && compareAndExchange(&m_state, LOCKED, UNLOCKED))
+			{
+				memoryBarrier();
+				return;
+			}
+			pause();
+		}
+
+		for (;;)
+		{
+			i32 state = m_state;
+			if (state == UNLOCKED)
+			{
+				// grab it as CONTENDED; we cannot know whether other parked
+				// threads still need the wakeup from our unlock
+				if (compareAndExchange(&m_state, CONTENDED, UNLOCKED))
+				{
+					memoryBarrier();
+					return;
+				}
+			}
+			else if (state == LOCKED)
+			{
+				compareAndExchange(&m_state, CONTENDED, LOCKED);
+			}
+			else
+			{
+				m_park_signal.wait();
+			}
+		}
+	}
+
+	bool poll()
+	{
+		if (compareAndExchange(&m_state, LOCKED, UNLOCKED))
+		{
+			memoryBarrier();
+			return true;
+		}
+		return false;
+	}
+
+	void unlock()
+	{
+		memoryBarrier();
+		for (;;)
+		{
+			i32 state = m_state;
+			if (compareAndExchange(&m_state, UNLOCKED, state))
+			{
+				if (state == CONTENDED)
+				{
+					m_park_signal.signal();
+				}
+				return;
+			}
+		}
+	}
+
+private:
+	enum
+	{
+		UNLOCKED = 0,
+		LOCKED = 1,
+		CONTENDED = 2,
+		SPIN_COUNT = 40
+	};
+
+	AdaptiveMutex(const AdaptiveMutex&);
+	void operator=(const AdaptiveMutex&);
+
+	volatile i32 m_state;
+	Semaphore m_park_signal;
+};
+
+
+class AdaptiveMutexLock
+{
+public:
+	AdaptiveMutexLock(AdaptiveMutex& mutex)
+		: m_mutex(mutex)
+	{
+		mutex.lock();
+	}
+	~AdaptiveMutexLock() { m_mutex.unlock(); }
+
+private:
+	AdaptiveMutexLock(const AdaptiveMutexLock&);
+	void operator=(const AdaptiveMutexLock&);
+	AdaptiveMutex& m_mutex;
+};
+
+
 class SpinLock
 {
 public:
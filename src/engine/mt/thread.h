@@ -2,7 +2,7 @@
 
 #include "engine/lumix.h"
 
-#ifdef __linux__
+#if defined __linux__ || defined __EMSCRIPTEN__
 	#include <pthread.h>
 #endif
 
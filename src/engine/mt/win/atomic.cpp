@@ -53,5 +53,11 @@ LUMIX_ENGINE_API void memoryBarrier()
 }
 
 
+void pause()
+{
+	_mm_pause();
+}
+
+
 } // ~namespace MT
 } // ~namespace Lumix
@@ -0,0 +1,76 @@
+#include "engine/mt/fiber.h"
+#include "engine/iallocator.h"
+#include "engine/win/simple_win.h"
+
+
+namespace Lumix
+{
+namespace MT
+{
+namespace Fiber
+{
+
+
+struct FiberImpl
+{
+	void* handle;
+	FiberProc proc;
+	void* parameter;
+	bool is_thread_fiber;
+};
+
+
+static void __stdcall trampoline(void* parameter)
+{
+	FiberImpl* fiber = (FiberImpl*)parameter;
+	fiber->proc(fiber->parameter);
+}
+
+
+Handle initFromThread(IAllocator& allocator)
+{
+	FiberImpl* fiber = LUMIX_NEW(allocator, FiberImpl);
+	fiber->proc = nullptr;
+	fiber->parameter = nullptr;
+	fiber->is_thread_fiber = true;
+	fiber->handle = ConvertThreadToFiber(nullptr);
+	return fiber;
+}
+
+
+Handle create(int stack_size, FiberProc proc, void* parameter, IAllocator& allocator)
+{
+	FiberImpl* fiber = LUMIX_NEW(allocator, FiberImpl);
+	fiber->proc = proc;
+	fiber->parameter = parameter;
+	fiber->is_thread_fiber = false;
+	fiber->handle = CreateFiber(stack_size, trampoline, fiber);
+	return fiber;
+}
+
+
+void destroy(Handle fiber, IAllocator& allocator)
+{
+	if (!fiber) return;
+	if (fiber->is_thread_fiber)
+	{
+		ConvertFiberToThread();
+	}
+	else
+	{
+		DeleteFiber(fiber->handle);
+	}
+	LUMIX_DELETE(allocator, fiber);
+}
+
+
+void switchTo(Handle from, Handle to)
+{
+	(void)from;
+	SwitchToFiber(to->handle);
+}
+
+
+} // namespace Fiber
+} // namespace MT
+} // namespace Lumix
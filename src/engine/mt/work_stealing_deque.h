@@ -0,0 +1,85 @@
+#pragma once
+
+#include "engine/mt/atomic.h"
+
+
+namespace Lumix
+{
+	namespace MT
+	{
+		// Bounded work-stealing deque (Chase-Lev). The owning thread pushes and
+		// pops at the bottom without contention; other threads steal from the
+		// top with a CAS. size must be a power of two.
+		template <class T, i32 size>
+		class WorkStealingDeque
+		{
+		public:
+			WorkStealingDeque()
+				: m_top(0)
+				, m_bottom(0)
+			{
+				static_assert((size & (size - 1)) == 0, "size must be a power of two");
+			}
+
+
+			// owner thread only
+			bool push(const T& item)
+			{
+				i32 b = m_bottom;
+				i32 t = m_top;
+				if (b - t >= size) return false;
+				m_items[b & (size - 1)] = item;
+				memoryBarrier();
+				m_bottom = b + 1;
+				return true;
+			}
+
+
+			// owner thread only
+			bool pop(T& item)
+			{
+				i32 b = m_bottom - 1;
+				m_bottom = b;
+				memoryBarrier();
+				i32 t = m_top;
+				if (t > b)
+				{
+					m_bottom = t;
+					return false;
+				}
+				item = m_items[b & (size - 1)];
+				if (t != b) return true;
+
+				// last item; race the thieves for it
+				bool won = compareAndExchange(&m_top, t + 1, t);
+				m_bottom = t + 1;
+				return won;
+			}
+
+
+			// any thread
+			bool steal(T& item)
+			{
+				i32 t = m_top;
+				memoryBarrier();
+				i32 b = m_bottom;
+				if (t >= b) return false;
+				item = m_items[t & (size - 1)];
+				return compareAndExchange(&m_top, t + 1, t);
+			}
+
+
+			bool isEmpty() const { return m_top >= m_bottom; }
+
+
+		private:
+			WorkStealingDeque(const WorkStealingDeque&);
+			void operator=(const WorkStealingDeque&);
+
+		private:
+			volatile i32 m_top;
+			volatile i32 m_bottom;
+			T m_items[size];
+		};
+	} // namespace MT
+} // namespace Lumix
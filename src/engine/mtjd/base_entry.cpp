@@ -1,6 +1,7 @@
 #include "engine/lumix.h"
 #include "engine/mtjd/base_entry.h"
 
+#include "engine/mt/sync.h"
 #include "engine/mtjd/manager.h"
 
 namespace Lumix
@@ -0,0 +1,85 @@
+#pragma once
+
+
+#include "job.h"
+#include "group.h"
+#include "manager.h"
+
+
+namespace Lumix
+{
+
+
+namespace MTJD
+{
+
+
+template <class T> class ForEachJob LUMIX_FINAL : public MTJD::Job
+{
+public:
+	ForEachJob(MTJD::Manager& manager, const T& function, int from, int to, IAllocator& allocator)
+		: MTJD::Job(Job::AUTO_DESTROY, MTJD::Priority::Normal, manager, allocator, manager.getJobAllocator())
+		, m_function(function)
+		, m_from(from)
+		, m_to(to)
+	{
+		setJobName("forEach");
+	}
+
+	void execute() override { m_function(m_from, m_to); }
+
+private:
+	const T& m_function;
+	int m_from;
+	int m_to;
+};
+
+
+// Calls function(sub_from, sub_to) over subranges of [from, to) on the worker
+// threads and blocks until the whole range is done. grain <= 0 picks a chunk
+// size giving every worker several chunks, so uneven per-item cost balances
+// out through stealing. The calling thread processes the first chunk itself;
+// jobs come from the manager's pool allocator, so a hot loop recycles the
+// same few blocks every frame.
+template <class T>
+void forEach(MTJD::Manager& manager, IAllocator& allocator, int from, int to, int grain, const T& function)
+{
+	int count = to - from;
+	if (count <= 0) return;
+
+	int workers_count = (int)manager.getCpuThreadsCount();
+	if (grain <= 0)
+	{
+		enum { CHUNKS_PER_WORKER = 4 };
+		grain = count / (workers_count * CHUNKS_PER_WORKER);
+		if (grain < 1) grain = 1;
+	}
+
+	if (workers_count < 2 || count <= grain)
+	{
+		function(from, to);
+		return;
+	}
+
+	Group sync_point(true, allocator);
+	int first_end = from + grain < to ? from + grain : to;
+	int begin = first_end;
+	while (begin < to)
+	{
+		int end = begin + grain < to ? begin + grain : to;
+		ForEachJob<T>* job =
+			LUMIX_NEW(manager.getJobAllocator(), ForEachJob<T>)(manager, function, begin, end, allocator);
+		job->addDependency(&sync_point);
+		manager.schedule(job);
+		begin = end;
+	}
+
+	function(from, first_end);
+	sync_point.sync();
+}
+
+
+} // namespace MTJD
+
+
+} // namespace Lumix
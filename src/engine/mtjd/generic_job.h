@@ -16,8 +16,8 @@ namespace MTJD
 template <class T> class GenericJob LUMIX_FINAL : public MTJD::Job
 {
 public:
-	GenericJob(MTJD::Manager& manager, T function, IAllocator& allocator)
-		: MTJD::Job(Job::AUTO_DESTROY, MTJD::Priority::Normal, manager, allocator, allocator)
+	GenericJob(MTJD::Manager& manager, T function, IAllocator& allocator, Priority priority)
+		: MTJD::Job(Job::AUTO_DESTROY, priority, manager, allocator, allocator)
 		, m_function(function)
 	{
 	}
@@ -29,9 +29,10 @@ private:
 };
 
 
-template <class T> MTJD::Job* makeJob(MTJD::Manager& manager, T function, IAllocator& allocator)
+template <class T>
+MTJD::Job* makeJob(MTJD::Manager& manager, T function, IAllocator& allocator, Priority priority = Priority::Default)
 {
-	return LUMIX_NEW(allocator, GenericJob<T>)(manager, function, allocator);
+	return LUMIX_NEW(allocator, GenericJob<T>)(manager, function, allocator, priority);
 }
 
 
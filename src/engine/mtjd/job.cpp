@@ -1,6 +1,7 @@
 #include "engine/lumix.h"
 #include "engine/mtjd/job.h"
 
+#include "engine/mt/atomic.h"
 #include "engine/mtjd/manager.h"
 
 namespace Lumix
@@ -15,6 +16,7 @@ Job::Job(int flags,
 	: BaseEntry(1, (flags & SYNC_EVENT) != 0, allocator)
 	, m_manager(manager)
 	, m_priority(priority)
+	, m_affinity_mask(ANY_WORKER)
 	, m_auto_destroy((flags & AUTO_DESTROY) != 0)
 	, m_scheduled(false)
 	, m_executed(false)
@@ -22,6 +22,8 @@ public:
 		AUTO_DESTROY = 1 << 1
 	};
 
+	static const u32 ANY_WORKER = 0xffffFFFF;
+
 public:
 	Job(int flags,
 		Priority priority,
@@ -35,6 +37,20 @@ public:
 
 	Priority getPriority() const { return m_priority; }
 
+	// workers whose index bit is set may run this job; advisory - set it
+	// before scheduling. Defaults to ANY_WORKER.
+	void setAffinityMask(u32 affinity_mask) { m_affinity_mask = affinity_mask; }
+	u32 getAffinityMask() const { return m_affinity_mask; }
+
+	// Continuation: holds next's dependency count until this job finishes,
+	// at which point next auto-schedules on a worker. Do not schedule next
+	// manually. Returns next, so chains read a->then(b)->then(c).
+	Job* then(Job* next)
+	{
+		addDependency(next);
+		return next;
+	}
+
 protected:
 	virtual void execute() = 0;
 	virtual void onExecuted();
@@ -43,6 +59,7 @@ protected:
 
 	Manager& m_manager;
 	Priority m_priority;
+	u32 m_affinity_mask;
 	bool m_auto_destroy;
 	bool m_scheduled;
 	bool m_executed;
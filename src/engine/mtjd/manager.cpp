@@ -1,11 +1,15 @@
 #include "engine/lumix.h"
 #include "engine/mtjd/manager.h"
 
+#include "engine/array.h"
 #include "engine/mtjd/job.h"
-#include "engine/mtjd/scheduler.h"
 #include "engine/mtjd/worker_thread.h"
 
+#include "engine/mt/atomic.h"
+#include "engine/mt/mpmc_queue.h"
+#include "engine/mt/sync.h"
 #include "engine/mt/thread.h"
+#include "engine/pool_allocator.h"
 
 namespace Lumix
 {
@@ -15,54 +19,41 @@ namespace MTJD
 
 struct ManagerImpl LUMIX_FINAL : public Manager
 {
-	typedef MT::LockFreeFixedQueue<Job*, 512>	JobsTable;
-	typedef Array<JobTrans*>					TransTable;
-
-
 	ManagerImpl(IAllocator& allocator)
-		: m_scheduling_counter(0)
+		: m_worker_tasks(allocator)
+		, m_allocator(allocator)
+		, m_job_allocator(allocator)
 		#if !LUMIX_SINGLE_THREAD()
-			, m_scheduler(*this, allocator)
+			, m_work_signal(0, 0x7fffFFFF)
+			, m_aborted(false)
 		#endif
-		, m_worker_tasks(allocator)
-		, m_allocator(allocator)
-		, m_pending_trans(allocator)
 	{
 #if !LUMIX_SINGLE_THREAD()
 		u32 threads_num = getCpuThreadsCount();
 
-		m_scheduler.create("MTJD::Scheduler");
-
 		m_worker_tasks.reserve(threads_num);
 		for (u32 i = 0; i < threads_num; ++i)
 		{
 			auto& task = m_worker_tasks.emplace(m_allocator);
-			task.create("MTJD::WorkerTask", this, &m_trans_queue);
+			task.create("MTJD::WorkerTask", this, i);
 			task.setAffinityMask(getAffinityMask(i));
 		}
-
 #endif
 	}
 
 	~ManagerImpl()
 	{
 #if !LUMIX_SINGLE_THREAD()
-
-		u32 threads_num = getCpuThreadsCount();
-		for (u32 i = 0; i < threads_num; ++i)
+		m_aborted = true;
+		for (int i = 0; i < m_worker_tasks.size(); ++i)
 		{
-			m_trans_queue.abort();
+			m_work_signal.signal();
 		}
 
 		for (auto& task : m_worker_tasks)
 		{
 			task.destroy();
 		}
-
-		m_scheduler.forceExit(false);
-		m_scheduler.dataSignal();
-		m_scheduler.destroy();
-
 #endif
 	}
 
@@ -92,9 +83,36 @@ struct ManagerImpl LUMIX_FINAL : public Manager
 		{
 			job->m_scheduled = true;
 
-			pushReadyJob(job);
+			int lane = (int)job->getPriority();
+			if (lane < 0 || lane >= (int)Priority::Count) lane = (int)Priority::Default;
+
+			// frame-priority work scheduled by a worker goes to its own deque
+			// (LIFO, cache-warm); everything else lands in the lane matching
+			// its priority, where workers pick it up or steal it
+			if ((int)Priority::Default == lane && Job::ANY_WORKER == job->getAffinityMask())
+			{
+				MT::ThreadID thread_id = MT::getCurrentThreadID();
+				for (auto& task : m_worker_tasks)
+				{
+					if (task.m_thread_id != thread_id) continue;
+					if (task.m_deque.push(job))
+					{
+						m_work_signal.signal();
+						return;
+					}
+					break;
+				}
+			}
+
+			if (m_lanes[lane].push(job))
+			{
+				m_work_signal.signal();
+				return;
+			}
 
-			m_scheduler.dataSignal();
+			// everything is full; the caller runs the ready job itself
+			job->execute();
+			job->onExecuted();
 		}
 
 #else
@@ -105,114 +123,72 @@ struct ManagerImpl LUMIX_FINAL : public Manager
 #endif
 	}
 
-	void scheduleCpu(Job* job)
+
+	IAllocator& getJobAllocator() override
 	{
-		JobTrans* tr = m_trans_queue.alloc(false);
-		if (tr)
-		{
-			tr->data = job;
-			if (!m_trans_queue.push(tr, false))
-			{
-				m_trans_queue.dealoc(tr);
-				pushReadyJob(job);
-			}
-			else
-			{
-				m_pending_trans.push(tr);
-			}
-		}
+		return m_job_allocator;
 	}
 
-	void doScheduling() override
+
+	Job* getReadyJob(u32 worker_index) override
 	{
 #if !LUMIX_SINGLE_THREAD()
-
-		u32 count = MT::atomicIncrement(&m_scheduling_counter);
-		if (1 == count)
+		Job* job;
+		// lanes drain strictly in priority order at job boundaries, so
+		// background work runs only when no higher-priority job is waiting
+		for (int lane = 0; lane < (int)Priority::Count; ++lane)
 		{
-			do
-			{
-				for (int i = 0; i < m_pending_trans.size();)
-				{
-					JobTrans* tr = m_pending_trans[i];
-					if (tr->isCompleted())
-					{
-						tr->data->onExecuted();
-						m_trans_queue.dealoc(tr);
-						m_pending_trans.eraseFast(i);
-					}
-					else
-					{
-						++i;
-					}
-				}
-
-				Job* job = getNextReadyJob();
-				if (job)
-				{
-					scheduleCpu(job);
-				}
+			if (!m_lanes[lane].pop(job)) continue;
+			if (job->getAffinityMask() & (1 << worker_index)) return job;
 
-				count = MT::atomicDecrement(&m_scheduling_counter);
-			} while (0 < count);
+			// some other worker's job; requeue it and look further
+			while (!m_lanes[lane].push(job)) MT::yield();
+			m_work_signal.signal();
 		}
 
-#endif
-	}
-
-	Job* getNextReadyJob()
-	{
-#if !LUMIX_SINGLE_THREAD()
-
-		for (i32 i = 0; i < (i32)Priority::Count; ++i)
+		int workers_count = m_worker_tasks.size();
+		for (int i = 1; i < workers_count; ++i)
 		{
-			if (!m_ready_to_execute[i].isEmpty())
-			{
-				Job** entry = m_ready_to_execute[i].pop(true);
-				Job* ret = *entry;
-				m_ready_to_execute[i].dealoc(entry);
-
-				return ret;
-			}
+			WorkerTask& victim = m_worker_tasks[(worker_index + i) % workers_count];
+			if (victim.m_deque.steal(job)) return job;
 		}
-
 #endif
-
 		return nullptr;
 	}
 
-	void pushReadyJob(Job* job)
-	{
-		ASSERT(job);
 
+	bool isAborted() const override
+	{
 #if !LUMIX_SINGLE_THREAD()
+		return m_aborted;
+#else
+		return true;
+#endif
+	}
 
-		Job** jobEntry = m_ready_to_execute[(i32)job->getPriority()].alloc(true);
-		if (jobEntry)
-		{
-			*jobEntry = job;
-			m_ready_to_execute[(i32)job->getPriority()].push(jobEntry, true);
-		}
 
+	void waitForWork() override
+	{
+#if !LUMIX_SINGLE_THREAD()
+		m_work_signal.wait();
 #endif
 	}
 
+
 	u32 getAffinityMask(u32) const
 	{
 		return MT::getThreadAffinityMask();
 	}
 
 	IAllocator&			m_allocator;
-	JobsTable			m_ready_to_execute[(size_t)Priority::Count];
-	JobTransQueue		m_trans_queue;
-	TransTable			m_pending_trans;
+	PoolAllocator		m_job_allocator;
 	Array<WorkerTask>	m_worker_tasks;
 	#if !LUMIX_SINGLE_THREAD()
-		Scheduler			m_scheduler;
+		MT::MPMCQueue<Job*, 512> m_lanes[(int)Priority::Count];
+		MT::Semaphore	m_work_signal;
+		volatile bool	m_aborted;
 	#endif
 
-	volatile i32 m_scheduling_counter;
-
 
 }; // struct ManagerImpl
 
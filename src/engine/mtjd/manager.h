@@ -1,12 +1,16 @@
 #pragma once
 
 
-#include "engine/mt/lock_free_fixed_queue.h"
-#include "engine/mt/transaction.h"
+#include "engine/lumix.h"
 
 
 namespace Lumix
 {
+
+
+class IAllocator;
+
+
 namespace MTJD
 {
 
@@ -17,21 +21,24 @@ class WorkerTask;
 
 class LUMIX_ENGINE_API Manager
 {
-	friend class Scheduler;
 	friend class WorkerTask;
 
 public:
-	typedef MT::Transaction<Job*> JobTrans;
-	typedef MT::LockFreeFixedQueue<JobTrans, 32> JobTransQueue;
-
 	virtual ~Manager() {}
 
 	virtual u32 getCpuThreadsCount() const = 0;
 	virtual void schedule(Job* job) = 0;
-	virtual void doScheduling() = 0;
+	virtual IAllocator& getJobAllocator() = 0;
 
 	static Manager* create(IAllocator& allocator);
 	static void destroy(Manager& manager);
+
+protected:
+	// worker-side interface: grab work from the shared inbox or another
+	// worker's deque, or go to sleep until something is scheduled
+	virtual Job* getReadyJob(u32 worker_index) = 0;
+	virtual bool isAborted() const = 0;
+	virtual void waitForWork() = 0;
 };
 
 
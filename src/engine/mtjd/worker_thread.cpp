@@ -12,6 +12,9 @@ namespace Lumix
 
 		WorkerTask::WorkerTask(IAllocator& allocator)
 			: Task(allocator)
+			, m_manager(nullptr)
+			, m_thread_id(0)
+			, m_index(0)
 		{
 		}
 
@@ -19,35 +22,38 @@ namespace Lumix
 		{
 		}
 
-		bool WorkerTask::create(const char* name, Manager* manager, Manager::JobTransQueue* trans_queue)
+		bool WorkerTask::create(const char* name, Manager* manager, u32 index)
 		{
 			ASSERT(manager);
-			ASSERT(trans_queue);
 
 			m_manager = manager;
-			m_trans_queue = trans_queue;
+			m_index = index;
 
 			return Task::create(name);
 		}
 
 		int WorkerTask::task()
 		{
-			ASSERT(m_trans_queue);
+			ASSERT(m_manager);
+			m_thread_id = MT::getCurrentThreadID();
 
-			while (!m_trans_queue->isAborted())
+			while (!m_manager->isAborted())
 			{
-				Manager::JobTrans* tr = m_trans_queue->pop(true);
-				if (!tr)
-					break;
+				Job* job;
+				if (!m_deque.pop(job)) job = m_manager->getReadyJob(m_index);
+				if (!job)
+				{
+					m_manager->waitForWork();
+					continue;
+				}
 
 				Profiler::beginBlock("WorkerTask");
-				Profiler::beginBlock(tr->data->getJobName());
-				tr->data->execute();
-				tr->setCompleted();
+				Profiler::beginBlock(job->getJobName());
+				job->execute();
 				Profiler::endBlock();
 				Profiler::endBlock();
 
-				m_manager->doScheduling();
+				job->onExecuted();
 			}
 
 			return 0;
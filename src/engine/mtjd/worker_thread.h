@@ -2,7 +2,8 @@
 
 
 #include "engine/mt/task.h"
-#include "engine/mt/lock_free_fixed_queue.h"
+#include "engine/mt/thread.h"
+#include "engine/mt/work_stealing_deque.h"
 
 #include "engine/mtjd/manager.h"
 
@@ -20,19 +21,29 @@ namespace MTJD
 {
 
 
+class Job;
+struct ManagerImpl;
+
+
 class WorkerTask LUMIX_FINAL : public MT::Task
 {
+	friend struct ManagerImpl;
+
 public:
-	WorkerTask(IAllocator& allocator);
+	typedef MT::WorkStealingDeque<Job*, 512> JobDeque;
+
+	explicit WorkerTask(IAllocator& allocator);
 	~WorkerTask();
 
-	bool create(const char* name, Manager* manager, Manager::JobTransQueue* trans_queue);
+	bool create(const char* name, Manager* manager, u32 index);
 
 	virtual int task();
 
 private:
-	Manager::JobTransQueue* m_trans_queue;
+	JobDeque m_deque;
+	volatile MT::ThreadID m_thread_id;
 	Manager* m_manager;
+	u32 m_index;
 };
 
 
@@ -40,4 +51,4 @@ private:
 } // namepsace Lumix
 
 
-#endif
\ No newline at end of file
+#endif
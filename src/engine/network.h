@@ -16,6 +16,14 @@ namespace Net
 
 
 class TCPStream;
+class TCPAcceptor;
+
+
+// blocks until one of the streams has data or a connection is pending on the
+// acceptor (which can be null); returns the index of the first ready stream,
+// -1 when the acceptor is ready, -2 on timeout; this is how one network
+// thread serves many connections without dedicating a thread to each
+LUMIX_ENGINE_API int waitForData(TCPStream** streams, int count, TCPAcceptor* acceptor, int timeout_ms);
 
 
 class LUMIX_ENGINE_API TCPAcceptor
@@ -26,9 +34,13 @@ public:
 
 	bool start(const char* ip, u16 port);
 	TCPStream* accept();
+	// returns nullptr when no connection is pending; never blocks
+	TCPStream* acceptPending();
 	void close(TCPStream* stream);
 
 private:
+	friend int waitForData(TCPStream**, int, TCPAcceptor*, int);
+
 	IAllocator& m_allocator;
 	uintptr m_socket;
 };
@@ -66,8 +78,12 @@ public:
 
 	bool read(void* buffer, size_t size);
 	bool write(const void* buffer, size_t size);
+	// true when at least one byte can be read without blocking
+	bool hasData() const;
 
 private:
+	friend int waitForData(TCPStream**, int, TCPAcceptor*, int);
+
 	TCPStream();
 
 	uintptr m_socket;
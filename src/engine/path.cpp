@@ -3,6 +3,7 @@
 
 #include "engine/blob.h"
 #include "engine/crc32.h"
+#include "engine/mt/atomic.h"
 #include "engine/mt/sync.h"
 #include "engine/path_utils.h"
 #include "engine/string.h"
@@ -15,10 +16,12 @@ namespace Lumix
 
 
 	PathManager::PathManager(Lumix::IAllocator& allocator)
-		: m_paths(allocator)
-		, m_mutex(false)
-		, m_allocator(allocator)
+		: m_allocator(allocator)
 	{
+		for (int i = 0; i < SHARDS_COUNT; ++i)
+		{
+			m_shards[i] = LUMIX_NEW(m_allocator, Shard)(m_allocator);
+		}
 		g_path_manager = this;
 		m_empty_path = getPath(0, "");
 	}
@@ -28,26 +31,39 @@ namespace Lumix
 	{
 		decrementRefCount(m_empty_path);
 		m_empty_path = nullptr;
-		ASSERT(m_paths.size() == 0);
+		for (int i = 0; i < SHARDS_COUNT; ++i)
+		{
+			ASSERT(m_shards[i]->m_paths.size() == 0);
+			LUMIX_DELETE(m_allocator, m_shards[i]);
+		}
 		g_path_manager = nullptr;
 	}
 
 
 	void PathManager::serialize(OutputBlob& serializer)
 	{
-		MT::SpinLock lock(m_mutex);
 		clear();
-		serializer.write((i32)m_paths.size());
-		for (int i = 0; i < m_paths.size(); ++i)
+		i32 count = 0;
+		for (int i = 0; i < SHARDS_COUNT; ++i)
 		{
-			serializer.writeString(m_paths.at(i)->m_path);
+			MT::AdaptiveMutexLock lock(m_shards[i]->m_mutex);
+			count += m_shards[i]->m_paths.size();
+		}
+		serializer.write(count);
+		for (int i = 0; i < SHARDS_COUNT; ++i)
+		{
+			MT::AdaptiveMutexLock lock(m_shards[i]->m_mutex);
+			auto& paths = m_shards[i]->m_paths;
+			for (int j = 0; j < paths.size(); ++j)
+			{
+				serializer.writeString(paths.at(j)->m_path);
+			}
 		}
 	}
 
 
 	void PathManager::deserialize(InputBlob& serializer)
 	{
-		MT::SpinLock lock(m_mutex);
 		i32 size;
 		serializer.read(size);
 		for (int i = 0; i < size; ++i)
@@ -55,8 +71,8 @@ namespace Lumix
 			char path[MAX_PATH_LENGTH];
 			serializer.readString(path, sizeof(path));
 			u32 hash = crc32(path);
-			PathInternal* internal = getPathMultithreadUnsafe(hash, path);
-			--internal->m_ref_count;
+			PathInternal* internal = getPath(hash, path);
+			MT::atomicDecrement(&internal->m_ref_count);
 		}
 	}
 
@@ -76,73 +92,75 @@ namespace Lumix
 
 	PathInternal* PathManager::getPath(u32 hash)
 	{
-		MT::SpinLock lock(m_mutex);
-		int index = m_paths.find(hash);
+		Shard& shard = getShard(hash);
+		MT::AdaptiveMutexLock lock(shard.m_mutex);
+		int index = shard.m_paths.find(hash);
 		if (index < 0)
 		{
 			return nullptr;
 		}
-		++m_paths.at(index)->m_ref_count;
-		return m_paths.at(index);
+		MT::atomicIncrement(&shard.m_paths.at(index)->m_ref_count);
+		return shard.m_paths.at(index);
 	}
 
 
 	PathInternal* PathManager::getPath(u32 hash, const char* path)
 	{
-		MT::SpinLock lock(m_mutex);
-		return getPathMultithreadUnsafe(hash, path);
-	}
-
-
-	void PathManager::clear()
-	{
-		for (int i = m_paths.size() - 1; i >= 0; --i)
-		{
-			if (m_paths.at(i)->m_ref_count == 0)
-			{
-				LUMIX_DELETE(m_allocator, m_paths.at(i));
-				m_paths.eraseAt(i);
-			}
-		}
-	}
-
-
-	PathInternal* PathManager::getPathMultithreadUnsafe(u32 hash, const char* path)
-	{
-		int index = m_paths.find(hash);
+		Shard& shard = getShard(hash);
+		MT::AdaptiveMutexLock lock(shard.m_mutex);
+		int index = shard.m_paths.find(hash);
 		if (index < 0)
 		{
 			PathInternal* internal = LUMIX_NEW(m_allocator, PathInternal);
 			internal->m_ref_count = 1;
 			internal->m_id = hash;
 			copyString(internal->m_path, path);
-			m_paths.insert(hash, internal);
+			shard.m_paths.insert(hash, internal);
 			return internal;
 		}
-		else
+		MT::atomicIncrement(&shard.m_paths.at(index)->m_ref_count);
+		return shard.m_paths.at(index);
+	}
+
+
+	void PathManager::clear()
+	{
+		for (int i = 0; i < SHARDS_COUNT; ++i)
 		{
-			++m_paths.at(index)->m_ref_count;
-			return m_paths.at(index);
+			MT::AdaptiveMutexLock lock(m_shards[i]->m_mutex);
+			auto& paths = m_shards[i]->m_paths;
+			for (int j = paths.size() - 1; j >= 0; --j)
+			{
+				if (paths.at(j)->m_ref_count == 0)
+				{
+					LUMIX_DELETE(m_allocator, paths.at(j));
+					paths.eraseAt(j);
+				}
+			}
 		}
 	}
 
 
 	void PathManager::incrementRefCount(PathInternal* path)
 	{
-		MT::SpinLock lock(m_mutex);
-		++path->m_ref_count;
+		MT::atomicIncrement(&path->m_ref_count);
 	}
 
 
 	void PathManager::decrementRefCount(PathInternal* path)
 	{
-		MT::SpinLock lock(m_mutex);
-		--path->m_ref_count;
-		if (path->m_ref_count == 0)
-		{
-			m_paths.erase(path->m_id);
-			LUMIX_DELETE(m_allocator, path);
-		}
+		u32 hash = path->m_id;
+		if (MT::atomicDecrement(&path->m_ref_count) > 0) return;
+
+		// the count hit zero; reclaim under the shard lock, rechecking in case
+		// another thread interned the same path meanwhile
+		Shard& shard = getShard(hash);
+		MT::AdaptiveMutexLock lock(shard.m_mutex);
+		int index = shard.m_paths.find(hash);
+		if (index < 0 || shard.m_paths.at(index) != path) return;
+		if (path->m_ref_count != 0) return;
+		shard.m_paths.eraseAt(index);
+		LUMIX_DELETE(m_allocator, path);
 	}
 
 
@@ -36,16 +36,31 @@ public:
 	void clear();
 
 private:
+	enum { SHARDS_COUNT = 16 };
+
+	// the intern table is split into shards with independent locks so that
+	// parallel resource loads do not serialize on one global mutex
+	struct Shard
+	{
+		explicit Shard(IAllocator& allocator)
+			: m_mutex(false)
+			, m_paths(allocator)
+		{
+		}
+
+		MT::AdaptiveMutex m_mutex;
+		AssociativeArray<u32, PathInternal*> m_paths;
+	};
+
+	Shard& getShard(u32 hash) { return *m_shards[hash % SHARDS_COUNT]; }
 	PathInternal* getPath(u32 hash, const char* path);
 	PathInternal* getPath(u32 hash);
-	PathInternal* getPathMultithreadUnsafe(u32 hash, const char* path);
 	void incrementRefCount(PathInternal* path);
 	void decrementRefCount(PathInternal* path);
 
 private:
 	IAllocator& m_allocator;
-	AssociativeArray<u32, PathInternal*> m_paths;
-	MT::SpinMutex m_mutex;
+	Shard* m_shards[SHARDS_COUNT];
 	PathInternal* m_empty_path;
 };
 
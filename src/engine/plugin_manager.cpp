@@ -1,6 +1,8 @@
 #include "engine/plugin_manager.h"
 #include "engine/array.h"
 #include "engine/log.h"
+#include "engine/math_utils.h"
+#include "engine/mtjd/for_each.h"
 #include "engine/profiler.h"
 #include "engine/system.h"
 #include "engine/debug/debug.h"
@@ -8,10 +10,26 @@
 #include "engine/iplugin.h"
 
 
-namespace Lumix 
+namespace Lumix
 {
 
 
+// name is matched against one entry of the comma separated dependency list
+static bool dependsOn(IPlugin& plugin, const char* name)
+{
+	int name_length = stringLength(name);
+	const char* c = plugin.getInitDependencies();
+	while (*c)
+	{
+		const char* start = c;
+		while (*c && *c != ',') ++c;
+		if (int(c - start) == name_length && compareStringN(start, name, name_length) == 0) return true;
+		if (*c) ++c;
+	}
+	return false;
+}
+
+
 class PluginManagerImpl LUMIX_FINAL : public PluginManager
 {
 	private:
@@ -26,6 +44,8 @@ class PluginManagerImpl LUMIX_FINAL : public PluginManager
 			, m_allocator(allocator)
 			, m_engine(engine)
 			, m_library_loaded(allocator)
+			, m_background_init_done(false)
+			, m_late_init_done(false)
 		{ }
 
 
@@ -46,6 +66,15 @@ class PluginManagerImpl LUMIX_FINAL : public PluginManager
 		void update(float dt, bool paused) override
 		{
 			PROFILE_FUNCTION();
+			if (!m_late_init_done)
+			{
+				// deferred past the first frame so it does not delay startup
+				m_late_init_done = true;
+				for (int i = 0, c = m_plugins.size(); i < c; ++i)
+				{
+					m_plugins[i]->initLate();
+				}
+			}
 			for (int i = 0, c = m_plugins.size(); i < c; ++i)
 			{
 				m_plugins[i]->update(dt);
@@ -53,6 +82,67 @@ class PluginManagerImpl LUMIX_FINAL : public PluginManager
 		}
 
 
+		void initPlugins() override
+		{
+			PROFILE_FUNCTION();
+			// plugins whose declared dependencies all have a level get the next
+			// one; independent plugins share a level and init concurrently
+			Array<int> levels(m_allocator);
+			levels.resize(m_plugins.size());
+			for (int& level : levels) level = -1;
+			int max_level = 0;
+			bool changed = true;
+			while (changed)
+			{
+				changed = false;
+				for (int i = 0; i < m_plugins.size(); ++i)
+				{
+					if (levels[i] >= 0) continue;
+					int level = 0;
+					bool ready = true;
+					for (int j = 0; j < m_plugins.size(); ++j)
+					{
+						if (j == i || !dependsOn(*m_plugins[i], m_plugins[j]->getName())) continue;
+						if (levels[j] < 0)
+						{
+							ready = false;
+							break;
+						}
+						level = Math::maximum(level, levels[j] + 1);
+					}
+					if (ready)
+					{
+						levels[i] = level;
+						max_level = Math::maximum(max_level, level);
+						changed = true;
+					}
+				}
+			}
+			for (int i = 0; i < m_plugins.size(); ++i)
+			{
+				// only a dependency cycle leaves a plugin without a level
+				if (levels[i] >= 0) continue;
+				g_log_error.log("Core") << "Cyclic init dependency involving " << m_plugins[i]->getName();
+				levels[i] = max_level + 1;
+			}
+
+			Array<IPlugin*> batch(m_allocator);
+			for (int level = 0; level <= max_level + 1; ++level)
+			{
+				batch.clear();
+				for (int i = 0; i < m_plugins.size(); ++i)
+				{
+					if (levels[i] == level) batch.push(m_plugins[i]);
+				}
+				MTJD::forEach(m_engine.getMTJDManager(), m_allocator, 0, batch.size(), 1,
+					[&batch](int from, int to) {
+						for (int i = from; i < to; ++i) batch[i]->initBackground();
+					});
+			}
+			m_background_init_done = true;
+		}
+
+
 		void serialize(OutputBlob& serializer) override
 		{
 			for (int i = 0, c = m_plugins.size(); i < c; ++i)
@@ -170,6 +260,9 @@ class PluginManagerImpl LUMIX_FINAL : public PluginManager
 				i->pluginAdded(*plugin);
 				plugin->pluginAdded(*i);
 			}
+			// plugins loaded after startup run their init stages in place
+			if (m_background_init_done) plugin->initBackground();
+			if (m_late_init_done) plugin->initLate();
 		}
 
 
@@ -179,6 +272,8 @@ class PluginManagerImpl LUMIX_FINAL : public PluginManager
 		LibraryList m_libraries;
 		PluginList m_plugins;
 		IAllocator& m_allocator;
+		bool m_background_init_done;
+		bool m_late_init_done;
 };
 	
 
@@ -27,6 +27,9 @@ namespace Lumix
 			
 			virtual IPlugin* load(const char* path) = 0;
 			virtual void addPlugin(IPlugin* plugin) = 0;
+			// call once after all startup plugins are loaded; runs the plugins'
+			// initBackground stages on worker threads in dependency order
+			virtual void initPlugins() = 0;
 			virtual void update(float dt, bool paused) = 0;
 			virtual void serialize(OutputBlob& serializer) = 0;
 			virtual void deserialize(InputBlob& serializer) = 0;
@@ -0,0 +1,214 @@
+#pragma once
+
+
+#include "engine/iallocator.h"
+#include "engine/string.h"
+#include "engine/mt/sync.h"
+
+
+namespace Lumix
+{
+
+
+	// IAllocator with power-of-two size-class pools. Freed blocks go on a
+	// per-class free list and are recycled on the next allocation of the same
+	// class, so fixed-size object churn (jobs, async items, poses) stops
+	// touching the general heap once the pools are warm. Sizes above the
+	// largest class fall through to the source allocator.
+	class PoolAllocator LUMIX_FINAL : public IAllocator
+	{
+		public:
+			explicit PoolAllocator(IAllocator& source)
+				: m_source(source)
+				, m_mutex(false)
+			{
+				for (int i = 0; i < SIZE_CLASSES_COUNT; ++i)
+				{
+					m_free_lists[i] = nullptr;
+					m_pages[i] = nullptr;
+				}
+			}
+
+
+			~PoolAllocator()
+			{
+				for (int i = 0; i < SIZE_CLASSES_COUNT; ++i)
+				{
+					Page* page = m_pages[i];
+					while (page)
+					{
+						Page* next = page->next;
+						m_source.deallocate_aligned(page);
+						page = next;
+					}
+				}
+			}
+
+
+			void* allocate(size_t size) override
+			{
+				int size_class = getSizeClass(size);
+				if (size_class < 0) return m_source.allocate(size);
+
+				MT::SpinLock lock(m_mutex);
+				FreeBlock* block = m_free_lists[size_class];
+				if (!block)
+				{
+					refill(size_class);
+					block = m_free_lists[size_class];
+				}
+				m_free_lists[size_class] = block->next;
+				return block;
+			}
+
+
+			void deallocate(void* ptr) override
+			{
+				if (!ptr) return;
+				{
+					MT::SpinLock lock(m_mutex);
+					int size_class = getPtrSizeClass(ptr);
+					if (size_class >= 0)
+					{
+						FreeBlock* block = (FreeBlock*)ptr;
+						block->next = m_free_lists[size_class];
+						m_free_lists[size_class] = block;
+						return;
+					}
+				}
+				m_source.deallocate(ptr);
+			}
+
+
+			void* reallocate(void* ptr, size_t size) override
+			{
+				if (!ptr) return allocate(size);
+
+				int size_class;
+				{
+					MT::SpinLock lock(m_mutex);
+					size_class = getPtrSizeClass(ptr);
+				}
+				if (size_class < 0) return m_source.reallocate(ptr, size);
+
+				size_t old_size = (size_t)MIN_BLOCK_SIZE << size_class;
+				if (size <= old_size) return ptr;
+
+				void* new_mem = allocate(size);
+				copyMemory(new_mem, ptr, old_size);
+				deallocate(ptr);
+				return new_mem;
+			}
+
+
+			void* allocate_aligned(size_t size, size_t align) override
+			{
+				if (align > MIN_BLOCK_SIZE) return m_source.allocate_aligned(size, align);
+				return allocate(size);
+			}
+
+
+			void deallocate_aligned(void* ptr) override
+			{
+				if (!ptr) return;
+				{
+					MT::SpinLock lock(m_mutex);
+					int size_class = getPtrSizeClass(ptr);
+					if (size_class >= 0)
+					{
+						FreeBlock* block = (FreeBlock*)ptr;
+						block->next = m_free_lists[size_class];
+						m_free_lists[size_class] = block;
+						return;
+					}
+				}
+				m_source.deallocate_aligned(ptr);
+			}
+
+
+			void* reallocate_aligned(void* ptr, size_t size, size_t align) override
+			{
+				if (align > MIN_BLOCK_SIZE) return m_source.reallocate_aligned(ptr, size, align);
+				return reallocate(ptr, size);
+			}
+
+
+		private:
+			enum
+			{
+				MIN_BLOCK_SIZE = 16,
+				SIZE_CLASSES_COUNT = 6, // 16, 32, 64, 128, 256, 512
+				PAGE_SIZE = 16 * 1024,
+				PAGE_MAGIC = 0x506f6f4c // "PooL"
+			};
+
+			struct FreeBlock
+			{
+				FreeBlock* next;
+			};
+
+			struct Page
+			{
+				u32 magic;
+				u32 size_class;
+				Page* next;
+			};
+
+
+			static int getSizeClass(size_t size)
+			{
+				size_t block_size = MIN_BLOCK_SIZE;
+				for (int i = 0; i < SIZE_CLASSES_COUNT; ++i)
+				{
+					if (size <= block_size) return i;
+					block_size <<= 1;
+				}
+				return -1;
+			}
+
+
+			// caller holds m_mutex
+			int getPtrSizeClass(const void* ptr) const
+			{
+				const Page* page = (const Page*)((uintptr)ptr & ~(uintptr)(PAGE_SIZE - 1));
+				for (int i = 0; i < SIZE_CLASSES_COUNT; ++i)
+				{
+					for (const Page* p = m_pages[i]; p; p = p->next)
+					{
+						if (p == page) return i;
+					}
+				}
+				return -1;
+			}
+
+
+			void refill(int size_class)
+			{
+				Page* page = (Page*)m_source.allocate_aligned(PAGE_SIZE, PAGE_SIZE);
+				page->magic = PAGE_MAGIC;
+				page->size_class = size_class;
+				page->next = m_pages[size_class];
+				m_pages[size_class] = page;
+
+				size_t block_size = (size_t)MIN_BLOCK_SIZE << size_class;
+				size_t header_size = (sizeof(Page) + MIN_BLOCK_SIZE - 1) & ~(size_t)(MIN_BLOCK_SIZE - 1);
+				u8* begin = (u8*)page + header_size;
+				u8* end = (u8*)page + PAGE_SIZE;
+				for (u8* mem = begin; mem + block_size <= end; mem += block_size)
+				{
+					FreeBlock* block = (FreeBlock*)mem;
+					block->next = m_free_lists[size_class];
+					m_free_lists[size_class] = block;
+				}
+			}
+
+
+		private:
+			IAllocator& m_source;
+			MT::SpinMutex m_mutex;
+			FreeBlock* m_free_lists[SIZE_CLASSES_COUNT];
+			Page* m_pages[SIZE_CLASSES_COUNT];
+	};
+
+
+} // namespace Lumix
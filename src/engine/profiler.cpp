@@ -1,7 +1,11 @@
 #include "profiler.h"
+#include "engine/array.h"
+#include "engine/fs/os_file.h"
 #include "engine/hash_map.h"
 #include "engine/log.h"
+#include "engine/string.h"
 #include "engine/timer.h"
+#include "engine/mt/atomic.h"
 #include "engine/mt/sync.h"
 #include "engine/mt/thread.h"
 
@@ -134,14 +138,75 @@ struct ThreadData
 };
 
 
+// after this many consecutive frames over budget the overrun listeners fire;
+// a single spiky frame does not count as a bust
+static const int BUDGET_OVERRUN_FRAMES = 10;
+
+
+struct BudgetGroup
+{
+	char name[32];
+	float budget_ms;
+	u64 ticks;
+	float last_ms;
+	int overrun_frames;
+};
+
+
+struct MemoryTag
+{
+	char name[32];
+	volatile i64 size;
+	volatile i32 count;
+};
+
+
+static void atomicAdd64(volatile i64* dest, i64 value)
+{
+	for (;;)
+	{
+		i64 tmp = *dest;
+		if (MT::compareAndExchange64(dest, tmp + value, tmp)) return;
+	}
+}
+
+
 struct Instance
 {
+	enum { MAX_THREADS = 64 };
+	enum { MAX_BUDGET_GROUPS = 32 };
+	enum { MAX_MEMORY_TAGS = 32 };
+
 	Instance()
 		: threads(allocator)
 		, frame_listeners(allocator)
+		, budget_overrun_listeners(allocator)
+		, load_records(allocator)
+		, gpu_allocs(allocator)
+		, gpu_budget_listeners(allocator)
 		, m_mutex(false)
+		, thread_count(0)
+		, budget_group_count(0)
+		, memory_tag_count(0)
+		, is_load_telemetry_enabled(false)
+		, frame_history_next(0)
+		, frame_history_count(0)
+		, last_frame_ticks(0)
+		, last_hitch_dump_ticks(0)
+		, hitch_counter(0)
+		, io_queue_depth(0)
+		, is_hitch_detector_enabled(true)
+		, gpu_total(0)
+		, gpu_high_water(0)
+		, gpu_budget(0)
+		, is_gpu_budget_exceeded(false)
 	{
+		for (u64& size : gpu_category_sizes) size = 0;
+		for (i64& size : prev_tag_sizes) size = 0;
 		threads.insert(MT::getCurrentThreadID(), &main_thread);
+		thread_ids[0] = MT::getCurrentThreadID();
+		thread_data[0] = &main_thread;
+		thread_count = 1;
 		timer = Timer::create(allocator);
 	}
 
@@ -159,9 +224,39 @@ struct Instance
 	DefaultAllocator allocator;
 	DelegateList<void()> frame_listeners;
 	HashMap<MT::ThreadID, ThreadData*> threads;
+	// flat copy of the threads map; entries are only appended and thread_count
+	// is bumped after the entry is written, so the hot path can scan it without
+	// taking m_mutex
+	MT::ThreadID thread_ids[MAX_THREADS];
+	ThreadData* thread_data[MAX_THREADS];
+	volatile int thread_count;
 	ThreadData main_thread;
 	Timer* timer;
-	MT::SpinMutex m_mutex;
+	MT::AdaptiveMutex m_mutex;
+	DelegateList<void(const char*)> budget_overrun_listeners;
+	BudgetGroup budget_groups[MAX_BUDGET_GROUPS];
+	int budget_group_count;
+	MemoryTag memory_tags[MAX_MEMORY_TAGS];
+	volatile int memory_tag_count;
+	Array<LoadRecord> load_records;
+	volatile bool is_load_telemetry_enabled;
+	enum { FRAME_HISTORY = 64 };
+	float frame_history[FRAME_HISTORY];
+	int frame_history_next;
+	int frame_history_count;
+	u64 last_frame_ticks;
+	u64 last_hitch_dump_ticks;
+	int hitch_counter;
+	int io_queue_depth;
+	bool is_hitch_detector_enabled;
+	i64 prev_tag_sizes[MAX_MEMORY_TAGS];
+	Array<GPUAlloc> gpu_allocs;
+	DelegateList<void(u64)> gpu_budget_listeners;
+	u64 gpu_category_sizes[(int)GPUCategory::COUNT];
+	u64 gpu_total;
+	u64 gpu_high_water;
+	u64 gpu_budget;
+	bool is_gpu_budget_exceeded;
 };
 
 
@@ -185,23 +280,29 @@ struct BlockInfo
 	ThreadData* thread_data;
 };
 
-static BlockInfo getBlock(const char* name)
+static ThreadData* getThreadData()
 {
-	auto thread_id = MT::getCurrentThreadID();
-
-	ThreadData* thread_data = nullptr;
+	MT::ThreadID thread_id = MT::getCurrentThreadID();
+	for (int i = 0, c = g_instance.thread_count; i < c; ++i)
 	{
-		MT::SpinLock lock(g_instance.m_mutex);
-		auto iter = g_instance.threads.find(thread_id);
-		if (iter == g_instance.threads.end())
-		{
-			g_instance.threads.insert(thread_id, LUMIX_NEW(g_instance.allocator, ThreadData));
-			iter = g_instance.threads.find(thread_id);
-		}
-
-		thread_data = iter.value();
+		if (g_instance.thread_ids[i] == thread_id) return g_instance.thread_data[i];
 	}
 
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	ASSERT(g_instance.thread_count < Instance::MAX_THREADS);
+	ThreadData* thread_data = LUMIX_NEW(g_instance.allocator, ThreadData);
+	g_instance.threads.insert(thread_id, thread_data);
+	g_instance.thread_ids[g_instance.thread_count] = thread_id;
+	g_instance.thread_data[g_instance.thread_count] = thread_data;
+	++g_instance.thread_count;
+	return thread_data;
+}
+
+
+static BlockInfo getBlock(const char* name)
+{
+	ThreadData* thread_data = getThreadData();
+
 	if (!thread_data->current_block)
 	{
 		Block* LUMIX_RESTRICT root = thread_data->root_block;
@@ -282,15 +383,7 @@ const char* getThreadName(MT::ThreadID thread_id)
 
 void setThreadName(const char* name)
 {
-	MT::SpinLock lock(g_instance.m_mutex);
-	MT::ThreadID thread_id = MT::getCurrentThreadID();
-	auto iter = g_instance.threads.find(thread_id);
-	if (iter == g_instance.threads.end())
-	{
-		g_instance.threads.insert(thread_id, LUMIX_NEW(g_instance.allocator, ThreadData));
-		iter = g_instance.threads.find(thread_id);
-	}
-	Lumix::copyString(iter.value()->name, name);
+	Lumix::copyString(getThreadData()->name, name);
 }
 
 
@@ -334,6 +427,324 @@ u64 now()
 }
 
 
+u64 frequency()
+{
+	return g_instance.timer->getFrequency();
+}
+
+
+static BudgetGroup& getBudgetGroup(const char* name)
+{
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	for (int i = 0; i < g_instance.budget_group_count; ++i)
+	{
+		if (equalStrings(g_instance.budget_groups[i].name, name)) return g_instance.budget_groups[i];
+	}
+
+	ASSERT(g_instance.budget_group_count < Instance::MAX_BUDGET_GROUPS);
+	BudgetGroup& group = g_instance.budget_groups[g_instance.budget_group_count];
+	copyString(group.name, name);
+	group.budget_ms = 0;
+	group.ticks = 0;
+	group.last_ms = 0;
+	group.overrun_frames = 0;
+	++g_instance.budget_group_count;
+	return group;
+}
+
+
+void setBudget(const char* name, float budget_ms)
+{
+	getBudgetGroup(name).budget_ms = budget_ms;
+}
+
+
+void addBudgetTime(const char* name, u64 ticks)
+{
+	BudgetGroup& group = getBudgetGroup(name);
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	group.ticks += ticks;
+}
+
+
+int getBudgetGroupCount()
+{
+	return g_instance.budget_group_count;
+}
+
+
+const char* getBudgetGroupName(int index)
+{
+	return g_instance.budget_groups[index].name;
+}
+
+
+float getBudgetGroupBudget(int index)
+{
+	return g_instance.budget_groups[index].budget_ms;
+}
+
+
+float getBudgetGroupTime(int index)
+{
+	return g_instance.budget_groups[index].last_ms;
+}
+
+
+int getBudgetGroupOverrunFrames(int index)
+{
+	return g_instance.budget_groups[index].overrun_frames;
+}
+
+
+DelegateList<void(const char*)>& getBudgetOverrunListeners()
+{
+	return g_instance.budget_overrun_listeners;
+}
+
+
+int registerMemoryTag(const char* name)
+{
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	for (int i = 0; i < g_instance.memory_tag_count; ++i)
+	{
+		if (equalStrings(g_instance.memory_tags[i].name, name)) return i;
+	}
+
+	ASSERT(g_instance.memory_tag_count < Instance::MAX_MEMORY_TAGS);
+	MemoryTag& tag = g_instance.memory_tags[g_instance.memory_tag_count];
+	copyString(tag.name, name);
+	tag.size = 0;
+	tag.count = 0;
+	return g_instance.memory_tag_count++;
+}
+
+
+void trackAlloc(int tag, size_t size)
+{
+	atomicAdd64(&g_instance.memory_tags[tag].size, (i64)size);
+	MT::atomicIncrement(&g_instance.memory_tags[tag].count);
+}
+
+
+void trackFree(int tag, size_t size)
+{
+	atomicAdd64(&g_instance.memory_tags[tag].size, -(i64)size);
+	MT::atomicDecrement(&g_instance.memory_tags[tag].count);
+}
+
+
+int getMemoryTagCount()
+{
+	return g_instance.memory_tag_count;
+}
+
+
+const char* getMemoryTagName(int index)
+{
+	return g_instance.memory_tags[index].name;
+}
+
+
+u64 getMemoryTagSize(int index)
+{
+	return (u64)g_instance.memory_tags[index].size;
+}
+
+
+int getMemoryTagAllocationCount(int index)
+{
+	return g_instance.memory_tags[index].count;
+}
+
+
+void enableLoadTelemetry(bool enable)
+{
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	if (enable && !g_instance.is_load_telemetry_enabled) g_instance.load_records.clear();
+	g_instance.is_load_telemetry_enabled = enable;
+}
+
+
+bool isLoadTelemetryEnabled()
+{
+	return g_instance.is_load_telemetry_enabled;
+}
+
+
+int beginLoadRecord(const char* path)
+{
+	if (!g_instance.is_load_telemetry_enabled) return -1;
+
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	LoadRecord& record = g_instance.load_records.emplace();
+	copyString(record.path, path);
+	// every timestamp starts at the queue time, so a record of a load that is
+	// still in flight draws as a partial bar instead of garbage
+	record.queued = now();
+	record.issued = record.file_read = record.parsed = record.ready = record.queued;
+	record.failed = false;
+	return g_instance.load_records.size() - 1;
+}
+
+
+void setLoadRecordIssued(int record)
+{
+	if (record < 0) return;
+
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	if (record >= g_instance.load_records.size()) return;
+	g_instance.load_records[record].issued = now();
+}
+
+
+void setLoadRecordFileRead(int record)
+{
+	if (record < 0) return;
+
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	if (record >= g_instance.load_records.size()) return;
+	g_instance.load_records[record].file_read = now();
+}
+
+
+void setLoadRecordParsed(int record)
+{
+	if (record < 0) return;
+
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	if (record >= g_instance.load_records.size()) return;
+	g_instance.load_records[record].parsed = now();
+}
+
+
+void setLoadRecordReady(int record, bool failed)
+{
+	if (record < 0) return;
+
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	if (record >= g_instance.load_records.size()) return;
+	g_instance.load_records[record].ready = now();
+	g_instance.load_records[record].failed = failed;
+}
+
+
+int getLoadRecordCount()
+{
+	return g_instance.load_records.size();
+}
+
+
+const LoadRecord& getLoadRecord(int index)
+{
+	return g_instance.load_records[index];
+}
+
+
+// callers hold m_mutex and have already subtracted the entry's old size
+static void updateGPUAlloc(GPUAlloc& alloc, u64 size)
+{
+	alloc.size = size;
+	g_instance.gpu_total += size;
+	g_instance.gpu_category_sizes[(int)alloc.category] += size;
+	if (g_instance.gpu_total > g_instance.gpu_high_water)
+	{
+		g_instance.gpu_high_water = g_instance.gpu_total;
+	}
+	if (g_instance.gpu_budget != 0 && g_instance.gpu_total > g_instance.gpu_budget &&
+		!g_instance.is_gpu_budget_exceeded)
+	{
+		g_instance.is_gpu_budget_exceeded = true;
+		g_log_warning.log("Engine") << "GPU memory budget exceeded ("
+									<< float((g_instance.gpu_total / 1024) / 1024.0f) << "MB)";
+		g_instance.gpu_budget_listeners.invoke(g_instance.gpu_total);
+	}
+}
+
+
+void trackGPUAlloc(GPUCategory category, const char* name, u64 size)
+{
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	for (GPUAlloc& alloc : g_instance.gpu_allocs)
+	{
+		if (alloc.category != category || !equalStrings(alloc.name, name)) continue;
+
+		// e.g. a reloaded texture; replace the old size
+		g_instance.gpu_total -= alloc.size;
+		g_instance.gpu_category_sizes[(int)category] -= alloc.size;
+		alloc.size = 0;
+		updateGPUAlloc(alloc, size);
+		return;
+	}
+	GPUAlloc& alloc = g_instance.gpu_allocs.emplace();
+	copyString(alloc.name, name);
+	alloc.category = category;
+	alloc.size = 0;
+	updateGPUAlloc(alloc, size);
+}
+
+
+void untrackGPUAlloc(GPUCategory category, const char* name)
+{
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	for (int i = 0, c = g_instance.gpu_allocs.size(); i < c; ++i)
+	{
+		GPUAlloc& alloc = g_instance.gpu_allocs[i];
+		if (alloc.category != category || !equalStrings(alloc.name, name)) continue;
+
+		g_instance.gpu_total -= alloc.size;
+		g_instance.gpu_category_sizes[(int)category] -= alloc.size;
+		g_instance.gpu_allocs.eraseFast(i);
+		if (g_instance.gpu_total <= g_instance.gpu_budget) g_instance.is_gpu_budget_exceeded = false;
+		return;
+	}
+}
+
+
+u64 getGPUMemoryTotal()
+{
+	return g_instance.gpu_total;
+}
+
+
+u64 getGPUMemorySize(GPUCategory category)
+{
+	return g_instance.gpu_category_sizes[(int)category];
+}
+
+
+u64 getGPUMemoryHighWater()
+{
+	return g_instance.gpu_high_water;
+}
+
+
+void setGPUMemoryBudget(u64 bytes)
+{
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
+	g_instance.gpu_budget = bytes;
+	g_instance.is_gpu_budget_exceeded = bytes != 0 && g_instance.gpu_total > bytes;
+}
+
+
+DelegateList<void (u64)>& getGPUBudgetListeners()
+{
+	return g_instance.gpu_budget_listeners;
+}
+
+
+int getGPUAllocCount()
+{
+	return g_instance.gpu_allocs.size();
+}
+
+
+const GPUAlloc& getGPUAlloc(int index)
+{
+	return g_instance.gpu_allocs[index];
+}
+
+
 Block* getRootBlock(MT::ThreadID thread_id)
 {
 	auto iter = g_instance.threads.find(thread_id);
@@ -345,15 +756,7 @@ Block* getRootBlock(MT::ThreadID thread_id)
 
 void* endBlock()
 {
-	auto thread_id = MT::getCurrentThreadID();
-
-	ThreadData* thread_data = nullptr;
-	{
-		MT::SpinLock lock(g_instance.m_mutex);
-		auto iter = g_instance.threads.find(thread_id);
-		ASSERT(iter.isValid());
-		thread_data = iter.value();
-	}
+	ThreadData* thread_data = getThreadData();
 
 	ASSERT(thread_data->current_block);
 	auto* block = thread_data->current_block;
@@ -364,14 +767,132 @@ void* endBlock()
 }
 
 
+void enableHitchDetector(bool enable)
+{
+	g_instance.is_hitch_detector_enabled = enable;
+}
+
+
+void setIOQueueDepth(int depth)
+{
+	g_instance.io_queue_depth = depth;
+}
+
+
+// caller holds m_mutex and the frame's hits have not been cleared yet
+static void writeHitchBlocks(FS::OsFile& file, MT::ThreadID thread_id, Block* block, double to_us, bool& first)
+{
+	while (block)
+	{
+		if (block->m_type == BlockType::TIME)
+		{
+			for (int i = 0, c = block->m_hits.size(); i < c; ++i)
+			{
+				StaticString<300> line(first ? "\n" : ",\n",
+					"{\"name\":\"", block->m_name, "\",\"ph\":\"X\",\"pid\":0,\"tid\":", thread_id,
+					",\"ts\":", (u64)(block->m_hits[i].m_start * to_us),
+					",\"dur\":", (u64)(block->m_hits[i].m_length * to_us), "}");
+				file.write(line, stringLength(line));
+				first = false;
+			}
+		}
+		writeHitchBlocks(file, thread_id, block->m_first_child, to_us, first);
+		block = block->m_next;
+	}
+}
+
+
+static void dumpHitch(float frame_ms, float median_ms)
+{
+	StaticString<MAX_PATH_LENGTH> path("hitch_", g_instance.hitch_counter, ".json");
+	++g_instance.hitch_counter;
+	FS::OsFile file;
+	if (!file.open(path, FS::Mode::CREATE_AND_WRITE, g_instance.allocator)) return;
+
+	double to_us = 1000000.0 / (double)g_instance.timer->getFrequency();
+	file.write("[", 1);
+	bool first = true;
+	for (auto iter = g_instance.threads.begin(), end = g_instance.threads.end(); iter != end; ++iter)
+	{
+		StaticString<300> line(first ? "\n" : ",\n",
+			"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":", iter.key(),
+			",\"args\":{\"name\":\"", iter.value()->name, "\"}}");
+		file.write(line, stringLength(line));
+		first = false;
+	}
+	for (auto iter = g_instance.threads.begin(), end = g_instance.threads.end(); iter != end; ++iter)
+	{
+		writeHitchBlocks(file, iter.key(), iter.value()->root_block, to_us, first);
+	}
+	for (int i = 0; i < g_instance.memory_tag_count; ++i)
+	{
+		i64 size = g_instance.memory_tags[i].size;
+		StaticString<300> line(",\n{\"name\":\"mem ", g_instance.memory_tags[i].name,
+			"\",\"ph\":\"C\",\"pid\":0,\"ts\":0,\"args\":{\"size_kb\":", (i32)(size / 1024),
+			",\"delta_kb\":", (i32)((size - g_instance.prev_tag_sizes[i]) / 1024), "}}");
+		file.write(line, stringLength(line));
+	}
+	StaticString<300> io_line(",\n{\"name\":\"io_queue_depth\",\"ph\":\"C\",\"pid\":0,\"ts\":0,"
+		"\"args\":{\"depth\":", g_instance.io_queue_depth, "}}");
+	file.write(io_line, stringLength(io_line));
+	file.write("\n]", 2);
+	file.close();
+
+	(g_log_warning.log("Engine") << "Frame hitch, trace saved to " << (const char*)path)
+		.field("frame_ms", frame_ms)
+		.field("median_ms", median_ms);
+}
+
+
 void frame()
 {
 	PROFILE_FUNCTION();
 
-	MT::SpinLock lock(g_instance.m_mutex);
+	MT::AdaptiveMutexLock lock(g_instance.m_mutex);
 	g_instance.frame_listeners.invoke();
 	u64 now = g_instance.timer->getRawTimeSinceStart();
 
+	if (g_instance.last_frame_ticks != 0)
+	{
+		float frame_ms = float((now - g_instance.last_frame_ticks) * 1000.0 /
+							   (double)g_instance.timer->getFrequency());
+		// the median needs half the window of samples before it means anything
+		if (g_instance.is_hitch_detector_enabled &&
+			g_instance.frame_history_count >= Instance::FRAME_HISTORY / 2)
+		{
+			float sorted[Instance::FRAME_HISTORY];
+			int count = g_instance.frame_history_count;
+			for (int i = 0; i < count; ++i)
+			{
+				float v = g_instance.frame_history[i];
+				int j = i;
+				while (j > 0 && sorted[j - 1] > v)
+				{
+					sorted[j] = sorted[j - 1];
+					--j;
+				}
+				sorted[j] = v;
+			}
+			float median_ms = sorted[count / 2];
+			// one dump per 10 seconds; a hitch storm should not turn into a disk storm
+			bool cooled_down =
+				now - g_instance.last_hitch_dump_ticks > g_instance.timer->getFrequency() * 10;
+			if (frame_ms > 2 * median_ms && frame_ms > 25.0f && cooled_down)
+			{
+				dumpHitch(frame_ms, median_ms);
+				g_instance.last_hitch_dump_ticks = now;
+			}
+		}
+		g_instance.frame_history[g_instance.frame_history_next] = frame_ms;
+		g_instance.frame_history_next = (g_instance.frame_history_next + 1) % Instance::FRAME_HISTORY;
+		if (g_instance.frame_history_count < Instance::FRAME_HISTORY) ++g_instance.frame_history_count;
+	}
+	g_instance.last_frame_ticks = now;
+	for (int i = 0; i < g_instance.memory_tag_count; ++i)
+	{
+		g_instance.prev_tag_sizes[i] = g_instance.memory_tags[i].size;
+	}
+
 	for (auto* i : g_instance.threads)
 	{
 		if (!i->root_block) continue;
@@ -385,6 +906,26 @@ void frame()
 			block = block->m_parent;
 		}
 	}
+
+	double to_ms = 1000.0 / (double)g_instance.timer->getFrequency();
+	for (int i = 0; i < g_instance.budget_group_count; ++i)
+	{
+		BudgetGroup& group = g_instance.budget_groups[i];
+		group.last_ms = float(group.ticks * to_ms);
+		group.ticks = 0;
+		if (group.budget_ms <= 0 || group.last_ms <= group.budget_ms)
+		{
+			group.overrun_frames = 0;
+			continue;
+		}
+		++group.overrun_frames;
+		if (group.overrun_frames == BUDGET_OVERRUN_FRAMES)
+		{
+			g_log_warning.log("Engine") << group.name << " is over its frame budget ("
+				<< group.last_ms << " / " << group.budget_ms << " ms)";
+			g_instance.budget_overrun_listeners.invoke(group.name);
+		}
+	}
 }
 
 
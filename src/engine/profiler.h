@@ -31,6 +31,7 @@ LUMIX_ENGINE_API int getThreadIndex(u32 id);
 LUMIX_ENGINE_API int getThreadCount();
 
 LUMIX_ENGINE_API u64 now();
+LUMIX_ENGINE_API u64 frequency();
 LUMIX_ENGINE_API Block* getRootBlock(MT::ThreadID thread_id);
 LUMIX_ENGINE_API int getBlockInt(Block* block);
 LUMIX_ENGINE_API BlockType getBlockType(Block* block);
@@ -48,6 +49,88 @@ LUMIX_ENGINE_API void* endBlock();
 LUMIX_ENGINE_API void frame();
 LUMIX_ENGINE_API DelegateList<void ()>& getFrameListeners();
 
+// named frame budget groups; times accumulated during the frame are compared
+// against the budget in frame(), a zero budget means track time only
+LUMIX_ENGINE_API void setBudget(const char* name, float budget_ms);
+LUMIX_ENGINE_API void addBudgetTime(const char* name, u64 ticks);
+LUMIX_ENGINE_API int getBudgetGroupCount();
+LUMIX_ENGINE_API const char* getBudgetGroupName(int index);
+LUMIX_ENGINE_API float getBudgetGroupBudget(int index);
+LUMIX_ENGINE_API float getBudgetGroupTime(int index);
+LUMIX_ENGINE_API int getBudgetGroupOverrunFrames(int index);
+// invoked from frame() once a group has been over budget for
+// BUDGET_OVERRUN_FRAMES consecutive frames
+LUMIX_ENGINE_API DelegateList<void (const char*)>& getBudgetOverrunListeners();
+
+// per-subsystem memory counters fed by named BaseProxyAllocators; atomic
+// adds only, cheap enough to stay on in shipped builds
+LUMIX_ENGINE_API int registerMemoryTag(const char* name);
+LUMIX_ENGINE_API void trackAlloc(int tag, size_t size);
+LUMIX_ENGINE_API void trackFree(int tag, size_t size);
+LUMIX_ENGINE_API int getMemoryTagCount();
+LUMIX_ENGINE_API const char* getMemoryTagName(int index);
+LUMIX_ENGINE_API u64 getMemoryTagSize(int index);
+LUMIX_ENGINE_API int getMemoryTagAllocationCount(int index);
+
+// per-resource load timeline; everything happens at load frequency, so it is
+// cheap enough to turn on in shipped builds. enabling clears the previous
+// session, record indices from an older session are silently dropped
+struct LoadRecord
+{
+	char path[MAX_PATH_LENGTH];
+	u64 queued;    // load requested
+	u64 issued;    // read handed to the file system
+	u64 file_read; // read finished
+	u64 parsed;    // Resource::load returned
+	u64 ready;     // resource and all its dependencies ready
+	bool failed;
+};
+LUMIX_ENGINE_API void enableLoadTelemetry(bool enable);
+LUMIX_ENGINE_API bool isLoadTelemetryEnabled();
+LUMIX_ENGINE_API int beginLoadRecord(const char* path);
+LUMIX_ENGINE_API void setLoadRecordIssued(int record);
+LUMIX_ENGINE_API void setLoadRecordFileRead(int record);
+LUMIX_ENGINE_API void setLoadRecordParsed(int record);
+LUMIX_ENGINE_API void setLoadRecordReady(int record, bool failed);
+LUMIX_ENGINE_API int getLoadRecordCount();
+LUMIX_ENGINE_API const LoadRecord& getLoadRecord(int index);
+
+// GPU memory ledger fed by the renderer on create/destroy; bgfx only reports
+// aggregates, this keeps per-resource sizes so budget busts name the culprit
+enum class GPUCategory
+{
+	TEXTURE,
+	VERTEX_BUFFER,
+	INDEX_BUFFER,
+	FRAMEBUFFER,
+
+	COUNT
+};
+struct GPUAlloc
+{
+	char name[MAX_PATH_LENGTH];
+	GPUCategory category;
+	u64 size;
+};
+LUMIX_ENGINE_API void trackGPUAlloc(GPUCategory category, const char* name, u64 size);
+LUMIX_ENGINE_API void untrackGPUAlloc(GPUCategory category, const char* name);
+LUMIX_ENGINE_API u64 getGPUMemoryTotal();
+LUMIX_ENGINE_API u64 getGPUMemorySize(GPUCategory category);
+LUMIX_ENGINE_API u64 getGPUMemoryHighWater();
+LUMIX_ENGINE_API void setGPUMemoryBudget(u64 bytes);
+// invoked once each time the total crosses the budget from below
+LUMIX_ENGINE_API DelegateList<void (u64)>& getGPUBudgetListeners();
+LUMIX_ENGINE_API int getGPUAllocCount();
+LUMIX_ENGINE_API const GPUAlloc& getGPUAlloc(int index);
+
+// always-on hitch forensics: when a frame exceeds twice the rolling median
+// (and a 25 ms floor), frame() dumps the frame's whole event trace plus
+// memory tag deltas and the IO queue depth to hitch_<n>.json in
+// chrome://tracing format, so rare in-game hitches leave evidence even with
+// no profiler UI attached
+LUMIX_ENGINE_API void enableHitchDetector(bool enable);
+LUMIX_ENGINE_API void setIOQueueDepth(int depth);
+
 
 #ifdef _DEBUG
 	struct Scope
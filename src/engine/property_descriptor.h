@@ -266,6 +266,27 @@ public:
 	};
 
 
+	void setBatch(const ComponentUID* cmps, int count, int index, InputBlob& stream) const override
+	{
+		i32 v;
+		stream.read(&v, sizeof(v));
+		if (index < 0)
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				(static_cast<S*>(cmps[i].scene)->*m_single.setter)(cmps[i].handle, v);
+			}
+		}
+		else
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				(static_cast<S*>(cmps[i].scene)->*m_array.setter)(cmps[i].handle, index, v);
+			}
+		}
+	}
+
+
 	void get(ComponentUID cmp, int index, OutputBlob& stream) const override
 	{
 		i32 i = 0;
@@ -387,6 +408,27 @@ public:
 	};
 
 
+	void setBatch(const ComponentUID* cmps, int count, int index, InputBlob& stream) const override
+	{
+		T v;
+		stream.read(&v, sizeof(v));
+		if (index < 0)
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				(static_cast<S*>(cmps[i].scene)->*m_single.setter)(cmps[i].handle, v);
+			}
+		}
+		else
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				(static_cast<S*>(cmps[i].scene)->*m_array.setter)(cmps[i].handle, index, v);
+			}
+		}
+	}
+
+
 	void get(ComponentUID cmp, int index, OutputBlob& stream) const override
 	{
 		int len = sizeof(T);
@@ -784,6 +826,27 @@ public:
 	};
 
 
+	void setBatch(const ComponentUID* cmps, int count, int index, InputBlob& stream) const override
+	{
+		float f;
+		stream.read(&f, sizeof(f));
+		if (index >= 0)
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				(static_cast<S*>(cmps[i].scene)->*m_array_setter)(cmps[i].handle, index, f);
+			}
+		}
+		else
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				(static_cast<S*>(cmps[i].scene)->*m_setter)(cmps[i].handle, f);
+			}
+		}
+	}
+
+
 	void get(ComponentUID cmp, int index, OutputBlob& stream) const override
 	{
 		float f = 0;
@@ -927,4 +990,217 @@ private:
 };
 
 
+// descriptors below take the getter and setter as template parameters instead of
+// storing them, so the calls are direct and inlinable in the virtual overrides and
+// the object itself is stateless enough to live in static storage - register these
+// with PropertyRegister::addStatic and registration allocates nothing
+
+
+template <class S, bool (S::*Getter)(ComponentHandle), void (S::*Setter)(ComponentHandle, bool)>
+class StaticBoolPropertyDescriptor : public IPropertyDescriptor
+{
+public:
+	explicit StaticBoolPropertyDescriptor(const char* name)
+	{
+		setName(name);
+		m_type = IPropertyDescriptor::BOOL;
+	}
+
+
+	void set(ComponentUID cmp, int index, InputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		bool b;
+		stream.read(&b, sizeof(b));
+		(static_cast<S*>(cmp.scene)->*Setter)(cmp.handle, b);
+	}
+
+
+	void get(ComponentUID cmp, int index, OutputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		bool b = (static_cast<S*>(cmp.scene)->*Getter)(cmp.handle);
+		stream.write(&b, sizeof(b));
+	}
+};
+
+
+template <class S, int (S::*Getter)(ComponentHandle), void (S::*Setter)(ComponentHandle, int)>
+class StaticIntPropertyDescriptor : public INumericPropertyDescriptor<int>
+{
+public:
+	explicit StaticIntPropertyDescriptor(const char* name)
+	{
+		setName(name);
+		m_type = INTEGER;
+		m_min = getIntPropertyMin();
+		m_max = getIntPropertyMax();
+		m_step = 1;
+	}
+
+
+	void set(ComponentUID cmp, int index, InputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		i32 i;
+		stream.read(&i, sizeof(i));
+		(static_cast<S*>(cmp.scene)->*Setter)(cmp.handle, i);
+	}
+
+
+	void setBatch(const ComponentUID* cmps, int count, int index, InputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		i32 v;
+		stream.read(&v, sizeof(v));
+		for (int i = 0; i < count; ++i)
+		{
+			(static_cast<S*>(cmps[i].scene)->*Setter)(cmps[i].handle, v);
+		}
+	}
+
+
+	void get(ComponentUID cmp, int index, OutputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		i32 i = (static_cast<S*>(cmp.scene)->*Getter)(cmp.handle);
+		stream.write(i);
+	}
+
+
+	void setLimit(int min, int max)
+	{
+		m_min = min;
+		m_max = max;
+	}
+};
+
+
+template <class S, float (S::*Getter)(ComponentHandle), void (S::*Setter)(ComponentHandle, float)>
+class StaticDecimalPropertyDescriptor : public INumericPropertyDescriptor<float>
+{
+public:
+	StaticDecimalPropertyDescriptor(const char* name, float min, float max, float step)
+	{
+		setName(name);
+		m_min = min;
+		m_max = max;
+		m_step = step;
+		m_type = DECIMAL;
+	}
+
+
+	void set(ComponentUID cmp, int index, InputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		float f;
+		stream.read(&f, sizeof(f));
+		(static_cast<S*>(cmp.scene)->*Setter)(cmp.handle, f);
+	}
+
+
+	void setBatch(const ComponentUID* cmps, int count, int index, InputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		float f;
+		stream.read(&f, sizeof(f));
+		for (int i = 0; i < count; ++i)
+		{
+			(static_cast<S*>(cmps[i].scene)->*Setter)(cmps[i].handle, f);
+		}
+	}
+
+
+	void get(ComponentUID cmp, int index, OutputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		float f = (static_cast<S*>(cmp.scene)->*Getter)(cmp.handle);
+		stream.write(&f, sizeof(f));
+	}
+};
+
+
+template <typename T, class S, T (S::*Getter)(ComponentHandle), void (S::*Setter)(ComponentHandle, const T&)>
+class StaticSimplePropertyDescriptor : public IPropertyDescriptor
+{
+public:
+	explicit StaticSimplePropertyDescriptor(const char* name)
+	{
+		setName(name);
+		m_type = toPropertyType<T>();
+	}
+
+
+	void set(ComponentUID cmp, int index, InputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		T v;
+		stream.read(&v, sizeof(v));
+		(static_cast<S*>(cmp.scene)->*Setter)(cmp.handle, v);
+	}
+
+
+	void setBatch(const ComponentUID* cmps, int count, int index, InputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		T v;
+		stream.read(&v, sizeof(v));
+		for (int i = 0; i < count; ++i)
+		{
+			(static_cast<S*>(cmps[i].scene)->*Setter)(cmps[i].handle, v);
+		}
+	}
+
+
+	void get(ComponentUID cmp, int index, OutputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		T v = (static_cast<S*>(cmp.scene)->*Getter)(cmp.handle);
+		stream.write(&v, sizeof(v));
+	}
+};
+
+
+template <class S,
+	int (S::*Getter)(ComponentHandle),
+	void (S::*Setter)(ComponentHandle, int),
+	int (S::*EnumCountGetter)() const,
+	const char* (S::*EnumNameGetter)(int)>
+class StaticDynamicEnumPropertyDescriptor : public IEnumPropertyDescriptor
+{
+public:
+	explicit StaticDynamicEnumPropertyDescriptor(const char* name)
+	{
+		setName(name);
+		m_type = ENUM;
+	}
+
+
+	void set(ComponentUID cmp, int index, InputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		int value;
+		stream.read(&value, sizeof(value));
+		(static_cast<S*>(cmp.scene)->*Setter)(cmp.handle, value);
+	}
+
+
+	void get(ComponentUID cmp, int index, OutputBlob& stream) const override
+	{
+		ASSERT(index == -1);
+		int value = (static_cast<S*>(cmp.scene)->*Getter)(cmp.handle);
+		stream.write(&value, sizeof(value));
+	}
+
+
+	int getEnumCount(IScene* scene, ComponentHandle) override { return (static_cast<S*>(scene)->*EnumCountGetter)(); }
+
+
+	const char* getEnumItemName(IScene* scene, ComponentHandle, int index) override
+	{
+		return (static_cast<S*>(scene)->*EnumNameGetter)(index);
+	}
+};
+
+
 } // !namespace Lumix
@@ -21,9 +21,11 @@ struct ComponentTypeData
 
 
 typedef AssociativeArray<ComponentType, Array<IPropertyDescriptor*>> PropertyMap;
+typedef AssociativeArray<ComponentType, AssociativeArray<u32, IPropertyDescriptor*>> PropertyHashMap;
 
 
 static PropertyMap* g_properties = nullptr;
+static PropertyHashMap* g_properties_by_hash = nullptr;
 static IAllocator* g_allocator = nullptr;
 
 
@@ -39,6 +41,7 @@ void init(IAllocator& allocator)
 {
 	ASSERT(!g_properties);
 	g_properties = LUMIX_NEW(allocator, PropertyMap)(allocator);
+	g_properties_by_hash = LUMIX_NEW(allocator, PropertyHashMap)(allocator);
 	g_allocator = &allocator;
 }
 
@@ -50,19 +53,53 @@ void shutdown()
 		Array<IPropertyDescriptor*>& props = g_properties->at(j);
 		for (auto* prop : props)
 		{
-			LUMIX_DELETE(*g_allocator, prop);
+			if (prop->isOwned()) LUMIX_DELETE(*g_allocator, prop);
 		}
 	}
 
 	LUMIX_DELETE(*g_allocator, g_properties);
+	LUMIX_DELETE(*g_allocator, g_properties_by_hash);
 	g_properties = nullptr;
+	g_properties_by_hash = nullptr;
 	g_allocator = nullptr;
 }
 
 
+static AssociativeArray<u32, IPropertyDescriptor*>& getHashTable(ComponentType type)
+{
+	int index = g_properties_by_hash->find(type);
+	if (index < 0)
+	{
+		g_properties_by_hash->emplace(type, *g_allocator);
+		index = g_properties_by_hash->find(type);
+	}
+	return g_properties_by_hash->at(index);
+}
+
+
 void add(const char* component_type, IPropertyDescriptor* descriptor)
 {
-	getDescriptors(getComponentType(component_type)).push(descriptor);
+	ComponentType type = getComponentType(component_type);
+	getDescriptors(type).push(descriptor);
+	// resolved here once, so each lookup is a binary search instead of a scan
+	// over every descriptor and array child of the component type
+	AssociativeArray<u32, IPropertyDescriptor*>& table = getHashTable(type);
+	table.insert(descriptor->getNameHash(), descriptor);
+	if (descriptor->getType() == IPropertyDescriptor::ARRAY)
+	{
+		auto* array_desc = static_cast<IArrayDescriptor*>(descriptor);
+		for (auto* child : array_desc->getChildren())
+		{
+			table.insert(child->getNameHash(), child);
+		}
+	}
+}
+
+
+void addStatic(const char* component_type, IPropertyDescriptor* descriptor)
+{
+	descriptor->setOwned(false);
+	add(component_type, descriptor);
 }
 
 
@@ -80,6 +117,12 @@ Array<IPropertyDescriptor*>& getDescriptors(ComponentType type)
 
 const IPropertyDescriptor* getDescriptor(ComponentType type, u32 name_hash)
 {
+	AssociativeArray<u32, IPropertyDescriptor*>& table = getHashTable(type);
+	int index = table.find(name_hash);
+	if (index >= 0) return table.at(index);
+
+	// children attached to an array descriptor after add() are only
+	// reachable through the scan
 	Array<IPropertyDescriptor*>& props = getDescriptors(type);
 	for (int i = 0; i < props.size(); ++i)
 	{
@@ -20,6 +20,8 @@ namespace PropertyRegister
 LUMIX_ENGINE_API void init(IAllocator& allocator);
 LUMIX_ENGINE_API void shutdown();
 LUMIX_ENGINE_API void add(const char* component_type, IPropertyDescriptor* desc);
+// for descriptors in static storage; registered like add() but never deleted
+LUMIX_ENGINE_API void addStatic(const char* component_type, IPropertyDescriptor* desc);
 LUMIX_ENGINE_API const IPropertyDescriptor* getDescriptor(ComponentType type, u32 name_hash);
 LUMIX_ENGINE_API const IPropertyDescriptor* getDescriptor(const char* component_type, const char* property_name);
 LUMIX_ENGINE_API Array<IPropertyDescriptor*>& getDescriptors(ComponentType type);
@@ -3,6 +3,7 @@
 #include "engine/vec.h"
 #include "engine/math_utils.h"
 #include "engine/matrix.h"
+#include "engine/simd.h"
 
 
 namespace Lumix
@@ -133,6 +134,170 @@ void nlerp(const Quat& q1, const Quat& q2, Quat* out, float t)
 }
 
 
+void slerp(const Quat& q1, const Quat& q2, Quat* out, float t)
+{
+	float d = q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+	float sign = 1.0f;
+	if (d < 0)
+	{
+		d = -d;
+		sign = -1.0f;
+	}
+	if (d > 0.9995f)
+	{
+		// tiny arc, the normalized lerp is exact enough and skips the trig
+		nlerp(q1, q2, out, t);
+		return;
+	}
+	float angle = acosf(d);
+	float s = 1.0f / sinf(angle);
+	float c1 = sinf((1 - t) * angle) * s;
+	float c2 = sinf(t * angle) * s * sign;
+	out->x = q1.x * c1 + q2.x * c2;
+	out->y = q1.y * c1 + q2.y * c2;
+	out->z = q1.z * c1 + q2.z * c2;
+	out->w = q1.w * c1 + q2.w * c2;
+}
+
+
+void nlerp(const Quat* a, const Quat* b, Quat* out, float t, int count)
+{
+	// four quaternions per iteration, transposed so each float4 holds one
+	// component of four elements; the hemisphere check picks the per-element
+	// sign of the weight like the scalar nlerp does
+	float4 inv4 = f4Splat(1.0f - t);
+	float4 one4 = f4Splat(1.0f);
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		float4 ax = f4LoadUnaligned(&a[i]);
+		float4 ay = f4LoadUnaligned(&a[i + 1]);
+		float4 az = f4LoadUnaligned(&a[i + 2]);
+		float4 aw = f4LoadUnaligned(&a[i + 3]);
+		float4 bx = f4LoadUnaligned(&b[i]);
+		float4 by = f4LoadUnaligned(&b[i + 1]);
+		float4 bz = f4LoadUnaligned(&b[i + 2]);
+		float4 bw = f4LoadUnaligned(&b[i + 3]);
+		f4Transpose(ax, ay, az, aw);
+		f4Transpose(bx, by, bz, bw);
+
+		float4 dot = f4Add(f4Add(f4Mul(ax, bx), f4Mul(ay, by)), f4Add(f4Mul(az, bz), f4Mul(aw, bw)));
+		int neg = f4MoveMask(dot);
+		float ts[4] = {(neg & 1) ? -t : t,
+			(neg & 2) ? -t : t,
+			(neg & 4) ? -t : t,
+			(neg & 8) ? -t : t};
+		float4 t4 = f4LoadUnaligned(ts);
+
+		float4 ox = f4Add(f4Mul(ax, inv4), f4Mul(bx, t4));
+		float4 oy = f4Add(f4Mul(ay, inv4), f4Mul(by, t4));
+		float4 oz = f4Add(f4Mul(az, inv4), f4Mul(bz, t4));
+		float4 ow = f4Add(f4Mul(aw, inv4), f4Mul(bw, t4));
+		float4 len_sq = f4Add(f4Add(f4Mul(ox, ox), f4Mul(oy, oy)), f4Add(f4Mul(oz, oz), f4Mul(ow, ow)));
+		float4 rcp_len = f4Div(one4, f4Sqrt(len_sq));
+		ox = f4Mul(ox, rcp_len);
+		oy = f4Mul(oy, rcp_len);
+		oz = f4Mul(oz, rcp_len);
+		ow = f4Mul(ow, rcp_len);
+
+		f4Transpose(ox, oy, oz, ow);
+		f4StoreUnaligned(&out[i], ox);
+		f4StoreUnaligned(&out[i + 1], oy);
+		f4StoreUnaligned(&out[i + 2], oz);
+		f4StoreUnaligned(&out[i + 3], ow);
+	}
+	for (; i < count; ++i)
+	{
+		nlerp(a[i], b[i], &out[i], t);
+	}
+}
+
+
+void slerp(const Quat* a, const Quat* b, Quat* out, float t, int count)
+{
+	// trig bound, so there is nothing to vectorize without simd sin/cos;
+	// callers that can live with a normalized lerp should use the nlerp batch
+	for (int i = 0; i < count; ++i)
+	{
+		slerp(a[i], b[i], &out[i], t);
+	}
+}
+
+
+void toMatrices(const Quat* src, Matrix* dst, int count)
+{
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		float4 qx = f4LoadUnaligned(&src[i]);
+		float4 qy = f4LoadUnaligned(&src[i + 1]);
+		float4 qz = f4LoadUnaligned(&src[i + 2]);
+		float4 qw = f4LoadUnaligned(&src[i + 3]);
+		f4Transpose(qx, qy, qz, qw);
+
+		float4 fx = f4Add(qx, qx);
+		float4 fy = f4Add(qy, qy);
+		float4 fz = f4Add(qz, qz);
+		float4 fwx = f4Mul(fx, qw);
+		float4 fwy = f4Mul(fy, qw);
+		float4 fwz = f4Mul(fz, qw);
+		float4 fxx = f4Mul(fx, qx);
+		float4 fxy = f4Mul(fy, qx);
+		float4 fxz = f4Mul(fz, qx);
+		float4 fyy = f4Mul(fy, qy);
+		float4 fyz = f4Mul(fz, qy);
+		float4 fzz = f4Mul(fz, qz);
+
+		float4 one = f4Splat(1.0f);
+		float4 zero = f4Sub(one, one);
+
+		// after the transpose each register is one column of one output
+		// matrix, so the stores hit the 16 floats of a matrix in order
+		float4 c1x = f4Sub(one, f4Add(fyy, fzz));
+		float4 c1y = f4Add(fxy, fwz);
+		float4 c1z = f4Sub(fxz, fwy);
+		float4 c1w = zero;
+		f4Transpose(c1x, c1y, c1z, c1w);
+		f4StoreUnaligned(&dst[i].m11, c1x);
+		f4StoreUnaligned(&dst[i + 1].m11, c1y);
+		f4StoreUnaligned(&dst[i + 2].m11, c1z);
+		f4StoreUnaligned(&dst[i + 3].m11, c1w);
+
+		float4 c2x = f4Sub(fxy, fwz);
+		float4 c2y = f4Sub(one, f4Add(fxx, fzz));
+		float4 c2z = f4Add(fyz, fwx);
+		float4 c2w = zero;
+		f4Transpose(c2x, c2y, c2z, c2w);
+		f4StoreUnaligned(&dst[i].m21, c2x);
+		f4StoreUnaligned(&dst[i + 1].m21, c2y);
+		f4StoreUnaligned(&dst[i + 2].m21, c2z);
+		f4StoreUnaligned(&dst[i + 3].m21, c2w);
+
+		float4 c3x = f4Add(fxz, fwy);
+		float4 c3y = f4Sub(fyz, fwx);
+		float4 c3z = f4Sub(one, f4Add(fxx, fyy));
+		float4 c3w = zero;
+		f4Transpose(c3x, c3y, c3z, c3w);
+		f4StoreUnaligned(&dst[i].m31, c3x);
+		f4StoreUnaligned(&dst[i + 1].m31, c3y);
+		f4StoreUnaligned(&dst[i + 2].m31, c3z);
+		f4StoreUnaligned(&dst[i + 3].m31, c3w);
+
+		for (int j = 0; j < 4; ++j)
+		{
+			dst[i + j].m41 = 0;
+			dst[i + j].m42 = 0;
+			dst[i + j].m43 = 0;
+			dst[i + j].m44 = 1;
+		}
+	}
+	for (; i < count; ++i)
+	{
+		dst[i] = src[i].toMatrix();
+	}
+}
+
+
 Quat Quat::operator*(const Quat& rhs) const
 {
 	return Quat(w * rhs.x + rhs.w * x + y * rhs.z - rhs.y * z,
@@ -57,6 +57,14 @@ struct LUMIX_ENGINE_API Quat
 
 
 LUMIX_ENGINE_API void nlerp(const Quat& q1, const Quat& q2, Quat* out, float t);
+LUMIX_ENGINE_API void slerp(const Quat& q1, const Quat& q2, Quat* out, float t);
+
+// batch kernels shared by pose blending and bone matrix building; four
+// elements per step with a scalar tail, out may alias a or b
+LUMIX_ENGINE_API void nlerp(const Quat* a, const Quat* b, Quat* out, float t, int count);
+LUMIX_ENGINE_API void slerp(const Quat* a, const Quat* b, Quat* out, float t, int count);
+// writes full matrices, the translation is set to zero
+LUMIX_ENGINE_API void toMatrices(const Quat* src, Matrix* dst, int count);
 
 
 } // namespace Lumix
@@ -4,6 +4,7 @@
 #include "engine/log.h"
 #include "engine/lumix.h"
 #include "engine/path.h"
+#include "engine/profiler.h"
 #include "engine/resource.h"
 #include "engine/resource_manager.h"
 #include "engine/resource_manager_base.h"
@@ -31,6 +32,7 @@ Resource::Resource(const Path& path, ResourceManagerBase& resource_manager, IAll
 	, m_cb(allocator)
 	, m_resource_manager(resource_manager)
 	, m_async_op(FS::FileSystem::INVALID_ASYNC)
+	, m_load_record(-1)
 {
 }
 
@@ -46,6 +48,11 @@ void Resource::checkState()
 	if (m_failed_dep_count > 0 && m_current_state != State::FAILURE)
 	{
 		m_current_state = State::FAILURE;
+		if (m_load_record >= 0)
+		{
+			Profiler::setLoadRecordReady(m_load_record, true);
+			m_load_record = -1;
+		}
 		m_cb.invoke(old_state, m_current_state, *this);
 	}
 
@@ -56,6 +63,11 @@ void Resource::checkState()
 		{
 			onBeforeReady();
 			m_current_state = State::READY;
+			if (m_load_record >= 0)
+			{
+				Profiler::setLoadRecordReady(m_load_record, false);
+				m_load_record = -1;
+			}
 			m_cb.invoke(old_state, m_current_state, *this);
 		}
 
@@ -72,10 +84,12 @@ void Resource::fileLoaded(FS::IFile& file, bool success)
 {
 	m_async_op = FS::FileSystem::INVALID_ASYNC;
 	if (m_desired_state != State::READY) return;
-	
+
 	ASSERT(m_current_state != State::READY);
 	ASSERT(m_empty_dep_count == 1);
 
+	Profiler::setLoadRecordFileRead(m_load_record);
+
 	if (!success)
 	{
 		g_log_error.log("Core") << "Could not open " << getPath().c_str();
@@ -90,6 +104,7 @@ void Resource::fileLoaded(FS::IFile& file, bool success)
 	{
 		++m_failed_dep_count;
 	}
+	Profiler::setLoadRecordParsed(m_load_record);
 
 	--m_empty_dep_count;
 	checkState();
@@ -107,6 +122,8 @@ void Resource::doUnload()
 	}
 
 	m_desired_state = State::EMPTY;
+	// a canceled load is not worth a waterfall entry, just drop its record
+	m_load_record = -1;
 	unload();
 	ASSERT(m_empty_dep_count <= 1);
 
@@ -135,6 +152,9 @@ void Resource::doLoad()
 	m_desired_state = State::READY;
 
 	if (m_async_op != FS::FileSystem::INVALID_ASYNC) return;
+	// loads issued directly were never queued, their record starts here
+	if (m_load_record < 0) m_load_record = Profiler::beginLoadRecord(m_path.c_str());
+	Profiler::setLoadRecordIssued(m_load_record);
 	FS::FileSystem& fs = m_resource_manager.getOwner().getFileSystem();
 	FS::ReadCallback cb;
 	cb.bind<Resource, &Resource::fileLoaded>(this);
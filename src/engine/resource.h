@@ -68,6 +68,10 @@ protected:
 	virtual void onBeforeReady() {}
 	virtual void unload(void) = 0;
 	virtual bool load(FS::IFile& file) = 0;
+	// called on reload while the resource is ready; patch the loaded data in
+	// place and return true to keep GPU objects and dependents intact, or
+	// return false to fall back to the full unload/load
+	virtual bool reloadInPlace(FS::IFile& file) { return false; }
 
 	void onCreated(State state);
 	void doUnload();
@@ -101,6 +105,8 @@ private:
 	u16 m_failed_dep_count;
 	State m_current_state;
 	u32 m_async_op;
+	// Profiler load record of the load in flight, -1 when telemetry is off
+	i32 m_load_record;
 }; // class Resource
 
 
@@ -49,6 +49,14 @@ namespace Lumix
 		}
 	}
 
+	void ResourceManager::updateLoadQueues(int max_count)
+	{
+		for (auto* manager : m_resource_managers)
+		{
+			manager->updateLoadQueue(max_count);
+		}
+	}
+
 	void ResourceManager::enableUnload(bool enable)
 	{
 		for (auto* manager : m_resource_managers)
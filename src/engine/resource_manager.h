@@ -1,7 +1,7 @@
 #pragma once
 
 
-#include "engine/hash_map.h"
+#include "engine/flat_hash_map.h"
 
 
 namespace Lumix
@@ -24,7 +24,7 @@ class ResourceManagerBase;
 
 class LUMIX_ENGINE_API ResourceManager
 {
-	typedef HashMap<u32, ResourceManagerBase*> ResourceManagerTable;
+	typedef FlatHashMap<u32, ResourceManagerBase*> ResourceManagerTable;
 
 public:
 	explicit ResourceManager(IAllocator& allocator);
@@ -41,6 +41,7 @@ public:
 	void remove(ResourceType type);
 	void reload(const Path& path);
 	void removeUnreferenced();
+	void updateLoadQueues(int max_count);
 	void enableUnload(bool enable);
 
 	FS::FileSystem& getFileSystem() { return *m_file_system; }
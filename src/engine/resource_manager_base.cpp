@@ -4,6 +4,7 @@
 #include "engine/lumix.h"
 #include "engine/path.h"
 #include "engine/path_utils.h"
+#include "engine/profiler.h"
 #include "engine/resource.h"
 #include "engine/resource_manager.h"
 
@@ -18,6 +19,7 @@ namespace Lumix
 
 	void ResourceManagerBase::destroy(void)
 	{
+		m_load_queue.clear();
 		for (auto iter = m_resources.begin(), end = m_resources.end(); iter != end; ++iter)
 		{
 			Resource* resource = iter.value();
@@ -61,6 +63,62 @@ namespace Lumix
 		return resource;
 	}
 
+
+	// queues the load instead of issuing it immediately; smaller distance to
+	// the camera means higher priority, so the key is the priority negated
+	Resource* ResourceManagerBase::load(const Path& path, float priority)
+	{
+		Resource* resource = get(path);
+
+		if(nullptr == resource)
+		{
+			resource = createResource(path);
+			m_resources.insert(path.getHash(), resource);
+		}
+
+		if(resource->isEmpty())
+		{
+			// queue time starts now; doLoad stamps the record again when the
+			// read is actually issued
+			if (resource->m_load_record < 0)
+			{
+				resource->m_load_record = Profiler::beginLoadRecord(path.c_str());
+			}
+			if (!m_load_queue.decreaseKey(resource, -priority))
+			{
+				m_load_queue.insert(-priority, resource);
+			}
+		}
+
+		resource->addRef();
+		return resource;
+	}
+
+
+	// raises the queued load priority of an already requested resource without
+	// touching its reference count; does nothing once the load has been issued
+	void ResourceManagerBase::prioritize(Resource& resource, float priority)
+	{
+		if (!resource.isEmpty() || resource.getRefCount() <= 0) return;
+
+		if (!m_load_queue.decreaseKey(&resource, -priority))
+		{
+			m_load_queue.insert(-priority, &resource);
+		}
+	}
+
+
+	void ResourceManagerBase::updateLoadQueue(int max_count)
+	{
+		for (int i = 0; i < max_count && !m_load_queue.empty(); ++i)
+		{
+			Resource* resource = m_load_queue.top();
+			m_load_queue.pop();
+			if (resource->isEmpty() && resource->getRefCount() > 0) resource->doLoad();
+		}
+	}
+
+
 	void ResourceManagerBase::removeUnreferenced()
 	{
 		if (!m_is_unload_enabled) return;
@@ -73,6 +131,7 @@ namespace Lumix
 
 		for (auto* i : to_remove)
 		{
+			m_load_queue.remove(i);
 			m_resources.erase(i->getPath().getHash());
 			destroyResource(*i);
 		}
@@ -100,6 +159,9 @@ namespace Lumix
 		ASSERT(new_ref_count >= 0);
 		if(new_ref_count == 0 && m_is_unload_enabled)
 		{
+			// a load that is only queued is obsolete now, drop it before it
+			// issues any IO; in-flight reads are canceled by doUnload
+			m_load_queue.remove(&resource);
 			resource.doUnload();
 		}
 	}
@@ -112,6 +174,19 @@ namespace Lumix
 
 	void ResourceManagerBase::reload(Resource& resource)
 	{
+		if (resource.isReady())
+		{
+			// let the resource patch itself in place first; a successful patch
+			// keeps GPU objects stable and spares dependents a reload cascade
+			FS::FileSystem& fs = m_owner->getFileSystem();
+			FS::IFile* file = fs.open(fs.getDefaultDevice(), resource.getPath(), FS::Mode::OPEN_AND_READ);
+			if (file)
+			{
+				bool patched = resource.reloadInPlace(*file);
+				fs.close(*file);
+				if (patched) return;
+			}
+		}
 		resource.doUnload();
 		resource.doLoad();
 	}
@@ -133,6 +208,7 @@ namespace Lumix
 	ResourceManagerBase::ResourceManagerBase(IAllocator& allocator)
 		: m_size(0)
 		, m_resources(allocator)
+		, m_load_queue(allocator)
 		, m_allocator(allocator)
 		, m_owner(nullptr)
 		, m_is_unload_enabled(true)
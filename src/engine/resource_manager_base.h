@@ -1,7 +1,8 @@
 #pragma once
 
 
-#include "engine/hash_map.h"
+#include "engine/binary_heap.h"
+#include "engine/flat_hash_map.h"
 
 
 namespace Lumix
@@ -24,7 +25,7 @@ class LUMIX_ENGINE_API ResourceManagerBase
 {
 	friend class Resource;
 public:
-	typedef HashMap<u32, Resource*> ResourceTable;
+	typedef FlatHashMap<u32, Resource*> ResourceTable;
 
 public:
 	void create(ResourceType type, ResourceManager& owner);
@@ -33,7 +34,10 @@ public:
 	void enableUnload(bool enable);
 
 	Resource* load(const Path& path);
+	Resource* load(const Path& path, float priority);
 	void load(Resource& resource);
+	void prioritize(Resource& resource, float priority);
+	void updateLoadQueue(int max_count);
 	void removeUnreferenced();
 
 	void unload(const Path& path);
@@ -56,6 +60,7 @@ private:
 	IAllocator& m_allocator;
 	u32 m_size;
 	ResourceTable m_resources;
+	BinaryHeap<float, Resource*> m_load_queue;
 	ResourceManager* m_owner;
 	bool m_is_unload_enabled;
 };
@@ -0,0 +1,74 @@
+#pragma once
+
+
+#include "engine/array.h"
+#include "engine/delegate.h"
+#include "engine/mt/sync.h"
+
+
+namespace Lumix
+{
+template <typename T> class SafeDelegateList;
+
+// DelegateList that may be bound, unbound and invoked from any thread.
+// invoke() copies the listeners under a shared read lock and calls them with
+// no lock held, so callbacks are free to bind/unbind - at most they can still
+// receive one broadcast that raced their unbind. Mutations take the write
+// lock and are expected to be rare compared to broadcasts.
+template <typename R, typename... Args> class SafeDelegateList<R(Args...)>
+{
+public:
+	SafeDelegateList(IAllocator& allocator)
+		: m_allocator(allocator)
+		, m_delegates(allocator)
+	{
+	}
+
+	template <typename C, R (C::*Function)(Args...)> void bind(C* instance)
+	{
+		Delegate<R(Args...)> cb;
+		cb.template bind<C, Function>(instance);
+		MT::WriteLock lock(m_lock);
+		m_delegates.push(cb);
+	}
+
+	template <R (*Function)(Args...)> void bind()
+	{
+		Delegate<R(Args...)> cb;
+		cb.template bind<Function>();
+		MT::WriteLock lock(m_lock);
+		m_delegates.push(cb);
+	}
+
+	template <typename C, R (C::*Function)(Args...)> void unbind(C* instance)
+	{
+		Delegate<R(Args...)> cb;
+		cb.template bind<C, Function>(instance);
+		MT::WriteLock lock(m_lock);
+		for (int i = 0; i < m_delegates.size(); ++i)
+		{
+			if (m_delegates[i] == cb)
+			{
+				m_delegates.eraseFast(i);
+				break;
+			}
+		}
+	}
+
+	void invoke(Args... args)
+	{
+		InlineArray<Delegate<R(Args...)>, 8> copy(m_allocator);
+		{
+			MT::ReadLock lock(m_lock);
+			for (auto& i : m_delegates) copy.push(i);
+		}
+		for (auto& i : copy) i.invoke(args...);
+	}
+
+private:
+	IAllocator& m_allocator;
+	MT::RWLock m_lock;
+	Array<Delegate<R(Args...)>> m_delegates;
+};
+
+} // namespace Lumix
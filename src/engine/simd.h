@@ -4,17 +4,39 @@
 #include "engine/lumix.h"
 
 
-#ifdef _WIN32
-	#include <xmmintrin.h>
+#if defined _WIN32 || defined __SSE2__
+	#define LUMIX_SIMD_SSE
+#elif defined __wasm_simd128__
+	#define LUMIX_SIMD_WASM
+#endif
+
+#ifdef LUMIX_SIMD_SSE
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#endif
+#elif defined LUMIX_SIMD_WASM
+	#include <wasm_simd128.h>
 #else
 	#include <cmath>
 #endif
 
+// the 8-wide tier is compiled in even when the build's baseline arch is SSE;
+// MSVC emits AVX2 instructions regardless of /arch and GCC enables them per
+// function through this attribute, so callers must gate on hasAVX2() at
+// runtime
+#if defined LUMIX_SIMD_SSE && defined __GNUC__ && !defined __AVX2__
+	#define LUMIX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+	#define LUMIX_TARGET_AVX2
+#endif
+
 namespace Lumix
 {
 
 
-#ifdef _WIN32
+#ifdef LUMIX_SIMD_SSE
+	#define LUMIX_SIMD_AVX2
 	typedef __m128 float4;
 
 
@@ -42,6 +64,12 @@ namespace Lumix
 	}
 
 
+	LUMIX_FORCE_INLINE void f4StoreUnaligned(void* dest, float4 src)
+	{
+		_mm_storeu_ps((float*)dest, src);
+	}
+
+
 	LUMIX_FORCE_INLINE int f4MoveMask(float4 a)
 	{
 		return _mm_movemask_ps(a);
@@ -101,7 +129,150 @@ namespace Lumix
 		return _mm_max_ps(a, b);
 	}
 
-#else 
+
+	LUMIX_FORCE_INLINE float4 f4UnpackLo(float4 a, float4 b)
+	{
+		return _mm_unpacklo_ps(a, b);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4UnpackHi(float4 a, float4 b)
+	{
+		return _mm_unpackhi_ps(a, b);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4MoveLH(float4 a, float4 b)
+	{
+		return _mm_movelh_ps(a, b);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4MoveHL(float4 a, float4 b)
+	{
+		return _mm_movehl_ps(a, b);
+	}
+
+#elif defined LUMIX_SIMD_WASM
+	typedef v128_t float4;
+
+
+	LUMIX_FORCE_INLINE float4 f4LoadUnaligned(const void* src)
+	{
+		return wasm_v128_load(src);
+	}
+
+
+	// wasm loads carry no alignment requirement, aligned is the same op
+	LUMIX_FORCE_INLINE float4 f4Load(const void* src)
+	{
+		return wasm_v128_load(src);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4Splat(float value)
+	{
+		return wasm_f32x4_splat(value);
+	}
+
+
+	LUMIX_FORCE_INLINE void f4Store(void* dest, float4 src)
+	{
+		wasm_v128_store(dest, src);
+	}
+
+
+	LUMIX_FORCE_INLINE void f4StoreUnaligned(void* dest, float4 src)
+	{
+		wasm_v128_store(dest, src);
+	}
+
+
+	LUMIX_FORCE_INLINE int f4MoveMask(float4 a)
+	{
+		return wasm_i32x4_bitmask(a);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4Add(float4 a, float4 b)
+	{
+		return wasm_f32x4_add(a, b);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4Sub(float4 a, float4 b)
+	{
+		return wasm_f32x4_sub(a, b);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4Mul(float4 a, float4 b)
+	{
+		return wasm_f32x4_mul(a, b);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4Div(float4 a, float4 b)
+	{
+		return wasm_f32x4_div(a, b);
+	}
+
+
+	// wasm has no reciprocal approximations, full precision stands in
+	LUMIX_FORCE_INLINE float4 f4Rcp(float4 a)
+	{
+		return wasm_f32x4_div(wasm_f32x4_splat(1.0f), a);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4Sqrt(float4 a)
+	{
+		return wasm_f32x4_sqrt(a);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4Rsqrt(float4 a)
+	{
+		return wasm_f32x4_div(wasm_f32x4_splat(1.0f), wasm_f32x4_sqrt(a));
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4Min(float4 a, float4 b)
+	{
+		return wasm_f32x4_min(a, b);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4Max(float4 a, float4 b)
+	{
+		return wasm_f32x4_max(a, b);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4UnpackLo(float4 a, float4 b)
+	{
+		return wasm_i32x4_shuffle(a, b, 0, 4, 1, 5);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4UnpackHi(float4 a, float4 b)
+	{
+		return wasm_i32x4_shuffle(a, b, 2, 6, 3, 7);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4MoveLH(float4 a, float4 b)
+	{
+		return wasm_i32x4_shuffle(a, b, 0, 1, 4, 5);
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4MoveHL(float4 a, float4 b)
+	{
+		return wasm_i32x4_shuffle(a, b, 6, 7, 2, 3);
+	}
+
+#else
 	struct float4
 	{
 		float x, y, z, w;
@@ -132,6 +303,12 @@ namespace Lumix
 	}
 
 
+	LUMIX_FORCE_INLINE void f4StoreUnaligned(void* dest, float4 src)
+	{
+		(*(float4*)dest) = src;
+	}
+
+
 	LUMIX_FORCE_INLINE int f4MoveMask(float4 a)
 	{
 		return (a.w < 0 ? (1 << 3) : 0) | 
@@ -239,6 +416,254 @@ namespace Lumix
 		};
 	}
 
+
+	LUMIX_FORCE_INLINE float4 f4UnpackLo(float4 a, float4 b)
+	{
+		return {a.x, b.x, a.y, b.y};
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4UnpackHi(float4 a, float4 b)
+	{
+		return {a.z, b.z, a.w, b.w};
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4MoveLH(float4 a, float4 b)
+	{
+		return {a.x, a.y, b.x, b.y};
+	}
+
+
+	LUMIX_FORCE_INLINE float4 f4MoveHL(float4 a, float4 b)
+	{
+		return {b.z, b.w, a.z, a.w};
+	}
+
+#endif
+
+
+// in-place 4x4 transpose, the usual AoS <-> SoA shuffle
+LUMIX_FORCE_INLINE void f4Transpose(float4& r0, float4& r1, float4& r2, float4& r3)
+{
+	float4 t0 = f4UnpackLo(r0, r1);
+	float4 t1 = f4UnpackLo(r2, r3);
+	float4 t2 = f4UnpackHi(r0, r1);
+	float4 t3 = f4UnpackHi(r2, r3);
+	r0 = f4MoveLH(t0, t1);
+	r1 = f4MoveHL(t1, t0);
+	r2 = f4MoveLH(t2, t3);
+	r3 = f4MoveHL(t3, t2);
+}
+
+
+#ifdef LUMIX_SIMD_AVX2
+	typedef __m256 float8;
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE float8 f8LoadUnaligned(const void* src)
+	{
+		return _mm256_loadu_ps((const float*)(src));
+	}
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE float8 f8Load(const void* src)
+	{
+		return _mm256_load_ps((const float*)(src));
+	}
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE float8 f8Splat(float value)
+	{
+		return _mm256_set1_ps(value);
+	}
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE void f8Store(void* dest, float8 src)
+	{
+		_mm256_store_ps((float*)dest, src);
+	}
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE void f8StoreUnaligned(void* dest, float8 src)
+	{
+		_mm256_storeu_ps((float*)dest, src);
+	}
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE int f8MoveMask(float8 a)
+	{
+		return _mm256_movemask_ps(a);
+	}
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE float8 f8Add(float8 a, float8 b)
+	{
+		return _mm256_add_ps(a, b);
+	}
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE float8 f8Sub(float8 a, float8 b)
+	{
+		return _mm256_sub_ps(a, b);
+	}
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE float8 f8Mul(float8 a, float8 b)
+	{
+		return _mm256_mul_ps(a, b);
+	}
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE float8 f8Div(float8 a, float8 b)
+	{
+		return _mm256_div_ps(a, b);
+	}
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE float8 f8Min(float8 a, float8 b)
+	{
+		return _mm256_min_ps(a, b);
+	}
+
+
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE float8 f8Max(float8 a, float8 b)
+	{
+		return _mm256_max_ps(a, b);
+	}
+
+
+	// a * b + c
+	LUMIX_TARGET_AVX2 LUMIX_FORCE_INLINE float8 f8Fmadd(float8 a, float8 b, float8 c)
+	{
+		return _mm256_fmadd_ps(a, b, c);
+	}
+
+
+	LUMIX_FORCE_INLINE bool detectAVX2()
+	{
+		#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7) return false;
+			__cpuid(info, 1);
+			// FMA, OSXSAVE and AVX; a kernel that does not save ymm state would
+			// corrupt registers on context switch
+			if ((info[2] & (1 << 12)) == 0) return false;
+			if ((info[2] & (1 << 27)) == 0) return false;
+			if ((info[2] & (1 << 28)) == 0) return false;
+			if ((_xgetbv(0) & 6) != 6) return false;
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+		#else
+			return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+		#endif
+	}
+
+
+	// true when the CPU and the OS support AVX2 and FMA; every use of float8
+	// intrinsics must be behind this check
+	inline bool hasAVX2()
+	{
+		static const bool has_avx2 = detectAVX2();
+		return has_avx2;
+	}
+
+#else
+	// pair of float4 so portable code can use the 8-wide API unconditionally
+	struct float8
+	{
+		float4 lo;
+		float4 hi;
+	};
+
+
+	LUMIX_FORCE_INLINE float8 f8LoadUnaligned(const void* src)
+	{
+		return {f4LoadUnaligned(src), f4LoadUnaligned((const float*)src + 4)};
+	}
+
+
+	LUMIX_FORCE_INLINE float8 f8Load(const void* src)
+	{
+		return {f4Load(src), f4Load((const float*)src + 4)};
+	}
+
+
+	LUMIX_FORCE_INLINE float8 f8Splat(float value)
+	{
+		return {f4Splat(value), f4Splat(value)};
+	}
+
+
+	LUMIX_FORCE_INLINE void f8Store(void* dest, float8 src)
+	{
+		f4Store(dest, src.lo);
+		f4Store((float*)dest + 4, src.hi);
+	}
+
+
+	LUMIX_FORCE_INLINE void f8StoreUnaligned(void* dest, float8 src)
+	{
+		f4StoreUnaligned(dest, src.lo);
+		f4StoreUnaligned((float*)dest + 4, src.hi);
+	}
+
+
+	LUMIX_FORCE_INLINE int f8MoveMask(float8 a)
+	{
+		return f4MoveMask(a.lo) | (f4MoveMask(a.hi) << 4);
+	}
+
+
+	LUMIX_FORCE_INLINE float8 f8Add(float8 a, float8 b)
+	{
+		return {f4Add(a.lo, b.lo), f4Add(a.hi, b.hi)};
+	}
+
+
+	LUMIX_FORCE_INLINE float8 f8Sub(float8 a, float8 b)
+	{
+		return {f4Sub(a.lo, b.lo), f4Sub(a.hi, b.hi)};
+	}
+
+
+	LUMIX_FORCE_INLINE float8 f8Mul(float8 a, float8 b)
+	{
+		return {f4Mul(a.lo, b.lo), f4Mul(a.hi, b.hi)};
+	}
+
+
+	LUMIX_FORCE_INLINE float8 f8Div(float8 a, float8 b)
+	{
+		return {f4Div(a.lo, b.lo), f4Div(a.hi, b.hi)};
+	}
+
+
+	LUMIX_FORCE_INLINE float8 f8Min(float8 a, float8 b)
+	{
+		return {f4Min(a.lo, b.lo), f4Min(a.hi, b.hi)};
+	}
+
+
+	LUMIX_FORCE_INLINE float8 f8Max(float8 a, float8 b)
+	{
+		return {f4Max(a.lo, b.lo), f4Max(a.hi, b.hi)};
+	}
+
+
+	// a * b + c
+	LUMIX_FORCE_INLINE float8 f8Fmadd(float8 a, float8 b, float8 c)
+	{
+		return {f4Add(f4Mul(a.lo, b.lo), c.lo), f4Add(f4Mul(a.hi, b.hi), c.hi)};
+	}
+
+
+	inline bool hasAVX2()
+	{
+		return false;
+	}
+
 #endif
 
 
@@ -0,0 +1,182 @@
+#pragma once
+
+
+#include "engine/lumix.h"
+#include "engine/math_utils.h"
+#include "engine/mtjd/for_each.h"
+
+
+namespace Lumix
+{
+
+
+// LSD radix sort on byte digits; keys must be an unsigned type and values move
+// with their keys. The temp arrays must hold count elements. Passes whose
+// digit is the same across the whole array are skipped, so sorting pointers or
+// keys with a narrow range does only the work the data needs.
+template <typename Key, typename Value>
+void radixSort(Key* keys, Value* values, Key* temp_keys, Value* temp_values, int count)
+{
+	if (count == 0) return;
+
+	Key* src_keys = keys;
+	Value* src_values = values;
+	Key* dst_keys = temp_keys;
+	Value* dst_values = temp_values;
+	for (int pass = 0; pass < (int)sizeof(Key); ++pass)
+	{
+		int shift = pass * 8;
+		u32 histogram[256] = {};
+		for (int i = 0; i < count; ++i)
+		{
+			++histogram[(src_keys[i] >> shift) & 0xff];
+		}
+		if (histogram[(src_keys[0] >> shift) & 0xff] == (u32)count) continue;
+
+		u32 offset = 0;
+		for (int i = 0; i < 256; ++i)
+		{
+			u32 c = histogram[i];
+			histogram[i] = offset;
+			offset += c;
+		}
+		for (int i = 0; i < count; ++i)
+		{
+			u32 idx = histogram[(src_keys[i] >> shift) & 0xff]++;
+			dst_keys[idx] = src_keys[i];
+			dst_values[idx] = src_values[i];
+		}
+
+		Key* tk = src_keys;
+		src_keys = dst_keys;
+		dst_keys = tk;
+		Value* tv = src_values;
+		src_values = dst_values;
+		dst_values = tv;
+	}
+	if (src_keys != keys)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			keys[i] = src_keys[i];
+			values[i] = src_values[i];
+		}
+	}
+}
+
+
+// merges src[left, mid) and src[mid, right) into dst[left, right); equal
+// elements keep their order, which is what makes the sorts below stable
+template <typename T, typename Cmp>
+void mergeSortedRuns(const T* src, T* dst, int left, int mid, int right, const Cmp& cmp)
+{
+	int a = left;
+	int b = mid;
+	int out = left;
+	while (a < mid && b < right)
+	{
+		dst[out++] = cmp(src[b], src[a]) ? src[b++] : src[a++];
+	}
+	while (a < mid) dst[out++] = src[a++];
+	while (b < right) dst[out++] = src[b++];
+}
+
+
+// stable bottom-up merge sort; cmp is a strict weak ordering and temp must
+// hold count elements. No allocation and no comparator calls through function
+// pointers, so it beats qsort on the draw-key sized arrays it is meant for
+template <typename T, typename Cmp>
+void mergeSort(T* data, T* temp, int count, const Cmp& cmp)
+{
+	enum { RUN = 16 };
+	for (int begin = 0; begin < count; begin += RUN)
+	{
+		int end = Math::minimum(begin + RUN, count);
+		for (int i = begin + 1; i < end; ++i)
+		{
+			T value = data[i];
+			int j = i;
+			while (j > begin && cmp(value, data[j - 1]))
+			{
+				data[j] = data[j - 1];
+				--j;
+			}
+			data[j] = value;
+		}
+	}
+
+	T* src = data;
+	T* dst = temp;
+	for (int width = RUN; width < count; width *= 2)
+	{
+		for (int left = 0; left < count; left += 2 * width)
+		{
+			int mid = Math::minimum(left + width, count);
+			int right = Math::minimum(left + 2 * width, count);
+			mergeSortedRuns(src, dst, left, mid, right, cmp);
+		}
+		T* t = src;
+		src = dst;
+		dst = t;
+	}
+	if (src != data)
+	{
+		for (int i = 0; i < count; ++i) data[i] = src[i];
+	}
+}
+
+
+// sorts a power-of-two number of chunks on the worker threads, then merges
+// pairs of chunks level by level, one merge per job; small arrays fall
+// through to the serial sort. temp must hold count elements
+template <typename T, typename Cmp>
+void parallelSort(MTJD::Manager& manager, IAllocator& allocator, T* data, T* temp, int count, const Cmp& cmp)
+{
+	enum { MIN_PARALLEL = 4096 };
+	int workers = (int)manager.getCpuThreadsCount();
+	if (count < MIN_PARALLEL || workers < 2)
+	{
+		mergeSort(data, temp, count, cmp);
+		return;
+	}
+
+	int chunk_count = 1;
+	while (chunk_count < workers) chunk_count *= 2;
+	int chunk_size = (count + chunk_count - 1) / chunk_count;
+
+	MTJD::forEach(manager, allocator, 0, chunk_count, 1, [&](int from, int to) {
+		for (int i = from; i < to; ++i)
+		{
+			int begin = i * chunk_size;
+			if (begin >= count) continue;
+			int end = Math::minimum(begin + chunk_size, count);
+			mergeSort(data + begin, temp + begin, end - begin, cmp);
+		}
+	});
+
+	T* src = data;
+	T* dst = temp;
+	for (int width = chunk_size; width < count; width *= 2)
+	{
+		int pair_count = (count + 2 * width - 1) / (2 * width);
+		MTJD::forEach(manager, allocator, 0, pair_count, 1, [&](int from, int to) {
+			for (int p = from; p < to; ++p)
+			{
+				int left = p * 2 * width;
+				int mid = Math::minimum(left + width, count);
+				int right = Math::minimum(left + 2 * width, count);
+				mergeSortedRuns(src, dst, left, mid, right, cmp);
+			}
+		});
+		T* t = src;
+		src = dst;
+		dst = t;
+	}
+	if (src != data)
+	{
+		for (int i = 0; i < count; ++i) data[i] = src[i];
+	}
+}
+
+
+} // namespace Lumix
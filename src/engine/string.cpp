@@ -144,25 +144,17 @@ const char* findSubstring(const char* haystack, const char* needle)
 
 bool copyNString(char* destination, int length, const char* source, int source_len)
 {
-	if (!source)
+	if (!source || length < 1)
 	{
 		return false;
 	}
 
-	while (*source && length > 1 && source_len)
-	{
-		*destination = *source;
-		--source_len;
-		--length;
-		++destination;
-		++source;
-	}
-	if (length > 0)
-	{
-		*destination = 0;
-		return *source == '\0' || source_len == 0;
-	}
-	return false;
+	const char* source_end = (const char*)memchr(source, 0, source_len);
+	int src_len = source_end ? int(source_end - source) : source_len;
+	int copied = src_len < length - 1 ? src_len : length - 1;
+	memcpy(destination, source, copied);
+	destination[copied] = 0;
+	return copied == src_len;
 }
 
 
@@ -173,15 +165,11 @@ bool copyString(char* destination, int length, const char* source)
 		return false;
 	}
 
-	while (*source && length > 1)
-	{
-		*destination = *source;
-		--length;
-		++destination;
-		++source;
-	}
-	*destination = 0;
-	return *source == '\0';
+	int src_len = (int)strlen(source);
+	int copied = src_len < length - 1 ? src_len : length - 1;
+	memcpy(destination, source, copied);
+	destination[copied] = 0;
+	return copied == src_len;
 }
 
 
@@ -213,23 +201,17 @@ bool catNString(char* destination,
 				const char* source,
 				int source_len)
 {
-	while (*destination && length)
-	{
-		--length;
-		++destination;
-	}
-	return copyNString(destination, length, source, source_len);
+	const char* end = (const char*)memchr(destination, 0, length);
+	int dest_len = end ? int(end - destination) : length;
+	return copyNString(destination + dest_len, length - dest_len, source, source_len);
 }
 
 
 bool catString(char* destination, int length, const char* source)
 {
-	while (*destination && length)
-	{
-		--length;
-		++destination;
-	}
-	return copyString(destination, length, source);
+	const char* end = (const char*)memchr(destination, 0, length);
+	int dest_len = end ? int(end - destination) : length;
+	return copyString(destination + dest_len, length - dest_len, source);
 }
 
 static void reverse(char* str, int length)
@@ -434,37 +416,57 @@ bool toCString(i64 value, char* output, int length)
 	return false;
 }
 
-bool toCString(u64 value, char* output, int length)
+static const char DIGIT_PAIRS[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+
+// produces the digits back to front, two per step through the pair table;
+// returns the first digit, buffer_end is one past the last
+static char* writeDigits(u64 value, char* buffer_end)
 {
-	char* c = output;
-	char* num_start = output;
-	if (length > 0)
+	char* p = buffer_end;
+	while (value >= 100)
 	{
-		if (value == 0)
-		{
-			if (length == 1)
-			{
-				return false;
-			}
-			*c = '0';
-			*(c + 1) = 0;
-			return true;
-		}
-		while (value > 0 && length > 1)
-		{
-			*c = value % 10 + '0';
-			value = value / 10;
-			--length;
-			++c;
-		}
-		if (length > 0)
-		{
-			reverse(num_start, (int)(c - num_start));
-			*c = 0;
-			return true;
-		}
+		int pair = int(value % 100) * 2;
+		value /= 100;
+		p -= 2;
+		p[0] = DIGIT_PAIRS[pair];
+		p[1] = DIGIT_PAIRS[pair + 1];
 	}
-	return false;
+	if (value < 10)
+	{
+		--p;
+		*p = char('0' + value);
+	}
+	else
+	{
+		int pair = int(value) * 2;
+		p -= 2;
+		p[0] = DIGIT_PAIRS[pair];
+		p[1] = DIGIT_PAIRS[pair + 1];
+	}
+	return p;
+}
+
+
+bool toCString(u64 value, char* output, int length)
+{
+	char tmp[20];
+	char* start = writeDigits(value, tmp + sizeof(tmp));
+	int digits = int(tmp + sizeof(tmp) - start);
+	if (digits >= length) return false;
+	memcpy(output, start, digits);
+	output[digits] = 0;
+	return true;
 }
 
 bool toCStringHex(u8 value, char* output, int length)
@@ -496,35 +498,7 @@ bool toCStringHex(u8 value, char* output, int length)
 
 bool toCString(u32 value, char* output, int length)
 {
-	char* c = output;
-	char* num_start = output;
-	if (length > 0)
-	{
-		if (value == 0)
-		{
-			if (length == 1)
-			{
-				return false;
-			}
-			*c = '0';
-			*(c + 1) = 0;
-			return true;
-		}
-		while (value > 0 && length > 1)
-		{
-			*c = value % 10 + '0';
-			value = value / 10;
-			--length;
-			++c;
-		}
-		if (length > 0)
-		{
-			reverse(num_start, (int)(c - num_start));
-			*c = 0;
-			return true;
-		}
-	}
-	return false;
+	return toCString((u64)value, output, length);
 }
 
 static bool increment(char* output, char* end, bool is_space_after)
@@ -579,6 +553,50 @@ bool toCString(float value, char* output, int length, int after_point)
 		value = -value;
 		--length;
 	}
+	if (value < 1.8446743e19f)
+	{
+		// the whole part fits an u64, so it goes through the digit pair
+		// table; the pow/log10 loop below only remains for astronomical
+		// values, nans and infinities
+		double num = value;
+		u64 whole = (u64)num;
+		char tmp[20];
+		char* start = writeDigits(whole, tmp + sizeof(tmp));
+		int digits = int(tmp + sizeof(tmp) - start);
+		if (digits >= length) return false;
+		memcpy(output, start, digits);
+		char* c = output + digits;
+		length -= digits;
+		double dec_part = num - (double)whole;
+		if (length > 1 && after_point > 0)
+		{
+			*c = '.';
+			++c;
+			--length;
+		}
+		else if (length > 0 && after_point == 0)
+		{
+			*c = 0;
+			return true;
+		}
+		else
+		{
+			return false;
+		}
+		while (length > 1 && after_point > 0)
+		{
+			dec_part *= 10;
+			char digit = (char)dec_part;
+			*c = digit + '0';
+			dec_part -= digit;
+			++c;
+			--length;
+			--after_point;
+		}
+		*c = 0;
+		if ((int)(dec_part + 0.5)) increment(output, c - 1, length > 1);
+		return true;
+	}
 	// int part
 	int exponent = value == 0 ? 0 : (int)log10(value);
 	float num = value;
@@ -171,6 +171,15 @@ public:
 		m_cstr[m_size] = 0;
 	}
 
+	base_string(base_string<T>&& rhs)
+		: m_allocator(rhs.m_allocator)
+	{
+		m_cstr = rhs.m_cstr;
+		m_size = rhs.m_size;
+		rhs.m_cstr = nullptr;
+		rhs.m_size = 0;
+	}
+
 	base_string(const T* rhs, IAllocator& allocator)
 		: m_allocator(allocator)
 	{
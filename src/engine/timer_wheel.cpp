@@ -0,0 +1,141 @@
+#include "engine/timer_wheel.h"
+
+
+namespace Lumix
+{
+
+
+static const float SLOT_DURATION = 1 / 30.0f;
+
+
+TimerWheel::TimerWheel(IAllocator& allocator)
+	: m_entries(allocator)
+	, m_first_free(-1)
+	, m_pending_count(0)
+	, m_time(0)
+	, m_last_slot(0)
+{
+	for (int& slot : m_slots) slot = -1;
+}
+
+
+int TimerWheel::getSlot(float deadline) const
+{
+	return (int)(deadline / SLOT_DURATION) & (SLOTS_COUNT - 1);
+}
+
+
+TimerWheel::Handle TimerWheel::add(float delay, const Callback& callback, void* user_data)
+{
+	int idx;
+	if (m_first_free >= 0)
+	{
+		idx = m_first_free;
+		m_first_free = m_entries[idx].next;
+	}
+	else
+	{
+		idx = m_entries.size();
+		ASSERT(idx < 0xffff);
+		m_entries.emplace().generation = 0;
+	}
+
+	Entry& entry = m_entries[idx];
+	entry.callback = callback;
+	entry.user_data = user_data;
+	entry.deadline = m_time + (delay > 0 ? delay : 0);
+	entry.active = true;
+
+	int slot = getSlot(entry.deadline);
+	entry.next = m_slots[slot];
+	m_slots[slot] = idx;
+	++m_pending_count;
+
+	return (Handle)idx | ((Handle)entry.generation << 16);
+}
+
+
+void TimerWheel::cancel(Handle handle)
+{
+	if (handle == INVALID_HANDLE) return;
+
+	int idx = int(handle & 0xffff);
+	u16 generation = u16(handle >> 16);
+	if (idx >= m_entries.size()) return;
+
+	Entry& entry = m_entries[idx];
+	if (!entry.active || entry.generation != generation) return;
+
+	// the slot sweep reclaims the entry
+	entry.active = false;
+	--m_pending_count;
+}
+
+
+void TimerWheel::clear()
+{
+	m_entries.clear();
+	for (int& slot : m_slots) slot = -1;
+	m_first_free = -1;
+	m_pending_count = 0;
+}
+
+
+void TimerWheel::sweep(int slot)
+{
+	// detach the whole chain first; callbacks may add() into this very slot
+	int idx = m_slots[slot];
+	m_slots[slot] = -1;
+
+	while (idx >= 0)
+	{
+		int next = m_entries[idx].next;
+		bool fire = m_entries[idx].active && m_entries[idx].deadline <= m_time;
+		bool keep = m_entries[idx].active && !fire;
+
+		if (keep)
+		{
+			m_entries[idx].next = m_slots[slot];
+			m_slots[slot] = idx;
+		}
+		else
+		{
+			Callback callback = m_entries[idx].callback;
+			void* user_data = m_entries[idx].user_data;
+
+			m_entries[idx].active = false;
+			++m_entries[idx].generation;
+			m_entries[idx].next = m_first_free;
+			m_first_free = idx;
+
+			if (fire)
+			{
+				--m_pending_count;
+				callback.invoke(user_data);
+			}
+		}
+		idx = next;
+	}
+}
+
+
+void TimerWheel::update(float time_delta)
+{
+	m_time += time_delta;
+
+	int target = (int)(m_time / SLOT_DURATION);
+	if (target - m_last_slot >= SLOTS_COUNT)
+	{
+		// a huge step crossed the whole wheel; one revolution covers it
+		m_last_slot = target - SLOTS_COUNT + 1;
+	}
+
+	for (int abs_slot = m_last_slot; abs_slot <= target; ++abs_slot)
+	{
+		sweep(abs_slot & (SLOTS_COUNT - 1));
+	}
+	m_last_slot = target;
+}
+
+
+} // namespace Lumix
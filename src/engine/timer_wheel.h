@@ -0,0 +1,66 @@
+#pragma once
+
+
+#include "engine/array.h"
+#include "engine/delegate.h"
+
+
+namespace Lumix
+{
+
+
+// Hashed timer wheel: pending timers hash into a fixed ring of slots by
+// deadline, so add() and cancel() are O(1) and update() only walks the slots
+// the elapsed time crossed - no per-frame scan over every pending timer.
+// Callbacks fire from update(), on the calling thread; a callback that wants
+// to run wide can schedule an MTJD job itself.
+class LUMIX_ENGINE_API TimerWheel
+{
+public:
+	typedef u32 Handle;
+	typedef Delegate<void(void*)> Callback;
+
+	enum : Handle
+	{
+		INVALID_HANDLE = 0xffffFFFF
+	};
+
+	explicit TimerWheel(IAllocator& allocator);
+
+	Handle add(float delay, const Callback& callback, void* user_data);
+	void cancel(Handle handle);
+	void clear();
+	// advances time and fires every timer whose deadline passed; callbacks
+	// may add or cancel timers on this wheel
+	void update(float time_delta);
+	int getPendingCount() const { return m_pending_count; }
+
+private:
+	enum
+	{
+		SLOTS_COUNT = 256 // power of two
+	};
+
+	struct Entry
+	{
+		Callback callback;
+		void* user_data;
+		float deadline;
+		int next;
+		u16 generation;
+		bool active;
+	};
+
+	int getSlot(float deadline) const;
+	void sweep(int slot);
+
+	Array<Entry> m_entries;
+	int m_slots[SLOTS_COUNT];
+	int m_first_free;
+	int m_pending_count;
+	float m_time;
+	int m_last_slot;
+};
+
+
+} // namespace Lumix
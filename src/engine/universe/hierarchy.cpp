@@ -26,13 +26,15 @@ public:
 		: m_universe(universe)
 		, m_parents(allocator)
 		, m_children(allocator)
+		, m_dirty(allocator)
+		, m_dirty_set(allocator)
 		, m_allocator(allocator)
 		, m_system(system)
 	{
 		universe.registerComponentType(HIERARCHY_TYPE_HANDLE, this, &HierarchyImpl::serializeComponent, &HierarchyImpl::deserializeComponent);
 		m_is_processing = false;
 		universe.entityDestroyed().bind<HierarchyImpl, &HierarchyImpl::onEntityDestroyed>(this);
-		universe.entityTransformed().bind<HierarchyImpl, &HierarchyImpl::onEntityMoved>(this);
+		universe.entityTransformed().bind<HierarchyImpl, &HierarchyImpl::onEntitiesMoved>(this);
 	}
 
 
@@ -46,6 +48,8 @@ public:
 		}
 		m_children.clear();
 		m_parents.clear();
+		m_dirty.clear();
+		m_dirty_set.clear();
 	}
 
 
@@ -101,6 +105,57 @@ public:
 
 	IPlugin& getPlugin() const override { return m_system; }
 	void update(float time_delta, bool paused) override {}
+
+
+	// single recompute pass per frame; parents are flushed before their
+	// children, so each subtree is composed exactly once no matter how many
+	// times its root moved during update
+	void lateUpdate(float time_delta, bool paused) override
+	{
+		if (m_dirty.empty()) return;
+
+		m_is_processing = true;
+		Array<Entity> moved_entities(m_allocator);
+		Array<Transform> moved_transforms(m_allocator);
+		// setTransforms marks moved children with children of their own, so
+		// deeper levels are appended to m_dirty and handled in this same loop
+		for (int i = 0; i < m_dirty.size(); ++i)
+		{
+			Entity entity = m_dirty[i];
+			m_dirty_set.erase(m_dirty_set.find(entity));
+			Children::iterator iter = m_children.find(entity);
+			if (!iter.isValid()) continue;
+
+			Transform parent_transform = m_universe.getTransform(entity);
+			Array<Child>& children = *iter.value();
+			moved_entities.clear();
+			moved_transforms.clear();
+			for (int j = 0, c = children.size(); j < c; ++j)
+			{
+				moved_entities.push(children[j].m_entity);
+				moved_transforms.push(parent_transform * children[j].m_local_transform);
+			}
+			if (!moved_entities.empty())
+			{
+				m_universe.setTransforms(&moved_entities[0], &moved_transforms[0], moved_entities.size());
+			}
+		}
+		m_dirty.clear();
+		m_is_processing = false;
+	}
+
+
+	// update is a no-op and the dirty flush runs in lateUpdate, which the
+	// engine calls serially after the concurrent phases
+	UpdateAccess getUpdateAccess() const override
+	{
+		UpdateAccess access;
+		access.component_reads = 0;
+		access.component_writes = 0;
+		access.transform_read = false;
+		access.transform_write = false;
+		return access;
+	}
 	Universe& getUniverse() override { return m_universe; }
 	IAllocator& getAllocator() { return m_allocator; }
 
@@ -127,21 +182,26 @@ public:
 	}
 
 
+	void onEntitiesMoved(const Entity* entities, int count)
+	{
+		for (int i = 0; i < count; ++i) onEntityMoved(entities[i]);
+	}
+
+
+	void markChildrenDirty(Entity entity)
+	{
+		if (!m_children.find(entity).isValid()) return;
+		if (m_dirty_set.find(entity).isValid()) return;
+		m_dirty_set.insert(entity, true);
+		m_dirty.push(entity);
+	}
+
+
 	void onEntityMoved(Entity entity)
 	{
-		bool was_processing = m_is_processing;
-		m_is_processing = true;
-		Children::iterator iter = m_children.find(entity);
-		if (iter.isValid())
-		{
-			Transform parent_transform = m_universe.getTransform(entity);
-			Array<Child>& children = *iter.value();
-			for (int i = 0, c = children.size(); i < c; ++i)
-			{
-				m_universe.setTransform(children[i].m_entity, parent_transform * children[i].m_local_transform);
-			}
-		}
-		m_is_processing = was_processing;
+		// children are not recomputed here; repeated moves of the same parent
+		// within a frame collapse into a single recompute in lateUpdate
+		markChildrenDirty(entity);
 
 		if (m_is_processing) return;
 
@@ -406,6 +466,8 @@ private:
 	Universe& m_universe;
 	Parents m_parents;
 	Children m_children;
+	Array<Entity> m_dirty;
+	HashMap<Entity, bool> m_dirty_set;
 	IPlugin& m_system;
 	bool m_is_processing;
 };
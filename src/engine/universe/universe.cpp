@@ -8,6 +8,7 @@
 #include "engine/property_register.h"
 #include "engine/serializer.h"
 #include <cstdint>
+#include <cstdlib>
 
 
 namespace Lumix
@@ -34,11 +35,31 @@ Universe::Universe(IAllocator& allocator)
 	, m_entity_moved(m_allocator)
 	, m_first_free_slot(-1)
 	, m_scenes(m_allocator)
+	, m_pending_destroy(m_allocator)
+	, m_transform_snapshot_0(m_allocator)
+	, m_transform_snapshot_1(m_allocator)
+	, m_published_snapshot(nullptr)
+	, m_back_snapshot(&m_transform_snapshot_0)
 {
 	m_entities.reserve(RESERVED_ENTITIES_COUNT);
 }
 
 
+void Universe::publishTransformSnapshot()
+{
+	Array<Transform>& back = *m_back_snapshot;
+	back.resize(m_entities.size());
+	for (int i = 0; i < m_entities.size(); ++i)
+	{
+		const EntityData& data = m_entities[i];
+		if (!data.valid) continue;
+		back[i] = Transform(data.position, data.rotation);
+	}
+	m_published_snapshot = &back;
+	m_back_snapshot = &back == &m_transform_snapshot_0 ? &m_transform_snapshot_1 : &m_transform_snapshot_0;
+}
+
+
 IScene* Universe::getScene(ComponentType type) const
 {
 	return m_component_type_map[type.index].scene;
@@ -85,14 +106,14 @@ const Quat& Universe::getRotation(Entity entity) const
 void Universe::setRotation(Entity entity, const Quat& rot)
 {
 	m_entities[entity.index].rotation = rot;
-	entityTransformed().invoke(entity);
+	entityTransformed().invoke(&entity, 1);
 }
 
 
 void Universe::setRotation(Entity entity, float x, float y, float z, float w)
 {
 	m_entities[entity.index].rotation.set(x, y, z, w);
-	entityTransformed().invoke(entity);
+	entityTransformed().invoke(&entity, 1);
 }
 
 
@@ -106,7 +127,7 @@ void Universe::setMatrix(Entity entity, const Matrix& mtx)
 {
 	EntityData& out = m_entities[entity.index];
 	mtx.decompose(out.position, out.rotation, out.scale);
-	entityTransformed().invoke(entity);
+	entityTransformed().invoke(&entity, 1);
 }
 
 
@@ -124,7 +145,21 @@ void Universe::setTransform(Entity entity, const Transform& transform)
 	auto& tmp = m_entities[entity.index];
 	tmp.position = transform.pos;
 	tmp.rotation = transform.rot;
-	entityTransformed().invoke(entity);
+	entityTransformed().invoke(&entity, 1);
+}
+
+
+void Universe::setTransforms(const Entity* entities, const Transform* transforms, int count)
+{
+	if (count == 0) return;
+
+	for (int i = 0; i < count; ++i)
+	{
+		auto& tmp = m_entities[entities[i].index];
+		tmp.position = transforms[i].pos;
+		tmp.rotation = transforms[i].rot;
+	}
+	entityTransformed().invoke(entities, count);
 }
 
 
@@ -149,7 +184,7 @@ void Universe::setPosition(Entity entity, float x, float y, float z)
 {
 	auto& transform = m_entities[entity.index];
 	transform.position.set(x, y, z);
-	entityTransformed().invoke(entity);
+	entityTransformed().invoke(&entity, 1);
 }
 
 
@@ -157,7 +192,7 @@ void Universe::setPosition(Entity entity, const Vec3& pos)
 {
 	auto& transform = m_entities[entity.index];
 	transform.position = pos;
-	entityTransformed().invoke(entity);
+	entityTransformed().invoke(&entity, 1);
 }
 
 
@@ -289,6 +324,40 @@ void Universe::destroyEntity(Entity entity)
 }
 
 
+void Universe::deferDestroyEntity(Entity entity)
+{
+	if (!hasEntity(entity)) return;
+	for (Entity e : m_pending_destroy)
+	{
+		if (e == entity) return;
+	}
+	m_pending_destroy.push(entity);
+}
+
+
+static int compareEntities(const void* a, const void* b)
+{
+	return ((const Entity*)a)->index - ((const Entity*)b)->index;
+}
+
+
+void Universe::processDeferredDestruction()
+{
+	if (m_pending_destroy.empty()) return;
+
+	// sorted so scenes tear their per-entity data down in increasing entity
+	// order no matter in which order gameplay marked the entities
+	qsort(&m_pending_destroy[0], m_pending_destroy.size(), sizeof(m_pending_destroy[0]), compareEntities);
+	for (Entity entity : m_pending_destroy)
+	{
+		// an entity can be destroyed directly after being marked
+		if (!hasEntity(entity)) continue;
+		destroyEntity(entity);
+	}
+	m_pending_destroy.clear();
+}
+
+
 Entity Universe::getFirstEntity()
 {
 	for (int i = 0; i < m_entities.size(); ++i)
@@ -355,9 +424,8 @@ void Universe::deserialize(InputBlob& serializer)
 	for (int i = 0; i < count; ++i)
 	{
 		u32 key;
-		char name[50];
 		serializer.read(key);
-		serializer.readString(name, sizeof(name));
+		const char* name = serializer.readStringView();
 		m_id_to_name_map.insert(key, string(name, m_allocator));
 		m_name_to_id_map.insert(crc32(name), key);
 	}
@@ -415,7 +483,7 @@ void Universe::setScale(Entity entity, float scale)
 {
 	auto& transform = m_entities[entity.index];
 	transform.scale = scale;
-	entityTransformed().invoke(entity);
+	entityTransformed().invoke(&entity, 1);
 }
 
 
@@ -472,6 +540,25 @@ bool Universe::hasComponent(Entity entity, ComponentType component_type) const
 }
 
 
+u64 Universe::getComponentsMask(Entity entity) const
+{
+	return m_entities[entity.index].components;
+}
+
+
+void Universe::getEntitiesWithComponents(u64 mask, Array<Entity>& entities) const
+{
+	// one AND per entity over the contiguous entity array; no scene is asked
+	// anything
+	for (int i = 0, c = m_entities.size(); i < c; ++i)
+	{
+		const EntityData& data = m_entities[i];
+		if (!data.valid) continue;
+		if ((data.components & mask) == mask) entities.push({i});
+	}
+}
+
+
 void Universe::destroyComponent(Entity entity, ComponentType component_type, IScene* scene, ComponentHandle index)
 {
 	auto mask = m_entities[entity.index].components;
@@ -53,9 +53,20 @@ public:
 	void createEntity(Entity entity);
 	Entity createEntity(const Vec3& position, const Quat& rotation);
 	void destroyEntity(Entity entity);
+	// marks the entity dead; components are torn down in one entity-ordered
+	// batch at the end-of-frame fence, so handles held by gameplay code stay
+	// valid for the rest of the frame
+	void deferDestroyEntity(Entity entity);
+	// destroys marked entities; the engine calls this once per frame after
+	// the scenes' late update
+	void processDeferredDestruction();
 	void addComponent(Entity entity, ComponentType component_type, IScene* scene, ComponentHandle index);
 	void destroyComponent(Entity entity, ComponentType component_type, IScene* scene, ComponentHandle index);
 	bool hasComponent(Entity entity, ComponentType component_type) const;
+	// bit index = ComponentType::index; maintained at component add/destroy
+	u64 getComponentsMask(Entity entity) const;
+	// appends every valid entity whose mask contains all bits of mask
+	void getEntitiesWithComponents(u64 mask, Array<Entity>& entities) const;
 	ComponentUID getComponent(Entity entity, ComponentType type) const;
 	ComponentUID getFirstComponent(Entity entity) const;
 	ComponentUID getNextComponent(const ComponentUID& cmp) const;
@@ -79,6 +90,9 @@ public:
 	Matrix getPositionAndRotation(Entity entity) const;
 	Matrix getMatrix(Entity entity) const;
 	void setTransform(Entity entity, const Transform& transform);
+	// preferred for bulk movement: writes every transform first, then delivers
+	// one span notification instead of a delegate fan-out per entity
+	void setTransforms(const Entity* entities, const Transform* transforms, int count);
 	Transform getTransform(Entity entity) const;
 	void setRotation(Entity entity, float x, float y, float z, float w);
 	void setRotation(Entity entity, const Quat& rot);
@@ -99,7 +113,8 @@ public:
 		m_name = name; 
 	}
 
-	DelegateList<void(Entity)>& entityTransformed() { return m_entity_moved; }
+	// invoked with a span of moved entities; single setters pass a span of one
+	DelegateList<void(const Entity*, int)>& entityTransformed() { return m_entity_moved; }
 	DelegateList<void(Entity)>& entityCreated() { return m_entity_created; }
 	DelegateList<void(Entity)>& entityDestroyed() { return m_entity_destroyed; }
 	DelegateList<void(const ComponentUID&)>& componentDestroyed() { return m_component_destroyed; }
@@ -115,6 +130,15 @@ public:
 	Array<IScene*>& getScenes();
 	void addScene(IScene* scene);
 
+	// copies entity transforms into the back buffer and publishes it; call at
+	// the frame fence, when no job reading the previous snapshot is still in
+	// flight. Worker jobs can then read last-frame transforms through
+	// getTransformSnapshot() without taking any lock while the main thread
+	// mutates the live entity data.
+	void publishTransformSnapshot();
+	// indexed by entity.index; nullptr until the first publish
+	const Array<Transform>* getTransformSnapshot() const { return m_published_snapshot; }
+
 private:
 	struct EntityData
 	{
@@ -145,11 +169,16 @@ private:
 	Array<EntityData> m_entities;
 	AssociativeArray<u32, u32> m_name_to_id_map;
 	AssociativeArray<u32, string> m_id_to_name_map;
-	DelegateList<void(Entity)> m_entity_moved;
+	DelegateList<void(const Entity*, int)> m_entity_moved;
 	DelegateList<void(Entity)> m_entity_created;
 	DelegateList<void(Entity)> m_entity_destroyed;
 	DelegateList<void(const ComponentUID&)> m_component_destroyed;
 	DelegateList<void(const ComponentUID&)> m_component_added;
+	Array<Transform> m_transform_snapshot_0;
+	Array<Transform> m_transform_snapshot_1;
+	Array<Transform>* m_published_snapshot;
+	Array<Transform>* m_back_snapshot;
+	Array<Entity> m_pending_destroy;
 	int m_first_free_slot;
 	StaticString<64> m_name;
 };
@@ -1,9 +1,14 @@
 #include "engine/input_system.h"
+#include "engine/array.h"
 #include "engine/associative_array.h"
 #include "engine/delegate.h"
 #include "engine/delegate_list.h"
+#include "engine/mt/atomic.h"
+#include "engine/mt/task.h"
+#include "engine/mt/thread.h"
 #include "engine/profiler.h"
 #include "engine/string.h"
+#include "engine/timer.h"
 #include "engine/vec.h"
 
 #include <windows.h>
@@ -17,10 +22,32 @@ namespace Lumix
 static const float DEADZONE = 0.2f;
 
 
+struct InputSystemImpl;
+
+
+// samples the mouse at ~1 kHz so fast gestures are not aliased to the frame rate
+class InputPollTask LUMIX_FINAL : public MT::Task
+{
+public:
+	InputPollTask(InputSystemImpl& system, IAllocator& allocator)
+		: MT::Task(allocator)
+		, m_system(system)
+	{
+	}
+
+	int task() override;
+
+private:
+	InputSystemImpl& m_system;
+};
+
+
 struct InputSystemImpl LUMIX_FINAL : public InputSystem
 {
 	typedef decltype(XInputGetState)* XInputGetState_fn_ptr;
 
+	enum { RING_SIZE = 512 }; // power of two, ~half a second of 1 kHz samples
+
 	explicit InputSystemImpl(IAllocator& allocator)
 		: m_actions(allocator)
 		, m_allocator(allocator)
@@ -29,6 +56,10 @@ struct InputSystemImpl LUMIX_FINAL : public InputSystem
 		, m_injected_mouse_rel_pos(0, 0)
 		, m_xinput_library(nullptr)
 		, m_xinput_get_state(nullptr)
+		, m_events(allocator)
+		, m_poll_task(nullptr)
+		, m_ring_write(0)
+		, m_ring_read(0)
 	{
 		m_last_checked_controller = 0;
 		for (int i = 0; i < Lumix::lengthOf(m_xinput_connected); ++i)
@@ -45,15 +76,38 @@ struct InputSystemImpl LUMIX_FINAL : public InputSystem
 				m_xinput_library = nullptr;
 			}
 		}
+		m_timer = Timer::create(allocator);
+		m_frame_start_time = m_frame_end_time = m_timer->getRawTimeSinceStart();
+		m_poll_task = LUMIX_NEW(allocator, InputPollTask)(*this, allocator);
+		m_poll_task->create("input_poll");
 	}
 
 
 	~InputSystemImpl()
 	{
+		m_poll_task->forceExit(true);
+		m_poll_task->destroy();
+		LUMIX_DELETE(m_allocator, m_poll_task);
+		Timer::destroy(m_timer);
 		if (m_xinput_library) FreeLibrary(m_xinput_library);
 	}
 
 
+	// single producer (the poll task); events that do not fit are dropped, a
+	// frame long enough to fill the ring has bigger problems than input precision
+	void pushEvent(const Event& event)
+	{
+		i32 write = m_ring_write;
+		if (write - m_ring_read >= RING_SIZE) return;
+		m_ring[write & (RING_SIZE - 1)] = event;
+		MT::memoryBarrier(); // the event must be visible before the index
+		m_ring_write = write + 1;
+	}
+
+
+	u64 now() { return m_timer->getRawTimeSinceStart(); }
+
+
 	void enable(bool enabled) override { m_is_enabled = enabled; }
 
 
@@ -75,6 +129,17 @@ struct InputSystemImpl LUMIX_FINAL : public InputSystem
 		}
 		m_mouse_rel_pos = m_injected_mouse_rel_pos;
 		m_injected_mouse_rel_pos = {0, 0};
+
+		m_frame_start_time = m_frame_end_time;
+		m_frame_end_time = m_timer->getRawTimeSinceStart();
+		m_events.clear();
+		i32 write = m_ring_write;
+		MT::memoryBarrier(); // see pushEvent
+		while (m_ring_read != write)
+		{
+			m_events.push(m_ring[m_ring_read & (RING_SIZE - 1)]);
+			++m_ring_read;
+		}
 	}
 
 
@@ -112,6 +177,33 @@ struct InputSystemImpl LUMIX_FINAL : public InputSystem
 	float getMouseXMove() const override { return m_mouse_rel_pos.x; }
 	float getMouseYMove() const override { return m_mouse_rel_pos.y; }
 	Vec2 getMousePos() const override { return m_mouse_pos; }
+	int getEventCount() const override { return m_events.size(); }
+	const Event& getEvent(int index) const override { return m_events[index]; }
+
+
+	Vec2 getMousePosAt(float t) const override
+	{
+		// the poll task samples in screen space while m_mouse_pos is injected in
+		// client space; anchor the sample curve so its last point lands on m_mouse_pos
+		const Event* prev = nullptr;
+		const Event* next = nullptr;
+		const Event* last = nullptr;
+		u64 time = m_frame_start_time + u64(t * float(m_frame_end_time - m_frame_start_time));
+		for (const Event& event : m_events)
+		{
+			if (event.type != Event::MOUSE_MOVE) continue;
+			last = &event;
+			if (event.timestamp <= time) prev = &event;
+			else if (!next) next = &event;
+		}
+		if (!last) return m_mouse_pos;
+		Vec2 offset(m_mouse_pos.x - last->abs_x, m_mouse_pos.y - last->abs_y);
+		if (!prev) return Vec2(next->abs_x + offset.x, next->abs_y + offset.y);
+		if (!next || next->timestamp == prev->timestamp) return Vec2(prev->abs_x + offset.x, prev->abs_y + offset.y);
+		float k = float(time - prev->timestamp) / float(next->timestamp - prev->timestamp);
+		return Vec2(prev->abs_x + (next->abs_x - prev->abs_x) * k + offset.x,
+			prev->abs_y + (next->abs_y - prev->abs_y) * k + offset.y);
+	}
 	bool isMouseDown(MouseButton button) override
 	{
 		switch (button)
@@ -186,9 +278,60 @@ struct InputSystemImpl LUMIX_FINAL : public InputSystem
 	XINPUT_STATE m_xinput_states[XUSER_MAX_COUNT];
 	bool m_xinput_connected[XUSER_MAX_COUNT];
 	u32 m_last_checked_controller;
+	Timer* m_timer;
+	InputPollTask* m_poll_task;
+	Array<Event> m_events;
+	u64 m_frame_start_time;
+	u64 m_frame_end_time;
+	Event m_ring[RING_SIZE];
+	volatile i32 m_ring_write;
+	volatile i32 m_ring_read;
 };
 
 
+int InputPollTask::task()
+{
+	POINT last_pos;
+	GetCursorPos(&last_pos);
+	static const int BUTTON_VKS[] = {VK_LBUTTON, VK_MBUTTON, VK_RBUTTON};
+	bool last_down[lengthOf(BUTTON_VKS)] = {};
+	while (!isForceExit())
+	{
+		POINT pos;
+		if (GetCursorPos(&pos) && (pos.x != last_pos.x || pos.y != last_pos.y))
+		{
+			InputSystem::Event event;
+			event.type = InputSystem::Event::MOUSE_MOVE;
+			event.rel_x = float(pos.x - last_pos.x);
+			event.rel_y = float(pos.y - last_pos.y);
+			event.abs_x = float(pos.x);
+			event.abs_y = float(pos.y);
+			event.timestamp = m_system.now();
+			m_system.pushEvent(event);
+			last_pos = pos;
+		}
+		for (int i = 0; i < lengthOf(BUTTON_VKS); ++i)
+		{
+			bool down = (GetAsyncKeyState(BUTTON_VKS[i]) >> 8) != 0;
+			if (down == last_down[i]) continue;
+			InputSystem::Event event;
+			event.type = InputSystem::Event::MOUSE_BUTTON;
+			event.button = (InputSystem::MouseButton)i;
+			event.is_down = down;
+			event.rel_x = 0;
+			event.rel_y = 0;
+			event.abs_x = float(last_pos.x);
+			event.abs_y = float(last_pos.y);
+			event.timestamp = m_system.now();
+			m_system.pushEvent(event);
+			last_down[i] = down;
+		}
+		MT::sleep(1);
+	}
+	return 0;
+}
+
+
 InputSystem* InputSystem::create(IAllocator& allocator)
 {
 	return LUMIX_NEW(allocator, InputSystemImpl)(allocator);
@@ -63,6 +63,43 @@ TCPStream* TCPAcceptor::accept()
 }
 
 
+TCPStream* TCPAcceptor::acceptPending()
+{
+	fd_set set;
+	FD_ZERO(&set);
+	FD_SET((SOCKET)m_socket, &set);
+	TIMEVAL timeout = {0, 0};
+	if (::select(0, &set, nullptr, nullptr, &timeout) <= 0) return nullptr;
+
+	SOCKET socket = ::accept(m_socket, nullptr, nullptr);
+	if (socket == INVALID_SOCKET) return nullptr;
+	return LUMIX_NEW(m_allocator, TCPStream)(socket);
+}
+
+
+int waitForData(TCPStream** streams, int count, TCPAcceptor* acceptor, int timeout_ms)
+{
+	fd_set set;
+	FD_ZERO(&set);
+	for (int i = 0; i < count; ++i)
+	{
+		FD_SET((SOCKET)streams[i]->m_socket, &set);
+	}
+	if (acceptor) FD_SET((SOCKET)acceptor->m_socket, &set);
+
+	TIMEVAL timeout = {timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+	if (::select(0, &set, nullptr, nullptr, &timeout) <= 0) return -2;
+
+	// existing connections are served before new ones are accepted
+	for (int i = 0; i < count; ++i)
+	{
+		if (FD_ISSET((SOCKET)streams[i]->m_socket, &set)) return i;
+	}
+	if (acceptor && FD_ISSET((SOCKET)acceptor->m_socket, &set)) return -1;
+	return -2;
+}
+
+
 TCPConnector::TCPConnector(IAllocator& allocator)
 	: m_allocator(allocator)
 	, m_socket(0)
@@ -92,6 +129,13 @@ TCPStream* TCPConnector::connect(const char* ip, u16 port)
 	sin.sin_family = AF_INET;
 	sin.sin_port = htons(port);
 	sin.sin_addr.s_addr = ip ? ::inet_addr(ip) : INADDR_ANY;
+	if (ip && sin.sin_addr.s_addr == INADDR_NONE)
+	{
+		// not a dotted quad, resolve it as a hostname
+		hostent* host = ::gethostbyname(ip);
+		if (!host || !host->h_addr_list[0]) return nullptr;
+		copyMemory(&sin.sin_addr, host->h_addr_list[0], sizeof(sin.sin_addr));
+	}
 
 	if (::connect(socket, (LPSOCKADDR)&sin, sizeof(sin)) != 0) return nullptr;
 
@@ -167,5 +211,15 @@ bool TCPStream::write(const void* buffer, size_t size)
 }
 
 
+bool TCPStream::hasData() const
+{
+	fd_set set;
+	FD_ZERO(&set);
+	FD_SET((SOCKET)m_socket, &set);
+	TIMEVAL timeout = {0, 0};
+	return ::select(0, &set, nullptr, nullptr, &timeout) > 0;
+}
+
+
 } // namespace Net
 } // namespace Lumix
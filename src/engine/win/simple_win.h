@@ -15,7 +15,9 @@
 #define SOCK_STREAM 1
 #define INVALID_SOCKET (SOCKET)(~0)
 #define INADDR_ANY (u_long)0x00000000
+#define INADDR_NONE (u_long)0xffffffff
 #define SOCKET_ERROR (-1)
+#define FD_SETSIZE 64
 #define WSABASEERR 10000
 #define WSAEWOULDBLOCK (WSABASEERR + 35)
 #define DECLSPEC_IMPORT __declspec(dllimport)
@@ -33,6 +35,8 @@
 #define TRUNCATE_EXISTING 5
 #define FILE_ATTRIBUTE_NORMAL 0x00000080
 #define INVALID_HANDLE_VALUE ((HANDLE)(LONG_PTR)-1)
+#define PAGE_READONLY 0x02
+#define FILE_MAP_READ 0x0004
 #define VOID void
 #define FILE_BEGIN 0
 #define FILE_CURRENT 1
@@ -44,6 +48,7 @@
 #define EXCEPTION_EXECUTE_HANDLER 1
 #define GetFileAttributes  GetFileAttributesA
 #define CreateFile CreateFileA
+#define CreateFileMapping CreateFileMappingA
 #define CreateSemaphore CreateSemaphoreA
 #define CreateMutex CreateMutexA
 #define CreateEvent CreateEventA
@@ -272,6 +277,47 @@ typedef unsigned short WORD;
 typedef struct sockaddr_in SOCKADDR_IN;
 
 
+typedef struct fd_set
+{
+	unsigned int fd_count;
+	SOCKET fd_array[FD_SETSIZE];
+} fd_set;
+
+#define FD_ZERO(set) (((fd_set*)(set))->fd_count = 0)
+#define FD_SET(fd, set)                                                                      \
+	do                                                                                       \
+	{                                                                                        \
+		unsigned int fd_i;                                                                   \
+		for (fd_i = 0; fd_i < ((fd_set*)(set))->fd_count; ++fd_i)                            \
+		{                                                                                    \
+			if (((fd_set*)(set))->fd_array[fd_i] == (fd)) break;                             \
+		}                                                                                    \
+		if (fd_i == ((fd_set*)(set))->fd_count && ((fd_set*)(set))->fd_count < FD_SETSIZE)   \
+		{                                                                                    \
+			((fd_set*)(set))->fd_array[fd_i] = (fd);                                         \
+			++((fd_set*)(set))->fd_count;                                                    \
+		}                                                                                    \
+	} while (false)
+#define FD_ISSET(fd, set) __WSAFDIsSet((SOCKET)(fd), (fd_set*)(set))
+
+
+typedef struct timeval
+{
+	long tv_sec;
+	long tv_usec;
+} TIMEVAL;
+
+
+struct hostent
+{
+	char* h_name;
+	char** h_aliases;
+	short h_addrtype;
+	short h_length;
+	char** h_addr_list;
+};
+
+
 typedef struct _SECURITY_ATTRIBUTES
 {
 	DWORD nLength;
@@ -467,6 +513,9 @@ int PASCAL connect(SOCKET s, const struct sockaddr* name, int namelen);
 int PASCAL closesocket(SOCKET s);
 int PASCAL recv(SOCKET s, char* buf, int len, int flags);
 int PASCAL send(SOCKET s, const char* buf, int len, int flags);
+int PASCAL select(int nfds, fd_set* readfds, fd_set* writefds, fd_set* exceptfds, const struct timeval* timeout);
+int PASCAL __WSAFDIsSet(SOCKET fd, fd_set* set);
+struct hostent* PASCAL gethostbyname(const char* name);
 WINBASEAPI HANDLE WINAPI CreateFileA(LPCSTR lpFileName,
 	DWORD dwDesiredAccess,
 	DWORD dwShareMode,
@@ -488,6 +537,18 @@ WINBASEAPI BOOL WINAPI ReadFile(HANDLE hFile,
 	LPDWORD lpNumberOfBytesRead,
 	LPOVERLAPPED lpOverlapped);
 WINBASEAPI DWORD WINAPI GetFileSize(HANDLE hFile, LPDWORD lpFileSizeHigh);
+WINBASEAPI HANDLE WINAPI CreateFileMappingA(HANDLE hFile,
+	LPSECURITY_ATTRIBUTES lpFileMappingAttributes,
+	DWORD flProtect,
+	DWORD dwMaximumSizeHigh,
+	DWORD dwMaximumSizeLow,
+	LPCSTR lpName);
+WINBASEAPI LPVOID WINAPI MapViewOfFile(HANDLE hFileMappingObject,
+	DWORD dwDesiredAccess,
+	DWORD dwFileOffsetHigh,
+	DWORD dwFileOffsetLow,
+	SIZE_T dwNumberOfBytesToMap);
+WINBASEAPI BOOL WINAPI UnmapViewOfFile(LPCVOID lpBaseAddress);
 WINBASEAPI DWORD WINAPI SetFilePointer(HANDLE hFile,
 	LONG lDistanceToMove,
 	PLONG lpDistanceToMoveHigh,
@@ -524,6 +585,14 @@ WINBASEAPI DWORD WINAPI SetThreadIdealProcessor(HANDLE hThread, DWORD dwIdealPro
 WINBASEAPI BOOL WINAPI SetThreadPriority(HANDLE hThread, int nPriority);
 WINBASEAPI BOOL WINAPI GetExitCodeThread(HANDLE hThread, LPDWORD lpExitCode);
 WINBASEAPI VOID WINAPI ExitThread(DWORD dwExitCode);
+typedef VOID(WINAPI* LPFIBER_START_ROUTINE)(LPVOID lpFiberParameter);
+WINBASEAPI LPVOID WINAPI ConvertThreadToFiber(LPVOID lpParameter);
+WINBASEAPI BOOL WINAPI ConvertFiberToThread(VOID);
+WINBASEAPI LPVOID WINAPI CreateFiber(SIZE_T dwStackSize,
+	LPFIBER_START_ROUTINE lpStartAddress,
+	LPVOID lpParameter);
+WINBASEAPI VOID WINAPI DeleteFiber(LPVOID lpFiber);
+WINBASEAPI VOID WINAPI SwitchToFiber(LPVOID lpFiber);
 WINBASEAPI VOID WINAPI Sleep(DWORD dwMilliseconds);
 WINBASEAPI VOID WINAPI GetSystemInfo(LPSYSTEM_INFO lpSystemInfo);
 WINBASEAPI DWORD WINAPI GetCurrentThreadId(VOID);
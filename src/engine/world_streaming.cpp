@@ -0,0 +1,370 @@
+#include "engine/world_streaming.h"
+#include "engine/blob.h"
+#include "engine/fs/file_system.h"
+#include "engine/fs/os_file.h"
+#include "engine/log.h"
+#include "engine/math_utils.h"
+#include "engine/matrix.h"
+#include "engine/property_register.h"
+#include "engine/universe/universe.h"
+#include <cmath>
+#include <cstdlib>
+
+
+namespace Lumix
+{
+
+
+static const u32 REGION_FILE_VERSION = 0;
+
+
+struct WorldStreaming::Region
+{
+	explicit Region(IAllocator& allocator)
+		: entities(allocator)
+	{
+	}
+
+
+	void onFileLoaded(FS::IFile& file, bool success) { owner->regionLoaded(*this, file, success); }
+
+
+	WorldStreaming* owner;
+	int x;
+	int z;
+	u32 async_op;
+	bool is_resident;
+	Array<Entity> entities;
+};
+
+
+Entity WorldStreaming::GUIDMap::get(EntityGUID guid)
+{
+	auto iter = guid_to_entity.find(guid.value);
+	if (iter != guid_to_entity.end()) return iter.value();
+	return INVALID_ENTITY;
+}
+
+
+EntityGUID WorldStreaming::GUIDMap::get(Entity entity)
+{
+	if (!isValid(entity)) return INVALID_ENTITY_GUID;
+	auto iter = entity_to_guid.find(entity);
+	if (iter != entity_to_guid.end()) return {iter.value()};
+	return INVALID_ENTITY_GUID;
+}
+
+
+void WorldStreaming::GUIDMap::insert(EntityGUID guid, Entity entity)
+{
+	guid_to_entity.insert(guid.value, entity);
+	entity_to_guid.insert(entity, guid.value);
+}
+
+
+void WorldStreaming::GUIDMap::erase(Entity entity)
+{
+	auto iter = entity_to_guid.find(entity);
+	if (iter == entity_to_guid.end()) return;
+	guid_to_entity.erase(guid_to_entity.find(iter.value()));
+	entity_to_guid.erase(iter);
+}
+
+
+WorldStreaming::WorldStreaming(Universe& universe, FS::FileSystem& fs, IAllocator& allocator)
+	: m_allocator(allocator)
+	, m_universe(universe)
+	, m_fs(fs)
+	, m_regions(allocator)
+	, m_guid_map(allocator)
+	, m_region_size(0)
+	, m_load_radius(0)
+	, m_unload_radius(0)
+{
+}
+
+
+WorldStreaming::~WorldStreaming()
+{
+	for (auto iter = m_regions.begin(), end = m_regions.end(); iter != end; ++iter)
+	{
+		Region* region = iter.value();
+		if (region->async_op != FS::FileSystem::INVALID_ASYNC) m_fs.cancelAsync(region->async_op);
+		LUMIX_DELETE(m_allocator, region);
+	}
+}
+
+
+void WorldStreaming::setSource(const char* dir, float region_size)
+{
+	ASSERT(m_regions.size() == 0);
+	m_dir = dir;
+	m_region_size = region_size;
+}
+
+
+void WorldStreaming::setRadii(float load_radius, float unload_radius)
+{
+	ASSERT(unload_radius > load_radius);
+	m_load_radius = load_radius;
+	m_unload_radius = unload_radius;
+}
+
+
+u64 WorldStreaming::getRegionKey(int x, int z)
+{
+	return ((u64)(u32)x << 32) | (u32)z;
+}
+
+
+// squared distance from the focus point to the region's cell on the xz plane
+static float getCellDistanceSquared(const Vec3& center, int x, int z, float size)
+{
+	float min_x = x * size;
+	float min_z = z * size;
+	float dx = center.x < min_x ? min_x - center.x : (center.x > min_x + size ? center.x - min_x - size : 0);
+	float dz = center.z < min_z ? min_z - center.z : (center.z > min_z + size ? center.z - min_z - size : 0);
+	return dx * dx + dz * dz;
+}
+
+
+void WorldStreaming::startLoading(int x, int z)
+{
+	Region* region = LUMIX_NEW(m_allocator, Region)(m_allocator);
+	region->owner = this;
+	region->x = x;
+	region->z = z;
+	region->is_resident = false;
+	m_regions.insert(getRegionKey(x, z), region);
+
+	StaticString<MAX_PATH_LENGTH> path(m_dir, "/", x, "_", z, ".rgn");
+	FS::ReadCallback cb;
+	cb.bind<Region, &Region::onFileLoaded>(region);
+	region->async_op = m_fs.openAsync(m_fs.getDefaultDevice(), Path(path), FS::Mode::OPEN_AND_READ, cb);
+}
+
+
+void WorldStreaming::regionLoaded(Region& region, FS::IFile& file, bool success)
+{
+	region.async_op = FS::FileSystem::INVALID_ASYNC;
+	if (!success)
+	{
+		// missing files are expected, not every cell of the grid has content
+		region.is_resident = true;
+		return;
+	}
+
+	Array<u8> data(m_allocator);
+	const void* buffer = file.getBuffer();
+	if (!buffer)
+	{
+		data.resize((int)file.size());
+		if (!data.empty()) file.read(&data[0], data.size());
+		buffer = data.empty() ? nullptr : &data[0];
+	}
+	InputBlob blob(buffer, (int)file.size());
+	TextDeserializer deserializer(blob, m_guid_map);
+
+	u32 version;
+	deserializer.read(&version);
+	i32 count;
+	deserializer.read(&count);
+
+	// all entities exist before any component deserializes, so references
+	// within the region and into already resident regions resolve
+	Array<Transform> transforms(m_allocator);
+	region.entities.reserve(count);
+	transforms.reserve(count);
+	for (int i = 0; i < count; ++i)
+	{
+		u64 guid;
+		deserializer.read(&guid);
+		char name[64];
+		deserializer.read(name, lengthOf(name));
+		Transform tr;
+		deserializer.read(&tr);
+		float scale;
+		deserializer.read(&scale);
+		Entity entity = m_universe.createEntity(tr.pos, tr.rot);
+		m_universe.setScale(entity, scale);
+		if (name[0]) m_universe.setEntityName(entity, name);
+		m_guid_map.insert({guid}, entity);
+		region.entities.push(entity);
+		transforms.push(tr);
+	}
+	// one span notification for the whole region instead of a fan-out per entity
+	if (count > 0) m_universe.setTransforms(&region.entities[0], &transforms[0], count);
+
+	for (int i = 0; i < count; ++i)
+	{
+		u32 cmp_type_hash;
+		deserializer.read(&cmp_type_hash);
+		while (cmp_type_hash != 0)
+		{
+			ComponentType cmp_type = PropertyRegister::getComponentTypeFromHash(cmp_type_hash);
+			int scene_version;
+			deserializer.read(&scene_version);
+			m_universe.deserializeComponent(deserializer, region.entities[i], cmp_type, scene_version);
+			deserializer.read(&cmp_type_hash);
+		}
+	}
+	region.is_resident = true;
+}
+
+
+void WorldStreaming::unload(Region& region)
+{
+	if (region.async_op != FS::FileSystem::INVALID_ASYNC) m_fs.cancelAsync(region.async_op);
+	for (Entity entity : region.entities)
+	{
+		m_guid_map.erase(entity);
+		// the deferred queue tears the region down in one entity-ordered batch
+		// at the frame fence
+		m_universe.deferDestroyEntity(entity);
+	}
+	LUMIX_DELETE(m_allocator, &region);
+}
+
+
+void WorldStreaming::update(const Vec3& center)
+{
+	if (m_dir[0] == '\0' || m_region_size <= 0) return;
+
+	float load_r2 = m_load_radius * m_load_radius;
+	int min_x = int(floorf((center.x - m_load_radius) / m_region_size));
+	int max_x = int(floorf((center.x + m_load_radius) / m_region_size));
+	int min_z = int(floorf((center.z - m_load_radius) / m_region_size));
+	int max_z = int(floorf((center.z + m_load_radius) / m_region_size));
+	for (int z = min_z; z <= max_z; ++z)
+	{
+		for (int x = min_x; x <= max_x; ++x)
+		{
+			if (getCellDistanceSquared(center, x, z, m_region_size) > load_r2) continue;
+			if (m_regions.find(getRegionKey(x, z)) != m_regions.end()) continue;
+			startLoading(x, z);
+		}
+	}
+
+	float unload_r2 = m_unload_radius * m_unload_radius;
+	Array<Region*> to_unload(m_allocator);
+	for (auto iter = m_regions.begin(), end = m_regions.end(); iter != end; ++iter)
+	{
+		Region* region = iter.value();
+		if (getCellDistanceSquared(center, region->x, region->z, m_region_size) > unload_r2)
+		{
+			to_unload.push(region);
+		}
+	}
+	for (Region* region : to_unload)
+	{
+		m_regions.erase(m_regions.find(getRegionKey(region->x, region->z)));
+		unload(*region);
+	}
+}
+
+
+static int compareRecords(const void* a, const void* b)
+{
+	u64 key_a = ((const u64*)a)[0];
+	u64 key_b = ((const u64*)b)[0];
+	if (key_a < key_b) return -1;
+	return key_a > key_b ? 1 : 0;
+}
+
+
+bool WorldStreaming::saveRegions(const char* dir, float region_size)
+{
+	struct Record
+	{
+		u64 key;
+		Entity entity;
+	};
+
+	Array<Record> records(m_allocator);
+	for (Entity entity = m_universe.getFirstEntity(); isValid(entity); entity = m_universe.getNextEntity(entity))
+	{
+		const Vec3& pos = m_universe.getPosition(entity);
+		Record& record = records.emplace();
+		record.key = getRegionKey(int(floorf(pos.x / region_size)), int(floorf(pos.z / region_size)));
+		record.entity = entity;
+
+		// guids must survive resaves so references in other regions stay valid
+		if (!Lumix::isValid(m_guid_map.get(entity)))
+		{
+			m_guid_map.insert({Math::randGUID()}, entity);
+		}
+	}
+	if (!records.empty()) qsort(&records[0], records.size(), sizeof(records[0]), compareRecords);
+
+	OutputBlob blob(m_allocator);
+	TextSerializer serializer(blob, m_guid_map);
+	for (int begin = 0; begin < records.size();)
+	{
+		int end = begin;
+		while (end < records.size() && records[end].key == records[begin].key) ++end;
+
+		blob.clear();
+		serializer.write("version", REGION_FILE_VERSION);
+		serializer.write("count", (i32)(end - begin));
+		for (int i = begin; i < end; ++i)
+		{
+			Entity entity = records[i].entity;
+			serializer.write("guid", m_guid_map.get(entity).value);
+			serializer.write("name", m_universe.getEntityName(entity));
+			serializer.write("transform", m_universe.getTransform(entity));
+			serializer.write("scale", m_universe.getScale(entity));
+		}
+		for (int i = begin; i < end; ++i)
+		{
+			Entity entity = records[i].entity;
+			for (ComponentUID cmp = m_universe.getFirstComponent(entity); cmp.isValid();
+				 cmp = m_universe.getNextComponent(cmp))
+			{
+				const char* cmp_name = PropertyRegister::getComponentTypeID(cmp.type.index);
+				serializer.write(cmp_name, PropertyRegister::getComponentTypeHash(cmp.type));
+				serializer.write("scene_version", (i32)cmp.scene->getVersion());
+				m_universe.serializeComponent(serializer, cmp.type, cmp.handle);
+			}
+			serializer.write("cmp_end", (u32)0);
+		}
+
+		int x = (int)(u32)(records[begin].key >> 32);
+		int z = (int)(u32)records[begin].key;
+		StaticString<MAX_PATH_LENGTH> path(dir, "/", x, "_", z, ".rgn");
+		FS::OsFile file;
+		if (!file.open(path, FS::Mode::CREATE_AND_WRITE, m_allocator))
+		{
+			g_log_error.log("Engine") << "Could not save region " << path;
+			return false;
+		}
+		file.write(blob.getData(), blob.getPos());
+		file.close();
+
+		begin = end;
+	}
+	return true;
+}
+
+
+int WorldStreaming::getResidentRegionCount() const
+{
+	int count = 0;
+	for (auto iter = m_regions.begin(), end = m_regions.end(); iter != end; ++iter)
+	{
+		if (iter.value()->is_resident) ++count;
+	}
+	return count;
+}
+
+
+bool WorldStreaming::isLoading() const
+{
+	for (auto iter = m_regions.begin(), end = m_regions.end(); iter != end; ++iter)
+	{
+		if (!iter.value()->is_resident) return true;
+	}
+	return false;
+}
+
+
+} // namespace Lumix
@@ -0,0 +1,92 @@
+#pragma once
+
+
+#include "engine/array.h"
+#include "engine/hash_map.h"
+#include "engine/lumix.h"
+#include "engine/serializer.h"
+#include "engine/string.h"
+#include "engine/vec.h"
+
+
+namespace Lumix
+{
+
+
+class Universe;
+
+namespace FS
+{
+class FileSystem;
+class IFile;
+}
+
+
+// streams entities of a universe in and out around a focus point. The world is
+// partitioned into square regions on the xz plane, each serialized to its own
+// file in the per-entity format; regions inside the load radius are fetched
+// through the async file system, regions outside the unload radius are torn
+// down through the deferred destruction queue. Entity references are stored as
+// GUIDs and remapped on load; a reference into a region that is not resident
+// deserializes as an invalid entity. Scene state not attached to an entity
+// stays in the monolithic universe file
+class LUMIX_ENGINE_API WorldStreaming
+{
+public:
+	WorldStreaming(Universe& universe, FS::FileSystem& fs, IAllocator& allocator);
+	~WorldStreaming();
+
+	// region files are <dir>/<x>_<z>.rgn as written by saveRegions
+	void setSource(const char* dir, float region_size);
+	// unload_radius must be greater than load_radius so a region does not
+	// oscillate when the focus point sits on a cell boundary
+	void setRadii(float load_radius, float unload_radius);
+	// issues loads and unloads for the given focus point; call once per frame,
+	// loaded regions materialize from updateAsyncTransactions
+	void update(const Vec3& center);
+	// partitions the universe's entities by position into region files under
+	// dir; the directory must exist
+	bool saveRegions(const char* dir, float region_size);
+
+	int getResidentRegionCount() const;
+	bool isLoading() const;
+
+private:
+	struct Region;
+
+	struct GUIDMap : public IEntityGUIDMap
+	{
+		explicit GUIDMap(IAllocator& allocator)
+			: guid_to_entity(allocator)
+			, entity_to_guid(allocator)
+		{
+		}
+
+		Entity get(EntityGUID guid) override;
+		EntityGUID get(Entity entity) override;
+		void insert(EntityGUID guid, Entity entity);
+		void erase(Entity entity);
+
+		HashMap<u64, Entity> guid_to_entity;
+		HashMap<Entity, u64> entity_to_guid;
+	};
+
+	static u64 getRegionKey(int x, int z);
+	void startLoading(int x, int z);
+	void unload(Region& region);
+	void regionLoaded(Region& region, FS::IFile& file, bool success);
+
+private:
+	IAllocator& m_allocator;
+	Universe& m_universe;
+	FS::FileSystem& m_fs;
+	HashMap<u64, Region*> m_regions;
+	GUIDMap m_guid_map;
+	StaticString<MAX_PATH_LENGTH> m_dir;
+	float m_region_size;
+	float m_load_radius;
+	float m_unload_radius;
+};
+
+
+} // namespace Lumix
@@ -1,4 +1,6 @@
 ﻿#include "gui_system.h"
+#include "engine/array.h"
+#include "engine/crc32.h"
 #include "engine/delegate.h"
 #include "engine/delegate_list.h"
 #include "engine/engine.h"
@@ -8,6 +10,7 @@
 #include "engine/matrix.h"
 #include "engine/path.h"
 #include "engine/plugin_manager.h"
+#include "engine/profiler.h"
 #include "engine/resource_manager.h"
 #include "renderer/material.h"
 #include "renderer/material_manager.h"
@@ -16,6 +19,7 @@
 #include "renderer/shader.h"
 #include "renderer/texture.h"
 #include <bgfx/bgfx.h>
+#include <cfloat>
 #include <imgui/imgui.h>
 
 
@@ -29,12 +33,90 @@ struct GUISystemImpl;
 static const ResourceType MATERIAL_TYPE("material");
 static const ResourceType TEXTURE_TYPE("texture");
 
+// distance field spread in atlas pixels; the imgui shader reconstructs the
+// edge with smoothstep around alpha 0.5, so this is the widest outline or
+// smoothing the shader can ask for
+static const float SDF_SPREAD = 4.0f;
+
+
+// one sweep of a 3-4 chamfer distance transform; run forward then backward
+// to propagate distances across the whole atlas
+static void chamferSweep(float* dist, int w, int h, bool forward)
+{
+	int x_begin = forward ? 0 : w - 1;
+	int x_end = forward ? w : -1;
+	int step = forward ? 1 : -1;
+	for (int i = 0; i < h; ++i)
+	{
+		int y = forward ? i : h - 1 - i;
+		for (int x = x_begin; x != x_end; x += step)
+		{
+			float d = dist[x + y * w];
+			int py = y - step;
+			if (x - step >= 0 && x - step < w)
+			{
+				d = Math::minimum(d, dist[x - step + y * w] + 1.0f);
+			}
+			if (py >= 0 && py < h)
+			{
+				d = Math::minimum(d, dist[x + py * w] + 1.0f);
+				if (x - step >= 0 && x - step < w) d = Math::minimum(d, dist[x - step + py * w] + 1.41421f);
+				if (x + step >= 0 && x + step < w) d = Math::minimum(d, dist[x + step + py * w] + 1.41421f);
+			}
+			dist[x + y * w] = d;
+		}
+	}
+}
+
+
+// replaces the coverage alpha of the font atlas with a signed distance field,
+// edge at 0.5, so text stays crisp when scaled and gets sub-pixel positioning
+// from plain bilinear filtering
+static void bakeDistanceField(u8* rgba, int w, int h, IAllocator& allocator)
+{
+	Array<float> dist_in(allocator);
+	Array<float> dist_out(allocator);
+	dist_in.resize(w * h);
+	dist_out.resize(w * h);
+	for (int i = 0; i < w * h; ++i)
+	{
+		bool inside = rgba[i * 4 + 3] >= 128;
+		dist_in[i] = inside ? 0.0f : FLT_MAX;
+		dist_out[i] = inside ? FLT_MAX : 0.0f;
+	}
+	chamferSweep(&dist_in[0], w, h, true);
+	chamferSweep(&dist_in[0], w, h, false);
+	chamferSweep(&dist_out[0], w, h, true);
+	chamferSweep(&dist_out[0], w, h, false);
+
+	for (int i = 0; i < w * h; ++i)
+	{
+		float signed_dist = dist_out[i] - dist_in[i];
+		float alpha = 128.0f + signed_dist * (127.0f / SDF_SPREAD);
+		rgba[i * 4 + 3] = (u8)Math::clamp(alpha, 0.0f, 255.0f);
+	}
+}
+
 
 struct GUISystemImpl LUMIX_FINAL : public GUISystem
 {
+	// retained geometry of one imgui draw list; re-uploaded only when the
+	// content hash changes, so a static HUD skips the upload entirely
+	struct CachedDrawList
+	{
+		bgfx::DynamicVertexBufferHandle vertex_buffer;
+		bgfx::DynamicIndexBufferHandle index_buffer;
+		u32 vertex_hash;
+		u32 index_hash;
+		int num_vertices;
+		int num_indices;
+	};
+
 	GUISystemImpl(Engine& engine)
 		: m_engine(engine)
 		, m_interface(nullptr)
+		, m_draw_list_cache(engine.getAllocator())
+		, m_is_budget_hud_enabled(false)
 	{
 		m_context = ImGui::CreateContext();
 		m_original_context = ImGui::GetCurrentContext();
@@ -45,6 +127,7 @@ struct GUISystemImpl LUMIX_FINAL : public GUISystem
 		u8* pixels;
 		int w, h;
 		io.Fonts->GetTexDataAsRGBA32(&pixels, &w, &h);
+		bakeDistanceField(pixels, w, h, m_engine.getAllocator());
 		auto* material_manager = m_engine.getResourceManager().get(MATERIAL_TYPE);
 		auto* resource = material_manager->load(Path("pipelines/imgui/imgui.mat"));
 		m_material = static_cast<Material*>(resource);
@@ -72,6 +155,8 @@ struct GUISystemImpl LUMIX_FINAL : public GUISystem
 
 	~GUISystemImpl()
 	{
+		while (!m_draw_list_cache.empty()) destroyLastCacheEntry();
+
 		Texture* texture = m_material->getTexture(0);
 		if (texture)
 		{
@@ -99,6 +184,7 @@ struct GUISystemImpl LUMIX_FINAL : public GUISystem
 
 		REGISTER_FUNCTION(beginGUI);
 		REGISTER_FUNCTION(endGUI);
+		REGISTER_FUNCTION(enableBudgetHUD);
 		REGISTER_FUNCTION(enableCursor);
 		REGISTER_FUNCTION(getMouseX);
 		REGISTER_FUNCTION(getMouseY);
@@ -140,23 +226,77 @@ struct GUISystemImpl LUMIX_FINAL : public GUISystem
 	}
 
 
-	void drawGUICmdList(ImDrawList* cmd_list)
+	void destroyLastCacheEntry()
+	{
+		CachedDrawList& cached = m_draw_list_cache.back();
+		if (bgfx::isValid(cached.vertex_buffer)) bgfx::destroyDynamicVertexBuffer(cached.vertex_buffer);
+		if (bgfx::isValid(cached.index_buffer)) bgfx::destroyDynamicIndexBuffer(cached.index_buffer);
+		m_draw_list_cache.pop();
+	}
+
+
+	// imgui re-tessellates everything each frame, so caching happens at draw
+	// list granularity: geometry lives in persistent dynamic buffers keyed by
+	// a content hash and is re-uploaded only when the list actually changed
+	void updateDrawListCache(int list_idx, ImDrawList* cmd_list, const bgfx::VertexDecl& decl)
+	{
+		while (m_draw_list_cache.size() <= list_idx)
+		{
+			CachedDrawList& cached = m_draw_list_cache.emplace();
+			cached.vertex_buffer = BGFX_INVALID_HANDLE;
+			cached.index_buffer = BGFX_INVALID_HANDLE;
+			cached.vertex_hash = 0;
+			cached.index_hash = 0;
+			cached.num_vertices = 0;
+			cached.num_indices = 0;
+		}
+
+		CachedDrawList& cached = m_draw_list_cache[list_idx];
+		int num_vertices = cmd_list->VtxBuffer.size();
+		int num_indices = cmd_list->IdxBuffer.size();
+		int vertices_size = num_vertices * decl.getStride();
+		int indices_size = num_indices * sizeof(u16);
+		u32 vertex_hash = crc32(&cmd_list->VtxBuffer[0], vertices_size);
+		u32 index_hash = crc32(&cmd_list->IdxBuffer[0], indices_size);
+
+		if (!bgfx::isValid(cached.vertex_buffer))
+		{
+			cached.vertex_buffer = bgfx::createDynamicVertexBuffer(
+				bgfx::copy(&cmd_list->VtxBuffer[0], vertices_size), decl, BGFX_BUFFER_ALLOW_RESIZE);
+		}
+		else if (cached.num_vertices != num_vertices || cached.vertex_hash != vertex_hash)
+		{
+			bgfx::updateDynamicVertexBuffer(
+				cached.vertex_buffer, 0, bgfx::copy(&cmd_list->VtxBuffer[0], vertices_size));
+		}
+		cached.num_vertices = num_vertices;
+		cached.vertex_hash = vertex_hash;
+
+		if (!bgfx::isValid(cached.index_buffer))
+		{
+			cached.index_buffer = bgfx::createDynamicIndexBuffer(
+				bgfx::copy(&cmd_list->IdxBuffer[0], indices_size), BGFX_BUFFER_ALLOW_RESIZE);
+		}
+		else if (cached.num_indices != num_indices || cached.index_hash != index_hash)
+		{
+			bgfx::updateDynamicIndexBuffer(
+				cached.index_buffer, 0, bgfx::copy(&cmd_list->IdxBuffer[0], indices_size));
+		}
+		cached.num_indices = num_indices;
+		cached.index_hash = index_hash;
+	}
+
+
+	void drawGUICmdList(int list_idx, ImDrawList* cmd_list)
 	{
 		Renderer* renderer = static_cast<Renderer*>(m_engine.getPluginManager().getPlugin("renderer"));
 		if (!renderer) return;
 
 		Pipeline* pipeline = m_interface->getPipeline();
-		int num_indices = cmd_list->IdxBuffer.size();
-		int num_vertices = cmd_list->VtxBuffer.size();
-		auto& decl = renderer->getBasic2DVertexDecl();
-		bgfx::TransientVertexBuffer vertex_buffer;
-		bgfx::TransientIndexBuffer index_buffer;
-		if (!bgfx::checkAvailTransientBuffers(num_vertices, decl, num_indices)) return;
-		bgfx::allocTransientVertexBuffer(&vertex_buffer, num_vertices, decl);
-		bgfx::allocTransientIndexBuffer(&index_buffer, num_indices);
+		if (cmd_list->IdxBuffer.size() == 0 || cmd_list->VtxBuffer.size() == 0) return;
 
-		copyMemory(vertex_buffer.data, &cmd_list->VtxBuffer[0], num_vertices * decl.getStride());
-		copyMemory(index_buffer.data, &cmd_list->IdxBuffer[0], num_indices * sizeof(u16));
+		updateDrawListCache(list_idx, cmd_list, renderer->getBasic2DVertexDecl());
+		CachedDrawList& cached = m_draw_list_cache[list_idx];
 
 		u32 elem_offset = 0;
 		const ImDrawCmd* pcmd_begin = cmd_list->CmdBuffer.begin();
@@ -182,8 +322,8 @@ struct GUISystemImpl LUMIX_FINAL : public GUISystem
 				pcmd->TextureId ? *(bgfx::TextureHandle*)pcmd->TextureId : material->getTexture(0)->handle;
 			auto texture_uniform = material->getShader()->m_texture_slots[0].uniform_handle;
 			pipeline->setTexture(0, texture_id, texture_uniform);
-			pipeline->render(vertex_buffer,
-				index_buffer,
+			pipeline->render(cached.vertex_buffer,
+				cached.index_buffer,
 				Matrix::IDENTITY,
 				elem_offset,
 				pcmd->ElemCount,
@@ -214,8 +354,9 @@ struct GUISystemImpl LUMIX_FINAL : public GUISystem
 		for (int i = 0; i < draw_data->CmdListsCount; ++i)
 		{
 			ImDrawList* cmd_list = draw_data->CmdLists[i];
-			drawGUICmdList(cmd_list);
+			drawGUICmdList(i, cmd_list);
 		}
+		while (m_draw_list_cache.size() > draw_data->CmdListsCount) destroyLastCacheEntry();
 
 		ImGui::NewFrame();
 		ImGui::SetCurrentContext(m_original_context);
@@ -257,6 +398,41 @@ struct GUISystemImpl LUMIX_FINAL : public GUISystem
 	}
 
 
+	void enableBudgetHUD(bool enable)
+	{
+		m_is_budget_hud_enabled = enable;
+	}
+
+
+	void onBudgetHUD()
+	{
+		ImGui::SetNextWindowPos(ImVec2(10, 10));
+		ImGuiWindowFlags flags = ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
+								 ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings |
+								 ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoInputs;
+		if (ImGui::Begin("###frame_budgets", nullptr, ImVec2(0, 0), 0.5f, flags))
+		{
+			for (int i = 0, c = Profiler::getBudgetGroupCount(); i < c; ++i)
+			{
+				float time = Profiler::getBudgetGroupTime(i);
+				float budget = Profiler::getBudgetGroupBudget(i);
+				const char* name = Profiler::getBudgetGroupName(i);
+				if (budget > 0)
+				{
+					bool is_over = time > budget;
+					ImGui::TextColored(is_over ? ImVec4(1, 0.25f, 0.25f, 1) : ImVec4(1, 1, 1, 1),
+						"%s: %.2f / %.2f ms", name, time, budget);
+				}
+				else
+				{
+					ImGui::Text("%s: %.2f ms", name, time);
+				}
+			}
+		}
+		ImGui::End();
+	}
+
+
 	void update(float time_delta) override
 	{
 		beginGUI();
@@ -264,6 +440,7 @@ struct GUISystemImpl LUMIX_FINAL : public GUISystem
 		auto& io = ImGui::GetIO();
 		io.MousePos = ImVec2(mouse_pos.x, mouse_pos.y);
 		io.MouseDown[0] = m_engine.getInputSystem().isMouseDown(InputSystem::LEFT);
+		if (m_is_budget_hud_enabled) onBudgetHUD();
 		endGUI();
 	}
 
@@ -280,6 +457,8 @@ struct GUISystemImpl LUMIX_FINAL : public GUISystem
 	ImGuiContext* m_original_context;
 	ImFont* m_font;
 	Material* m_material;
+	Array<CachedDrawList> m_draw_list_cache;
+	bool m_is_budget_hud_enabled;
 };
 
 
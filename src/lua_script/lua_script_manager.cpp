@@ -3,6 +3,8 @@
 #include "engine/crc32.h"
 #include "engine/log.h"
 #include "engine/fs/file_system.h"
+#include <lua.hpp>
+#include <lauxlib.h> // must be after lua.hpp
 
 
 namespace Lumix
@@ -12,6 +14,7 @@ namespace Lumix
 LuaScript::LuaScript(const Path& path, ResourceManagerBase& resource_manager, IAllocator& allocator)
 	: Resource(path, resource_manager, allocator)
 	, m_source_code(allocator)
+	, m_bytecode(allocator)
 {
 }
 
@@ -25,6 +28,32 @@ LuaScript::~LuaScript()
 void LuaScript::unload()
 {
 	m_source_code = "";
+	m_bytecode.clear();
+}
+
+
+static int dumpBytecode(lua_State* L, const void* data, size_t size, void* user_ptr)
+{
+	auto* bytecode = (Array<u8>*)user_ptr;
+	int offset = bytecode->size();
+	bytecode->resize(offset + (int)size);
+	copyMemory(&(*bytecode)[offset], data, size);
+	return 0;
+}
+
+
+bool LuaScript::ensureBytecode(lua_State* L)
+{
+	if (!m_bytecode.empty()) return true;
+
+	if (luaL_loadbuffer(L, m_source_code.c_str(), m_source_code.length(), getPath().c_str()) != LUA_OK)
+	{
+		lua_pop(L, 1);
+		return false;
+	}
+	lua_dump(L, dumpBytecode, &m_bytecode, 0);
+	lua_pop(L, 1);
+	return !m_bytecode.empty();
 }
 
 
@@ -7,6 +7,9 @@
 #include "engine/string.h"
 
 
+struct lua_State;
+
+
 namespace Lumix
 {
 
@@ -20,9 +23,16 @@ public:
 	void unload() override;
 	bool load(FS::IFile& file) override;
 	const char* getSourceCode() const { return m_source_code.c_str(); }
+	// compiles the source once and caches the dumped bytecode, so every
+	// instance after the first loads the chunk without reparsing; returns
+	// false on compile errors, callers then fall back to the source
+	bool ensureBytecode(lua_State* L);
+	const char* getBytecode() const { return m_bytecode.empty() ? nullptr : (const char*)&m_bytecode[0]; }
+	int getBytecodeSize() const { return m_bytecode.size(); }
 
 private:
 	string m_source_code;
+	Array<u8> m_bytecode;
 };
 
 
@@ -1,5 +1,6 @@
 #include "lua_script_system.h"
 #include "engine/array.h"
+#include "engine/associative_array.h"
 #include "engine/base_proxy_allocator.h"
 #include "engine/binary_array.h"
 #include "engine/blob.h"
@@ -12,6 +13,8 @@
 #include "engine/json_serializer.h"
 #include "engine/log.h"
 #include "engine/lua_wrapper.h"
+#include "engine/mtjd/generic_job.h"
+#include "engine/mtjd/group.h"
 #include "engine/path_utils.h"
 #include "engine/plugin_manager.h"
 #include "engine/profiler.h"
@@ -19,6 +22,7 @@
 #include "engine/property_register.h"
 #include "engine/resource_manager.h"
 #include "engine/serializer.h"
+#include "engine/timer_wheel.h"
 #include "engine/string.h"
 #include "engine/universe/universe.h"
 #include "lua_script/lua_script_manager.h"
@@ -61,9 +65,9 @@ namespace Lumix
 	{
 		struct TimerData
 		{
-			float time;
 			lua_State* state;
 			int func;
+			TimerWheel::Handle handle;
 		};
 
 		struct UpdateData
@@ -73,6 +77,53 @@ namespace Lumix
 			int environment;
 		};
 
+		// a standalone VM for "compute" scripts updated on MTJD workers; the
+		// worker owns the VM and both message queues while its job is in
+		// flight, the main thread only touches them after syncComputeJobs()
+		struct ComputeVM
+		{
+			explicit ComputeVM(IAllocator& allocator)
+				: allocator(allocator)
+				, inbox(allocator)
+				, outbox(allocator)
+				, error(allocator)
+			{
+			}
+
+			IAllocator& allocator;
+			lua_State* state = nullptr;
+			Array<string> inbox;
+			Array<string> outbox;
+			string error;
+		};
+
+		// a running interpolation applied natively each frame; scripts only
+		// start and cancel tweens instead of polling in update()
+		struct Tween
+		{
+			enum Type : u8
+			{
+				POSITION,
+				ROTATION,
+				PROPERTY
+			};
+
+			int id;
+			Entity entity;
+			Type type;
+			int easing;
+			float time;
+			float duration;
+			Vec3 from_pos;
+			Vec3 to_pos;
+			Quat from_rot;
+			Quat to_rot;
+			float from_value;
+			float to_value;
+			const IPropertyDescriptor* desc;
+			ComponentUID cmp;
+		};
+
 
 		struct ScriptInstance
 		{
@@ -217,10 +268,23 @@ namespace Lumix
 					}
 
 					lua_rawgeti(script.m_state, LUA_REGISTRYINDEX, script.m_environment);
-					bool errors = luaL_loadbuffer(script.m_state,
-						script.m_script->getSourceCode(),
-						stringLength(script.m_script->getSourceCode()),
-						script.m_script->getPath().c_str()) != LUA_OK;
+					bool errors;
+					if (script.m_script->ensureBytecode(L))
+					{
+						// the chunk is compiled once per resource; instances only
+						// load the cached bytecode and get their own environment
+						errors = luaL_loadbuffer(script.m_state,
+							script.m_script->getBytecode(),
+							script.m_script->getBytecodeSize(),
+							script.m_script->getPath().c_str()) != LUA_OK;
+					}
+					else
+					{
+						errors = luaL_loadbuffer(script.m_state,
+							script.m_script->getSourceCode(),
+							stringLength(script.m_script->getSourceCode()),
+							script.m_script->getPath().c_str()) != LUA_OK;
+					}
 
 					if (errors)
 					{
@@ -302,7 +366,11 @@ namespace Lumix
 			, m_scripts(system.m_allocator)
 			, m_updates(system.m_allocator)
 			, m_timers(system.m_allocator)
+			, m_timer_wheel(system.m_allocator)
 			, m_property_names(system.m_allocator)
+			, m_compute_vms(system.m_allocator)
+			, m_compute_jobs_sync(true, system.m_allocator)
+			, m_tweens(system.m_allocator)
 			, m_is_game_running(false)
 			, m_is_api_registered(false)
 		{
@@ -313,6 +381,12 @@ namespace Lumix
 		}
 
 
+		~LuaScriptSceneImpl()
+		{
+			destroyComputeVMs();
+		}
+
+
 		int getVersion() const override { return (int)LuaSceneVersion::LATEST; }
 
 
@@ -513,6 +587,132 @@ namespace Lumix
 		}
 
 
+		static LuaScriptSceneImpl* getUpvalueScene(lua_State* L)
+		{
+			int tmp = lua_getglobal(L, "g_scene_lua_script");
+			ASSERT(tmp == LUA_TLIGHTUSERDATA);
+			auto* scene = LuaWrapper::toType<LuaScriptSceneImpl*>(L, -1);
+			lua_pop(L, 1);
+			return scene;
+		}
+
+
+		// registered inside compute VMs only; while the VM's job is in flight
+		// the worker is the sole owner of both queues
+		static int LUA_computeSendMessage(lua_State* L)
+		{
+			auto* vm = LuaWrapper::toType<ComputeVM*>(L, lua_upvalueindex(1));
+			const char* msg = LuaWrapper::checkArg<const char*>(L, 1);
+			vm->outbox.emplace(msg, vm->allocator);
+			return 0;
+		}
+
+
+		static int LUA_computeReceiveMessage(lua_State* L)
+		{
+			auto* vm = LuaWrapper::toType<ComputeVM*>(L, lua_upvalueindex(1));
+			if (vm->inbox.empty())
+			{
+				lua_pushnil(L);
+				return 1;
+			}
+			lua_pushstring(L, vm->inbox[0].c_str());
+			vm->inbox.erase(0);
+			return 1;
+		}
+
+
+		static int LUA_createComputeVM(lua_State* L)
+		{
+			const char* src = LuaWrapper::checkArg<const char*>(L, 1);
+			LuaScriptSceneImpl* scene = getUpvalueScene(L);
+			scene->syncComputeJobs();
+
+			IAllocator& allocator = scene->m_system.m_allocator;
+			ComputeVM* vm = LUMIX_NEW(allocator, ComputeVM)(allocator);
+			vm->state = luaL_newstate();
+			luaL_openlibs(vm->state);
+			lua_pushlightuserdata(vm->state, vm);
+			lua_pushcclosure(vm->state, &LUA_computeSendMessage, 1);
+			lua_setglobal(vm->state, "sendMessage");
+			lua_pushlightuserdata(vm->state, vm);
+			lua_pushcclosure(vm->state, &LUA_computeReceiveMessage, 1);
+			lua_setglobal(vm->state, "receiveMessage");
+
+			if (luaL_loadbuffer(vm->state, src, stringLength(src), "compute") != LUA_OK ||
+				lua_pcall(vm->state, 0, 0, 0) != LUA_OK)
+			{
+				g_log_error.log("Lua Script") << lua_tostring(vm->state, -1);
+				lua_close(vm->state);
+				LUMIX_DELETE(allocator, vm);
+				LuaWrapper::push(L, -1);
+				return 1;
+			}
+
+			for (int i = 0; i < scene->m_compute_vms.size(); ++i)
+			{
+				if (scene->m_compute_vms[i]) continue;
+				scene->m_compute_vms[i] = vm;
+				LuaWrapper::push(L, i);
+				return 1;
+			}
+			scene->m_compute_vms.push(vm);
+			LuaWrapper::push(L, scene->m_compute_vms.size() - 1);
+			return 1;
+		}
+
+
+		static int LUA_destroyComputeVM(lua_State* L)
+		{
+			int id = LuaWrapper::checkArg<int>(L, 1);
+			LuaScriptSceneImpl* scene = getUpvalueScene(L);
+			if (id < 0 || id >= scene->m_compute_vms.size() || !scene->m_compute_vms[id]) return 0;
+
+			scene->syncComputeJobs();
+			lua_close(scene->m_compute_vms[id]->state);
+			LUMIX_DELETE(scene->m_system.m_allocator, scene->m_compute_vms[id]);
+			scene->m_compute_vms[id] = nullptr;
+			return 0;
+		}
+
+
+		static int LUA_sendToCompute(lua_State* L)
+		{
+			int id = LuaWrapper::checkArg<int>(L, 1);
+			const char* msg = LuaWrapper::checkArg<const char*>(L, 2);
+			LuaScriptSceneImpl* scene = getUpvalueScene(L);
+			if (id < 0 || id >= scene->m_compute_vms.size() || !scene->m_compute_vms[id]) return 0;
+
+			scene->syncComputeJobs();
+			ComputeVM* vm = scene->m_compute_vms[id];
+			vm->inbox.emplace(msg, vm->allocator);
+			return 0;
+		}
+
+
+		static int LUA_receiveFromCompute(lua_State* L)
+		{
+			int id = LuaWrapper::checkArg<int>(L, 1);
+			LuaScriptSceneImpl* scene = getUpvalueScene(L);
+			if (id < 0 || id >= scene->m_compute_vms.size() || !scene->m_compute_vms[id])
+			{
+				lua_pushnil(L);
+				return 1;
+			}
+
+			scene->syncComputeJobs();
+			ComputeVM* vm = scene->m_compute_vms[id];
+			if (vm->outbox.empty())
+			{
+				lua_pushnil(L);
+				return 1;
+			}
+			lua_pushstring(L, vm->outbox[0].c_str());
+			vm->outbox.erase(0);
+			return 1;
+		}
+
+
 		void registerPropertyAPI()
 		{
 			lua_State* L = m_system.m_engine.getState();
@@ -650,6 +850,34 @@ namespace Lumix
 		}
 
 
+		// resolves a component property once by name and returns getter and
+		// setter closures bound directly to the descriptor, so per-frame
+		// access skips the crc32 and the descriptor scan in PropertyRegister;
+		// property_name is the descriptor name as registered, not the
+		// camel-case name used by the generated global accessors
+		static int LUA_getPropertyAccessors(lua_State* L)
+		{
+			const char* cmp_name = LuaWrapper::checkArg<const char*>(L, 1);
+			const char* prop_name = LuaWrapper::checkArg<const char*>(L, 2);
+			ComponentType cmp_type = PropertyRegister::getComponentType(cmp_name);
+			const IPropertyDescriptor* desc = PropertyRegister::getDescriptor(cmp_type, crc32(prop_name));
+			if (!desc)
+			{
+				g_log_error.log("Lua Script") << "Unknown property " << cmp_name << "." << prop_name;
+				lua_pushnil(L);
+				lua_pushnil(L);
+				return 2;
+			}
+			lua_pushlightuserdata(L, (void*)desc);
+			lua_pushinteger(L, cmp_type.index);
+			lua_pushcclosure(L, &LUA_getProperty, 2);
+			lua_pushlightuserdata(L, (void*)desc);
+			lua_pushinteger(L, cmp_type.index);
+			lua_pushcclosure(L, &LUA_setProperty, 2);
+			return 2;
+		}
+
+
 		static int LUA_setProperty(lua_State* L)
 		{
 			auto* desc = LuaWrapper::toType<IPropertyDescriptor*>(L, lua_upvalueindex(1));
@@ -815,14 +1043,31 @@ namespace Lumix
 
 		void cancelTimer(int timer_func)
 		{
-			for (int i = 0, c = m_timers.size(); i < c; ++i)
+			int idx = m_timers.find(timer_func);
+			if (idx < 0) return;
+			m_timer_wheel.cancel(m_timers.at(idx).handle);
+			m_timers.eraseAt(idx);
+		}
+
+
+		void onTimerFired(void* user_data)
+		{
+			int func = int(uintptr(user_data));
+			int idx = m_timers.find(func);
+			if (idx < 0) return;
+			lua_State* state = m_timers.at(idx).state;
+			m_timers.eraseAt(idx);
+
+			if (lua_rawgeti(state, LUA_REGISTRYINDEX, func) != LUA_TFUNCTION)
 			{
-				if (m_timers[i].func == timer_func)
-				{
-					m_timers.eraseFast(i);
-					break;
-				}
+				ASSERT(false);
 			}
+			if (lua_pcall(state, 0, 0, 0) != LUA_OK)
+			{
+				g_log_error.log("Lua Script") << lua_tostring(state, -1);
+				lua_pop(state, 1);
+			}
+			luaL_unref(state, LUA_REGISTRYINDEX, func);
 		}
 
 
@@ -831,12 +1076,15 @@ namespace Lumix
 			auto* scene = LuaWrapper::checkArg<LuaScriptSceneImpl*>(L, 1);
 			float time = LuaWrapper::checkArg<float>(L, 2);
 			if (!lua_isfunction(L, 3)) LuaWrapper::argError(L, 3, "function");
-			TimerData& timer = scene->m_timers.emplace();
-			timer.time = time;
+			TimerData timer;
 			timer.state = L;
 			lua_pushvalue(L, 3);
 			timer.func = luaL_ref(L, LUA_REGISTRYINDEX);
 			lua_pop(L, 1);
+			TimerWheel::Callback cb;
+			cb.bind<LuaScriptSceneImpl, &LuaScriptSceneImpl::onTimerFired>(scene);
+			timer.handle = scene->m_timer_wheel.add(time, cb, (void*)uintptr(timer.func));
+			scene->m_timers.insert(timer.func, timer);
 			LuaWrapper::push(L, timer.func);
 			return 1;
 		}
@@ -873,10 +1121,26 @@ namespace Lumix
 			REGISTER_FUNCTION(getScriptCount);
 			REGISTER_FUNCTION(setScriptSource);
 			REGISTER_FUNCTION(cancelTimer);
+			REGISTER_FUNCTION(tweenPosition);
+			REGISTER_FUNCTION(tweenRotation);
+			REGISTER_FUNCTION(tweenProperty);
+			REGISTER_FUNCTION(cancelTween);
 
 			#undef REGISTER_FUNCTION
 
 			LuaWrapper::createSystemFunction(engine_state, "LuaScript", "setTimer", &LuaScriptSceneImpl::setTimer);
+			LuaWrapper::createSystemFunction(engine_state,
+				"LuaScript",
+				"getPropertyAccessors",
+				&LuaScriptSceneImpl::LUA_getPropertyAccessors);
+			LuaWrapper::createSystemFunction(
+				engine_state, "LuaScript", "createComputeVM", &LuaScriptSceneImpl::LUA_createComputeVM);
+			LuaWrapper::createSystemFunction(
+				engine_state, "LuaScript", "destroyComputeVM", &LuaScriptSceneImpl::LUA_destroyComputeVM);
+			LuaWrapper::createSystemFunction(
+				engine_state, "LuaScript", "sendToCompute", &LuaScriptSceneImpl::LUA_sendToCompute);
+			LuaWrapper::createSystemFunction(
+				engine_state, "LuaScript", "receiveFromCompute", &LuaScriptSceneImpl::LUA_receiveFromCompute);
 		}
 
 
@@ -1018,13 +1282,13 @@ namespace Lumix
 				lua_pop(inst.m_state, 1);
 			}
 
-			for (int i = 0; i < m_timers.size(); ++i)
+			for (int i = m_timers.size() - 1; i >= 0; --i)
 			{
-				if (m_timers[i].state == inst.m_state)
+				if (m_timers.at(i).state == inst.m_state)
 				{
-					luaL_unref(m_timers[i].state, LUA_REGISTRYINDEX, m_timers[i].func);
-					m_timers.eraseFast(i);
-					--i;
+					luaL_unref(m_timers.at(i).state, LUA_REGISTRYINDEX, m_timers.at(i).func);
+					m_timer_wheel.cancel(m_timers.at(i).handle);
+					m_timers.eraseAt(i);
 				}
 			}
 
@@ -1032,7 +1296,7 @@ namespace Lumix
 			{
 				if(m_updates[i].state == inst.m_state)
 				{
-					m_updates.eraseFast(i);
+					removeFromUpdates(i);
 					break;
 				}
 			}
@@ -1063,6 +1327,40 @@ namespace Lumix
 		}
 
 
+		// keeps the Lua-side dispatch table mirroring m_updates; slot idx holds
+		// the environment of m_updates[idx], so update() enters the VM once per
+		// frame instead of once per script
+		void setUpdateTableSlot(int idx, int environment)
+		{
+			lua_State* L = m_system.m_engine.getState();
+			if (m_update_table_ref == -1)
+			{
+				lua_newtable(L);
+				m_update_table_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+			}
+			lua_rawgeti(L, LUA_REGISTRYINDEX, m_update_table_ref);
+			if (environment == -1)
+			{
+				lua_pushnil(L);
+			}
+			else
+			{
+				lua_rawgeti(L, LUA_REGISTRYINDEX, environment);
+			}
+			lua_rawseti(L, -2, idx + 1);
+			lua_pop(L, 1);
+		}
+
+
+		void removeFromUpdates(int idx)
+		{
+			int last = m_updates.size() - 1;
+			if (idx != last) setUpdateTableSlot(idx, m_updates[last].environment);
+			setUpdateTableSlot(last, -1);
+			m_updates.eraseFast(idx);
+		}
+
+
 		void startScript(ScriptInstance& instance, bool is_restart)
 		{
 			if (is_restart)
@@ -1071,7 +1369,7 @@ namespace Lumix
 				{
 					if (m_updates[i].state == instance.m_state)
 					{
-						m_updates.eraseFast(i);
+						removeFromUpdates(i);
 						break;
 					}
 				}
@@ -1089,6 +1387,7 @@ namespace Lumix
 				update_data.script = instance.m_script;
 				update_data.state = instance.m_state;
 				update_data.environment = instance.m_environment;
+				setUpdateTableSlot(m_updates.size() - 1, instance.m_environment);
 			}
 			lua_pop(instance.m_state, 1);
 
@@ -1120,8 +1419,22 @@ namespace Lumix
 		{
 			m_scripts_init_called = false;
 			m_is_game_running = false;
+			destroyComputeVMs();
+			m_tweens.clear();
 			m_updates.clear();
+			lua_State* L = m_system.m_engine.getState();
+			if (m_update_table_ref != -1)
+			{
+				luaL_unref(L, LUA_REGISTRYINDEX, m_update_table_ref);
+				m_update_table_ref = -1;
+			}
+			if (m_update_dispatcher_ref != -1)
+			{
+				luaL_unref(L, LUA_REGISTRYINDEX, m_update_dispatcher_ref);
+				m_update_dispatcher_ref = -1;
+			}
 			m_timers.clear();
+			m_timer_wheel.clear();
 		}
 
 
@@ -1445,42 +1758,230 @@ namespace Lumix
 
 		void updateTimers(float time_delta)
 		{
-			int timers_to_remove[1024];
-			int timers_to_remove_count = 0;
-			for (int i = 0, c = m_timers.size(); i < c; ++i)
+			m_timer_wheel.update(time_delta);
+		}
+
+
+		// easing: 0 linear, 1 ease in, 2 ease out, 3 ease in-out
+		static float easeTween(int easing, float t)
+		{
+			switch (easing)
 			{
-				auto& timer = m_timers[i];
-				timer.time -= time_delta;
-				if (timer.time < 0)
+				case 1: return t * t;
+				case 2: return t * (2 - t);
+				case 3: return t < 0.5f ? 2 * t * t : -1 + (4 - 2 * t) * t;
+				default: return t;
+			}
+		}
+
+
+		int startTween(Tween& tween)
+		{
+			tween.id = m_next_tween_id;
+			++m_next_tween_id;
+			tween.time = 0;
+			if (tween.duration < 0.001f) tween.duration = 0.001f;
+			m_tweens.push(tween);
+			return tween.id;
+		}
+
+
+		int tweenPosition(Entity entity, Vec3 to, float duration, int easing)
+		{
+			Tween tween;
+			tween.entity = entity;
+			tween.type = Tween::POSITION;
+			tween.easing = easing;
+			tween.duration = duration;
+			tween.from_pos = m_universe.getPosition(entity);
+			tween.to_pos = to;
+			return startTween(tween);
+		}
+
+
+		int tweenRotation(Entity entity, Vec3 axis, float angle, float duration, int easing)
+		{
+			Tween tween;
+			tween.entity = entity;
+			tween.type = Tween::ROTATION;
+			tween.easing = easing;
+			tween.duration = duration;
+			tween.from_rot = m_universe.getRotation(entity);
+			tween.to_rot = Quat(axis, angle);
+			return startTween(tween);
+		}
+
+
+		int tweenProperty(const char* cmp_name,
+			const char* prop_name,
+			Entity entity,
+			float to,
+			float duration,
+			int easing)
+		{
+			ComponentType cmp_type = PropertyRegister::getComponentType(cmp_name);
+			const IPropertyDescriptor* desc = PropertyRegister::getDescriptor(cmp_type, crc32(prop_name));
+			if (!desc || desc->getType() != IPropertyDescriptor::DECIMAL)
+			{
+				g_log_error.log("Lua Script") << "Can not tween property " << cmp_name << "." << prop_name;
+				return -1;
+			}
+			IScene* scene = m_universe.getScene(cmp_type);
+			if (!scene) return -1;
+			ComponentHandle handle = scene->getComponent(entity, cmp_type);
+			if (!isValid(handle)) return -1;
+
+			Tween tween;
+			tween.entity = entity;
+			tween.type = Tween::PROPERTY;
+			tween.easing = easing;
+			tween.duration = duration;
+			tween.desc = desc;
+			tween.cmp = ComponentUID(entity, cmp_type, scene, handle);
+			OutputBlob blob(&tween.from_value, sizeof(tween.from_value));
+			desc->get(tween.cmp, -1, blob);
+			tween.to_value = to;
+			return startTween(tween);
+		}
+
+
+		void cancelTween(int id)
+		{
+			for (int i = 0; i < m_tweens.size(); ++i)
+			{
+				if (m_tweens[i].id == id)
 				{
-					if (lua_rawgeti(timer.state, LUA_REGISTRYINDEX, timer.func) != LUA_TFUNCTION)
-					{
-						ASSERT(false);
-					}
+					m_tweens.eraseFast(i);
+					return;
+				}
+			}
+		}
 
-					if (lua_pcall(timer.state, 0, 0, 0) != LUA_OK)
+
+		void updateTweens(float time_delta)
+		{
+			for (int i = m_tweens.size() - 1; i >= 0; --i)
+			{
+				Tween& tween = m_tweens[i];
+				tween.time += time_delta;
+				float t = easeTween(tween.easing, Math::minimum(tween.time / tween.duration, 1.0f));
+				switch (tween.type)
+				{
+					case Tween::POSITION:
+						m_universe.setPosition(tween.entity, tween.from_pos + (tween.to_pos - tween.from_pos) * t);
+						break;
+					case Tween::ROTATION:
 					{
-						g_log_error.log("Lua Script") << lua_tostring(timer.state, -1);
-						lua_pop(timer.state, 1);
+						Quat rot;
+						nlerp(tween.from_rot, tween.to_rot, &rot, t);
+						m_universe.setRotation(tween.entity, rot);
 					}
-					timers_to_remove[timers_to_remove_count] = i;
-					++timers_to_remove_count;
-					if (timers_to_remove_count >= lengthOf(timers_to_remove))
+					break;
+					case Tween::PROPERTY:
 					{
-						g_log_error.log("Lua Script") << "Too many lua timers in one frame, some are not executed";
-						break;
+						float v = tween.from_value + (tween.to_value - tween.from_value) * t;
+						InputBlob blob(&v, sizeof(v));
+						tween.desc->set(tween.cmp, -1, blob);
 					}
+					break;
 				}
+				if (tween.time >= tween.duration) m_tweens.eraseFast(i);
+			}
+		}
+
+
+		// blocks until all compute VM jobs finished; must run before the main
+		// thread touches any compute VM or its message queues
+		void syncComputeJobs()
+		{
+			if (!m_compute_jobs_in_flight) return;
+
+			m_compute_jobs_sync.sync();
+			m_compute_jobs_in_flight = false;
+			for (ComputeVM* vm : m_compute_vms)
+			{
+				if (!vm || vm->error.length() == 0) continue;
+				g_log_error.log("Lua Script") << vm->error.c_str();
+				vm->error = "";
+			}
+		}
+
+
+		static void updateComputeVM(ComputeVM& vm, float time_delta)
+		{
+			lua_State* L = vm.state;
+			if (lua_getglobal(L, "update") != LUA_TFUNCTION)
+			{
+				lua_pop(L, 1);
+				return;
+			}
+			lua_pushnumber(L, time_delta);
+			if (lua_pcall(L, 1, 0, 0) != LUA_OK)
+			{
+				// logging is deferred to the main thread after sync
+				vm.error = lua_tostring(L, -1);
+				lua_pop(L, 1);
 			}
-			for (int i = timers_to_remove_count - 1; i >= 0; --i)
+		}
+
+
+		void scheduleComputeJobs(float time_delta)
+		{
+			ASSERT(!m_compute_jobs_in_flight);
+			MTJD::Manager& manager = m_system.m_engine.getMTJDManager();
+			for (ComputeVM* vm : m_compute_vms)
 			{
-				auto& timer = m_timers[timers_to_remove[i]];
-				luaL_unref(timer.state, LUA_REGISTRYINDEX, timer.func);
-				m_timers.eraseFast(timers_to_remove[i]);
+				if (!vm) continue;
+				MTJD::Job* job = MTJD::makeJob(manager,
+					[vm, time_delta]() { updateComputeVM(*vm, time_delta); },
+					manager.getJobAllocator());
+				job->addDependency(&m_compute_jobs_sync);
+				manager.schedule(job);
+				m_compute_jobs_in_flight = true;
 			}
 		}
 
 
+		void destroyComputeVMs()
+		{
+			syncComputeJobs();
+			for (ComputeVM*& vm : m_compute_vms)
+			{
+				if (!vm) continue;
+				lua_close(vm->state);
+				LUMIX_DELETE(m_system.m_allocator, vm);
+				vm = nullptr;
+			}
+			m_compute_vms.clear();
+		}
+
+
+		void ensureUpdateDispatcher(lua_State* L)
+		{
+			if (m_update_dispatcher_ref != -1) return;
+
+			static const char* DISPATCHER_SRC =
+				"return function(envs, count, dt)\n"
+				"	for i = 1, count do\n"
+				"		local update = envs[i].update\n"
+				"		if update ~= nil then\n"
+				"			local ok, err = pcall(update, dt)\n"
+				"			if not ok then Engine.logError(err) end\n"
+				"		end\n"
+				"	end\n"
+				"end";
+
+			if (luaL_loadbuffer(L, DISPATCHER_SRC, stringLength(DISPATCHER_SRC), "update_dispatcher") != LUA_OK ||
+				lua_pcall(L, 0, 1, 0) != LUA_OK)
+			{
+				g_log_error.log("Lua Script") << lua_tostring(L, -1);
+				lua_pop(L, 1);
+				return;
+			}
+			m_update_dispatcher_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+		}
+
+
 		void update(float time_delta, bool paused) override
 		{
 			PROFILE_FUNCTION();
@@ -1489,7 +1990,36 @@ namespace Lumix
 
 			if (paused) return;
 
+			syncComputeJobs();
+
 			updateTimers(time_delta);
+			updateTweens(time_delta);
+
+			if (!m_updates.empty()) updateScripts(time_delta);
+
+			// scheduled last so compute VMs overlap the rest of the frame and
+			// message calls from script updates do not stall on the jobs
+			scheduleComputeJobs(time_delta);
+		}
+
+
+		void updateScripts(float time_delta)
+		{
+			lua_State* L = m_system.m_engine.getState();
+			ensureUpdateDispatcher(L);
+			if (m_update_dispatcher_ref != -1 && m_update_table_ref != -1)
+			{
+				lua_rawgeti(L, LUA_REGISTRYINDEX, m_update_dispatcher_ref);
+				lua_rawgeti(L, LUA_REGISTRYINDEX, m_update_table_ref);
+				lua_pushinteger(L, m_updates.size());
+				lua_pushnumber(L, time_delta);
+				if (lua_pcall(L, 3, 0, 0) != LUA_OK)
+				{
+					g_log_error.log("Lua Script") << lua_tostring(L, -1);
+					lua_pop(L, 1);
+				}
+				return;
+			}
 
 			for (int i = 0; i < m_updates.size(); ++i)
 			{
@@ -1622,19 +2152,16 @@ namespace Lumix
 		{
 			auto& scr = m_scripts[{cmp.index}]->m_scripts[scr_index];
 			int count;
-			char path[MAX_PATH_LENGTH];
-			blob.readString(path, lengthOf(path));
+			const char* path = blob.readStringView();
 			blob.read(count);
 			scr.m_environment = -1;
 			scr.m_properties.clear();
-			char buf[256];
 			for (int i = 0; i < count; ++i)
 			{
 				auto& prop = scr.m_properties.emplace(m_system.m_allocator);
 				prop.type = Property::ANY;
 				blob.read(prop.name_hash);
-				blob.readString(buf, lengthOf(buf));
-				prop.stored_value = buf;
+				prop.stored_value = blob.readStringView();
 			}
 			setScriptPath(cmp, scr_index, Path(path));
 		}
@@ -1645,9 +2172,17 @@ namespace Lumix
 		AssociativeArray<u32, string> m_property_names;
 		Universe& m_universe;
 		Array<UpdateData> m_updates;
-		Array<TimerData> m_timers;
+		AssociativeArray<int, TimerData> m_timers;
+		TimerWheel m_timer_wheel;
 		FunctionCall m_function_call;
 		ScriptInstance* m_current_script_instance;
+		Array<ComputeVM*> m_compute_vms;
+		MTJD::Group m_compute_jobs_sync;
+		bool m_compute_jobs_in_flight = false;
+		Array<Tween> m_tweens;
+		int m_next_tween_id = 0;
+		int m_update_dispatcher_ref = -1;
+		int m_update_table_ref = -1;
 		bool m_scripts_init_called = false;
 		bool m_is_api_registered = false;
 		bool m_is_game_running = false;
@@ -109,6 +109,10 @@ struct StudioAppPlugin LUMIX_FINAL : public StudioApp::IPlugin
 					}
 				}
 
+				static bool debug_draw_links = false;
+				ImGui::Checkbox("Draw links", &debug_draw_links);
+				if (debug_draw_links) scene->debugDrawLinks();
+
 				static bool debug_draw_navmesh = false;
 				ImGui::Checkbox("Draw navmesh", &debug_draw_navmesh);
 				if (debug_draw_navmesh)
@@ -170,5 +174,6 @@ LUMIX_STUDIO_ENTRY(navigation)
 	app.addPlugin(*studio_app_plugin);
 
 	app.registerComponent("navmesh_agent", "Navmesh Agent");
+	app.registerComponent("navmesh_link", "Navmesh Link");
 }
 
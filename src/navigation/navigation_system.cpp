@@ -10,6 +10,10 @@
 #include "engine/log.h"
 #include "engine/lua_wrapper.h"
 #include "engine/lumix.h"
+#include "engine/mtjd/for_each.h"
+#include "engine/mtjd/generic_job.h"
+#include "engine/mtjd/group.h"
+#include "engine/mt/atomic.h"
 #include "engine/profiler.h"
 #include "engine/property_descriptor.h"
 #include "engine/property_register.h"
@@ -39,18 +43,217 @@ enum class NavigationSceneVersion : int
 {
 	USE_ROOT_MOTION,
 	ROOT_MOTION_FROM_ANIM,
+	NAVMESH_LINK,
 
 	LATEST
 };
 
 
 static const ComponentType NAVMESH_AGENT_TYPE = PropertyRegister::getComponentType("navmesh_agent");
+static const ComponentType NAVMESH_LINK_TYPE = PropertyRegister::getComponentType("navmesh_link");
+// links use areas below RC_WALKABLE_AREA; one area per distinct traversal
+// cost, so the cost lookup the crowd does per hop is a baked array read
+static const u8 OFFMESH_FIRST_AREA = 1;
 static const ComponentType ANIM_CONTROLLER_TYPE = PropertyRegister::getComponentType("anim_controller");
 static const int CELLS_PER_TILE_SIDE = 256;
 static const float CELL_SIZE = 0.3f;
 static void registerLuaAPI(lua_State* L);
 
 
+static const unsigned char FULL_AGENT_UPDATE_FLAGS = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_SEPARATION |
+	DT_CROWD_OBSTACLE_AVOIDANCE | DT_CROWD_OPTIMIZE_TOPO | DT_CROWD_OPTIMIZE_VIS;
+
+
+// pre-transformed triangles bucketed per navmesh tile, built once per bake;
+// tile rasterization then reads world-space geometry instead of
+// re-transforming every intersecting model for every tile it touches
+struct TileGeometry
+{
+	explicit TileGeometry(IAllocator& allocator)
+		: vertices(allocator)
+		, areas(allocator)
+	{
+	}
+
+	Array<Vec3> vertices;
+	Array<u8> areas;
+};
+
+
+// debug geometry is built once from its source data into these retained
+// buffers and replayed in bulk every frame; invalidated only when the source
+// changes
+struct DebugDrawCache
+{
+	explicit DebugDrawCache(IAllocator& allocator)
+		: lines(allocator)
+		, triangles(allocator)
+	{
+	}
+
+	void clear()
+	{
+		lines.clear();
+		triangles.clear();
+		is_valid = false;
+	}
+
+	Array<DebugLine> lines;
+	Array<DebugTriangle> triangles;
+	bool is_valid = false;
+};
+
+
+static void addCacheLine(DebugDrawCache& cache, const Vec3& from, const Vec3& to, u32 color)
+{
+	DebugLine& line = cache.lines.emplace();
+	line.from = from;
+	line.to = to;
+	line.color = color;
+	line.life = 0;
+}
+
+
+static void addCacheTriangle(DebugDrawCache& cache, const Vec3& p0, const Vec3& p1, const Vec3& p2, u32 color)
+{
+	DebugTriangle& tri = cache.triangles.emplace();
+	tri.p0 = p0;
+	tri.p1 = p1;
+	tri.p2 = p2;
+	tri.color = color;
+	tri.life = 0;
+}
+
+
+static void addCacheCube(DebugDrawCache& cache, const Vec3& min, const Vec3& max, u32 color)
+{
+	Vec3 a = min;
+	Vec3 b = min;
+	b.x = max.x;
+	addCacheLine(cache, a, b, color);
+	a.set(b.x, b.y, max.z);
+	addCacheLine(cache, a, b, color);
+	b.set(min.x, a.y, a.z);
+	addCacheLine(cache, a, b, color);
+	a.set(b.x, b.y, min.z);
+	addCacheLine(cache, a, b, color);
+
+	a = min;
+	a.y = max.y;
+	b = a;
+	b.x = max.x;
+	addCacheLine(cache, a, b, color);
+	a.set(b.x, b.y, max.z);
+	addCacheLine(cache, a, b, color);
+	b.set(min.x, a.y, a.z);
+	addCacheLine(cache, a, b, color);
+	a.set(b.x, b.y, min.z);
+	addCacheLine(cache, a, b, color);
+
+	a = min;
+	b = a;
+	b.y = max.y;
+	addCacheLine(cache, a, b, color);
+	a.x = max.x;
+	b.x = max.x;
+	addCacheLine(cache, a, b, color);
+	a.z = max.z;
+	b.z = max.z;
+	addCacheLine(cache, a, b, color);
+	a.x = min.x;
+	b.x = min.x;
+	addCacheLine(cache, a, b, color);
+}
+
+
+static void addCacheCubeSolid(DebugDrawCache& cache, const Vec3& min, const Vec3& max, u32 color)
+{
+	Vec3 a = min;
+	Vec3 b = min;
+	Vec3 c = max;
+
+	b.x = max.x;
+	c.z = min.z;
+	addCacheTriangle(cache, a, c, b, color);
+	b.x = min.x;
+	b.y = max.y;
+	addCacheTriangle(cache, a, b, c, color);
+
+	b = max;
+	c = max;
+	a.z = max.z;
+	b.y = min.y;
+	addCacheTriangle(cache, a, b, c, color);
+	b.x = min.x;
+	b.y = max.y;
+	addCacheTriangle(cache, a, c, b, color);
+
+	a = min;
+	b = min;
+	c = max;
+
+	b.x = max.x;
+	c.y = min.y;
+	addCacheTriangle(cache, a, c, b, color);
+	b.x = min.x;
+	b.z = max.z;
+	addCacheTriangle(cache, a, b, c, color);
+
+	b = max;
+	c = max;
+	a.y = max.y;
+	b.z = min.z;
+	addCacheTriangle(cache, a, c, b, color);
+	b.x = min.x;
+	b.z = max.z;
+	addCacheTriangle(cache, a, b, c, color);
+
+	a = min;
+	b = min;
+	c = max;
+
+	b.y = max.y;
+	c.x = min.x;
+	addCacheTriangle(cache, a, c, b, color);
+	b.y = min.y;
+	b.z = max.z;
+	addCacheTriangle(cache, a, b, c, color);
+
+	b = max;
+	c = max;
+	a.x = max.x;
+	b.z = min.z;
+	addCacheTriangle(cache, a, b, c, color);
+	b.y = min.y;
+	b.z = max.z;
+	addCacheTriangle(cache, a, c, b, color);
+}
+
+
+enum class TileState : u8
+{
+	UNLOADED,
+	LOADING,
+	LOADED
+};
+
+
+struct PathRequest
+{
+	Entity entity;
+	Vec3 dest;
+	float speed;
+	float stop_distance;
+};
+
+
+struct DirtyTile
+{
+	int x;
+	int z;
+};
+
+
 struct Agent
 {
 	enum Flags : u32
@@ -69,6 +272,35 @@ struct Agent
 	float speed = 0;
 	float yaw_diff = 0;
 	float stop_distance = 0;
+	bool is_lod_reduced = false;
+	// long-range routes are followed one tile-corridor leg at a time
+	bool is_long_range = false;
+	Vec3 long_range_dest = {0, 0, 0};
+	float long_range_speed = 0;
+	float long_range_stop_distance = 0;
+};
+
+
+// one node per navmesh tile; the four axis neighbors (Detour's even sides)
+// carry the averaged portal midpoint, cached so tile-level A* prices a hop
+// as portal-to-portal distance without touching the polygon graph
+struct TileGraphNode
+{
+	bool connected[4];
+	Vec3 portal[4];
+};
+
+
+// an authored off-mesh connection; the entity's position is the start point,
+// the end offset is in the entity's local space
+struct NavmeshLink
+{
+	Entity entity;
+	Vec3 end_offset = {0, 0, 2};
+	float radius = 0.5f;
+	float cost = 1;
+	bool is_bidirectional = true;
+	u8 area = OFFMESH_FIRST_AREA;
 };
 
 
@@ -76,7 +308,7 @@ struct NavigationSystem LUMIX_FINAL : public IPlugin
 {
 	NavigationSystem(Engine& engine)
 		: m_engine(engine)
-		, m_allocator(engine.getAllocator())
+		, m_allocator("navigation", engine.getAllocator())
 	{
 		ASSERT(s_instance == nullptr);
 		s_instance = this;
@@ -152,19 +384,47 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		, m_num_tiles_x(0)
 		, m_num_tiles_z(0)
 		, m_agents(m_allocator)
+		, m_links(m_allocator)
+		, m_link_cost_areas(m_allocator)
+		, m_debug_navmesh_cache(m_allocator)
+		, m_debug_path_cache(m_allocator)
+		, m_debug_heightfield_cache(m_allocator)
+		, m_debug_compact_cache(m_allocator)
+		, m_debug_contours_cache(m_allocator)
+		, m_navmesh_generation(0)
+		, m_tile_graph(m_allocator)
+		, m_tile_graph_generation(0xffffFFFF)
+		, m_moved_entity_aabbs(m_allocator)
+		, m_dirty_tiles(m_allocator)
+		, m_path_requests(m_allocator)
+		, m_tile_states(m_allocator)
+		, m_bake_geometry(m_allocator)
+		, m_is_streaming(false)
+		, m_streaming_radius(FLT_MAX)
+		, m_tile_rebuild_sync(true, m_allocator)
+		, m_tile_rebuild_state(0)
+		, m_rebuilt_tile_data(nullptr)
+		, m_rebuilt_tile_size(0)
+		, m_rebuilt_tile_success(false)
 		, m_crowd(nullptr)
+		, m_crowd_job_sync(true, m_allocator)
+		, m_crowd_job_in_flight(false)
+		, m_crowd_job_dt(0)
+		, m_agent_lod_distance(FLT_MAX)
 		, m_script_scene(nullptr)
 		, m_on_update(m_allocator)
 	{
 		setGeneratorParams(0.3f, 0.1f, 0.3f, 2.0f, 60.0f, 1.5f);
-		m_universe.entityTransformed().bind<NavigationSceneImpl, &NavigationSceneImpl::onEntityMoved>(this);
+		m_universe.entityTransformed().bind<NavigationSceneImpl, &NavigationSceneImpl::onEntitiesMoved>(this);
 		universe.registerComponentType(NAVMESH_AGENT_TYPE, this, &NavigationSceneImpl::serializeAgent, &NavigationSceneImpl::deserializeAgent);
+		universe.registerComponentType(NAVMESH_LINK_TYPE, this, &NavigationSceneImpl::serializeLink, &NavigationSceneImpl::deserializeLink);
 	}
 
 
 	~NavigationSceneImpl()
 	{
-		m_universe.entityTransformed().unbind<NavigationSceneImpl, &NavigationSceneImpl::onEntityMoved>(this);
+		syncCrowdJob();
+		m_universe.entityTransformed().unbind<NavigationSceneImpl, &NavigationSceneImpl::onEntitiesMoved>(this);
 		clearNavmesh();
 	}
 
@@ -172,14 +432,24 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	void clear() override
 	{
 		m_agents.clear();
+		m_links.clear();
+	}
+
+
+	void onEntitiesMoved(const Entity* entities, int count)
+	{
+		for (int i = 0; i < count; ++i) onEntityMoved(entities[i]);
 	}
 
 
 	void onEntityMoved(Entity entity)
 	{
+		markDirty(entity);
+
 		auto iter = m_agents.find(entity);
 		if (!iter.isValid()) return;
 		if (iter.value().agent < 0) return;
+		syncCrowdJob();
 		const Agent& agent = iter.value();
 		Vec3 pos = m_universe.getPosition(iter.key());
 		const dtCrowdAgent* dt_agent = m_crowd->getAgent(agent.agent);
@@ -197,8 +467,142 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	}
 
 
+	// marks the tiles under the entity's old and new world AABBs for rebuild;
+	// agents are skipped - they move every frame and do not shape the navmesh
+	void markDirty(Entity entity)
+	{
+		if (!m_navmesh) return;
+		if (m_agents.find(entity).isValid()) return;
+
+		auto* render_scene = static_cast<RenderScene*>(m_universe.getScene(crc32("renderer")));
+		if (!render_scene) return;
+		ComponentHandle model_instance = render_scene->getModelInstanceComponent(entity);
+		if (model_instance == INVALID_COMPONENT) return;
+		Model* model = render_scene->getModelInstanceModel(model_instance);
+		if (!model || !model->isReady()) return;
+
+		AABB aabb = model->getAABB();
+		aabb.transform(m_universe.getMatrix(entity));
+
+		auto aabb_iter = m_moved_entity_aabbs.find(entity);
+		if (aabb_iter.isValid())
+		{
+			markDirtyAABB(aabb_iter.value());
+			aabb_iter.value() = aabb;
+		}
+		else
+		{
+			m_moved_entity_aabbs.insert(entity, aabb);
+		}
+		markDirtyAABB(aabb);
+	}
+
+
+	void markDirtyAABB(const AABB& aabb)
+	{
+		// a tile rasterizes geometry one border past its bounds, so the dirty
+		// region is expanded accordingly
+		float margin = (1 + m_config.borderSize) * m_config.cs;
+		float tile_size = CELLS_PER_TILE_SIDE * CELL_SIZE;
+		int from_x = Math::clamp(int((aabb.min.x - m_aabb.min.x - margin) / tile_size), 0, m_num_tiles_x - 1);
+		int to_x = Math::clamp(int((aabb.max.x - m_aabb.min.x + margin) / tile_size), 0, m_num_tiles_x - 1);
+		int from_z = Math::clamp(int((aabb.min.z - m_aabb.min.z - margin) / tile_size), 0, m_num_tiles_z - 1);
+		int to_z = Math::clamp(int((aabb.max.z - m_aabb.min.z + margin) / tile_size), 0, m_num_tiles_z - 1);
+		for (int z = from_z; z <= to_z; ++z)
+		{
+			for (int x = from_x; x <= to_x; ++x)
+			{
+				bool queued = false;
+				for (const DirtyTile& tile : m_dirty_tiles)
+				{
+					if (tile.x == x && tile.z == z)
+					{
+						queued = true;
+						break;
+					}
+				}
+				if (queued) continue;
+				DirtyTile& tile = m_dirty_tiles.emplace();
+				tile.x = x;
+				tile.z = z;
+			}
+		}
+	}
+
+
+	// one dirty tile at a time is rebuilt on a worker; the finished blob is
+	// swapped into the Detour navmesh here, on the main thread between crowd
+	// updates, so agents never query a half-built tile. The worker reads live
+	// scene geometry - an entity moving mid-build re-dirties its tiles, so the
+	// result converges
+	void processDirtyTiles()
+	{
+		if (m_tile_rebuild_state == 2)
+		{
+			m_tile_rebuild_sync.sync();
+			if (m_navmesh)
+			{
+				m_navmesh->removeTile(
+					m_navmesh->getTileRefAt(m_rebuilding_tile.x, m_rebuilding_tile.z, 0), 0, 0);
+				if (m_rebuilt_tile_success &&
+					dtStatusFailed(m_navmesh->addTile(
+						m_rebuilt_tile_data, m_rebuilt_tile_size, DT_TILE_FREE_DATA, 0, nullptr)))
+				{
+					g_log_error.log("Navigation") << "Could not add rebuilt Detour tile.";
+					dtFree(m_rebuilt_tile_data);
+				}
+				++m_navmesh_generation;
+			}
+			else if (m_rebuilt_tile_success)
+			{
+				dtFree(m_rebuilt_tile_data);
+			}
+			m_rebuilt_tile_data = nullptr;
+			m_tile_rebuild_state = 0;
+		}
+
+		if (m_tile_rebuild_state != 0) return;
+		if (!m_navmesh || m_dirty_tiles.empty()) return;
+
+		m_rebuilding_tile = m_dirty_tiles.back();
+		m_dirty_tiles.pop();
+		m_tile_rebuild_state = 1;
+		NavigationSceneImpl* scene = this;
+		MTJD::Job* job = MTJD::makeJob(m_system.m_engine.getMTJDManager(),
+			[scene]()
+			{
+				scene->m_rebuilt_tile_success = scene->buildTileNavData(scene->m_rebuilding_tile.x,
+					scene->m_rebuilding_tile.z,
+					false,
+					&scene->m_rebuilt_tile_data,
+					&scene->m_rebuilt_tile_size);
+				MT::memoryBarrier();
+				scene->m_tile_rebuild_state = 2;
+			},
+			m_system.m_engine.getMTJDManager().getJobAllocator());
+		job->addDependency(&m_tile_rebuild_sync);
+		m_system.m_engine.getMTJDManager().schedule(job);
+	}
+
+
+	// blocks until no rebuild job is touching scene or navmesh data
+	void finishTileRebuilds()
+	{
+		if (m_tile_rebuild_state == 0) return;
+		m_tile_rebuild_sync.sync();
+		if (m_tile_rebuild_state == 2 && m_rebuilt_tile_success) dtFree(m_rebuilt_tile_data);
+		m_rebuilt_tile_data = nullptr;
+		m_tile_rebuild_state = 0;
+	}
+
+
 	void clearNavmesh()
 	{
+		finishTileRebuilds();
+		m_is_streaming = false;
+		m_tile_states.clear();
+		m_dirty_tiles.clear();
+		m_moved_entity_aabbs.clear();
 		rcFreePolyMeshDetail(m_detail_mesh);
 		rcFreePolyMesh(m_polymesh);
 		dtFreeNavMeshQuery(m_navquery);
@@ -218,13 +622,106 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	}
 
 
-	void rasterizeGeometry(const AABB& aabb, rcContext& ctx, rcConfig& cfg, rcHeightfield& solid)
+	void rasterizeGeometry(int tile_x, int tile_z, const AABB& aabb, rcContext& ctx, rcConfig& cfg, rcHeightfield& solid)
 	{
-		rasterizeMeshes(aabb, ctx, cfg, solid);
+		rasterizeMeshes(tile_x, tile_z, aabb, ctx, cfg, solid);
 		rasterizeTerrains(aabb, ctx, cfg, solid);
 	}
 
 
+	void bucketBakeTriangle(const Vec3& a, const Vec3& b, const Vec3& c, u8 area)
+	{
+		float tile_size = CELLS_PER_TILE_SIDE * CELL_SIZE;
+		// a tile rasterizes a border around itself, so triangles land in every
+		// tile whose expanded bounds they touch
+		float margin = (1 + m_config.borderSize) * m_config.cs;
+		float min_x = Math::minimum(a.x, Math::minimum(b.x, c.x)) - margin;
+		float max_x = Math::maximum(a.x, Math::maximum(b.x, c.x)) + margin;
+		float min_z = Math::minimum(a.z, Math::minimum(b.z, c.z)) - margin;
+		float max_z = Math::maximum(a.z, Math::maximum(b.z, c.z)) + margin;
+		int from_x = int(floorf((min_x - m_aabb.min.x) / tile_size));
+		int to_x = int(floorf((max_x - m_aabb.min.x) / tile_size));
+		int from_z = int(floorf((min_z - m_aabb.min.z) / tile_size));
+		int to_z = int(floorf((max_z - m_aabb.min.z) / tile_size));
+		if (to_x < 0 || from_x >= m_num_tiles_x) return;
+		if (to_z < 0 || from_z >= m_num_tiles_z) return;
+		from_x = Math::clamp(from_x, 0, m_num_tiles_x - 1);
+		to_x = Math::clamp(to_x, 0, m_num_tiles_x - 1);
+		from_z = Math::clamp(from_z, 0, m_num_tiles_z - 1);
+		to_z = Math::clamp(to_z, 0, m_num_tiles_z - 1);
+		for (int z = from_z; z <= to_z; ++z)
+		{
+			for (int x = from_x; x <= to_x; ++x)
+			{
+				TileGeometry& geom = m_bake_geometry[x + z * m_num_tiles_x];
+				geom.vertices.push(a);
+				geom.vertices.push(b);
+				geom.vertices.push(c);
+				geom.areas.push(area);
+			}
+		}
+	}
+
+
+	void buildBakeGeometryCache()
+	{
+		PROFILE_FUNCTION();
+		const float walkable_threshold = cosf(Math::degreesToRadians(45));
+
+		m_bake_geometry.clear();
+		m_bake_geometry.reserve(m_num_tiles_x * m_num_tiles_z);
+		for (int i = 0, c = m_num_tiles_x * m_num_tiles_z; i < c; ++i) m_bake_geometry.emplace(m_allocator);
+
+		auto render_scene = static_cast<RenderScene*>(m_universe.getScene(crc32("renderer")));
+		if (!render_scene) return;
+
+		u32 no_navigation_flag = Material::getCustomFlag("no_navigation");
+		u32 nonwalkable_flag = Material::getCustomFlag("nonwalkable");
+		for (auto model_instance = render_scene->getFirstModelInstance(); model_instance != INVALID_COMPONENT;
+			 model_instance = render_scene->getNextModelInstance(model_instance))
+		{
+			auto* model = render_scene->getModelInstanceModel(model_instance);
+			if (!model) continue;
+			ASSERT(model->isReady());
+
+			bool is16 = model->areIndices16();
+
+			Entity entity = render_scene->getModelInstanceEntity(model_instance);
+			Matrix mtx = m_universe.getMatrix(entity);
+			auto lod = model->getLODMeshIndices(0);
+			for (int mesh_idx = lod.from; mesh_idx <= lod.to; ++mesh_idx)
+			{
+				auto& mesh = model->getMesh(mesh_idx);
+				if (mesh.material->isCustomFlag(no_navigation_flag)) continue;
+				bool is_walkable = !mesh.material->isCustomFlag(nonwalkable_flag);
+				auto* vertices =
+					&model->getVertices()[mesh.attribute_array_offset / model->getVertexDecl().getStride()];
+				const u16* indices16 = model->getIndices16();
+				const u32* indices32 = model->getIndices32();
+				for (int i = 0; i < mesh.indices_count; i += 3)
+				{
+					Vec3 a, b, c;
+					if (is16)
+					{
+						a = mtx.transform(vertices[indices16[mesh.indices_offset + i]]);
+						b = mtx.transform(vertices[indices16[mesh.indices_offset + i + 1]]);
+						c = mtx.transform(vertices[indices16[mesh.indices_offset + i + 2]]);
+					}
+					else
+					{
+						a = mtx.transform(vertices[indices32[mesh.indices_offset + i]]);
+						b = mtx.transform(vertices[indices32[mesh.indices_offset + i + 1]]);
+						c = mtx.transform(vertices[indices32[mesh.indices_offset + i + 2]]);
+					}
+					Vec3 n = crossProduct(a - b, a - c).normalized();
+					u8 area = n.y > walkable_threshold && is_walkable ? RC_WALKABLE_AREA : 0;
+					bucketBakeTriangle(a, b, c, area);
+				}
+			}
+		}
+	}
+
+
 	AABB getTerrainSpaceAABB(const Vec3& terrain_pos, const Quat& terrain_rot, const AABB& aabb_world_space)
 	{
 		Matrix mtx = terrain_rot.toMatrix();
@@ -296,9 +793,20 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	}
 
 
-	void rasterizeMeshes(const AABB& aabb, rcContext& ctx, rcConfig& cfg, rcHeightfield& solid)
+	void rasterizeMeshes(int tile_x, int tile_z, const AABB& aabb, rcContext& ctx, rcConfig& cfg, rcHeightfield& solid)
 	{
 		PROFILE_FUNCTION();
+		if (!m_bake_geometry.empty())
+		{
+			const TileGeometry& geom = m_bake_geometry[tile_x + tile_z * m_num_tiles_x];
+			for (int i = 0, c = geom.areas.size(); i < c; ++i)
+			{
+				const Vec3* v = &geom.vertices[i * 3];
+				rcRasterizeTriangle(&ctx, &v[0].x, &v[1].x, &v[2].x, geom.areas[i], solid);
+			}
+			return;
+		}
+
 		const float walkable_threshold = cosf(Math::degreesToRadians(45));
 
 		auto render_scene = static_cast<RenderScene*>(m_universe.getScene(crc32("renderer")));
@@ -385,6 +893,10 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	}
 
 
+	void setAgentLODDistance(float distance) override { m_agent_lod_distance = distance; }
+	float getAgentLODDistance() const override { return m_agent_lod_distance; }
+
+
 	float getAgentSpeed(Entity entity) override
 	{
 		return m_agents[entity].speed;
@@ -403,13 +915,51 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	}
 
 
-	void update(float time_delta, bool paused) override
+	// distant agents steer along their corridor without obstacle avoidance,
+	// separation or path optimization, which is where most of the per-agent
+	// update cost goes; a single dtCrowd is clocked by one time step, so
+	// per-agent update frequency cannot be lowered without slowing the agent
+	// down - dropping the steering work is the part that can go
+	void updateAgentLODs()
 	{
-		PROFILE_FUNCTION();
-		if (!m_crowd) return;
-		if (paused) return;
-		m_crowd->update(time_delta, nullptr);
+		if (m_agent_lod_distance >= FLT_MAX) return;
+		auto* render_scene = static_cast<RenderScene*>(m_universe.getScene(crc32("renderer")));
+		if (!render_scene) return;
+		ComponentHandle camera = render_scene->getCameraInSlot("main");
+		if (!isValid(camera)) return;
 
+		Vec3 cam_pos = m_universe.getPosition(render_scene->getCameraEntity(camera));
+		float lod_distance_squared = m_agent_lod_distance * m_agent_lod_distance;
+		int reduced = 0;
+		for (auto& agent : m_agents)
+		{
+			if (agent.agent < 0) continue;
+			Vec3 pos = m_universe.getPosition(agent.entity);
+			bool is_far = (pos - cam_pos).squaredLength() > lod_distance_squared;
+			if (is_far) ++reduced;
+			if (agent.is_lod_reduced == is_far) continue;
+
+			agent.is_lod_reduced = is_far;
+			dtCrowdAgentParams params = m_crowd->getAgent(agent.agent)->params;
+			params.updateFlags = is_far ? 0 : FULL_AGENT_UPDATE_FLAGS;
+			m_crowd->updateAgentParameters(agent.agent, &params);
+		}
+		PROFILE_INT("reduced agents", reduced);
+	}
+
+
+	// waits for the crowd update job and publishes its results; every access
+	// to m_crowd outside the job must go through here first
+	void syncCrowdJob()
+	{
+		if (!m_crowd_job_in_flight) return;
+		{
+			PROFILE_BLOCK("sync crowd update");
+			m_crowd_job_sync.sync();
+		}
+		m_crowd_job_in_flight = false;
+
+		float time_delta = m_crowd_job_dt;
 		for (auto& agent : m_agents)
 		{
 			if (agent.agent < 0) continue;
@@ -434,9 +984,35 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	}
 
 
+	void update(float time_delta, bool paused) override
+	{
+		PROFILE_FUNCTION();
+		processDirtyTiles();
+		processPathRequests();
+		updateTileStreaming();
+		if (!m_crowd) return;
+		if (paused) return;
+
+		updateAgentLODs();
+
+		// dtCrowd is not thread-safe, so the whole crowd step runs as one
+		// worker job overlapped with the rest of the frame
+		dtCrowd* crowd = m_crowd;
+		m_crowd_job_dt = time_delta;
+		m_crowd_job_in_flight = true;
+		MTJD::Manager& manager = m_system.m_engine.getMTJDManager();
+		MTJD::Job* job = MTJD::makeJob(manager,
+			[crowd, time_delta]() { crowd->update(time_delta, nullptr); },
+			manager.getJobAllocator());
+		job->addDependency(&m_crowd_job_sync);
+		manager.schedule(job);
+	}
+
+
 	void lateUpdate(float time_delta, bool paused) override
 	{
 		PROFILE_FUNCTION();
+		syncCrowdJob();
 		if (!m_crowd) return;
 		if (paused) return;
 
@@ -504,7 +1080,7 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 				{
 					m_crowd->resetMoveTarget(agent.agent);
 					agent.is_finished = true;
-					onPathFinished(agent);
+					finishLeg(agent);
 				}
 			}
 			else if (dt_agent->ncorners == 1 && agent.stop_distance > 0)
@@ -514,7 +1090,7 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 				{
 					m_crowd->resetMoveTarget(agent.agent);
 					agent.is_finished = true;
-					onPathFinished(agent);
+					finishLeg(agent);
 				}
 			}
 			else
@@ -540,7 +1116,14 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	}
 
 
-	static void drawPoly(RenderScene* render_scene, const dtMeshTile& tile, const dtPoly& poly)
+	static void submitDebugCache(RenderScene* render_scene, const DebugDrawCache& cache)
+	{
+		if (!cache.lines.empty()) render_scene->addDebugLines(&cache.lines[0], cache.lines.size());
+		if (!cache.triangles.empty()) render_scene->addDebugTriangles(&cache.triangles[0], cache.triangles.size());
+	}
+
+
+	static void drawPoly(DebugDrawCache& cache, const dtMeshTile& tile, const dtPoly& poly)
 	{
 		const unsigned int ip = (unsigned int)(&poly - tile.polys);
 		const dtPolyDetail& pd = tile.detailMeshes[ip];
@@ -560,7 +1143,7 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 					v[k] = *(Vec3*)&tile.detailVerts[(pd.vertBase + t[k] - poly.vertCount) * 3];
 				}
 			}
-			render_scene->addDebugTriangle(v[0], v[1], v[2], 0xff00aaff, 0);
+			addCacheTriangle(cache, v[0], v[1], v[2], 0xff00aaff);
 		}
 
 		for (int k = 0; k < pd.triCount; ++k)
@@ -577,7 +1160,7 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 			for (int m = 0, n = 2; m < 3; n = m++)
 			{
 				if (((t[3] >> (n * 2)) & 0x3) == 0) continue; // Skip inner detail edges.
-				render_scene->addDebugLine(*(Vec3*)tv[n], *(Vec3*)tv[m], 0xff0000ff, 0);
+				addCacheLine(cache, *(Vec3*)tv[n], *(Vec3*)tv[m], 0xff0000ff);
 			}
 		}
 	}
@@ -592,6 +1175,7 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 
 		const Agent& agent = iter.value();
 		if (agent.agent < 0) return nullptr;
+		syncCrowdJob();
 		return m_crowd->getAgent(agent.agent);
 	}
 
@@ -601,6 +1185,7 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		auto render_scene = static_cast<RenderScene*>(m_universe.getScene(crc32("renderer")));
 		if (!render_scene) return;
 		if (!m_crowd) return;
+		syncCrowdJob();
 
 		auto iter = m_agents.find(entity);
 		if (iter == m_agents.end()) return;
@@ -610,6 +1195,9 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 
 		const dtPolyRef* path = dt_agent->corridor.getPath();
 		const int npath = dt_agent->corridor.getPathCount();
+		// paths change every frame, so this cache is only a scratch buffer for
+		// the bulk submit
+		m_debug_path_cache.clear();
 		for (int j = 0; j < npath; ++j)
 		{
 			dtPolyRef ref = path[j];
@@ -617,8 +1205,9 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 			const dtPoly* poly = nullptr;
 			if (dtStatusFailed(m_navmesh->getTileAndPolyByRef(ref, &tile, &poly))) continue;
 
-			drawPoly(render_scene, *tile, *poly);
+			drawPoly(m_debug_path_cache, *tile, *poly);
 		}
+		submitDebugCache(render_scene, m_debug_path_cache);
 
 		Vec3 prev = *(Vec3*)dt_agent->npos;
 		for (int i = 0; i < dt_agent->ncorners; ++i)
@@ -652,28 +1241,34 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		if (!render_scene) return;
 		if (!m_debug_contours) return;
 
-		Vec3 orig = m_debug_tile_origin;
-		float cs = m_debug_contours->cs;
-		float ch = m_debug_contours->ch;
-		for (int i = 0; i < m_debug_contours->nconts; ++i)
+		if (!m_debug_contours_cache.is_valid)
 		{
-			const rcContour& c = m_debug_contours->conts[i];
+			m_debug_contours_cache.clear();
+			Vec3 orig = m_debug_tile_origin;
+			float cs = m_debug_contours->cs;
+			float ch = m_debug_contours->ch;
+			for (int i = 0; i < m_debug_contours->nconts; ++i)
+			{
+				const rcContour& c = m_debug_contours->conts[i];
 
-			if (c.nverts < 2) continue;
+				if (c.nverts < 2) continue;
 
-			Vec3 first =
-				orig + Vec3((float)c.verts[0] * cs, (float)c.verts[1] * ch, (float)c.verts[2] * cs);
-			Vec3 prev = first;
-			for (int j = 1; j < c.nverts; ++j)
-			{
-				const int* v = &c.verts[j * 4];
-				Vec3 cur = orig + Vec3((float)v[0] * cs, (float)v[1] * ch, (float)v[2] * cs);
-				render_scene->addDebugLine(prev, cur, i & 1 ? 0xffff00ff : 0xffff0000, 0);
-				prev = cur;
-			}
+				Vec3 first =
+					orig + Vec3((float)c.verts[0] * cs, (float)c.verts[1] * ch, (float)c.verts[2] * cs);
+				Vec3 prev = first;
+				for (int j = 1; j < c.nverts; ++j)
+				{
+					const int* v = &c.verts[j * 4];
+					Vec3 cur = orig + Vec3((float)v[0] * cs, (float)v[1] * ch, (float)v[2] * cs);
+					addCacheLine(m_debug_contours_cache, prev, cur, i & 1 ? 0xffff00ff : 0xffff0000);
+					prev = cur;
+				}
 
-			render_scene->addDebugLine(prev, first, i & 1 ? 0xffff00ff : 0xffff0000, 0);
+				addCacheLine(m_debug_contours_cache, prev, first, i & 1 ? 0xffff00ff : 0xffff0000);
+			}
+			m_debug_contours_cache.is_valid = true;
 		}
+		submitDebugCache(render_scene, m_debug_contours_cache);
 	}
 
 
@@ -716,21 +1311,194 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		}
 
 		file.close();
-		if (!m_crowd) initCrowd();
+		if (!m_crowd) initCrowd();
+	}
+
+
+	bool load(const char* path) override
+	{
+		clearNavmesh();
+
+		FS::ReadCallback cb;
+		cb.bind<NavigationSceneImpl, &NavigationSceneImpl::fileLoaded>(this);
+		FS::FileSystem& fs = m_system.m_engine.getFileSystem();
+		return fs.openAsync(fs.getDefaultDevice(), Path(path), FS::Mode::OPEN_AND_READ, cb) != FS::FileSystem::INVALID_ASYNC;
+	}
+
+	
+	StaticString<MAX_PATH_LENGTH> getTilePath(int x, int z) const
+	{
+		return StaticString<MAX_PATH_LENGTH>(m_tiled_path.data, "_", x, "_", z, ".nvt");
+	}
+
+
+	// writes the header and one file per tile; each tile carries its own
+	// coordinates so the shared async read callback can identify it
+	bool saveTiled(const char* path) override
+	{
+		if (!m_navmesh) return false;
+
+		m_tiled_path = path;
+		FS::OsFile file;
+		if (!file.open(path, FS::Mode::CREATE_AND_WRITE, m_allocator)) return false;
+
+		file.write(&m_aabb, sizeof(m_aabb));
+		file.write(&m_num_tiles_x, sizeof(m_num_tiles_x));
+		file.write(&m_num_tiles_z, sizeof(m_num_tiles_z));
+		auto params = m_navmesh->getParams();
+		file.write(params, sizeof(*params));
+		file.close();
+
+		for (int j = 0; j < m_num_tiles_z; ++j)
+		{
+			for (int i = 0; i < m_num_tiles_x; ++i)
+			{
+				const auto* tile = m_navmesh->getTileAt(i, j, 0);
+				if (!tile) continue;
+				FS::OsFile tile_file;
+				if (!tile_file.open(getTilePath(i, j), FS::Mode::CREATE_AND_WRITE, m_allocator)) return false;
+				tile_file.write(&i, sizeof(i));
+				tile_file.write(&j, sizeof(j));
+				tile_file.write(&tile->dataSize, sizeof(tile->dataSize));
+				tile_file.write(tile->data, tile->dataSize);
+				tile_file.close();
+			}
+		}
+		return true;
+	}
+
+
+	void tiledHeaderLoaded(FS::IFile& file, bool success)
+	{
+		if (!success) return;
+		if (!initNavmesh()) return;
+
+		file.read(&m_aabb, sizeof(m_aabb));
+		file.read(&m_num_tiles_x, sizeof(m_num_tiles_x));
+		file.read(&m_num_tiles_z, sizeof(m_num_tiles_z));
+		dtNavMeshParams params;
+		file.read(&params, sizeof(params));
+		file.close();
+		if (dtStatusFailed(m_navmesh->init(&params)))
+		{
+			g_log_error.log("Navigation") << "Could not init Detour navmesh";
+			return;
+		}
+
+		m_tile_states.clear();
+		m_tile_states.resize(m_num_tiles_x * m_num_tiles_z);
+		for (TileState& state : m_tile_states) state = TileState::UNLOADED;
+		m_is_streaming = true;
+		if (!m_crowd) initCrowd();
+	}
+
+
+	void tileLoaded(FS::IFile& file, bool success)
+	{
+		if (!success)
+		{
+			g_log_error.log("Navigation") << "Could not read navmesh tile";
+			return;
+		}
+
+		int x, z, data_size;
+		file.read(&x, sizeof(x));
+		file.read(&z, sizeof(z));
+		file.read(&data_size, sizeof(data_size));
+		u8* data = (u8*)dtAlloc(data_size, DT_ALLOC_PERM);
+		file.read(data, data_size);
+		file.close();
+
+		// streaming can have been torn down or the tile evicted from the
+		// wanted set while the read was in flight
+		int idx = x + z * m_num_tiles_x;
+		if (!m_is_streaming || !m_navmesh || m_tile_states[idx] != TileState::LOADING)
+		{
+			dtFree(data);
+			return;
+		}
+
+		syncCrowdJob();
+		if (dtStatusFailed(m_navmesh->addTile(data, data_size, DT_TILE_FREE_DATA, 0, nullptr)))
+		{
+			g_log_error.log("Navigation") << "Could not add Detour tile";
+			dtFree(data);
+			m_tile_states[idx] = TileState::UNLOADED;
+			return;
+		}
+		m_tile_states[idx] = TileState::LOADED;
+		++m_navmesh_generation;
 	}
 
 
-	bool load(const char* path) override
+	bool loadTiled(const char* path) override
 	{
 		clearNavmesh();
 
+		m_tiled_path = path;
 		FS::ReadCallback cb;
-		cb.bind<NavigationSceneImpl, &NavigationSceneImpl::fileLoaded>(this);
+		cb.bind<NavigationSceneImpl, &NavigationSceneImpl::tiledHeaderLoaded>(this);
 		FS::FileSystem& fs = m_system.m_engine.getFileSystem();
 		return fs.openAsync(fs.getDefaultDevice(), Path(path), FS::Mode::OPEN_AND_READ, cb) != FS::FileSystem::INVALID_ASYNC;
 	}
 
-	
+
+	void setStreamingRadius(float radius) override { m_streaming_radius = radius; }
+	float getStreamingRadius() const override { return m_streaming_radius; }
+
+
+	// keeps navmesh tiles within the streaming radius of the "main" camera
+	// resident and evicts the rest; runs before the crowd job is scheduled,
+	// so the navmesh is not mutated while a worker reads it
+	void updateTileStreaming()
+	{
+		if (!m_is_streaming || !m_navmesh) return;
+		auto* render_scene = static_cast<RenderScene*>(m_universe.getScene(crc32("renderer")));
+		if (!render_scene) return;
+		ComponentHandle camera = render_scene->getCameraInSlot("main");
+		if (!isValid(camera)) return;
+
+		PROFILE_FUNCTION();
+		Vec3 cam_pos = m_universe.getPosition(render_scene->getCameraEntity(camera));
+		float tile_size = CELLS_PER_TILE_SIDE * CELL_SIZE;
+		float radius_squared = m_streaming_radius * m_streaming_radius;
+		FS::FileSystem& fs = m_system.m_engine.getFileSystem();
+		int resident = 0;
+		for (int j = 0; j < m_num_tiles_z; ++j)
+		{
+			for (int i = 0; i < m_num_tiles_x; ++i)
+			{
+				float min_x = m_aabb.min.x + i * tile_size;
+				float min_z = m_aabb.min.z + j * tile_size;
+				float dx = cam_pos.x - Math::clamp(cam_pos.x, min_x, min_x + tile_size);
+				float dz = cam_pos.z - Math::clamp(cam_pos.z, min_z, min_z + tile_size);
+				bool is_wanted = dx * dx + dz * dz < radius_squared;
+
+				TileState& state = m_tile_states[i + j * m_num_tiles_x];
+				if (is_wanted && state != TileState::UNLOADED) ++resident;
+				if (is_wanted && state == TileState::UNLOADED)
+				{
+					FS::ReadCallback cb;
+					cb.bind<NavigationSceneImpl, &NavigationSceneImpl::tileLoaded>(this);
+					if (fs.openAsync(fs.getDefaultDevice(), Path(getTilePath(i, j)), FS::Mode::OPEN_AND_READ, cb) !=
+						FS::FileSystem::INVALID_ASYNC)
+					{
+						state = TileState::LOADING;
+						++resident;
+					}
+				}
+				else if (!is_wanted && state == TileState::LOADED)
+				{
+					m_navmesh->removeTile(m_navmesh->getTileRefAt(i, j, 0), nullptr, nullptr);
+					state = TileState::UNLOADED;
+					++m_navmesh_generation;
+				}
+			}
+		}
+		PROFILE_INT("resident tiles", resident);
+	}
+
+
 	bool save(const char* path) override
 	{
 		if (!m_navmesh) return false;
@@ -764,27 +1532,32 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		if (!render_scene) return;
 		if (!m_debug_heightfield) return;
 
-		Vec3 orig = m_debug_tile_origin;
-		int width = m_debug_heightfield->width;
-		float cell_height = 0.1f;
-		int rendered_cubes = 0;
-		for(int z = 0; z < m_debug_heightfield->height; ++z)
+		if (!m_debug_heightfield_cache.is_valid)
 		{
-			for(int x = 0; x < width; ++x)
+			m_debug_heightfield_cache.clear();
+			Vec3 orig = m_debug_tile_origin;
+			int width = m_debug_heightfield->width;
+			float cell_height = 0.1f;
+			for (int z = 0; z < m_debug_heightfield->height; ++z)
 			{
-				float fx = orig.x + x * CELL_SIZE;
-				float fz = orig.z + z * CELL_SIZE;
-				const rcSpan* span = m_debug_heightfield->spans[x + z * width];
-				while(span)
+				for (int x = 0; x < width; ++x)
 				{
-					Vec3 mins(fx, orig.y + span->smin * cell_height, fz);
-					Vec3 maxs(fx + CELL_SIZE, orig.y + span->smax * cell_height, fz + CELL_SIZE);
-					render_scene->addDebugCubeSolid(mins, maxs, 0xffff00ff, 0);
-					render_scene->addDebugCube(mins, maxs, 0xff00aaff, 0);
-					span = span->next;
+					float fx = orig.x + x * CELL_SIZE;
+					float fz = orig.z + z * CELL_SIZE;
+					const rcSpan* span = m_debug_heightfield->spans[x + z * width];
+					while (span)
+					{
+						Vec3 mins(fx, orig.y + span->smin * cell_height, fz);
+						Vec3 maxs(fx + CELL_SIZE, orig.y + span->smax * cell_height, fz + CELL_SIZE);
+						addCacheCubeSolid(m_debug_heightfield_cache, mins, maxs, 0xffff00ff);
+						addCacheCube(m_debug_heightfield_cache, mins, maxs, 0xff00aaff);
+						span = span->next;
+					}
 				}
 			}
+			m_debug_heightfield_cache.is_valid = true;
 		}
+		submitDebugCache(render_scene, m_debug_heightfield_cache);
 	}
 
 
@@ -796,38 +1569,44 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		if (!render_scene) return;
 		if (!m_debug_compact_heightfield) return;
 
-		auto& chf = *m_debug_compact_heightfield;
-		const float cs = chf.cs;
-		const float ch = chf.ch;
+		if (!m_debug_compact_cache.is_valid)
+		{
+			m_debug_compact_cache.clear();
+			auto& chf = *m_debug_compact_heightfield;
+			const float cs = chf.cs;
+			const float ch = chf.ch;
 
-		Vec3 orig = m_debug_tile_origin;
+			Vec3 orig = m_debug_tile_origin;
 
-		int rendered_cubes = 0;
-		for (int y = 0; y < chf.height; ++y)
-		{
-			for (int x = 0; x < chf.width; ++x)
+			int rendered_cubes = 0;
+			for (int y = 0; y < chf.height && rendered_cubes <= MAX_CUBES; ++y)
 			{
-				float vx = orig.x + (float)x * cs;
-				float vz = orig.z + (float)y * cs;
+				for (int x = 0; x < chf.width && rendered_cubes <= MAX_CUBES; ++x)
+				{
+					float vx = orig.x + (float)x * cs;
+					float vz = orig.z + (float)y * cs;
 
-				const rcCompactCell& c = chf.cells[x + y * chf.width];
+					const rcCompactCell& c = chf.cells[x + y * chf.width];
 
-				for (u32 i = c.index, ni = c.index + c.count; i < ni; ++i)
-				{
-					float vy = orig.y + float(chf.spans[i].y) * ch;
-					render_scene->addDebugTriangle(
-						Vec3(vx, vy, vz), Vec3(vx + cs, vy, vz + cs), Vec3(vx + cs, vy, vz), 0xffff00FF, 0);
-					render_scene->addDebugTriangle(
-						Vec3(vx, vy, vz), Vec3(vx, vy, vz + cs), Vec3(vx + cs, vy, vz + cs), 0xffff00FF, 0);
-					++rendered_cubes;
-					if (rendered_cubes > MAX_CUBES) return;
+					for (u32 i = c.index, ni = c.index + c.count; i < ni; ++i)
+					{
+						float vy = orig.y + float(chf.spans[i].y) * ch;
+						addCacheTriangle(m_debug_compact_cache,
+							Vec3(vx, vy, vz), Vec3(vx + cs, vy, vz + cs), Vec3(vx + cs, vy, vz), 0xffff00FF);
+						addCacheTriangle(m_debug_compact_cache,
+							Vec3(vx, vy, vz), Vec3(vx, vy, vz + cs), Vec3(vx + cs, vy, vz + cs), 0xffff00FF);
+						++rendered_cubes;
+						if (rendered_cubes > MAX_CUBES) break;
+					}
 				}
 			}
+			m_debug_compact_cache.is_valid = true;
 		}
+		submitDebugCache(render_scene, m_debug_compact_cache);
 	}
 
 
-	static void drawPolyBoundaries(RenderScene* render_scene,
+	static void drawPolyBoundaries(DebugDrawCache& cache,
 		const dtMeshTile& tile,
 		const unsigned int col,
 		bool inner)
@@ -893,8 +1672,7 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 						if (((t[3] >> (n * 2)) & 0x3) == 0) continue; // Skip inner detail edges.
 						if (distancePtLine2d(tv[n], v0, v1) < thr && distancePtLine2d(tv[m], v0, v1) < thr)
 						{
-							render_scene->addDebugLine(
-								*(Vec3*)tv[n] + Vec3(0, 0.5f, 0), *(Vec3*)tv[m] + Vec3(0, 0.5f, 0), c, 0);
+							addCacheLine(cache, *(Vec3*)tv[n] + Vec3(0, 0.5f, 0), *(Vec3*)tv[m] + Vec3(0, 0.5f, 0), c);
 						}
 					}
 				}
@@ -903,7 +1681,7 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	}
 
 
-	static void drawTilePortal(RenderScene* render_scene, const dtMeshTile& tile)
+	static void drawTilePortal(DebugDrawCache& cache, const dtMeshTile& tile)
 	{
 		const float padx = 0.04f;
 		const float pady = tile.header->walkableClimb;
@@ -930,10 +1708,10 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 
 						const float x = va[0] + ((side == 0) ? -padx : padx);
 
-						render_scene->addDebugLine(Vec3(x, va[1] - pady, va[2]), Vec3(x, va[1] + pady, va[2]), col, 0);
-						render_scene->addDebugLine(Vec3(x, va[1] + pady, va[2]), Vec3(x, vb[1] + pady, vb[2]), col, 0);
-						render_scene->addDebugLine(Vec3(x, vb[1] + pady, vb[2]), Vec3(x, vb[1] - pady, vb[2]), col, 0);
-						render_scene->addDebugLine(Vec3(x, vb[1] - pady, vb[2]), Vec3(x, va[1] - pady, va[2]), col, 0);
+						addCacheLine(cache, Vec3(x, va[1] - pady, va[2]), Vec3(x, va[1] + pady, va[2]), col);
+						addCacheLine(cache, Vec3(x, va[1] + pady, va[2]), Vec3(x, vb[1] + pady, vb[2]), col);
+						addCacheLine(cache, Vec3(x, vb[1] + pady, vb[2]), Vec3(x, vb[1] - pady, vb[2]), col);
+						addCacheLine(cache, Vec3(x, vb[1] - pady, vb[2]), Vec3(x, va[1] - pady, va[2]), col);
 
 					}
 					else if (side == 2 || side == 6)
@@ -942,10 +1720,10 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 
 						const float z = va[2] + ((side == 2) ? -padx : padx);
 
-						render_scene->addDebugLine(Vec3(va[0], va[1] - pady, z), Vec3(va[0], va[1] + pady, z), col, 0);
-						render_scene->addDebugLine(Vec3(va[0], va[1] + pady, z), Vec3(vb[0], vb[1] + pady, z), col, 0);
-						render_scene->addDebugLine(Vec3(vb[0], vb[1] + pady, z), Vec3(vb[0], vb[1] - pady, z), col, 0);
-						render_scene->addDebugLine(Vec3(vb[0], vb[1] - pady, z), Vec3(va[0], va[1] - pady, z), col, 0);
+						addCacheLine(cache, Vec3(va[0], va[1] - pady, z), Vec3(va[0], va[1] + pady, z), col);
+						addCacheLine(cache, Vec3(va[0], va[1] + pady, z), Vec3(vb[0], vb[1] + pady, z), col);
+						addCacheLine(cache, Vec3(vb[0], vb[1] + pady, z), Vec3(vb[0], vb[1] - pady, z), col);
+						addCacheLine(cache, Vec3(vb[0], vb[1] - pady, z), Vec3(va[0], va[1] - pady, z), col);
 					}
 
 				}
@@ -961,24 +1739,38 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		int x = int((pos.x - m_aabb.min.x + (1 + m_config.borderSize) * m_config.cs) / (CELLS_PER_TILE_SIDE * CELL_SIZE));
 		int z = int((pos.z - m_aabb.min.z + (1 + m_config.borderSize) * m_config.cs) / (CELLS_PER_TILE_SIDE * CELL_SIZE));
 		const dtMeshTile* tile = m_navmesh->getTileAt(x, z, 0);
+		if (!tile || !tile->header) return;
 		auto render_scene = static_cast<RenderScene*>(m_universe.getScene(crc32("renderer")));
 		if (!render_scene) return;
 
-		dtPolyRef base = m_navmesh->getPolyRefBase(tile);
-
-		int tileNum = m_navmesh->decodePolyIdTile(base);
-
-		for (int i = 0; i < tile->header->polyCount; ++i)
+		bool key_matches = m_debug_navmesh_cache.is_valid && m_navmesh_cache_key.x == x &&
+						   m_navmesh_cache_key.z == z && m_navmesh_cache_key.inner == inner_boundaries &&
+						   m_navmesh_cache_key.outer == outer_boundaries && m_navmesh_cache_key.portals == portals &&
+						   m_navmesh_cache_key.generation == m_navmesh_generation;
+		if (!key_matches)
 		{
-			const dtPoly* p = &tile->polys[i];
-			if (p->getType() == DT_POLYTYPE_OFFMESH_CONNECTION) continue;
-			drawPoly(render_scene, *tile, *p);
-		}
+			m_debug_navmesh_cache.clear();
+			for (int i = 0; i < tile->header->polyCount; ++i)
+			{
+				const dtPoly* p = &tile->polys[i];
+				if (p->getType() == DT_POLYTYPE_OFFMESH_CONNECTION) continue;
+				drawPoly(m_debug_navmesh_cache, *tile, *p);
+			}
 
-		if(outer_boundaries) drawPolyBoundaries(render_scene, *tile, 0xffff0000, false);
-		if(inner_boundaries) drawPolyBoundaries(render_scene, *tile, 0xffff0000, true);
+			if (outer_boundaries) drawPolyBoundaries(m_debug_navmesh_cache, *tile, 0xffff0000, false);
+			if (inner_boundaries) drawPolyBoundaries(m_debug_navmesh_cache, *tile, 0xffff0000, true);
 
-		if(portals) drawTilePortal(render_scene, *tile);
+			if (portals) drawTilePortal(m_debug_navmesh_cache, *tile);
+
+			m_debug_navmesh_cache.is_valid = true;
+			m_navmesh_cache_key.x = x;
+			m_navmesh_cache_key.z = z;
+			m_navmesh_cache_key.inner = inner_boundaries;
+			m_navmesh_cache_key.outer = outer_boundaries;
+			m_navmesh_cache_key.portals = portals;
+			m_navmesh_cache_key.generation = m_navmesh_generation;
+		}
+		submitDebugCache(render_scene, m_debug_navmesh_cache);
 	}
 
 
@@ -986,6 +1778,7 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	{
 		if (m_crowd)
 		{
+			syncCrowdJob();
 			for (Agent& agent : m_agents)
 			{
 				m_crowd->removeAgent(agent.agent);
@@ -1017,6 +1810,7 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 			m_crowd = nullptr;
 			return false;
 		}
+		applyLinkCosts();
 		for (auto iter = m_agents.begin(), end = m_agents.end(); iter != end; ++iter)
 		{
 			Agent& agent = iter.value();
@@ -1035,6 +1829,8 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		Agent& agent = iter.value();
 		if (agent.agent < 0) return;
 
+		syncCrowdJob();
+		agent.is_long_range = false;
 		m_crowd->resetMoveTarget(agent.agent);
 	}
 
@@ -1050,11 +1846,319 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		Agent& agent = iter.value();
 		if (agent.agent < 0) return;
 
+		syncCrowdJob();
 		dtCrowdAgent* dt_agent = m_crowd->getEditableAgent(agent.agent);
 		if (dt_agent) dt_agent->paused = !active;
 	}
 
 
+	// async counterpart of navigate(): the request is only queued here and a
+	// bounded number of them is resolved per update, so a horde spawning 50
+	// agents at once costs the same frame time as spawning a few. dtCrowd is
+	// not thread-safe, which is why the pump is a per-frame budget on the main
+	// thread rather than a worker job
+	void navigateQueued(Entity entity, const Vec3& dest, float speed, float stop_distance) override
+	{
+		PathRequest& request = m_path_requests.emplace();
+		request.entity = entity;
+		request.dest = dest;
+		request.speed = speed;
+		request.stop_distance = stop_distance;
+	}
+
+
+	void processPathRequests()
+	{
+		static const int MAX_REQUESTS_PER_UPDATE = 8;
+		if (m_path_requests.empty()) return;
+		PROFILE_FUNCTION();
+		PROFILE_INT("queued", m_path_requests.size());
+		int count = Math::minimum(m_path_requests.size(), MAX_REQUESTS_PER_UPDATE);
+		for (int i = 0; i < count; ++i)
+		{
+			const PathRequest& request = m_path_requests[i];
+			navigate(request.entity, request.dest, request.speed, request.stop_distance);
+		}
+		int remaining = m_path_requests.size() - count;
+		for (int i = 0; i < remaining; ++i) m_path_requests[i] = m_path_requests[i + count];
+		m_path_requests.resize(remaining);
+	}
+
+
+	// slices of a batch run on worker jobs, each with its own dtNavMeshQuery
+	// since query objects keep per-search state; the queries only read the
+	// navmesh, so they can run concurrently. small batches stay on the main
+	// thread and reuse m_navquery
+	template <typename T>
+	void runQueryBatch(int count, const T& fn)
+	{
+		static const int MIN_PARALLEL = 16;
+		if (count < MIN_PARALLEL)
+		{
+			fn(m_navquery, 0, count);
+			return;
+		}
+		dtNavMesh* navmesh = m_navmesh;
+		MTJD::forEach(m_system.m_engine.getMTJDManager(), m_allocator, 0, count, MIN_PARALLEL,
+			[navmesh, &fn](int from, int to)
+			{
+				dtNavMeshQuery* query = dtAllocNavMeshQuery();
+				if (!query) return;
+				if (dtStatusFailed(query->init(navmesh, 2048)))
+				{
+					dtFreeNavMeshQuery(query);
+					return;
+				}
+				fn(query, from, to);
+				dtFreeNavMeshQuery(query);
+			});
+	}
+
+
+	void findNearestWalkablePoints(const Vec3* points, int count, const Vec3& extents, Vec3* out_points, bool* out_found) override
+	{
+		for (int i = 0; i < count; ++i) out_found[i] = false;
+		if (!m_navquery) return;
+		PROFILE_FUNCTION();
+
+		runQueryBatch(count, [points, &extents, out_points, out_found](dtNavMeshQuery* query, int from, int to)
+		{
+			dtQueryFilter filter;
+			for (int i = from; i < to; ++i)
+			{
+				dtPolyRef ref = 0;
+				dtStatus status = query->findNearestPoly(&points[i].x, &extents.x, &filter, &ref, &out_points[i].x);
+				out_found[i] = !dtStatusFailed(status) && ref != 0;
+			}
+		});
+	}
+
+
+	void findRandomPointsAroundCircle(const Vec3& center, float radius, int count, Vec3* out_points, bool* out_found) override
+	{
+		for (int i = 0; i < count; ++i) out_found[i] = false;
+		if (!m_navquery) return;
+		PROFILE_FUNCTION();
+
+		dtQueryFilter filter;
+		static const float ext[] = {1.0f, 20.0f, 1.0f};
+		dtPolyRef center_ref = 0;
+		m_navquery->findNearestPoly(&center.x, ext, &filter, &center_ref, nullptr);
+		if (center_ref == 0) return;
+
+		runQueryBatch(count, [&center, radius, center_ref, out_points, out_found](dtNavMeshQuery* query, int from, int to)
+		{
+			dtQueryFilter filter;
+			for (int i = from; i < to; ++i)
+			{
+				dtPolyRef ref = 0;
+				dtStatus status = query->findRandomPointAroundCircle(
+					center_ref, &center.x, radius, &filter, Math::randFloat, &ref, &out_points[i].x);
+				out_found[i] = !dtStatusFailed(status) && ref != 0;
+			}
+		});
+	}
+
+
+	void arePointsReachable(const Vec3& from, const Vec3* to, int count, bool* out_reachable) override
+	{
+		for (int i = 0; i < count; ++i) out_reachable[i] = false;
+		if (!m_navquery) return;
+		PROFILE_FUNCTION();
+
+		dtQueryFilter filter;
+		static const float ext[] = {1.0f, 20.0f, 1.0f};
+		dtPolyRef from_ref = 0;
+		m_navquery->findNearestPoly(&from.x, ext, &filter, &from_ref, nullptr);
+		if (from_ref == 0) return;
+
+		runQueryBatch(count, [&from, from_ref, to, out_reachable](dtNavMeshQuery* query, int range_from, int range_to)
+		{
+			static const int MAX_PATH = 256;
+			dtQueryFilter filter;
+			for (int i = range_from; i < range_to; ++i)
+			{
+				dtPolyRef to_ref = 0;
+				Vec3 nearest;
+				query->findNearestPoly(&to[i].x, ext, &filter, &to_ref, &nearest.x);
+				if (to_ref == 0) continue;
+
+				dtPolyRef path[MAX_PATH];
+				int path_count = 0;
+				dtStatus status = query->findPath(from_ref, to_ref, &from.x, &to[i].x, &filter, path, &path_count, MAX_PATH);
+				// a partial path means the target poly was not reached
+				out_reachable[i] = !dtStatusFailed(status) && path_count > 0 && path[path_count - 1] == to_ref;
+			}
+		});
+	}
+
+
+	void buildTileGraph()
+	{
+		PROFILE_FUNCTION();
+		int count = m_num_tiles_x * m_num_tiles_z;
+		m_tile_graph.resize(count);
+		// detour's even sides map to the four axis neighbors
+		static const int SIDES[] = {0, 2, 4, 6};
+		for (int z = 0; z < m_num_tiles_z; ++z)
+		{
+			for (int x = 0; x < m_num_tiles_x; ++x)
+			{
+				TileGraphNode& node = m_tile_graph[x + z * m_num_tiles_x];
+				for (int dir = 0; dir < 4; ++dir) node.connected[dir] = false;
+
+				const dtMeshTile* tile = m_navmesh->getTileAt(x, z, 0);
+				if (!tile || !tile->header) continue;
+
+				for (int dir = 0; dir < 4; ++dir)
+				{
+					unsigned short m = DT_EXT_LINK | (unsigned short)SIDES[dir];
+					Vec3 sum(0, 0, 0);
+					int edge_count = 0;
+					for (int i = 0; i < tile->header->polyCount; ++i)
+					{
+						const dtPoly* poly = &tile->polys[i];
+						const int nv = poly->vertCount;
+						for (int j = 0; j < nv; ++j)
+						{
+							if (poly->neis[j] != m) continue;
+							Vec3 va = *(Vec3*)&tile->verts[poly->verts[j] * 3];
+							Vec3 vb = *(Vec3*)&tile->verts[poly->verts[(j + 1) % nv] * 3];
+							sum += (va + vb) * 0.5f;
+							++edge_count;
+						}
+					}
+					if (edge_count > 0)
+					{
+						node.connected[dir] = true;
+						node.portal[dir] = sum * (1.0f / edge_count);
+					}
+				}
+			}
+		}
+		m_tile_graph_generation = m_navmesh_generation;
+	}
+
+
+	int getTileIndex(const Vec3& pos) const
+	{
+		float tile_size = CELLS_PER_TILE_SIDE * CELL_SIZE;
+		int x = Math::clamp(int((pos.x - m_aabb.min.x) / tile_size), 0, m_num_tiles_x - 1);
+		int z = Math::clamp(int((pos.z - m_aabb.min.z) / tile_size), 0, m_num_tiles_z - 1);
+		return x + z * m_num_tiles_x;
+	}
+
+
+	// A* over the tile graph; returns the portal midpoint a few tiles along
+	// the route, which becomes the next leg's target. false means the route
+	// is local (same tile) or tile-level unreachable - plain Detour handles
+	// both
+	bool findHierarchicalWaypoint(const Vec3& start, const Vec3& dest, Vec3* out_waypoint)
+	{
+		if (!m_navmesh) return false;
+		if (m_tile_graph_generation != m_navmesh_generation) buildTileGraph();
+
+		int start_tile = getTileIndex(start);
+		int dest_tile = getTileIndex(dest);
+		if (start_tile == dest_tile) return false;
+
+		PROFILE_FUNCTION();
+		static const int LOOKAHEAD_TILES = 3;
+		// neighbor order matches TileGraphNode: sides 0, 2, 4, 6
+		const int offsets[] = {1, m_num_tiles_x, -1, -m_num_tiles_x};
+		const int dx[] = {1, 0, -1, 0};
+
+		int count = m_tile_graph.size();
+		Array<float> costs(m_allocator);
+		Array<int> parents(m_allocator);
+		Array<u8> states(m_allocator); // 0 unvisited, 1 open, 2 closed
+		costs.resize(count);
+		parents.resize(count);
+		states.resize(count);
+		for (int i = 0; i < count; ++i) states[i] = 0;
+
+		float tile_size = CELLS_PER_TILE_SIDE * CELL_SIZE;
+		auto heuristic = [&](int tile) {
+			float ddx = float((tile % m_num_tiles_x) - (dest_tile % m_num_tiles_x));
+			float ddz = float((tile / m_num_tiles_x) - (dest_tile / m_num_tiles_x));
+			return sqrtf(ddx * ddx + ddz * ddz) * tile_size;
+		};
+
+		Array<int> open(m_allocator);
+		costs[start_tile] = 0;
+		parents[start_tile] = -1;
+		states[start_tile] = 1;
+		open.push(start_tile);
+		while (!open.empty())
+		{
+			int best = 0;
+			for (int i = 1; i < open.size(); ++i)
+			{
+				if (costs[open[i]] + heuristic(open[i]) < costs[open[best]] + heuristic(open[best])) best = i;
+			}
+			int tile = open[best];
+			open.eraseFast(best);
+			if (tile == dest_tile) break;
+			states[tile] = 2;
+
+			const TileGraphNode& node = m_tile_graph[tile];
+			int tile_x = tile % m_num_tiles_x;
+			for (int dir = 0; dir < 4; ++dir)
+			{
+				if (!node.connected[dir]) continue;
+				int nx = tile_x + dx[dir];
+				if (nx < 0 || nx >= m_num_tiles_x) continue;
+				int neighbor = tile + offsets[dir];
+				if (neighbor < 0 || neighbor >= count) continue;
+				if (states[neighbor] == 2) continue;
+
+				Vec3 from_portal = parents[tile] < 0 ? start : node.portal[dir];
+				float cost = costs[tile] + (node.portal[dir] - from_portal).length() + 0.1f * tile_size;
+				if (states[neighbor] == 1 && cost >= costs[neighbor]) continue;
+
+				costs[neighbor] = cost;
+				parents[neighbor] = tile;
+				if (states[neighbor] != 1)
+				{
+					states[neighbor] = 1;
+					open.push(neighbor);
+				}
+			}
+		}
+		if (states[dest_tile] == 0) return false;
+
+		// walk the route back to the start, then forward a few tiles
+		Array<int> route(m_allocator);
+		for (int tile = dest_tile; tile >= 0; tile = parents[tile]) route.push(tile);
+		int steps = Math::minimum(LOOKAHEAD_TILES, route.size() - 1);
+		int from = route[route.size() - steps];
+		int to = route[route.size() - steps - 1];
+		const TileGraphNode& node = m_tile_graph[from];
+		for (int dir = 0; dir < 4; ++dir)
+		{
+			if (node.connected[dir] && from + offsets[dir] == to)
+			{
+				*out_waypoint = node.portal[dir];
+				return true;
+			}
+		}
+		return false;
+	}
+
+
+	// a long-range agent finishing a leg continues toward its stored goal;
+	// onPathFinished only fires at the real destination
+	void finishLeg(Agent& agent)
+	{
+		if (agent.is_long_range)
+		{
+			navigate(agent.entity, agent.long_range_dest, agent.long_range_speed, agent.long_range_stop_distance);
+			if (!agent.is_finished) return;
+		}
+		onPathFinished(agent);
+	}
+
+
 	bool navigate(Entity entity, const Vec3& dest, float speed, float stop_distance) override
 	{
 		if (!m_navquery) return false;
@@ -1064,22 +2168,48 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		if (iter == m_agents.end()) return false;
 		Agent& agent = iter.value();
 		if (agent.agent < 0) return false;
+		syncCrowdJob();
+
+		// cross-map routes are planned on the tile graph and followed one leg
+		// at a time, so Detour never expands the full polygon graph
+		Vec3 target = dest;
+		float leg_stop_distance = stop_distance;
+		agent.is_long_range = false;
+		Vec3 start_pos = m_universe.getPosition(entity);
+		Vec3 to_dest = dest - start_pos;
+		to_dest.y = 0;
+		float long_range_threshold = 2 * CELLS_PER_TILE_SIDE * CELL_SIZE;
+		if (to_dest.length() > long_range_threshold)
+		{
+			Vec3 waypoint;
+			if (findHierarchicalWaypoint(start_pos, dest, &waypoint))
+			{
+				agent.is_long_range = true;
+				agent.long_range_dest = dest;
+				agent.long_range_speed = speed;
+				agent.long_range_stop_distance = stop_distance;
+				target = waypoint;
+				leg_stop_distance = 2.0f;
+			}
+		}
+
 		dtPolyRef end_poly_ref;
 		dtQueryFilter filter;
 		static const float ext[] = { 1.0f, 20.0f, 1.0f };
-		m_navquery->findNearestPoly(&dest.x, ext, &filter, &end_poly_ref, 0);
+		m_navquery->findNearestPoly(&target.x, ext, &filter, &end_poly_ref, 0);
 		dtCrowdAgentParams params = m_crowd->getAgent(agent.agent)->params;
 		params.maxSpeed = speed;
 		m_crowd->updateAgentParameters(agent.agent, &params);
-		if (m_crowd->requestMoveTarget(agent.agent, end_poly_ref, &dest.x))
+		if (m_crowd->requestMoveTarget(agent.agent, end_poly_ref, &target.x))
 		{
-			agent.stop_distance = stop_distance;
+			agent.stop_distance = leg_stop_distance;
 			agent.is_finished = false;
 		}
 		else
 		{
 			g_log_warning.log("Navigation") << "requestMoveTarget failed";
 			agent.is_finished = true;
+			agent.is_long_range = false;
 		}
 		return !agent.is_finished;
 	}
@@ -1136,7 +2266,35 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		if (!m_navmesh) return false;
 		m_navmesh->removeTile(m_navmesh->getTileRefAt(x, z, 0), 0, 0);
 
+		unsigned char* nav_data = nullptr;
+		int nav_data_size = 0;
+		if (!buildTileNavData(x, z, keep_data, &nav_data, &nav_data_size)) return false;
+		if (dtStatusFailed(m_navmesh->addTile(nav_data, nav_data_size, DT_TILE_FREE_DATA, 0, nullptr)))
+		{
+			dtFree(nav_data);
+			g_log_error.log("Navigation") << "Could not add Detour tile.";
+			return false;
+		}
+		++m_navmesh_generation;
+		return true;
+	}
+
+
+	// builds one tile's Detour blob without touching the navmesh or, unless
+	// keep_data is set, any member state; tiles are independent, so this runs
+	// concurrently from workers during a full bake. keep_data stores the
+	// intermediate Recast data for debug drawing and must stay single-threaded
+	bool buildTileNavData(int x, int z, bool keep_data, unsigned char** out_nav_data, int* out_nav_data_size)
+	{
+		PROFILE_FUNCTION();
 		rcContext ctx;
+		rcConfig cfg = m_config;
+		if (keep_data)
+		{
+			m_debug_heightfield_cache.clear();
+			m_debug_compact_cache.clear();
+			m_debug_contours_cache.clear();
+		}
 
 		Vec3 bmin(m_aabb.min.x + x * CELLS_PER_TILE_SIDE * CELL_SIZE - (1 + m_config.borderSize) * m_config.cs,
 			m_aabb.min.y,
@@ -1145,44 +2303,44 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 			m_aabb.max.y,
 			bmin.z + CELLS_PER_TILE_SIDE * CELL_SIZE + (1 + m_config.borderSize) * m_config.cs);
 		if (keep_data) m_debug_tile_origin = bmin;
-		rcVcopy(m_config.bmin, &bmin.x);
-		rcVcopy(m_config.bmax, &bmax.x);
+		rcVcopy(cfg.bmin, &bmin.x);
+		rcVcopy(cfg.bmax, &bmax.x);
 		rcHeightfield* solid = rcAllocHeightfield();
-		m_debug_heightfield = keep_data ? solid : nullptr;
+		if (keep_data) m_debug_heightfield = solid;
 		if (!solid)
 		{
 			g_log_error.log("Navigation") << "Could not generate navmesh: Out of memory 'solid'.";
 			return false;
 		}
 		if (!rcCreateHeightfield(
-				&ctx, *solid, m_config.width, m_config.height, m_config.bmin, m_config.bmax, m_config.cs, m_config.ch))
+				&ctx, *solid, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
 		{
 			g_log_error.log("Navigation") << "Could not generate navmesh: Could not create solid heightfield.";
 			return false;
 		}
-		rasterizeGeometry(AABB(bmin, bmax), ctx, m_config, *solid);
+		rasterizeGeometry(x, z, AABB(bmin, bmax), ctx, cfg, *solid);
 
-		rcFilterLowHangingWalkableObstacles(&ctx, m_config.walkableClimb, *solid);
-		rcFilterLedgeSpans(&ctx, m_config.walkableHeight, m_config.walkableClimb, *solid);
-		rcFilterWalkableLowHeightSpans(&ctx, m_config.walkableHeight, *solid);
+		rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *solid);
+		rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid);
+		rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *solid);
 
 		rcCompactHeightfield* chf = rcAllocCompactHeightfield();
-		m_debug_compact_heightfield = keep_data ? chf : nullptr;
+		if (keep_data) m_debug_compact_heightfield = chf;
 		if (!chf)
 		{
 			g_log_error.log("Navigation") << "Could not generate navmesh: Out of memory 'chf'.";
 			return false;
 		}
 
-		if (!rcBuildCompactHeightfield(&ctx, m_config.walkableHeight, m_config.walkableClimb, *solid, *chf))
+		if (!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid, *chf))
 		{
 			g_log_error.log("Navigation") << "Could not generate navmesh: Could not build compact data.";
 			return false;
 		}
 
-		if (!m_debug_heightfield) rcFreeHeightField(solid);
+		if (!keep_data) rcFreeHeightField(solid);
 
-		if (!rcErodeWalkableArea(&ctx, m_config.walkableRadius, *chf))
+		if (!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf))
 		{
 			g_log_error.log("Navigation") << "Could not generate navmesh: Could not erode.";
 			return false;
@@ -1194,94 +2352,129 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 			return false;
 		}
 
-		if (!rcBuildRegions(&ctx, *chf, m_config.borderSize, m_config.minRegionArea, m_config.mergeRegionArea))
+		if (!rcBuildRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
 		{
 			g_log_error.log("Navigation") << "Could not generate navmesh: Could not build regions.";
 			return false;
 		}
 
 		rcContourSet* cset = rcAllocContourSet();
-		m_debug_contours = keep_data ? cset : nullptr;
+		if (keep_data) m_debug_contours = cset;
 		if (!cset)
 		{
 			ctx.log(RC_LOG_ERROR, "Could not generate navmesh: Out of memory 'cset'.");
 			return false;
 		}
-		if (!rcBuildContours(&ctx, *chf, m_config.maxSimplificationError, m_config.maxEdgeLen, *cset))
+		if (!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset))
 		{
 			g_log_error.log("Navigation") << "Could not generate navmesh: Could not create contours.";
 			return false;
 		}
 
-		m_polymesh = rcAllocPolyMesh();
-		if (!m_polymesh)
+		rcPolyMesh* polymesh = rcAllocPolyMesh();
+		if (keep_data) m_polymesh = polymesh;
+		if (!polymesh)
 		{
-			g_log_error.log("Navigation") << "Could not generate navmesh: Out of memory 'm_polymesh'.";
+			g_log_error.log("Navigation") << "Could not generate navmesh: Out of memory 'polymesh'.";
 			return false;
 		}
-		if (!rcBuildPolyMesh(&ctx, *cset, m_config.maxVertsPerPoly, *m_polymesh))
+		if (!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *polymesh))
 		{
 			g_log_error.log("Navigation") << "Could not generate navmesh: Could not triangulate contours.";
 			return false;
 		}
 
-		m_detail_mesh = rcAllocPolyMeshDetail();
-		if (!m_detail_mesh)
+		rcPolyMeshDetail* detail_mesh = rcAllocPolyMeshDetail();
+		if (keep_data) m_detail_mesh = detail_mesh;
+		if (!detail_mesh)
 		{
 			g_log_error.log("Navigation") << "Could not generate navmesh: Out of memory 'pmdtl'.";
 			return false;
 		}
 
 		if (!rcBuildPolyMeshDetail(
-				&ctx, *m_polymesh, *chf, m_config.detailSampleDist, m_config.detailSampleMaxError, *m_detail_mesh))
+				&ctx, *polymesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *detail_mesh))
 		{
 			g_log_error.log("Navigation") << "Could not generate navmesh: Could not build detail mesh.";
 			return false;
 		}
 
-		if (!m_debug_compact_heightfield) rcFreeCompactHeightfield(chf);
-		if (!m_debug_contours) rcFreeContourSet(cset);
+		if (!keep_data) rcFreeCompactHeightfield(chf);
+		if (!keep_data) rcFreeContourSet(cset);
 
-		unsigned char* nav_data = 0;
-		int nav_data_size = 0;
+		for (int i = 0; i < polymesh->npolys; ++i)
+		{
+			polymesh->flags[i] = polymesh->areas[i] == RC_WALKABLE_AREA ? 1 : 0;
+		}
 
-		for (int i = 0; i < m_polymesh->npolys; ++i)
+		// every authored link is handed to the builder; it bakes only those
+		// whose start point falls inside this tile
+		Array<float> link_verts(m_allocator);
+		Array<float> link_radii(m_allocator);
+		Array<unsigned short> link_flags(m_allocator);
+		Array<u8> link_areas(m_allocator);
+		Array<u8> link_dirs(m_allocator);
+		Array<unsigned int> link_ids(m_allocator);
+		for (const NavmeshLink& link : m_links)
 		{
-			m_polymesh->flags[i] = m_polymesh->areas[i] == RC_WALKABLE_AREA ? 1 : 0;
+			Vec3 start = m_universe.getPosition(link.entity);
+			Vec3 end = start + m_universe.getRotation(link.entity).rotate(link.end_offset);
+			link_verts.push(start.x);
+			link_verts.push(start.y);
+			link_verts.push(start.z);
+			link_verts.push(end.x);
+			link_verts.push(end.y);
+			link_verts.push(end.z);
+			link_radii.push(link.radius);
+			link_flags.push(1);
+			link_areas.push(link.area);
+			link_dirs.push(link.is_bidirectional ? u8(DT_OFFMESH_CON_BIDIR) : 0);
+			link_ids.push(link.entity.index);
 		}
 
 		dtNavMeshCreateParams params = {};
-		params.verts = m_polymesh->verts;
-		params.vertCount = m_polymesh->nverts;
-		params.polys = m_polymesh->polys;
-		params.polyAreas = m_polymesh->areas;
-		params.polyFlags = m_polymesh->flags;
-		params.polyCount = m_polymesh->npolys;
-		params.nvp = m_polymesh->nvp;
-		params.detailMeshes = m_detail_mesh->meshes;
-		params.detailVerts = m_detail_mesh->verts;
-		params.detailVertsCount = m_detail_mesh->nverts;
-		params.detailTris = m_detail_mesh->tris;
-		params.detailTriCount = m_detail_mesh->ntris;
-		params.walkableHeight = m_config.walkableHeight * m_config.ch;
-		params.walkableRadius = m_config.walkableRadius * m_config.cs;
-		params.walkableClimb = m_config.walkableClimb * m_config.ch;
+		params.verts = polymesh->verts;
+		params.vertCount = polymesh->nverts;
+		params.polys = polymesh->polys;
+		params.polyAreas = polymesh->areas;
+		params.polyFlags = polymesh->flags;
+		params.polyCount = polymesh->npolys;
+		params.nvp = polymesh->nvp;
+		params.detailMeshes = detail_mesh->meshes;
+		params.detailVerts = detail_mesh->verts;
+		params.detailVertsCount = detail_mesh->nverts;
+		params.detailTris = detail_mesh->tris;
+		params.detailTriCount = detail_mesh->ntris;
+		params.walkableHeight = cfg.walkableHeight * cfg.ch;
+		params.walkableRadius = cfg.walkableRadius * cfg.cs;
+		params.walkableClimb = cfg.walkableClimb * cfg.ch;
 		params.tileX = x;
 		params.tileY = z;
-		rcVcopy(params.bmin, m_polymesh->bmin);
-		rcVcopy(params.bmax, m_polymesh->bmax);
-		params.cs = m_config.cs;
-		params.ch = m_config.ch;
+		rcVcopy(params.bmin, polymesh->bmin);
+		rcVcopy(params.bmax, polymesh->bmax);
+		params.cs = cfg.cs;
+		params.ch = cfg.ch;
 		params.buildBvTree = false;
+		if (!link_verts.empty())
+		{
+			params.offMeshConVerts = &link_verts[0];
+			params.offMeshConRad = &link_radii[0];
+			params.offMeshConFlags = &link_flags[0];
+			params.offMeshConAreas = &link_areas[0];
+			params.offMeshConDir = &link_dirs[0];
+			params.offMeshConUserID = &link_ids[0];
+			params.offMeshConCount = link_radii.size();
+		}
 
-		if (!dtCreateNavMeshData(&params, &nav_data, &nav_data_size))
+		bool created = dtCreateNavMeshData(&params, out_nav_data, out_nav_data_size);
+		if (!keep_data)
 		{
-			g_log_error.log("Navigation") << "Could not build Detour navmesh.";
-			return false;
+			rcFreePolyMeshDetail(detail_mesh);
+			rcFreePolyMesh(polymesh);
 		}
-		if (dtStatusFailed(m_navmesh->addTile(nav_data, nav_data_size, DT_TILE_FREE_DATA, 0, nullptr)))
+		if (!created)
 		{
-			g_log_error.log("Navigation") << "Could not add Detour tile.";
+			g_log_error.log("Navigation") << "Could not build Detour navmesh.";
 			return false;
 		}
 		return true;
@@ -1370,23 +2563,65 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 			return false;
 		}
 
-		for (int j = 0; j < m_num_tiles_z; ++j)
+		// model geometry is transformed and bucketed once up front; tiles
+		// sharing a model then rasterize from the cache instead of each
+		// re-transforming the model's vertices
+		buildBakeGeometryCache();
+
+		// tiles are independent, so the whole bake is one job per tile; the
+		// universe does not change while this blocks, which makes the scene
+		// geometry a read-only snapshot for the workers
+		struct TileResult
 		{
-			for (int i = 0; i < m_num_tiles_x; ++i)
+			unsigned char* data;
+			int size;
+			bool success;
+		};
+
+		int tile_count = m_num_tiles_x * m_num_tiles_z;
+		Array<TileResult> results(m_allocator);
+		results.resize(tile_count);
+		TileResult* results_ptr = &results[0];
+		NavigationSceneImpl* scene = this;
+		int num_tiles_x = m_num_tiles_x;
+		MTJD::forEach(m_system.m_engine.getMTJDManager(), m_allocator, 0, tile_count, 1,
+			[scene, results_ptr, num_tiles_x](int from, int to)
 			{
-				if (!generateTile(i, j, false))
+				for (int i = from; i < to; ++i)
 				{
-					return false;
+					TileResult& result = results_ptr[i];
+					result.data = nullptr;
+					result.size = 0;
+					result.success =
+						scene->buildTileNavData(i % num_tiles_x, i / num_tiles_x, false, &result.data, &result.size);
 				}
+			});
+
+		bool success = true;
+		for (TileResult& result : results)
+		{
+			if (!result.success)
+			{
+				success = false;
+				continue;
+			}
+			if (dtStatusFailed(m_navmesh->addTile(result.data, result.size, DT_TILE_FREE_DATA, 0, nullptr)))
+			{
+				g_log_error.log("Navigation") << "Could not add Detour tile.";
+				dtFree(result.data);
+				success = false;
 			}
 		}
-		return true;
+		m_bake_geometry.clear();
+		++m_navmesh_generation;
+		return success;
 	}
 
 
 	void addCrowdAgent(Agent& agent)
 	{
 		ASSERT(m_crowd);
+		syncCrowdJob();
 
 		Vec3 pos = m_universe.getPosition(agent.entity);
 		dtCrowdAgentParams params = {};
@@ -1396,7 +2631,7 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 		params.maxSpeed = 10.0f;
 		params.collisionQueryRange = params.radius * 12.0f;
 		params.pathOptimizationRange = params.radius * 30.0f;
-		params.updateFlags = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_SEPARATION | DT_CROWD_OBSTACLE_AVOIDANCE | DT_CROWD_OPTIMIZE_TOPO | DT_CROWD_OPTIMIZE_VIS;
+		params.updateFlags = FULL_AGENT_UPDATE_FLAGS;
 		agent.agent = m_crowd->addAgent(&pos.x, &params);
 		if (agent.agent < 0)
 		{
@@ -1422,6 +2657,16 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 			m_universe.addComponent(entity, type, this, cmp);
 			return cmp;
 		}
+		if (type == NAVMESH_LINK_TYPE)
+		{
+			NavmeshLink link;
+			link.entity = entity;
+			link.area = registerLinkCostArea(link.cost);
+			m_links.insert(entity, link);
+			ComponentHandle cmp = {entity.index};
+			m_universe.addComponent(entity, type, this, cmp);
+			return cmp;
+		}
 		return INVALID_COMPONENT;
 	}
 
@@ -1433,10 +2678,20 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 			Entity entity = { component.index };
 			auto iter = m_agents.find(entity);
 			const Agent& agent = iter.value();
-			if (m_crowd && agent.agent >= 0) m_crowd->removeAgent(agent.agent);
+			if (m_crowd && agent.agent >= 0)
+			{
+				syncCrowdJob();
+				m_crowd->removeAgent(agent.agent);
+			}
 			m_agents.erase(iter);
 			m_universe.destroyComponent(entity, type, this, component);
 		}
+		else if (type == NAVMESH_LINK_TYPE)
+		{
+			Entity entity = {component.index};
+			m_links.erase(m_links.find(entity));
+			m_universe.destroyComponent(entity, type, this, component);
+		}
 		else
 		{
 			ASSERT(false);
@@ -1486,6 +2741,31 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	}
 
 
+	void serializeLink(ISerializer& serializer, ComponentHandle cmp)
+	{
+		NavmeshLink& link = m_links[{cmp.index}];
+		serializer.write("end_offset", link.end_offset);
+		serializer.write("radius", link.radius);
+		serializer.write("cost", link.cost);
+		serializer.write("bidirectional", link.is_bidirectional);
+	}
+
+
+	void deserializeLink(IDeserializer& serializer, Entity entity, int scene_version)
+	{
+		NavmeshLink link;
+		link.entity = entity;
+		serializer.read(&link.end_offset);
+		serializer.read(&link.radius);
+		serializer.read(&link.cost);
+		serializer.read(&link.is_bidirectional);
+		link.area = registerLinkCostArea(link.cost);
+		m_links.insert(entity, link);
+		ComponentHandle cmp = {entity.index};
+		m_universe.addComponent(entity, NAVMESH_LINK_TYPE, this, cmp);
+	}
+
+
 	void serialize(OutputBlob& serializer) override
 	{
 		int count = m_agents.size();
@@ -1497,6 +2777,16 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 			serializer.write(iter.value().height);
 			serializer.write(iter.value().flags);
 		}
+		count = m_links.size();
+		serializer.write(count);
+		for (const NavmeshLink& link : m_links)
+		{
+			serializer.write(link.entity);
+			serializer.write(link.end_offset);
+			serializer.write(link.radius);
+			serializer.write(link.cost);
+			serializer.write(link.is_bidirectional);
+		}
 	}
 
 
@@ -1518,6 +2808,84 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 			ComponentHandle cmp = {agent.entity.index};
 			m_universe.addComponent(agent.entity, NAVMESH_AGENT_TYPE, this, cmp);
 		}
+		serializer.read(count);
+		m_links.rehash(count == 0 ? 1 : count);
+		for (int i = 0; i < count; ++i)
+		{
+			NavmeshLink link;
+			serializer.read(link.entity);
+			serializer.read(link.end_offset);
+			serializer.read(link.radius);
+			serializer.read(link.cost);
+			serializer.read(link.is_bidirectional);
+			link.area = registerLinkCostArea(link.cost);
+			m_links.insert(link.entity, link);
+			ComponentHandle cmp = {link.entity.index};
+			m_universe.addComponent(link.entity, NAVMESH_LINK_TYPE, this, cmp);
+		}
+	}
+
+
+	// maps a traversal cost multiplier to a Detour area id so the cost is
+	// baked into the tiles and read back by the crowd's query filter
+	u8 registerLinkCostArea(float cost)
+	{
+		for (int i = 0; i < m_link_cost_areas.size(); ++i)
+		{
+			if (m_link_cost_areas[i] == cost) return u8(OFFMESH_FIRST_AREA + i);
+		}
+		if (OFFMESH_FIRST_AREA + m_link_cost_areas.size() >= RC_WALKABLE_AREA)
+		{
+			g_log_error.log("Navigation") << "Too many distinct link costs";
+			return OFFMESH_FIRST_AREA;
+		}
+		m_link_cost_areas.push(cost);
+		applyLinkCosts();
+		return u8(OFFMESH_FIRST_AREA + m_link_cost_areas.size() - 1);
+	}
+
+
+	void applyLinkCosts()
+	{
+		if (!m_crowd) return;
+		for (int i = 0; i < m_link_cost_areas.size(); ++i)
+		{
+			m_crowd->getEditableFilter(0)->setAreaCost(OFFMESH_FIRST_AREA + i, m_link_cost_areas[i]);
+		}
+	}
+
+
+	void debugDrawLinks() override
+	{
+		auto render_scene = static_cast<RenderScene*>(m_universe.getScene(crc32("renderer")));
+		if (!render_scene) return;
+
+		for (const NavmeshLink& link : m_links)
+		{
+			Vec3 start = m_universe.getPosition(link.entity);
+			Vec3 end = start + m_universe.getRotation(link.entity).rotate(link.end_offset);
+			u32 color = link.is_bidirectional ? 0xff00ffff : 0xffff8000;
+			render_scene->addDebugLine(start, end, color, 0);
+			render_scene->addDebugCross(start, link.radius, color, 0);
+			render_scene->addDebugCross(end, link.radius, color, 0);
+		}
+	}
+
+
+	Vec3 getLinkEndOffset(ComponentHandle cmp) { return m_links[{cmp.index}].end_offset; }
+	void setLinkEndOffset(ComponentHandle cmp, const Vec3& value) { m_links[{cmp.index}].end_offset = value; }
+	float getLinkRadius(ComponentHandle cmp) { return m_links[{cmp.index}].radius; }
+	void setLinkRadius(ComponentHandle cmp, float value) { m_links[{cmp.index}].radius = value; }
+	bool isLinkBidirectional(ComponentHandle cmp) { return m_links[{cmp.index}].is_bidirectional; }
+	void setLinkBidirectional(ComponentHandle cmp, bool value) { m_links[{cmp.index}].is_bidirectional = value; }
+	float getLinkCost(ComponentHandle cmp) { return m_links[{cmp.index}].cost; }
+
+
+	void setLinkCost(ComponentHandle cmp, float value)
+	{
+		NavmeshLink& link = m_links[{cmp.index}];
+		link.cost = value;
+		link.area = registerLinkCostArea(value);
 	}
 
 
@@ -1586,7 +2954,8 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	IPlugin& getPlugin() const override { return m_system; }
 	ComponentHandle getComponent(Entity entity, ComponentType type) override
 	{
-		if (type == NAVMESH_AGENT_TYPE) return {entity.index};
+		if (type == NAVMESH_AGENT_TYPE && m_agents.find(entity).isValid()) return {entity.index};
+		if (type == NAVMESH_LINK_TYPE && m_links.find(entity).isValid()) return {entity.index};
 		return INVALID_COMPONENT;
 	}
 	Universe& getUniverse() override { return m_universe; }
@@ -1599,6 +2968,43 @@ struct NavigationSceneImpl LUMIX_FINAL : public NavigationScene
 	dtNavMeshQuery* m_navquery;
 	rcPolyMeshDetail* m_detail_mesh;
 	HashMap<Entity, Agent> m_agents;
+	HashMap<Entity, NavmeshLink> m_links;
+	Array<float> m_link_cost_areas;
+	DebugDrawCache m_debug_navmesh_cache;
+	DebugDrawCache m_debug_path_cache;
+	DebugDrawCache m_debug_heightfield_cache;
+	DebugDrawCache m_debug_compact_cache;
+	DebugDrawCache m_debug_contours_cache;
+	struct
+	{
+		int x;
+		int z;
+		bool inner;
+		bool outer;
+		bool portals;
+		u32 generation;
+	} m_navmesh_cache_key;
+	u32 m_navmesh_generation;
+	Array<TileGraphNode> m_tile_graph;
+	u32 m_tile_graph_generation;
+	HashMap<Entity, AABB> m_moved_entity_aabbs;
+	Array<DirtyTile> m_dirty_tiles;
+	Array<PathRequest> m_path_requests;
+	Array<TileState> m_tile_states;
+	Array<TileGeometry> m_bake_geometry;
+	StaticString<MAX_PATH_LENGTH> m_tiled_path;
+	bool m_is_streaming;
+	float m_streaming_radius;
+	MTJD::Group m_tile_rebuild_sync;
+	MTJD::Group m_crowd_job_sync;
+	bool m_crowd_job_in_flight;
+	float m_crowd_job_dt;
+	float m_agent_lod_distance;
+	volatile i32 m_tile_rebuild_state;
+	DirtyTile m_rebuilding_tile;
+	unsigned char* m_rebuilt_tile_data;
+	int m_rebuilt_tile_size;
+	bool m_rebuilt_tile_success;
 	rcCompactHeightfield* m_debug_compact_heightfield;
 	rcHeightfield* m_debug_heightfield;
 	rcContourSet* m_debug_contours;
@@ -1629,6 +3035,18 @@ void NavigationSystem::registerProperties()
 		LUMIX_NEW(allocator, BoolPropertyDescriptor<NavigationSceneImpl>)("root motion from anim",
 			&NavigationSceneImpl::isGettingRootMotionFromAnim,
 			&NavigationSceneImpl::setIsGettingRootMotionFromAnim));
+	PropertyRegister::add("navmesh_link",
+		LUMIX_NEW(allocator, SimplePropertyDescriptor<Vec3, NavigationSceneImpl>)(
+			"end offset", &NavigationSceneImpl::getLinkEndOffset, &NavigationSceneImpl::setLinkEndOffset));
+	PropertyRegister::add("navmesh_link",
+		LUMIX_NEW(allocator, DecimalPropertyDescriptor<NavigationSceneImpl>)(
+			"radius", &NavigationSceneImpl::getLinkRadius, &NavigationSceneImpl::setLinkRadius, 0, 999.0f, 0.1f));
+	PropertyRegister::add("navmesh_link",
+		LUMIX_NEW(allocator, DecimalPropertyDescriptor<NavigationSceneImpl>)(
+			"cost", &NavigationSceneImpl::getLinkCost, &NavigationSceneImpl::setLinkCost, 0, 999.0f, 0.1f));
+	PropertyRegister::add("navmesh_link",
+		LUMIX_NEW(allocator, BoolPropertyDescriptor<NavigationSceneImpl>)(
+			"bidirectional", &NavigationSceneImpl::isLinkBidirectional, &NavigationSceneImpl::setLinkBidirectional));
 }
 
 
@@ -1662,6 +3080,7 @@ static void registerLuaAPI(lua_State* L)
 
 	REGISTER_FUNCTION(generateNavmesh);
 	REGISTER_FUNCTION(navigate);
+	REGISTER_FUNCTION(navigateQueued);
 	REGISTER_FUNCTION(setActorActive);
 	REGISTER_FUNCTION(cancelNavigation);
 	REGISTER_FUNCTION(debugDrawNavmesh);
@@ -1672,9 +3091,14 @@ static void registerLuaAPI(lua_State* L)
 	REGISTER_FUNCTION(debugDrawContours);
 	REGISTER_FUNCTION(generateTile);
 	REGISTER_FUNCTION(save);
+	REGISTER_FUNCTION(saveTiled);
+	REGISTER_FUNCTION(loadTiled);
+	REGISTER_FUNCTION(setStreamingRadius);
 	REGISTER_FUNCTION(load);
 	REGISTER_FUNCTION(setGeneratorParams);
 	REGISTER_FUNCTION(getAgentSpeed);
+	REGISTER_FUNCTION(setAgentLODDistance);
+	REGISTER_FUNCTION(getAgentLODDistance);
 
 	#undef REGISTER_FUNCTION
 }
@@ -18,8 +18,14 @@ class NavigationScene : public IScene
 public:
 	virtual bool isFinished(Entity entity) = 0;
 	virtual bool navigate(Entity entity, const struct Vec3& dest, float speed, float stop_distance) = 0;
+	// queues the request; a bounded number of requests is resolved each update
+	virtual void navigateQueued(Entity entity, const Vec3& dest, float speed, float stop_distance) = 0;
 	virtual void setActorActive(Entity entity, bool active) = 0;
 	virtual float getAgentSpeed(Entity entity) = 0;
+	// agents beyond this distance from the "main" camera keep following their
+	// path but skip obstacle avoidance and path optimization; FLT_MAX disables
+	virtual void setAgentLODDistance(float distance) = 0;
+	virtual float getAgentLODDistance() const = 0;
 	virtual float getAgentYawDiff(Entity entity) = 0;
 	virtual void setAgentRootMotion(Entity, const Vec3& root_motion) = 0;
 	virtual bool generateNavmesh() = 0;
@@ -27,12 +33,24 @@ public:
 	virtual bool generateTileAt(const Vec3& pos, bool keep_data) = 0;
 	virtual bool load(const char* path) = 0;
 	virtual bool save(const char* path) = 0;
+	// per-tile variant of save/load; tiles are stored as individual files and
+	// streamed in and out around the "main" camera instead of staying resident
+	virtual bool saveTiled(const char* path) = 0;
+	virtual bool loadTiled(const char* path) = 0;
+	virtual void setStreamingRadius(float radius) = 0;
+	virtual float getStreamingRadius() const = 0;
 	virtual void debugDrawNavmesh(const Vec3& pos, bool inner_boundaries, bool outer_boundaries, bool portals) = 0;
 	virtual void debugDrawCompactHeightfield() = 0;
 	virtual void debugDrawHeightfield() = 0;
 	virtual void debugDrawContours() = 0;
 	virtual void debugDrawPath(Entity entity) = 0;
+	virtual void debugDrawLinks() = 0;
 	virtual const dtCrowdAgent* getDetourAgent(Entity entity) = 0;
+	// batched spatial queries; results are written per element, with out flags
+	// cleared for inputs that found no usable navmesh position
+	virtual void findNearestWalkablePoints(const Vec3* points, int count, const Vec3& extents, Vec3* out_points, bool* out_found) = 0;
+	virtual void findRandomPointsAroundCircle(const Vec3& center, float radius, int count, Vec3* out_points, bool* out_found) = 0;
+	virtual void arePointsReachable(const Vec3& from, const Vec3* to, int count, bool* out_reachable) = 0;
 	virtual bool isNavmeshReady() const = 0;
 	virtual bool hasDebugDrawData() const = 0;
 	virtual DelegateList<void(float)>& onUpdate() = 0;
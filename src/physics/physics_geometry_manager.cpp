@@ -1,5 +1,7 @@
 #include "physics_geometry_manager.h"
+#include "engine/crc32.h"
 #include "engine/fs/file_system.h"
+#include "engine/fs/os_file.h"
 #include "engine/log.h"
 #include "engine/resource_manager.h"
 #include "engine/string.h"
@@ -84,6 +86,57 @@ struct InputStream LUMIX_FINAL : public physx::PxInputStream
 };
 
 
+// header of the on-disk cooked mesh cache; the content hash ties the cached
+// blob to the exact input geometry, so edited sources are recooked instead of
+// loading a stale cache
+struct CookedHeader
+{
+	u32 m_magic;
+	u32 m_version;
+	u32 m_convex;
+	u32 m_content_hash;
+};
+
+static const u32 COOKED_HEADER_MAGIC = 0x5f4c5043; // '_LPC'
+static const u32 COOKED_VERSION = 1;
+
+
+static bool loadCookedCache(const char* path, bool is_convex, u32 content_hash, IAllocator& allocator, Array<u8>& blob)
+{
+	FS::OsFile file;
+	if (!file.open(path, FS::Mode::OPEN_AND_READ, allocator)) return false;
+
+	CookedHeader header;
+	bool valid = file.read(&header, sizeof(header)) && header.m_magic == COOKED_HEADER_MAGIC &&
+				 header.m_version == COOKED_VERSION && header.m_convex == (is_convex ? 1 : 0) &&
+				 header.m_content_hash == content_hash;
+	if (valid)
+	{
+		int blob_size = int(file.size() - sizeof(header));
+		blob.resize(blob_size);
+		valid = blob_size > 0 && file.read(&blob[0], blob_size);
+	}
+	file.close();
+	return valid;
+}
+
+
+static void saveCookedCache(const char* path, bool is_convex, u32 content_hash, const OutputStream& data, IAllocator& allocator)
+{
+	FS::OsFile file;
+	if (!file.open(path, FS::Mode::CREATE_AND_WRITE, allocator)) return;
+
+	CookedHeader header;
+	header.m_magic = COOKED_HEADER_MAGIC;
+	header.m_version = COOKED_VERSION;
+	header.m_convex = is_convex ? 1 : 0;
+	header.m_content_hash = content_hash;
+	file.write(&header, sizeof(header));
+	file.write(data.data, data.size);
+	file.close();
+}
+
+
 Resource* PhysicsGeometryManager::createResource(const Path& path)
 {
 	return LUMIX_NEW(m_allocator, PhysicsGeometry)(path, *this, m_allocator);
@@ -133,6 +186,47 @@ bool PhysicsGeometry::load(FS::IFile& file)
 	file.read(&verts[0], sizeof(verts[0]) * verts.size());
 
 	bool is_convex = header.m_convex != 0;
+	u32 content_hash = crc32(&verts[0], int(sizeof(verts[0])) * verts.size());
+	Array<u32> tris(getAllocator());
+	if (!is_convex)
+	{
+		u32 num_indices;
+		file.read(&num_indices, sizeof(num_indices));
+		tris.resize(num_indices);
+		file.read(&tris[0], sizeof(tris[0]) * tris.size());
+		content_hash ^= crc32(&tris[0], int(sizeof(tris[0])) * tris.size());
+	}
+
+	// cooking is by far the slowest part of loading, so cooked meshes are cached
+	// next to the source resource and fed straight to create*Mesh on later loads
+	StaticString<MAX_PATH_LENGTH> cooked_path(getPath().c_str(), ".cooked");
+	Array<u8> cooked(getAllocator());
+	if (loadCookedCache(cooked_path, is_convex, content_hash, getAllocator(), cooked))
+	{
+		InputStream readBuffer(&cooked[0], cooked.size());
+		if (is_convex)
+		{
+			convex_mesh = system.getPhysics()->createConvexMesh(readBuffer);
+			tri_mesh = nullptr;
+			if (convex_mesh)
+			{
+				m_size = file.size();
+				return true;
+			}
+		}
+		else
+		{
+			tri_mesh = system.getPhysics()->createTriangleMesh(readBuffer);
+			convex_mesh = nullptr;
+			if (tri_mesh)
+			{
+				m_size = file.size();
+				return true;
+			}
+		}
+		// a cache cooked by an incompatible PhysX falls through to recooking
+	}
+
 	if (is_convex)
 	{
 		physx::PxConvexMeshDesc meshDesc;
@@ -149,24 +243,19 @@ bool PhysicsGeometry::load(FS::IFile& file)
 			return false;
 		}
 
+		saveCookedCache(cooked_path, is_convex, content_hash, writeBuffer, getAllocator());
 		InputStream readBuffer(writeBuffer.data, writeBuffer.size);
 		convex_mesh = system.getPhysics()->createConvexMesh(readBuffer);
 		tri_mesh = nullptr;
 	}
 	else
 	{
-		u32 num_indices;
-		Array<u32> tris(getAllocator());
-		file.read(&num_indices, sizeof(num_indices));
-		tris.resize(num_indices);
-		file.read(&tris[0], sizeof(tris[0]) * tris.size());
-
 		physx::PxTriangleMeshDesc meshDesc;
 		meshDesc.points.count = num_verts;
 		meshDesc.points.stride = sizeof(physx::PxVec3);
 		meshDesc.points.data = &verts[0];
 
-		meshDesc.triangles.count = num_indices / 3;
+		meshDesc.triangles.count = tris.size() / 3;
 		meshDesc.triangles.stride = 3 * sizeof(physx::PxU32);
 		meshDesc.triangles.data = &tris[0];
 
@@ -177,6 +266,7 @@ bool PhysicsGeometry::load(FS::IFile& file)
 			return false;
 		}
 
+		saveCookedCache(cooked_path, is_convex, content_hash, writeBuffer, getAllocator());
 		InputStream readBuffer(writeBuffer.data, writeBuffer.size);
 		tri_mesh = system.getPhysics()->createTriangleMesh(readBuffer);
 		convex_mesh = nullptr;
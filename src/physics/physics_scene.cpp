@@ -8,6 +8,9 @@
 #include "engine/log.h"
 #include "engine/lua_wrapper.h"
 #include "engine/matrix.h"
+#include "engine/mtjd/for_each.h"
+#include "engine/mtjd/generic_job.h"
+#include "engine/mtjd/group.h"
 #include "engine/path.h"
 #include "engine/profiler.h"
 #include "engine/property_register.h"
@@ -83,6 +86,54 @@ struct Ragdoll
 	RagdollBone* root = nullptr;
 	Transform root_transform;
 	int layer;
+	// range in the scene's flattened bone array, rebuilt lazily when the
+	// linked skeleton changes
+	int flat_first = 0;
+	int flat_count = 0;
+	bool is_lod_suspended = false;
+};
+
+
+// per-frame write-back copy of a ragdoll bone; updateRagdolls walks these in
+// one contiguous sweep instead of chasing the editing-friendly linked nodes
+struct FlatRagdollBone
+{
+	PxRigidDynamic* actor;
+	int pose_bone_idx;
+	Transform bind_transform;
+	Transform inv_bind_transform;
+	bool is_kinematic;
+};
+
+
+// feeds PhysX worker tasks into the engine's job pool instead of letting the
+// default dispatcher spin up its own threads that fight ours for cores
+struct MTJDCpuDispatcher LUMIX_FINAL : public PxCpuDispatcher
+{
+	explicit MTJDCpuDispatcher(MTJD::Manager& manager)
+		: m_manager(manager)
+	{
+	}
+
+
+	void submitTask(PxBaseTask& task) override
+	{
+		PxBaseTask* task_ptr = &task;
+		MTJD::Job* job = MTJD::makeJob(m_manager,
+			[task_ptr]()
+			{
+				task_ptr->run();
+				task_ptr->release();
+			},
+			m_manager.getJobAllocator());
+		m_manager.schedule(job);
+	}
+
+
+	PxU32 getWorkerCount() const override { return m_manager.getCpuThreadsCount(); }
+
+
+	MTJD::Manager& m_manager;
 };
 
 
@@ -213,14 +264,33 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 				auto contact_count = cp.extractContacts(&contact, 1);
 
 				auto pos = fromPhysx(contact.position);
-				Entity e1 = { (int)(intptr_t)(pairHeader.actors[0]->userData) };
-				Entity e2 = { (int)(intptr_t)(pairHeader.actors[1]->userData) };
-				m_scene.onContact(e1, e2, pos);
+				// fetchResults runs the callbacks; events are only buffered
+				// here and dispatched in one batch after the step is collected
+				ContactData& contact_data = m_scene.m_contact_buffer.emplace();
+				contact_data.position = pos;
+				contact_data.e1 = { (int)(intptr_t)(pairHeader.actors[0]->userData) };
+				contact_data.e2 = { (int)(intptr_t)(pairHeader.actors[1]->userData) };
 			}
 		}
 
 
-		void onTrigger(PxTriggerPair* pairs, PxU32 count) override {}
+		void onTrigger(PxTriggerPair* pairs, PxU32 count) override
+		{
+			for (PxU32 i = 0; i < count; ++i)
+			{
+				const auto& pair = pairs[i];
+				if (pair.flags & (PxTriggerPairFlag::eREMOVED_SHAPE_TRIGGER |
+									 PxTriggerPairFlag::eREMOVED_SHAPE_OTHER))
+				{
+					continue;
+				}
+
+				TriggerData& trigger_data = m_scene.m_trigger_buffer.emplace();
+				trigger_data.e1 = { (int)(intptr_t)(pair.triggerActor->userData) };
+				trigger_data.e2 = { (int)(intptr_t)(pair.otherActor->userData) };
+				trigger_data.touch_lost = pair.status == PxPairFlag::eNOTIFY_TOUCH_LOST;
+			}
+		}
 		void onConstraintBreak(PxConstraintInfo*, PxU32) override {}
 		void onWake(PxActor**, PxU32) override {}
 		void onSleep(PxActor**, PxU32) override {}
@@ -241,6 +311,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 			, entity(INVALID_ENTITY)
 			, type(_type)
 			, dynamic_type(DynamicType::STATIC)
+			, is_lod_suspended(false)
 		{
 		}
 
@@ -261,6 +332,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 		PhysicsSceneImpl& scene;
 		ActorType type;
 		DynamicType dynamic_type;
+		bool is_lod_suspended;
 
 	private:
 		void onStateChanged(Resource::State old_state, Resource::State new_state, Resource&);
@@ -270,13 +342,27 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 	PhysicsSceneImpl(Universe& context, IAllocator& allocator)
 		: m_allocator(allocator)
 		, m_controllers(m_allocator)
+		, m_controller_moves(m_allocator)
 		, m_actors(m_allocator)
 		, m_ragdolls(m_allocator)
+		, m_ragdoll_flat_bones(m_allocator)
+		, m_ragdoll_topology_version(0)
+		, m_ragdoll_flat_version(0xffffFFFF)
 		, m_terrains(m_allocator)
 		, m_dynamic_actors(m_allocator)
 		, m_universe(context)
 		, m_is_game_running(false)
+		, m_lod_distance(FLT_MAX)
+		, m_simulation_in_flight(false)
+		, m_queued_raycasts(m_allocator)
+		, m_raycast_results(m_allocator)
+		, m_heightfield_job_sync(true, m_allocator)
+		, m_heightfield_job_in_flight(false)
+		, m_heightfield_patch_data(m_allocator)
 		, m_contact_callback(*this)
+		, m_contact_buffer(m_allocator)
+		, m_trigger_buffer(m_allocator)
+		, m_contact_batch_cb(m_allocator)
 		, m_queued_forces(m_allocator)
 		, m_layers_count(2)
 		, m_joints(m_allocator)
@@ -320,10 +406,12 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 
 	~PhysicsSceneImpl()
 	{
+		syncSimulation();
 		m_controller_manager->release();
 		m_default_material->release();
 		m_dummy_actor->release();
 		m_scene->release();
+		LUMIX_DELETE(m_allocator, m_cpu_dispatcher);
 	}
 
 
@@ -346,6 +434,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 			destroySkeleton(ragdoll.root);
 		}
 		m_ragdolls.clear();
+		++m_ragdoll_topology_version;
 
 		for (auto& joint : m_joints)
 		{
@@ -364,30 +453,63 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 	}
 
 
-	void onContact(Entity e1, Entity e2, const Vec3& position)
+	DelegateList<void(const ContactData*, int)>& onContactBatch() override { return m_contact_batch_cb; }
+
+
+	void dispatchEventBatches()
 	{
-		if (!m_script_scene) return;
+		if (m_contact_buffer.empty() && m_trigger_buffer.empty()) return;
+		PROFILE_FUNCTION();
+		PROFILE_INT("contacts", m_contact_buffer.size());
+		PROFILE_INT("triggers", m_trigger_buffer.size());
 
-		auto send = [this](Entity e1, Entity e2, const Vec3& position)
+		if (!m_contact_buffer.empty())
 		{
-			auto cmp = m_script_scene->getComponent(e1);
-			if (cmp == INVALID_COMPONENT) return;
+			m_contact_batch_cb.invoke(&m_contact_buffer[0], m_contact_buffer.size());
+		}
 
-			for (int i = 0, c = m_script_scene->getScriptCount(cmp); i < c; ++i)
+		if (m_script_scene)
+		{
+			auto send = [this](Entity e1, Entity e2, const char* fn, const Vec3* position, bool touch_lost)
 			{
-				auto* call = m_script_scene->beginFunctionCall(cmp, i, "onContact");
-				if (!call) continue;
-
-				call->add(e2.index);
-				call->add(position.x);
-				call->add(position.y);
-				call->add(position.z);
-				m_script_scene->endFunctionCall();
+				auto cmp = m_script_scene->getComponent(e1);
+				if (cmp == INVALID_COMPONENT) return;
+
+				for (int i = 0, c = m_script_scene->getScriptCount(cmp); i < c; ++i)
+				{
+					auto* call = m_script_scene->beginFunctionCall(cmp, i, fn);
+					if (!call) continue;
+
+					call->add(e2.index);
+					if (position)
+					{
+						call->add(position->x);
+						call->add(position->y);
+						call->add(position->z);
+					}
+					else
+					{
+						call->add(touch_lost ? 1 : 0);
+					}
+					m_script_scene->endFunctionCall();
+				}
+			};
+
+			for (const ContactData& contact : m_contact_buffer)
+			{
+				send(contact.e1, contact.e2, "onContact", &contact.position, false);
+				send(contact.e2, contact.e1, "onContact", &contact.position, false);
 			}
-		};
+			for (const TriggerData& trigger : m_trigger_buffer)
+			{
+				send(trigger.e1, trigger.e2, "onTrigger", nullptr, trigger.touch_lost);
+				send(trigger.e2, trigger.e1, "onTrigger", nullptr, trigger.touch_lost);
+			}
+		}
 
-		send(e1, e2, position);
-		send(e2, e1, position);
+		// capacity is kept, so steady-state frames do not allocate
+		m_contact_buffer.clear();
+		m_trigger_buffer.clear();
 	}
 
 
@@ -660,8 +782,39 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 		int bytes_per_pixel) override
 	{
 		PROFILE_FUNCTION();
+		// the sample conversion and PxHeightField::modifySamples run on a
+		// worker so a brush stroke on a big terrain does not stall the editor;
+		// only the edited rect is copied to staging here. syncSimulation()
+		// waits for the job, so every other scene access sees it finished
+		syncSimulation();
+		m_heightfield_patch_data.resize(width * height * bytes_per_pixel);
+		copyMemory(&m_heightfield_patch_data[0], src_data, m_heightfield_patch_data.size());
+		const u8* staging = &m_heightfield_patch_data[0];
+
+		PhysicsSceneImpl* scene = this;
+		MTJD::Job* job = MTJD::makeJob(m_engine->getMTJDManager(),
+			[scene, cmp, x, y, width, height, staging, bytes_per_pixel]()
+			{
+				PROFILE_BLOCK("heightfield patch");
+				scene->applyHeightfieldPatch(cmp, x, y, width, height, staging, bytes_per_pixel);
+			},
+			m_engine->getMTJDManager().getJobAllocator());
+		job->addDependency(&m_heightfield_job_sync);
+		m_heightfield_job_in_flight = true;
+		m_engine->getMTJDManager().schedule(job);
+	}
+
+
+	void applyHeightfieldPatch(ComponentHandle cmp,
+		int x,
+		int y,
+		int width,
+		int height,
+		const u8* src_data,
+		int bytes_per_pixel)
+	{
 		Heightfield& terrain = m_terrains[{cmp.index}];
-		
+
 		PxShape* shape;
 		terrain.m_actor->getShapes(&shape, 1);
 		PxHeightFieldGeometry geom;
@@ -1070,6 +1223,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 
 	ComponentHandle createComponent(ComponentType component_type, Entity entity) override
 	{
+		syncSimulation();
 		if (component_type == DISTANCE_JOINT_TYPE)
 		{
 			return createDistanceJoint(entity);
@@ -1120,6 +1274,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 
 	void destroyComponent(ComponentHandle cmp, ComponentType type) override
 	{
+		syncSimulation();
 		if (type == HEIGHTFIELD_TYPE)
 		{
 			Entity entity = {cmp.index};
@@ -1150,6 +1305,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 			Entity entity = m_ragdolls.at(idx).entity;
 			destroySkeleton(m_ragdolls.at(idx).root);
 			m_ragdolls.eraseAt(idx);
+			++m_ragdoll_topology_version;
 			m_universe.destroyComponent(entity, type, this, cmp);
 		}
 		else if (type == SPHERICAL_JOINT_TYPE || type == HINGE_JOINT_TYPE || type == DISTANCE_JOINT_TYPE ||
@@ -1558,12 +1714,37 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 	void updateDynamicActors()
 	{
 		PROFILE_FUNCTION();
-		for (auto* actor : m_dynamic_actors)
+		// only actors PhysX actually moved this step write back to the
+		// universe; sleeping props cost nothing here. The active transform
+		// list also contains controllers and ragdoll bones, so entries are
+		// matched against m_actors before touching the universe
+		PxU32 active_count;
+		const PxActiveTransform* active = m_scene->getActiveTransforms(active_count);
+		Array<Entity> moved_entities(m_allocator);
+		Array<Transform> moved_transforms(m_allocator);
+		moved_entities.reserve(active_count);
+		moved_transforms.reserve(active_count);
+		for (PxU32 i = 0; i < active_count; ++i)
+		{
+			Entity entity = {(int)(intptr_t)active[i].userData};
+			int idx = m_actors.find(entity);
+			if (idx < 0) continue;
+			RigidActor* actor = m_actors.at(idx);
+			if (actor->physx_actor != active[i].actor) continue;
+			if (actor->dynamic_type != DynamicType::DYNAMIC) continue;
+
+			const PxTransform& trans = active[i].actor2World;
+			moved_entities.push(actor->entity);
+			moved_transforms.push(fromPhysx(trans));
+		}
+		// one batched write delivers a single entityTransformed fan-out for
+		// all awake actors instead of two per actor
+		if (!moved_entities.empty())
 		{
-			PxTransform trans = actor->physx_actor->getGlobalPose();
-			m_universe.setPosition(actor->entity, trans.p.x, trans.p.y, trans.p.z);
-			m_universe.setRotation(actor->entity, trans.q.x, trans.q.y, trans.q.z, trans.q.w);
+			m_universe.setTransforms(&moved_entities[0], &moved_transforms[0], moved_entities.size());
 		}
+		PROFILE_INT("awake actors", moved_entities.size());
+		PROFILE_INT("sleeping actors", m_dynamic_actors.size() - moved_entities.size());
 	}
 
 
@@ -1581,20 +1762,181 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 	}
 
 
+	// PhysX forbids touching the scene while a step is in flight; the step
+	// kicked at the end of update() is collected here, either at the start of
+	// the next update or early by any caller that needs same-frame results.
+	// a pending heightfield job writes to the scene too, so it is waited on
+	// under the same guard
+	void syncSimulation()
+	{
+		if (m_heightfield_job_in_flight)
+		{
+			PROFILE_BLOCK("sync heightfield job");
+			m_heightfield_job_sync.sync();
+			m_heightfield_job_in_flight = false;
+		}
+		if (!m_simulation_in_flight) return;
+		fetchResults();
+		m_simulation_in_flight = false;
+		updateRagdolls();
+		updateDynamicActors();
+		dispatchEventBatches();
+	}
+
+
+	// keyframes a far-away ragdoll: bones whose authored flag is not kinematic
+	// get only the physx flag flipped, so serialization and the editor still
+	// see the authored state
+	void setRagdollLODKinematic(RagdollBone* bone, bool kinematic)
+	{
+		while (bone)
+		{
+			if (!bone->is_kinematic)
+			{
+				bone->actor->isRigidBody()->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, kinematic);
+			}
+			setRagdollLODKinematic(bone->child, kinematic);
+			bone = bone->next;
+		}
+	}
+
+
+	void updateLOD()
+	{
+		if (m_lod_distance >= FLT_MAX) return;
+		auto* render_scene = static_cast<RenderScene*>(m_universe.getScene(RENDERER_HASH));
+		if (!render_scene) return;
+		ComponentHandle camera = render_scene->getCameraInSlot("main");
+		if (!isValid(camera)) return;
+
+		PROFILE_FUNCTION();
+		Vec3 cam_pos = m_universe.getPosition(render_scene->getCameraEntity(camera));
+		float lod_distance_squared = m_lod_distance * m_lod_distance;
+
+		int suspended = 0;
+		for (auto* actor : m_dynamic_actors)
+		{
+			if (!actor->physx_actor) continue;
+			float dist_squared = (m_universe.getPosition(actor->entity) - cam_pos).squaredLength();
+			bool far_away = dist_squared > lod_distance_squared;
+			if (far_away) ++suspended;
+			if (far_away == actor->is_lod_suspended) continue;
+			actor->is_lod_suspended = far_away;
+			actor->physx_actor->setActorFlag(PxActorFlag::eDISABLE_SIMULATION, far_away);
+			if (!far_away)
+			{
+				PxRigidDynamic* dynamic = actor->physx_actor->isRigidDynamic();
+				if (dynamic) dynamic->wakeUp();
+			}
+		}
+		PROFILE_INT("suspended actors", suspended);
+
+		for (int i = 0, c = m_ragdolls.size(); i < c; ++i)
+		{
+			Ragdoll& ragdoll = m_ragdolls.at(i);
+			if (!ragdoll.root) continue;
+			float dist_squared = (m_universe.getPosition(ragdoll.entity) - cam_pos).squaredLength();
+			bool far_away = dist_squared > lod_distance_squared;
+			if (far_away == ragdoll.is_lod_suspended) continue;
+			ragdoll.is_lod_suspended = far_away;
+			setRagdollLODKinematic(ragdoll.root, far_away);
+		}
+	}
+
+
+	void setLODDistance(float distance) override { m_lod_distance = distance; }
+	float getLODDistance() override { return m_lod_distance; }
+
+
 	void updateControllers(float time_delta)
 	{
 		PROFILE_FUNCTION();
 		Vec3 g(0, time_delta * -9.8f, 0);
-		for (auto& controller : m_controllers)
+		int count = m_controllers.size();
+		if (count == 0) return;
+
+		// PxController::move is not reentrant, but its expensive part - the
+		// capsule sweeps - are plain scene queries, legal from workers while
+		// no step is in flight. Workers classify each controller: a free
+		// horizontal path plus a flat ground contact (or free fall) is
+		// resolved right there and only teleported below; anything touching
+		// walls, steps or slopes falls back to the serial move
+		m_controller_moves.resize(count);
+		Controller* controllers = &m_controllers.at(0);
+		ControllerMove* moves = &m_controller_moves[0];
+		PxScene* px_scene = m_scene;
+		MTJD::forEach(m_engine->getMTJDManager(), m_allocator, 0, count, 8,
+			[controllers, moves, px_scene, g](int from, int to)
+			{
+				const float SKIN = 0.1f;
+				for (int i = from; i < to; ++i)
+				{
+					Controller& c = controllers[i];
+					ControllerMove& move = moves[i];
+					move.is_resolved = false;
+
+					const PxExtendedVec3& p = c.m_controller->getPosition();
+					PxVec3 pos((float)p.x, (float)p.y, (float)p.z);
+					PxCapsuleGeometry capsule(c.m_radius, c.m_height * 0.5f);
+					// physx capsules extend along x; controllers stand upright
+					PxTransform pose(pos, PxQuat(PxHalfPi, PxVec3(0, 0, 1)));
+
+					Filter filter;
+					filter.entity = c.m_entity;
+					PxQueryFilterData filter_data;
+					filter_data.flags = PxQueryFlag::eDYNAMIC | PxQueryFlag::eSTATIC | PxQueryFlag::ePREFILTER;
+					PxSweepBuffer hit;
+
+					Vec3 horizontal(c.m_frame_change.x, 0, c.m_frame_change.z);
+					float h_len = horizontal.length();
+					if (h_len > 1e-5f)
+					{
+						PxVec3 dir(horizontal.x / h_len, 0, horizontal.z / h_len);
+						if (px_scene->sweep(capsule, pose, dir, h_len + SKIN, hit,
+								PxHitFlag::eDISTANCE, filter_data, &filter))
+						{
+							continue;
+						}
+						pose.p += dir * h_len;
+					}
+
+					float drop = -(g.y + c.m_frame_change.y);
+					if (drop <= 0) continue;
+					float resolved_drop = drop;
+					if (px_scene->sweep(capsule, pose, PxVec3(0, -1, 0), drop + SKIN, hit,
+							PxHitFlag::eDISTANCE | PxHitFlag::eNORMAL, filter_data, &filter))
+					{
+						// anything but a flat resting contact goes the serial way
+						if (hit.block.normal.y < 0.9f) continue;
+						resolved_drop = Math::maximum(0.0f, hit.block.distance - SKIN);
+					}
+					move.final_pos.set(pose.p.x, pose.p.y - resolved_drop, pose.p.z);
+					move.is_resolved = true;
+				}
+			});
+
+		int resolved = 0;
+		for (int i = 0; i < count; ++i)
 		{
+			Controller& controller = m_controllers.at(i);
 			Vec3 dif = g + controller.m_frame_change;
 			controller.m_frame_change.set(0, 0, 0);
+			if (m_controller_moves[i].is_resolved)
+			{
+				++resolved;
+				const Vec3& p = m_controller_moves[i].final_pos;
+				controller.m_controller->setPosition(PxExtendedVec3(p.x, p.y, p.z));
+				float y = p.y - controller.m_height * 0.5f - controller.m_radius;
+				m_universe.setPosition(controller.m_entity, p.x, y, p.z);
+				continue;
+			}
 			const PxExtendedVec3& p = controller.m_controller->getPosition();
 			controller.m_controller->move(toPhysx(dif), 0.01f, time_delta, PxControllerFilters());
 
 			float y = (float)p.y - controller.m_height * 0.5f - controller.m_radius;
 			m_universe.setPosition(controller.m_entity, (float)p.x, y, (float)p.z);
 		}
+		PROFILE_INT("parallel moves", resolved);
 	}
 
 
@@ -1611,6 +1953,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 
 			auto* physx_actor = static_cast<PxRigidDynamic*>(actor->physx_actor);
 			if (!physx_actor) return;
+			if (actor->is_lod_suspended) continue;
 			PxVec3 f(i.force.x, i.force.y, i.force.z);
 			physx_actor->addForce(f);
 		}
@@ -1728,6 +2071,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 		bone->bind_transform =
 			(entity_transform.inverted() * transform).inverted() * model->getBone(bone->pose_bone_idx).transform;
 		bone->inv_bind_transform = bone->bind_transform.inverted();
+		++m_ragdoll_topology_version;
 		PxTransform delta = toPhysx(transform).getInverse() * bone->actor->getGlobalPose();
 		bone->actor->setGlobalPose(toPhysx(transform));
 
@@ -1807,12 +2151,14 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 	{
 		auto& ragdoll = m_ragdolls[{cmp.index}];
 		setRagdollRoot(ragdoll, deserializeRagdollBone(ragdoll, nullptr, blob));
+		++m_ragdoll_topology_version;
 	}
 
 
 	void setRagdollBoneKinematic(RagdollBone* bone, bool is_kinematic) override
 	{
 		bone->is_kinematic = is_kinematic;
+		++m_ragdoll_topology_version;
 		bone->actor->isRigidBody()->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, is_kinematic);
 	}
 
@@ -1820,6 +2166,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 	void setRagdollBoneKinematicRecursive(RagdollBone* bone, bool is_kinematic) override
 	{
 		if (!bone) return;
+		++m_ragdoll_topology_version;
 		bone->is_kinematic = is_kinematic;
 		bone->actor->isRigidBody()->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, is_kinematic);
 		setRagdollBoneKinematicRecursive(bone->child, is_kinematic);
@@ -1964,6 +2311,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 		bone->prev = nullptr;
 		bone->next = ragdoll.root;
 		if(bone->next) bone->next->prev = bone;
+		++m_ragdoll_topology_version;
 	}
 
 
@@ -1979,6 +2327,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 		parent->child = child;
 		child->parent = parent;
 		changeRagdollBoneJoint(child, PxJointConcreteType::eD6);
+		++m_ragdoll_topology_version;
 	}
 
 
@@ -2089,6 +2438,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 		if (parent) connect(ragdoll, new_bone, parent);
 
 		findCloserChildren(ragdoll, cmp, model, new_bone);
+		++m_ragdoll_topology_version;
 
 		return new_bone;
 	}
@@ -2106,25 +2456,34 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 	}
 
 
-	void updateBone(const Transform& root_transform, const Transform& inv_root, RagdollBone* bone, Pose* pose)
+	void collectRagdollBones(RagdollBone* bone)
 	{
-		if (!bone) return;
-			
-		if (bone->is_kinematic)
+		while (bone)
 		{
-			Transform bone_transform(Transform(pose->positions[bone->pose_bone_idx], pose->rotations[bone->pose_bone_idx]));
-			bone->actor->setKinematicTarget(toPhysx(root_transform * bone_transform * bone->inv_bind_transform));
+			FlatRagdollBone flat;
+			flat.actor = bone->actor;
+			flat.pose_bone_idx = bone->pose_bone_idx;
+			flat.bind_transform = bone->bind_transform;
+			flat.inv_bind_transform = bone->inv_bind_transform;
+			flat.is_kinematic = bone->is_kinematic;
+			m_ragdoll_flat_bones.push(flat);
+			collectRagdollBones(bone->child);
+			bone = bone->next;
 		}
-		else
+	}
+
+
+	void rebuildRagdollFlatBones()
+	{
+		m_ragdoll_flat_bones.clear();
+		for (int i = 0, c = m_ragdolls.size(); i < c; ++i)
 		{
-			PxTransform bone_pose = bone->actor->getGlobalPose();
-			auto tr = inv_root * Transform(fromPhysx(bone_pose.p), fromPhysx(bone_pose.q)) * bone->bind_transform;
-			pose->rotations[bone->pose_bone_idx] = tr.rot;
-			pose->positions[bone->pose_bone_idx] = tr.pos;
+			Ragdoll& ragdoll = m_ragdolls.at(i);
+			ragdoll.flat_first = m_ragdoll_flat_bones.size();
+			collectRagdollBones(ragdoll.root);
+			ragdoll.flat_count = m_ragdoll_flat_bones.size() - ragdoll.flat_first;
 		}
-
-		updateBone(root_transform, inv_root, bone->next, pose);
-		updateBone(root_transform, inv_root, bone->child, pose);
+		m_ragdoll_flat_version = m_ragdoll_topology_version;
 	}
 
 
@@ -2133,6 +2492,8 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 		auto* render_scene = static_cast<RenderScene*>(m_universe.getScene(RENDERER_HASH));
 		if (!render_scene) return;
 
+		if (m_ragdoll_flat_version != m_ragdoll_topology_version) rebuildRagdollFlatBones();
+
 		for (auto& ragdoll : m_ragdolls)
 		{
 			ComponentHandle model_instance = render_scene->getModelInstanceComponent(ragdoll.entity);
@@ -2154,7 +2515,23 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 
 				m_is_updating_ragdoll = false;
 			}
-			updateBone(root_transform, root_transform.inverted(), ragdoll.root, pose);
+			Transform inv_root = root_transform.inverted();
+			for (int i = ragdoll.flat_first, end = ragdoll.flat_first + ragdoll.flat_count; i < end; ++i)
+			{
+				FlatRagdollBone& bone = m_ragdoll_flat_bones[i];
+				if (bone.is_kinematic || ragdoll.is_lod_suspended)
+				{
+					Transform bone_transform(pose->positions[bone.pose_bone_idx], pose->rotations[bone.pose_bone_idx]);
+					bone.actor->setKinematicTarget(toPhysx(root_transform * bone_transform * bone.inv_bind_transform));
+				}
+				else
+				{
+					PxTransform bone_pose = bone.actor->getGlobalPose();
+					auto tr = inv_root * Transform(fromPhysx(bone_pose.p), fromPhysx(bone_pose.q)) * bone.bind_transform;
+					pose->rotations[bone.pose_bone_idx] = tr.rot;
+					pose->positions[bone.pose_bone_idx] = tr.pos;
+				}
+			}
 		}
 	}
 
@@ -2163,16 +2540,20 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 	{
 		if (!m_is_game_running || paused) return;
 		
+		// results of the step kicked at the end of the previous update; it ran
+		// concurrently with rendering, animation and scripts, so transforms
+		// are one frame behind gameplay
+		syncSimulation();
+
+		executeQueuedRaycasts();
 		applyQueuedForces();
+		updateLOD();
+		updateControllers(time_delta);
+		render();
 
 		time_delta = Math::minimum(1 / 20.0f, time_delta);
 		simulateScene(time_delta);
-		fetchResults();
-		updateRagdolls();
-		updateDynamicActors();
-		updateControllers(time_delta);
-		
-		render();
+		m_simulation_in_flight = true;
 	}
 
 
@@ -2228,6 +2609,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 
 	void stopGame() override
 	{
+		syncSimulation();
 		m_is_game_running = false;
 	}
 
@@ -2284,6 +2666,69 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 	void moveController(ComponentHandle cmp, const Vec3& v) override { m_controllers[{cmp.index}].m_frame_change += v; }
 
 
+	int queueRaycast(const Vec3& origin, const Vec3& dir, float distance, Entity ignored) override
+	{
+		QueuedRaycast& query = m_queued_raycasts.emplace();
+		query.origin = origin;
+		query.dir = dir;
+		query.distance = distance;
+		query.ignored = ignored;
+		return m_queued_raycasts.size() - 1;
+	}
+
+
+	bool getQueuedRaycastResult(int id, RaycastHit& result) override
+	{
+		if (id < 0 || id >= m_raycast_results.size()) return false;
+		result = m_raycast_results[id].hit;
+		return m_raycast_results[id].is_hit;
+	}
+
+
+	void executeQueuedRaycasts()
+	{
+		m_raycast_results.resize(m_queued_raycasts.size());
+		if (m_queued_raycasts.empty()) return;
+
+		PROFILE_BLOCK("batched raycasts");
+		PROFILE_INT("count", m_queued_raycasts.size());
+		// scene queries are read calls, so the workers can cast concurrently
+		// as long as no step is in flight
+		MTJD::forEach(m_engine->getMTJDManager(),
+			m_allocator,
+			0,
+			m_queued_raycasts.size(),
+			0,
+			[this](int from, int to) {
+				for (int i = from; i < to; ++i)
+				{
+					const QueuedRaycast& query = m_queued_raycasts[i];
+					m_raycast_results[i].is_hit =
+						raycastEx(query.origin, query.dir, query.distance, m_raycast_results[i].hit, query.ignored);
+				}
+			});
+		m_queued_raycasts.clear();
+	}
+
+
+	static int LUA_getQueuedRaycast(lua_State* L)
+	{
+		auto* scene = LuaWrapper::checkArg<PhysicsSceneImpl*>(L, 1);
+		int id = LuaWrapper::checkArg<int>(L, 2);
+
+		RaycastHit hit;
+		if (scene->getQueuedRaycastResult(id, hit))
+		{
+			LuaWrapper::push(L, true);
+			LuaWrapper::push(L, hit.entity);
+			LuaWrapper::push(L, hit.position);
+			return 3;
+		}
+		LuaWrapper::push(L, false);
+		return 1;
+	}
+
+
 	static int LUA_raycast(lua_State* L)
 	{
 		auto* scene = LuaWrapper::checkArg<PhysicsSceneImpl*>(L, 1);
@@ -2333,6 +2778,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 
 	bool raycastEx(const Vec3& origin, const Vec3& dir, float distance, RaycastHit& result, Entity ignored) override
 	{
+		syncSimulation();
 		PxVec3 physx_origin(origin.x, origin.y, origin.z);
 		PxVec3 unit_dir(dir.x, dir.y, dir.z);
 		PxReal max_distance = distance;
@@ -2363,8 +2809,15 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 	}
 
 
+	void onEntitiesMoved(const Entity* entities, int count)
+	{
+		for (int i = 0; i < count; ++i) onEntityMoved(entities[i]);
+	}
+
+
 	void onEntityMoved(Entity entity)
 	{
+		syncSimulation();
 		int ctrl_idx = m_controllers.find(entity);
 		if(ctrl_idx >= 0)
 		{
@@ -2404,6 +2857,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 
 	void heightmapLoaded(Heightfield& terrain)
 	{
+		syncSimulation();
 		PROFILE_FUNCTION();
 		Array<PxHeightFieldSample> heights(m_allocator);
 
@@ -2455,8 +2909,31 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 			hfDesc.samples.stride = sizeof(PxHeightFieldSample);
 			hfDesc.thickness = -1;
 
-			PxHeightField* heightfield = m_system->getPhysics()->createHeightField(hfDesc);
 			float height_scale = bytes_per_pixel == 2 ? 1 / (256 * 256.0f - 1) : 1 / 255.0f;
+
+			// a reload with unchanged dimensions and scales - the common case
+			// when sculpting saves the heightmap - patches the existing
+			// heightfield in place; recooking and recreating the actor would
+			// drop contacts and stall for the whole field
+			if (terrain.m_actor)
+			{
+				PxShape* shape;
+				if (terrain.m_actor->getShapes(&shape, 1) == 1)
+				{
+					PxHeightFieldGeometry geom;
+					if (shape->getHeightFieldGeometry(geom) && (int)geom.heightField->getNbRows() == height &&
+						(int)geom.heightField->getNbColumns() == width &&
+						geom.heightScale == height_scale * terrain.m_y_scale &&
+						geom.rowScale == terrain.m_xz_scale && geom.columnScale == terrain.m_xz_scale)
+					{
+						geom.heightField->modifySamples(0, 0, hfDesc);
+						shape->setGeometry(geom);
+						return;
+					}
+				}
+			}
+
+			PxHeightField* heightfield = m_system->getPhysics()->createHeightField(hfDesc);
 			PxHeightFieldGeometry hfGeom(heightfield,
 				PxMeshGeometryFlags(),
 				height_scale * terrain.m_y_scale,
@@ -2846,6 +3323,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 		serializer.read(&ragdoll.layer);
 
 		setRagdollRoot(ragdoll, deserializeRagdollBone(ragdoll, nullptr, serializer));
+		++m_ragdoll_topology_version;
 		ComponentHandle cmp = {ragdoll.entity.index};
 		m_universe.addComponent(ragdoll.entity, RAGDOLL_TYPE, this, cmp);
 	}
@@ -3452,6 +3930,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 
 	void serialize(OutputBlob& serializer) override
 	{
+		syncSimulation();
 		serializer.write(m_layers_count);
 		serializer.write(m_layers_names);
 		serializer.write(m_collision_filter);
@@ -4085,6 +4564,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 			serializer.read(ragdoll.layer);
 			ragdoll.entity = entity;
 			setRagdollRoot(ragdoll, deserializeRagdollBone(ragdoll, nullptr, serializer));
+			++m_ragdoll_topology_version;
 			ComponentHandle cmp = {ragdoll.entity.index};
 			m_universe.addComponent(ragdoll.entity, RAGDOLL_TYPE, this, cmp);
 		}
@@ -4233,6 +4713,7 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 
 	void deserialize(InputBlob& serializer) override
 	{
+		syncSimulation();
 		serializer.read(m_layers_count);
 		serializer.read(m_layers_names);
 		serializer.read(m_collision_filter);
@@ -4326,27 +4807,60 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 		int m_layer;
 	};
 
+	struct ControllerMove
+	{
+		Vec3 final_pos;
+		bool is_resolved;
+	};
+
 	IAllocator& m_allocator;
 
 	Universe& m_universe;
 	Engine* m_engine;
 	ContactCallback m_contact_callback;
+	Array<ContactData> m_contact_buffer;
+	Array<TriggerData> m_trigger_buffer;
+	DelegateList<void(const ContactData*, int)> m_contact_batch_cb;
 	BoneOrientation m_new_bone_orientation = BoneOrientation::X;
 	PxScene* m_scene;
 	LuaScriptScene* m_script_scene;
 	PhysicsSystem* m_system;
 	PxRigidDynamic* m_dummy_actor;
 	PxControllerManager* m_controller_manager;
+	MTJDCpuDispatcher* m_cpu_dispatcher = nullptr;
 	PxMaterial* m_default_material;
 
 	AssociativeArray<Entity, RigidActor*> m_actors;
 	AssociativeArray<Entity, Ragdoll> m_ragdolls;
+	Array<FlatRagdollBone> m_ragdoll_flat_bones;
+	u32 m_ragdoll_topology_version;
+	u32 m_ragdoll_flat_version;
 	AssociativeArray<Entity, Joint> m_joints;
 	AssociativeArray<Entity, Controller> m_controllers;
+	Array<ControllerMove> m_controller_moves;
 	AssociativeArray<Entity, Heightfield> m_terrains;
 
 	Array<RigidActor*> m_dynamic_actors;
 	bool m_is_game_running;
+	float m_lod_distance;
+	bool m_simulation_in_flight;
+	struct QueuedRaycast
+	{
+		Vec3 origin;
+		Vec3 dir;
+		float distance;
+		Entity ignored;
+	};
+	struct QueuedRaycastResult
+	{
+		RaycastHit hit;
+		bool is_hit;
+	};
+	Array<QueuedRaycast> m_queued_raycasts;
+	Array<QueuedRaycastResult> m_raycast_results;
+	MTJD::Group m_heightfield_job_sync;
+	bool m_heightfield_job_in_flight;
+	Array<u8> m_heightfield_patch_data;
 	bool m_is_updating_ragdoll;
 	u32 m_debug_visualization_flags;
 	Array<QueuedForce> m_queued_forces;
@@ -4359,22 +4873,27 @@ struct PhysicsSceneImpl LUMIX_FINAL : public PhysicsScene
 PhysicsScene* PhysicsScene::create(PhysicsSystem& system, Universe& context, Engine& engine, IAllocator& allocator)
 {
 	PhysicsSceneImpl* impl = LUMIX_NEW(allocator, PhysicsSceneImpl)(context, allocator);
-	impl->m_universe.entityTransformed().bind<PhysicsSceneImpl, &PhysicsSceneImpl::onEntityMoved>(impl);
+	impl->m_universe.entityTransformed().bind<PhysicsSceneImpl, &PhysicsSceneImpl::onEntitiesMoved>(impl);
 	impl->m_engine = &engine;
 	PxSceneDesc sceneDesc(system.getPhysics()->getTolerancesScale());
 	sceneDesc.gravity = PxVec3(0.0f, -9.8f, 0.0f);
-	if (!sceneDesc.cpuDispatcher)
-	{
-		PxDefaultCpuDispatcher* cpu_dispatcher = PxDefaultCpuDispatcherCreate(1);
-		if (!cpu_dispatcher)
-		{
-			g_log_error.log("Physics") << "PxDefaultCpuDispatcherCreate failed!";
-		}
-		sceneDesc.cpuDispatcher = cpu_dispatcher;
-	}
+	impl->m_cpu_dispatcher = LUMIX_NEW(allocator, MTJDCpuDispatcher)(engine.getMTJDManager());
+	sceneDesc.cpuDispatcher = impl->m_cpu_dispatcher;
 
 	sceneDesc.filterShader = impl->filterShader;
 	sceneDesc.simulationEventCallback = &impl->m_contact_callback;
+	sceneDesc.flags |= PxSceneFlag::eENABLE_ACTIVETRANSFORMS;
+
+	// MBP keeps broadphase cost flat when a streamed chunk inserts many actors
+	// at once; the world is covered with a coarse grid of regions and actors
+	// are grouped per region by PhysX
+	sceneDesc.broadPhaseType = PxBroadPhaseType::eMBP;
+	const float WORLD_EXTENT = 8192.0f;
+	const PxU32 REGION_SUBDIV = 4;
+	PxBounds3 world_bounds(PxVec3(-WORLD_EXTENT), PxVec3(WORLD_EXTENT));
+	PxBounds3 region_bounds[REGION_SUBDIV * REGION_SUBDIV];
+	PxU32 region_count = PxBroadPhaseExt::createRegionsFromWorldBounds(region_bounds, world_bounds, REGION_SUBDIV);
+	sceneDesc.limits.maxNbRegions = region_count;
 
 	impl->m_scene = system.getPhysics()->createScene(sceneDesc);
 	if (!impl->m_scene)
@@ -4383,6 +4902,14 @@ PhysicsScene* PhysicsScene::create(PhysicsSystem& system, Universe& context, Eng
 		return nullptr;
 	}
 
+	for (PxU32 i = 0; i < region_count; ++i)
+	{
+		PxBroadPhaseRegion region;
+		region.bounds = region_bounds[i];
+		region.userData = nullptr;
+		impl->m_scene->addBroadPhaseRegion(region);
+	}
+
 	impl->m_controller_manager = PxCreateControllerManager(*impl->m_scene);
 
 	impl->m_system = &system;
@@ -4518,8 +5045,12 @@ void PhysicsScene::registerLuaAPI(lua_State* L)
 	REGISTER_FUNCTION(moveController);
 	REGISTER_FUNCTION(setRagdollKinematic);
 	REGISTER_FUNCTION(addForceAtPos);
+	REGISTER_FUNCTION(queueRaycast);
+	REGISTER_FUNCTION(setLODDistance);
+	REGISTER_FUNCTION(getLODDistance);
 	
 	LuaWrapper::createSystemFunction(L, "Physics", "raycast", &PhysicsSceneImpl::LUA_raycast);
+	LuaWrapper::createSystemFunction(L, "Physics", "getQueuedRaycast", &PhysicsSceneImpl::LUA_getQueuedRaycast);
 
 	#undef REGISTER_FUNCTION
 }
@@ -2,6 +2,7 @@
 
 
 #include "engine/lumix.h"
+#include "engine/delegate_list.h"
 #include "engine/iplugin.h"
 #include "engine/vec.h"
 
@@ -46,6 +47,22 @@ struct RaycastHit
 };
 
 
+struct ContactData
+{
+	Vec3 position;
+	Entity e1;
+	Entity e2;
+};
+
+
+struct TriggerData
+{
+	Entity e1;
+	Entity e2;
+	bool touch_lost;
+};
+
+
 class LUMIX_PHYSICS_API PhysicsScene : public IScene
 {
 public:
@@ -178,6 +195,19 @@ public:
 	virtual void putToSleep(ComponentHandle cmp) = 0;
 
 	virtual void moveController(ComponentHandle cmp, const Vec3& v) = 0;
+	// rays queued during a frame execute as one batch on job workers at the
+	// start of the next physics update; the returned id is valid for polling
+	// during that following frame
+	virtual int queueRaycast(const Vec3& origin, const Vec3& dir, float distance, Entity ignored) = 0;
+	virtual bool getQueuedRaycastResult(int id, RaycastHit& result) = 0;
+	// invoked once per simulated step with the whole frame's contact batch;
+	// listeners iterate the flat array instead of getting a call per contact
+	virtual DelegateList<void(const ContactData*, int)>& onContactBatch() = 0;
+	// props farther than this from the main camera are taken out of the
+	// simulation (dynamic actors) or keyframed (ragdolls) until approached;
+	// FLT_MAX disables the LOD
+	virtual void setLODDistance(float distance) = 0;
+	virtual float getLODDistance() = 0;
 	virtual ComponentHandle getController(Entity entity) = 0;
 	virtual int getControllerLayer(ComponentHandle cmp) = 0;
 	virtual void setControllerLayer(ComponentHandle cmp, int layer) = 0;
@@ -369,7 +369,7 @@ namespace Lumix
 	struct PhysicsSystemImpl LUMIX_FINAL : public PhysicsSystem
 	{
 		explicit PhysicsSystemImpl(Engine& engine)
-			: m_allocator(engine.getAllocator())
+			: m_allocator("physics", engine.getAllocator())
 			, m_engine(engine)
 			, m_manager(*this, engine.getAllocator())
 		{
@@ -2,14 +2,16 @@
 #include "engine/lumix.h"
 
 #include "engine/binary_array.h"
-#include "engine/free_list.h"
 #include "engine/geometry.h"
+#include "engine/math_utils.h"
 #include "engine/profiler.h"
 
 #include "engine/mtjd/group.h"
 #include "engine/mtjd/manager.h"
 #include "engine/mtjd/job.h"
 
+#include <cfloat>
+
 namespace Lumix
 {
 typedef Array<u64> LayerMasks;
@@ -18,19 +20,79 @@ typedef Array<ComponentHandle> SphereToModelInstanceMap;
 
 static const int MIN_ENTITIES_PER_THREAD = 50;
 
-static void doCulling(int start_index,
-	const Sphere* LUMIX_RESTRICT start,
-	const Sphere* LUMIX_RESTRICT end,
+#ifdef LUMIX_SIMD_AVX2
+static LUMIX_TARGET_AVX2 void doCullingLeafAVX2(const int* LUMIX_RESTRICT indices,
+	int count,
+	const Sphere* LUMIX_RESTRICT spheres,
+	const Frustum* LUMIX_RESTRICT frustum,
+	const u64* LUMIX_RESTRICT layer_masks,
+	const ComponentHandle* LUMIX_RESTRICT sphere_to_model_instance_map,
+	u64 layer_mask,
+	CullingSystem::Subresults& results)
+{
+	// all eight planes in one register; the frustum is only 16-aligned, hence
+	// the unaligned loads
+	float8 px = f8LoadUnaligned(frustum->xs);
+	float8 py = f8LoadUnaligned(frustum->ys);
+	float8 pz = f8LoadUnaligned(frustum->zs);
+	float8 pd = f8LoadUnaligned(frustum->ds);
+
+	for (int i = 0; i < count; ++i)
+	{
+		int idx = indices[i];
+		const Sphere& sphere = spheres[idx];
+		float8 cx = f8Splat(sphere.position.x);
+		float8 cy = f8Splat(sphere.position.y);
+		float8 cz = f8Splat(sphere.position.z);
+
+		float8 t = f8Fmadd(cx, px, pd);
+		t = f8Fmadd(cy, py, t);
+		t = f8Fmadd(cz, pz, t);
+		t = f8Sub(t, f8Splat(-sphere.radius));
+		if (f8MoveMask(t)) continue;
+
+		if (layer_masks[idx] & layer_mask) results.push(sphere_to_model_instance_map[idx]);
+	}
+}
+#endif
+
+
+static void doCullingLeaf(const int* LUMIX_RESTRICT indices,
+	int count,
+	const Sphere* LUMIX_RESTRICT spheres,
 	const Frustum* LUMIX_RESTRICT frustum,
 	const u64* LUMIX_RESTRICT layer_masks,
 	const ComponentHandle* LUMIX_RESTRICT sphere_to_model_instance_map,
 	u64 layer_mask,
+	bool fully_inside,
 	CullingSystem::Subresults& results)
 {
-	PROFILE_FUNCTION();
-	int i = start_index;
-	ASSERT(results.empty());
-	PROFILE_INT("objects", int(end - start));
+	if (fully_inside)
+	{
+		// the leaf bounds passed the frustum whole, only the layers filter
+		for (int i = 0; i < count; ++i)
+		{
+			int idx = indices[i];
+			if (layer_masks[idx] & layer_mask) results.push(sphere_to_model_instance_map[idx]);
+		}
+		return;
+	}
+
+#ifdef LUMIX_SIMD_AVX2
+	if (hasAVX2())
+	{
+		doCullingLeafAVX2(indices,
+			count,
+			spheres,
+			frustum,
+			layer_masks,
+			sphere_to_model_instance_map,
+			layer_mask,
+			results);
+		return;
+	}
+#endif
+
 	float4 px = f4Load(frustum->xs);
 	float4 py = f4Load(frustum->ys);
 	float4 pz = f4Load(frustum->zs);
@@ -39,13 +101,15 @@ static void doCulling(int start_index,
 	float4 py2 = f4Load(&frustum->ys[4]);
 	float4 pz2 = f4Load(&frustum->zs[4]);
 	float4 pd2 = f4Load(&frustum->ds[4]);
-	
-	for (const Sphere *sphere = start; sphere <= end; sphere++, ++i)
+
+	for (int i = 0; i < count; ++i)
 	{
-		float4 cx = f4Splat(sphere->position.x);
-		float4 cy = f4Splat(sphere->position.y);
-		float4 cz = f4Splat(sphere->position.z);
-		float4 r = f4Splat(-sphere->radius);
+		int idx = indices[i];
+		const Sphere& sphere = spheres[idx];
+		float4 cx = f4Splat(sphere.position.x);
+		float4 cy = f4Splat(sphere.position.y);
+		float4 cz = f4Splat(sphere.position.z);
+		float4 r = f4Splat(-sphere.radius);
 
 		float4 t = f4Mul(cx, px);
 		t = f4Add(t, f4Mul(cy, py));
@@ -61,36 +125,295 @@ static void doCulling(int start_index,
 		t = f4Sub(t, r);
 		if (f4MoveMask(t)) continue;
 
-		if(layer_masks[i] & layer_mask) results.push(sphere_to_model_instance_map[i]);
+		if (layer_masks[idx] & layer_mask) results.push(sphere_to_model_instance_map[idx]);
 	}
 }
 
+
+// Bounding volume hierarchy over the sphere array. Leaves own contiguous
+// ranges of m_order, internal nodes keep their left child at node + 1 and
+// store the right child index. Topology changes (add/remove) mark the tree
+// dirty and it is rebuilt on the next cull; a moved sphere only refits its
+// leaf and the ancestors. Culling collects candidate leaf ranges, so the
+// per-sphere tests scale with the visible set instead of the scene size.
+struct SphereBVH
+{
+	enum { LEAF_SIZE = 64 };
+
+	enum
+	{
+		OUTSIDE = 0,
+		INTERSECT,
+		INSIDE
+	};
+
+	struct Node
+	{
+		Vec3 min;
+		Vec3 max;
+		int first; // leaf: start in m_order; internal: right child index
+		int count; // 0 for internal nodes
+		int parent;
+	};
+
+	struct Range
+	{
+		int first;
+		int count;
+		bool fully_inside;
+	};
+
+	explicit SphereBVH(IAllocator& allocator)
+		: m_nodes(allocator)
+		, m_order(allocator)
+		, m_sphere_to_leaf(allocator)
+		, m_is_dirty(true)
+	{
+	}
+
+
+	static float axisValue(const Sphere& sphere, int axis)
+	{
+		return (&sphere.position.x)[axis];
+	}
+
+
+	void computeBounds(int node_index, const CullingSystem::InputSpheres& spheres)
+	{
+		Node& node = m_nodes[node_index];
+		Vec3 min_b(FLT_MAX, FLT_MAX, FLT_MAX);
+		Vec3 max_b(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (int i = node.first, end = node.first + node.count; i < end; ++i)
+		{
+			const Sphere& sphere = spheres[m_order[i]];
+			min_b.x = Math::minimum(min_b.x, sphere.position.x - sphere.radius);
+			min_b.y = Math::minimum(min_b.y, sphere.position.y - sphere.radius);
+			min_b.z = Math::minimum(min_b.z, sphere.position.z - sphere.radius);
+			max_b.x = Math::maximum(max_b.x, sphere.position.x + sphere.radius);
+			max_b.y = Math::maximum(max_b.y, sphere.position.y + sphere.radius);
+			max_b.z = Math::maximum(max_b.z, sphere.position.z + sphere.radius);
+		}
+		node.min = min_b;
+		node.max = max_b;
+	}
+
+
+	// Hoare quickselect; puts the median of the centroids on the split axis at
+	// indices[mid], smaller values before it. A median split keeps the tree
+	// balanced, so the traversal stack depth stays logarithmic
+	void selectMedian(int* indices, int count, int mid, int axis, const CullingSystem::InputSpheres& spheres)
+	{
+		int left = 0;
+		int right = count - 1;
+		while (left < right)
+		{
+			float pivot = axisValue(spheres[indices[(left + right) / 2]], axis);
+			int i = left;
+			int j = right;
+			while (i <= j)
+			{
+				while (axisValue(spheres[indices[i]], axis) < pivot) ++i;
+				while (axisValue(spheres[indices[j]], axis) > pivot) --j;
+				if (i <= j)
+				{
+					int tmp = indices[i];
+					indices[i] = indices[j];
+					indices[j] = tmp;
+					++i;
+					--j;
+				}
+			}
+			if (mid <= j) right = j;
+			else if (mid >= i) left = i;
+			else break;
+		}
+	}
+
+
+	int buildNode(int first, int count, int parent, const CullingSystem::InputSpheres& spheres)
+	{
+		int node_index = m_nodes.size();
+		{
+			Node& node = m_nodes.emplace();
+			node.first = first;
+			node.count = count;
+			node.parent = parent;
+		}
+		computeBounds(node_index, spheres);
+
+		if (count <= LEAF_SIZE)
+		{
+			for (int i = first, end = first + count; i < end; ++i)
+			{
+				m_sphere_to_leaf[m_order[i]] = node_index;
+			}
+			return node_index;
+		}
+
+		Vec3 size = m_nodes[node_index].max - m_nodes[node_index].min;
+		int axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+		int mid = count / 2;
+		selectMedian(&m_order[first], count, mid, axis, spheres);
+
+		m_nodes[node_index].count = 0;
+		buildNode(first, mid, node_index, spheres);
+		int right = buildNode(first + mid, count - mid, node_index, spheres);
+		m_nodes[node_index].first = right;
+		return node_index;
+	}
+
+
+	void build(const CullingSystem::InputSpheres& spheres)
+	{
+		PROFILE_FUNCTION();
+		m_nodes.clear();
+		m_order.resize(spheres.size());
+		m_sphere_to_leaf.resize(spheres.size());
+		for (int i = 0; i < m_order.size(); ++i) m_order[i] = i;
+		if (!spheres.empty())
+		{
+			m_nodes.reserve(2 * (spheres.size() / LEAF_SIZE + 1));
+			buildNode(0, spheres.size(), -1, spheres);
+		}
+		m_is_dirty = false;
+	}
+
+
+	void refit(int sphere_index, const CullingSystem::InputSpheres& spheres)
+	{
+		if (m_is_dirty) return;
+
+		int node_index = m_sphere_to_leaf[sphere_index];
+		computeBounds(node_index, spheres);
+		node_index = m_nodes[node_index].parent;
+		while (node_index >= 0)
+		{
+			Node& node = m_nodes[node_index];
+			const Node& left = m_nodes[node_index + 1];
+			const Node& right = m_nodes[node.first];
+			node.min.x = Math::minimum(left.min.x, right.min.x);
+			node.min.y = Math::minimum(left.min.y, right.min.y);
+			node.min.z = Math::minimum(left.min.z, right.min.z);
+			node.max.x = Math::maximum(left.max.x, right.max.x);
+			node.max.y = Math::maximum(left.max.y, right.max.y);
+			node.max.z = Math::maximum(left.max.z, right.max.z);
+			node_index = node.parent;
+		}
+	}
+
+
+	static int classify(const Frustum& frustum, const Vec3& min, const Vec3& max)
+	{
+		int result = INSIDE;
+		for (int i = 0; i < lengthOf(frustum.xs); ++i)
+		{
+			float x = frustum.xs[i];
+			float y = frustum.ys[i];
+			float z = frustum.zs[i];
+			float d = frustum.ds[i];
+
+			// the box vertex furthest along the plane normal decides outside,
+			// the nearest one decides fully inside
+			float px = x >= 0 ? max.x : min.x;
+			float py = y >= 0 ? max.y : min.y;
+			float pz = z >= 0 ? max.z : min.z;
+			if (x * px + y * py + z * pz + d < 0) return OUTSIDE;
+
+			float nx = x >= 0 ? min.x : max.x;
+			float ny = y >= 0 ? min.y : max.y;
+			float nz = z >= 0 ? min.z : max.z;
+			if (x * nx + y * ny + z * nz + d < 0) result = INTERSECT;
+		}
+		return result;
+	}
+
+
+	void cull(const Frustum& frustum, Array<Range>& ranges) const
+	{
+		PROFILE_FUNCTION();
+		if (m_nodes.empty()) return;
+
+		struct StackEntry
+		{
+			int node;
+			bool inside;
+		};
+		StackEntry stack[64];
+		int stack_size = 0;
+		stack[stack_size].node = 0;
+		stack[stack_size].inside = false;
+		++stack_size;
+
+		while (stack_size > 0)
+		{
+			--stack_size;
+			int node_index = stack[stack_size].node;
+			bool inside = stack[stack_size].inside;
+			const Node& node = m_nodes[node_index];
+
+			if (!inside)
+			{
+				int c = classify(frustum, node.min, node.max);
+				if (c == OUTSIDE) continue;
+				inside = c == INSIDE;
+			}
+
+			if (node.count > 0)
+			{
+				Range& range = ranges.emplace();
+				range.first = node.first;
+				range.count = node.count;
+				range.fully_inside = inside;
+				continue;
+			}
+
+			ASSERT(stack_size + 2 <= (int)lengthOf(stack));
+			stack[stack_size].node = node_index + 1;
+			stack[stack_size].inside = inside;
+			++stack_size;
+			stack[stack_size].node = node.first;
+			stack[stack_size].inside = inside;
+			++stack_size;
+		}
+	}
+
+
+	Array<Node> m_nodes;
+	Array<int> m_order;
+	Array<int> m_sphere_to_leaf;
+	bool m_is_dirty;
+};
+
+
 class CullingJob LUMIX_FINAL : public MTJD::Job
 {
 public:
 	CullingJob(const CullingSystem::InputSpheres& spheres,
+		const SphereBVH& bvh,
+		const Array<SphereBVH::Range>& ranges,
+		int first_range,
+		int last_range,
 		const LayerMasks& layer_masks,
 		const SphereToModelInstanceMap& sphere_to_model_instance_map,
 		u64 layer_mask,
 		CullingSystem::Subresults& results,
-		int start,
-		int end,
 		const Frustum& frustum,
 		MTJD::Manager& manager,
 		IAllocator& allocator,
 		IAllocator& job_allocator)
 		: Job(Job::AUTO_DESTROY, MTJD::Priority::Default, manager, allocator, job_allocator)
 		, m_spheres(spheres)
+		, m_bvh(bvh)
+		, m_ranges(ranges)
+		, m_first_range(first_range)
+		, m_last_range(last_range)
 		, m_results(results)
-		, m_start(start)
-		, m_end(end)
 		, m_frustum(frustum)
 		, m_layer_masks(layer_masks)
 		, m_layer_mask(layer_mask)
 		, m_sphere_to_model_instance_map(sphere_to_model_instance_map)
 	{
 		setJobName("CullingJob");
-		m_results.reserve(end - start);
 		ASSERT(m_results.empty());
 		m_is_executed = false;
 	}
@@ -99,26 +422,34 @@ public:
 
 	void execute() override
 	{
+		PROFILE_FUNCTION();
 		ASSERT(m_results.empty() && !m_is_executed);
-		doCulling(m_start,
-			&m_spheres[m_start],
-			&m_spheres[m_end],
-			&m_frustum,
-			&m_layer_masks[0],
-			&m_sphere_to_model_instance_map[0],
-			m_layer_mask,
-			m_results);
+		for (int i = m_first_range; i <= m_last_range; ++i)
+		{
+			const SphereBVH::Range& range = m_ranges[i];
+			doCullingLeaf(&m_bvh.m_order[range.first],
+				range.count,
+				&m_spheres[0],
+				&m_frustum,
+				&m_layer_masks[0],
+				&m_sphere_to_model_instance_map[0],
+				m_layer_mask,
+				range.fully_inside,
+				m_results);
+		}
 		m_is_executed = true;
 	}
 
 private:
 	const CullingSystem::InputSpheres& m_spheres;
+	const SphereBVH& m_bvh;
+	const Array<SphereBVH::Range>& m_ranges;
 	CullingSystem::Subresults& m_results;
 	const LayerMasks& m_layer_masks;
 	const SphereToModelInstanceMap& m_sphere_to_model_instance_map;
 	u64 m_layer_mask;
-	int m_start;
-	int m_end;
+	int m_first_range;
+	int m_last_range;
 	const Frustum& m_frustum;
 	bool m_is_executed;
 };
@@ -128,7 +459,6 @@ class CullingSystemImpl LUMIX_FINAL : public CullingSystem
 public:
 	CullingSystemImpl(MTJD::Manager& mtjd_manager, IAllocator& allocator)
 		: m_allocator(allocator)
-		, m_job_allocator(allocator)
 		, m_spheres(allocator)
 		, m_result(allocator)
 		, m_sync_point(true, allocator)
@@ -136,6 +466,8 @@ public:
 		, m_layer_masks(m_allocator)
 		, m_sphere_to_model_instance_map(m_allocator)
 		, m_model_instance_to_sphere_map(m_allocator)
+		, m_bvh(m_allocator)
+		, m_ranges(m_allocator)
 	{
 		m_result.emplace(m_allocator);
 		m_model_instance_to_sphere_map.reserve(5000);
@@ -155,6 +487,7 @@ public:
 		m_layer_masks.clear();
 		m_model_instance_to_sphere_map.clear();
 		m_sphere_to_model_instance_map.clear();
+		m_bvh.m_is_dirty = true;
 	}
 
 
@@ -171,21 +504,37 @@ public:
 	}
 
 
+	const Results& peekResult() override { return m_result; }
+
+
+	// rebuilds the tree if the topology changed and collects the candidate
+	// leaf ranges; everything outside the frustum is rejected here in bulk
+	void collectRanges(const Frustum& frustum)
+	{
+		if (m_bvh.m_is_dirty) m_bvh.build(m_spheres);
+		m_ranges.clear();
+		m_bvh.cull(frustum, m_ranges);
+	}
+
+
+
 	void cullToFrustum(const Frustum& frustum, u64 layer_mask) override
 	{
 		for (int i = 0; i < m_result.size(); ++i)
 		{
 			m_result[i].clear();
 		}
-		if (!m_spheres.empty())
+		collectRanges(frustum);
+		for (const SphereBVH::Range& range : m_ranges)
 		{
-			doCulling(0,
+			doCullingLeaf(&m_bvh.m_order[range.first],
+				range.count,
 				&m_spheres[0],
-				&m_spheres.back(),
 				&frustum,
 				&m_layer_masks[0],
 				&m_sphere_to_model_instance_map[0],
 				layer_mask,
+				range.fully_inside,
 				m_result[0]);
 		}
 		m_is_async_result = false;
@@ -194,67 +543,96 @@ public:
 
 	void cullToFrustumAsync(const Frustum& frustum, u64 layer_mask) override
 	{
-		int count = m_spheres.size();
+		cullToFrustumAsync(frustum, layer_mask, nullptr, 0);
+	}
+
+
+	void cullToFrustumAsync(const Frustum& frustum,
+		u64 layer_mask,
+		MTJD::Job* const* continuations,
+		int continuations_count) override
+	{
 		for(auto& i : m_result)
 		{
 			i.clear();
 		}
 
-		if (count == 0)
-		{
-			m_is_async_result = false;
-			return;
-		}
+		collectRanges(frustum);
+		int candidate_count = 0;
+		for (const SphereBVH::Range& range : m_ranges) candidate_count += range.count;
 
-		if (count < m_result.size() * MIN_ENTITIES_PER_THREAD)
+		if (candidate_count == 0 || candidate_count < m_result.size() * MIN_ENTITIES_PER_THREAD)
 		{
-			cullToFrustum(frustum, layer_mask);
+			for (const SphereBVH::Range& range : m_ranges)
+			{
+				doCullingLeaf(&m_bvh.m_order[range.first],
+					range.count,
+					&m_spheres[0],
+					&frustum,
+					&m_layer_masks[0],
+					&m_sphere_to_model_instance_map[0],
+					layer_mask,
+					range.fully_inside,
+					m_result[0]);
+			}
+			m_is_async_result = false;
+			for (int i = 0; i < continuations_count; ++i)
+			{
+				m_mtjd_manager.schedule(continuations[i]);
+			}
 			return;
 		}
 		m_is_async_result = true;
 
+		// leaf ranges are dealt out so every job tests about the same number
+		// of candidate spheres
 		int cpu_count = m_mtjd_manager.getCpuThreadsCount();
-		int step = count / cpu_count;
-		int i = 0;
 		CullingJob* jobs[16];
 		ASSERT(lengthOf(jobs) >= cpu_count);
-		for (; i < cpu_count - 1; i++)
+		int per_job = candidate_count / cpu_count;
+		int first_range = 0;
+		int job_count = 0;
+		for (int i = 0; i < cpu_count && first_range < m_ranges.size(); ++i)
 		{
-			m_result[i].clear();
-			CullingJob* cj = LUMIX_NEW(m_job_allocator, CullingJob)(m_spheres,
+			int last_range = first_range;
+			int job_spheres = m_ranges[last_range].count;
+			while (i < cpu_count - 1 && last_range + 1 < m_ranges.size() && job_spheres < per_job)
+			{
+				++last_range;
+				job_spheres += m_ranges[last_range].count;
+			}
+			if (i == cpu_count - 1) last_range = m_ranges.size() - 1;
+
+			m_result[i].reserve(job_spheres);
+			IAllocator& job_allocator = m_mtjd_manager.getJobAllocator();
+			CullingJob* cj = LUMIX_NEW(job_allocator, CullingJob)(m_spheres,
+				m_bvh,
+				m_ranges,
+				first_range,
+				last_range,
 				m_layer_masks,
 				m_sphere_to_model_instance_map,
 				layer_mask,
 				m_result[i],
-				i * step,
-				(i + 1) * step - 1,
 				frustum,
 				m_mtjd_manager,
 				m_allocator,
-				m_job_allocator);
+				job_allocator);
 			cj->addDependency(&m_sync_point);
-			jobs[i] = cj;
+			if (i < continuations_count) cj->then(continuations[i]);
+			jobs[job_count] = cj;
+			++job_count;
+			first_range = last_range + 1;
 		}
 
-		m_result[i].clear();
-		CullingJob* cj = LUMIX_NEW(m_job_allocator, CullingJob)(m_spheres,
-			m_layer_masks,
-			m_sphere_to_model_instance_map,
-			layer_mask,
-			m_result[i],
-			i * step,
-			count - 1,
-			frustum,
-			m_mtjd_manager,
-			m_allocator,
-			m_job_allocator);
-		cj->addDependency(&m_sync_point);
-		jobs[i] = cj;
-
-		for (i = 0; i < cpu_count; ++i)
+		for (int i = 0; i < job_count; ++i)
 		{
 			m_mtjd_manager.schedule(jobs[i]);
 		}
+		for (int i = job_count; i < continuations_count; ++i)
+		{
+			m_mtjd_manager.schedule(continuations[i]);
+		}
 	}
 
 
@@ -293,6 +671,7 @@ public:
 		}
 		m_model_instance_to_sphere_map[model_instance.index] = m_spheres.size() - 1;
 		m_layer_masks.push(layer_mask);
+		m_bvh.m_is_dirty = true;
 	}
 
 
@@ -311,13 +690,18 @@ public:
 		m_sphere_to_model_instance_map.pop();
 		m_layer_masks.pop();
 		m_model_instance_to_sphere_map[model_instance.index] = -1;
+		m_bvh.m_is_dirty = true;
 	}
 
 
 	void updateBoundingSphere(const Sphere& sphere, ComponentHandle model_instance) override
 	{
 		int idx = m_model_instance_to_sphere_map[model_instance.index];
-		if (idx >= 0) m_spheres[idx] = sphere;
+		if (idx < 0) return;
+		m_spheres[idx] = sphere;
+		// dynamics stay in place in the tree, only the bounds on their path to
+		// the root grow; the tree never degrades structurally
+		m_bvh.refit(idx, m_spheres);
 	}
 
 
@@ -334,6 +718,7 @@ public:
 			m_sphere_to_model_instance_map.push(model_instances[i]);
 			m_layer_masks.push(1);
 		}
+		m_bvh.m_is_dirty = true;
 	}
 
 
@@ -345,12 +730,13 @@ public:
 
 private:
 	IAllocator& m_allocator;
-	FreeList<CullingJob, 16> m_job_allocator;
 	InputSpheres m_spheres;
 	Results m_result;
 	LayerMasks m_layer_masks;
 	ModelInstancetoSphereMap m_model_instance_to_sphere_map;
 	SphereToModelInstanceMap m_sphere_to_model_instance_map;
+	SphereBVH m_bvh;
+	Array<SphereBVH::Range> m_ranges;
 
 	MTJD::Manager& m_mtjd_manager;
 	MTJD::Group m_sync_point;
@@ -368,4 +754,4 @@ void CullingSystem::destroy(CullingSystem& culling_system)
 {
 	LUMIX_DELETE(static_cast<CullingSystemImpl&>(culling_system).getAllocator(), &culling_system);
 }
-}
\ No newline at end of file
+}
@@ -14,6 +14,7 @@ namespace Lumix
 
 	namespace MTJD
 	{
+		class Job;
 		class Manager;
 	}
 	struct Frustum;
@@ -33,9 +34,18 @@ namespace Lumix
 
 		virtual void clear() = 0;
 		virtual const Results& getResult() = 0;
+		// result arrays without waiting for in-flight culling jobs; only safe
+		// to read from a continuation chained after those jobs
+		virtual const Results& peekResult() = 0;
 
 		virtual void cullToFrustum(const Frustum& frustum, u64 layer_mask) = 0;
 		virtual void cullToFrustumAsync(const Frustum& frustum, u64 layer_mask) = 0;
+		// chains continuations[i] after the job filling the i-th subresult, so
+		// dependent work runs on workers without a blocking getResult()
+		virtual void cullToFrustumAsync(const Frustum& frustum,
+			u64 layer_mask,
+			MTJD::Job* const* continuations,
+			int continuations_count) = 0;
 
 		virtual bool isAdded(ComponentHandle model_instance) = 0;
 		virtual void addStatic(ComponentHandle model_instance, const Sphere& sphere, u64 layer_mask) = 0;
@@ -19,8 +19,11 @@
 #include "engine/log.h"
 #include "engine/lua_wrapper.h"
 #include "engine/math_utils.h"
+#include "engine/mt/atomic.h"
 #include "engine/mt/task.h"
 #include "engine/mt/thread.h"
+#include "engine/mtjd/generic_job.h"
+#include "engine/mtjd/group.h"
 #include "engine/path_utils.h"
 #include "engine/plugin_manager.h"
 #include "engine/property_register.h"
@@ -720,18 +723,27 @@ static bool saveAsDDS(ImportAssetDialog& dialog,
 	int image_height,
 	bool alpha,
 	bool normal,
-	const char* dest_path)
+	const char* dest_path,
+	bool with_progress)
 {
 	ASSERT(image_data);
 
 	dialog.setImportMessage(StaticString<MAX_PATH_LENGTH + 30>("Saving ") << dest_path, 0);
 
-	dialog.getDDSConvertCallbackData().dialog = &dialog;
-	dialog.getDDSConvertCallbackData().dest_path = dest_path;
-	dialog.getDDSConvertCallbackData().cancel_requested = false;
-
 	crn_uint32 size;
 	crn_comp_params comp_params = s_default_comp_params;
+	if (with_progress)
+	{
+		dialog.getDDSConvertCallbackData().dialog = &dialog;
+		dialog.getDDSConvertCallbackData().dest_path = dest_path;
+		dialog.getDDSConvertCallbackData().cancel_requested = false;
+	}
+	else
+	{
+		// concurrent compressions must not share the dialog's progress state
+		comp_params.m_pProgress_func = nullptr;
+		comp_params.m_pProgress_func_data = nullptr;
+	}
 	comp_params.m_width = image_width;
 	comp_params.m_height = image_height;
 	comp_params.m_format = normal ? cCRNFmtDXN_YX : (alpha ? cCRNFmtDXT5 : cCRNFmtDXT1);
@@ -761,6 +773,86 @@ static bool saveAsDDS(ImportAssetDialog& dialog,
 }
 
 
+// compresses each layer the same way saveAsDDS does and splices the results into
+// one dds with a DX10 header and arraySize > 1; bgfx loads these as texture
+// arrays, so materials can share the texture and differ only by a layer index
+static bool saveAsLayeredDDS(ImportAssetDialog& dialog,
+	const Array<u8*>& layers,
+	int image_width,
+	int image_height,
+	bool alpha,
+	bool normal,
+	const char* dest_path)
+{
+	ASSERT(!layers.empty());
+
+	dialog.setImportMessage(StaticString<MAX_PATH_LENGTH + 30>("Saving ") << dest_path, 0);
+
+	dialog.getDDSConvertCallbackData().dialog = &dialog;
+	dialog.getDDSConvertCallbackData().dest_path = dest_path;
+	dialog.getDDSConvertCallbackData().cancel_requested = false;
+
+	crn_comp_params comp_params = s_default_comp_params;
+	comp_params.m_width = image_width;
+	comp_params.m_height = image_height;
+	comp_params.m_format = normal ? cCRNFmtDXN_YX : (alpha ? cCRNFmtDXT5 : cCRNFmtDXT1);
+	crn_mipmap_params mipmap_params;
+	mipmap_params.m_mode = cCRNMipModeGenerateMips;
+
+	static const int DDS_HEADER_SIZE = 128;
+	Array<void*> blobs(dialog.getEditor().getAllocator());
+	crn_uint32 layer_size = 0;
+	for (u8* layer : layers)
+	{
+		comp_params.m_pImages[0][0] = (u32*)layer;
+		crn_uint32 size;
+		void* data = crn_compress(comp_params, mipmap_params, size);
+		if (!data || size <= DDS_HEADER_SIZE || (!blobs.empty() && size != layer_size))
+		{
+			dialog.setMessage(StaticString<MAX_PATH_LENGTH + 30>("Could not convert ") << dest_path);
+			if (data) crn_free_block(data);
+			for (void* blob : blobs) crn_free_block(blob);
+			return false;
+		}
+		layer_size = size;
+		blobs.push(data);
+	}
+
+	FS::OsFile file;
+	if (!file.open(dest_path, FS::Mode::CREATE_AND_WRITE, dialog.getEditor().getAllocator()))
+	{
+		dialog.setMessage(StaticString<MAX_PATH_LENGTH + 30>("Could not save ") << dest_path);
+		for (void* blob : blobs) crn_free_block(blob);
+		return false;
+	}
+
+	// reuse the legacy header crnlib wrote for the first layer, but route the
+	// pixel format through the DX10 extension since that is the only dds
+	// variant with an array size
+	u8 header[DDS_HEADER_SIZE];
+	copyMemory(header, blobs[0], DDS_HEADER_SIZE);
+	*(u32*)(header + 80) = 0x4; // ddspf.dwFlags = DDPF_FOURCC
+	*(u32*)(header + 84) = 0x30315844; // ddspf.dwFourCC = "DX10"
+
+	u32 dx10_header[5];
+	dx10_header[0] = normal ? 83 : (alpha ? 77 : 71); // DXGI_FORMAT_BC5/BC3/BC1_UNORM
+	dx10_header[1] = 3; // DDS_DIMENSION_TEXTURE2D
+	dx10_header[2] = 0;
+	dx10_header[3] = layers.size();
+	dx10_header[4] = 0;
+
+	file.write((const char*)header, sizeof(header));
+	file.write((const char*)dx10_header, sizeof(dx10_header));
+	for (void* blob : blobs)
+	{
+		file.write((const char*)blob + DDS_HEADER_SIZE, layer_size - DDS_HEADER_SIZE);
+	}
+	file.close();
+	for (void* blob : blobs) crn_free_block(blob);
+	return true;
+}
+
+
 struct ImportTextureTask LUMIX_FINAL : public MT::Task
 {
 	explicit ImportTextureTask(ImportAssetDialog& dialog)
@@ -823,24 +915,26 @@ struct ImportTextureTask LUMIX_FINAL : public MT::Task
 			dest_path,
 			lengthOf(dest_path));
 
+		bool success = true;
 		if (m_dialog.m_convert_to_dds)
 		{
 			m_dialog.setImportMessage("Converting to DDS...", 0);
 
-			saveAsDDS(m_dialog,
+			success = saveAsDDS(m_dialog,
 				m_dialog.m_source,
 				m_dialog.m_image.data,
 				m_dialog.m_image.width,
 				m_dialog.m_image.height,
 				m_dialog.m_image.comps == 4,
 				m_dialog.m_is_normal_map,
-				dest_path);
+				dest_path,
+				true);
 		}
 		else if (m_dialog.m_convert_to_raw)
 		{
 			m_dialog.setImportMessage("Converting to RAW...", -1);
 
-			saveAsRaw(m_dialog,
+			success = saveAsRaw(m_dialog,
 				m_dialog.m_editor.getEngine().getFileSystem(),
 				m_dialog.m_image.data,
 				m_dialog.m_image.width,
@@ -855,12 +949,14 @@ struct ImportTextureTask LUMIX_FINAL : public MT::Task
 
 			if (!copyFile(m_dialog.m_source, dest_path))
 			{
+				success = false;
 				m_dialog.setMessage(StaticString<MAX_PATH_LENGTH * 2 + 30>("Could not copy ")
 									<< m_dialog.m_source
 									<< " to "
 									<< dest_path);
 			}
 		}
+		m_dialog.m_task_succeeded = success;
 		stbi_image_free(m_dialog.m_image.data);
 		m_dialog.m_image.data = nullptr;
 
@@ -873,6 +969,70 @@ struct ImportTextureTask LUMIX_FINAL : public MT::Task
 }; // struct ImportTextureTask
 
 
+struct ImportTextureArrayTask LUMIX_FINAL : public MT::Task
+{
+	explicit ImportTextureArrayTask(ImportAssetDialog& dialog)
+		: Task(dialog.m_editor.getAllocator())
+		, m_dialog(dialog)
+	{
+	}
+
+
+	int task() override
+	{
+		m_dialog.setImportMessage("Importing texture array...", 0);
+
+		IAllocator& allocator = m_dialog.m_editor.getAllocator();
+		Array<u8*> layers(allocator);
+		int width = 0;
+		int height = 0;
+		bool alpha = false;
+		for (auto& src : m_dialog.m_texture_array_sources)
+		{
+			int w, h, comps;
+			u8* data = stbi_load(src, &w, &h, &comps, 4);
+			if (!data)
+			{
+				m_dialog.setMessage(
+					StaticString<MAX_PATH_LENGTH + 200>("Could not load ") << src << " : " << stbi_failure_reason());
+			}
+			else if (!layers.empty() && (w != width || h != height))
+			{
+				m_dialog.setMessage(StaticString<MAX_PATH_LENGTH + 200>(src)
+									<< " is " << w << " x " << h << ", layers must all be " << width << " x "
+									<< height);
+				stbi_image_free(data);
+				data = nullptr;
+			}
+			if (!data)
+			{
+				for (u8* layer : layers) stbi_image_free(layer);
+				return -1;
+			}
+			width = w;
+			height = h;
+			alpha = alpha || comps == 4;
+			layers.push(data);
+		}
+
+		char basename[MAX_PATH_LENGTH];
+		PathUtils::getBasename(basename, sizeof(basename), m_dialog.m_texture_array_sources[0]);
+		PathBuilder dest_path(m_dialog.m_output_dir);
+		dest_path << "/" << basename << "_array.dds";
+
+		m_dialog.setImportMessage("Converting to DDS...", 0);
+		saveAsLayeredDDS(m_dialog, layers, width, height, alpha, m_dialog.m_is_normal_map, dest_path);
+
+		for (u8* layer : layers) stbi_image_free(layer);
+		return 0;
+	}
+
+
+	ImportAssetDialog& m_dialog;
+
+}; // struct ImportTextureArrayTask
+
+
 struct ImportTask LUMIX_FINAL : public MT::Task
 {
 	struct ProgressHandler LUMIX_FINAL : public Assimp::ProgressHandler
@@ -1066,11 +1226,20 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 	};
 
 
+	struct PendingTexture
+	{
+		StaticString<MAX_PATH_LENGTH> src;
+		StaticString<MAX_PATH_LENGTH> dest;
+		bool is_normal_map;
+	};
+
+
 	ConvertTask(ImportAssetDialog& dialog, float scale)
 		: Task(dialog.m_editor.getAllocator())
 		, m_dialog(dialog)
 		, m_scale(scale)
 		, m_nodes(dialog.m_editor.getAllocator())
+		, m_pending_textures(dialog.m_editor.getAllocator())
 	{
 	}
 
@@ -1079,7 +1248,7 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 		const char* source_mesh_dir,
 		FS::OsFile& material_file,
 		bool is_normal_map,
-		bool is_srgb) const
+		bool is_srgb)
 	{
 		PathUtils::FileInfo texture_info(texture.src);
 		material_file << ",\n\t\"texture\" : {\n\t\t\"source\" : \"";
@@ -1103,30 +1272,13 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 		dest << "/" << texture_info.m_basename << (texture.to_dds ? ".dds" : texture_info.m_extension);
 		if (texture.to_dds && !is_src_dds)
 		{
-			int image_width, image_height, image_comp;
-			auto data = stbi_load(texture.src, &image_width, &image_height, &image_comp, 4);
-			if (!data)
-			{
-				StaticString<MAX_PATH_LENGTH + 20> error_msg("Could not load image ", texture.src);
-				m_dialog.setMessage(error_msg);
-				return false;
-			}
-
-			if (!saveAsDDS(m_dialog,
-					texture.src,
-					data,
-					image_width,
-					image_height,
-					image_comp == 4,
-					is_normal_map,
-					dest))
-			{
-				stbi_image_free(data);
-				m_dialog.setMessage(StaticString<MAX_PATH_LENGTH * 2 + 20>(
-					"Error converting ", texture.src, " to ", dest));
-				return false;
-			}
-			stbi_image_free(data);
+			// compressions are independent of the material files, which only
+			// reference the destination path, so they are queued and run as
+			// parallel jobs once every material is written
+			PendingTexture& pending = m_pending_textures.emplace();
+			pending.src = texture.src;
+			pending.dest = dest;
+			pending.is_normal_map = is_normal_map;
 		}
 		else
 		{
@@ -1151,6 +1303,57 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 	}
 
 
+	// the fence before the task reports success; every queued compression runs
+	// as its own job, and crnlib's helper threads handle the large ones
+	bool convertPendingTextures()
+	{
+		if (m_pending_textures.empty()) return true;
+
+		IAllocator& allocator = m_dialog.m_editor.getAllocator();
+		MTJD::Manager& manager = m_dialog.m_editor.getEngine().getMTJDManager();
+		MTJD::Group sync(true, allocator);
+		volatile i32 failed = 0;
+		for (PendingTexture& texture : m_pending_textures)
+		{
+			PendingTexture* t = &texture;
+			volatile i32* failed_ptr = &failed;
+			ImportAssetDialog* dialog = &m_dialog;
+			MTJD::Job* job = MTJD::makeJob(manager,
+				[t, failed_ptr, dialog]() {
+					int image_width, image_height, image_comp;
+					auto data = stbi_load(t->src, &image_width, &image_height, &image_comp, 4);
+					if (!data)
+					{
+						dialog->setMessage(StaticString<MAX_PATH_LENGTH + 20>("Could not load image ", t->src));
+						MT::atomicIncrement(failed_ptr);
+						return;
+					}
+					if (!saveAsDDS(*dialog,
+							t->src,
+							data,
+							image_width,
+							image_height,
+							image_comp == 4,
+							t->is_normal_map,
+							t->dest,
+							false))
+					{
+						dialog->setMessage(StaticString<MAX_PATH_LENGTH * 2 + 20>(
+							"Error converting ", t->src, " to ", t->dest));
+						MT::atomicIncrement(failed_ptr);
+					}
+					stbi_image_free(data);
+				},
+				manager.getJobAllocator());
+			job->addDependency(&sync);
+			manager.schedule(job);
+		}
+		sync.sync();
+		m_pending_textures.clear();
+		return failed == 0;
+	}
+
+
 	static float getLength(aiAnimation* animation)
 	{
 		float length = 0;
@@ -1316,7 +1519,9 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 				: (animation->mTicksPerSecond == 1 ? 30 : animation->mTicksPerSecond));
 			if (animation->mTicksPerSecond < 2) header.fps = detectFPS(animation);
 			header.magic = Animation::HEADER_MAGIC;
-			header.version = 3;
+			// version 4 stores quantized tracks: 3xu16 range-encoded positions
+			// and 4xi16 quaternions, which the runtime keeps resident as-is
+			header.version = 4;
 
 			file.write(&header, sizeof(header));
 			file.write(&import_animation.root_motion_bone_idx, sizeof(import_animation.root_motion_bone_idx));
@@ -1328,6 +1533,7 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 
 			Array<aiVectorKey> positions(m_dialog.m_editor.getAllocator());
 			Array<aiQuatKey> rotations(m_dialog.m_editor.getAllocator());
+			Array<Vec3> out_positions(m_dialog.m_editor.getAllocator());
 			for (unsigned int channel_idx = 0; channel_idx < animation->mNumChannels; ++channel_idx)
 			{
 				const aiNodeAnim* channel = animation->mChannels[channel_idx];
@@ -1347,6 +1553,7 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 					u16 frame = u16(pos.mTime * m_dialog.m_model.time_scale * header.fps / animation->mTicksPerSecond);
 					file.write(&frame, sizeof(frame));
 				}
+				out_positions.clear();
 				for (const auto& pos : positions)
 				{
 					Vec3 out_pos(pos.mValue.x, pos.mValue.y, pos.mValue.z);
@@ -1362,9 +1569,31 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 					{
 						out_pos = fixOrientation(out_pos);
 					}
-					file.write(&out_pos, sizeof(out_pos));
+					out_positions.push(out_pos);
 				}
-				
+				Vec3 pos_min(FLT_MAX, FLT_MAX, FLT_MAX);
+				Vec3 pos_max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+				for (const Vec3& p : out_positions)
+				{
+					pos_min.x = Math::minimum(pos_min.x, p.x);
+					pos_min.y = Math::minimum(pos_min.y, p.y);
+					pos_min.z = Math::minimum(pos_min.z, p.z);
+					pos_max.x = Math::maximum(pos_max.x, p.x);
+					pos_max.y = Math::maximum(pos_max.y, p.y);
+					pos_max.z = Math::maximum(pos_max.z, p.z);
+				}
+				Vec3 pos_range = pos_max - pos_min;
+				file.write(&pos_min, sizeof(pos_min));
+				file.write(&pos_range, sizeof(pos_range));
+				for (const Vec3& p : out_positions)
+				{
+					u16 q[3];
+					q[0] = pos_range.x > 0 ? u16((p.x - pos_min.x) / pos_range.x * 65535.0f + 0.5f) : 0;
+					q[1] = pos_range.y > 0 ? u16((p.y - pos_min.y) / pos_range.y * 65535.0f + 0.5f) : 0;
+					q[2] = pos_range.z > 0 ? u16((p.z - pos_min.z) / pos_range.z * 65535.0f + 0.5f) : 0;
+					file.write(q, sizeof(q));
+				}
+
 				compressRotations(rotations, channel, float(anim_length * animation->mTicksPerSecond), m_dialog.m_model.rotation_error / 100000.0f);
 				count = rotations.size();
 				file.write(&count, sizeof(count));
@@ -1384,7 +1613,12 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 					{
 						out_rot = fixOrientation(out_rot);
 					}
-					file.write(&out_rot, sizeof(out_rot));
+					i16 q[4];
+					q[0] = i16(Math::clamp(out_rot.x, -1.0f, 1.0f) * 32767.0f);
+					q[1] = i16(Math::clamp(out_rot.y, -1.0f, 1.0f) * 32767.0f);
+					q[2] = i16(Math::clamp(out_rot.z, -1.0f, 1.0f) * 32767.0f);
+					q[3] = i16(Math::clamp(out_rot.w, -1.0f, 1.0f) * 32767.0f);
+					file.write(q, sizeof(q));
 				}
 			}
 
@@ -1457,7 +1691,7 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 	}
 
 
-	bool saveMaterial(ImportMaterial& material, const char* source_mesh_dir, int* undefined_count) const
+	bool saveMaterial(ImportMaterial& material, const char* source_mesh_dir, int* undefined_count)
 	{
 		ASSERT(undefined_count);
 
@@ -1512,8 +1746,10 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 			qsort(&m_dialog.m_meshes[0], m_dialog.m_meshes.size(), sizeof(m_dialog.m_meshes[0]), cmpMeshes);
 		}
 
-		if (saveLumixPhysics() && saveLumixModel() && saveLumixMaterials() && saveLumixAnimations())
+		if (saveLumixPhysics() && saveLumixModel() && saveLumixMaterials() && convertPendingTextures() &&
+			saveLumixAnimations())
 		{
+			m_dialog.m_task_succeeded = true;
 			m_dialog.setMessage("Success.");
 		}
 		return 0;
@@ -1927,9 +2163,16 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 		}
 
 		file.write((const char*)&indices_count, sizeof(indices_count));
+		file.write((const char*)&vertices_size, sizeof(vertices_size));
 		writeIndices(file);
 
-		file.write((const char*)&vertices_size, sizeof(vertices_size));
+		// pad so the vertex data starts 16-byte aligned right behind the
+		// indices; the runtime loads both as a single blob
+		int index_size = areIndices16Bit() ? sizeof(u16) : sizeof(u32);
+		i32 indices_size = indices_count * index_size;
+		u8 padding[16] = {};
+		file.write(padding, (16 - indices_size % 16) % 16);
+
 		writeVertices(file);
 	}
 
@@ -2480,6 +2723,7 @@ struct ConvertTask LUMIX_FINAL : public MT::Task
 
 	ImportAssetDialog& m_dialog;
 	Array<aiNode*> m_nodes;
+	Array<PendingTexture> m_pending_textures;
 	float m_scale;
 }; // struct ConvertTask
 
@@ -2491,9 +2735,12 @@ ImportAssetDialog::ImportAssetDialog(StudioApp& app)
 	, m_is_converting(false)
 	, m_is_importing(false)
 	, m_is_importing_texture(false)
+	, m_task_succeeded(false)
+	, m_out_path_hash(0)
+	, m_sources_hash(0)
 	, m_mutex(false)
 	, m_saved_textures(app.getWorldEditor()->getAllocator())
-	, m_convert_to_dds(false)
+	, m_convert_to_dds(true)
 	, m_convert_to_raw(false)
 	, m_is_normal_map(false)
 	, m_raw_texture_scale(1)
@@ -2501,6 +2748,7 @@ ImportAssetDialog::ImportAssetDialog(StudioApp& app)
 	, m_materials(app.getWorldEditor()->getAllocator())
 	, m_importers(app.getWorldEditor()->getAllocator())
 	, m_sources(app.getWorldEditor()->getAllocator())
+	, m_texture_array_sources(app.getWorldEditor()->getAllocator())
 	, m_animations(app.getWorldEditor()->getAllocator())
 {
 	s_default_comp_params.m_file_type = cCRNFileTypeDDS;
@@ -2509,7 +2757,7 @@ ImportAssetDialog::ImportAssetDialog(StudioApp& app)
 	s_default_comp_params.m_dxt_compressor_type = cCRNDXTCompressorCRN;
 	s_default_comp_params.m_pProgress_func = ddsConvertCallback;
 	s_default_comp_params.m_pProgress_func_data = &m_dds_convert_callback;
-	s_default_comp_params.m_num_helper_threads = 3;
+	s_default_comp_params.m_num_helper_threads = Math::maximum(1, int(MT::getCPUsCount()) - 1);
 
 	m_image.data = nullptr;
 
@@ -2694,6 +2942,20 @@ bool ImportAssetDialog::hasMessage()
 }
 
 
+// crc32 of the file's content; 0 when the file cannot be read
+static u32 getFileContentHash(const char* path, IAllocator& allocator)
+{
+	FS::OsFile file;
+	if (!file.open(path, FS::Mode::OPEN_AND_READ, allocator)) return 0;
+	Array<u8> content(allocator);
+	content.resize((int)file.size());
+	bool read = !content.empty() && file.read(&content[0], content.size());
+	file.close();
+	if (!read) return 0;
+	return crc32(&content[0], content.size());
+}
+
+
 void ImportAssetDialog::saveModelMetadata()
 {
 	PathBuilder model_path(m_output_dir, "/", m_mesh_output_filename, ".msh");
@@ -2703,6 +2965,13 @@ void ImportAssetDialog::saveModelMetadata()
 
 	OutputBlob blob(m_editor.getAllocator());
 	blob.reserve(1024);
+	writeImportSettings(blob);
+	m_metadata.setRawMemory(model_path_hash, crc32("import_settings"), blob.getData(), blob.getPos());
+}
+
+
+void ImportAssetDialog::writeImportSettings(OutputBlob& blob) const
+{
 	blob.write(&m_model, sizeof(m_model));
 	blob.write(m_meshes.size());
 	for (auto& i : m_meshes)
@@ -2730,7 +2999,21 @@ void ImportAssetDialog::saveModelMetadata()
 	int sources_count = m_sources.size();
 	blob.write(sources_count);
 	blob.write(&m_sources[0], sizeof(m_sources) * m_sources.size());
-	m_metadata.setRawMemory(model_path_hash, crc32("import_settings"), blob.getData(), blob.getPos());
+}
+
+
+// crc32 of the import settings and of every source file's content; a matching
+// recorded value means rerunning the conversion would produce identical outputs
+u32 ImportAssetDialog::getSourcesHash()
+{
+	OutputBlob blob(m_editor.getAllocator());
+	blob.reserve(1024);
+	writeImportSettings(blob);
+	for (auto& source : m_sources)
+	{
+		blob.write(getFileContentHash(source, m_editor.getAllocator()));
+	}
+	return crc32(blob.getData(), blob.getPos());
 }
 
 
@@ -2751,10 +3034,26 @@ void ImportAssetDialog::convert(bool use_ui)
 		}
 	}
 
+	PathBuilder model_path(m_output_dir, "/", m_mesh_output_filename, ".msh");
+	char normalized_path[MAX_PATH_LENGTH];
+	PathUtils::normalize(model_path, normalized_path, lengthOf(normalized_path));
+	u32 model_path_hash = crc32(normalized_path);
+	u32 sources_hash = getSourcesHash();
+	if (PlatformInterface::fileExists(normalized_path) &&
+		m_metadata.getInt(model_path_hash, crc32("source_hash")) == (int)sources_hash)
+	{
+		if (use_ui) setMessage("Up to date.");
+		else g_log_info.log("Editor") << normalized_path << " is up to date, conversion skipped";
+		return;
+	}
+
 	saveModelMetadata();
 
 	setImportMessage("Converting...", -1);
 	m_is_converting = true;
+	m_task_succeeded = false;
+	m_out_path_hash = model_path_hash;
+	m_sources_hash = sources_hash;
 	m_task = LUMIX_NEW(m_editor.getAllocator(), ConvertTask)(*this, m_model.mesh_scale);
 	m_task->create("ConvertAssetTask");
 }
@@ -2774,14 +3073,42 @@ void ImportAssetDialog::importTexture()
 	getRelativePath(m_editor, dest_path, lengthOf(dest_path), tmp);
 	u32 hash = crc32(dest_path);
 
+	OutputBlob settings(m_editor.getAllocator());
+	settings.write(m_convert_to_dds);
+	settings.write(m_convert_to_raw);
+	settings.write(m_is_normal_map);
+	settings.write(m_raw_texture_scale);
+	settings.write(getFileContentHash(m_source, m_editor.getAllocator()));
+	u32 sources_hash = crc32(settings.getData(), settings.getPos());
+	if (PlatformInterface::fileExists(tmp) && m_metadata.getInt(hash, crc32("source_hash")) == (int)sources_hash)
+	{
+		setImportMessage(StaticString<MAX_PATH_LENGTH + 40>(dest_path, " is up to date, import skipped"), 1);
+		return;
+	}
+
 	m_metadata.setString(hash, crc32("source"), m_source);
 
 	m_is_importing_texture = true;
+	m_task_succeeded = false;
+	m_out_path_hash = hash;
+	m_sources_hash = sources_hash;
 	m_task = LUMIX_NEW(m_editor.getAllocator(), ImportTextureTask)(*this);
 	m_task->create("ImportTextureTask");
 }
 
 
+void ImportAssetDialog::importTextureArray()
+{
+	ASSERT(!m_task);
+	if (m_texture_array_sources.size() < 2) return;
+	setImportMessage("Importing texture array...", 0);
+
+	m_is_importing_texture = true;
+	m_task = LUMIX_NEW(m_editor.getAllocator(), ImportTextureArrayTask)(*this);
+	m_task->create("ImportTextureArrayTask");
+}
+
+
 bool ImportAssetDialog::isTextureDirValid() const
 {
 	if (!m_texture_output_dir[0]) return true;
@@ -3066,6 +3393,26 @@ void ImportAssetDialog::onImageGUI()
 	}
 
 	if (ImGui::Button("Import texture")) importTexture();
+
+	ImGui::Separator();
+	ImGui::Text("Texture array layers:");
+	for (int i = 0; i < m_texture_array_sources.size(); ++i)
+	{
+		ImGui::Text("%s", m_texture_array_sources[i].data);
+		ImGui::SameLine();
+		StaticString<40> remove_label("Remove##array_layer", i);
+		if (ImGui::Button(remove_label))
+		{
+			m_texture_array_sources.erase(i);
+			--i;
+		}
+	}
+	if (ImGui::Button("Add current as layer")) m_texture_array_sources.emplace(m_source);
+	if (m_texture_array_sources.size() > 1)
+	{
+		ImGui::SameLine();
+		if (ImGui::Button("Import texture array")) importTextureArray();
+	}
 }
 
 
@@ -3274,8 +3621,8 @@ static bool createBillboard(ImportAssetDialog& dialog,
 
 	preprocessBillboard((u32*)&data[0], width, height, engine.getAllocator());
 	preprocessBillboardNormalmap((u32*)&data_normal[0], width, height, engine.getAllocator());
-	saveAsDDS(dialog, "billboard_generator", (u8*)&data[0], width, height, true, false, out_path.c_str());
-	saveAsDDS(dialog, "billboard_generator", (u8*)&data_normal[0], width, height, true, true, out_path_normal.c_str());
+	saveAsDDS(dialog, "billboard_generator", (u8*)&data[0], width, height, true, false, out_path.c_str(), true);
+	saveAsDDS(dialog, "billboard_generator", (u8*)&data_normal[0], width, height, true, true, out_path_normal.c_str(), true);
 	bgfx::destroyTexture(texture);
 	bgfx::destroyTexture(normal_texture);
 	Pipeline::destroy(pipeline);
@@ -3293,7 +3640,9 @@ void ImportAssetDialog::import()
 	}
 
 	convert(false);
-	if (m_is_converting) checkTask(true);
+	// nothing to do when the recorded source hash matched or validation failed
+	if (!m_is_converting) return;
+	checkTask(true);
 
 	if (m_model.create_billboard_lod)
 	{
@@ -3329,6 +3678,11 @@ void ImportAssetDialog::checkTask(bool wait)
 	m_task->destroy();
 	LUMIX_DELETE(m_editor.getAllocator(), m_task);
 	m_task = nullptr;
+	if (m_task_succeeded && m_out_path_hash != 0)
+	{
+		m_metadata.setInt(m_out_path_hash, crc32("source_hash"), (int)m_sources_hash);
+	}
+	m_out_path_hash = 0;
 	m_is_importing = false;
 	m_is_converting = false;
 	m_is_importing_texture = false;
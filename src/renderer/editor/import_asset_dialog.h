@@ -18,6 +18,7 @@ class Metadata;
 namespace Lumix
 {
 
+class OutputBlob;
 class WorldEditor;
 
 namespace MT
@@ -89,6 +90,7 @@ class ImportAssetDialog LUMIX_FINAL : public StudioApp::IPlugin
 	friend struct ImportTask;
 	friend struct ConvertTask;
 	friend struct ImportTextureTask;
+	friend struct ImportTextureArrayTask;
 	public:
 		enum Orientation : int
 		{
@@ -127,6 +129,7 @@ class ImportAssetDialog LUMIX_FINAL : public StudioApp::IPlugin
 		void getMessage(char* msg, int max_size);
 		bool hasMessage();
 		void importTexture();
+		void importTextureArray();
 		bool isTextureDirValid() const;
 		void onMaterialsGUI();
 		void onMeshesGUI();
@@ -135,6 +138,8 @@ class ImportAssetDialog LUMIX_FINAL : public StudioApp::IPlugin
 		void onLODsGUI();
 		void onAction();
 		void saveModelMetadata();
+		void writeImportSettings(Lumix::OutputBlob& blob) const;
+		Lumix::u32 getSourcesHash();
 		bool isOpened() const;
 		void clearSources();
 		void addSource(const char* src);
@@ -144,6 +149,7 @@ class ImportAssetDialog LUMIX_FINAL : public StudioApp::IPlugin
 		Lumix::Array<Lumix::u32> m_saved_textures;
 		Lumix::Array<Assimp::Importer> m_importers;
 		Lumix::Array<Lumix::StaticString<Lumix::MAX_PATH_LENGTH> > m_sources;
+		Lumix::Array<Lumix::StaticString<Lumix::MAX_PATH_LENGTH> > m_texture_array_sources;
 		Lumix::Array<ImportAnimation> m_animations;
 		Lumix::Array<ImportMesh> m_meshes;
 		Lumix::Array<ImportMaterial> m_materials;
@@ -190,6 +196,11 @@ class ImportAssetDialog LUMIX_FINAL : public StudioApp::IPlugin
 		bool m_is_converting;
 		bool m_is_importing;
 		bool m_is_importing_texture;
+		bool m_task_succeeded;
+		// pending source-hash record; written into metadata only after the task
+		// finished successfully, so failed or interrupted imports are retried
+		Lumix::u32 m_out_path_hash;
+		Lumix::u32 m_sources_hash;
 		float m_raw_texture_scale;
 		Lumix::MT::Task* m_task;
 		Lumix::MT::SpinMutex m_mutex;
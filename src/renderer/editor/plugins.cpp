@@ -6,6 +6,7 @@
 #include "editor/studio_app.h"
 #include "editor/utils.h"
 #include "editor/world_editor.h"
+#include "engine/associative_array.h"
 #include "engine/crc32.h"
 #include "engine/engine.h"
 #include "engine/fs/disk_file_device.h"
@@ -58,6 +59,8 @@ static const ResourceType MATERIAL_TYPE("material");
 static const ResourceType SHADER_TYPE("shader");
 static const ResourceType TEXTURE_TYPE("texture");
 static const ResourceType MODEL_TYPE("model");
+static const char* THUMBNAILS_DIR = "editor/thumbnails/";
+static const int THUMBNAIL_RESOLUTION = 128;
 
 
 struct MaterialPlugin LUMIX_FINAL : public AssetBrowser::IPlugin
@@ -96,6 +99,12 @@ struct MaterialPlugin LUMIX_FINAL : public AssetBrowser::IPlugin
 		}
 		fs.close(*file);
 
+		commitTmpFile(tmp_path, material);
+	}
+
+
+	void commitTmpFile(const char* tmp_path, Material* material)
+	{
 		auto& engine = m_app.getWorldEditor()->getEngine();
 		StaticString<MAX_PATH_LENGTH> src_full_path;
 		StaticString<MAX_PATH_LENGTH> dest_full_path;
@@ -121,6 +130,32 @@ struct MaterialPlugin LUMIX_FINAL : public AssetBrowser::IPlugin
 	}
 
 
+	void bakeMaterial(Material* material)
+	{
+		FS::FileSystem& fs = m_app.getWorldEditor()->getEngine().getFileSystem();
+		auto& allocator = m_app.getWorldEditor()->getAllocator();
+		OutputBlob blob(allocator);
+		if (!material->saveBinary(blob))
+		{
+			g_log_error.log("Editor") << "Could not bake material " << material->getPath().c_str();
+			return;
+		}
+
+		// use temporary because otherwise the material is reloaded during saving
+		StaticString<MAX_PATH_LENGTH> tmp_path(material->getPath().c_str(), ".tmp");
+		FS::IFile* file = fs.open(fs.getDefaultDevice(), Path(tmp_path), FS::Mode::CREATE_AND_WRITE);
+		if (!file)
+		{
+			g_log_error.log("Editor") << "Could not save file " << material->getPath().c_str();
+			return;
+		}
+		file->write(blob.getData(), blob.getPos());
+		fs.close(*file);
+
+		commitTmpFile(tmp_path, material);
+	}
+
+
 	bool onGUI(Resource* resource, ResourceType type) override
 	{
 		if (type != MATERIAL_TYPE) return false;
@@ -129,6 +164,8 @@ struct MaterialPlugin LUMIX_FINAL : public AssetBrowser::IPlugin
 
 		if (ImGui::Button("Save")) saveMaterial(material);
 		ImGui::SameLine();
+		if (ImGui::Button("Bake binary")) bakeMaterial(material);
+		ImGui::SameLine();
 		if (ImGui::Button("Open in external editor")) m_app.getAssetBrowser()->openInExternalEditor(material);
 
 		bool b;
@@ -354,6 +391,7 @@ struct ModelPlugin LUMIX_FINAL : public AssetBrowser::IPlugin
 {
 	explicit ModelPlugin(StudioApp& app)
 		: m_app(app)
+		, m_thumbnails(app.getWorldEditor()->getAllocator())
 	{
 		m_camera_cmp = INVALID_COMPONENT;
 		m_camera_entity = INVALID_ENTITY;
@@ -361,6 +399,9 @@ struct ModelPlugin LUMIX_FINAL : public AssetBrowser::IPlugin
 		m_pipeline = nullptr;
 		m_universe = nullptr;
 		m_is_mouse_captured = false;
+		m_thumbnail_model = nullptr;
+		m_thumbnail_hash = 0;
+		m_is_thumbnail_readback_queued = false;
 
 		createPreviewUniverse();
 	}
@@ -369,6 +410,12 @@ struct ModelPlugin LUMIX_FINAL : public AssetBrowser::IPlugin
 	~ModelPlugin()
 	{
 		auto& engine = m_app.getWorldEditor()->getEngine();
+		if (m_thumbnail_model) m_thumbnail_model->getResourceManager().unload(*m_thumbnail_model);
+		for (int i = 0; i < m_thumbnails.size(); ++i)
+		{
+			Texture* texture = m_thumbnails.at(i);
+			if (texture) texture->getResourceManager().unload(*texture);
+		}
 		engine.destroyUniverse(*m_universe);
 		Pipeline::destroy(m_pipeline);
 	}
@@ -485,6 +532,139 @@ struct ModelPlugin LUMIX_FINAL : public AssetBrowser::IPlugin
 	}
 
 
+	void* getThumbnail(const char* path) override
+	{
+		updateThumbnailBake();
+
+		u32 hash = crc32(path);
+		int idx = m_thumbnails.find(hash);
+		if (idx >= 0)
+		{
+			// nullptr entries mark failed bakes, so they are not retried every frame
+			Texture* texture = m_thumbnails.at(idx);
+			if (!texture || !texture->isReady()) return nullptr;
+			return &texture->handle;
+		}
+
+		StaticString<MAX_PATH_LENGTH> dds_path(THUMBNAILS_DIR, hash, ".dds");
+		if (PlatformInterface::fileExists(dds_path) &&
+			PlatformInterface::getLastModified(dds_path) > PlatformInterface::getLastModified(path))
+		{
+			auto* manager = m_app.getWorldEditor()->getEngine().getResourceManager().get(TEXTURE_TYPE);
+			m_thumbnails.insert(hash, static_cast<Texture*>(manager->load(Path(dds_path))));
+			return nullptr;
+		}
+
+		if (m_thumbnail_model) return nullptr;
+
+		auto* manager = m_app.getWorldEditor()->getEngine().getResourceManager().get(MODEL_TYPE);
+		m_thumbnail_model = static_cast<Model*>(manager->load(Path(path)));
+		m_thumbnail_hash = hash;
+		m_thumbnail_path = dds_path;
+		return nullptr;
+	}
+
+
+	void releaseThumbnailModel()
+	{
+		m_thumbnail_model->getResourceManager().unload(*m_thumbnail_model);
+		m_thumbnail_model = nullptr;
+	}
+
+
+	// renders the queued model into the preview pipeline and asynchronously reads
+	// the tile back; one bake is in flight at a time so scrolling never stalls
+	void updateThumbnailBake()
+	{
+		if (!m_thumbnail_model || m_is_thumbnail_readback_queued) return;
+		if (m_thumbnail_model->isFailure())
+		{
+			m_thumbnails.insert(m_thumbnail_hash, nullptr);
+			releaseThumbnailModel();
+			return;
+		}
+		if (!m_thumbnail_model->isReady()) return;
+
+		auto* render_scene = static_cast<RenderScene*>(m_universe->getScene(MODEL_INSTANCE_TYPE));
+		if (!render_scene)
+		{
+			m_thumbnails.insert(m_thumbnail_hash, nullptr);
+			releaseThumbnailModel();
+			return;
+		}
+
+		// the preview scene is borrowed for one frame and restored afterwards,
+		// so an open preview of the selected model is not disturbed
+		Path selected_path = render_scene->getModelInstancePath(m_mesh);
+		Vec3 camera_pos = m_universe->getPosition(m_camera_entity);
+		Quat camera_rot = m_universe->getRotation(m_camera_entity);
+
+		render_scene->setModelInstancePath(m_mesh, m_thumbnail_model->getPath());
+		AABB aabb = m_thumbnail_model->getAABB();
+		m_universe->setRotation(m_camera_entity, {0, 0, 0, 1});
+		m_universe->setPosition(m_camera_entity,
+			{(aabb.max.x + aabb.min.x) * 0.5f,
+				(aabb.max.y + aabb.min.y) * 0.5f,
+				aabb.max.z + aabb.max.x - aabb.min.x});
+
+		m_pipeline->setViewport(0, 0, THUMBNAIL_RESOLUTION, THUMBNAIL_RESOLUTION);
+		m_pipeline->render();
+
+		Delegate<void(const u8*, int, int)> callback;
+		callback.bind<ModelPlugin, &ModelPlugin::onThumbnailReadback>(this);
+		m_is_thumbnail_readback_queued = m_pipeline->readRenderbufferAsync("default", 0, callback);
+
+		render_scene->setModelInstancePath(m_mesh, selected_path);
+		m_universe->setPosition(m_camera_entity, camera_pos);
+		m_universe->setRotation(m_camera_entity, camera_rot);
+	}
+
+
+	void onThumbnailReadback(const u8* data, int width, int height)
+	{
+		m_is_thumbnail_readback_queued = false;
+
+		crn_comp_params comp_params;
+		comp_params.m_file_type = cCRNFileTypeDDS;
+		comp_params.m_dxt_quality = cCRNDXTQualitySuperFast;
+		comp_params.m_width = width;
+		comp_params.m_height = height;
+		comp_params.m_format = cCRNFmtDXT1;
+		comp_params.m_pImages[0][0] = (const u32*)data;
+		crn_mipmap_params mipmap_params;
+		mipmap_params.m_mode = cCRNMipModeGenerateMips;
+
+		crn_uint32 size;
+		void* compressed = crn_compress(comp_params, mipmap_params, size);
+		bool saved = false;
+		if (compressed)
+		{
+			PlatformInterface::makePath(THUMBNAILS_DIR);
+			auto& allocator = m_app.getWorldEditor()->getAllocator();
+			FS::OsFile file;
+			if (file.open(m_thumbnail_path, FS::Mode::CREATE_AND_WRITE, allocator))
+			{
+				file.write((const char*)compressed, size);
+				file.close();
+				saved = true;
+			}
+			crn_free_block(compressed);
+		}
+
+		if (saved)
+		{
+			auto* manager = m_app.getWorldEditor()->getEngine().getResourceManager().get(TEXTURE_TYPE);
+			m_thumbnails.insert(m_thumbnail_hash, static_cast<Texture*>(manager->load(Path(m_thumbnail_path))));
+		}
+		else
+		{
+			g_log_error.log("Editor") << "Could not save thumbnail " << m_thumbnail_path;
+			m_thumbnails.insert(m_thumbnail_hash, nullptr);
+		}
+		releaseThumbnailModel();
+	}
+
+
 	bool onGUI(Resource* resource, ResourceType type) override
 	{
 		if (type != MODEL_TYPE) return false;
@@ -597,6 +777,11 @@ struct ModelPlugin LUMIX_FINAL : public AssetBrowser::IPlugin
 	bool m_is_mouse_captured;
 	int m_captured_mouse_x;
 	int m_captured_mouse_y;
+	AssociativeArray<u32, Texture*> m_thumbnails;
+	Model* m_thumbnail_model;
+	u32 m_thumbnail_hash;
+	StaticString<MAX_PATH_LENGTH> m_thumbnail_path;
+	bool m_is_thumbnail_readback_queued;
 };
 
 
@@ -128,11 +128,29 @@ void SceneView::onUniverseDestroyed()
 }
 
 
+// keeps models around the editor camera at the front of the load queue, so
+// flying or teleporting across a level streams in what is ahead first
+void SceneView::prefetchModels()
+{
+	static const float PREFETCH_RADIUS = 300;
+
+	auto* scene = m_pipeline->getScene();
+	if (!scene) return;
+
+	Lumix::ComponentUID camera = m_editor->getEditCamera();
+	if (!Lumix::isValid(camera.entity)) return;
+
+	Lumix::Vec3 camera_pos = m_editor->getUniverse()->getPosition(camera.entity);
+	scene->prefetchModels(camera_pos, PREFETCH_RADIUS);
+}
+
+
 void SceneView::update()
 {
 	PROFILE_FUNCTION();
-	if (ImGui::IsAnyItemActive()) return;
 	if (!m_is_opened) return;
+	prefetchModels();
+	if (ImGui::IsAnyItemActive()) return;
 	if (ImGui::GetIO().KeyCtrl) return;
 
 	int screen_x = int(ImGui::GetIO().MousePos.x);
@@ -436,6 +454,28 @@ void SceneView::onGUI()
 			ImGui::LabelText("GPU time", "%.2f", m_pipeline->getGPUTime() * 1000.0f);
 			ImGui::LabelText("Waiting for submit", "%.2f", m_pipeline->getWaitSubmitTime() * 1000.0f);
 			ImGui::LabelText("Waiting for render thread", "%.2f", m_pipeline->getGPUTime() * 1000.0f);
+			if (ImGui::TreeNode("Passes"))
+			{
+				auto* renderer = static_cast<Lumix::Renderer*>(
+					m_editor->getEngine().getPluginManager().getPlugin("renderer"));
+				ImGui::Columns(4);
+				ImGui::Text("Pass"); ImGui::NextColumn();
+				ImGui::Text("Draw calls"); ImGui::NextColumn();
+				ImGui::Text("Instances"); ImGui::NextColumn();
+				ImGui::Text("Triangles"); ImGui::NextColumn();
+				ImGui::Separator();
+				for (int i = 0, c = renderer->getPassStatsCount(); i < c; ++i)
+				{
+					const Lumix::Renderer::PassStats& pass = renderer->getPassStats(i);
+					ImGui::Text("%s", pass.name); ImGui::NextColumn();
+					ImGui::Text("%d", pass.draw_call_count); ImGui::NextColumn();
+					ImGui::Text("%d", pass.instance_count); ImGui::NextColumn();
+					Lumix::toCStringPretty(pass.triangle_count, buf, Lumix::lengthOf(buf));
+					ImGui::Text("%s", buf); ImGui::NextColumn();
+				}
+				ImGui::Columns(1);
+				ImGui::TreePop();
+			}
 		}
 		ImGui::End();
 		ImGui::PopStyleColor();
@@ -32,6 +32,7 @@ class SceneView
 		const bgfx::TextureHandle& getTextureHandle() const { return m_texture_handle; }
 
 	private:
+		void prefetchModels();
 		void renderGizmos();
 		void renderIcons();
 		void onUniverseCreated();
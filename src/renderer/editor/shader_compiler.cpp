@@ -13,6 +13,9 @@
 #include "engine/fs/resource_file_device.h"
 #include "engine/log.h"
 #include "engine/mt/thread.h"
+#include "engine/mtjd/generic_job.h"
+#include "engine/mtjd/job.h"
+#include "engine/mtjd/manager.h"
 #include "engine/path.h"
 #include "engine/path_utils.h"
 #include "engine/plugin_manager.h"
@@ -46,6 +49,9 @@ ShaderCompiler::ShaderCompiler(StudioApp& app, LogUI& log_ui)
 	, m_shd_files(m_editor.getAllocator())
 	, m_changed_files(m_editor.getAllocator())
 	, m_mutex(false)
+	, m_compile_sync_point(true, m_editor.getAllocator())
+	, m_compile_jobs(m_editor.getAllocator())
+	, m_is_compiling(false)
 {
 	m_notifications_id = -1;
 
@@ -424,68 +430,85 @@ void ShaderCompiler::compilePass(const char* shd_path,
 	const char* pass,
 	int define_mask,
 	const Lumix::ShaderCombinations::Defines& all_defines)
+{
+	auto& manager = m_editor.getEngine().getMTJDManager();
+	for (int mask = 0; mask < 1 << Lumix::lengthOf(all_defines); ++mask)
+	{
+		if ((mask & (~define_mask)) == 0)
+		{
+			// permutations are independent of each other, so each one becomes a
+			// job; compile() schedules the whole batch and waits on the group
+			Lumix::MTJD::Job* job = Lumix::MTJD::makeJob(manager,
+				[this, shd_path, is_vertex_shader, pass, mask, &all_defines]() {
+					compilePermutation(shd_path, is_vertex_shader, pass, mask, all_defines);
+				},
+				manager.getJobAllocator());
+			job->addDependency(&m_compile_sync_point);
+			m_compile_jobs.push(job);
+		}
+	}
+}
+
+
+void ShaderCompiler::compilePermutation(const char* shd_path,
+	bool is_vertex_shader,
+	const char* pass,
+	int mask,
+	const Lumix::ShaderCombinations::Defines& all_defines)
 {
 	const char* base_path = m_editor.getEngine().getDiskFileDevice()->getBasePath();
 	bool is_opengl = getRenderer().isOpenGL();
 
-	for (int mask = 0; mask < 1 << Lumix::lengthOf(all_defines); ++mask)
+	Lumix::PathUtils::FileInfo shd_file_info(shd_path);
+	Lumix::StaticString<Lumix::MAX_PATH_LENGTH> source_path(
+		"", shd_file_info.m_dir, shd_file_info.m_basename, is_vertex_shader ? "_vs.sc" : "_fs.sc");
+	Lumix::StaticString<Lumix::MAX_PATH_LENGTH> out_path(base_path);
+	out_path << "/pipelines/compiled" << (is_opengl ? "_gl/" : "/");
+	out_path << shd_file_info.m_basename << "_" << pass;
+	out_path << mask << (is_vertex_shader ? "_vs.shb" : "_fs.shb");
+
+	const char* args_array[18];
+	args_array[0] = "-f";
+	args_array[1] = source_path;
+	args_array[2] = "-o";
+	args_array[3] = out_path;
+	args_array[4] = "--depends";
+	args_array[5] = "-i";
+	Lumix::StaticString<Lumix::MAX_PATH_LENGTH> include(base_path, "/pipelines/");
+	args_array[6] = include;
+	args_array[7] = "--varyingdef";
+	Lumix::StaticString<Lumix::MAX_PATH_LENGTH> varying(base_path, "/pipelines/varying.def.sc");
+	args_array[8] = varying;
+	args_array[9] = "--platform";
+	if (is_opengl)
 	{
-		if ((mask & (~define_mask)) == 0)
+		args_array[10] = "linux";
+		args_array[11] = "--profile";
+		args_array[12] = "140";
+	}
+	else
+	{
+		args_array[10] = "windows";
+		args_array[11] = "--profile";
+		args_array[12] = is_vertex_shader ? "vs_5_0" : "ps_5_0";
+	}
+	args_array[13] = "--type";
+	args_array[14] = is_vertex_shader ? "vertex" : "fragment";
+	args_array[15] = "-O3";
+	args_array[16] = "--define";
+	Lumix::StaticString<256> defines(pass, ";");
+	for (int i = 0; i < Lumix::lengthOf(all_defines); ++i)
+	{
+		if (mask & (1 << i))
 		{
-			updateNotifications();
-			Lumix::PathUtils::FileInfo shd_file_info(shd_path);
-			Lumix::StaticString<Lumix::MAX_PATH_LENGTH> source_path(
-				"", shd_file_info.m_dir, shd_file_info.m_basename, is_vertex_shader ? "_vs.sc" : "_fs.sc");
-			Lumix::StaticString<Lumix::MAX_PATH_LENGTH> out_path(base_path);
-			out_path << "/pipelines/compiled" << (is_opengl ? "_gl/" : "/");
-			out_path << shd_file_info.m_basename << "_" << pass;
-			out_path << mask << (is_vertex_shader ? "_vs.shb" : "_fs.shb");
-
-			const char* args_array[18];
-			args_array[0] = "-f";
-			args_array[1] = source_path;
-			args_array[2] = "-o";
-			args_array[3] = out_path;
-			args_array[4] = "--depends";
-			args_array[5] = "-i";
-			Lumix::StaticString<Lumix::MAX_PATH_LENGTH> include(base_path, "/pipelines/");
-			args_array[6] = include;
-			args_array[7] = "--varyingdef";
-			Lumix::StaticString<Lumix::MAX_PATH_LENGTH> varying(base_path, "/pipelines/varying.def.sc");
-			args_array[8] = varying;
-			args_array[9] = "--platform";
-			if (getRenderer().isOpenGL())
-			{
-				args_array[10] = "linux";
-				args_array[11] = "--profile";
-				args_array[12] = "140";
-			}
-			else
-			{
-				args_array[10] = "windows";
-				args_array[11] = "--profile";
-				args_array[12] = is_vertex_shader ? "vs_5_0" : "ps_5_0";
-			}
-			args_array[13] = "--type";
-			args_array[14] = is_vertex_shader ? "vertex" : "fragment";
-			args_array[15] = "-O3";
-			args_array[16] = "--define";
-			Lumix::StaticString<256> defines(pass, ";");
-			for (int i = 0; i < Lumix::lengthOf(all_defines); ++i)
-			{
-				if (mask & (1 << i))
-				{
-					defines << getRenderer().getShaderDefine(all_defines[i]) << ";";
-				}
-			}
-			args_array[17] = defines;
-			bgfx::setShaderCErrorFunction(errorCallback, nullptr);
-			if (bgfx::compileShader(18, args_array) == EXIT_FAILURE)
-			{
-				Lumix::g_log_error.log("Renderer") << "Failed to compile " << source_path << "(" << out_path << "), defines = \"" << defines << "\"";
-			}
+			defines << getRenderer().getShaderDefine(all_defines[i]) << ";";
 		}
 	}
+	args_array[17] = defines;
+	if (bgfx::compileShader(18, args_array) == EXIT_FAILURE)
+	{
+		Lumix::g_log_error.log("Renderer") << "Failed to compile " << source_path << "(" << out_path << "), defines = \"" << defines << "\"";
+	}
 }
 
 
@@ -553,9 +576,10 @@ void ShaderCompiler::processChangedFiles()
 
 void ShaderCompiler::wait()
 {
-	while (!m_to_compile.empty())
+	while (!m_to_compile.empty() || m_is_compiling)
 	{
 		update();
+		if (m_is_compiling) Lumix::MT::sleep(10);
 	}
 }
 
@@ -567,13 +591,28 @@ void ShaderCompiler::update()
 
 	processChangedFiles();
 
+	if (m_is_compiling)
+	{
+		// the last batch of permutation jobs is still running on the workers; the
+		// UI thread only polls the group instead of blocking on it
+		if (m_compile_sync_point.getDependenceCount() > 0) return;
+		m_is_compiling = false;
+
+		if (m_to_compile.empty())
+		{
+			reloadShaders();
+			parseDependencies();
+			m_app.getAssetBrowser()->enableUpdate(true);
+		}
+	}
+
 	if (!m_to_compile.empty())
 	{
 		m_app.getAssetBrowser()->enableUpdate(false);
 		compile(m_to_compile.back().c_str());
 		m_to_compile.pop();
 
-		if (m_to_compile.empty())
+		if (m_to_compile.empty() && !m_is_compiling)
 		{
 			reloadShaders();
 			parseDependencies();
@@ -638,8 +677,18 @@ void ShaderCompiler::compile(const char* path)
 		Lumix::ShaderCombinations combinations;
 		Lumix::Shader::getShaderCombinations(path, getRenderer(), &data[0], &combinations);
 
+		updateNotifications();
+		bgfx::setShaderCErrorFunction(errorCallback, nullptr);
 		compileAllPasses(path, false, combinations.fs_local_mask, combinations);
 		compileAllPasses(path, true, combinations.vs_local_mask, combinations);
+
+		auto& manager = m_editor.getEngine().getMTJDManager();
+		m_is_compiling = !m_compile_jobs.empty();
+		for (Lumix::MTJD::Job* job : m_compile_jobs)
+		{
+			manager.schedule(job);
+		}
+		m_compile_jobs.clear();
 	}
 	else
 	{
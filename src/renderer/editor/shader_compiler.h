@@ -3,6 +3,7 @@
 
 #include "engine/associative_array.h"
 #include "engine/mt/sync.h"
+#include "engine/mtjd/group.h"
 #include "engine/string.h"
 #include "renderer/shader.h"
 
@@ -11,6 +12,10 @@ namespace Lumix
 {
 struct ShaderCombinations;
 class WorldEditor;
+namespace MTJD
+{
+class Job;
+}
 }
 
 namespace PlatformInterface
@@ -49,6 +54,11 @@ private:
 					 const char* pass,
 					 int define_mask,
 					 const Lumix::ShaderCombinations::Defines& all_defines);
+	void compilePermutation(const char* path,
+							bool is_vertex_shader,
+							const char* pass,
+							int mask,
+							const Lumix::ShaderCombinations::Defines& all_defines);
 	bool isChanged(const Lumix::ShaderCombinations& combinations,
 				   const char* bin_base_path,
 				   const char* shd_path) const;
@@ -83,5 +93,8 @@ private:
 	Lumix::Array<Lumix::string> m_shd_files;
 	Lumix::Array<Lumix::string> m_changed_files;
 	Lumix::MT::SpinMutex m_mutex;
+	Lumix::MTJD::Group m_compile_sync_point;
+	Lumix::Array<Lumix::MTJD::Job*> m_compile_jobs;
+	bool m_is_compiling;
 	LogUI& m_log_ui;
 };
@@ -1467,6 +1467,37 @@ ShaderEditor::Node* ShaderEditor::getNodeByID(int id)
 }
 
 
+// writes the file only when its content actually changed, so regenerating an
+// unchanged graph does not kick the shader compiler's file watcher into a
+// full recompile
+static bool writeFileIfChanged(const char* path, const Lumix::OutputBlob& blob, Lumix::IAllocator& allocator)
+{
+	Lumix::FS::OsFile file;
+	if (file.open(path, Lumix::FS::Mode::OPEN_AND_READ, allocator))
+	{
+		bool is_same = (int)file.size() == blob.getPos();
+		if (is_same && blob.getPos() > 0)
+		{
+			Lumix::Array<Lumix::u8> content(allocator);
+			content.resize(blob.getPos());
+			file.read(&content[0], content.size());
+			is_same = Lumix::compareMemory(&content[0], blob.getData(), content.size()) == 0;
+		}
+		file.close();
+		if (is_same) return true;
+	}
+
+	if (!file.open(path, Lumix::FS::Mode::CREATE_AND_WRITE, allocator))
+	{
+		Lumix::g_log_error.log("Editor") << "Could not create file " << path;
+		return false;
+	}
+	file.write(blob.getData(), blob.getPos());
+	file.close();
+	return true;
+}
+
+
 void ShaderEditor::generate(const char* path, ShaderType shader_type)
 {
 	char sc_path[Lumix::MAX_PATH_LENGTH];
@@ -1482,13 +1513,6 @@ void ShaderEditor::generate(const char* path, ShaderType shader_type)
 		Lumix::catString(sc_path, "_vs.sc");
 	}
 
-	Lumix::FS::OsFile file;
-	if(!file.open(sc_path, Lumix::FS::Mode::CREATE_AND_WRITE, m_allocator))
-	{
-		Lumix::g_log_error.log("Editor") << "Could not create file " << sc_path;
-		return;
-	}
-
 	Lumix::OutputBlob blob(m_allocator);
 	blob.reserve(4096);
 
@@ -1548,8 +1572,7 @@ void ShaderEditor::generate(const char* path, ShaderType shader_type)
 	}
 	blob << "}\n";
 
-	file.write(blob.getData(), blob.getPos());
-	file.close();
+	writeFileIfChanged(sc_path, blob, m_allocator);
 }
 
 
@@ -2153,26 +2176,17 @@ void ShaderEditor::generateMain(const char* path)
 	Lumix::catString(shd_path, info.m_basename);
 	Lumix::catString(shd_path, ".shd");
 
-	FILE* fp = fopen(shd_path, "wb");
-	if (!fp)
-	{
-		Lumix::g_log_error.log("Editor") << "Could not generate " << shd_path;
-		return;
-	}
-
 	Lumix::OutputBlob blob(m_allocator);
 	generatePasses(blob);
-	fwrite(blob.getData(), 1, blob.getPos(), fp);
 
-	bool first = true;
 	for(const auto& texture : m_textures)
 	{
 		if(!texture[0]) continue;
 
-		fprintf(fp, "texture_slot(\"%s\", \"%s\")\n", texture, texture);
+		blob << "texture_slot(\"" << texture << "\", \"" << texture << "\")\n";
 	}
 
-	fclose(fp);
+	writeFileIfChanged(shd_path, blob, m_allocator);
 }
 
 
@@ -1,6 +1,8 @@
 #include "renderer/frame_buffer.h"
+#include "engine/iallocator.h"
 #include "engine/json_serializer.h"
 #include "engine/log.h"
+#include "engine/profiler.h"
 #include "engine/string.h"
 #include "engine/vec.h"
 #include <bgfx/bgfx.h>
@@ -15,20 +17,28 @@ namespace Lumix
 FrameBuffer::FrameBuffer(const Declaration& decl)
 	: m_declaration(decl)
 {
+	for (auto& readback : m_readbacks) readback.m_data = nullptr;
 	m_autodestroy_handle = true;
 	bgfx::TextureHandle texture_handles[16];
 
+	u64 gpu_size = 0;
 	for (int i = 0; i < decl.m_renderbuffers_count; ++i)
 	{
 		const RenderBuffer& renderbuffer = decl.m_renderbuffers[i];
 		texture_handles[i] = bgfx::createTexture2D((uint16_t)decl.m_width,
 			(uint16_t)decl.m_height,
-			false, 
+			false,
 			1,
 			renderbuffer.m_format,
 			BGFX_TEXTURE_RT);
 		m_declaration.m_renderbuffers[i].m_handle = texture_handles[i];
+
+		bgfx::TextureInfo info;
+		bgfx::calcTextureSize(
+			info, (uint16_t)decl.m_width, (uint16_t)decl.m_height, 1, false, false, 1, renderbuffer.m_format);
+		gpu_size += info.storageSize;
 	}
+	Profiler::trackGPUAlloc(Profiler::GPUCategory::FRAMEBUFFER, decl.m_name, gpu_size);
 
 	m_window_handle = nullptr;
 	m_handle = bgfx::createFrameBuffer((uint8_t)decl.m_renderbuffers_count, texture_handles);
@@ -38,6 +48,7 @@ FrameBuffer::FrameBuffer(const Declaration& decl)
 
 FrameBuffer::FrameBuffer(const char* name, int width, int height, void* window_handle)
 {
+	for (auto& readback : m_readbacks) readback.m_data = nullptr;
 	m_autodestroy_handle = false;
 	copyString(m_declaration.m_name, name);
 	m_declaration.m_width = width;
@@ -51,14 +62,85 @@ FrameBuffer::FrameBuffer(const char* name, int width, int height, void* window_h
 
 FrameBuffer::~FrameBuffer()
 {
+	for (auto& readback : m_readbacks)
+	{
+		if (!readback.m_data) continue;
+
+		bgfx::destroyTexture(readback.m_texture);
+		readback.m_allocator->deallocate(readback.m_data);
+		readback.m_data = nullptr;
+	}
 	if (m_autodestroy_handle)
 	{
+		Profiler::untrackGPUAlloc(Profiler::GPUCategory::FRAMEBUFFER, m_declaration.m_name);
 		destroyRenderbuffers();
 		bgfx::destroyFrameBuffer(m_handle);
 	}
 }
 
 
+bool FrameBuffer::readAsync(int renderbuffer_idx, u8 blit_view, IAllocator& allocator, const ReadbackCallback& callback)
+{
+	if (renderbuffer_idx >= m_declaration.m_renderbuffers_count) return false;
+
+	AsyncReadback* readback = nullptr;
+	for (auto& r : m_readbacks)
+	{
+		if (!r.m_data)
+		{
+			readback = &r;
+			break;
+		}
+	}
+	if (!readback)
+	{
+		g_log_warning.log("Renderer") << "Too many async readbacks in flight on " << m_declaration.m_name;
+		return false;
+	}
+
+	const RenderBuffer& renderbuffer = m_declaration.m_renderbuffers[renderbuffer_idx];
+	bgfx::TextureInfo info;
+	bgfx::calcTextureSize(info,
+		(uint16_t)m_declaration.m_width,
+		(uint16_t)m_declaration.m_height,
+		1,
+		false,
+		false,
+		1,
+		renderbuffer.m_format);
+
+	readback->m_texture = bgfx::createTexture2D((uint16_t)m_declaration.m_width,
+		(uint16_t)m_declaration.m_height,
+		false,
+		1,
+		renderbuffer.m_format,
+		BGFX_TEXTURE_READ_BACK | BGFX_TEXTURE_BLIT_DST);
+	bgfx::touch(blit_view);
+	bgfx::blit(blit_view, readback->m_texture, 0, 0, renderbuffer.m_handle);
+	readback->m_data = (u8*)allocator.allocate(info.storageSize);
+	readback->m_allocator = &allocator;
+	readback->m_width = m_declaration.m_width;
+	readback->m_height = m_declaration.m_height;
+	readback->m_callback = callback;
+	readback->m_ready_frame = bgfx::readTexture(readback->m_texture, readback->m_data);
+	return true;
+}
+
+
+void FrameBuffer::checkReadbacks(u32 frame_number)
+{
+	for (auto& readback : m_readbacks)
+	{
+		if (!readback.m_data || frame_number < readback.m_ready_frame) continue;
+
+		readback.m_callback.invoke(readback.m_data, readback.m_width, readback.m_height);
+		bgfx::destroyTexture(readback.m_texture);
+		readback.m_allocator->deallocate(readback.m_data);
+		readback.m_data = nullptr;
+	}
+}
+
+
 void FrameBuffer::destroyRenderbuffers()
 {
 	for (int i = 0; i < m_declaration.m_renderbuffers_count; ++i)
@@ -86,13 +168,20 @@ void FrameBuffer::resize(int width, int height)
 	{
 		bgfx::TextureHandle texture_handles[16];
 
+		u64 gpu_size = 0;
 		for (int i = 0; i < m_declaration.m_renderbuffers_count; ++i)
 		{
 			const RenderBuffer& renderbuffer = m_declaration.m_renderbuffers[i];
 			texture_handles[i] = bgfx::createTexture2D(
 				(uint16_t)width, (uint16_t)height, false, 1, renderbuffer.m_format, BGFX_TEXTURE_RT);
 			m_declaration.m_renderbuffers[i].m_handle = texture_handles[i];
+
+			bgfx::TextureInfo info;
+			bgfx::calcTextureSize(info, (uint16_t)width, (uint16_t)height, 1, false, false, 1, renderbuffer.m_format);
+			gpu_size += info.storageSize;
 		}
+		// replaces the ledger entry created with the old dimensions
+		Profiler::trackGPUAlloc(Profiler::GPUCategory::FRAMEBUFFER, m_declaration.m_name, gpu_size);
 
 		m_window_handle = nullptr;
 		m_handle = bgfx::createFrameBuffer((uint8_t)m_declaration.m_renderbuffers_count, texture_handles);
@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include "engine/delegate.h"
 #include "engine/lumix.h"
 #include "engine/vec.h"
 #include <bgfx/bgfx.h>
@@ -13,12 +14,14 @@ namespace Lumix
 {
 
 
+class IAllocator;
 class JsonSerializer;
 
 
 class FrameBuffer
 {
 	public:
+		typedef Delegate<void(const u8*, int, int)> ReadbackCallback;
 		struct RenderBuffer
 		{
 			bgfx::TextureFormat::Enum m_format;
@@ -65,16 +68,37 @@ class FrameBuffer
 		}
 		
 		
-		bgfx::TextureHandle getRenderbufferHandle(int idx) const 
+		bgfx::TextureHandle getRenderbufferHandle(int idx) const
 		{
 			if (idx >= m_declaration.m_renderbuffers_count ) return BGFX_INVALID_HANDLE;
 			return m_declaration.m_renderbuffers[idx].m_handle;
 		}
 
+		// Queues an asynchronous readback of a renderbuffer; the callback is
+		// invoked from checkReadbacks a few frames later, once the data has
+		// been copied back without stalling the GPU.
+		bool readAsync(int renderbuffer_idx, u8 blit_view, IAllocator& allocator, const ReadbackCallback& callback);
+		void checkReadbacks(u32 frame_number);
+
+	private:
+		struct AsyncReadback
+		{
+			bgfx::TextureHandle m_texture;
+			u32 m_ready_frame;
+			int m_width;
+			int m_height;
+			u8* m_data;
+			IAllocator* m_allocator;
+			ReadbackCallback m_callback;
+		};
+
+		static const int MAX_ASYNC_READBACKS = 4;
+
 	private:
 		void destroyRenderbuffers();
 
 	private:
+		AsyncReadback m_readbacks[MAX_ASYNC_READBACKS];
 		bool m_autodestroy_handle;
 		void* m_window_handle;
 		bgfx::FrameBufferHandle m_handle;
@@ -1,4 +1,5 @@
 #include "renderer/material.h"
+#include "engine/blob.h"
 #include "engine/crc32.h"
 #include "engine/fs/file_system.h"
 #include "engine/json_serializer.h"
@@ -23,6 +24,8 @@ static const ResourceType TEXTURE_TYPE("texture");
 static const ResourceType SHADER_TYPE("shader");
 static const ResourceType MATERIAL_TYPE("material");
 static const float DEFAULT_ALPHA_REF_VALUE = 0.3f;
+static const u32 BINARY_MAGIC = 0x5f4c4d42; // == '_LMB'
+static const u32 BINARY_VERSION = 0;
 
 
 static struct CustomFlags
@@ -279,6 +282,86 @@ bool Material::save(JsonSerializer& serializer)
 }
 
 
+bool Material::saveBinary(OutputBlob& blob)
+{
+	if (!isReady()) return false;
+	if (!m_shader) return false;
+
+	auto& renderer = static_cast<MaterialManager&>(m_resource_manager).getRenderer();
+
+	blob.write(BINARY_MAGIC);
+	blob.write(BINARY_VERSION);
+	blob.write(isBackfaceCulling());
+	blob.write(m_alpha_ref);
+	blob.write(m_color);
+	blob.write(m_metallic);
+	blob.write(m_roughness);
+	blob.write(m_layers_count);
+	// layer, define and custom flag indices are assigned per session, so names
+	// go to disk and are resolved again on load
+	blob.writeString(renderer.getLayerName(m_render_layer));
+
+	i32 custom_flag_count = 0;
+	for (int i = 0; i < 32; ++i)
+	{
+		if (m_custom_flags & (1 << i)) ++custom_flag_count;
+	}
+	blob.write(custom_flag_count);
+	for (int i = 0; i < 32; ++i)
+	{
+		if (m_custom_flags & (1 << i)) blob.writeString(s_custom_flags.flags[i]);
+	}
+
+	i32 define_count = 0;
+	for (int i = 0; i < sizeof(m_define_mask) * 8; ++i)
+	{
+		if ((m_define_mask & (1 << i)) == 0) continue;
+		if (equalStrings("SKINNED", renderer.getShaderDefine(i))) continue;
+		++define_count;
+	}
+	blob.write(define_count);
+	for (int i = 0; i < sizeof(m_define_mask) * 8; ++i)
+	{
+		if ((m_define_mask & (1 << i)) == 0) continue;
+		const char* def = renderer.getShaderDefine(i);
+		if (equalStrings("SKINNED", def)) continue;
+		blob.writeString(def);
+	}
+
+	blob.write(m_shader->m_uniforms.size());
+	for (int i = 0; i < m_shader->m_uniforms.size(); ++i)
+	{
+		blob.write(m_uniforms[i].name_hash);
+		blob.write(m_uniforms[i].matrix, sizeof(m_uniforms[i].matrix));
+	}
+
+	blob.write(m_texture_count);
+	for (int i = 0; i < m_texture_count; ++i)
+	{
+		char path[MAX_PATH_LENGTH];
+		u32 flags = 0;
+		bool keep_data = false;
+		if (m_textures[i])
+		{
+			flags = m_textures[i]->bgfx_flags;
+			keep_data = m_textures[i]->getData() != nullptr;
+			path[0] = '/';
+			copyString(path + 1, MAX_PATH_LENGTH - 1, m_textures[i]->getPath().c_str());
+		}
+		else
+		{
+			path[0] = '\0';
+		}
+		blob.writeString(path);
+		blob.write(flags);
+		blob.write(keep_data);
+	}
+
+	blob.writeString(m_shader->getPath().c_str());
+	return true;
+}
+
+
 void Material::deserializeCustomFlags(JsonSerializer& serializer)
 {
 	m_custom_flags = 0;
@@ -767,6 +850,133 @@ bool Material::isBackfaceCulling() const
 }
 
 
+bool Material::reloadInPlace(FS::IFile& file)
+{
+	PROFILE_FUNCTION();
+
+	// pin the current shader and textures so dependencies shared with the new
+	// definition never drop to zero references; a one-float uniform tweak then
+	// reparses the material without touching any GPU object
+	Shader* old_shader = m_shader;
+	if (old_shader) old_shader->getResourceManager().load(*old_shader);
+
+	Texture* old_textures[MAX_TEXTURE_COUNT];
+	int old_texture_count = m_texture_count;
+	for (int i = 0; i < old_texture_count; ++i)
+	{
+		old_textures[i] = m_textures[i];
+		if (old_textures[i]) old_textures[i]->getResourceManager().load(*old_textures[i]);
+	}
+
+	unload();
+	bool success = load(file);
+
+	if (old_shader) old_shader->getResourceManager().unload(*old_shader);
+	for (int i = 0; i < old_texture_count; ++i)
+	{
+		if (old_textures[i]) old_textures[i]->getResourceManager().unload(*old_textures[i]);
+	}
+	if (!success) return false;
+
+	// a dependency new to this definition may still be loading, checkState
+	// notifies observers the usual way in that case
+	checkState();
+	return true;
+}
+
+
+bool Material::loadBinary(InputBlob& blob, const char* material_dir)
+{
+	auto& renderer = static_cast<MaterialManager&>(m_resource_manager).getRenderer();
+
+	u32 version;
+	blob.read(version);
+	if (version > BINARY_VERSION)
+	{
+		g_log_error.log("Renderer") << "Unsupported binary material version in " << getPath();
+		return false;
+	}
+
+	bool backface_culling;
+	blob.read(backface_culling);
+	enableBackfaceCulling(backface_culling);
+	float alpha_ref;
+	blob.read(alpha_ref);
+	setAlphaRef(alpha_ref);
+	blob.read(m_color);
+	blob.read(m_metallic);
+	blob.read(m_roughness);
+	blob.read(m_layers_count);
+
+	char tmp[MAX_PATH_LENGTH];
+	blob.readString(tmp, lengthOf(tmp));
+	m_render_layer = renderer.getLayer(tmp);
+	m_render_layer_mask = 1ULL << (u64)m_render_layer;
+
+	i32 custom_flag_count;
+	blob.read(custom_flag_count);
+	m_custom_flags = 0;
+	for (int i = 0; i < custom_flag_count; ++i)
+	{
+		blob.readString(tmp, lengthOf(tmp));
+		setCustomFlag(getCustomFlag(tmp));
+	}
+
+	i32 define_count;
+	blob.read(define_count);
+	m_define_mask = 0;
+	for (int i = 0; i < define_count; ++i)
+	{
+		blob.readString(tmp, lengthOf(tmp));
+		m_define_mask |= 1 << renderer.getShaderDefineIdx(tmp);
+	}
+
+	i32 uniform_count;
+	blob.read(uniform_count);
+	for (int i = 0; i < uniform_count; ++i)
+	{
+		Uniform& uniform = m_uniforms.emplace();
+		blob.read(uniform.name_hash);
+		blob.read(uniform.matrix, sizeof(uniform.matrix));
+	}
+
+	i32 texture_count;
+	blob.read(texture_count);
+	for (int i = 0; i < texture_count; ++i)
+	{
+		char path[MAX_PATH_LENGTH];
+		blob.readString(path, lengthOf(path));
+		u32 flags;
+		blob.read(flags);
+		bool keep_data;
+		blob.read(keep_data);
+		if (path[0] != '\0')
+		{
+			char texture_path[MAX_PATH_LENGTH];
+			if (path[0] != '/' && path[0] != '\\')
+			{
+				copyString(texture_path, material_dir);
+				catString(texture_path, path);
+			}
+			else
+			{
+				copyString(texture_path, path);
+			}
+			auto* mng = m_resource_manager.getOwner().get(TEXTURE_TYPE);
+			m_textures[m_texture_count] = static_cast<Texture*>(mng->load(Path(texture_path)));
+			addDependency(*m_textures[m_texture_count]);
+			m_textures[m_texture_count]->setFlags(flags);
+			if (keep_data) m_textures[m_texture_count]->addDataReference();
+		}
+		++m_texture_count;
+	}
+
+	blob.readString(tmp, lengthOf(tmp));
+	setShader(Path(tmp));
+	return true;
+}
+
+
 bool Material::load(FS::IFile& file)
 {
 	PROFILE_FUNCTION();
@@ -776,11 +986,38 @@ bool Material::load(FS::IFile& file)
 	m_render_states = BGFX_STATE_CULL_CW;
 	setAlphaRef(DEFAULT_ALPHA_REF_VALUE);
 	m_uniforms.clear();
+
+	char material_dir[MAX_PATH_LENGTH];
+	PathUtils::getDir(material_dir, MAX_PATH_LENGTH, getPath().c_str());
+
+	u32 magic = 0;
+	if (file.size() >= sizeof(magic)) file.read(&magic, sizeof(magic));
+	if (magic == BINARY_MAGIC)
+	{
+		// compiled material, the whole definition is consumed in a single read
+		int size = (int)file.size() - (int)sizeof(magic);
+		Array<u8> data(m_allocator);
+		const u8* mem = (const u8*)file.getBuffer();
+		if (mem)
+		{
+			mem += sizeof(magic);
+		}
+		else
+		{
+			data.resize(size);
+			file.read(&data[0], size);
+			mem = &data[0];
+		}
+		InputBlob blob(mem, size);
+		if (!loadBinary(blob, material_dir)) return false;
+		m_size = file.size();
+		return true;
+	}
+	file.seek(FS::SeekMode::BEGIN, 0);
+
 	JsonSerializer serializer(file, JsonSerializer::READ, getPath(), m_allocator);
 	serializer.deserializeObjectBegin();
 	char label[256];
-	char material_dir[MAX_PATH_LENGTH];
-	PathUtils::getDir(material_dir, MAX_PATH_LENGTH, getPath().c_str());
 	while (!serializer.isObjectEnd())
 	{
 		serializer.deserializeLabel(label, 255);
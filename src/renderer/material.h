@@ -15,7 +15,9 @@ namespace FS
 	class IFile;
 }
 
+class InputBlob;
 class JsonSerializer;
+class OutputBlob;
 class ResourceManager;
 class Shader;
 struct ShaderInstance;
@@ -73,6 +75,9 @@ public:
 	void setTexture(int i, Texture* texture);
 	void setTexturePath(int i, const Path& path);
 	bool save(JsonSerializer& serializer);
+	// bakes the current state into the compiled binary format; json stays the
+	// authoring format, load() accepts either
+	bool saveBinary(OutputBlob& blob);
 	int getUniformCount() const { return m_uniforms.size(); }
 	Uniform& getUniform(int index) { return m_uniforms[index]; }
 	const Uniform& getUniform(int index) const { return m_uniforms[index]; }
@@ -102,7 +107,9 @@ private:
 	void onBeforeReady() override;
 	void unload(void) override;
 	bool load(FS::IFile& file) override;
+	bool reloadInPlace(FS::IFile& file) override;
 
+	bool loadBinary(InputBlob& blob, const char* material_dir);
 	bool deserializeTexture(JsonSerializer& serializer, const char* material_dir);
 	void deserializeUniforms(JsonSerializer& serializer);
 	void deserializeDefines(JsonSerializer& serializer);
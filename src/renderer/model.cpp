@@ -60,13 +60,16 @@ Model::Model(const Path& path, ResourceManagerBase& resource_manager, IAllocator
 	, m_bone_map(m_allocator)
 	, m_meshes(m_allocator)
 	, m_bones(m_allocator)
-	, m_indices(m_allocator)
+	, m_geometry_data(m_allocator)
+	, m_indices_data(nullptr)
+	, m_indices_count(0)
 	, m_vertices(m_allocator)
 	, m_uvs(m_allocator)
 	, m_vertices_handle(BGFX_INVALID_HANDLE)
 	, m_indices_handle(BGFX_INVALID_HANDLE)
 	, m_first_nonroot_bone_index(0)
 	, m_flags(0)
+	, m_has_occluder_meshes(false)
 {
 	m_lods[0] = { 0, -1, FLT_MAX };
 	m_lods[1] = { 0, -1, FLT_MAX };
@@ -95,8 +98,8 @@ RayCastModelHit Model::castRay(const Vec3& origin,
 	Vec3 local_dir = static_cast<Vec3>(inv * Vec4(dir.x, dir.y, dir.z, 0));
 
 	const Array<Vec3>& vertices = m_vertices;
-	u16* indices16 = (u16*)&m_indices[0];
-	u32* indices32 = (u32*)&m_indices[0];
+	const u16* indices16 = (const u16*)m_indices_data;
+	const u32* indices32 = (const u32*)m_indices_data;
 	int vertex_offset = 0;
 	bool is16 = m_flags & (u32)Model::Flags::INDICES_16BIT;
 	for (int mesh_index = m_lods[0].from_mesh; mesh_index <= m_lods[0].to_mesh; ++mesh_index)
@@ -296,6 +299,9 @@ void Model::create(const bgfx::VertexDecl& vertex_decl,
 	ASSERT(!bgfx::isValid(m_indices_handle));
 	auto* mem = bgfx::copy(indices_data, indices_size);
 	m_indices_handle = bgfx::createIndexBuffer(mem, BGFX_BUFFER_INDEX32);
+
+	Profiler::trackGPUAlloc(Profiler::GPUCategory::VERTEX_BUFFER, getPath().c_str(), attributes_size);
+	Profiler::trackGPUAlloc(Profiler::GPUCategory::INDEX_BUFFER, getPath().c_str(), indices_size);
 	m_meshes.emplace(material, 0, attributes_size, 0, indices_size / int(sizeof(int)), "default", m_allocator);
 
 	Model::LOD lod;
@@ -304,8 +310,10 @@ void Model::create(const bgfx::VertexDecl& vertex_decl,
 	lod.to_mesh = 0;
 	m_lods[0] = lod;
 
-	m_indices.resize(indices_size);
-	copyMemory(&m_indices[0], indices_data, indices_size);
+	m_geometry_data.resize(indices_size);
+	copyMemory(&m_geometry_data[0], indices_data, indices_size);
+	m_indices_data = &m_geometry_data[0];
+	m_indices_count = indices_size / int(sizeof(int));
 
 	m_vertices.resize(attributes_size / vertex_decl.getStride());
 	m_uvs.resize(m_vertices.size());
@@ -361,22 +369,55 @@ bool Model::parseGeometry(FS::IFile& file, FileVersion version)
 	if (indices_count <= 0) return false;
 
 	int index_size = (m_flags & (u32)Model::Flags::INDICES_16BIT) ? 2 : 4;
-	m_indices.resize(indices_count * index_size);
-	file.read(&m_indices[0], index_size * indices_count);
+	int indices_size = index_size * indices_count;
+	m_indices_count = indices_count;
 
+	const u8* vertices_data;
 	i32 vertices_size = 0;
-	file.read(&vertices_size, sizeof(vertices_size));
-	if (vertices_size <= 0) return false;
-
-	ASSERT(!bgfx::isValid(m_vertices_handle));
-	const bgfx::Memory* vertices_mem = bgfx::alloc(vertices_size);
-	file.read(vertices_mem->data, vertices_size);
-	m_vertices_handle = bgfx::createVertexBuffer(vertices_mem, m_vertex_decl);
+	if (version > FileVersion::SINGLE_BLOB_GEOMETRY)
+	{
+		file.read(&vertices_size, sizeof(vertices_size));
+		if (vertices_size <= 0) return false;
+
+		// indices and vertices are stored as one blob, the vertex data aligned
+		// to 16 bytes behind the indices, so a single read gets both and the
+		// GPU buffers can reference the blob without a staging copy
+		int vertices_offset = (indices_size + 15) & ~15;
+		m_geometry_data.resize(vertices_offset + vertices_size);
+		file.read(&m_geometry_data[0], m_geometry_data.size());
+		m_indices_data = &m_geometry_data[0];
+		vertices_data = &m_geometry_data[vertices_offset];
+
+		ASSERT(!bgfx::isValid(m_vertices_handle));
+		m_vertices_handle =
+			bgfx::createVertexBuffer(bgfx::makeRef(vertices_data, vertices_size), m_vertex_decl);
+
+		ASSERT(!bgfx::isValid(m_indices_handle));
+		m_indices_handle = bgfx::createIndexBuffer(
+			bgfx::makeRef(m_indices_data, indices_size), index_size == 4 ? BGFX_BUFFER_INDEX32 : 0);
+	}
+	else
+	{
+		m_geometry_data.resize(indices_size);
+		file.read(&m_geometry_data[0], indices_size);
+		m_indices_data = &m_geometry_data[0];
+
+		file.read(&vertices_size, sizeof(vertices_size));
+		if (vertices_size <= 0) return false;
+
+		ASSERT(!bgfx::isValid(m_vertices_handle));
+		const bgfx::Memory* vertices_mem = bgfx::alloc(vertices_size);
+		file.read(vertices_mem->data, vertices_size);
+		vertices_data = vertices_mem->data;
+		m_vertices_handle = bgfx::createVertexBuffer(vertices_mem, m_vertex_decl);
+
+		ASSERT(!bgfx::isValid(m_indices_handle));
+		const bgfx::Memory* mem = bgfx::copy(m_indices_data, indices_size);
+		m_indices_handle = bgfx::createIndexBuffer(mem, index_size == 4 ? BGFX_BUFFER_INDEX32 : 0);
+	}
 
-	ASSERT(!bgfx::isValid(m_indices_handle));
-	int indices_size = index_size * indices_count;
-	const bgfx::Memory* mem = bgfx::copy(&m_indices[0], indices_size);
-	m_indices_handle = bgfx::createIndexBuffer(mem, index_size == 4 ? BGFX_BUFFER_INDEX32 : 0);
+	Profiler::trackGPUAlloc(Profiler::GPUCategory::VERTEX_BUFFER, getPath().c_str(), vertices_size);
+	Profiler::trackGPUAlloc(Profiler::GPUCategory::INDEX_BUFFER, getPath().c_str(), indices_size);
 
 	int vertex_count = 0;
 	for (int i = 0; i < m_meshes.size(); ++i)
@@ -392,7 +433,7 @@ bool Model::parseGeometry(FS::IFile& file, FileVersion version)
 		file.read(&m_aabb, sizeof(m_aabb));
 	}
 
-	computeRuntimeData(vertices_mem->data, version <= FileVersion::BOUNDING_SHAPES_PRECOMPUTED);
+	computeRuntimeData(vertices_data, version <= FileVersion::BOUNDING_SHAPES_PRECOMPUTED);
 
 	return true;
 }
@@ -601,6 +642,14 @@ bool Model::load(FS::IFile& file)
 		&& parseLODs(file))
 	{
 		m_size = file.size();
+		for (const Mesh& mesh : m_meshes)
+		{
+			if (startsWith(mesh.name.c_str(), "occluder"))
+			{
+				m_has_occluder_meshes = true;
+				break;
+			}
+		}
 		return true;
 	}
 
@@ -659,11 +708,23 @@ void Model::unload(void)
 	m_bones.clear();
 	m_uvs.clear();
 	m_vertices.clear();
+	m_has_occluder_meshes = false;
 
-	if(bgfx::isValid(m_vertices_handle)) bgfx::destroyVertexBuffer(m_vertices_handle);
-	if(bgfx::isValid(m_indices_handle)) bgfx::destroyIndexBuffer(m_indices_handle);
+	if(bgfx::isValid(m_vertices_handle))
+	{
+		Profiler::untrackGPUAlloc(Profiler::GPUCategory::VERTEX_BUFFER, getPath().c_str());
+		bgfx::destroyVertexBuffer(m_vertices_handle);
+	}
+	if(bgfx::isValid(m_indices_handle))
+	{
+		Profiler::untrackGPUAlloc(Profiler::GPUCategory::INDEX_BUFFER, getPath().c_str());
+		bgfx::destroyIndexBuffer(m_indices_handle);
+	}
 	m_indices_handle = BGFX_INVALID_HANDLE;
 	m_vertices_handle = BGFX_INVALID_HANDLE;
+	m_geometry_data.clear();
+	m_indices_data = nullptr;
+	m_indices_count = 0;
 }
 
 
@@ -10,6 +10,7 @@
 #include "engine/vec.h"
 #include "engine/resource.h"
 #include <bgfx/bgfx.h>
+#include <cfloat>
 
 
 struct lua_State;
@@ -94,6 +95,7 @@ public:
 		WITH_FLAGS,
 		SINGLE_VERTEX_DECL,
 		BOUNDING_SHAPES_PRECOMPUTED,
+		SINGLE_BLOB_GEOMETRY,
 
 		LATEST // keep this last
 	};
@@ -144,6 +146,27 @@ public:
 		return {m_lods[i].from_mesh, m_lods[i].to_mesh};
 	}
 
+	// same as getLODMeshIndices, except instances cross into the next lod at
+	// per-seed offsets spread over the last quarter of the switch distance, so
+	// a group of instances fades over one by one instead of popping along a
+	// shared boundary circle
+	LODMeshIndices getDitheredLODMeshIndices(float squared_distance, u32 seed) const
+	{
+		int i = 0;
+		while (squared_distance >= m_lods[i].distance) ++i;
+		float next_distance = m_lods[i].distance;
+		if (next_distance < FLT_MAX && m_lods[i + 1].to_mesh >= 0)
+		{
+			float band_start = next_distance * 0.75f;
+			if (squared_distance >= band_start)
+			{
+				float offset = ((seed * 2654435761u) >> 16 & 0xffff) * (1.0f / 65535.0f);
+				if (squared_distance >= band_start + (next_distance - band_start) * offset) ++i;
+			}
+		}
+		return {m_lods[i].from_mesh, m_lods[i].to_mesh};
+	}
+
 	Mesh& getMesh(int index) { return m_meshes[index]; }
 	bgfx::VertexBufferHandle getVerticesHandle() const { return m_vertices_handle; }
 	bgfx::IndexBufferHandle getIndicesHandle() const { return m_indices_handle; }
@@ -160,13 +183,14 @@ public:
 	RayCastModelHit castRay(const Vec3& origin, const Vec3& dir, const Matrix& model_transform);
 	const AABB& getAABB() const { return m_aabb; }
 	LOD* getLODs() { return m_lods; }
-	const u16* getIndices16() const { return areIndices16() ? (u16*)&m_indices[0] : nullptr; }
-	const u32* getIndices32() const { return areIndices16() ? nullptr : (u32*)&m_indices[0]; }
+	const u16* getIndices16() const { return areIndices16() ? (const u16*)m_indices_data : nullptr; }
+	const u32* getIndices32() const { return areIndices16() ? nullptr : (const u32*)m_indices_data; }
 	bool areIndices16() const { return (m_flags & (u32)Flags::INDICES_16BIT) != 0; }
-	int getIndicesCount() const { return m_indices.size() / (areIndices16() ? 2 : 4); }
+	int getIndicesCount() const { return m_indices_count; }
 	const Array<Vec3>& getVertices() const { return m_vertices; }
 	const Array<Vec2>& getUVs() const { return m_uvs; }
 	u32 getFlags() const { return m_flags;	}
+	bool hasOccluderMeshes() const { return m_has_occluder_meshes; }
 
 	static void registerLuaAPI(lua_State* L);
 
@@ -197,7 +221,11 @@ private:
 	bgfx::VertexBufferHandle m_vertices_handle;
 	Array<Mesh> m_meshes;
 	Array<Bone> m_bones;
-	Array<u8> m_indices;
+	// single allocation holding the index (and with SINGLE_BLOB_GEOMETRY also
+	// the vertex) data; GPU buffers reference it without a staging copy
+	Array<u8> m_geometry_data;
+	const u8* m_indices_data;
+	int m_indices_count;
 	Array<Vec3> m_vertices;
 	Array<Vec2> m_uvs;
 	LOD m_lods[MAX_LOD_COUNT];
@@ -206,6 +234,7 @@ private:
 	AABB m_aabb;
 	u32 m_flags;
 	int m_first_nonroot_bone_index;
+	bool m_has_occluder_meshes;
 };
 
 
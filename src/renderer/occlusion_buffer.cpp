@@ -0,0 +1,242 @@
+#include "occlusion_buffer.h"
+#include "engine/geometry.h"
+#include "engine/math_utils.h"
+#include "engine/profiler.h"
+#include "engine/string.h"
+#include "renderer/model.h"
+#include <cfloat>
+#include <cmath>
+
+
+namespace Lumix
+{
+
+
+static const int MAX_CLIPPED_VERTICES = 8;
+
+
+static bool isOccluderMesh(const Mesh& mesh)
+{
+	return startsWith(mesh.name.c_str(), "occluder");
+}
+
+
+OcclusionBuffer::OcclusionBuffer(IAllocator& allocator)
+	: m_depth(allocator)
+	, m_clip_vertices(allocator)
+	, m_has_occluders(false)
+	, m_near_distance(0)
+	, m_tan_half_fov(1)
+	, m_ratio(1)
+{
+	m_depth.resize(WIDTH * HEIGHT);
+}
+
+
+void OcclusionBuffer::begin(const Frustum& frustum)
+{
+	PROFILE_FUNCTION();
+	ASSERT(frustum.fov > 0);
+
+	for (float& depth : m_depth) depth = FLT_MAX;
+	m_has_occluders = false;
+
+	m_camera_position = frustum.position;
+	m_camera_direction = frustum.direction;
+	m_camera_direction.normalize();
+	m_near_distance = frustum.near_distance;
+	m_tan_half_fov = tanf(frustum.fov * 0.5f);
+	m_ratio = frustum.ratio;
+
+	Matrix view;
+	view.lookAt(frustum.position, frustum.position + m_camera_direction, frustum.up);
+	Matrix projection;
+	projection.setPerspective(frustum.fov, frustum.ratio, frustum.near_distance, frustum.far_distance, false);
+	m_view_proj_matrix = projection * view;
+}
+
+
+void OcclusionBuffer::rasterizeScreenTriangle(const Vec2& a, const Vec2& b, const Vec2& c, float depth)
+{
+	float signed_area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+	if (signed_area == 0) return;
+	const Vec2& v1 = signed_area > 0 ? b : c;
+	const Vec2& v2 = signed_area > 0 ? c : b;
+
+	int min_x = Math::maximum(0, int(Math::minimum(a.x, v1.x, v2.x)));
+	int max_x = Math::minimum(WIDTH - 1, int(Math::maximum(a.x, v1.x, v2.x)));
+	int min_y = Math::maximum(0, int(Math::minimum(a.y, v1.y, v2.y)));
+	int max_y = Math::minimum(HEIGHT - 1, int(Math::maximum(a.y, v1.y, v2.y)));
+	if (min_x > max_x || min_y > max_y) return;
+
+	for (int y = min_y; y <= max_y; ++y)
+	{
+		float py = y + 0.5f;
+		for (int x = min_x; x <= max_x; ++x)
+		{
+			float px = x + 0.5f;
+			float e0 = (v1.x - a.x) * (py - a.y) - (v1.y - a.y) * (px - a.x);
+			float e1 = (v2.x - v1.x) * (py - v1.y) - (v2.y - v1.y) * (px - v1.x);
+			float e2 = (a.x - v2.x) * (py - v2.y) - (a.y - v2.y) * (px - v2.x);
+			if (e0 < 0 || e1 < 0 || e2 < 0) continue;
+
+			float& pixel = m_depth[y * WIDTH + x];
+			if (depth < pixel)
+			{
+				pixel = depth;
+				m_has_occluders = true;
+			}
+		}
+	}
+}
+
+
+template <typename T>
+void OcclusionBuffer::rasterizeIndexed(const Matrix& mvp, const Vec3* vertices, const T* indices, int indices_count)
+{
+	for (int i = 0; i < indices_count; i += 3)
+	{
+		Vec4 clip[3];
+		for (int j = 0; j < 3; ++j)
+		{
+			clip[j] = mvp * Vec4(vertices[indices[i + j]], 1);
+		}
+		rasterizeClipSpaceTriangle(clip);
+	}
+}
+
+
+template <typename T>
+void OcclusionBuffer::rasterizeClipped(const Vec4* clip_vertices, const T* indices, int indices_count)
+{
+	for (int i = 0; i < indices_count; i += 3)
+	{
+		Vec4 clip[3] = {
+			clip_vertices[indices[i]], clip_vertices[indices[i + 1]], clip_vertices[indices[i + 2]]};
+		rasterizeClipSpaceTriangle(clip);
+	}
+}
+
+
+void OcclusionBuffer::rasterizeClipSpaceTriangle(const Vec4* clip)
+{
+	Vec4 clipped[MAX_CLIPPED_VERTICES];
+	int clipped_count = 0;
+
+	// clip against the near plane; with this projection w is the view
+	// depth, everything else is handled by the screen rect clamp
+	for (int j = 0; j < 3; ++j)
+	{
+		const Vec4& current = clip[j];
+		const Vec4& next = clip[(j + 1) % 3];
+		bool current_in = current.w >= m_near_distance;
+		bool next_in = next.w >= m_near_distance;
+		if (current_in) clipped[clipped_count++] = current;
+		if (current_in != next_in)
+		{
+			float t = (m_near_distance - current.w) / (next.w - current.w);
+			clipped[clipped_count++] = current + (next - current) * t;
+		}
+	}
+	if (clipped_count < 3) return;
+
+	Vec2 screen[MAX_CLIPPED_VERTICES];
+	float depth = 0;
+	for (int j = 0; j < clipped_count; ++j)
+	{
+		float inv_w = 1.0f / clipped[j].w;
+		screen[j].x = (clipped[j].x * inv_w * 0.5f + 0.5f) * WIDTH;
+		screen[j].y = (0.5f - clipped[j].y * inv_w * 0.5f) * HEIGHT;
+		depth = Math::maximum(depth, clipped[j].w);
+	}
+	for (int j = 2; j < clipped_count; ++j)
+	{
+		rasterizeScreenTriangle(screen[0], screen[j - 1], screen[j], depth);
+	}
+}
+
+
+void OcclusionBuffer::rasterize(const Matrix& world_matrix, const Vec3* vertices, const u16* indices, int indices_count)
+{
+	rasterizeIndexed(m_view_proj_matrix * world_matrix, vertices, indices, indices_count);
+}
+
+
+void OcclusionBuffer::rasterize(const Matrix& world_matrix, const Vec3* vertices, const u32* indices, int indices_count)
+{
+	rasterizeIndexed(m_view_proj_matrix * world_matrix, vertices, indices, indices_count);
+}
+
+
+void OcclusionBuffer::rasterizeOccluders(Model* model, const Matrix& world_matrix)
+{
+	PROFILE_FUNCTION();
+	const Vec3* vertices = &model->getVertices()[0];
+	const u16* indices16 = model->getIndices16();
+	const u32* indices32 = model->getIndices32();
+	Matrix mvp = m_view_proj_matrix * world_matrix;
+
+	int vertex_count = model->getVertices().size();
+	if (vertex_count == 0) return;
+	m_clip_vertices.resize(vertex_count);
+	Matrix::transformPoints(mvp, vertices, &m_clip_vertices[0], vertex_count);
+
+	for (int mesh_idx = 0, mesh_count = model->getMeshCount(); mesh_idx < mesh_count; ++mesh_idx)
+	{
+		const Mesh& mesh = model->getMesh(mesh_idx);
+		if (!isOccluderMesh(mesh)) continue;
+
+		if (indices16)
+		{
+			rasterizeClipped(&m_clip_vertices[0], indices16 + mesh.indices_offset, mesh.indices_count);
+		}
+		else
+		{
+			rasterizeClipped(&m_clip_vertices[0], indices32 + mesh.indices_offset, mesh.indices_count);
+		}
+	}
+}
+
+
+bool OcclusionBuffer::isOccluded(const Vec3& center, float radius) const
+{
+	if (!m_has_occluders) return false;
+
+	float sphere_depth = dotProduct(center - m_camera_position, m_camera_direction) - radius;
+	if (sphere_depth <= m_near_distance) return false;
+
+	Vec4 clip = m_view_proj_matrix * Vec4(center, 1);
+	if (clip.w <= 0) return false;
+	float inv_w = 1.0f / clip.w;
+
+	// project the radius at the sphere's nearest point so the footprint only
+	// gets bigger than the exact one
+	float radius_y = radius / (sphere_depth * m_tan_half_fov);
+	float radius_x = radius_y / m_ratio;
+	float center_x = (clip.x * inv_w * 0.5f + 0.5f) * WIDTH;
+	float center_y = (0.5f - clip.y * inv_w * 0.5f) * HEIGHT;
+
+	int min_x = int(center_x - radius_x * 0.5f * WIDTH);
+	int max_x = int(center_x + radius_x * 0.5f * WIDTH);
+	int min_y = int(center_y - radius_y * 0.5f * HEIGHT);
+	int max_y = int(center_y + radius_y * 0.5f * HEIGHT);
+	if (max_x < 0 || min_x >= WIDTH || max_y < 0 || min_y >= HEIGHT) return false;
+
+	min_x = Math::maximum(min_x, 0);
+	max_x = Math::minimum(max_x, WIDTH - 1);
+	min_y = Math::maximum(min_y, 0);
+	max_y = Math::minimum(max_y, HEIGHT - 1);
+
+	for (int y = min_y; y <= max_y; ++y)
+	{
+		const float* row = &m_depth[y * WIDTH];
+		for (int x = min_x; x <= max_x; ++x)
+		{
+			if (row[x] >= sphere_depth) return false;
+		}
+	}
+	return true;
+}
+
+
+} // namespace Lumix
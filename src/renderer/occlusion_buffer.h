@@ -0,0 +1,67 @@
+#pragma once
+
+
+#include "engine/array.h"
+#include "engine/lumix.h"
+#include "engine/matrix.h"
+
+
+namespace Lumix
+{
+
+
+class IAllocator;
+class Model;
+struct Frustum;
+
+
+// Software coverage buffer rasterized from designated occluder meshes (any
+// mesh whose name starts with "occluder"). Each pixel stores the distance of
+// the nearest covering occluder along the camera direction; a bounding sphere
+// is culled only when every pixel it can touch is behind a nearer occluder.
+// The test errs on the side of drawing: triangles write the farthest depth of
+// their vertices, spheres test with their nearest point and an enlarged
+// screen footprint.
+class LUMIX_RENDERER_API OcclusionBuffer
+{
+public:
+	enum
+	{
+		WIDTH = 384,
+		HEIGHT = 192
+	};
+
+public:
+	explicit OcclusionBuffer(IAllocator& allocator);
+
+	void begin(const Frustum& frustum);
+	void rasterizeOccluders(Model* model, const Matrix& world_matrix);
+	void rasterize(const Matrix& world_matrix, const Vec3* vertices, const u16* indices, int indices_count);
+	void rasterize(const Matrix& world_matrix, const Vec3* vertices, const u32* indices, int indices_count);
+	bool isOccluded(const Vec3& center, float radius) const;
+	bool hasOccluders() const { return m_has_occluders; }
+
+private:
+	template <typename T>
+	void rasterizeIndexed(const Matrix& mvp, const Vec3* vertices, const T* indices, int indices_count);
+	template <typename T>
+	void rasterizeClipped(const Vec4* clip_vertices, const T* indices, int indices_count);
+	void rasterizeClipSpaceTriangle(const Vec4* clip);
+	void rasterizeScreenTriangle(const Vec2& a, const Vec2& b, const Vec2& c, float depth);
+
+private:
+	Array<float> m_depth;
+	// scratch for rasterizeOccluders; vertices are shared by several triangles,
+	// so they are transformed once per model instead of once per index
+	Array<Vec4> m_clip_vertices;
+	Matrix m_view_proj_matrix;
+	Vec3 m_camera_position;
+	Vec3 m_camera_direction;
+	float m_near_distance;
+	float m_tan_half_fov;
+	float m_ratio;
+	bool m_has_occluders;
+};
+
+
+} // namespace Lumix
@@ -6,6 +6,7 @@
 #include "engine/property_register.h"
 #include "engine/resource_manager.h"
 #include "engine/resource_manager_base.h"
+#include "engine/simd.h"
 #include "editor/gizmo.h"
 #include "editor/world_editor.h"
 #include "renderer/material.h"
@@ -105,18 +106,6 @@ void ParticleEmitter::ForceModule::deserialize(InputBlob& blob)
 }
 
 
-void ParticleEmitter::ForceModule::update(float time_delta)
-{
-	if (m_emitter.m_velocity.empty()) return;
-
-	Vec3* LUMIX_RESTRICT particle_velocity = &m_emitter.m_velocity[0];
-	for (int i = 0, c = m_emitter.m_velocity.size(); i < c; ++i)
-	{
-		particle_velocity[i] += m_acceleration * time_delta;
-	}
-}
-
-
 const ComponentType ParticleEmitter::ForceModule::s_type = PropertyRegister::getComponentType("particle_emitter_force");
 
 
@@ -530,7 +519,6 @@ void ParticleEmitter::SizeModule::update(float)
 		int next_idx = Math::minimum(idx + 1, size);
 		float w = float_idx - idx;
 		particle_size[i] = m_sampled[idx] * (1 - w) + m_sampled[next_idx] * w;
-		PROFILE_INT("Test", int(particle_size[i] * 1000));
 	}
 }
 
@@ -609,6 +597,10 @@ ParticleEmitter::ParticleEmitter(Entity entity, Universe& universe, IAllocator&
 	, m_subimage_module(nullptr)
 	, m_autoemit(true)
 	, m_local_space(false)
+	, m_bounds_center(universe.getPosition(entity))
+	, m_bounds_radius(1)
+	, m_pending_dt(0)
+	, m_culled_frames(0)
 {
 	init();
 }
@@ -722,16 +714,31 @@ void ParticleEmitter::destroyParticle(int index)
 
 void ParticleEmitter::updateLives(float time_delta)
 {
-	for (int i = 0, c = m_rel_life.size(); i < c; ++i)
+	int count = m_rel_life.size();
+	if (count == 0) return;
+
+	float* LUMIX_RESTRICT rel_life = &m_rel_life[0];
+	float* LUMIX_RESTRICT life = &m_life[0];
+	float4 dt4 = f4Splat(time_delta);
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
 	{
-		float rel_life = m_rel_life[i];
-		rel_life += time_delta / m_life[i];
-		m_rel_life[i] = rel_life;
+		float4 l = f4Add(f4LoadUnaligned(rel_life + i), f4Div(dt4, f4LoadUnaligned(life + i)));
+		f4StoreUnaligned(rel_life + i, l);
+	}
+	for (; i < count; ++i)
+	{
+		rel_life[i] += time_delta / life[i];
+	}
 
-		if (rel_life > 1)
+	// expiry swap-removes across all the particle arrays, so it stays a
+	// separate scalar pass after the vector sweep
+	for (int j = 0, c = m_rel_life.size(); j < c; ++j)
+	{
+		if (m_rel_life[j] > 1)
 		{
-			destroyParticle(i);
-			--i;
+			destroyParticle(j);
+			--j;
 			--c;
 		}
 	}
@@ -795,20 +802,60 @@ void ParticleEmitter::deserialize(InputBlob& blob, ResourceManager& manager)
 }
 
 
-void ParticleEmitter::updatePositions(float time_delta)
+// one fused sweep integrating acceleration into the velocities and the
+// velocities into the positions; both arrays are treated as flat streams of
+// count * 3 floats, with the acceleration constant pre-rotated for the three
+// lane phases xyz takes inside a 12 float block
+void ParticleEmitter::updatePositions(float time_delta, const Vec3& acceleration)
 {
-	for (int i = 0, c = m_position.size(); i < c; ++i)
+	int count = m_position.size();
+	if (count == 0) return;
+
+	float* LUMIX_RESTRICT pos = (float*)&m_position[0];
+	float* LUMIX_RESTRICT vel = (float*)&m_velocity[0];
+	int float_count = count * 3;
+	Vec3 a = acceleration * time_delta;
+	float accel_pattern[12] = {a.x, a.y, a.z, a.x, a.y, a.z, a.x, a.y, a.z, a.x, a.y, a.z};
+	float4 accel4[3] = {
+		f4LoadUnaligned(accel_pattern), f4LoadUnaligned(accel_pattern + 4), f4LoadUnaligned(accel_pattern + 8)};
+	float4 dt4 = f4Splat(time_delta);
+	int i = 0;
+	for (; i + 12 <= float_count; i += 12)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			float4 v = f4Add(f4LoadUnaligned(vel + i + j * 4), accel4[j]);
+			f4StoreUnaligned(vel + i + j * 4, v);
+			float4 p = f4Add(f4LoadUnaligned(pos + i + j * 4), f4Mul(v, dt4));
+			f4StoreUnaligned(pos + i + j * 4, p);
+		}
+	}
+	const float a_arr[3] = {a.x, a.y, a.z};
+	for (; i < float_count; ++i)
 	{
-		m_position[i] += m_velocity[i] * time_delta;
+		vel[i] += a_arr[i % 3];
+		pos[i] += vel[i] * time_delta;
 	}
 }
 
 
 void ParticleEmitter::updateRotations(float time_delta)
 {
-	for (int i = 0, c = m_rotation.size(); i < c; ++i)
+	int count = m_rotation.size();
+	if (count == 0) return;
+
+	float* LUMIX_RESTRICT rot = &m_rotation[0];
+	float* LUMIX_RESTRICT speed = &m_rotational_speed[0];
+	float4 dt4 = f4Splat(time_delta);
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		float4 r = f4Add(f4LoadUnaligned(rot + i), f4Mul(f4LoadUnaligned(speed + i), dt4));
+		f4StoreUnaligned(rot + i, r);
+	}
+	for (; i < count; ++i)
 	{
-		m_rotation[i] += m_rotational_speed[i] * time_delta;
+		rot[i] += speed[i] * time_delta;
 	}
 }
 
@@ -816,13 +863,42 @@ void ParticleEmitter::updateRotations(float time_delta)
 void ParticleEmitter::update(float time_delta)
 {
 	spawnParticles(time_delta);
+	updateParticles(time_delta);
+}
+
+
+void ParticleEmitter::updateParticles(float time_delta)
+{
 	updateLives(time_delta);
-	updatePositions(time_delta);
+
+	// force modules only contribute a constant acceleration, so they are
+	// folded into the movement sweep instead of each touching every velocity
+	Vec3 acceleration(0, 0, 0);
+	for (auto* module : m_modules)
+	{
+		if (module->getType() == ForceModule::s_type)
+		{
+			acceleration += static_cast<ForceModule*>(module)->m_acceleration;
+		}
+	}
+	updatePositions(time_delta, acceleration);
 	updateRotations(time_delta);
 	for (auto* module : m_modules)
 	{
 		module->update(time_delta);
 	}
+
+	// positions are local when m_local_space, so measure against the origin
+	// there; the bounds stay valid while the emitter sleeps because nothing
+	// moves the particles in the meantime
+	Vec3 center = m_local_space ? Vec3(0, 0, 0) : m_universe.getPosition(m_entity);
+	float radius_squared = 0;
+	for (const Vec3& pos : m_position)
+	{
+		radius_squared = Math::maximum(radius_squared, (pos - center).squaredLength());
+	}
+	m_bounds_center = m_local_space ? m_universe.getPosition(m_entity) : center;
+	m_bounds_radius = sqrt(radius_squared) + 1;
 }
 
 
@@ -159,9 +159,10 @@ public:
 		explicit ForceModule(ParticleEmitter& emitter);
 		void serialize(OutputBlob& blob) override;
 		void deserialize(InputBlob& blob) override;
-		void update(float time_delta) override;
 		ComponentType getType() const override { return s_type; }
 
+		// no update(); the acceleration is folded into the emitter's fused
+		// movement sweep instead of running its own pass over the velocities
 		static const ComponentType s_type;
 		Vec3 m_acceleration;
 	};
@@ -221,6 +222,11 @@ public:
 	void serialize(OutputBlob& blob);
 	void deserialize(InputBlob& blob, ResourceManager& manager);
 	void update(float time_delta);
+	// the two halves of update(); spawning rolls the shared Math::randFloat
+	// state and must stay on the main thread, while the integration half is
+	// self-contained and safe to run one emitter per worker
+	void spawnParticles(float time_delta);
+	void updateParticles(float time_delta);
 	Material* getMaterial() const { return m_material; }
 	void setMaterial(Material* material);
 	IAllocator& getAllocator() { return m_allocator; }
@@ -249,13 +255,19 @@ public:
 	bool m_is_valid;
 	bool m_autoemit;
 	bool m_local_space;
+	// bounding sphere of the live particles, refreshed at the end of
+	// updateParticles; RenderScene uses it to slow down or sleep emitters no
+	// camera can see, accumulating the skipped time in m_pending_dt
+	Vec3 m_bounds_center;
+	float m_bounds_radius;
+	float m_pending_dt;
+	int m_culled_frames;
 
 private:
 	void spawnParticle();
 	void destroyParticle(int index);
-	void spawnParticles(float time_delta);
 	void updateLives(float time_delta);
-	void updatePositions(float time_delta);
+	void updatePositions(float time_delta, const Vec3& acceleration);
 	void updateRotations(float time_delta);
 
 private:
@@ -7,7 +7,13 @@
 #include "engine/lifo_allocator.h"
 #include "engine/log.h"
 #include "engine/lua_wrapper.h"
+#include "engine/math_utils.h"
+#include "engine/mtjd/for_each.h"
+#include "engine/mtjd/generic_job.h"
+#include "engine/mtjd/group.h"
+#include "engine/mtjd/manager.h"
 #include "engine/profiler.h"
+#include "engine/sort.h"
 #include "engine/engine.h"
 #include "imgui/imgui.h"
 #include "lua_script/lua_script_system.h"
@@ -26,6 +32,7 @@
 #include "engine/universe/universe.h"
 #include <bgfx/bgfx.h>
 #include <cmath>
+#include <cstdlib>
 
 
 namespace Lumix
@@ -34,6 +41,11 @@ namespace Lumix
 
 static const float SHADOW_CAM_NEAR = 50.0f;
 static const float SHADOW_CAM_FAR = 5000.0f;
+static const int LIGHT_CLUSTERS_X = 16;
+static const int LIGHT_CLUSTERS_Y = 16;
+static const int LIGHT_CLUSTERS_Z = 16;
+static const int MAX_CLUSTER_LIGHTS = 64;
+static const int LIGHT_INDICES_TEXTURE_SIZE = 256;
 static bool is_opengl = false;
 
 
@@ -48,6 +60,86 @@ struct InstanceData
 };
 
 
+struct SortedMesh
+{
+	u64 key;
+	const ModelInstanceMesh* info;
+};
+
+
+struct CachedBatch
+{
+	explicit CachedBatch(IAllocator& allocator)
+		: matrices(allocator)
+	{
+	}
+
+	Mesh* mesh;
+	Model* model;
+	Array<Matrix> matrices;
+};
+
+
+// retained draw list of one renderAll pass; as long as the frustum, the LOD
+// reference point and the scene version match, the coalesced batches and the
+// non-instanced mesh list are replayed instead of walking, keying and sorting
+// the visible meshes again
+struct CachedScenePass
+{
+	explicit CachedScenePass(IAllocator& allocator)
+		: batches(allocator)
+		, immediate_meshes(allocator)
+		, is_valid(false)
+	{
+	}
+
+	Array<CachedBatch> batches;
+	Array<ModelInstanceMesh> immediate_meshes;
+	Frustum frustum;
+	Vec3 lod_ref_point;
+	u64 layer_mask;
+	u32 scene_version;
+	bool is_valid;
+};
+
+
+// one bgfx view of a local light shadowmap (a spot light or one face of an
+// omni light cube); the matrices and the frustum are computed up front so
+// the influenced geometry of all views can be gathered in parallel jobs
+// before the serial bgfx recording
+struct ShadowView
+{
+	explicit ShadowView(IAllocator& allocator)
+		: meshes(allocator)
+	{
+	}
+
+	ComponentHandle light;
+	FrameBuffer* framebuffer;
+	Matrix view_matrix;
+	Matrix projection_matrix;
+	Frustum frustum;
+	bool use_frustum;
+	u16 view_x;
+	u16 view_y;
+	u16 width;
+	u16 height;
+	Array<ModelInstanceMesh> meshes;
+};
+
+
+static u64 getMeshSortKey(const ModelInstanceMesh& info, float squared_depth)
+{
+	// mesh identity (and through it material and shader) in the high bits so
+	// identical meshes end up contiguous after the sort, quantized depth in
+	// the low bits so distinct meshes are still submitted roughly front to
+	// back
+	u64 mesh_bits = (u64)(uintptr)info.mesh >> 4;
+	u32 depth_bits = (u32)Math::minimum(sqrtf(squared_depth) * 4.0f, (float)0xffFFff);
+	return (mesh_bits << 24) | depth_bits;
+}
+
+
 struct View
 {
 	u8 bgfx_id;
@@ -55,6 +147,10 @@ struct View
 	u64 render_state;
 	u32 stencil;
 	int pass_idx;
+	char name[32];
+	int draw_call_count;
+	int instance_count;
+	int triangle_count;
 	CommandBufferGenerator command_buffer;
 };
 
@@ -285,6 +381,12 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		, m_scene(nullptr)
 		, m_width(-1)
 		, m_height(-1)
+		, m_sync_point(true, allocator)
+		, m_pass_caches(allocator)
+		, m_pass_cache_idx(0)
+		, m_light_clusters_texture(BGFX_INVALID_HANDLE)
+		, m_light_indices_texture(BGFX_INVALID_HANDLE)
+		, m_debug_geometry_version(0xffffFFFF)
 	{
 		for (auto& handle : m_debug_vertex_buffers)
 		{
@@ -498,6 +600,13 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		m_terrain_matrix_uniform = bgfx::createUniform("u_terrainMatrix", bgfx::UniformType::Mat4);
 		m_decal_matrix_uniform = bgfx::createUniform("u_decalMatrix", bgfx::UniformType::Mat4);
 		m_emitter_matrix_uniform = bgfx::createUniform("u_emitterMatrix", bgfx::UniformType::Mat4);
+		m_cluster_params_uniform = bgfx::createUniform("u_clusterParams", bgfx::UniformType::Vec4);
+		m_cluster_light_pos_radius_uniform =
+			bgfx::createUniform("u_clusterLightPosRadius", bgfx::UniformType::Vec4, MAX_CLUSTER_LIGHTS);
+		m_cluster_light_color_attenuation_uniform =
+			bgfx::createUniform("u_clusterLightRgbAttenuation", bgfx::UniformType::Vec4, MAX_CLUSTER_LIGHTS);
+		m_tex_light_clusters_uniform = bgfx::createUniform("u_texLightClusters", bgfx::UniformType::Int1);
+		m_tex_light_indices_uniform = bgfx::createUniform("u_texLightIndices", bgfx::UniformType::Int1);
 	}
 
 
@@ -526,6 +635,13 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		bgfx::destroyUniform(m_texture_size_uniform);
 		bgfx::destroyUniform(m_decal_matrix_uniform);
 		bgfx::destroyUniform(m_emitter_matrix_uniform);
+		bgfx::destroyUniform(m_cluster_params_uniform);
+		bgfx::destroyUniform(m_cluster_light_pos_radius_uniform);
+		bgfx::destroyUniform(m_cluster_light_color_attenuation_uniform);
+		bgfx::destroyUniform(m_tex_light_clusters_uniform);
+		bgfx::destroyUniform(m_tex_light_indices_uniform);
+		if (bgfx::isValid(m_light_clusters_texture)) bgfx::destroyTexture(m_light_clusters_texture);
+		if (bgfx::isValid(m_light_indices_texture)) bgfx::destroyTexture(m_light_indices_texture);
 	}
 
 
@@ -569,6 +685,8 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	void renderParticlesFromEmitter(const ParticleEmitter& emitter)
 	{
 		static const int PARTICLE_BATCH_SIZE = 256;
+		// below this the forEach scheduling overhead outweighs the fill itself
+		static const int PARALLEL_FILL_MIN = 4096;
 
 		if (emitter.m_life.empty()) return;
 		if (!emitter.getMaterial()) return;
@@ -591,9 +709,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 			bgfx::setIndexBuffer(m_particle_index_buffer);
 			bgfx::setStencil(view.stencil, BGFX_STENCIL_NONE);
 			bgfx::setState(view.render_state | material->getRenderStates());
-			++m_stats.draw_call_count;
-			m_stats.instance_count += count;
-			m_stats.triangle_count += count * 2;
+			addDrawStats(view, count, count * 2);
 			bgfx::setUniform(m_emitter_matrix_uniform, &mtx);
 			bgfx::submit(view.bgfx_id, material->getShaderInstance().getProgramHandle(view.pass_idx));
 		};
@@ -612,24 +728,37 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 			float h = 1.0f / rows;
 			material->setDefine(subimage_define_idx, true);
 			int size = emitter.m_subimage_module->rows * emitter.m_subimage_module->cols;
-			instance_buffer = bgfx::allocInstanceDataBuffer(emitter.m_life.size(), sizeof(Instance));
-			Instance* instance = (Instance*)instance_buffer->data;
-			for (int i = 0, c = emitter.m_life.size(); i < c; ++i)
+			instance_buffer = m_renderer.allocInstanceDataBuffer(
+				Renderer::TransientClient::PARTICLES, emitter.m_life.size(), sizeof(Instance));
+			if (!instance_buffer) return;
+			auto fill = [&emitter, instance_buffer, size, cols, w, h](int from, int to) {
+				Instance* instance = (Instance*)instance_buffer->data + from;
+				for (int i = from; i < to; ++i)
+				{
+					instance->pos.set(emitter.m_position[i], emitter.m_size[i]);
+					instance->alpha_and_rotation.set(emitter.m_alpha[i], emitter.m_rotation[i], 0, 0);
+					float fidx = emitter.m_rel_life[i] * size;
+					int idx = int(fidx);
+					float t = fidx - idx;
+					float row0 = h * (idx / cols);
+					float col0 = w * (idx % cols);
+					float row1 = h * ((idx + 1) / cols);
+					float col1 = w * ((idx + 1) % cols);
+					instance->uv_params0.set(col0, row0, w, h);
+					instance->uv_params1.set(col1, row1, t, 0);
+					++instance;
+				}
+			};
+			int count = emitter.m_life.size();
+			if (count >= PARALLEL_FILL_MIN)
+			{
+				MTJD::forEach(m_renderer.getEngine().getMTJDManager(), m_allocator, 0, count, 0, fill);
+			}
+			else
 			{
-				instance->pos.set(emitter.m_position[i], emitter.m_size[i]);
-				instance->alpha_and_rotation.set(emitter.m_alpha[i], emitter.m_rotation[i], 0, 0);
-				float fidx = emitter.m_rel_life[i] * size;
-				int idx = int(fidx);
-				float t = fidx - idx;
-				float row0 = h * (idx / cols);
-				float col0 = w * (idx % cols);
-				float row1 = h * ((idx + 1) / cols);
-				float col1 = w * ((idx + 1) % cols);
-				instance->uv_params0.set(col0, row0, w, h);
-				instance->uv_params1.set(col1, row1, t, 0);
-				++instance;
+				fill(0, count);
 			}
-			draw(instance_buffer, emitter.m_life.size());
+			draw(instance_buffer, count);
 		}
 		else
 		{
@@ -639,15 +768,28 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 				Vec4 alpha_and_rotation;
 			};
 			material->setDefine(subimage_define_idx, false);
-			instance_buffer = bgfx::allocInstanceDataBuffer(emitter.m_life.size(), sizeof(Instance));
-			Instance* instance = (Instance*)instance_buffer->data;
-			for (int i = 0, c = emitter.m_life.size(); i < c; ++i)
+			instance_buffer = m_renderer.allocInstanceDataBuffer(
+				Renderer::TransientClient::PARTICLES, emitter.m_life.size(), sizeof(Instance));
+			if (!instance_buffer) return;
+			auto fill = [&emitter, instance_buffer](int from, int to) {
+				Instance* instance = (Instance*)instance_buffer->data + from;
+				for (int i = from; i < to; ++i)
+				{
+					instance->pos = Vec4(emitter.m_position[i], emitter.m_size[i]);
+					instance->alpha_and_rotation = Vec4(emitter.m_alpha[i], emitter.m_rotation[i], 0, 0);
+					++instance;
+				}
+			};
+			int count = emitter.m_life.size();
+			if (count >= PARALLEL_FILL_MIN)
 			{
-				instance->pos = Vec4(emitter.m_position[i], emitter.m_size[i]);
-				instance->alpha_and_rotation = Vec4(emitter.m_alpha[i], emitter.m_rotation[i], 0, 0);
-				++instance;
+				MTJD::forEach(m_renderer.getEngine().getMTJDManager(), m_allocator, 0, count, 0, fill);
 			}
-			draw(instance_buffer, emitter.m_life.size());
+			else
+			{
+				fill(0, count);
+			}
+			draw(instance_buffer, count);
 		}
 	}
 
@@ -721,6 +863,169 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	}
 
 
+	// Assigns the point lights visible in the applied camera's frustum to a
+	// froxel grid and uploads the result as a cluster texture, a light index
+	// texture and light uniform arrays, so a pipeline can light all geometry
+	// in a single pass instead of re-rendering lit geometry per light.
+	void bindLightClusters()
+	{
+		if (m_applied_camera == INVALID_COMPONENT) return;
+		PROFILE_FUNCTION();
+
+		if (!bgfx::isValid(m_light_clusters_texture))
+		{
+			u32 flags = BGFX_TEXTURE_MIN_POINT | BGFX_TEXTURE_MAG_POINT | BGFX_TEXTURE_U_CLAMP |
+						BGFX_TEXTURE_V_CLAMP;
+			m_light_clusters_texture = bgfx::createTexture2D(LIGHT_CLUSTERS_X,
+				LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z,
+				false,
+				1,
+				bgfx::TextureFormat::RG32F,
+				flags);
+			m_light_indices_texture = bgfx::createTexture2D(LIGHT_INDICES_TEXTURE_SIZE,
+				LIGHT_INDICES_TEXTURE_SIZE,
+				false,
+				1,
+				bgfx::TextureFormat::R32F,
+				flags);
+		}
+
+		IAllocator& frame_allocator = m_renderer.getEngine().getLIFOAllocator();
+		Array<ComponentHandle> lights(frame_allocator);
+		m_scene->getPointLights(m_camera_frustum, lights);
+		int light_count = Math::minimum(lights.size(), MAX_CLUSTER_LIGHTS);
+
+		Universe& universe = m_scene->getUniverse();
+		Matrix view = universe.getMatrix(m_scene->getCameraEntity(m_applied_camera));
+		view.fastInverse();
+		float near_plane = m_camera_frustum.near_distance;
+		float far_plane = m_camera_frustum.far_distance;
+		float tan_half_fov = tanf(m_camera_frustum.fov * 0.5f);
+		float ratio = m_camera_frustum.ratio;
+
+		Array<Vec4> light_pos_radius(frame_allocator);
+		Array<Vec4> light_color_attenuation(frame_allocator);
+		Array<Vec4> view_lights(frame_allocator);
+		light_pos_radius.resize(light_count);
+		light_color_attenuation.resize(light_count);
+		view_lights.resize(light_count);
+		for (int i = 0; i < light_count; ++i)
+		{
+			ComponentHandle light = lights[i];
+			Vec3 pos = universe.getPosition(m_scene->getPointLightEntity(light));
+			float range = m_scene->getLightRange(light);
+			float intensity = m_scene->getPointLightIntensity(light);
+			intensity *= intensity;
+			light_pos_radius[i] = Vec4(pos, range);
+			light_color_attenuation[i] =
+				Vec4(m_scene->getPointLightColor(light) * intensity, m_scene->getLightAttenuation(light));
+			Vec3 view_pos = view.transform(pos);
+			view_lights[i] = Vec4(view_pos.x, view_pos.y, -view_pos.z, range);
+		}
+
+		Array<u64> masks(frame_allocator);
+		masks.resize(LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z);
+		u64* masks_ptr = &masks[0];
+		const Vec4* view_lights_ptr = light_count > 0 ? &view_lights[0] : nullptr;
+		float slice_size = (far_plane - near_plane) / LIGHT_CLUSTERS_Z;
+		Array<MTJD::Job*> jobs(frame_allocator);
+		jobs.reserve(LIGHT_CLUSTERS_Z);
+		for (int slice = 0; slice < LIGHT_CLUSTERS_Z; ++slice)
+		{
+			MTJD::Job* job = MTJD::makeJob(m_renderer.getEngine().getMTJDManager(),
+				[masks_ptr, view_lights_ptr, light_count, slice, slice_size, near_plane, tan_half_fov, ratio]()
+				{
+					PROFILE_BLOCK("Light Cluster Job");
+					u64* slice_masks = masks_ptr + slice * LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y;
+					for (int i = 0; i < LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y; ++i) slice_masks[i] = 0;
+					float slice_near = near_plane + slice * slice_size;
+					float slice_far = slice_near + slice_size;
+					for (int i = 0; i < light_count; ++i)
+					{
+						const Vec4& light = view_lights_ptr[i];
+						float radius = light.w;
+						if (light.z + radius < slice_near || light.z - radius > slice_far) continue;
+
+						float depth = Math::maximum(near_plane, light.z - radius);
+						float half_height = depth * tan_half_fov;
+						float half_width = half_height * ratio;
+						int from_x = int(((light.x - radius) / half_width * 0.5f + 0.5f) * LIGHT_CLUSTERS_X);
+						int to_x = int(((light.x + radius) / half_width * 0.5f + 0.5f) * LIGHT_CLUSTERS_X);
+						int from_y = int(((light.y - radius) / half_height * 0.5f + 0.5f) * LIGHT_CLUSTERS_Y);
+						int to_y = int(((light.y + radius) / half_height * 0.5f + 0.5f) * LIGHT_CLUSTERS_Y);
+						if (to_x < 0 || from_x >= LIGHT_CLUSTERS_X) continue;
+						if (to_y < 0 || from_y >= LIGHT_CLUSTERS_Y) continue;
+						from_x = Math::maximum(from_x, 0);
+						to_x = Math::minimum(to_x, LIGHT_CLUSTERS_X - 1);
+						from_y = Math::maximum(from_y, 0);
+						to_y = Math::minimum(to_y, LIGHT_CLUSTERS_Y - 1);
+						u64 bit = u64(1) << i;
+						for (int y = from_y; y <= to_y; ++y)
+						{
+							for (int x = from_x; x <= to_x; ++x)
+							{
+								slice_masks[y * LIGHT_CLUSTERS_X + x] |= bit;
+							}
+						}
+					}
+				},
+				m_renderer.getEngine().getMTJDManager().getJobAllocator());
+			job->addDependency(&m_sync_point);
+			jobs.push(job);
+		}
+		for (MTJD::Job* job : jobs)
+		{
+			m_renderer.getEngine().getMTJDManager().schedule(job);
+		}
+		m_sync_point.sync();
+
+		const bgfx::Memory* clusters_mem =
+			bgfx::alloc(LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z * 2 * sizeof(float));
+		const bgfx::Memory* indices_mem =
+			bgfx::alloc(LIGHT_INDICES_TEXTURE_SIZE * LIGHT_INDICES_TEXTURE_SIZE * sizeof(float));
+		float* clusters_data = (float*)clusters_mem->data;
+		float* indices_data = (float*)indices_mem->data;
+		int offset = 0;
+		for (int cluster = 0; cluster < masks.size(); ++cluster)
+		{
+			u64 mask = masks[cluster];
+			int count = 0;
+			clusters_data[cluster * 2] = (float)offset;
+			for (int i = 0; i < light_count; ++i)
+			{
+				if ((mask & (u64(1) << i)) == 0) continue;
+				if (offset >= LIGHT_INDICES_TEXTURE_SIZE * LIGHT_INDICES_TEXTURE_SIZE) break;
+				indices_data[offset] = (float)i;
+				++offset;
+				++count;
+			}
+			clusters_data[cluster * 2 + 1] = (float)count;
+		}
+		bgfx::updateTexture2D(m_light_clusters_texture, 0, 0, 0, 0,
+			LIGHT_CLUSTERS_X, LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z, clusters_mem);
+		bgfx::updateTexture2D(m_light_indices_texture, 0, 0, 0, 0,
+			LIGHT_INDICES_TEXTURE_SIZE, LIGHT_INDICES_TEXTURE_SIZE, indices_mem);
+
+		m_current_view->command_buffer.beginAppend();
+		Vec4 cluster_params(near_plane, far_plane, (float)light_count, 0);
+		m_current_view->command_buffer.setUniform(m_cluster_params_uniform, cluster_params);
+		if (light_count > 0)
+		{
+			m_current_view->command_buffer.setUniform(
+				m_cluster_light_pos_radius_uniform, &light_pos_radius[0], light_count);
+			m_current_view->command_buffer.setUniform(
+				m_cluster_light_color_attenuation_uniform, &light_color_attenuation[0], light_count);
+		}
+		m_current_view->command_buffer.setTexture(
+			15 - m_global_textures_count, m_tex_light_clusters_uniform, m_light_clusters_texture);
+		++m_global_textures_count;
+		m_current_view->command_buffer.setTexture(
+			15 - m_global_textures_count, m_tex_light_indices_uniform, m_light_indices_texture);
+		++m_global_textures_count;
+		m_current_view->command_buffer.end();
+	}
+
+
 	void setViewProjection(const Matrix& mtx, int width, int height) override
 	{
 		bgfx::setViewRect(m_current_view->bgfx_id, 0, 0, (uint16_t)width, (uint16_t)height);
@@ -728,13 +1033,22 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	}
 
 
-	void finishInstances(int idx)
+	void addDrawStats(View& view, int instance_count, int triangle_count)
 	{
-		InstanceData& data = m_instances_data[idx];
-		if (!data.buffer) return;
+		++m_stats.draw_call_count;
+		m_stats.instance_count += instance_count;
+		m_stats.triangle_count += triangle_count;
+		++view.draw_call_count;
+		view.instance_count += instance_count;
+		view.triangle_count += triangle_count;
+	}
 
-		Mesh& mesh = *data.mesh;
-		const Model& model = *data.model;
+
+	void submitInstances(Mesh& mesh,
+		const Model& model,
+		const bgfx::InstanceDataBuffer* buffer,
+		int instance_count)
+	{
 		Material* material = mesh.material;
 		const u16 stride = model.getVertexDecl().getStride();
 
@@ -753,16 +1067,23 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 							 mesh.indices_count);
 		bgfx::setStencil(view.stencil, BGFX_STENCIL_NONE);
 		bgfx::setState(view.render_state | material->getRenderStates());
-		bgfx::setInstanceDataBuffer(data.buffer, data.instance_count);
+		bgfx::setInstanceDataBuffer(buffer, instance_count);
 		ShaderInstance& shader_instance = mesh.material->getShaderInstance();
-		++m_stats.draw_call_count;
-		m_stats.instance_count += data.instance_count;
-		m_stats.triangle_count += data.instance_count * mesh.indices_count / 3;
+		addDrawStats(view, instance_count, instance_count * mesh.indices_count / 3);
 		bgfx::submit(view.bgfx_id, shader_instance.getProgramHandle(view.pass_idx));
+	}
+
+
+	void finishInstances(int idx)
+	{
+		InstanceData& data = m_instances_data[idx];
+		if (!data.buffer) return;
+
+		submitInstances(*data.mesh, *data.model, data.buffer, data.instance_count);
 
 		data.buffer = nullptr;
 		data.instance_count = 0;
-		mesh.instance_idx = -1;
+		data.mesh->instance_idx = -1;
 	}
 
 
@@ -825,6 +1146,27 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	}
 
 
+	bool readRenderbufferAsync(const char* framebuffer,
+		int renderbuffer_idx,
+		const Delegate<void(const u8*, int, int)>& callback) override
+	{
+		FrameBuffer* fb = getFramebuffer(framebuffer);
+		if (!fb)
+		{
+			g_log_error.log("Renderer") << "readRenderbufferAsync: Framebuffer " << framebuffer
+										<< " not found.";
+			return false;
+		}
+
+		m_renderer.viewCounterAdd();
+		bgfx::setViewName(m_renderer.getViewCounter(), "async_readback_blit");
+		return fb->readAsync(renderbuffer_idx,
+			(u8)m_renderer.getViewCounter(),
+			m_renderer.getEngine().getAllocator(),
+			callback);
+	}
+
+
 	void setFramebuffer(const char* framebuffer_name)
 	{
 		if (equalStrings(framebuffer_name, "default"))
@@ -892,6 +1234,10 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		m_current_view->stencil = BGFX_STENCIL_NONE;
 		m_current_view->render_state = BGFX_STATE_RGB_WRITE | BGFX_STATE_ALPHA_WRITE | BGFX_STATE_DEPTH_WRITE | BGFX_STATE_MSAA;
 		m_current_view->pass_idx = m_pass_idx;
+		copyString(m_current_view->name, debug_name);
+		m_current_view->draw_call_count = 0;
+		m_current_view->instance_count = 0;
+		m_current_view->triangle_count = 0;
 		m_current_view->command_buffer.clear();
 		m_global_textures_count = 0;
 		if (layer_mask != 0)
@@ -1016,9 +1362,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		}
 		bgfx::setVertexBuffer(m_cube_vb);
 		bgfx::setIndexBuffer(m_cube_ib);
-		++m_stats.draw_call_count;
-		m_stats.instance_count += instance_count;
-		m_stats.triangle_count += instance_count * 12;
+		addDrawStats(*m_current_view, instance_count, instance_count * 12);
 		bgfx::submit(m_current_view->bgfx_id, material->getShaderInstance().getProgramHandle(m_pass_idx));
 	}
 
@@ -1108,7 +1452,9 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 			int buffer_idx = is_intersecting ? 0 : 1;
 			if(!instance_buffer[buffer_idx])
 			{
-				instance_buffer[buffer_idx] = bgfx::allocInstanceDataBuffer(128, sizeof(Data));
+				instance_buffer[buffer_idx] =
+					m_renderer.allocInstanceDataBuffer(Renderer::TransientClient::MESHES, 128, sizeof(Data));
+				if (!instance_buffer[buffer_idx]) continue;
 				instance_data[buffer_idx] = (Data*)instance_buffer[buffer_idx]->data;
 			}
 
@@ -1183,30 +1529,27 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	}
 
 
-	void renderSpotLightShadowmap(ComponentHandle light)
+	void prepareSpotLightShadowmap(ComponentHandle light, FrameBuffer* fb, Array<ShadowView>& views)
 	{
-		newView("point_light", 0xff);
-
 		Entity light_entity = m_scene->getPointLightEntity(light);
 		Matrix mtx = m_scene->getUniverse().getMatrix(light_entity);
 		float fov = m_scene->getLightFOV(light);
 		float range = m_scene->getLightRange(light);
-		u16 shadowmap_height = (u16)m_current_framebuffer->getHeight();
-		u16 shadowmap_width = (u16)m_current_framebuffer->getWidth();
 		Vec3 pos = mtx.getTranslation();
 
-		bgfx::setViewClear(m_current_view->bgfx_id, BGFX_CLEAR_DEPTH, 0, 1.0f, 0);
-		bgfx::touch(m_current_view->bgfx_id);
-		bgfx::setViewRect(m_current_view->bgfx_id, 0, 0, shadowmap_width, shadowmap_height);
-
-		Matrix projection_matrix;
-		projection_matrix.setPerspective(fov, 1, 0.01f, range, is_opengl);
-		Matrix view_matrix;
-		view_matrix.lookAt(pos, pos - mtx.getZVector(), mtx.getYVector());
-		bgfx::setViewTransform(m_current_view->bgfx_id, &view_matrix.m11, &projection_matrix.m11);
+		ShadowView& view = views.emplace(m_allocator);
+		view.light = light;
+		view.framebuffer = fb;
+		view.use_frustum = false;
+		view.view_x = 0;
+		view.view_y = 0;
+		view.width = (u16)fb->getWidth();
+		view.height = (u16)fb->getHeight();
+		view.projection_matrix.setPerspective(fov, 1, 0.01f, range, is_opengl);
+		view.view_matrix.lookAt(pos, pos - mtx.getZVector(), mtx.getYVector());
 
 		PointLightShadowmap& s = m_point_light_shadowmaps.emplace();
-		s.framebuffer = m_current_framebuffer;
+		s.framebuffer = fb;
 		s.light = light;
 		float ymul = is_opengl ? 0.5f : -0.5f;
 		static const Matrix biasMatrix(
@@ -1214,19 +1557,17 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 			0.0, ymul, 0.0, 0.0,
 			0.0,  0.0, 0.5, 0.0,
 			0.5,  0.5, 0.5, 1.0);
-		s.matrices[0] = biasMatrix * (projection_matrix * view_matrix);
-
-		renderPointLightInfluencedGeometry(light);
+		s.matrices[0] = biasMatrix * (view.projection_matrix * view.view_matrix);
 	}
 
 
-	void renderOmniLightShadowmap(ComponentHandle light)
+	void prepareOmniLightShadowmap(ComponentHandle light, FrameBuffer* fb, Array<ShadowView>& views)
 	{
 		Entity light_entity = m_scene->getPointLightEntity(light);
 		Vec3 light_pos = m_scene->getUniverse().getPosition(light_entity);
 		float range = m_scene->getLightRange(light);
-		u16 shadowmap_height = (u16)m_current_framebuffer->getHeight();
-		u16 shadowmap_width = (u16)m_current_framebuffer->getWidth();
+		u16 shadowmap_height = (u16)fb->getHeight();
+		u16 shadowmap_width = (u16)fb->getWidth();
 
 		float viewports[] = {0, 0, 0.5, 0, 0, 0.5, 0.5, 0.5};
 
@@ -1245,28 +1586,24 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		};
 
 		PointLightShadowmap& shadowmap_info = m_point_light_shadowmaps.emplace();
-		shadowmap_info.framebuffer = m_current_framebuffer;
+		shadowmap_info.framebuffer = fb;
 		shadowmap_info.light = light;
-		//setPointLightUniforms(light);
 
-		IAllocator& frame_allocator = m_renderer.getEngine().getLIFOAllocator();
 		for (int i = 0; i < 4; ++i)
 		{
-			newView("omnilight", 0xff);
-
-			bgfx::setViewClear(m_current_view->bgfx_id, BGFX_CLEAR_DEPTH, 0, 1.0f, 0);
-			bgfx::touch(m_current_view->bgfx_id);
-			u16 view_x = u16(shadowmap_width * viewports[i * 2]);
-			u16 view_y = u16(shadowmap_height * viewports[i * 2 + 1]);
-			bgfx::setViewRect(
-				m_current_view->bgfx_id, view_x, view_y, shadowmap_width >> 1, shadowmap_height >> 1);
-
 			float fovx = Math::degreesToRadians(143.98570868f + 3.51f);
 			float fovy = Math::degreesToRadians(125.26438968f + 9.85f);
 			float aspect = tanf(fovx * 0.5f) / tanf(fovy * 0.5f);
 
-			Matrix projection_matrix;
-			projection_matrix.setPerspective(fovx, aspect, 0.01f, range, is_opengl);
+			ShadowView& view = views.emplace(m_allocator);
+			view.light = light;
+			view.framebuffer = fb;
+			view.use_frustum = true;
+			view.view_x = u16(shadowmap_width * viewports[i * 2]);
+			view.view_y = u16(shadowmap_height * viewports[i * 2 + 1]);
+			view.width = shadowmap_width >> 1;
+			view.height = shadowmap_height >> 1;
+			view.projection_matrix.setPerspective(fovx, aspect, 0.01f, range, is_opengl);
 
 			Matrix view_matrix;
 			if (is_opengl)
@@ -1278,8 +1615,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 				view_matrix.fromEuler(YPR[i][0], YPR[i][1], YPR[i][2]);
 			}
 			view_matrix.setTranslation(light_pos);
-			Frustum frustum;
-			frustum.computePerspective(light_pos,
+			view.frustum.computePerspective(light_pos,
 				-view_matrix.getZVector(),
 				view_matrix.getYVector(),
 				fovx,
@@ -1288,20 +1624,28 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 				range);
 
 			view_matrix.fastInverse();
-
-			bgfx::setViewTransform(m_current_view->bgfx_id, &view_matrix.m11, &projection_matrix.m11);
+			view.view_matrix = view_matrix;
 
 			float ymul = is_opengl ? 0.5f : -0.5f;
 			static const Matrix biasMatrix(
 				0.5, 0.0, 0.0, 0.0, 0.0, ymul, 0.0, 0.0, 0.0, 0.0, 0.5, 0.0, 0.5, 0.5, 0.5, 1.0);
-			shadowmap_info.matrices[i] = biasMatrix * (projection_matrix * view_matrix);
+			shadowmap_info.matrices[i] = biasMatrix * (view.projection_matrix * view_matrix);
+		}
+	}
 
-			Array<ModelInstanceMesh> tmp_meshes(frame_allocator);
-			m_is_current_light_global = false;
-			m_scene->getPointLightInfluencedGeometry(light, frustum, tmp_meshes);
 
-			renderMeshes(tmp_meshes);
-		}
+	void recordShadowmapView(ShadowView& view)
+	{
+		m_current_framebuffer = view.framebuffer;
+		newView(view.use_frustum ? "omnilight" : "point_light", 0xff);
+
+		bgfx::setViewClear(m_current_view->bgfx_id, BGFX_CLEAR_DEPTH, 0, 1.0f, 0);
+		bgfx::touch(m_current_view->bgfx_id);
+		bgfx::setViewRect(m_current_view->bgfx_id, view.view_x, view.view_y, view.width, view.height);
+		bgfx::setViewTransform(m_current_view->bgfx_id, &view.view_matrix.m11, &view.projection_matrix.m11);
+
+		if (view.use_frustum) m_is_current_light_global = false;
+		renderMeshes(view.meshes);
 	}
 
 
@@ -1316,6 +1660,13 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		ComponentHandle lights[16];
 		int light_count = m_scene->getClosestPointLights(camera_pos, lights, lengthOf(lights));
 
+		// this bgfx has no per-thread encoders, so the bgfx calls themselves
+		// must stay on this thread; the matrices and frusta of every shadow
+		// view are prepared up front instead and the influenced geometry of
+		// all the views is gathered in parallel jobs, only the recording of
+		// the prepared lists stays serial
+		Array<ShadowView> views(m_renderer.getEngine().getLIFOAllocator());
+		views.reserve(framebuffers_count * 4);
 		int fb_index = 0;
 		for (int i = 0; i < light_count; ++i)
 		{
@@ -1323,18 +1674,51 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 			if (fb_index == framebuffers_count) break;
 
 			float fov = m_scene->getLightFOV(lights[i]);
-
-			m_current_framebuffer = fbs[i];
 			if (fov < Math::PI)
 			{
-				renderSpotLightShadowmap(lights[i]);
+				prepareSpotLightShadowmap(lights[i], fbs[i], views);
 			}
 			else
 			{
-				renderOmniLightShadowmap(lights[i]);
+				prepareOmniLightShadowmap(lights[i], fbs[i], views);
 			}
 			++fb_index;
 		}
+		if (views.empty()) return;
+
+		Array<MTJD::Job*> jobs(m_renderer.getEngine().getLIFOAllocator());
+		jobs.reserve(views.size());
+		for (ShadowView& view : views)
+		{
+			ShadowView* view_ptr = &view;
+			MTJD::Job* job = MTJD::makeJob(m_renderer.getEngine().getMTJDManager(),
+				[view_ptr, this]()
+				{
+					PROFILE_BLOCK("Gather Shadow View Job");
+					if (view_ptr->use_frustum)
+					{
+						m_scene->getPointLightInfluencedGeometry(
+							view_ptr->light, view_ptr->frustum, view_ptr->meshes);
+					}
+					else
+					{
+						m_scene->getPointLightInfluencedGeometry(view_ptr->light, view_ptr->meshes);
+					}
+				},
+				m_renderer.getEngine().getMTJDManager().getJobAllocator());
+			job->addDependency(&m_sync_point);
+			jobs.push(job);
+		}
+		for (MTJD::Job* job : jobs)
+		{
+			m_renderer.getEngine().getMTJDManager().schedule(job);
+		}
+		m_sync_point.sync();
+
+		for (ShadowView& view : views)
+		{
+			recordShadowmapView(view);
+		}
 	}
 
 
@@ -1460,14 +1844,17 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 			m_debug_index_buffer = bgfx::createDynamicIndexBuffer(mem);
 		}
 
+		u32 version = m_scene->getDebugGeometryVersion();
+		bool upload = version != m_debug_geometry_version;
+		m_debug_geometry_version = version;
 		m_debug_buffer_idx = 0;
-		renderDebugTriangles();
-		renderDebugLines();
-		renderDebugPoints();
+		renderDebugTriangles(upload);
+		renderDebugLines(upload);
+		renderDebugPoints(upload);
 	}
 
 
-	void renderDebugPoints()
+	void renderDebugPoints(bool upload)
 	{
 		const Array<DebugPoint>& points = m_scene->getDebugPoints();
 		if (points.empty() || !m_debug_line_material->isReady()) return;
@@ -1478,28 +1865,33 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		for (int j = 0; j < points.size() && m_debug_buffer_idx < lengthOf(m_debug_vertex_buffers);
 			j += BATCH_SIZE, ++m_debug_buffer_idx)
 		{
+			bool update_buffer = upload;
 			if (!bgfx::isValid(m_debug_vertex_buffers[m_debug_buffer_idx]))
 			{
 				m_debug_vertex_buffers[m_debug_buffer_idx] = bgfx::createDynamicVertexBuffer(0xffFF, m_base_vertex_decl);
+				update_buffer = true;
 			}
 
 			int point_count = Math::minimum(BATCH_SIZE, points.size() - j);
-			auto* mem = bgfx::alloc(sizeof(BaseVertex) * point_count);
-
-			BaseVertex* vertex = (BaseVertex*)mem->data;
-			for (int i = 0; i < points.size(); ++i)
+			if (update_buffer)
 			{
-				const DebugPoint& point = points[i];
-				vertex[0].rgba = point.color;
-				vertex[0].x = point.pos.x;
-				vertex[0].y = point.pos.y;
-				vertex[0].z = point.pos.z;
-				vertex[0].u = vertex[0].v = 0;
-
-				++vertex;
-			}
+				auto* mem = bgfx::alloc(sizeof(BaseVertex) * point_count);
+
+				BaseVertex* vertex = (BaseVertex*)mem->data;
+				for (int i = 0; i < point_count; ++i)
+				{
+					const DebugPoint& point = points[j + i];
+					vertex[0].rgba = point.color;
+					vertex[0].x = point.pos.x;
+					vertex[0].y = point.pos.y;
+					vertex[0].z = point.pos.z;
+					vertex[0].u = vertex[0].v = 0;
+
+					++vertex;
+				}
 
-			bgfx::updateDynamicVertexBuffer(m_debug_vertex_buffers[m_debug_buffer_idx], 0, mem);
+				bgfx::updateDynamicVertexBuffer(m_debug_vertex_buffers[m_debug_buffer_idx], 0, mem);
+			}
 
 			bgfx::setVertexBuffer(m_debug_vertex_buffers[m_debug_buffer_idx]);
 			bgfx::setIndexBuffer(m_debug_index_buffer, 0, point_count);
@@ -1511,7 +1903,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	}
 
 
-	void renderDebugLines()
+	void renderDebugLines(bool upload)
 	{
 		const Array<DebugLine>& lines = m_scene->getDebugLines();
 		if (lines.empty() || !m_debug_line_material->isReady()) return;
@@ -1522,34 +1914,39 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		for (int j = 0; j < lines.size() && m_debug_buffer_idx < lengthOf(m_debug_vertex_buffers);
 			 j += BATCH_SIZE, ++m_debug_buffer_idx)
 		{
+			bool update_buffer = upload;
 			if (!bgfx::isValid(m_debug_vertex_buffers[m_debug_buffer_idx]))
 			{
 				m_debug_vertex_buffers[m_debug_buffer_idx] = bgfx::createDynamicVertexBuffer(0xffFF, m_base_vertex_decl);
+				update_buffer = true;
 			}
 
 			int line_count = Math::minimum(BATCH_SIZE, lines.size() - j);
-			auto* mem = bgfx::alloc(sizeof(BaseVertex) * 2 * line_count);
-			
-			BaseVertex* vertex = (BaseVertex*)mem->data;
-			for (int i = 0; i < line_count; ++i)
+			if (update_buffer)
 			{
-				const DebugLine& line = lines[j + i];
-				vertex[0].rgba = line.color;
-				vertex[0].x = line.from.x;
-				vertex[0].y = line.from.y;
-				vertex[0].z = line.from.z;
-				vertex[0].u = vertex[0].v = 0;
-
-				vertex[1].rgba = line.color;
-				vertex[1].x = line.to.x;
-				vertex[1].y = line.to.y;
-				vertex[1].z = line.to.z;
-				vertex[1].u = vertex[0].v = 0;
-
-				vertex += 2;
-			}
+				auto* mem = bgfx::alloc(sizeof(BaseVertex) * 2 * line_count);
 
-			bgfx::updateDynamicVertexBuffer(m_debug_vertex_buffers[m_debug_buffer_idx], 0, mem);
+				BaseVertex* vertex = (BaseVertex*)mem->data;
+				for (int i = 0; i < line_count; ++i)
+				{
+					const DebugLine& line = lines[j + i];
+					vertex[0].rgba = line.color;
+					vertex[0].x = line.from.x;
+					vertex[0].y = line.from.y;
+					vertex[0].z = line.from.z;
+					vertex[0].u = vertex[0].v = 0;
+
+					vertex[1].rgba = line.color;
+					vertex[1].x = line.to.x;
+					vertex[1].y = line.to.y;
+					vertex[1].z = line.to.z;
+					vertex[1].u = vertex[0].v = 0;
+
+					vertex += 2;
+				}
+
+				bgfx::updateDynamicVertexBuffer(m_debug_vertex_buffers[m_debug_buffer_idx], 0, mem);
+			}
 
 			bgfx::setVertexBuffer(m_debug_vertex_buffers[m_debug_buffer_idx]);
 			bgfx::setIndexBuffer(m_debug_index_buffer, 0, line_count * 2);
@@ -1561,7 +1958,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	}
 
 
-	void renderDebugTriangles()
+	void renderDebugTriangles(bool upload)
 	{
 		const auto& tris = m_scene->getDebugTriangles();
 		if(tris.empty() || !m_debug_line_material->isReady()) return;
@@ -1572,40 +1969,45 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		for (int j = 0; j < tris.size() && m_debug_buffer_idx < lengthOf(m_debug_vertex_buffers);
 			 j += BATCH_SIZE, ++m_debug_buffer_idx)
 		{
+			bool update_buffer = upload;
 			if (!bgfx::isValid(m_debug_vertex_buffers[m_debug_buffer_idx]))
 			{
 				m_debug_vertex_buffers[m_debug_buffer_idx] = bgfx::createDynamicVertexBuffer(0xffFF, m_base_vertex_decl);
+				update_buffer = true;
 			}
 
 			int tri_count = Math::minimum(BATCH_SIZE, tris.size() - j);
-			auto* mem = bgfx::alloc(sizeof(BaseVertex) * 3 * tri_count);
-
-			BaseVertex* vertex = (BaseVertex*)mem->data;
-			for (int i = 0; i < tri_count; ++i)
+			if (update_buffer)
 			{
-				const DebugTriangle& tri = tris[j + i];
-				vertex[0].rgba = tri.color;
-				vertex[0].x = tri.p0.x;
-				vertex[0].y = tri.p0.y;
-				vertex[0].z = tri.p0.z;
-				vertex[0].u = vertex[0].v = 0;
-
-				vertex[1].rgba = tri.color;
-				vertex[1].x = tri.p1.x;
-				vertex[1].y = tri.p1.y;
-				vertex[1].z = tri.p1.z;
-				vertex[1].u = vertex[0].v = 0;
-
-				vertex[2].rgba = tri.color;
-				vertex[2].x = tri.p2.x;
-				vertex[2].y = tri.p2.y;
-				vertex[2].z = tri.p2.z;
-				vertex[2].u = vertex[0].v = 0;
-
-				vertex += 3;
-			}
+				auto* mem = bgfx::alloc(sizeof(BaseVertex) * 3 * tri_count);
 
-			bgfx::updateDynamicVertexBuffer(m_debug_vertex_buffers[m_debug_buffer_idx], 0, mem);
+				BaseVertex* vertex = (BaseVertex*)mem->data;
+				for (int i = 0; i < tri_count; ++i)
+				{
+					const DebugTriangle& tri = tris[j + i];
+					vertex[0].rgba = tri.color;
+					vertex[0].x = tri.p0.x;
+					vertex[0].y = tri.p0.y;
+					vertex[0].z = tri.p0.z;
+					vertex[0].u = vertex[0].v = 0;
+
+					vertex[1].rgba = tri.color;
+					vertex[1].x = tri.p1.x;
+					vertex[1].y = tri.p1.y;
+					vertex[1].z = tri.p1.z;
+					vertex[1].u = vertex[0].v = 0;
+
+					vertex[2].rgba = tri.color;
+					vertex[2].x = tri.p2.x;
+					vertex[2].y = tri.p2.y;
+					vertex[2].z = tri.p2.z;
+					vertex[2].u = vertex[0].v = 0;
+
+					vertex += 3;
+				}
+
+				bgfx::updateDynamicVertexBuffer(m_debug_vertex_buffers[m_debug_buffer_idx], 0, mem);
+			}
 
 			bgfx::setVertexBuffer(m_debug_vertex_buffers[m_debug_buffer_idx]);
 			bgfx::setIndexBuffer(m_debug_index_buffer, 0, tri_count * 3);
@@ -1855,7 +2257,8 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	{
 		Resource* res = m_scene->getEngine().getLuaResource(material_index);
 		Material* material = static_cast<Material*>(res);
-		if (!material->isReady() || !bgfx::checkAvailTransientVertexBuffer(3, m_base_vertex_decl))
+		if (!material->isReady() ||
+			!m_renderer.checkAvailTransientBuffers(Renderer::TransientClient::GUI, 6, m_base_vertex_decl, 0))
 		{
 			bgfx::touch(m_current_view->bgfx_id);
 			return;
@@ -1879,7 +2282,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		}
 
 		bgfx::TransientVertexBuffer vb;
-		bgfx::allocTransientVertexBuffer(&vb, 6, m_base_vertex_decl);
+		m_renderer.allocTransientBuffers(Renderer::TransientClient::GUI, &vb, 6, m_base_vertex_decl, nullptr, 0);
 		BaseVertex* vertex = (BaseVertex*)vb.data;
 		float right = left + w;
 		float bottom = top + h;
@@ -1967,13 +2370,91 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		bgfx::setStencil(view.stencil, BGFX_STENCIL_NONE);
 		bgfx::setState((view.render_state | material->getRenderStates()) & ~BGFX_STATE_CULL_MASK);
 		bgfx::setVertexBuffer(&vb);
-		++m_stats.draw_call_count;
-		++m_stats.instance_count;
-		m_stats.triangle_count += 2;
+		addDrawStats(*m_current_view, 1, 2);
 		bgfx::submit(m_current_view->bgfx_id, material->getShaderInstance().getProgramHandle(m_pass_idx));
 	}
 
 
+	CachedScenePass& getPassCache(const Frustum& frustum, const Vec3& lod_ref_point, u64 layer_mask)
+	{
+		static const int MAX_PASS_CACHES = 8;
+		u32 scene_version = m_scene->getSceneVersion();
+		for (CachedScenePass& cache : m_pass_caches)
+		{
+			if (cache.layer_mask != layer_mask) continue;
+			if (compareMemory(&cache.frustum, &frustum, sizeof(frustum)) != 0) continue;
+			if (compareMemory(&cache.lod_ref_point, &lod_ref_point, sizeof(lod_ref_point)) != 0) continue;
+
+			if (cache.scene_version != scene_version)
+			{
+				// same pass, stale content; re-record into the same entry
+				cache.is_valid = false;
+				cache.batches.clear();
+				cache.immediate_meshes.clear();
+				cache.scene_version = scene_version;
+			}
+			return cache;
+		}
+
+		CachedScenePass* cache;
+		if (m_pass_caches.size() < MAX_PASS_CACHES)
+		{
+			cache = &m_pass_caches.emplace(m_allocator);
+		}
+		else
+		{
+			cache = &m_pass_caches[m_pass_cache_idx];
+			m_pass_cache_idx = (m_pass_cache_idx + 1) % MAX_PASS_CACHES;
+		}
+		cache->is_valid = false;
+		cache->batches.clear();
+		cache->immediate_meshes.clear();
+		cache->frustum = frustum;
+		cache->lod_ref_point = lod_ref_point;
+		cache->layer_mask = layer_mask;
+		cache->scene_version = scene_version;
+		return *cache;
+	}
+
+
+	void replayPassCache(const CachedScenePass& cache)
+	{
+		PROFILE_FUNCTION();
+		ModelInstance* model_instances = m_scene->getModelInstances();
+		for (const CachedBatch& batch : cache.batches)
+		{
+			int instance_count = batch.matrices.size();
+			const bgfx::InstanceDataBuffer* buffer = m_renderer.allocInstanceDataBuffer(
+				Renderer::TransientClient::MESHES, instance_count, sizeof(Matrix));
+			if (!buffer)
+			{
+				g_log_warning.log("Renderer") << "Could not allocate instance data buffer";
+				return;
+			}
+			copyMemory(buffer->data, &batch.matrices[0], instance_count * sizeof(Matrix));
+			submitInstances(*batch.mesh, *batch.model, buffer, instance_count);
+		}
+		for (const ModelInstanceMesh& mesh : cache.immediate_meshes)
+		{
+			ModelInstance& model_instance = model_instances[mesh.model_instance.index];
+			switch (model_instance.type)
+			{
+				case ModelInstance::RIGID:
+					break;
+				case ModelInstance::SKINNED:
+					renderSkinnedMesh(model_instance, mesh);
+					break;
+				case ModelInstance::MULTILAYER_SKINNED:
+					renderMultilayerSkinnedMesh(model_instance, mesh);
+					break;
+				case ModelInstance::MULTILAYER_RIGID:
+					renderMultilayerRigidMesh(model_instance, mesh);
+					break;
+			}
+		}
+	}
+
+
 	void renderAll(const Frustum& frustum, bool render_grass, const Vec3& lod_ref_point, u64 layer_mask)
 	{
 		PROFILE_FUNCTION();
@@ -1983,8 +2464,16 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		IAllocator& frame_allocator = m_renderer.getEngine().getLIFOAllocator();
 		m_is_current_light_global = true;
 
-		auto& meshes = m_scene->getModelInstanceInfos(frustum, lod_ref_point, layer_mask);
-		renderMeshes(meshes);
+		CachedScenePass& cache = getPassCache(frustum, lod_ref_point, layer_mask);
+		if (cache.is_valid)
+		{
+			replayPassCache(cache);
+		}
+		else
+		{
+			auto& meshes = m_scene->getModelInstanceInfos(frustum, lod_ref_point, layer_mask);
+			cache.is_valid = renderMeshes(meshes, &cache);
+		}
 
 		if (render_grass)
 		{
@@ -2036,12 +2525,9 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 			InstanceData& data = m_instances_data[instance_idx];
 			if (!data.buffer)
 			{
-				if (!bgfx::checkAvailInstanceDataBuffer(InstanceData::MAX_INSTANCE_COUNT, sizeof(Matrix)))
-				{
-					return;
-				}
-				data.buffer =
-					bgfx::allocInstanceDataBuffer(InstanceData::MAX_INSTANCE_COUNT, sizeof(Matrix));
+				data.buffer = m_renderer.allocInstanceDataBuffer(
+					Renderer::TransientClient::MESHES, InstanceData::MAX_INSTANCE_COUNT, sizeof(Matrix));
+				if (!data.buffer) return;
 				data.instance_count = 0;
 				data.mesh = &mesh;
 				data.model = &model;
@@ -2072,15 +2558,27 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		Quat* rots = pose.rotations;
 
 		ASSERT(pose.count <= lengthOf(bone_mtx));
-		for (int bone_index = 0, bone_count = pose.count; bone_index < bone_count; ++bone_index)
+		// compose the transforms first so the quat-to-matrix conversion runs
+		// as one batch
+		Quat bone_rot[128];
+		Vec3 bone_pos[128];
+		int bone_count = pose.count;
+		for (int bone_index = 0; bone_index < bone_count; ++bone_index)
 		{
 			auto& bone = model.getBone(bone_index);
 			Transform tmp = {poss[bone_index], rots[bone_index]};
-			bone_mtx[bone_index] = (tmp * bone.inv_bind_transform).toMatrix();
+			tmp = tmp * bone.inv_bind_transform;
+			bone_rot[bone_index] = tmp.rot;
+			bone_pos[bone_index] = tmp.pos;
+		}
+		toMatrices(bone_rot, bone_mtx, bone_count);
+		for (int bone_index = 0; bone_index < bone_count; ++bone_index)
+		{
+			bone_mtx[bone_index].setTranslation(bone_pos[bone_index]);
 		}
 
 		int stride = model.getVertexDecl().getStride();
-		
+
 		int view_idx = m_layer_to_view_map[material->getRenderLayer()];
 		ASSERT(view_idx >= 0);
 		auto& view = m_views[view_idx >= 0 ? view_idx : 0];
@@ -2098,9 +2596,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		bgfx::setIndexBuffer(model_instance.model->getIndicesHandle(), mesh.indices_offset, mesh.indices_count);
 		bgfx::setStencil(view.stencil, BGFX_STENCIL_NONE);
 		bgfx::setState(view.render_state | material->getRenderStates());
-		++m_stats.draw_call_count;
-		++m_stats.instance_count;
-		m_stats.triangle_count += mesh.indices_count / 3;
+		addDrawStats(view, 1, mesh.indices_count / 3);
 		bgfx::submit(view.bgfx_id, shader_instance.getProgramHandle(view.pass_idx));
 	}
 
@@ -2127,9 +2623,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 			bgfx::setIndexBuffer(model_instance.model->getIndicesHandle(), mesh.indices_offset, mesh.indices_count);
 			bgfx::setStencil(view.stencil, BGFX_STENCIL_NONE);
 			bgfx::setState(view.render_state | material->getRenderStates());
-			++m_stats.draw_call_count;
-			++m_stats.instance_count;
-			m_stats.triangle_count += mesh.indices_count / 3;
+			addDrawStats(view, 1, mesh.indices_count / 3);
 			bgfx::submit(view.bgfx_id, shader_instance.getProgramHandle(view.pass_idx));
 		};
 
@@ -2168,11 +2662,21 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		Quat* rots = pose.rotations;
 
 		ASSERT(pose.count <= lengthOf(bone_mtx));
-		for (int bone_index = 0, bone_count = pose.count; bone_index < bone_count; ++bone_index)
+		Quat bone_rot[128];
+		Vec3 bone_pos[128];
+		int bone_count = pose.count;
+		for (int bone_index = 0; bone_index < bone_count; ++bone_index)
 		{
 			auto& bone = model.getBone(bone_index);
 			Transform tmp = { poss[bone_index], rots[bone_index] };
-			bone_mtx[bone_index] = (tmp * bone.inv_bind_transform).toMatrix();
+			tmp = tmp * bone.inv_bind_transform;
+			bone_rot[bone_index] = tmp.rot;
+			bone_pos[bone_index] = tmp.pos;
+		}
+		toMatrices(bone_rot, bone_mtx, bone_count);
+		for (int bone_index = 0; bone_index < bone_count; ++bone_index)
+		{
+			bone_mtx[bone_index].setTranslation(bone_pos[bone_index]);
 		}
 
 		int stride = model.getVertexDecl().getStride();
@@ -2191,9 +2695,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 			bgfx::setIndexBuffer(model_instance.model->getIndicesHandle(), mesh.indices_offset, mesh.indices_count);
 			bgfx::setStencil(view.stencil, BGFX_STENCIL_NONE);
 			bgfx::setState(view.render_state | material->getRenderStates());
-			++m_stats.draw_call_count;
-			++m_stats.instance_count;
-			m_stats.triangle_count += mesh.indices_count / 3;
+			addDrawStats(view, 1, mesh.indices_count / 3);
 			bgfx::submit(view.bgfx_id, shader_instance.getProgramHandle(view.pass_idx));
 		};
 
@@ -2228,7 +2730,8 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 
 	bool checkAvailTransientBuffers(u32 num_vertices, const bgfx::VertexDecl& decl, u32 num_indices) override
 	{
-		return bgfx::checkAvailTransientBuffers(num_vertices, decl, num_indices);
+		return m_renderer.checkAvailTransientBuffers(
+			Renderer::TransientClient::DEBUG_DRAW, num_vertices, decl, num_indices);
 	}
 
 
@@ -2238,8 +2741,8 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		bgfx::TransientIndexBuffer* tib,
 		u32 num_indices) override
 	{
-		bgfx::allocTransientIndexBuffer(tib, num_indices);
-		bgfx::allocTransientVertexBuffer(tvb, num_vertices, decl);
+		m_renderer.allocTransientBuffers(
+			Renderer::TransientClient::DEBUG_DRAW, tvb, num_vertices, decl, tib, num_indices);
 	}
 
 
@@ -2285,46 +2788,27 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		bgfx::setTransform(&mtx.m11);
 		bgfx::setVertexBuffer(&vertex_buffer);
 		bgfx::setIndexBuffer(&index_buffer, first_index, num_indices);
-		++m_stats.draw_call_count;
-		++m_stats.instance_count;
-		m_stats.triangle_count += num_indices / 3;
+		addDrawStats(view, 1, num_indices / 3);
 		bgfx::submit(m_current_view->bgfx_id, shader_instance.getProgramHandle(m_pass_idx));
 	}
 
 
-	void renderRigidMesh(const ModelInstance& model_instance, const ModelInstanceMesh& info)
+	void render(const bgfx::DynamicVertexBufferHandle& vertex_buffer,
+		const bgfx::DynamicIndexBufferHandle& index_buffer,
+		const Matrix& mtx,
+		int first_index,
+		int num_indices,
+		u64 render_states,
+		ShaderInstance& shader_instance) override
 	{
-		int instance_idx = info.mesh->instance_idx;
-		if (instance_idx == -1)
-		{
-			instance_idx = m_instance_data_idx;
-			m_instance_data_idx = (m_instance_data_idx + 1) % lengthOf(m_instances_data);
-			if (m_instances_data[instance_idx].buffer)
-			{
-				finishInstances(instance_idx);
-			}
-			InstanceData& data = m_instances_data[instance_idx];
-			if (!bgfx::checkAvailInstanceDataBuffer(InstanceData::MAX_INSTANCE_COUNT, sizeof(Matrix)))
-			{
-				g_log_warning.log("Renderer") << "Could not allocate instance data buffer";
-				return;
-			}
-			data.buffer =
-				bgfx::allocInstanceDataBuffer(InstanceData::MAX_INSTANCE_COUNT, sizeof(Matrix));
-			data.instance_count = 0;
-			data.mesh = info.mesh;
-			data.model = model_instance.model;
-			info.mesh->instance_idx = instance_idx;
-		}
-		InstanceData& data = m_instances_data[instance_idx];
-		float* mtcs = (float*)data.buffer->data;
-		copyMemory(&mtcs[data.instance_count * 16], &model_instance.matrix, sizeof(model_instance.matrix));
-		++data.instance_count;
-
-		if (data.instance_count == InstanceData::MAX_INSTANCE_COUNT)
-		{
-			finishInstances(instance_idx);
-		}
+		View& view = *m_current_view;
+		bgfx::setStencil(view.stencil, BGFX_STENCIL_NONE);
+		bgfx::setState(view.render_state | render_states);
+		bgfx::setTransform(&mtx.m11);
+		bgfx::setVertexBuffer(vertex_buffer);
+		bgfx::setIndexBuffer(index_buffer, first_index, num_indices);
+		addDrawStats(view, 1, num_indices / 3);
+		bgfx::submit(m_current_view->bgfx_id, shader_instance.getProgramHandle(m_pass_idx));
 	}
 
 
@@ -2431,8 +2915,12 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		Vec4 terrain_scale(info.m_terrain->getScale(), 0);
 		const Mesh& mesh = *info.m_terrain->getMesh();
 
-		Vec4 terrain_params(
-			info.m_terrain->getRootSize(), (float)detail_texture->width, (float)splat_texture->width, 0);
+		// w carries the detail array layer count so the shader can clamp the
+		// splat-map layer indices; 1 for legacy single-layer detail textures
+		Vec4 terrain_params(info.m_terrain->getRootSize(),
+			(float)detail_texture->width,
+			(float)splat_texture->width,
+			(float)detail_texture->layers);
 		bgfx::setUniform(m_terrain_params_uniform, &terrain_params);
 		bgfx::setUniform(m_rel_camera_pos_uniform, &rel_cam_pos);
 		bgfx::setUniform(m_terrain_scale_uniform, &terrain_scale);
@@ -2450,8 +2938,13 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 			Vec4 m_quad_min_and_size;
 			Vec4 m_morph_const;
 		};
-		const bgfx::InstanceDataBuffer* instance_buffer = bgfx::allocInstanceDataBuffer(
-			m_terrain_instances[index].m_count, sizeof(TerrainInstanceData));
+		const bgfx::InstanceDataBuffer* instance_buffer = m_renderer.allocInstanceDataBuffer(
+			Renderer::TransientClient::MESHES, m_terrain_instances[index].m_count, sizeof(TerrainInstanceData));
+		if (!instance_buffer)
+		{
+			m_terrain_instances[index].m_count = 0;
+			return;
+		}
 		TerrainInstanceData* instance_data = (TerrainInstanceData*)instance_buffer->data;
 
 		for (int i = 0; i < m_terrain_instances[index].m_count; ++i)
@@ -2472,9 +2965,9 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		bgfx::setState(view.render_state | mesh.material->getRenderStates());
 		bgfx::setInstanceDataBuffer(instance_buffer, m_terrain_instances[index].m_count);
 		auto shader_instance = material->getShaderInstance().getProgramHandle(view.pass_idx);
-		++m_stats.draw_call_count;
-		m_stats.instance_count += m_terrain_instances[index].m_count;
-		m_stats.triangle_count += m_terrain_instances[index].m_count * mesh_part_indices_count;
+		addDrawStats(view,
+			m_terrain_instances[index].m_count,
+			m_terrain_instances[index].m_count * mesh_part_indices_count);
 		bgfx::submit(view.bgfx_id, shader_instance);
 
 		m_terrain_instances[index].m_count = 0;
@@ -2483,10 +2976,9 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 
 	void renderGrass(const GrassInfo& grass)
 	{
-		if (!bgfx::checkAvailInstanceDataBuffer(grass.instance_count, sizeof(GrassInfo::InstanceData))) return;
-
-		const bgfx::InstanceDataBuffer* idb =
-			bgfx::allocInstanceDataBuffer(grass.instance_count, sizeof(GrassInfo::InstanceData));
+		const bgfx::InstanceDataBuffer* idb = m_renderer.allocInstanceDataBuffer(
+			Renderer::TransientClient::MESHES, grass.instance_count, sizeof(GrassInfo::InstanceData));
+		if (!idb) return;
 		copyMemory(idb->data, grass.instance_data, sizeof(GrassInfo::InstanceData) * grass.instance_count);
 		const Mesh& mesh = grass.model->getMesh(0);
 		Material* material = mesh.material;
@@ -2507,9 +2999,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		bgfx::setStencil(view.stencil, BGFX_STENCIL_NONE);
 		bgfx::setState(view.render_state | material->getRenderStates());
 		bgfx::setInstanceDataBuffer(idb, grass.instance_count);
-		++m_stats.draw_call_count;
-		m_stats.instance_count += grass.instance_count;
-		m_stats.triangle_count += grass.instance_count * mesh.indices_count;
+		addDrawStats(view, grass.instance_count, grass.instance_count * mesh.indices_count);
 		bgfx::submit(view.bgfx_id, material->getShaderInstance().getProgramHandle(view.pass_idx));
 	}
 
@@ -2546,13 +3036,19 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 
 		ModelInstance* model_instances = m_scene->getModelInstances();
 		PROFILE_INT("mesh count", meshes.size());
+		IAllocator& frame_allocator = m_renderer.getEngine().getLIFOAllocator();
+		Array<u64> keys(frame_allocator);
+		Array<const ModelInstanceMesh*> infos(frame_allocator);
+		keys.reserve(meshes.size());
+		infos.reserve(meshes.size());
 		for(auto& mesh : meshes)
 		{
 			ModelInstance& model_instance = model_instances[mesh.model_instance.index];
 			switch (model_instance.type)
 			{
 				case ModelInstance::RIGID:
-					renderRigidMesh(model_instance, mesh);
+					keys.push((u64)(uintptr)mesh.mesh);
+					infos.push(&mesh);
 					break;
 				case ModelInstance::SKINNED:
 					renderSkinnedMesh(model_instance, mesh);
@@ -2565,26 +3061,125 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 					break;
 			}
 		}
-		finishInstances();
+		if (keys.empty()) return;
+
+		// mesh pointers share their high bytes, so the radix sort skips most
+		// of its passes here
+		Array<u64> temp_keys(frame_allocator);
+		Array<const ModelInstanceMesh*> temp_infos(frame_allocator);
+		temp_keys.resize(keys.size());
+		temp_infos.resize(keys.size());
+		radixSort(&keys[0], &infos[0], &temp_keys[0], &temp_infos[0], keys.size());
+		int i = 0;
+		while (i < infos.size())
+		{
+			Mesh* mesh = infos[i]->mesh;
+			int instance_count = 1;
+			while (i + instance_count < infos.size() &&
+				   infos[i + instance_count]->mesh == mesh)
+			{
+				++instance_count;
+			}
+			const bgfx::InstanceDataBuffer* instance_buffer = m_renderer.allocInstanceDataBuffer(
+				Renderer::TransientClient::MESHES, instance_count, sizeof(Matrix));
+			if (!instance_buffer)
+			{
+				g_log_warning.log("Renderer") << "Could not allocate instance data buffer";
+				return;
+			}
+			Matrix* mtcs = (Matrix*)instance_buffer->data;
+			for (int j = 0; j < instance_count; ++j)
+			{
+				const ModelInstance& model_instance =
+					model_instances[infos[i + j]->model_instance.index];
+				copyMemory(&mtcs[j], &model_instance.matrix, sizeof(Matrix));
+			}
+			const ModelInstance& first = model_instances[infos[i]->model_instance.index];
+			submitInstances(*mesh, *first.model, instance_buffer, instance_count);
+			i += instance_count;
+		}
 	}
 
 
-	void renderMeshes(const Array<Array<ModelInstanceMesh>>& meshes)
+	bool renderMeshes(const Array<Array<ModelInstanceMesh>>& meshes, CachedScenePass* cache)
 	{
 		PROFILE_FUNCTION();
 		int mesh_count = 0;
+		bool complete = true;
+		ModelInstance* model_instances = m_scene->getModelInstances();
+		IAllocator& frame_allocator = m_renderer.getEngine().getLIFOAllocator();
+
+		Vec3 camera_pos(0, 0, 0);
+		if (isValid(m_applied_camera))
+		{
+			Entity camera_entity = m_scene->getCameraEntity(m_applied_camera);
+			camera_pos = m_scene->getUniverse().getPosition(camera_entity);
+		}
+
+		// jobs build one sorted draw-key list per culling subresult while the
+		// main thread walks the meshes that cannot be instanced; the buffers
+		// are preallocated here so the jobs do not touch any allocator
+		Array<Array<SortedMesh>> sorted_meshes(frame_allocator);
+		Array<Array<SortedMesh>> temp_meshes(frame_allocator);
+		Array<int> sorted_counts(frame_allocator);
+		Array<MTJD::Job*> jobs(frame_allocator);
+		sorted_meshes.reserve(meshes.size());
+		temp_meshes.reserve(meshes.size());
+		sorted_counts.reserve(meshes.size());
+		jobs.reserve(meshes.size());
 		for (auto& submeshes : meshes)
 		{
-			if(submeshes.empty()) continue;
-			ModelInstance* model_instances = m_scene->getModelInstances();
+			if (submeshes.empty()) continue;
 			mesh_count += submeshes.size();
+
+			Array<SortedMesh>& sorted = sorted_meshes.emplace(frame_allocator);
+			sorted.resize(submeshes.size());
+			Array<SortedMesh>& temp = temp_meshes.emplace(frame_allocator);
+			temp.resize(submeshes.size());
+			sorted_counts.push(0);
+			SortedMesh* out = &sorted[0];
+			SortedMesh* temp_out = &temp[0];
+			int* out_count = &sorted_counts.back();
+			MTJD::Job* job = MTJD::makeJob(m_renderer.getEngine().getMTJDManager(),
+				[&submeshes, model_instances, camera_pos, out, temp_out, out_count]()
+				{
+					PROFILE_BLOCK("Sort Meshes Job");
+					int count = 0;
+					for (auto& mesh : submeshes)
+					{
+						const ModelInstance& model_instance = model_instances[mesh.model_instance.index];
+						if (model_instance.type != ModelInstance::RIGID) continue;
+						float squared_depth =
+							(model_instance.matrix.getTranslation() - camera_pos).squaredLength();
+						out[count].key = getMeshSortKey(mesh, squared_depth);
+						out[count].info = &mesh;
+						++count;
+					}
+					mergeSort(out, temp_out, count,
+						[](const SortedMesh& a, const SortedMesh& b) { return a.key < b.key; });
+					*out_count = count;
+				},
+				m_renderer.getEngine().getMTJDManager().getJobAllocator());
+			job->addDependency(&m_sync_point);
+			jobs.push(job);
+		}
+		for (MTJD::Job* job : jobs)
+		{
+			m_renderer.getEngine().getMTJDManager().schedule(job);
+		}
+
+		for (auto& submeshes : meshes)
+		{
 			for (auto& mesh : submeshes)
 			{
 				ModelInstance& model_instance = model_instances[mesh.model_instance.index];
+				if (cache && model_instance.type != ModelInstance::RIGID)
+				{
+					cache->immediate_meshes.push(mesh);
+				}
 				switch (model_instance.type)
 				{
 					case ModelInstance::RIGID:
-						renderRigidMesh(model_instance, mesh);
 						break;
 					case ModelInstance::SKINNED:
 						renderSkinnedMesh(model_instance, mesh);
@@ -2598,8 +3193,88 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 				}
 			}
 		}
+
+		if (!jobs.empty())
+		{
+			m_sync_point.sync();
+			complete = submitSortedMeshes(sorted_meshes, sorted_counts, cache);
+		}
 		finishInstances();
 		PROFILE_INT("mesh count", mesh_count);
+		return complete;
+	}
+
+
+	bool submitSortedMeshes(const Array<Array<SortedMesh>>& sorted_meshes,
+		const Array<int>& counts,
+		CachedScenePass* cache)
+	{
+		PROFILE_FUNCTION();
+		ModelInstance* model_instances = m_scene->getModelInstances();
+		IAllocator& frame_allocator = m_renderer.getEngine().getLIFOAllocator();
+		Array<int> cursors(frame_allocator);
+		cursors.resize(sorted_meshes.size());
+		for (int& cursor : cursors) cursor = 0;
+
+		for (;;)
+		{
+			// pick the list with the smallest key under its cursor; entries
+			// of one mesh are contiguous within every list, so the whole
+			// batch can be gathered across all of them
+			int best = -1;
+			for (int i = 0; i < sorted_meshes.size(); ++i)
+			{
+				if (cursors[i] >= counts[i]) continue;
+				if (best < 0 ||
+					sorted_meshes[i][cursors[i]].key < sorted_meshes[best][cursors[best]].key)
+				{
+					best = i;
+				}
+			}
+			if (best < 0) return true;
+
+			Mesh* mesh = sorted_meshes[best][cursors[best]].info->mesh;
+			int instance_count = 0;
+			for (int i = 0; i < sorted_meshes.size(); ++i)
+			{
+				int cursor = cursors[i];
+				while (cursor < counts[i] && sorted_meshes[i][cursor].info->mesh == mesh) ++cursor;
+				instance_count += cursor - cursors[i];
+			}
+
+			const bgfx::InstanceDataBuffer* buffer = m_renderer.allocInstanceDataBuffer(
+				Renderer::TransientClient::MESHES, instance_count, sizeof(Matrix));
+			if (!buffer)
+			{
+				g_log_warning.log("Renderer") << "Could not allocate instance data buffer";
+				return false;
+			}
+			float* mtcs = (float*)buffer->data;
+			int offset = 0;
+			Model* model = nullptr;
+			for (int i = 0; i < sorted_meshes.size(); ++i)
+			{
+				int& cursor = cursors[i];
+				while (cursor < counts[i] && sorted_meshes[i][cursor].info->mesh == mesh)
+				{
+					const ModelInstance& model_instance =
+						model_instances[sorted_meshes[i][cursor].info->model_instance.index];
+					copyMemory(&mtcs[offset * 16], &model_instance.matrix, sizeof(Matrix));
+					model = model_instance.model;
+					++offset;
+					++cursor;
+				}
+			}
+			if (cache)
+			{
+				CachedBatch& batch = cache->batches.emplace(m_allocator);
+				batch.mesh = mesh;
+				batch.model = model;
+				batch.matrices.resize(instance_count);
+				copyMemory(&batch.matrices[0], mtcs, instance_count * sizeof(Matrix));
+			}
+			submitInstances(*mesh, *model, buffer, instance_count);
+		}
 	}
 
 
@@ -2642,6 +3317,13 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 		if (!isReady()) return;
 		if (!m_scene) return;
 
+		u32 frame_number = m_renderer.getFrameNumber();
+		for (auto* framebuffer : m_framebuffers)
+		{
+			framebuffer->checkReadbacks(frame_number);
+		}
+		if (m_default_framebuffer) m_default_framebuffer->checkReadbacks(frame_number);
+
 		m_stats = {};
 		m_applied_camera = INVALID_COMPONENT;
 		m_global_light_shadowmap = nullptr;
@@ -2678,6 +3360,13 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 			lua_pop(m_lua_state, 1);
 		}
 		finishInstances();
+
+		for (int i = 0; i <= m_view_idx; ++i)
+		{
+			View& view = m_views[i];
+			m_renderer.addPassStats(
+				view.name, view.draw_call_count, view.instance_count, view.triangle_count);
+		}
 	}
 
 
@@ -2767,6 +3456,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	void setScene(RenderScene* scene) override
 	{
 		m_scene = scene;
+		m_pass_caches.clear();
 		if (m_lua_state && m_scene) callInitScene();
 	}
 
@@ -2810,6 +3500,9 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	Array<PointLightShadowmap> m_point_light_shadowmaps;
 	FrameBuffer* m_global_light_shadowmap;
 	InstanceData m_instances_data[128];
+	MTJD::Group m_sync_point;
+	Array<CachedScenePass> m_pass_caches;
+	int m_pass_cache_idx;
 	int m_instance_data_idx;
 	ComponentHandle m_applied_camera;
 	bgfx::VertexBufferHandle m_cube_vb;
@@ -2851,6 +3544,13 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	bgfx::UniformHandle m_cam_inv_viewproj_uniform;
 	bgfx::UniformHandle m_texture_size_uniform;
 	bgfx::UniformHandle m_grass_max_dist_uniform;
+	bgfx::UniformHandle m_cluster_params_uniform;
+	bgfx::UniformHandle m_cluster_light_pos_radius_uniform;
+	bgfx::UniformHandle m_cluster_light_color_attenuation_uniform;
+	bgfx::UniformHandle m_tex_light_clusters_uniform;
+	bgfx::UniformHandle m_tex_light_indices_uniform;
+	bgfx::TextureHandle m_light_clusters_texture;
+	bgfx::TextureHandle m_light_indices_texture;
 	int m_global_textures_count;
 	int m_layer_to_view_map[64];
 
@@ -2859,6 +3559,7 @@ struct PipelineImpl LUMIX_FINAL : public Pipeline
 	bgfx::DynamicVertexBufferHandle m_debug_vertex_buffers[32];
 	bgfx::DynamicIndexBufferHandle m_debug_index_buffer;
 	int m_debug_buffer_idx;
+	u32 m_debug_geometry_version;
 	int m_has_shadowmap_define_idx;
 };
 
@@ -3050,6 +3751,7 @@ void Pipeline::registerLuaAPI(lua_State* L)
 	REGISTER_FUNCTION(bindFramebufferTexture);
 	REGISTER_FUNCTION(bindTexture);
 	REGISTER_FUNCTION(bindEnvironmentMaps);
+	REGISTER_FUNCTION(bindLightClusters);
 	REGISTER_FUNCTION(applyCamera);
 
 	REGISTER_FUNCTION(disableBlending);
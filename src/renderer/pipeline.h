@@ -14,6 +14,8 @@ namespace bgfx
 	struct ProgramHandle;
 	struct TransientVertexBuffer;
 	struct TransientIndexBuffer;
+	struct DynamicVertexBufferHandle;
+	struct DynamicIndexBufferHandle;
 	struct VertexDecl;
 }
 
@@ -86,6 +88,11 @@ class LUMIX_RENDERER_API Pipeline
 		static void destroy(Pipeline* pipeline);
 
 		virtual FrameBuffer* getFramebuffer(const char* framebuffer_name) = 0;
+		// queues an async readback of a framebuffer's renderbuffer; the callback
+		// gets the pixels a few frames later without stalling the GPU
+		virtual bool readRenderbufferAsync(const char* framebuffer,
+			int renderbuffer_idx,
+			const Delegate<void(const u8*, int, int)>& callback) = 0;
 		virtual void setScene(RenderScene* scene) = 0;
 		virtual RenderScene* getScene() = 0;
 		virtual int getWidth() = 0;
@@ -115,6 +122,14 @@ class LUMIX_RENDERER_API Pipeline
 			int num_indices,
 			u64 render_states,
 			struct ShaderInstance& shader_instance) = 0;
+		// same as above but sourcing retained geometry from persistent dynamic buffers
+		virtual void render(const bgfx::DynamicVertexBufferHandle& vertex_buffer,
+			const bgfx::DynamicIndexBufferHandle& index_buffer,
+			const Matrix& mtx,
+			int first_index,
+			int num_indices,
+			u64 render_states,
+			struct ShaderInstance& shader_instance) = 0;
 		virtual void renderModel(Model& model, const Matrix& mtx) = 0;
 		virtual void toggleStats() = 0;
 		virtual void setWindowHandle(void* data) = 0;
@@ -2,6 +2,7 @@
 #include "engine/matrix.h"
 #include "engine/quat.h"
 #include "engine/profiler.h"
+#include "engine/simd.h"
 #include "engine/vec.h"
 #include "renderer/model.h"
 
@@ -27,17 +28,44 @@ Pose::~Pose()
 }
 
 
+void blendPositions(Vec3* dst, const Vec3* src, int count, float weight)
+{
+	// the position lerp is elementwise, so the bone positions can be blended as
+	// one flat float stream, four components per iteration regardless of how
+	// they straddle bone boundaries
+	float inv = 1.0f - weight;
+	float* pos = (float*)dst;
+	const float* src_pos = (const float*)src;
+	int float_count = count * 3;
+	float4 inv4 = f4Splat(inv);
+	float4 weight4 = f4Splat(weight);
+	int i = 0;
+	for (; i + 4 <= float_count; i += 4)
+	{
+		float4 a = f4LoadUnaligned(pos + i);
+		float4 b = f4LoadUnaligned(src_pos + i);
+		f4StoreUnaligned(pos + i, f4Add(f4Mul(a, inv4), f4Mul(b, weight4)));
+	}
+	for (; i < float_count; ++i)
+	{
+		pos[i] = pos[i] * inv + src_pos[i] * weight;
+	}
+}
+
+
+void blendRotations(Quat* dst, const Quat* src, int count, float weight)
+{
+	nlerp(dst, src, dst, weight, count);
+}
+
+
 void Pose::blend(Pose& rhs, float weight)
 {
 	ASSERT(count == rhs.count);
 	if (weight <= 0.001f) return;
 	weight = Math::clamp(weight, 0.0f, 1.0f);
-	float inv = 1.0f - weight;
-	for (int i = 0, c = count; i < c; ++i)
-	{
-		positions[i] = positions[i] * inv + rhs.positions[i] * weight;
-		nlerp(rotations[i], rhs.rotations[i], &rotations[i], weight);
-	}
+	blendPositions(positions, rhs.positions, count, weight);
+	blendRotations(rotations, rhs.rotations, count, weight);
 }
 
 
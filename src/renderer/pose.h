@@ -15,6 +15,12 @@ struct Quat;
 struct Vec3;
 
 
+// fold one blend layer into `dst`, four bones per sweep; animation layering
+// calls these once per layer instead of paying a scalar lerp/nlerp per bone
+LUMIX_RENDERER_API void blendPositions(Vec3* dst, const Vec3* src, int count, float weight);
+LUMIX_RENDERER_API void blendRotations(Quat* dst, const Quat* src, int count, float weight);
+
+
 struct LUMIX_RENDERER_API Pose
 {
 	explicit Pose(IAllocator& allocator);
@@ -1,6 +1,7 @@
 #include "render_scene.h"
 
 #include "engine/array.h"
+#include "engine/binary_array.h"
 #include "engine/blob.h"
 #include "engine/crc32.h"
 #include "engine/engine.h"
@@ -11,6 +12,7 @@
 #include "engine/log.h"
 #include "engine/lua_wrapper.h"
 #include "engine/math_utils.h"
+#include "engine/mtjd/for_each.h"
 #include "engine/mtjd/generic_job.h"
 #include "engine/mtjd/job.h"
 #include "engine/mtjd/manager.h"
@@ -29,6 +31,7 @@
 #include "renderer/material.h"
 #include "renderer/material_manager.h"
 #include "renderer/model.h"
+#include "renderer/occlusion_buffer.h"
 #include "renderer/particle_system.h"
 #include "renderer/pipeline.h"
 #include "renderer/pose.h"
@@ -187,7 +190,7 @@ public:
 
 	~RenderSceneImpl()
 	{
-		m_universe.entityTransformed().unbind<RenderSceneImpl, &RenderSceneImpl::onEntityMoved>(this);
+		m_universe.entityTransformed().unbind<RenderSceneImpl, &RenderSceneImpl::onEntitiesMoved>(this);
 		m_universe.entityDestroyed().unbind<RenderSceneImpl, &RenderSceneImpl::onEntityDestroyed>(this);
 		CullingSystem::destroy(*m_culling_system);
 	}
@@ -234,16 +237,16 @@ public:
 		}
 		m_particle_emitters.clear();
 
-		for (auto& i : m_model_instances)
+		for (int i = m_model_instances_live.nextSet(0); i >= 0; i = m_model_instances_live.nextSet(i + 1))
 		{
-			if (i.entity != INVALID_ENTITY && i.model)
-			{
-				freeCustomMeshes(i, material_manager);
-				i.model->getResourceManager().unload(*i.model);
-				LUMIX_DELETE(m_allocator, i.pose);
-			}
+			auto& r = m_model_instances[i];
+			if (!r.model) continue;
+			freeCustomMeshes(r, material_manager);
+			r.model->getResourceManager().unload(*r.model);
+			LUMIX_DELETE(m_allocator, r.pose);
 		}
 		m_model_instances.clear();
+		m_model_instances_live.clear();
 		m_culling_system->clear();
 
 		for (auto& probe : m_environment_probes)
@@ -623,6 +626,7 @@ public:
 			if (life < 0)
 			{
 				m_debug_triangles.eraseFast(i);
+				++m_debug_geometry_version;
 			}
 			else
 			{
@@ -637,6 +641,7 @@ public:
 			if(life < 0)
 			{
 				m_debug_lines.eraseFast(i);
+				++m_debug_geometry_version;
 			}
 			else
 			{
@@ -652,6 +657,7 @@ public:
 			if (life < 0)
 			{
 				m_debug_points.eraseFast(i);
+				++m_debug_geometry_version;
 			}
 			else
 			{
@@ -662,10 +668,92 @@ public:
 
 		if (m_is_game_running && !paused)
 		{
-			for (auto* emitter : m_particle_emitters)
+			PROFILE_BLOCK("update emitters");
+			// emitters no camera can see run at 1/4 rate with the skipped time
+			// folded into their next step; emitters far from every camera sleep
+			// outright and replay the missed time in substeps on re-entry
+			static const float SLEEP_DISTANCE = 100;
+			static const float MAX_PENDING_TIME = 1.0f;
+			static const float CATCHUP_STEP = 1 / 30.0f;
+
+			Array<Frustum> frustums(m_allocator);
+			Array<Vec3> camera_positions(m_allocator);
+			for (auto& camera : m_cameras)
+			{
+				frustums.push(getCameraFrustum({camera.entity.index}));
+				camera_positions.push(m_universe.getPosition(camera.entity));
+			}
+
+			Array<ParticleEmitter*> valid_emitters(m_allocator);
+			Array<Sphere> bounds(m_allocator);
+			for (int i = 0, c = m_particle_emitters.size(); i < c; ++i)
+			{
+				ParticleEmitter* emitter = m_particle_emitters.at(i);
+				if (!emitter->m_is_valid) continue;
+				valid_emitters.push(emitter);
+				bounds.push(Sphere(emitter->m_bounds_center, emitter->m_bounds_radius));
+			}
+
+			// batch the sphere tests per frustum; no camera means nothing culls
+			int emitter_count = valid_emitters.size();
+			Array<u8> visible(m_allocator);
+			Array<u8> in_frustum(m_allocator);
+			visible.resize(emitter_count);
+			in_frustum.resize(emitter_count);
+			for (u8& v : visible) v = frustums.empty() ? 1 : 0;
+			for (const Frustum& frustum : frustums)
+			{
+				if (emitter_count == 0) break;
+				frustumIntersectSpheres(frustum, &bounds[0], &in_frustum[0], emitter_count);
+				for (int i = 0; i < emitter_count; ++i) visible[i] |= in_frustum[i];
+			}
+
+			Array<ParticleEmitter*> to_update(m_allocator);
+			for (int i = 0; i < emitter_count; ++i)
+			{
+				ParticleEmitter* emitter = valid_emitters[i];
+				emitter->m_pending_dt = Math::minimum(emitter->m_pending_dt + dt, MAX_PENDING_TIME);
+				if (visible[i])
+				{
+					while (emitter->m_pending_dt > dt + CATCHUP_STEP)
+					{
+						emitter->update(CATCHUP_STEP);
+						emitter->m_pending_dt -= CATCHUP_STEP;
+					}
+					emitter->m_culled_frames = 0;
+					to_update.push(emitter);
+					continue;
+				}
+				float nearest_squared = FLT_MAX;
+				for (const Vec3& pos : camera_positions)
+				{
+					nearest_squared =
+						Math::minimum(nearest_squared, (pos - emitter->m_bounds_center).squaredLength());
+				}
+				float sleep_distance = SLEEP_DISTANCE + emitter->m_bounds_radius;
+				if (nearest_squared < sleep_distance * sleep_distance)
+				{
+					++emitter->m_culled_frames;
+					if (emitter->m_culled_frames % 4 == 0) to_update.push(emitter);
+				}
+			}
+
+			// spawning rolls the shared rng and resizes the particle arrays, so
+			// it stays on the main thread; the integration half is independent
+			// per emitter and batched so several small emitters share one job
+			for (ParticleEmitter* emitter : to_update)
 			{
-				if (emitter->m_is_valid) emitter->update(dt);
+				emitter->spawnParticles(emitter->m_pending_dt);
 			}
+			MTJD::forEach(m_engine.getMTJDManager(), m_allocator, 0, to_update.size(), 4,
+				[&to_update](int from, int to) {
+					for (int i = from; i < to; ++i)
+					{
+						ParticleEmitter* emitter = to_update[i];
+						emitter->updateParticles(emitter->m_pending_dt);
+						emitter->m_pending_dt = 0;
+					}
+				});
 		}
 	}
 
@@ -705,6 +793,7 @@ public:
 		r.custom_meshes = false;
 		r.meshes = nullptr;
 		r.mesh_count = 0;
+		setModelInstanceLive(entity.index, true);
 
 		r.matrix = m_universe.getMatrix(r.entity);
 
@@ -714,7 +803,10 @@ public:
 		ComponentHandle cmp = {r.entity.index};
 		if (path[0] != 0)
 		{
-			auto* model = static_cast<Model*>(m_engine.getResourceManager().get(MODEL_TYPE)->load(Path(path)));
+			// queued instead of loaded immediately, so a freshly opened level
+			// streams models in priority order instead of flooding the loader
+			auto* model = static_cast<Model*>(
+				m_engine.getResourceManager().get(MODEL_TYPE)->load(Path(path), 0));
 			setModel(cmp, model);
 		}
 
@@ -800,6 +892,7 @@ public:
 		serializer.read(&light.m_range);
 		serializer.read(&light.m_specular_color);
 		serializer.read(&light.m_specular_intensity);
+		m_point_light_shadow_casters.push(light.m_cast_shadows);
 		m_point_lights_map.insert(light.m_component, m_point_lights.size() - 1);
 
 		m_universe.addComponent(light.m_entity, POINT_LIGHT_TYPE, this, light.m_component);
@@ -1300,11 +1393,10 @@ public:
 		m_decals.reserve(count);
 		for (int i = 0; i < count; ++i)
 		{
-			char tmp[MAX_PATH_LENGTH];
 			Decal decal;
 			serializer.read(decal.entity);
 			serializer.read(decal.scale);
-			serializer.readString(tmp, lengthOf(tmp));
+			const char* tmp = serializer.readStringView();
 			decal.material = tmp[0] == '\0' ? nullptr : static_cast<Material*>(material_manager->load(Path(tmp)));
 			updateDecalInfo(decal);
 			m_decals.insert(decal.entity, decal);
@@ -1510,6 +1602,7 @@ public:
 			auto& r = m_model_instances.emplace();
 			serializer.read(r.entity);
 			ASSERT(r.entity.index == i || !isValid(r.entity));
+			setModelInstanceLive(i, isValid(r.entity));
 			r.model = nullptr;
 			r.pose = nullptr;
 			r.custom_meshes = false;
@@ -1526,7 +1619,8 @@ public:
 				ComponentHandle cmp = { r.entity.index };
 				if (path != 0)
 				{
-					auto* model = static_cast<Model*>(m_engine.getResourceManager().get(MODEL_TYPE)->load(Path(path)));
+					auto* model = static_cast<Model*>(
+						m_engine.getResourceManager().get(MODEL_TYPE)->load(Path(path), 0));
 					setModel(cmp, model);
 				}
 
@@ -1537,9 +1631,7 @@ public:
 					allocateCustomMeshes(r, material_count);
 					for (int j = 0; j < material_count; ++j)
 					{
-						char path[MAX_PATH_LENGTH];
-						serializer.readString(path, lengthOf(path));
-						setModelInstanceMaterial(cmp, j, Path(path));
+						setModelInstanceMaterial(cmp, j, Path(serializer.readStringView()));
 					}
 				}
 
@@ -1553,11 +1645,13 @@ public:
 		i32 size = 0;
 		serializer.read(size);
 		m_point_lights.resize(size);
+		m_point_light_shadow_casters.clear();
 		for (int i = 0; i < size; ++i)
 		{
 			m_light_influenced_geometry.emplace(m_allocator);
 			PointLight& light = m_point_lights[i];
 			serializer.read(light);
+			m_point_light_shadow_casters.push(light.m_cast_shadows);
 			m_point_lights_map.insert(light.m_component, i);
 
 			m_universe.addComponent(light.m_entity, POINT_LIGHT_TYPE, this, light.m_component);
@@ -1642,6 +1736,7 @@ public:
 		LUMIX_DELETE(m_allocator, model_instance.pose);
 		model_instance.pose = nullptr;
 		model_instance.entity = INVALID_ENTITY;
+		m_model_instances_live[component.index] = false;
 		m_universe.destroyComponent(entity, MODEL_INSTANCE_TYPE, this, component);
 	}
 
@@ -1673,6 +1768,7 @@ public:
 		int index = m_point_lights_map[component];
 		Entity entity = m_point_lights[index].m_entity;
 		m_point_lights.eraseFast(index);
+		m_point_light_shadow_casters.eraseFast(index);
 		m_point_lights_map.erase(component);
 		m_light_influenced_geometry.eraseFast(index);
 		if (index < m_point_lights.size())
@@ -2350,6 +2446,12 @@ public:
 	}
 
 
+	void onEntitiesMoved(const Entity* entities, int count)
+	{
+		for (int i = 0; i < count; ++i) onEntityMoved(entities[i]);
+	}
+
+
 	void onEntityMoved(Entity entity)
 	{
 		int index = entity.index;
@@ -2358,6 +2460,7 @@ public:
 		if (index < m_model_instances.size() && isValid(m_model_instances[index].entity) &&
 			m_model_instances[index].model && m_model_instances[index].model->isReady())
 		{
+			++m_scene_version;
 			ModelInstance& r = m_model_instances[index];
 			r.matrix = m_universe.getMatrix(entity);
 			if (r.model && r.model->isReady())
@@ -2598,6 +2701,26 @@ public:
 	Model* getModelInstanceModel(ComponentHandle cmp) override { return m_model_instances[cmp.index].model; }
 
 
+	void prefetchModels(const Vec3& center, float radius) override
+	{
+		float radius_squared = radius * radius;
+		auto* model_manager = m_engine.getResourceManager().get(MODEL_TYPE);
+		for (int i = m_model_instances_live.nextSet(0); i >= 0; i = m_model_instances_live.nextSet(i + 1))
+		{
+			auto& r = m_model_instances[i];
+			if (!r.model) continue;
+			if (!r.model->isEmpty()) continue;
+
+			float dist_squared = (r.matrix.getTranslation() - center).squaredLength();
+			if (dist_squared > radius_squared) continue;
+
+			model_manager->prioritize(*r.model, radius_squared - dist_squared);
+			Vec3 pos = r.matrix.getTranslation();
+			addDebugCube(pos - Vec3(0.5f, 0.5f, 0.5f), pos + Vec3(0.5f, 0.5f, 0.5f), 0xff00a0ff, 0);
+		}
+	}
+
+
 	static u64 getLayerMask(ModelInstance& model_instance)
 	{
 		Model* model = model_instance.model;
@@ -2906,6 +3029,29 @@ public:
 	}
 
 
+	float getGrassDensityMultiplier() const override { return m_grass_density_multiplier; }
+
+
+	void setGrassDensityMultiplier(float multiplier) override
+	{
+		multiplier = Math::clamp(multiplier, 0.0f, 1.0f);
+		if (multiplier == m_grass_density_multiplier) return;
+		m_grass_density_multiplier = multiplier;
+		for (auto* terrain : m_terrains) terrain->forceGrassUpdate();
+	}
+
+
+	int getGrassMemoryBudget() const override { return m_grass_memory_budget; }
+
+
+	void setGrassMemoryBudget(int bytes) override
+	{
+		if (bytes == m_grass_memory_budget) return;
+		m_grass_memory_budget = bytes;
+		for (auto* terrain : m_terrains) terrain->forceGrassUpdate();
+	}
+
+
 	int getGrassRotationMode(ComponentHandle cmp, int index) override
 	{
 		return (int)m_terrains[{cmp.index}]->getGrassTypeRotationMode(index);
@@ -2983,11 +3129,9 @@ public:
 
 	ComponentHandle getNextModelInstance(ComponentHandle cmp) override
 	{
-		for(int i = cmp.index + 1; i < m_model_instances.size(); ++i)
-		{
-			if (m_model_instances[i].entity != INVALID_ENTITY) return {i};
-		}
-		return INVALID_COMPONENT;
+		int index = m_model_instances_live.nextSet(cmp.index + 1);
+		if (index < 0) return INVALID_COMPONENT;
+		return {index};
 	}
 
 
@@ -3015,7 +3159,25 @@ public:
 	}
 
 
-	void fillTemporaryInfos(const CullingSystem::Results& results, const Frustum& frustum, const Vec3& lod_ref_point)
+	void buildOcclusionBuffer(const Frustum& frustum)
+	{
+		PROFILE_FUNCTION();
+		m_occlusion_buffer.begin(frustum);
+		for (ComponentHandle cmp : m_occluder_instances)
+		{
+			const ModelInstance& r = m_model_instances[cmp.index];
+			if (!r.model || !r.model->isReady()) continue;
+			const Sphere& sphere = m_culling_system->getSphere(cmp);
+			if (!frustum.isSphereInside(sphere.position, sphere.radius)) continue;
+			m_occlusion_buffer.rasterizeOccluders(r.model, r.matrix);
+		}
+	}
+
+
+	void createTemporaryInfoJobs(const CullingSystem::Results& results,
+		const Frustum& frustum,
+		const Vec3& lod_ref_point,
+		bool use_occlusion)
 	{
 		PROFILE_FUNCTION();
 		m_jobs.clear();
@@ -3033,11 +3195,11 @@ public:
 		{
 			Array<ModelInstanceMesh>& subinfos = m_temporary_infos[subresult_index];
 			subinfos.clear();
-			if (results[subresult_index].empty()) continue;
 
 			MTJD::Job* job = MTJD::makeJob(m_engine.getMTJDManager(),
-				[&subinfos, this, &results, subresult_index, &frustum, lod_ref_point]()
+				[&subinfos, this, &results, subresult_index, &frustum, lod_ref_point, use_occlusion]()
 				{
+					if (results[subresult_index].empty()) return;
 					PROFILE_BLOCK("Temporary Info Job");
 					PROFILE_INT("ModelInstance count", results[subresult_index].size());
 					Vec3 ref_point = lod_ref_point;
@@ -3051,12 +3213,18 @@ public:
 					ModelInstance* LUMIX_RESTRICT model_instances = &m_model_instances[0];
 					for (int i = 0, c = results[subresult_index].size(); i < c; ++i)
 					{
+						if (use_occlusion)
+						{
+							const Sphere& sphere = m_culling_system->getSphere(raw_subresults[i]);
+							if (m_occlusion_buffer.isOccluded(sphere.position, sphere.radius)) continue;
+						}
 						const ModelInstance* LUMIX_RESTRICT model_instance = &model_instances[raw_subresults[i].index];
 						float squared_distance = (model_instance->matrix.getTranslation() - ref_point).squaredLength();
 						squared_distance *= lod_multiplier;
 
 						const Model* LUMIX_RESTRICT model = model_instance->model;
-						LODMeshIndices lod = model->getLODMeshIndices(squared_distance);
+						LODMeshIndices lod =
+							model->getDitheredLODMeshIndices(squared_distance, (u32)raw_subresults[i].index);
 						for (int j = lod.from, c = lod.to; j <= c; ++j)
 						{
 							auto& info = subinfos.emplace();
@@ -3065,11 +3233,10 @@ public:
 						}
 					}
 				},
-				m_allocator);
+				m_engine.getMTJDManager().getJobAllocator());
 			job->addDependency(&m_sync_point);
 			m_jobs.push(job);
 		}
-		runJobs(m_jobs, m_sync_point);
 	}
 
 
@@ -3157,13 +3324,15 @@ public:
 
 	void setLightCastShadows(ComponentHandle cmp, bool cast_shadows) override
 	{
-		m_point_lights[m_point_lights_map[cmp]].m_cast_shadows = cast_shadows;
+		int index = m_point_lights_map[cmp];
+		m_point_lights[index].m_cast_shadows = cast_shadows;
+		m_point_light_shadow_casters[index] = cast_shadows;
 	}
 
 
 	bool getLightCastShadows(ComponentHandle cmp) override
 	{
-		return m_point_lights[m_point_lights_map[cmp]].m_cast_shadows;
+		return m_point_light_shadow_casters[m_point_lights_map[cmp]];
 	}
 
 
@@ -3174,19 +3343,30 @@ public:
 		PROFILE_FUNCTION();
 
 		int light_index = m_point_lights_map[light_cmp];
-		for (int j = 0, cj = m_light_influenced_geometry[light_index].size(); j < cj; ++j)
+		const Array<ComponentHandle>& geometry = m_light_influenced_geometry[light_index];
+		if (geometry.empty()) return;
+
+		// gather the scattered bounding spheres once, then one batch test
+		Array<Sphere> spheres(m_allocator);
+		spheres.resize(geometry.size());
+		for (int j = 0; j < geometry.size(); ++j)
 		{
-			ComponentHandle model_instance_cmp = m_light_influenced_geometry[light_index][j];
+			spheres[j] = m_culling_system->getSphere(geometry[j]);
+		}
+		Array<u8> visible(m_allocator);
+		visible.resize(geometry.size());
+		frustumIntersectSpheres(frustum, &spheres[0], &visible[0], spheres.size());
+
+		for (int j = 0, cj = geometry.size(); j < cj; ++j)
+		{
+			if (!visible[j]) continue;
+			ComponentHandle model_instance_cmp = geometry[j];
 			ModelInstance& model_instance = m_model_instances[model_instance_cmp.index];
-			const Sphere& sphere = m_culling_system->getSphere(model_instance_cmp);
-			if (frustum.isSphereInside(sphere.position, sphere.radius))
+			for (int k = 0, kc = model_instance.model->getMeshCount(); k < kc; ++k)
 			{
-				for (int k = 0, kc = model_instance.model->getMeshCount(); k < kc; ++k)
-				{
-					auto& info = infos.emplace();
-					info.mesh = &model_instance.model->getMesh(k);
-					info.model_instance = model_instance_cmp;
-				}
+				auto& info = infos.emplace();
+				info.mesh = &model_instance.model->getMesh(k);
+				info.model_instance = model_instance_cmp;
 			}
 		}
 	}
@@ -3235,10 +3415,24 @@ public:
 		PROFILE_FUNCTION();
 
 		for(auto& i : m_temporary_infos) i.clear();
-		const CullingSystem::Results* results = cull(frustum, layer_mask);
-		if (!results) return m_temporary_infos;
+		if (m_model_instances.empty()) return m_temporary_infos;
+
+		// the info jobs run as continuations of the culling jobs, so the
+		// whole cull -> lod/mesh gathering chain stays on the workers and
+		// the main thread blocks only once, on the final sync point
+		// ortho frustums are shadowmap passes, occluders are rasterized for
+		// the camera only
+		bool use_occlusion = frustum.fov > 0 && !m_occluder_instances.empty();
+		if (use_occlusion)
+		{
+			buildOcclusionBuffer(frustum);
+			use_occlusion = m_occlusion_buffer.hasOccluders();
+		}
 
-		fillTemporaryInfos(*results, frustum, lod_ref_point);
+		const CullingSystem::Results& results = m_culling_system->peekResult();
+		createTemporaryInfoJobs(results, frustum, lod_ref_point, use_occlusion);
+		m_culling_system->cullToFrustumAsync(frustum, layer_mask, &m_jobs[0], m_jobs.size());
+		m_sync_point.sync();
 		return m_temporary_infos;
 	}
 
@@ -3268,8 +3462,13 @@ public:
 	float getCameraScreenHeight(ComponentHandle camera) override { return m_cameras[{camera.index}].screen_height; }
 
 
-	void setGlobalLODMultiplier(float multiplier) { m_lod_multiplier = multiplier; }
+	void setGlobalLODMultiplier(float multiplier)
+	{
+		if (multiplier != m_lod_multiplier) ++m_scene_version;
+		m_lod_multiplier = multiplier;
+	}
 	float getGlobalLODMultiplier() const { return m_lod_multiplier; }
+	u32 getSceneVersion() const override { return m_scene_version; }
 
 
 	Matrix getCameraViewProjection(ComponentHandle cmp) override
@@ -3327,6 +3526,7 @@ public:
 
 	const Array<DebugTriangle>& getDebugTriangles() const override { return m_debug_triangles; }
 	const Array<DebugLine>& getDebugLines() const override { return m_debug_lines; }
+	u32 getDebugGeometryVersion() const override { return m_debug_geometry_version; }
 	const Array<DebugPoint>& getDebugPoints() const override { return m_debug_points; }
 
 
@@ -3519,6 +3719,7 @@ public:
 		tri.p2 = p2;
 		tri.color = ARGBToABGR(color);
 		tri.life = life;
+		++m_debug_geometry_version;
 	}
 
 
@@ -3899,6 +4100,7 @@ public:
 		point.pos = pos;
 		point.color = ARGBToABGR(color);
 		point.life = life;
+		++m_debug_geometry_version;
 	}
 
 
@@ -3932,11 +4134,55 @@ public:
 
 	void addDebugLine(const Vec3& from, const Vec3& to, u32 color, float life) override
 	{
+		u32 abgr = ARGBToABGR(color);
+		if (!m_debug_lines.empty())
+		{
+			// wireframe shapes submit shared edges twice in a row; drop the duplicate
+			DebugLine& last = m_debug_lines.back();
+			if (last.color == abgr &&
+				((compareMemory(&last.from, &from, sizeof(from)) == 0 &&
+					 compareMemory(&last.to, &to, sizeof(to)) == 0) ||
+					(compareMemory(&last.from, &to, sizeof(to)) == 0 &&
+						compareMemory(&last.to, &from, sizeof(from)) == 0)))
+			{
+				if (life > last.life) last.life = life;
+				return;
+			}
+		}
 		DebugLine& line = m_debug_lines.emplace();
 		line.from = from;
 		line.to = to;
-		line.color = ARGBToABGR(color);
+		line.color = abgr;
 		line.life = life;
+		++m_debug_geometry_version;
+	}
+
+
+	void addDebugLines(const DebugLine* lines, int count) override
+	{
+		int offset = m_debug_lines.size();
+		m_debug_lines.resize(offset + count);
+		for (int i = 0; i < count; ++i)
+		{
+			DebugLine& line = m_debug_lines[offset + i];
+			line = lines[i];
+			line.color = ARGBToABGR(lines[i].color);
+		}
+		++m_debug_geometry_version;
+	}
+
+
+	void addDebugTriangles(const DebugTriangle* triangles, int count) override
+	{
+		int offset = m_debug_triangles.size();
+		m_debug_triangles.resize(offset + count);
+		for (int i = 0; i < count; ++i)
+		{
+			DebugTriangle& tri = m_debug_triangles[offset + i];
+			tri = triangles[i];
+			tri.color = ARGBToABGR(triangles[i].color);
+		}
+		++m_debug_geometry_version;
 	}
 
 
@@ -4297,25 +4543,108 @@ public:
 		{
 			m_light_influenced_geometry[i].eraseItemFast(component);
 		}
+		m_occluder_instances.eraseItemFast(component);
 		m_culling_system->removeStatic(component);
+		++m_scene_version;
+	}
+
+
+	int findMeshSet(const Mesh* meshes) const
+	{
+		for (int i = 0; i < m_custom_mesh_sets.size(); ++i)
+		{
+			if (m_custom_mesh_sets[i].meshes == meshes) return i;
+		}
+		return -1;
+	}
+
+
+	void destroyMeshArray(Mesh* meshes, int count, MaterialManager* manager)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			if (meshes[i].material) manager->unload(*meshes[i].material);
+			meshes[i].~Mesh();
+		}
+		m_allocator.deallocate(meshes);
+	}
+
+
+	void releaseMeshSet(int set_idx, MaterialManager* manager)
+	{
+		MeshSet& set = m_custom_mesh_sets[set_idx];
+		--set.ref_count;
+		if (set.ref_count > 0) return;
+		destroyMeshArray(set.meshes, set.count, manager);
+		m_custom_mesh_sets.eraseFast(set_idx);
 	}
 
 
 	void freeCustomMeshes(ModelInstance& r, MaterialManager* manager)
 	{
 		if (!r.custom_meshes) return;
-		for (int i = 0; i < r.mesh_count; ++i)
+
+		int set_idx = findMeshSet(r.meshes);
+		if (set_idx >= 0)
 		{
-			manager->unload(*r.meshes[i].material);
-			r.meshes[i].~Mesh();
+			releaseMeshSet(set_idx, manager);
+		}
+		else
+		{
+			destroyMeshArray(r.meshes, r.mesh_count, manager);
 		}
-		m_allocator.deallocate(r.meshes);
 		r.meshes = nullptr;
 		r.custom_meshes = false;
 		r.mesh_count = 0;
 	}
 
 
+	// reattaches a privately mutated mesh array: instances whose model and
+	// per-slot materials match end up pointing at the same shared array, so
+	// overriding one material on hundreds of instances costs one mesh set
+	void internCustomMeshes(ModelInstance& r)
+	{
+		if (!r.custom_meshes) return;
+		if (findMeshSet(r.meshes) >= 0) return;
+
+		u64 key = r.model ? r.model->getPath().getHash() : 0;
+		for (int i = 0; i < r.mesh_count; ++i)
+		{
+			u32 material_hash = r.meshes[i].material ? r.meshes[i].material->getPath().getHash() : 0;
+			key = key * 1099511628211ULL + material_hash;
+		}
+
+		auto& rm = m_engine.getResourceManager();
+		auto* material_manager = static_cast<MaterialManager*>(rm.get(MATERIAL_TYPE));
+		for (int i = 0; i < m_custom_mesh_sets.size(); ++i)
+		{
+			MeshSet& set = m_custom_mesh_sets[i];
+			if (set.key != key || set.count != r.mesh_count) continue;
+			bool equal = true;
+			for (int j = 0; j < r.mesh_count; ++j)
+			{
+				if (set.meshes[j].material != r.meshes[j].material)
+				{
+					equal = false;
+					break;
+				}
+			}
+			if (!equal) continue;
+
+			++set.ref_count;
+			destroyMeshArray(r.meshes, r.mesh_count, material_manager);
+			r.meshes = set.meshes;
+			return;
+		}
+
+		MeshSet& set = m_custom_mesh_sets.emplace();
+		set.key = key;
+		set.meshes = r.meshes;
+		set.count = r.mesh_count;
+		set.ref_count = 1;
+	}
+
+
 	void modelLoaded(Model* model, ComponentHandle component)
 	{
 		auto& rm = m_engine.getResourceManager();
@@ -4368,6 +4697,7 @@ public:
 				r.meshes[i].set(
 					src.attribute_array_offset, src.attribute_array_size, src.indices_offset, src.indices_count);
 			}
+			internCustomMeshes(r);
 		}
 		else
 		{
@@ -4386,6 +4716,9 @@ public:
 				m_light_influenced_geometry[i].push(component);
 			}
 		}
+
+		if (model->hasOccluderMeshes()) m_occluder_instances.push(component);
+		++m_scene_version;
 	}
 
 
@@ -4421,47 +4754,53 @@ public:
 	}
 
 
+	// detaches the instance onto a private mesh array; callers mutate it and
+	// reattach through internCustomMeshes
 	void allocateCustomMeshes(ModelInstance& r, int count)
 	{
-		if (r.custom_meshes && r.mesh_count == count) return;
+		int set_idx = r.custom_meshes ? findMeshSet(r.meshes) : -1;
+		bool is_private = r.custom_meshes && set_idx < 0;
+		if (is_private && r.mesh_count == count) return;
 
 		ASSERT(r.model);
 		auto& rm = r.model->getResourceManager();
 		auto* material_manager = static_cast<MaterialManager*>(rm.getOwner().get(MATERIAL_TYPE));
 
 		auto* new_meshes = (Mesh*)m_allocator.allocate(count * sizeof(Mesh));
-		if (r.meshes)
+		int copy_count = r.meshes ? Math::minimum((int)r.mesh_count, count) : 0;
+		for (int i = 0; i < copy_count; ++i)
 		{
-			for (int i = 0; i < r.mesh_count; ++i)
-			{
-				new (NewPlaceholder(), new_meshes + i) Mesh(r.meshes[i]);
-			}
+			new (NewPlaceholder(), new_meshes + i) Mesh(r.meshes[i]);
+		}
+		for (int i = copy_count; i < count; ++i)
+		{
+			new (NewPlaceholder(), new_meshes + i) Mesh(nullptr, 0, 0, 0, 0, "", m_allocator);
+		}
 
-			if (r.custom_meshes)
+		if (is_private)
+		{
+			// the copy takes over the old private array's material references
+			for (int i = count; i < r.mesh_count; ++i)
 			{
-				for (int i = count; i < r.mesh_count; ++i)
-				{
-					material_manager->unload(*r.meshes[i].material);
-				}
-				for (int i = 0; i < r.mesh_count; ++i)
-				{
-					r.meshes[i].~Mesh();
-				}
-				m_allocator.deallocate(r.meshes);
+				if (r.meshes[i].material) material_manager->unload(*r.meshes[i].material);
 			}
-			else
+			for (int i = 0; i < r.mesh_count; ++i)
 			{
-				for (int i = 0; i < r.mesh_count; ++i)
-				{
-					material_manager->load(*r.meshes[i].material);
-				}
+				r.meshes[i].~Mesh();
 			}
+			m_allocator.deallocate(r.meshes);
 		}
-
-		for (int i = r.mesh_count; i < count; ++i)
+		else
 		{
-			new (NewPlaceholder(), new_meshes + i) Mesh(nullptr, 0, 0, 0, 0, "", m_allocator);
+			// the source belongs to the model or to a shared set, so the copy
+			// needs references of its own
+			for (int i = 0; i < copy_count; ++i)
+			{
+				if (new_meshes[i].material) material_manager->load(*new_meshes[i].material);
+			}
+			if (set_idx >= 0) releaseMeshSet(set_idx, material_manager);
 		}
+
 		r.meshes = new_meshes;
 		r.mesh_count = count;
 		r.custom_meshes = true;
@@ -4483,6 +4822,8 @@ public:
 		if (r.meshes[index].material) material_manager->unload(*r.meshes[index].material);
 		auto* new_material = static_cast<Material*>(material_manager->load(path));
 		r.meshes[index].material = new_material;
+		internCustomMeshes(r);
+		++m_scene_version;
 	}
 
 
@@ -4753,6 +5094,7 @@ public:
 		light.m_cast_shadows = false;
 		light.m_attenuation_param = 2;
 		light.m_range = 10;
+		m_point_light_shadow_casters.push(false);
 		m_point_lights_map.insert(light.m_component, m_point_lights.size() - 1);
 
 		m_universe.addComponent(entity, POINT_LIGHT_TYPE, this, light.m_component);
@@ -4821,6 +5163,16 @@ public:
 	}
 
 
+	void setModelInstanceLive(int index, bool live)
+	{
+		while (index >= m_model_instances_live.size())
+		{
+			m_model_instances_live.push(false);
+		}
+		m_model_instances_live[index] = live;
+	}
+
+
 	ComponentHandle createModelInstance(Entity entity)
 	{
 		while(entity.index >= m_model_instances.size())
@@ -4838,6 +5190,7 @@ public:
 		r.custom_meshes = false;
 		r.mesh_count = 0;
 		r.matrix = m_universe.getMatrix(entity);
+		setModelInstanceLive(entity.index, true);
 		ComponentHandle cmp = {entity.index};
 		m_universe.addComponent(entity, MODEL_INSTANCE_TYPE, this, cmp);
 		m_model_instance_created.invoke(cmp);
@@ -4879,13 +5232,30 @@ private:
 
 	ComponentHandle m_point_light_last_cmp;
 	Array<Array<ComponentHandle>> m_light_influenced_geometry;
+	Array<ComponentHandle> m_occluder_instances;
+	OcclusionBuffer m_occlusion_buffer;
 	ComponentHandle m_active_global_light_cmp;
 	HashMap<ComponentHandle, int> m_point_lights_map;
 
+	// instances with identical material overrides share one refcounted mesh
+	// array instead of each holding a private copy of the whole set
+	struct MeshSet
+	{
+		u64 key;
+		Mesh* meshes;
+		int count;
+		int ref_count;
+	};
+
 	AssociativeArray<Entity, Decal> m_decals;
 	Array<ModelInstance> m_model_instances;
+	// one bit per m_model_instances slot; set when the slot holds a live component
+	BinaryArray m_model_instances_live;
+	Array<MeshSet> m_custom_mesh_sets;
 	HashMap<Entity, GlobalLight> m_global_lights;
 	Array<PointLight> m_point_lights;
+	// parallel to m_point_lights; lets the pipeline test shadow casters without touching the structs
+	BinaryArray m_point_light_shadow_casters;
 	HashMap<Entity, Camera> m_cameras;
 	Array<BoneAttachment> m_bone_attachments;
 	AssociativeArray<Entity, EnvironmentProbe> m_environment_probes;
@@ -4902,8 +5272,12 @@ private:
 
 	float m_time;
 	float m_lod_multiplier;
+	u32 m_scene_version;
+	u32 m_debug_geometry_version;
 	bool m_is_updating_attachments;
 	bool m_is_grass_enabled;
+	float m_grass_density_multiplier;
+	int m_grass_memory_budget;
 	bool m_is_game_running;
 
 	AssociativeArray<Model*, ModelLoadedCallback> m_model_loaded_callbacks;
@@ -4962,10 +5336,15 @@ RenderSceneImpl::RenderSceneImpl(Renderer& renderer,
 	, m_allocator(allocator)
 	, m_model_loaded_callbacks(m_allocator)
 	, m_model_instances(m_allocator)
+	, m_model_instances_live(m_allocator)
+	, m_custom_mesh_sets(m_allocator)
 	, m_cameras(m_allocator)
 	, m_terrains(m_allocator)
 	, m_point_lights(m_allocator)
+	, m_point_light_shadow_casters(m_allocator)
 	, m_light_influenced_geometry(m_allocator)
+	, m_occluder_instances(m_allocator)
+	, m_occlusion_buffer(m_allocator)
 	, m_global_lights(m_allocator)
 	, m_decals(m_allocator)
 	, m_debug_triangles(m_allocator)
@@ -4979,20 +5358,25 @@ RenderSceneImpl::RenderSceneImpl(Renderer& renderer,
 	, m_model_instance_created(m_allocator)
 	, m_model_instance_destroyed(m_allocator)
 	, m_is_grass_enabled(true)
+	, m_grass_density_multiplier(1.0f)
+	, m_grass_memory_budget(0)
 	, m_is_game_running(false)
 	, m_particle_emitters(m_allocator)
 	, m_point_lights_map(m_allocator)
 	, m_bone_attachments(m_allocator)
 	, m_environment_probes(m_allocator)
 	, m_lod_multiplier(1.0f)
+	, m_scene_version(0)
+	, m_debug_geometry_version(0)
 	, m_time(0)
 	, m_is_updating_attachments(false)
 {
 	is_opengl = renderer.isOpenGL();
-	m_universe.entityTransformed().bind<RenderSceneImpl, &RenderSceneImpl::onEntityMoved>(this);
+	m_universe.entityTransformed().bind<RenderSceneImpl, &RenderSceneImpl::onEntitiesMoved>(this);
 	m_universe.entityDestroyed().bind<RenderSceneImpl, &RenderSceneImpl::onEntityDestroyed>(this);
 	m_culling_system = CullingSystem::create(m_engine.getMTJDManager(), m_allocator);
 	m_model_instances.reserve(5000);
+	m_model_instances_live.reserve(5000);
 
 	for (auto& i : COMPONENT_INFOS)
 	{
@@ -5057,6 +5441,10 @@ void RenderScene::registerLuaAPI(lua_State* L)
 
 	REGISTER_FUNCTION(setGlobalLODMultiplier);
 	REGISTER_FUNCTION(getGlobalLODMultiplier);
+	REGISTER_FUNCTION(setGrassDensityMultiplier);
+	REGISTER_FUNCTION(getGrassDensityMultiplier);
+	REGISTER_FUNCTION(setGrassMemoryBudget);
+	REGISTER_FUNCTION(getGrassMemoryBudget);
 	REGISTER_FUNCTION(getCameraViewProjection);
 	REGISTER_FUNCTION(getGlobalLightEntity);
 	REGISTER_FUNCTION(getActiveGlobalLight);
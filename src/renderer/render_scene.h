@@ -162,6 +162,10 @@ public:
 		float life) = 0;
 
 	virtual void addDebugLine(const Vec3& from, const Vec3& to, u32 color, float life) = 0;
+	// bulk append of pre-built debug geometry; entries use ARGB colors like
+	// the single-shape calls
+	virtual void addDebugLines(const DebugLine* lines, int count) = 0;
+	virtual void addDebugTriangles(const DebugTriangle* triangles, int count) = 0;
 	virtual void addDebugCross(const Vec3& center, float size, u32 color, float life) = 0;
 	virtual void addDebugCube(const Vec3& pos,
 		const Vec3& dir,
@@ -220,6 +224,9 @@ public:
 	virtual const Array<DebugTriangle>& getDebugTriangles() const = 0;
 	virtual const Array<DebugLine>& getDebugLines() const = 0;
 	virtual const Array<DebugPoint>& getDebugPoints() const = 0;
+	// bumped whenever debug geometry is added or expires, so renderers can keep
+	// long-lived shapes in GPU buffers instead of re-uploading them every frame
+	virtual u32 getDebugGeometryVersion() const = 0;
 
 	virtual Matrix getCameraProjection(ComponentHandle camera) = 0;
 	virtual Matrix getCameraViewProjection(ComponentHandle camera) = 0;
@@ -313,8 +320,14 @@ public:
 	virtual Array<Array<ModelInstanceMesh>>& getModelInstanceInfos(const Frustum& frustum,
 		const Vec3& lod_ref_point,
 		u64 layer_mask) = 0;
+	// bumped whenever the renderable set changes (transforms, model loads and
+	// unloads, material overrides), so cached draw lists can be invalidated
+	virtual u32 getSceneVersion() const = 0;
 	virtual void getModelInstanceEntities(const Frustum& frustum, Array<Entity>& entities) = 0;
 	virtual Entity getModelInstanceEntity(ComponentHandle cmp) = 0;
+	// raises the load priority of queued models around center and draws
+	// placeholder boxes for instances whose model is still streaming in
+	virtual void prefetchModels(const Vec3& center, float radius) = 0;
 	virtual ComponentHandle getFirstModelInstance() = 0;
 	virtual ComponentHandle getNextModelInstance(ComponentHandle cmp) = 0;
 	virtual Model* getModelInstanceModel(ComponentHandle cmp) = 0;
@@ -348,6 +361,10 @@ public:
 	virtual ComponentHandle getNextTerrain(ComponentHandle cmp) = 0;
 
 	virtual bool isGrassEnabled() const = 0;
+	virtual float getGrassDensityMultiplier() const = 0;
+	virtual void setGrassDensityMultiplier(float multiplier) = 0;
+	virtual int getGrassMemoryBudget() const = 0;
+	virtual void setGrassMemoryBudget(int bytes) = 0;
 	virtual int getGrassRotationMode(ComponentHandle cmp, int index) = 0;
 	virtual void setGrassRotationMode(ComponentHandle cmp, int index, int value) = 0;
 	virtual float getGrassDistance(ComponentHandle cmp, int index) = 0;
@@ -1,19 +1,24 @@
 #include "renderer.h"
 
 #include "engine/array.h"
+#include "engine/base_proxy_allocator.h"
 #include "engine/command_line_parser.h"
 #include "engine/crc32.h"
 #include "engine/debug/debug.h"
+#include "engine/delegate_list.h"
 #include "engine/engine.h"
 #include "engine/fs/os_file.h"
 #include "engine/lifo_allocator.h"
 #include "engine/log.h"
+#include "engine/math_utils.h"
+#include "engine/mt/thread.h"
 #include "engine/profiler.h"
 #include "engine/property_descriptor.h"
 #include "engine/property_register.h"
 #include "engine/resource_manager.h"
 #include "engine/string.h"
 #include "engine/system.h"
+#include "engine/timer.h"
 #include "engine/universe/universe.h"
 #include "renderer/material.h"
 #include "renderer/material_manager.h"
@@ -586,7 +591,7 @@ struct RendererImpl LUMIX_FINAL : public Renderer
 
 	explicit RendererImpl(Engine& engine)
 		: m_engine(engine)
-		, m_allocator(engine.getAllocator())
+		, m_allocator("renderer", engine.getAllocator())
 		, m_texture_manager(m_allocator)
 		, m_model_manager(m_allocator)
 		, m_material_manager(*this, m_allocator)
@@ -597,7 +602,15 @@ struct RendererImpl LUMIX_FINAL : public Renderer
 		, m_layers(m_allocator)
 		, m_bgfx_allocator(m_allocator)
 		, m_callback_stub(*this)
+		, m_pass_stats(m_allocator)
+		, m_frame_pass_stats(m_allocator)
+		, m_before_submit(m_allocator)
+		, m_target_frame_time(0)
+		, m_max_queued_frames(0)
+		, m_gpu_frame_time(0)
+		, m_queued_frames(0)
 	{
+		m_frame_timer = Timer::create(m_allocator);
 		registerProperties(engine.getAllocator());
 		bgfx::PlatformData d;
 		void* window_handle = engine.getPlatformData().window_handle;
@@ -636,6 +649,20 @@ struct RendererImpl LUMIX_FINAL : public Renderer
 
 		m_current_pass_hash = crc32("MAIN");
 		m_view_counter = 0;
+		m_frame_number = 0;
+
+		// calibrated against the bundled bgfx transient pools (6MB of vertex
+		// and instance data, 2MB of indices); a client can run past its budget
+		// only while the more important clients still fit in what remains
+		setTransientBudget(TransientClient::GUI, 1024 * 1024);
+		setTransientBudget(TransientClient::MESHES, 3 * 1024 * 1024);
+		setTransientBudget(TransientClient::DEBUG_DRAW, 1024 * 1024);
+		setTransientBudget(TransientClient::PARTICLES, 1024 * 1024);
+		for (TransientPool& pool : m_transient_pools)
+		{
+			pool.used = 0;
+			pool.high_water = 0;
+		}
 		m_mat_color_uniform =
 			bgfx::createUniform("u_materialColor", bgfx::UniformType::Vec4);
 		m_roughness_metallic_uniform =
@@ -653,6 +680,9 @@ struct RendererImpl LUMIX_FINAL : public Renderer
 			.end();
 
 		m_default_shader = static_cast<Shader*>(m_shader_manager.load(Path("pipelines/common/default.shd")));
+		// optional manifest shipped next to the pipelines; every listed shader
+		// and its variant binaries start loading before the first frame
+		m_shader_manager.prewarmFromManifest("pipelines/shader_cache.lst");
 		RenderScene::registerLuaAPI(m_engine.getState());
 		m_layers.emplace("default");
 		m_layers.emplace("transparent");
@@ -662,6 +692,8 @@ struct RendererImpl LUMIX_FINAL : public Renderer
 
 	~RendererImpl()
 	{
+		Timer::destroy(m_frame_timer);
+		m_shader_manager.unloadPrewarmed();
 		m_shader_manager.unload(*m_default_shader);
 		m_texture_manager.destroy();
 		m_model_manager.destroy();
@@ -760,11 +792,196 @@ struct RendererImpl LUMIX_FINAL : public Renderer
 	}
 
 
+	void addPassStats(const char* pass_name, int draw_calls, int instances, int triangles) override
+	{
+		for (PassStats& stats : m_frame_pass_stats)
+		{
+			if (equalStrings(stats.name, pass_name))
+			{
+				stats.draw_call_count += draw_calls;
+				stats.instance_count += instances;
+				stats.triangle_count += triangles;
+				return;
+			}
+		}
+		PassStats& stats = m_frame_pass_stats.emplace();
+		copyString(stats.name, pass_name);
+		stats.draw_call_count = draw_calls;
+		stats.instance_count = instances;
+		stats.triangle_count = triangles;
+	}
+
+
+	int getPassStatsCount() const override { return m_pass_stats.size(); }
+
+
+	const PassStats& getPassStats(int index) const override { return m_pass_stats[index]; }
+
+
+	u32 getFrameNumber() const override { return m_frame_number; }
+
+
+	// a client may exceed its own budget while the pool still covers what the
+	// more important clients have not used yet; budgets are soft in quiet
+	// frames but the reserve holds once the frame runs hot
+	bool checkTransientBudget(TransientClient client, u32 bytes) const
+	{
+		const TransientPool& pool = m_transient_pools[(int)client];
+		if (pool.used + bytes <= pool.budget) return true;
+
+		u32 total_used = 0;
+		u32 total_budget = 0;
+		u32 reserved = 0;
+		for (int i = 0; i < lengthOf(m_transient_pools); ++i)
+		{
+			const TransientPool& p = m_transient_pools[i];
+			total_used += p.used;
+			total_budget += p.budget;
+			if (i < (int)client && p.used < p.budget) reserved += p.budget - p.used;
+		}
+		return total_used + reserved + bytes <= total_budget;
+	}
+
+
+	void chargeTransient(TransientClient client, u32 bytes)
+	{
+		TransientPool& pool = m_transient_pools[(int)client];
+		pool.used += bytes;
+		if (pool.used > pool.high_water) pool.high_water = pool.used;
+	}
+
+
+	bool checkAvailTransientBuffers(TransientClient client,
+		int num_vertices,
+		const bgfx::VertexDecl& decl,
+		int num_indices) override
+	{
+		u32 bytes = u32(num_vertices) * decl.getStride() + u32(num_indices) * sizeof(u16);
+		if (!checkTransientBudget(client, bytes)) return false;
+		if (num_indices == 0) return bgfx::checkAvailTransientVertexBuffer(num_vertices, decl);
+		return bgfx::checkAvailTransientBuffers(num_vertices, decl, num_indices);
+	}
+
+
+	bool allocTransientBuffers(TransientClient client,
+		bgfx::TransientVertexBuffer* tvb,
+		int num_vertices,
+		const bgfx::VertexDecl& decl,
+		bgfx::TransientIndexBuffer* tib,
+		int num_indices) override
+	{
+		if (!checkAvailTransientBuffers(client, num_vertices, decl, num_indices)) return false;
+		bgfx::allocTransientVertexBuffer(tvb, num_vertices, decl);
+		if (num_indices > 0) bgfx::allocTransientIndexBuffer(tib, num_indices);
+		chargeTransient(client, u32(num_vertices) * decl.getStride() + u32(num_indices) * sizeof(u16));
+		return true;
+	}
+
+
+	const bgfx::InstanceDataBuffer* allocInstanceDataBuffer(TransientClient client, int count, int stride) override
+	{
+		u32 bytes = u32(count) * stride;
+		if (!checkTransientBudget(client, bytes)) return nullptr;
+		if (!bgfx::checkAvailInstanceDataBuffer(count, u16(stride))) return nullptr;
+		const bgfx::InstanceDataBuffer* buffer = bgfx::allocInstanceDataBuffer(count, u16(stride));
+		if (buffer) chargeTransient(client, bytes);
+		return buffer;
+	}
+
+
+	void setTransientBudget(TransientClient client, u32 bytes) override
+	{
+		m_transient_pools[(int)client].budget = bytes;
+	}
+
+
+	u32 getTransientHighWater(TransientClient client) const override
+	{
+		return m_transient_pools[(int)client].high_water;
+	}
+
+
+	void setFramePacing(float target_fps, int max_queued_frames) override
+	{
+		m_target_frame_time = target_fps > 0 ? 1 / target_fps : 0;
+		m_max_queued_frames = max_queued_frames;
+	}
+
+
+	float getGPUFrameTime() const override { return m_gpu_frame_time; }
+
+
+	DelegateList<void()>& beforeSubmit() override { return m_before_submit; }
+
+
+	// sleeps until the pacing deadline; coarse 1 ms sleeps, then a short spin
+	// so the submit lands on the deadline instead of up to a scheduler quantum
+	// past it
+	void paceFrame()
+	{
+		float interval = m_target_frame_time;
+		if (m_gpu_frame_time > interval) interval = m_gpu_frame_time;
+		// the queue model: each submitted frame grows the queue by one and the
+		// GPU retires elapsed/gpu_time of a frame in the same span; above the
+		// cap the interval is stretched so the queue drains back to it
+		if (m_queued_frames > (float)m_max_queued_frames) interval *= 1.05f;
+
+		float elapsed = m_frame_timer->getTimeSinceTick();
+		while (elapsed < interval - 0.002f)
+		{
+			MT::sleep(1);
+			elapsed = m_frame_timer->getTimeSinceTick();
+		}
+		while (elapsed < interval)
+		{
+			elapsed = m_frame_timer->getTimeSinceTick();
+		}
+	}
+
+
 	void frame(bool capture) override
 	{
 		PROFILE_FUNCTION();
-		bgfx::frame(capture);
+		m_before_submit.invoke();
+		if (m_target_frame_time > 0) paceFrame();
+		float frame_interval = m_frame_timer->tick();
+		m_frame_number = bgfx::frame(capture);
 		m_view_counter = 0;
+
+		const bgfx::Stats* stats = bgfx::getStats();
+		if (stats->gpuTimerFreq > 0)
+		{
+			float gpu_time = float(double(stats->gpuTimeEnd - stats->gpuTimeBegin) / double(stats->gpuTimerFreq));
+			m_gpu_frame_time += (gpu_time - m_gpu_frame_time) * 0.1f;
+		}
+		if (m_gpu_frame_time > 0)
+		{
+			m_queued_frames += 1 - frame_interval / m_gpu_frame_time;
+			m_queued_frames = Math::clamp(m_queued_frames, 0.0f, 3.0f);
+		}
+		// the render thread blocking on submit means the bgfx queue is full
+		if (stats->waitSubmit > 0 && stats->cpuTimerFreq > 0 &&
+			stats->waitSubmit > i64(stats->cpuTimerFreq / 1000))
+		{
+			m_queued_frames = 3;
+		}
+		PROFILE_INT("gpu_frame_us", int(m_gpu_frame_time * 1000000));
+
+		m_pass_stats.clear();
+		for (const PassStats& stats : m_frame_pass_stats)
+		{
+			m_pass_stats.push(stats);
+		}
+		m_frame_pass_stats.clear();
+
+		PROFILE_INT("transient_gui_KB", int(m_transient_pools[(int)TransientClient::GUI].used >> 10));
+		PROFILE_INT("transient_meshes_KB", int(m_transient_pools[(int)TransientClient::MESHES].used >> 10));
+		PROFILE_INT("transient_debug_KB", int(m_transient_pools[(int)TransientClient::DEBUG_DRAW].used >> 10));
+		PROFILE_INT("transient_particles_KB", int(m_transient_pools[(int)TransientClient::PARTICLES].used >> 10));
+		for (TransientPool& pool : m_transient_pools)
+		{
+			pool.used = 0;
+		}
 	}
 
 
@@ -773,7 +990,7 @@ struct RendererImpl LUMIX_FINAL : public Renderer
 
 
 	Engine& m_engine;
-	IAllocator& m_allocator;
+	BaseProxyAllocator m_allocator;
 	Array<ShaderCombinations::Pass> m_passes;
 	Array<ShaderDefine> m_shader_defines;
 	Array<Layer> m_layers;
@@ -785,6 +1002,22 @@ struct RendererImpl LUMIX_FINAL : public Renderer
 	ModelManager m_model_manager;
 	u32 m_current_pass_hash;
 	int m_view_counter;
+	u32 m_frame_number;
+	struct TransientPool
+	{
+		u32 budget;
+		u32 used;
+		u32 high_water;
+	};
+	TransientPool m_transient_pools[(int)TransientClient::COUNT];
+	Array<PassStats> m_pass_stats;
+	Array<PassStats> m_frame_pass_stats;
+	DelegateList<void()> m_before_submit;
+	Timer* m_frame_timer;
+	float m_target_frame_time;
+	int m_max_queued_frames;
+	float m_gpu_frame_time;
+	float m_queued_frames;
 	Shader* m_default_shader;
 	BGFXAllocator m_bgfx_allocator;
 	bgfx::VertexDecl m_basic_vertex_decl;
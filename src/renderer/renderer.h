@@ -6,6 +6,9 @@
 
 namespace bgfx
 {
+	struct InstanceDataBuffer;
+	struct TransientIndexBuffer;
+	struct TransientVertexBuffer;
 	struct UniformHandle;
 	struct VertexDecl;
 }
@@ -22,16 +25,58 @@ class ModelManager;
 class Path;
 class Shader;
 class TextureManager;
+template <typename T> class DelegateList;
 
 
-class LUMIX_RENDERER_API Renderer : public IPlugin 
+class LUMIX_RENDERER_API Renderer : public IPlugin
 {
+	public:
+		// per-frame submission statistics of one named pipeline pass; the
+		// bundled bgfx has no per-view GPU timer queries, so draw call,
+		// instance and triangle counts are the closest per-pass attribution
+		// available
+		struct PassStats
+		{
+			char name[32];
+			int draw_call_count;
+			int instance_count;
+			int triangle_count;
+		};
+
+		// transient geometry clients in fixed degradation order; when the
+		// per-frame bgfx transient pools run low, allocations are refused
+		// from the bottom of this list up, so a particle burst drops its own
+		// geometry instead of starving the gui
+		enum class TransientClient : int
+		{
+			GUI,
+			MESHES,
+			DEBUG_DRAW,
+			PARTICLES,
+
+			COUNT
+		};
+
 	public:
 		virtual ~Renderer() {}
 		virtual void frame(bool capture) = 0;
+		// paces frame submission to target_fps and keeps at most
+		// max_queued_frames in flight on the GPU, so a GPU-bound frame holds
+		// a steady latency instead of filling the bgfx queue; 0 disables
+		virtual void setFramePacing(float target_fps, int max_queued_frames) = 0;
+		// GPU time of the last presented frame in seconds, smoothed
+		virtual float getGPUFrameTime() const = 0;
+		// invoked right before the frame is handed to the render thread; bgfx
+		// applies view transforms at submit, so a listener can late-latch
+		// camera matrices here with the freshest input
+		virtual DelegateList<void()>& beforeSubmit() = 0;
 		virtual void resize(int width, int height) = 0;
 		virtual int getViewCounter() const = 0;
 		virtual void viewCounterAdd() = 0;
+		virtual u32 getFrameNumber() const = 0;
+		virtual void addPassStats(const char* pass_name, int draw_calls, int instances, int triangles) = 0;
+		virtual int getPassStatsCount() const = 0;
+		virtual const PassStats& getPassStats(int index) const = 0;
 		virtual void makeScreenshot(const Path& filename) = 0;
 		virtual int getPassIdx(const char* pass) = 0;
 		virtual const char* getPassName(int idx) = 0;
@@ -50,6 +95,24 @@ class LUMIX_RENDERER_API Renderer : public IPlugin
 		virtual int getLayersCount() const = 0;
 		virtual int getLayer(const char* name) = 0;
 		virtual const char* getLayerName(int idx) const = 0;
+		// transient allocations go through the renderer so the per-client
+		// budgets can be enforced; bgfx instance data is carved out of the
+		// same pool as transient vertices, hence the shared byte accounting
+		virtual bool checkAvailTransientBuffers(TransientClient client,
+			int num_vertices,
+			const bgfx::VertexDecl& decl,
+			int num_indices) = 0;
+		virtual bool allocTransientBuffers(TransientClient client,
+			bgfx::TransientVertexBuffer* tvb,
+			int num_vertices,
+			const bgfx::VertexDecl& decl,
+			bgfx::TransientIndexBuffer* tib,
+			int num_indices) = 0;
+		virtual const bgfx::InstanceDataBuffer* allocInstanceDataBuffer(TransientClient client,
+			int count,
+			int stride) = 0;
+		virtual void setTransientBudget(TransientClient client, u32 bytes) = 0;
+		virtual u32 getTransientHighWater(TransientClient client) const = 0;
 
 		virtual Engine& getEngine() = 0;
 }; 
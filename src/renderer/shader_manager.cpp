@@ -1,7 +1,12 @@
 #include "engine/lumix.h"
 #include "renderer/shader_manager.h"
 
+#include "engine/engine.h"
+#include "engine/fs/file_system.h"
+#include "engine/log.h"
+#include "engine/path.h"
 #include "engine/resource.h"
+#include "renderer/renderer.h"
 #include "renderer/shader.h"
 
 namespace Lumix
@@ -12,6 +17,7 @@ ShaderManager::ShaderManager(Renderer& renderer, IAllocator& allocator)
 	: ResourceManagerBase(allocator)
 	, m_allocator(allocator)
 	, m_renderer(renderer)
+	, m_prewarmed(allocator)
 {
 	m_buffer = nullptr;
 	m_buffer_size = -1;
@@ -36,6 +42,51 @@ void ShaderManager::destroyResource(Resource& resource)
 }
 
 
+void ShaderManager::prewarm(const Path& shader_path)
+{
+	m_prewarmed.push(load(shader_path));
+}
+
+
+void ShaderManager::prewarmFromManifest(const char* manifest_path)
+{
+	FS::FileSystem& fs = m_renderer.getEngine().getFileSystem();
+	FS::IFile* file = fs.open(fs.getDefaultDevice(), Path(manifest_path), FS::Mode::OPEN_AND_READ);
+	if (!file) return;
+
+	Array<char> content(m_allocator);
+	content.resize((int)file->size());
+	file->read(&content[0], content.size());
+	fs.close(*file);
+
+	char line[MAX_PATH_LENGTH];
+	int line_length = 0;
+	for (int i = 0; i <= content.size(); ++i)
+	{
+		char c = i < content.size() ? content[i] : '\n';
+		if (c != '\n' && c != '\r')
+		{
+			if (line_length < lengthOf(line) - 1) line[line_length++] = c;
+			continue;
+		}
+		line[line_length] = '\0';
+		if (line_length > 0 && line[0] != '#') prewarm(Path(line));
+		line_length = 0;
+	}
+	g_log_info.log("Renderer") << "Prewarmed " << m_prewarmed.size() << " shaders from " << manifest_path;
+}
+
+
+void ShaderManager::unloadPrewarmed()
+{
+	for (Resource* resource : m_prewarmed)
+	{
+		unload(*resource);
+	}
+	m_prewarmed.clear();
+}
+
+
 u8* ShaderManager::getBuffer(i32 size)
 {
 	if (m_buffer_size < size)
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "engine/array.h"
 #include "engine/resource_manager_base.h"
 
 namespace Lumix
 {
 
+	class Path;
 	class Renderer;
 
 	class LUMIX_RENDERER_API ShaderBinaryManager LUMIX_FINAL : public ResourceManagerBase
@@ -30,6 +32,15 @@ namespace Lumix
 		Renderer& getRenderer() { return m_renderer; }
 		u8* getBuffer(i32 size);
 
+		// loads a shader - and through it every compiled variant binary - ahead
+		// of first use and keeps a reference until unloadPrewarmed is called, so
+		// first sight of a material does not hitch in shipped builds
+		void prewarm(const Path& shader_path);
+		// reads an optional manifest listing one shader path per line and
+		// prewarms every entry
+		void prewarmFromManifest(const char* manifest_path);
+		void unloadPrewarmed();
+
 	protected:
 		Resource* createResource(const Path& path) override;
 		void destroyResource(Resource& resource) override;
@@ -39,5 +50,6 @@ namespace Lumix
 		u8* m_buffer;
 		i32 m_buffer_size;
 		Renderer& m_renderer;
+		Array<Resource*> m_prewarmed;
 	};
 }
\ No newline at end of file
@@ -1,11 +1,17 @@
 #include "terrain.h"
 #include "engine/blob.h"
 #include "engine/crc32.h"
+#include "engine/fs/file_system.h"
 #include "engine/geometry.h"
 #include "engine/json_serializer.h"
 #include "engine/lifo_allocator.h"
 #include "engine/log.h"
 #include "engine/math_utils.h"
+#include "engine/morton.h"
+#include "engine/mtjd/generic_job.h"
+#include "engine/mtjd/job.h"
+#include "engine/mtjd/manager.h"
+#include "engine/path_utils.h"
 #include "engine/profiler.h"
 #include "engine/property_register.h"
 #include "engine/resource_manager.h"
@@ -13,6 +19,7 @@
 #include "engine/engine.h"
 #include "renderer/material.h"
 #include "renderer/model.h"
+#include "renderer/renderer.h"
 #include "renderer/render_scene.h"
 #include "renderer/shader.h"
 #include "renderer/texture.h"
@@ -29,6 +36,11 @@ static const float GRASS_QUAD_SIZE = 10.0f;
 static const float GRASS_QUAD_RADIUS = GRASS_QUAD_SIZE * 0.7072f;
 static const int GRID_SIZE = 16;
 static const int COPY_COUNT = 50;
+static const int HEIGHT_STRIP_ROWS = 64;
+static const int HEIGHT_STRIP_COUNT = 16;
+// raw heightmaps above this size are paged through the strip cache instead of
+// being kept fully resident on the cpu side
+static const int HEIGHTMAP_STREAM_THRESHOLD = 32 * 1024 * 1024;
 static const ComponentType TERRAIN_HASH = PropertyRegister::getComponentType("terrain");
 static const u32 MORPH_CONST_HASH = crc32("morph_const");
 static const u32 QUAD_SIZE_HASH = crc32("quad_size");
@@ -187,6 +199,14 @@ Terrain::Terrain(Renderer& renderer, Entity entity, RenderScene& scene, IAllocat
 	, m_allocator(allocator)
 	, m_grass_quads(m_allocator)
 	, m_last_camera_position(m_allocator)
+	, m_pending_grass_quads(m_allocator)
+	, m_grass_job_group(true, m_allocator)
+	, m_infos_cache(m_allocator)
+	, m_infos_cache_counter(0)
+	, m_height_strips(m_allocator)
+	, m_height_strip_counter(0)
+	, m_height_strip_mutex(false)
+	, m_heightmap_streamed(false)
 	, m_grass_types(m_allocator)
 	, m_renderer(renderer)
 	, m_vertices_handle(BGFX_INVALID_HANDLE)
@@ -213,6 +233,12 @@ Terrain::~Terrain()
 	setMaterial(nullptr);
 	LUMIX_DELETE(m_allocator, m_mesh);
 	LUMIX_DELETE(m_allocator, m_root);
+	waitForGrassJobs();
+	for (PendingGrassQuad* pending : m_pending_grass_quads)
+	{
+		LUMIX_DELETE(m_allocator, pending->quad);
+		LUMIX_DELETE(m_allocator, pending);
+	}
 	for (int j = 0; j < m_grass_quads.size(); ++j)
 	{
 		Array<GrassQuad*>& quads = m_grass_quads.at(j);
@@ -280,8 +306,8 @@ Terrain::GrassType::RotationMode Terrain::getGrassTypeRotationMode(int index) co
 
 void Terrain::setGrassTypeRotationMode(int index, Terrain::GrassType::RotationMode mode)
 {
-	m_grass_types[index].m_rotation_mode = mode;;
 	forceGrassUpdate();
+	m_grass_types[index].m_rotation_mode = mode;
 }
 
 
@@ -353,9 +379,26 @@ void Terrain::setGrassTypePath(int index, const Path& path)
 }
 	
 
+// quads generated on workers may reference grass types or heightmap data the
+// caller is about to change, so in-flight jobs are finished and their results
+// dropped together with the cached quads
+void Terrain::waitForGrassJobs()
+{
+	if (m_pending_grass_quads.empty()) return;
+	m_grass_job_group.sync();
+}
+
+
 void Terrain::forceGrassUpdate()
 {
 	m_force_grass_update = true;
+	waitForGrassJobs();
+	for (PendingGrassQuad* pending : m_pending_grass_quads)
+	{
+		LUMIX_DELETE(m_allocator, pending->quad);
+		LUMIX_DELETE(m_allocator, pending);
+	}
+	m_pending_grass_quads.clear();
 	for (int i = 0; i < m_grass_quads.size(); ++i)
 	{
 		Array<GrassQuad*>& quads = m_grass_quads.at(i);
@@ -379,6 +422,27 @@ Array<Terrain::GrassQuad*>& Terrain::getQuads(ComponentHandle camera)
 }
 
 
+// generateGrassTypeQuad runs on mtjd workers and the global Math::randFloat
+// state is not reentrant, so every quad rolls its own deterministic sequence
+struct GrassRand
+{
+	explicit GrassRand(u32 seed)
+		: state(seed ? seed : 0x9e3779b9)
+	{
+	}
+
+	float operator()(float from, float to)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return from + (to - from) * (state * (1.0f / 0xffffFFFF));
+	}
+
+	u32 state;
+};
+
+
 void Terrain::generateGrassTypeQuad(GrassPatch& patch, const Matrix& terrain_matrix, const Vec2& quad_pos)
 {
 	ASSERT(quad_pos.x >= 0);
@@ -399,10 +463,15 @@ void Terrain::generateGrassTypeQuad(GrassPatch& patch, const Matrix& terrain_mat
 
 	struct { float x, y; void* type; } hashed_patch = { quad_pos.x, quad_pos.y, patch.m_type };
 	u32 hash = crc32(&hashed_patch, sizeof(hashed_patch));
-	Math::seedRandom(hash);
+	GrassRand rand_float(hash);
 	int max_idx = splat_map->width * splat_map->height;
 
-	Vec2 step = quad_size * (1 / (float)patch.m_type->m_density);
+	// the scene-wide multiplier lets a settings menu thin out grass globally
+	// without touching the authored per-type densities
+	int density = int(patch.m_type->m_density * m_scene.getGrassDensityMultiplier());
+	if (density < 1) return;
+
+	Vec2 step = quad_size * (1 / (float)density);
 	for (float dy = 0; dy < quad_size.y; dy += step.y)
 	{
 		for (float dx = 0; dx < quad_size.x; dx += step.x)
@@ -421,22 +490,22 @@ void Terrain::generateGrassTypeQuad(GrassPatch& patch, const Matrix& terrain_mat
 			if ((ground_mask & (1 << patch.m_type->m_idx)) == 0) continue;
 
 			Matrix tmp = Matrix::IDENTITY;
-			float x = (quad_pos.x + dx + step.x * Math::randFloat(-0.5f, 0.5f)) * m_scale.x;
-			float z = (quad_pos.y + dy + step.y * Math::randFloat(-0.5f, 0.5f)) * m_scale.z;
+			float x = (quad_pos.x + dx + step.x * rand_float(-0.5f, 0.5f)) * m_scale.x;
+			float z = (quad_pos.y + dy + step.y * rand_float(-0.5f, 0.5f)) * m_scale.z;
 			tmp.setTranslation(Vec3(x, getHeight(x, z), z));
 			
 			switch (patch.m_type->m_rotation_mode)
 			{
 				case GrassType::RotationMode::Y_UP:
 				{
-					Quat q(Vec3(0, 1, 0), Math::randFloat(0, Math::PI * 2));
+					Quat q(Vec3(0, 1, 0), rand_float(0, Math::PI * 2));
 					tmp = tmp * q.toMatrix();
 				}
 				break;
 				case GrassType::RotationMode::ALL_RANDOM:
 				{
-					Vec3 random_axis(Math::randFloat(-1, 1), Math::randFloat(-1, 1), Math::randFloat(-1, 1));
-					float random_angle = Math::randFloat(0, Math::PI * 2);
+					Vec3 random_axis(rand_float(-1, 1), rand_float(-1, 1), rand_float(-1, 1));
+					float random_angle = rand_float(0, Math::PI * 2);
 					Quat q(random_axis.normalized(), random_angle);
 					tmp = tmp * q.toMatrix();
 				}
@@ -444,7 +513,7 @@ void Terrain::generateGrassTypeQuad(GrassPatch& patch, const Matrix& terrain_mat
 				case GrassType::RotationMode::ALIGN_WITH_NORMAL:
 				{
 					Vec3 normal = getNormal(x, z);
-					Quat random_base(Vec3(0, 1, 0), Math::randFloat(0, Math::PI * 2));
+					Quat random_base(Vec3(0, 1, 0), rand_float(0, Math::PI * 2));
 					Quat to_normal = Quat::vec3ToVec3({0, 1, 0}, normal);
 					tmp = tmp * (to_normal * random_base).toMatrix();
 				}
@@ -453,7 +522,7 @@ void Terrain::generateGrassTypeQuad(GrassPatch& patch, const Matrix& terrain_mat
 			}
 
 			tmp = terrain_matrix * tmp;
-			tmp.multiply3x3(Math::randFloat(0.9f, 1.1f));
+			tmp.multiply3x3(rand_float(0.9f, 1.1f));
 			GrassPatch::InstanceData& instance_data = patch.instance_data.emplace();
 			instance_data.matrix = tmp;
 			instance_data.normal = Vec4(getNormal(x, z), 0);
@@ -467,6 +536,18 @@ void Terrain::updateGrass(ComponentHandle camera)
 	PROFILE_FUNCTION();
 	if (!m_splatmap) return;
 
+	// move quads the workers finished into the visible set; this is the only
+	// place quads enter m_grass_quads, so the render path never sees a quad
+	// that is still being filled
+	for (int i = m_pending_grass_quads.size() - 1; i >= 0; --i)
+	{
+		PendingGrassQuad* pending = m_pending_grass_quads[i];
+		if (!pending->ready) continue;
+		getQuads(pending->camera).push(pending->quad);
+		LUMIX_DELETE(m_allocator, pending);
+		m_pending_grass_quads.eraseFast(i);
+	}
+
 	Universe& universe = m_scene.getUniverse();
 	Entity camera_entity = m_scene.getCameraEntity(camera);
 	Vec3 camera_pos = universe.getPosition(camera_entity);
@@ -486,21 +567,19 @@ void Terrain::updateGrass(ComponentHandle camera)
 	{
 		grass_distance = Math::maximum(grass_distance, int(type.m_distance / GRASS_QUAD_RADIUS + 0.99f));
 	}
+	// one quad further than the grass can be seen, so a quad is usually ready
+	// by the time the camera gets close enough to render it
+	++grass_distance;
 
 	float from_quad_x = cx - grass_distance * GRASS_QUAD_SIZE;
 	float from_quad_z = cz - grass_distance * GRASS_QUAD_SIZE;
 	float to_quad_x = cx + grass_distance * GRASS_QUAD_SIZE;
 	float to_quad_z = cz + grass_distance * GRASS_QUAD_SIZE;
 
-	float old_bounds[4] = {FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX};
 	Array<GrassQuad*>& quads = getQuads(camera);
 	for (int i = quads.size() - 1; i >= 0; --i)
 	{
 		GrassQuad* quad = quads[i];
-		old_bounds[0] = Math::minimum(old_bounds[0], quad->pos.x);
-		old_bounds[1] = Math::maximum(old_bounds[1], quad->pos.x);
-		old_bounds[2] = Math::minimum(old_bounds[2], quad->pos.z);
-		old_bounds[3] = Math::maximum(old_bounds[3], quad->pos.z);
 		if (quad->pos.x < from_quad_x || quad->pos.x > to_quad_x || quad->pos.z < from_quad_z ||
 			quad->pos.z > to_quad_z)
 		{
@@ -512,20 +591,87 @@ void Terrain::updateGrass(ComponentHandle camera)
 	from_quad_x = Math::maximum(0.0f, from_quad_x);
 	from_quad_z = Math::maximum(0.0f, from_quad_z);
 
-	int old_quad_size = quads.size();
+	// quads in flight are not in the visible set yet, so both lists feed the
+	// occupancy grid; one cell lookup per candidate replaces a linear scan of
+	// every quad for every candidate
+	SpatialHashGrid<GrassQuad*> occupied(GRASS_QUAD_SIZE, m_allocator);
+	for (GrassQuad* quad : quads)
+	{
+		occupied.insert(Vec3(quad->pos.x, 0, quad->pos.z), quad);
+	}
+	for (const PendingGrassQuad* pending : m_pending_grass_quads)
+	{
+		if (pending->camera != camera) continue;
+		occupied.insert(Vec3(pending->quad->pos.x, 0, pending->quad->pos.z), pending->quad);
+	}
+
 	for (float quad_z = from_quad_z; quad_z <= to_quad_z; quad_z += GRASS_QUAD_SIZE)
 	{
 		for (float quad_x = from_quad_x; quad_x <= to_quad_x; quad_x += GRASS_QUAD_SIZE)
 		{
-			if (quad_x >= old_bounds[0] && quad_x <= old_bounds[1] && quad_z >= old_bounds[2] &&
-				quad_z <= old_bounds[3])
-				continue;
-
-			PROFILE_BLOCK("generate quad");
-			GrassQuad* quad = LUMIX_NEW(m_allocator, GrassQuad)(m_allocator);
-			quads.push(quad);
-			quad->pos.x = quad_x;
-			quad->pos.z = quad_z;
+			bool exists = false;
+			occupied.forEachInCell(Vec3(quad_x, 0, quad_z), [&](GrassQuad* quad) {
+				if (quad->pos.x == quad_x && quad->pos.z == quad_z) exists = true;
+			});
+			if (exists) continue;
+
+			scheduleGrassQuad(camera, terrain_mtx, quad_x, quad_z);
+		}
+	}
+
+	// keep this camera's instance memory under the scene budget by dropping
+	// the quads furthest from the camera; a dropped quad regenerates on demand
+	// if the camera comes back
+	int budget = m_scene.getGrassMemoryBudget();
+	if (budget <= 0) return;
+	int used = 0;
+	for (GrassQuad* quad : quads)
+	{
+		for (GrassPatch& patch : quad->m_patches)
+		{
+			used += patch.instance_data.size() * sizeof(GrassPatch::InstanceData);
+		}
+	}
+	while (used > budget && !quads.empty())
+	{
+		int furthest = 0;
+		float furthest_squared = -1;
+		for (int i = 0, c = quads.size(); i < c; ++i)
+		{
+			float dist_squared = (quads[i]->pos - local_camera_pos).squaredLength();
+			if (dist_squared > furthest_squared)
+			{
+				furthest_squared = dist_squared;
+				furthest = i;
+			}
+		}
+		GrassQuad* quad = quads[furthest];
+		for (GrassPatch& patch : quad->m_patches)
+		{
+			used -= patch.instance_data.size() * sizeof(GrassPatch::InstanceData);
+		}
+		LUMIX_DELETE(m_allocator, quad);
+		quads.eraseFast(furthest);
+	}
+}
+
+
+// fills the quad on an mtjd worker; sampling the heightmap and building the
+// instance matrices is the expensive part and used to spike the main thread
+// every time the camera crossed a quad boundary
+void Terrain::scheduleGrassQuad(ComponentHandle camera, const Matrix& terrain_matrix, float quad_x, float quad_z)
+{
+	PendingGrassQuad* pending = LUMIX_NEW(m_allocator, PendingGrassQuad);
+	pending->camera = camera;
+	pending->ready = false;
+	pending->quad = LUMIX_NEW(m_allocator, GrassQuad)(m_allocator);
+	pending->quad->pos.set(quad_x, 0, quad_z);
+	m_pending_grass_quads.push(pending);
+
+	MTJD::Manager& manager = m_scene.getEngine().getMTJDManager();
+	MTJD::Job* job = MTJD::makeJob(manager,
+		[this, pending, terrain_matrix]() {
+			GrassQuad* quad = pending->quad;
 			quad->m_patches.reserve(m_grass_types.size());
 
 			float min_y = FLT_MAX;
@@ -537,7 +683,7 @@ void Terrain::updateGrass(ComponentHandle camera)
 				GrassPatch& patch = quad->m_patches.emplace(m_allocator);
 				patch.m_type = &grass_type;
 
-				generateGrassTypeQuad(patch, terrain_mtx, {quad_x / m_scale.x, quad_z / m_scale.z});
+				generateGrassTypeQuad(patch, terrain_matrix, {quad->pos.x / m_scale.x, quad->pos.z / m_scale.z});
 				for (auto instance_data : patch.instance_data)
 				{
 					min_y = Math::minimum(instance_data.matrix.getTranslation().y, min_y);
@@ -547,9 +693,11 @@ void Terrain::updateGrass(ComponentHandle camera)
 
 			quad->pos.y = (max_y + min_y) * 0.5f;
 			quad->radius = Math::maximum((max_y - min_y) * 0.5f, GRASS_QUAD_SIZE) * Math::SQRT2;
-
-		}
-	}
+			pending->ready = true;
+		},
+		manager.getJobAllocator());
+	job->addDependency(&m_grass_job_group);
+	manager.schedule(job);
 }
 
 
@@ -569,13 +717,27 @@ void Terrain::getGrassInfos(const Frustum& frustum, Array<GrassInfo>& infos, Com
 	Universe& universe = m_scene.getUniverse();
 	Matrix mtx = universe.getMatrix(m_entity);
 	Vec3 frustum_position = frustum.position;
+	if (quads.empty()) return;
+
+	// one batch sphere test for all quads; the scattered per-patch work below
+	// only runs for the visible ones
+	Array<Sphere> spheres(m_allocator);
+	spheres.reserve(quads.size());
 	for (auto* quad : quads)
 	{
 		Vec3 quad_center(quad->pos.x + GRASS_QUAD_SIZE * 0.5f, quad->pos.y, quad->pos.z + GRASS_QUAD_SIZE * 0.5f);
-		quad_center = mtx.transform(quad_center);
-		if (frustum.isSphereInside(quad_center, quad->radius))
+		spheres.push(Sphere(mtx.transform(quad_center), quad->radius));
+	}
+	Array<u8> visible(m_allocator);
+	visible.resize(quads.size());
+	frustumIntersectSpheres(frustum, &spheres[0], &visible[0], spheres.size());
+
+	for (int quad_idx = 0; quad_idx < quads.size(); ++quad_idx)
+	{
+		GrassQuad* quad = quads[quad_idx];
+		if (visible[quad_idx])
 		{
-			float dist2 = (quad_center - frustum_position).squaredLength();
+			float dist2 = (spheres[quad_idx].position - frustum_position).squaredLength();
 			for (int patch_idx = 0; patch_idx < quad->m_patches.size(); ++patch_idx)
 			{
 				const GrassPatch& patch = quad->m_patches[patch_idx];
@@ -682,7 +844,33 @@ void Terrain::getInfos(Array<TerrainInfo>& infos, const Vec3& camera_pos)
 	Vec3 local_camera_pos = inv_matrix.transform(camera_pos);
 	local_camera_pos.x /= m_scale.x;
 	local_camera_pos.z /= m_scale.z;
-	m_root->getInfos(infos, local_camera_pos, this, matrix);
+
+	// a few slots so the game camera and the shadowmap passes each keep their
+	// own cached patch list instead of evicting one another every frame
+	static const int INFOS_CACHE_SIZE = 4;
+	CachedInfos* slot = nullptr;
+	for (CachedInfos& cached : m_infos_cache)
+	{
+		if (compareMemory(&cached.camera_pos, &local_camera_pos, sizeof(local_camera_pos)) == 0 &&
+			compareMemory(&cached.matrix, &matrix, sizeof(matrix)) == 0)
+		{
+			cached.last_use = ++m_infos_cache_counter;
+			for (const TerrainInfo& info : cached.infos) infos.push(info);
+			return;
+		}
+		if (!slot || cached.last_use < slot->last_use) slot = &cached;
+	}
+	if (m_infos_cache.size() < INFOS_CACHE_SIZE)
+	{
+		slot = &m_infos_cache.emplace(m_allocator);
+	}
+
+	slot->infos.clear();
+	m_root->getInfos(slot->infos, local_camera_pos, this, matrix);
+	slot->camera_pos = local_camera_pos;
+	slot->matrix = matrix;
+	slot->last_use = ++m_infos_cache_counter;
+	for (const TerrainInfo& info : slot->infos) infos.push(info);
 }
 
 
@@ -746,16 +934,98 @@ float Terrain::getHeight(int x, int z) const
 	Texture* t = m_heightmap;
 	ASSERT(t->bytes_per_pixel == 2);
 	int idx = Math::clamp(x, 0, m_width) + Math::clamp(z, 0, m_height) * m_width;
+	if (m_heightmap_streamed) return m_scale.y * DIV64K * getStreamedHeightSample(idx);
+	if (!t->getData()) return 0; // reload after leaving streamed mode is still in flight
 	return m_scale.y * DIV64K * ((u16*)t->getData())[idx];
 }
 
 
+u16 Terrain::getStreamedHeightSample(int idx) const
+{
+	int strip_idx = idx / m_width / HEIGHT_STRIP_ROWS;
+
+	MT::SpinLock lock(m_height_strip_mutex);
+	++m_height_strip_counter;
+	HeightStrip* strip = nullptr;
+	for (HeightStrip& i : m_height_strips)
+	{
+		if (i.index == strip_idx)
+		{
+			i.last_use = m_height_strip_counter;
+			strip = &i;
+			break;
+		}
+	}
+	if (!strip)
+	{
+		strip = loadHeightStrip(strip_idx);
+		if (!strip) return 0;
+	}
+	int offset = idx - strip_idx * HEIGHT_STRIP_ROWS * m_width;
+	return strip->data[Math::minimum(offset, strip->data.size() - 1)];
+}
+
+
+// called with the strip mutex held; a miss costs one seek and one read since
+// strips are contiguous ranges of the raw file
+Terrain::HeightStrip* Terrain::loadHeightStrip(int strip_idx) const
+{
+	if (m_height_strips.empty())
+	{
+		for (int i = 0; i < HEIGHT_STRIP_COUNT; ++i)
+		{
+			m_height_strips.emplace(m_allocator);
+		}
+	}
+	HeightStrip* strip = &m_height_strips[0];
+	for (HeightStrip& i : m_height_strips)
+	{
+		if (i.index == -1)
+		{
+			strip = &i;
+			break;
+		}
+		if (i.last_use < strip->last_use) strip = &i;
+	}
+
+	int row_start = strip_idx * HEIGHT_STRIP_ROWS;
+	int row_count = Math::minimum(HEIGHT_STRIP_ROWS, m_height - row_start);
+	if (row_count <= 0) return nullptr;
+
+	FS::FileSystem& fs = m_scene.getEngine().getFileSystem();
+	FS::IFile* file = fs.open(fs.getDefaultDevice(), m_heightmap->getPath(), FS::Mode::OPEN_AND_READ);
+	if (!file)
+	{
+		g_log_error.log("Renderer") << "Could not stream heightmap " << m_heightmap->getPath();
+		return nullptr;
+	}
+	strip->data.resize(row_count * m_width);
+	file->seek(FS::SeekMode::BEGIN, row_start * m_width * sizeof(u16));
+	file->read(&strip->data[0], strip->data.size() * sizeof(u16));
+	fs.close(*file);
+	strip->index = strip_idx;
+	strip->last_use = m_height_strip_counter;
+	return strip;
+}
+
+
 void Terrain::setHeight(int x, int z, float h)
 {
 	const float DIV64K = 1.0f / 65535.0f;
 	const float DIV255 = 1.0f / 255.0f;
 	if (!m_heightmap) return;
 
+	if (m_heightmap_streamed)
+	{
+		// painting needs the whole map in memory anyway (it has to be saved
+		// back as one file), so editing drops the terrain to full residency;
+		// the reload repopulates the data and rebuilds the gpu texture
+		m_heightmap_streamed = false;
+		for (HeightStrip& strip : m_height_strips) strip.index = -1;
+		m_heightmap->addDataReference();
+		return;
+	}
+
 	Texture* t = m_heightmap;
 	ASSERT(t->bytes_per_pixel == 2);
 	int idx = Math::clamp(x, 0, m_width) + Math::clamp(z, 0, m_height) * m_width;
@@ -931,6 +1201,7 @@ void Terrain::generateGeometry()
 	m_indices_handle = bgfx::createIndexBuffer(indices_mem);
 	m_mesh = LUMIX_NEW(m_allocator, Mesh)(
 		m_material, 0, int(points.size() * sizeof(points[0])), 0, int(indices.size()), "terrain", m_allocator);
+	m_infos_cache.clear();
 }
 
 TerrainQuad* Terrain::generateQuadTree(float size)
@@ -948,14 +1219,37 @@ void Terrain::onMaterialLoaded(Resource::State, Resource::State new_state, Resou
 	PROFILE_FUNCTION();
 	if (new_state == Resource::State::READY)
 	{
+		// cached infos hold the old material's shader
+		m_infos_cache.clear();
 		m_detail_texture = m_material->getTextureByUniform(TEX_COLOR_UNIFORM);
 
+		// a layered detail texture (dds array) switches the shader to the
+		// splat-indexed array path; plain 2d detail textures keep the legacy
+		// single-layer sampling
+		u8 tex_array_define = m_renderer.getShaderDefineIdx("TEXTURE_ARRAY");
+		m_material->setDefine(tex_array_define, m_detail_texture && m_detail_texture->layers > 1);
+
 		m_heightmap = m_material->getTextureByUniform("u_texHeightmap");
 		bool is_data_ready = true;
+		m_heightmap_streamed = false;
 		if (m_heightmap && m_heightmap->getData() == nullptr)
 		{
-			m_heightmap->addDataReference();
-			is_data_ready = false;
+			char ext[10];
+			PathUtils::getExtension(ext, lengthOf(ext), m_heightmap->getPath().c_str());
+			int heightmap_size = m_heightmap->width * m_heightmap->height * m_heightmap->bytes_per_pixel;
+			if (equalStrings(ext, "raw") && heightmap_size > HEIGHTMAP_STREAM_THRESHOLD)
+			{
+				// raw files are plain row-major u16, so cpu height queries can
+				// page strips straight from disk instead of pinning the whole
+				// copy; the gpu texture is untouched
+				m_heightmap_streamed = true;
+				for (HeightStrip& strip : m_height_strips) strip.index = -1;
+			}
+			else
+			{
+				m_heightmap->addDataReference();
+				is_data_ready = false;
+			}
 		}
 		m_splatmap = m_material->getTextureByUniform("u_texSplatmap");
 		if (m_splatmap && m_splatmap->getData() == nullptr)
@@ -4,6 +4,8 @@
 #include "engine/array.h"
 #include "engine/associative_array.h"
 #include "engine/matrix.h"
+#include "engine/mt/sync.h"
+#include "engine/mtjd/group.h"
 #include "engine/resource.h"
 #include "engine/vec.h"
 #include <bgfx/bgfx.h>
@@ -81,6 +83,48 @@ class Terrain
 			float radius;
 		};
 
+		// a quad being filled on an mtjd worker; the worker owns the quad
+		// until it sets ready, then the main thread moves the quad into
+		// m_grass_quads during the next updateGrass
+		struct PendingGrassQuad
+		{
+			ComponentHandle camera;
+			GrassQuad* quad;
+			volatile bool ready;
+		};
+
+		// one cached result of the quadtree walk in getInfos, keyed by the
+		// local camera position and the terrain's world matrix; a camera that
+		// has not moved re-renders the terrain without re-evaluating the tree
+		struct CachedInfos
+		{
+			explicit CachedInfos(IAllocator& allocator)
+				: infos(allocator)
+				, last_use(0)
+			{}
+
+			Array<TerrainInfo> infos;
+			Vec3 camera_pos;
+			Matrix matrix;
+			u32 last_use;
+		};
+
+		// one slot of the lru cache that pages contiguous row strips out of
+		// the heightmap's raw file, so cpu height queries on big maps do not
+		// need the whole copy resident
+		struct HeightStrip
+		{
+			explicit HeightStrip(IAllocator& allocator)
+				: data(allocator)
+				, index(-1)
+				, last_use(0)
+			{}
+
+			Array<u16> data;
+			int index;
+			u32 last_use;
+		};
+
 	public:
 		Terrain(Renderer& renderer, Entity entity, RenderScene& scene, IAllocator& allocator);
 		~Terrain();
@@ -111,8 +155,8 @@ class Terrain
 
 		float getHeight(int x, int z) const;
 		void setHeight(int x, int z, float height);
-		void setXZScale(float scale) { m_scale.x = scale; m_scale.z = scale; }
-		void setYScale(float scale) { m_scale.y = scale; }
+		void setXZScale(float scale) { m_scale.x = scale; m_scale.z = scale; m_infos_cache.clear(); }
+		void setYScale(float scale) { m_scale.y = scale; m_infos_cache.clear(); }
 		void setGrassTypePath(int index, const Path& path);
 		void setGrassTypeDensity(int index, int density);
 		void setGrassTypeDistance(int index, float value);
@@ -130,10 +174,14 @@ class Terrain
 		void removeGrassType(int index);
 		void forceGrassUpdate();
 
-	private: 
+	private:
 		Array<Terrain::GrassQuad*>& getQuads(ComponentHandle camera);
 		TerrainQuad* generateQuadTree(float size);
 		void updateGrass(ComponentHandle camera);
+		void scheduleGrassQuad(ComponentHandle camera, const Matrix& terrain_matrix, float quad_x, float quad_z);
+		void waitForGrassJobs();
+		u16 getStreamedHeightSample(int idx) const;
+		HeightStrip* loadHeightStrip(int strip_idx) const;
 		void generateGrassTypeQuad(GrassPatch& patch, const Matrix& terrain_matrix, const Vec2& quad_pos_hm_space);
 		void generateGeometry();
 		void onMaterialLoaded(Resource::State, Resource::State new_state, Resource&);
@@ -158,6 +206,16 @@ class Terrain
 		Array<GrassType> m_grass_types;
 		AssociativeArray<ComponentHandle, Array<GrassQuad*> > m_grass_quads;
 		AssociativeArray<ComponentHandle, Vec3> m_last_camera_position;
+		Array<PendingGrassQuad*> m_pending_grass_quads;
+		MTJD::Group m_grass_job_group;
+		Array<CachedInfos> m_infos_cache;
+		u32 m_infos_cache_counter;
+		// mutable because the cache is filled from const height queries, which
+		// also run on grass workers - hence the lock
+		mutable Array<HeightStrip> m_height_strips;
+		mutable u32 m_height_strip_counter;
+		mutable MT::SpinMutex m_height_strip_mutex;
+		bool m_heightmap_streamed;
 		bool m_force_grass_update;
 		Renderer& m_renderer;
 };
@@ -46,6 +46,7 @@ Texture::Texture(const Path& path, ResourceManagerBase& resource_manager, IAlloc
 	, layers(1)
 {
 	bgfx_flags = 0;
+	gpu_size = 0;
 	is_cubemap = false;
 	handle = BGFX_INVALID_HANDLE;
 }
@@ -99,8 +100,13 @@ bool Texture::create(int w, int h, void* data)
 	mips = 1;
 	width = w;
 	height = h;
+	gpu_size = w * h * 4;
 
 	bool isReady = bgfx::isValid(handle);
+	if (isReady)
+	{
+		Profiler::trackGPUAlloc(Profiler::GPUCategory::TEXTURE, getPath().c_str(), gpu_size);
+	}
 	onCreated(isReady ? State::READY : State::FAILURE);
 
 	return isReady;
@@ -372,6 +378,7 @@ bool loadRaw(Texture& texture, FS::IFile& file)
 	texture.layers = 1;
 	texture.mips = 1;
 	texture.is_cubemap = false;
+	texture.gpu_size = texture.width * texture.height * sizeof(float);
 	return bgfx::isValid(texture.handle);
 }
 
@@ -487,6 +494,7 @@ static bool loadTGA(Texture& texture, FS::IFile& file)
 		bgfx::copy(image_dest, header.width * header.height * 4));
 	texture.depth = 1;
 	texture.layers = 1;
+	texture.gpu_size = header.width * header.height * 4;
 	return bgfx::isValid(texture.handle);
 }
 
@@ -515,13 +523,17 @@ static bool loadDDSorKTX(Texture& texture, FS::IFile& file)
 {
 	bgfx::TextureInfo info;
 	const auto* mem = bgfx::copy(file.getBuffer(), (u32)file.size());
-	texture.handle = bgfx::createTexture(mem, texture.bgfx_flags, 0, &info);
+	TextureManager& manager = static_cast<TextureManager&>(texture.getResourceManager());
+	// bgfx clamps the skip so at least the smallest mip survives
+	u8 mip_skip = (u8)manager.getMipSkip();
+	texture.handle = bgfx::createTexture(mem, texture.bgfx_flags, mip_skip, &info);
 	texture.width = info.width;
 	texture.mips = info.numMips;
 	texture.height = info.height;
 	texture.depth = info.depth;
 	texture.layers = info.numLayers;
 	texture.is_cubemap = info.cubeMap;
+	texture.gpu_size = info.storageSize;
 	return bgfx::isValid(texture.handle);
 }
 
@@ -544,6 +556,15 @@ bool Texture::load(FS::IFile& file)
 	else
 	{
 		loaded = loadTGA(*this, file);
+		if (loaded)
+		{
+			// decoded on the loading thread and kept uncompressed on the GPU,
+			// costing ~4x the VRAM and bandwidth of a BC-compressed dds
+			g_log_warning.log("Renderer") << "Uncompressed texture " << path << " ("
+				<< ((width * height * bytes_per_pixel) >> 10)
+				<< "KB), reimport it as dds";
+			PROFILE_INT("uncompressed_texture_KB", (width * height * bytes_per_pixel) >> 10);
+		}
 	}
 	if (!loaded)
 	{
@@ -551,6 +572,7 @@ bool Texture::load(FS::IFile& file)
 		return false;
 	}
 
+	Profiler::trackGPUAlloc(Profiler::GPUCategory::TEXTURE, path, gpu_size);
 	m_size = file.size();
 	return true;
 }
@@ -560,6 +582,7 @@ void Texture::unload(void)
 {
 	if (bgfx::isValid(handle))
 	{
+		Profiler::untrackGPUAlloc(Profiler::GPUCategory::TEXTURE, getPath().c_str());
 		bgfx::destroyTexture(handle);
 		handle = BGFX_INVALID_HANDLE;
 	}
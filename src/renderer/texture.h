@@ -51,6 +51,8 @@ class LUMIX_RENDERER_API Texture LUMIX_FINAL : public Resource
 		int mips;
 		bool is_cubemap;
 		u32 bgfx_flags;
+		// bytes the texture occupies on the GPU, fed to the Profiler ledger
+		u32 gpu_size;
 		bgfx::TextureHandle handle;
 		IAllocator& allocator;
 		int data_reference;
@@ -1,7 +1,10 @@
 #include "engine/lumix.h"
 #include "renderer/texture_manager.h"
 
+#include "engine/array.h"
+#include "engine/path_utils.h"
 #include "engine/resource.h"
+#include "engine/string.h"
 #include "renderer/texture.h"
 
 namespace Lumix
@@ -12,6 +15,25 @@ namespace Lumix
 	{
 		m_buffer = nullptr;
 		m_buffer_size = -1;
+		m_mip_skip = 0;
+	}
+
+
+	void TextureManager::setMipSkip(int mip_skip)
+	{
+		if (mip_skip == m_mip_skip) return;
+		m_mip_skip = mip_skip;
+
+		Array<Resource*> to_reload(m_allocator);
+		for (auto* resource : getResourceTable())
+		{
+			if (resource->isEmpty()) continue;
+
+			char ext[4];
+			PathUtils::getExtension(ext, lengthOf(ext), resource->getPath().c_str());
+			if (equalStrings(ext, "dds") || equalStrings(ext, "ktx")) to_reload.push(resource);
+		}
+		for (auto* resource : to_reload) reload(*resource);
 	}
 
 
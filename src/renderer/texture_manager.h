@@ -12,6 +12,12 @@ namespace Lumix
 
 		u8* getBuffer(i32 size);
 
+		// every DDS/KTX texture drops its top mip_skip mips on load; each
+		// skipped mip cuts that texture's IO and VRAM cost to a quarter, so
+		// min-spec configs can trade resolution for fitting the memory budget
+		void setMipSkip(int mip_skip);
+		int getMipSkip() const { return m_mip_skip; }
+
 	protected:
 		Resource* createResource(const Path& path) override;
 		void destroyResource(Resource& resource) override;
@@ -20,5 +26,6 @@ namespace Lumix
 		IAllocator& m_allocator;
 		u8* m_buffer;
 		i32 m_buffer_size;
+		int m_mip_skip;
 	};
 }
\ No newline at end of file
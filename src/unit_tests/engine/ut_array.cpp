@@ -83,5 +83,45 @@ void UT_array_erase(const char* params)
 	LUMIX_EXPECT(array1.size() == 15);
 }
 
+void UT_inline_array(const char* params)
+{
+	Lumix::DefaultAllocator allocator;
+	Lumix::InlineArray<int, 8> array1(allocator);
+
+	LUMIX_EXPECT(array1.empty());
+	LUMIX_EXPECT(array1.capacity() == 8);
+
+	for (int i = 0; i < 8; ++i)
+	{
+		array1.push(i);
+	}
+	LUMIX_EXPECT(array1.size() == 8);
+	LUMIX_EXPECT(array1.capacity() == 8);
+
+	for (int i = 8; i < 100; ++i)
+	{
+		array1.push(i);
+	}
+	LUMIX_EXPECT(array1.size() == 100);
+	for (int i = 0; i < 100; ++i)
+	{
+		LUMIX_EXPECT(array1[i] == i);
+	}
+
+	array1.eraseFast(0);
+	LUMIX_EXPECT(array1.size() == 99);
+	array1.erase(0);
+	LUMIX_EXPECT(array1.size() == 98);
+	array1.pop();
+	LUMIX_EXPECT(array1.size() == 97);
+
+	array1.clear();
+	LUMIX_EXPECT(array1.empty());
+
+	array1.resize(4);
+	LUMIX_EXPECT(array1.size() == 4);
+}
+
 REGISTER_TEST("unit_tests/engine/array", UT_array, "")
 REGISTER_TEST("unit_tests/engine/array/erase", UT_array_erase, "")
+REGISTER_TEST("unit_tests/engine/array/inline_array", UT_inline_array, "")
@@ -0,0 +1,134 @@
+#include "unit_tests/suite/lumix_unit_tests.h"
+#include "unit_tests/suite/benchmark.h"
+#include "engine/array.h"
+#include "engine/blob.h"
+#include "engine/crc32.h"
+#include "engine/fs/file_system.h"
+#include "engine/fs/memory_file_device.h"
+#include "engine/hash_map.h"
+#include "engine/json_serializer.h"
+#include "engine/path.h"
+
+
+namespace
+{
+
+
+void UT_benchmark_array(const char* params)
+{
+	Lumix::DefaultAllocator allocator;
+
+	Lumix::Array<int> array(allocator);
+	array.reserve(10000);
+	Lumix::UnitTest::benchmark("engine/array/push", 10000, [&](int i) {
+		if (array.size() == 10000) array.clear();
+		array.push(i);
+	});
+
+	array.clear();
+	for (int i = 0; i < 10000; ++i) array.push(i);
+	volatile int sum = 0;
+	Lumix::UnitTest::benchmark("engine/array/iterate", 1000, [&](int) {
+		int tmp = 0;
+		for (int value : array) tmp += value;
+		sum += tmp;
+	});
+}
+
+
+void UT_benchmark_hash_map(const char* params)
+{
+	Lumix::DefaultAllocator allocator;
+
+	Lumix::HashMap<Lumix::u32, int> map(allocator);
+	Lumix::UnitTest::benchmark("engine/hash_map/insert", 10000, [&](int i) {
+		if (map.size() == 10000) map.clear();
+		map.insert(Lumix::u32(i), i);
+	});
+
+	map.clear();
+	for (int i = 0; i < 10000; ++i) map.insert(Lumix::u32(i), i);
+	volatile int sum = 0;
+	Lumix::UnitTest::benchmark("engine/hash_map/lookup", 10000, [&](int i) {
+		sum += map[Lumix::u32(i % 10000)];
+	});
+}
+
+
+void UT_benchmark_crc32(const char* params)
+{
+	Lumix::DefaultAllocator allocator;
+
+	Lumix::Array<Lumix::u8> data(allocator);
+	data.resize(64 * 1024);
+	for (int i = 0; i < data.size(); ++i) data[i] = Lumix::u8(i);
+
+	volatile Lumix::u32 hash = 0;
+	Lumix::UnitTest::benchmark("engine/crc32/64KB", 100, [&](int) {
+		hash = Lumix::crc32(&data[0], data.size());
+	});
+}
+
+
+void UT_benchmark_blob(const char* params)
+{
+	Lumix::DefaultAllocator allocator;
+
+	Lumix::OutputBlob blob(allocator);
+	blob.reserve(10000 * (sizeof(int) + sizeof(float)));
+	Lumix::UnitTest::benchmark("engine/blob/write", 10000, [&](int i) {
+		if (i == 0) blob.clear();
+		blob.write(i);
+		blob.write(float(i));
+	});
+
+	Lumix::UnitTest::benchmark("engine/blob/read", 10000, [&](int i) {
+		static Lumix::InputBlob input(nullptr, 0);
+		if (i == 0) input = Lumix::InputBlob(blob);
+		int int_value;
+		float float_value;
+		input.read(int_value);
+		input.read(float_value);
+	});
+}
+
+
+void UT_benchmark_json(const char* params)
+{
+	Lumix::DefaultAllocator allocator;
+	Lumix::PathManager path_manager(allocator);
+
+	Lumix::FS::MemoryFileDevice device(allocator);
+	Lumix::FS::IFile* file = device.createFile(nullptr);
+	{
+		Lumix::JsonSerializer serializer(*file, Lumix::JsonSerializer::WRITE, Lumix::Path(""), allocator);
+		serializer.beginObject();
+		serializer.beginArray("values");
+		for (int i = 0; i < 1000; ++i) serializer.serializeArrayItem(i);
+		serializer.endArray();
+		serializer.endObject();
+	}
+
+	Lumix::UnitTest::benchmark("engine/json/parse_1000_ints", 10, [&](int) {
+		file->seek(Lumix::FS::SeekMode::BEGIN, 0);
+		Lumix::JsonSerializer serializer(*file, Lumix::JsonSerializer::READ, Lumix::Path(""), allocator);
+		serializer.deserializeObjectBegin();
+		serializer.deserializeArrayBegin("values");
+		int value;
+		while (!serializer.isArrayEnd()) serializer.deserializeArrayItem(value, 0);
+		serializer.deserializeArrayEnd();
+		serializer.deserializeObjectEnd();
+	});
+
+	device.destroyFile(file);
+}
+
+
+} // anonymous namespace
+
+
+REGISTER_TEST("benchmarks/engine/array", UT_benchmark_array, "")
+REGISTER_TEST("benchmarks/engine/hash_map", UT_benchmark_hash_map, "")
+REGISTER_TEST("benchmarks/engine/crc32", UT_benchmark_crc32, "")
+REGISTER_TEST("benchmarks/engine/blob", UT_benchmark_blob, "")
+REGISTER_TEST("benchmarks/engine/json", UT_benchmark_json, "")
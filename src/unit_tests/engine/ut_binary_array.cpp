@@ -58,6 +58,34 @@ void UT_binary_array(const char* params)
 		LUMIX_EXPECT(array2.getRaw()[0] == 0xffffFFFF);
 		LUMIX_EXPECT(array2.getRaw()[1] == 0xffffFFFF);
 	}
+
+	Lumix::BinaryArray track(allocator);
+	for (int i = 0; i < 100; ++i)
+	{
+		track.push(i == 3 || i == 31 || i == 32 || i == 77);
+	}
+	LUMIX_EXPECT(track.countSet() == 4);
+	LUMIX_EXPECT(track.nextSet(0) == 3);
+	LUMIX_EXPECT(track.nextSet(4) == 31);
+	LUMIX_EXPECT(track.nextSet(32) == 32);
+	LUMIX_EXPECT(track.nextSet(33) == 77);
+	LUMIX_EXPECT(track.nextSet(78) == -1);
+
+	track.fill(true);
+	LUMIX_EXPECT(track.countSet() == 100);
+	track.fill(false);
+	LUMIX_EXPECT(track.countSet() == 0);
+	LUMIX_EXPECT(track.nextSet(0) == -1);
+
+	// stale bits past the end must not leak into the counts
+	track.fill(true);
+	for (int i = 0; i < 90; ++i)
+	{
+		track.pop();
+	}
+	LUMIX_EXPECT(track.countSet() == 10);
+	LUMIX_EXPECT(track.nextSet(9) == 9);
+	LUMIX_EXPECT(track.nextSet(10) == -1);
 }
 
 REGISTER_TEST("unit_tests/engine/binary_array", UT_binary_array, "")
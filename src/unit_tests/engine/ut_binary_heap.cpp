@@ -0,0 +1,82 @@
+#include "unit_tests/suite/lumix_unit_tests.h"
+#include "engine/binary_heap.h"
+
+
+void UT_binary_heap(const char* params)
+{
+	Lumix::DefaultAllocator allocator;
+	Lumix::BinaryHeap<int, int> heap(allocator);
+
+	LUMIX_EXPECT(heap.empty());
+
+	int keys[] = { 7, 3, 9, 1, 5, 8, 2, 6, 4, 0 };
+	for (int key : keys)
+	{
+		heap.insert(key, key * 10);
+	}
+	LUMIX_EXPECT(heap.size() == 10);
+
+	for (int i = 0; i < 10; ++i)
+	{
+		LUMIX_EXPECT(heap.topKey() == i);
+		LUMIX_EXPECT(heap.top() == i * 10);
+		heap.pop();
+	}
+	LUMIX_EXPECT(heap.empty());
+}
+
+
+void UT_binary_heap_decrease_key(const char* params)
+{
+	Lumix::DefaultAllocator allocator;
+	Lumix::BinaryHeap<int, int> heap(allocator);
+
+	for (int i = 0; i < 10; ++i)
+	{
+		heap.insert(i + 10, i);
+	}
+	LUMIX_EXPECT(heap.top() == 0);
+	LUMIX_EXPECT(heap.contains(7));
+	LUMIX_EXPECT(!heap.contains(100));
+
+	LUMIX_EXPECT(heap.decreaseKey(7, 1));
+	LUMIX_EXPECT(heap.top() == 7);
+	LUMIX_EXPECT(heap.topKey() == 1);
+
+	LUMIX_EXPECT(!heap.decreaseKey(100, 0));
+
+	// increasing the key is a no-op
+	LUMIX_EXPECT(heap.decreaseKey(7, 50));
+	LUMIX_EXPECT(heap.top() == 7);
+}
+
+
+void UT_binary_heap_remove(const char* params)
+{
+	Lumix::DefaultAllocator allocator;
+	Lumix::BinaryHeap<int, int> heap(allocator);
+
+	for (int i = 0; i < 10; ++i)
+	{
+		heap.insert(i, i);
+	}
+
+	LUMIX_EXPECT(heap.remove(0));
+	LUMIX_EXPECT(heap.remove(5));
+	LUMIX_EXPECT(heap.remove(9));
+	LUMIX_EXPECT(!heap.remove(9));
+	LUMIX_EXPECT(heap.size() == 7);
+
+	int expected[] = { 1, 2, 3, 4, 6, 7, 8 };
+	for (int value : expected)
+	{
+		LUMIX_EXPECT(heap.top() == value);
+		heap.pop();
+	}
+	LUMIX_EXPECT(heap.empty());
+}
+
+
+REGISTER_TEST("unit_tests/engine/binary_heap", UT_binary_heap, "")
+REGISTER_TEST("unit_tests/engine/binary_heap/decrease_key", UT_binary_heap_decrease_key, "")
+REGISTER_TEST("unit_tests/engine/binary_heap/remove", UT_binary_heap_remove, "")
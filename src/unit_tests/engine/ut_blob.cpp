@@ -49,6 +49,8 @@ void UT_blob(const char* params)
 	s.c = 'Q';
 	blob.write(s);
 
+	blob.writeString("view string");
+
 	Lumix::InputBlob input(blob);
 	bool b2;
 	input.read(b2);
@@ -70,6 +72,12 @@ void UT_blob(const char* params)
 
 	S s2;
 	input.read(s2);
+
+	const char* view = input.readStringView();
+	LUMIX_EXPECT(Lumix::equalStrings(view, "view string"));
+	LUMIX_EXPECT(view >= (const char*)input.getData());
+	LUMIX_EXPECT(view < (const char*)input.getData() + input.getSize());
+
 	LUMIX_EXPECT(b == b2);
 	LUMIX_EXPECT(c == c2);
 	LUMIX_EXPECT(i == i2);
@@ -106,4 +114,35 @@ void UT_blob(const char* params)
 	LUMIX_EXPECT(blob.getPos() == sizeof(b));
 }
 
+void UT_chunked_blob(const char* params)
+{
+	Lumix::DefaultAllocator allocator;
+	Lumix::ChunkedOutputBlob blob(allocator);
+
+	const int COUNT = 100000;
+	for (int i = 0; i < COUNT; ++i)
+	{
+		blob.write(i);
+	}
+	LUMIX_EXPECT(blob.getPos() == COUNT * (int)sizeof(int));
+
+	Lumix::OutputBlob contiguous(allocator);
+	blob.copyTo(contiguous);
+	LUMIX_EXPECT(contiguous.getPos() == blob.getPos());
+
+	const int* values = (const int*)contiguous.getData();
+	bool data_ok = true;
+	for (int i = 0; i < COUNT; ++i)
+	{
+		data_ok = data_ok && values[i] == i;
+	}
+	LUMIX_EXPECT(data_ok);
+
+	blob.clear();
+	LUMIX_EXPECT(blob.getPos() == 0);
+	blob.writeString("test string");
+	LUMIX_EXPECT(blob.getPos() == (int)sizeof(Lumix::i32) + 12);
+}
+
 REGISTER_TEST("unit_tests/engine/blob", UT_blob, "")
+REGISTER_TEST("unit_tests/engine/blob/chunked", UT_chunked_blob, "")
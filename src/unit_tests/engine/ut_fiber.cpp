@@ -0,0 +1,50 @@
+#include "unit_tests/suite/lumix_unit_tests.h"
+
+#include "engine/mt/fiber.h"
+
+namespace
+{
+	Lumix::MT::Fiber::Handle main_fiber = Lumix::MT::Fiber::INVALID_FIBER;
+	Lumix::MT::Fiber::Handle coro_fiber = Lumix::MT::Fiber::INVALID_FIBER;
+
+	const int SWITCHES_COUNT = 3;
+
+	int sequence[SWITCHES_COUNT * 2];
+	int sequence_len = 0;
+
+	void coro(void* parameter)
+	{
+		LUMIX_EXPECT(parameter == (void*)&sequence);
+		for (;;)
+		{
+			sequence[sequence_len++] = 1;
+			Lumix::MT::Fiber::switchTo(coro_fiber, main_fiber);
+		}
+	}
+
+	void UT_fiber(const char* params)
+	{
+		Lumix::DefaultAllocator allocator;
+
+		main_fiber = Lumix::MT::Fiber::initFromThread(allocator);
+		coro_fiber = Lumix::MT::Fiber::create(64 * 1024, coro, &sequence, allocator);
+
+		sequence_len = 0;
+		for (int i = 0; i < SWITCHES_COUNT; ++i)
+		{
+			Lumix::MT::Fiber::switchTo(main_fiber, coro_fiber);
+			sequence[sequence_len++] = 0;
+		}
+
+		LUMIX_EXPECT(sequence_len == SWITCHES_COUNT * 2);
+		for (int i = 0; i < sequence_len; ++i)
+		{
+			LUMIX_EXPECT(sequence[i] == (i & 1 ? 0 : 1));
+		}
+
+		Lumix::MT::Fiber::destroy(coro_fiber, allocator);
+		Lumix::MT::Fiber::destroy(main_fiber, allocator);
+	}
+}
+
+REGISTER_TEST("unit_tests/engine/mt/fiber", UT_fiber, "")
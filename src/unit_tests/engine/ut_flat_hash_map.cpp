@@ -0,0 +1,85 @@
+#include "unit_tests/suite/lumix_unit_tests.h"
+
+#include "engine/flat_hash_map.h"
+#include "engine/debug/debug.h"
+
+namespace
+{
+	void UT_flat_insert_find(const char* params)
+	{
+		Lumix::DefaultAllocator main_allocator;
+		Lumix::Debug::Allocator allocator(main_allocator);
+		Lumix::FlatHashMap<i32, i32> hash_table(allocator);
+
+		LUMIX_EXPECT(hash_table.empty());
+
+		const i32 COUNT = 1000;
+		for (i32 i = 0; i < COUNT; ++i)
+		{
+			hash_table.insert(i * 7, i);
+		}
+		LUMIX_EXPECT(hash_table.size() == COUNT);
+
+		for (i32 i = 0; i < COUNT; ++i)
+		{
+			LUMIX_EXPECT(hash_table[i * 7] == i);
+			LUMIX_EXPECT(hash_table.find(i * 7).isValid());
+		}
+		LUMIX_EXPECT(!hash_table.find(3).isValid());
+		LUMIX_EXPECT(hash_table.find(3) == hash_table.end());
+	};
+
+	void UT_flat_erase(const char* params)
+	{
+		Lumix::DefaultAllocator main_allocator;
+		Lumix::Debug::Allocator allocator(main_allocator);
+		Lumix::FlatHashMap<i32, i32> hash_table(allocator);
+
+		const i32 COUNT = 100;
+		for (i32 i = 0; i < COUNT; ++i)
+		{
+			hash_table.insert(i, i * 2);
+		}
+
+		for (i32 i = 0; i < COUNT; i += 2)
+		{
+			LUMIX_EXPECT(hash_table.erase(i) == 1);
+		}
+		LUMIX_EXPECT(hash_table.size() == COUNT / 2);
+
+		for (i32 i = 0; i < COUNT; ++i)
+		{
+			LUMIX_EXPECT(hash_table.find(i).isValid() == (i % 2 == 1));
+		}
+
+		i32 visited = 0;
+		for (auto iter = hash_table.begin(), end = hash_table.end(); iter != end; ++iter)
+		{
+			LUMIX_EXPECT(iter.value() == iter.key() * 2);
+			++visited;
+		}
+		LUMIX_EXPECT(visited == COUNT / 2);
+	};
+
+	void UT_flat_clear(const char* params)
+	{
+		Lumix::DefaultAllocator main_allocator;
+		Lumix::Debug::Allocator allocator(main_allocator);
+		Lumix::FlatHashMap<i32, i32> hash_table(allocator);
+
+		const i32 COUNT = 20;
+		for (i32 i = 0; i < COUNT; ++i)
+		{
+			hash_table.insert(i, i);
+		}
+		LUMIX_EXPECT(!hash_table.empty());
+
+		hash_table.clear();
+		LUMIX_EXPECT(hash_table.empty());
+		LUMIX_EXPECT(hash_table.size() == 0);
+	};
+}
+
+REGISTER_TEST("unit_tests/engine/flat_hash_map/insert_find", UT_flat_insert_find, "")
+REGISTER_TEST("unit_tests/engine/flat_hash_map/erase", UT_flat_erase, "")
+REGISTER_TEST("unit_tests/engine/flat_hash_map/clear", UT_flat_clear, "")
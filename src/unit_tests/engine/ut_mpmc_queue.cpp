@@ -0,0 +1,116 @@
+#include "unit_tests/suite/lumix_unit_tests.h"
+
+#include "engine/mt/mpmc_queue.h"
+#include "engine/mt/task.h"
+#include "engine/mt/thread.h"
+
+namespace
+{
+	typedef Lumix::MT::MPMCQueue<i32, 256> Queue;
+
+	const i32 ITEMS_PER_PRODUCER = 10000;
+	const i32 PRODUCERS_COUNT = 2;
+	const i32 CONSUMERS_COUNT = 2;
+
+	class ProducerTask : public Lumix::MT::Task
+	{
+	public:
+		ProducerTask(Queue* queue, i32 first_value, Lumix::IAllocator& allocator)
+			: Lumix::MT::Task(allocator)
+			, m_queue(queue)
+			, m_first_value(first_value)
+		{}
+
+		int task() override
+		{
+			for (i32 i = 0; i < ITEMS_PER_PRODUCER; ++i)
+			{
+				while (!m_queue->push(m_first_value + i))
+				{
+					Lumix::MT::yield();
+				}
+			}
+			return 0;
+		}
+
+	private:
+		Queue* m_queue;
+		i32 m_first_value;
+	};
+
+	class ConsumerTask : public Lumix::MT::Task
+	{
+	public:
+		ConsumerTask(Queue* queue, volatile i32* remaining_count, Lumix::IAllocator& allocator)
+			: Lumix::MT::Task(allocator)
+			, m_queue(queue)
+			, m_remaining_count(remaining_count)
+			, m_sum(0)
+		{}
+
+		int task() override
+		{
+			i32 items[16];
+			while (*m_remaining_count > 0)
+			{
+				i32 count = m_queue->popBatch(items, Lumix::lengthOf(items));
+				for (i32 i = 0; i < count; ++i)
+				{
+					m_sum += items[i];
+				}
+				if (count > 0)
+				{
+					Lumix::MT::atomicSubtract(m_remaining_count, count);
+				}
+				else
+				{
+					Lumix::MT::yield();
+				}
+			}
+			return 0;
+		}
+
+		i64 getSum() const { return m_sum; }
+
+	private:
+		Queue* m_queue;
+		volatile i32* m_remaining_count;
+		i64 m_sum;
+	};
+
+	void UT_mpmc_queue(const char* params)
+	{
+		Lumix::DefaultAllocator allocator;
+		Queue queue;
+
+		LUMIX_EXPECT(queue.isEmpty());
+		LUMIX_EXPECT(queue.push(1));
+		i32 value = 0;
+		LUMIX_EXPECT(queue.pop(value));
+		LUMIX_EXPECT(value == 1);
+		LUMIX_EXPECT(!queue.pop(value));
+
+		volatile i32 remaining_count = PRODUCERS_COUNT * ITEMS_PER_PRODUCER;
+		ProducerTask producer1(&queue, 0, allocator);
+		ProducerTask producer2(&queue, ITEMS_PER_PRODUCER, allocator);
+		ConsumerTask consumer1(&queue, &remaining_count, allocator);
+		ConsumerTask consumer2(&queue, &remaining_count, allocator);
+
+		producer1.create("producer1");
+		producer2.create("producer2");
+		consumer1.create("consumer1");
+		consumer2.create("consumer2");
+
+		producer1.destroy();
+		producer2.destroy();
+		consumer1.destroy();
+		consumer2.destroy();
+
+		i64 total = PRODUCERS_COUNT * (i64)ITEMS_PER_PRODUCER;
+		i64 expected_sum = total * (total - 1) / 2;
+		LUMIX_EXPECT(consumer1.getSum() + consumer2.getSum() == expected_sum);
+		LUMIX_EXPECT(queue.isEmpty());
+	}
+}
+
+REGISTER_TEST("unit_tests/engine/mpmc_queue", UT_mpmc_queue, "")
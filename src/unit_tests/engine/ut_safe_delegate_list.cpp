@@ -0,0 +1,70 @@
+#include "unit_tests/suite/lumix_unit_tests.h"
+
+#include "engine/mt/atomic.h"
+#include "engine/mt/task.h"
+#include "engine/mt/thread.h"
+#include "engine/safe_delegate_list.h"
+
+namespace
+{
+	volatile i32 counter = 0;
+	volatile bool done = false;
+
+	struct Listener
+	{
+		void onEvent(int value) { Lumix::MT::atomicAdd(&counter, value); }
+	};
+
+	class BroadcastTask : public Lumix::MT::Task
+	{
+	public:
+		BroadcastTask(Lumix::SafeDelegateList<void(int)>* list, Lumix::IAllocator& allocator)
+			: Lumix::MT::Task(allocator)
+			, m_list(list)
+		{}
+
+		int task() override
+		{
+			while (!done)
+			{
+				m_list->invoke(1);
+			}
+			return 0;
+		}
+
+	private:
+		Lumix::SafeDelegateList<void(int)>* m_list;
+	};
+
+	void UT_safe_delegate_list(const char* params)
+	{
+		Lumix::DefaultAllocator allocator;
+		Lumix::SafeDelegateList<void(int)> list(allocator);
+
+		Listener listener;
+		list.bind<Listener, &Listener::onEvent>(&listener);
+		list.invoke(5);
+		LUMIX_EXPECT(counter == 5);
+
+		// bind/unbind a second listener while another thread broadcasts
+		BroadcastTask task(&list, allocator);
+		task.create("ut_safe_delegate_broadcast");
+
+		Listener other;
+		for (int i = 0; i < 1000; ++i)
+		{
+			list.bind<Listener, &Listener::onEvent>(&other);
+			list.unbind<Listener, &Listener::onEvent>(&other);
+		}
+
+		done = true;
+		task.destroy();
+
+		i32 total = counter;
+		list.unbind<Listener, &Listener::onEvent>(&listener);
+		list.invoke(1000000);
+		LUMIX_EXPECT(counter == total);
+	}
+}
+
+REGISTER_TEST("unit_tests/engine/safe_delegate_list", UT_safe_delegate_list, "")
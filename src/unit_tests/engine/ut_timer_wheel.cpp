@@ -0,0 +1,74 @@
+#include "unit_tests/suite/lumix_unit_tests.h"
+
+#include "engine/timer_wheel.h"
+
+namespace
+{
+	struct Listener
+	{
+		Listener()
+			: fired_count(0)
+			, last_value(0)
+		{}
+
+		void onTimer(void* user_data)
+		{
+			++fired_count;
+			last_value = int(Lumix::uintptr(user_data));
+		}
+
+		int fired_count;
+		int last_value;
+	};
+
+	void UT_timer_wheel(const char* params)
+	{
+		Lumix::DefaultAllocator allocator;
+		Lumix::TimerWheel wheel(allocator);
+
+		Listener listener;
+		Lumix::TimerWheel::Callback cb;
+		cb.bind<Listener, &Listener::onTimer>(&listener);
+
+		wheel.add(0.5f, cb, (void*)Lumix::uintptr(1));
+		Lumix::TimerWheel::Handle cancelled = wheel.add(0.5f, cb, (void*)Lumix::uintptr(2));
+		wheel.add(10.0f, cb, (void*)Lumix::uintptr(3));
+		LUMIX_EXPECT(wheel.getPendingCount() == 3);
+
+		wheel.cancel(cancelled);
+		LUMIX_EXPECT(wheel.getPendingCount() == 2);
+
+		wheel.update(0.3f);
+		LUMIX_EXPECT(listener.fired_count == 0);
+
+		wheel.update(0.3f);
+		LUMIX_EXPECT(listener.fired_count == 1);
+		LUMIX_EXPECT(listener.last_value == 1);
+		LUMIX_EXPECT(wheel.getPendingCount() == 1);
+
+		// long timer survives full wheel revolutions
+		for (int i = 0; i < 80; ++i)
+		{
+			wheel.update(0.1f);
+		}
+		LUMIX_EXPECT(listener.fired_count == 1);
+		for (int i = 0; i < 20; ++i)
+		{
+			wheel.update(0.1f);
+		}
+		LUMIX_EXPECT(listener.fired_count == 2);
+		LUMIX_EXPECT(listener.last_value == 3);
+		LUMIX_EXPECT(wheel.getPendingCount() == 0);
+
+		// many timers; firing order within a frame is not guaranteed, count is
+		for (int i = 0; i < 1000; ++i)
+		{
+			wheel.add(0.001f * i, cb, nullptr);
+		}
+		wheel.update(2.0f);
+		LUMIX_EXPECT(listener.fired_count == 1002);
+		LUMIX_EXPECT(wheel.getPendingCount() == 0);
+	}
+}
+
+REGISTER_TEST("unit_tests/engine/timer_wheel", UT_timer_wheel, "")
@@ -0,0 +1,54 @@
+#include "unit_tests/suite/lumix_unit_tests.h"
+#include "unit_tests/suite/benchmark.h"
+
+#include "engine/geometry.h"
+
+#include "engine/mtjd/manager.h"
+
+#include "renderer/culling_system.h"
+
+namespace
+{
+
+	void UT_benchmark_culling(const char* params)
+	{
+		Lumix::DefaultAllocator allocator;
+		Lumix::Array<Lumix::Sphere> spheres(allocator);
+		Lumix::Array<Lumix::ComponentHandle> model_instances(allocator);
+		int model_instance = 0;
+		for (float i = 0.f; i < 3000000.0f; i += 15.f)
+		{
+			spheres.push(Lumix::Sphere(i, 0.f, 50.f, 5.f));
+			model_instances.push({model_instance});
+			++model_instance;
+		}
+
+		Lumix::Frustum frustum;
+		frustum.computePerspective(Lumix::Vec3(0.f, 0.f, -5.f),
+			Lumix::Vec3(0.f, 0.f, 1.f),
+			Lumix::Vec3(0.f, 1.f, 0.f),
+			Lumix::Math::degreesToRadians(60.f),
+			2.32378864f,
+			10.f,
+			100.f);
+
+		Lumix::MTJD::Manager* mtjd_manager = Lumix::MTJD::Manager::create(allocator);
+		Lumix::CullingSystem* culling_system = Lumix::CullingSystem::create(*mtjd_manager, allocator);
+		culling_system->insert(spheres, model_instances);
+
+		volatile int visible = 0;
+		Lumix::UnitTest::benchmark("graphics/culling/200k_spheres", 10, [&](int) {
+			culling_system->cullToFrustum(frustum, 1);
+			const Lumix::CullingSystem::Results& result = culling_system->getResult();
+			int count = 0;
+			for (int i = 0; i < result.size(); ++i) count += result[i].size();
+			visible += count;
+		});
+
+		Lumix::CullingSystem::destroy(*culling_system);
+		Lumix::MTJD::Manager::destroy(*mtjd_manager);
+	}
+
+}
+
+REGISTER_TEST("benchmarks/graphics/culling", UT_benchmark_culling, "");
@@ -0,0 +1,53 @@
+#pragma once
+
+
+#include "engine/log.h"
+#include "engine/timer.h"
+#include "unit_tests/suite/unit_test_manager.h"
+
+
+namespace Lumix
+{
+	namespace UnitTest
+	{
+		// runs the body in timed rounds: one warmup round that is thrown away,
+		// then REPEAT measured rounds, and reports the median round so a
+		// scheduler hiccup in one round cannot skew the result; output is one
+		// tab-separated "BENCH <name> <ns/op>" line for regression tracking
+		template <typename T>
+		void benchmark(const char* name, int iterations, const T& body)
+		{
+			static const int REPEAT = 9;
+
+			Timer* timer = Timer::create(Manager::getAllocator());
+			double rounds[REPEAT];
+			for (int round = -1; round < REPEAT; ++round)
+			{
+				u64 start = timer->getRawTimeSinceStart();
+				for (int i = 0; i < iterations; ++i)
+				{
+					body(i);
+				}
+				u64 end = timer->getRawTimeSinceStart();
+				if (round >= 0) rounds[round] = double(end - start);
+			}
+
+			for (int i = 1; i < REPEAT; ++i)
+			{
+				double tmp = rounds[i];
+				int j = i - 1;
+				while (j >= 0 && rounds[j] > tmp)
+				{
+					rounds[j + 1] = rounds[j];
+					--j;
+				}
+				rounds[j + 1] = tmp;
+			}
+
+			double ns_per_op =
+				rounds[REPEAT / 2] * 1000000000.0 / (double)timer->getFrequency() / iterations;
+			g_log_info.log("benchmark") << "BENCH\t" << name << "\t" << float(ns_per_op);
+			Timer::destroy(timer);
+		}
+	} // ~UnitTest
+} // ~Lumix
@@ -43,7 +43,9 @@ namespace Lumix
 		void App::run(int argc, const char *argv[])
 		{
 			Manager::instance().dumpTests();
-			Manager::instance().runTests("*");
+			// a filter argument selects a subset, e.g. "benchmarks/*" runs only
+			// the performance tests
+			Manager::instance().runTests(argc > 1 ? argv[1] : "*");
 			Manager::instance().dumpResults();
 		}
 